@@ -59,6 +59,10 @@
 
   Jan-2010 - back to unzip and minizip 1.0 name scheme, with compatibility layer
 
+  Oct-2026 - Added unzReadCurrentFileBulk, unzDecompressBuffer and unzCrc32 for reading
+             whole files, copy stored data with memcpy and skip the crc of raw reads
+  Oct-2026 - unzLocateFile looks names up in an index of the central directory
+
   Copyright (C) 1998 - 2010 Gilles Vollant, Even Rouault, Mathias Svensson
 
 */
@@ -86,6 +90,11 @@
 #   include <errno.h>
 #endif
 
+#include <stdint.h>
+#if defined(__ARM_FEATURE_CRC32)
+#   include <arm_acle.h>
+#endif
+
 
 #ifndef local
 #  define local static
@@ -104,6 +113,10 @@
 #define UNZ_BUFSIZE (16384)
 #endif
 
+#ifndef UNZ_BULK_BUFSIZE
+#define UNZ_BULK_BUFSIZE (262144)
+#endif
+
 #ifndef UNZ_MAXFILENAMEINZIP
 #define UNZ_MAXFILENAMEINZIP (256)
 #endif
@@ -160,6 +173,14 @@ typedef struct
 } file_in_zip64_read_info_s;
 
 
+/* a slot of the file name index, empty when num_file_plus_one is 0 */
+typedef struct
+{
+    uLong hash;
+    ZPOS64_T num_file_plus_one;
+    ZPOS64_T pos_in_central_dir;
+} unz64_name_index_entry;
+
 /* unz64_s contain internal information about the zipfile
 */
 typedef struct
@@ -186,6 +207,9 @@ typedef struct
 
     int isZip64;
 
+    unz64_name_index_entry* name_index; /* built by the first unzLocateFile */
+    ZPOS64_T name_index_size;    /* a power of two, or 1 if the index could not be built */
+
 #    ifndef NOUNCRYPT
     unsigned long keys[3];     /* keys defining the pseudo-random sequence */
     const unsigned long* pcrc_32_tab;
@@ -750,6 +774,8 @@ local unzFile unzOpenInternal (const void *path,
     us.central_pos = central_pos;
     us.pfile_in_zip_read = NULL;
     us.encrypted = 0;
+    us.name_index = NULL;
+    us.name_index_size = 0;
 
 
     s=(unz64_s*)ALLOC(sizeof(unz64_s));
@@ -816,6 +842,7 @@ extern int ZEXPORT unzClose (unzFile file)
         unzCloseCurrentFile(file);
 
     ZCLOSE64(s->z_filefunc, s->filestream);
+    TRYFREE(s->name_index);
     TRYFREE(s);
     return UNZ_OK;
 }
@@ -1229,6 +1256,76 @@ extern int ZEXPORT unzGoToNextFile (unzFile  file)
   UNZ_OK if the file is found. It becomes the current file.
   UNZ_END_OF_LIST_OF_FILE if the file is not found
 */
+/*
+  FNV-1a hash of a file name with its letters in upper case, so the same index serves
+  case sensitive and case insensitive lookups.
+*/
+local uLong unz64local_NameHash (const char* fileName)
+{
+    uLong hash = 2166136261UL;
+    for (; *fileName != '\0'; fileName++)
+    {
+        char c = *fileName;
+        if ((c>='a') && (c<='z'))
+            c -= 0x20;
+        hash = ((hash ^ (unsigned char)c) * 16777619UL) & 0xffffffffUL;
+    }
+    return hash;
+}
+
+/*
+  Reads the central directory once into an open addressing table of the file names,
+  so that each unzLocateFile reads one file header instead of all of them up to the
+  file. The files are added in order, so a name that is in the zip more than once
+  finds the first, as the linear search does. Changes the current file.
+*/
+local void unz64local_BuildNameIndex (unz64_s* s)
+{
+    ZPOS64_T size = 16;
+    ZPOS64_T num = 0;
+    int err;
+
+    while (size < s->gi.number_entry * 2)
+        size *= 2;
+    s->name_index_size = 1;
+    s->name_index = (unz64_name_index_entry*)ALLOC((size_t)size * sizeof(unz64_name_index_entry));
+    if (s->name_index == NULL)
+        return;
+    memset(s->name_index, 0, (size_t)size * sizeof(unz64_name_index_entry));
+
+    err = unzGoToFirstFile((unzFile)s);
+    while (err == UNZ_OK)
+    {
+        char szCurrentFileName[UNZ_MAXFILENAMEINZIP+1];
+        uLong hash;
+        ZPOS64_T slot;
+        /* a zip64 count may be larger than the table */
+        if (++num > size / 2)
+            break;
+        err = unzGetCurrentFileInfo64((unzFile)s,NULL,
+                                    szCurrentFileName,sizeof(szCurrentFileName)-1,
+                                    NULL,0,NULL,0);
+        if (err != UNZ_OK)
+            break;
+        hash = unz64local_NameHash(szCurrentFileName);
+        for (slot = hash & (size - 1); s->name_index[slot].num_file_plus_one != 0; slot = (slot + 1) & (size - 1))
+        {
+        }
+        s->name_index[slot].hash = hash;
+        s->name_index[slot].num_file_plus_one = s->num_file + 1;
+        s->name_index[slot].pos_in_central_dir = s->pos_in_central_dir;
+        err = unzGoToNextFile((unzFile)s);
+    }
+
+    if (err != UNZ_END_OF_LIST_OF_FILE)
+    {
+        TRYFREE(s->name_index);
+        s->name_index = NULL;
+        return;
+    }
+    s->name_index_size = size;
+}
+
 extern int ZEXPORT unzLocateFile (unzFile file, const char *szFileName, int iCaseSensitivity)
 {
     unz64_s* s;
@@ -1259,20 +1356,49 @@ extern int ZEXPORT unzLocateFile (unzFile file, const char *szFileName, int iCas
     cur_file_infoSaved = s->cur_file_info;
     cur_file_info_internalSaved = s->cur_file_info_internal;
 
-    err = unzGoToFirstFile(file);
+    if (s->name_index_size == 0)
+        unz64local_BuildNameIndex(s);
 
-    while (err == UNZ_OK)
+    if (s->name_index != NULL)
     {
-        char szCurrentFileName[UNZ_MAXFILENAMEINZIP+1];
-        err = unzGetCurrentFileInfo64(file,NULL,
-                                    szCurrentFileName,sizeof(szCurrentFileName)-1,
-                                    NULL,0,NULL,0);
-        if (err == UNZ_OK)
+        uLong hash = unz64local_NameHash(szFileName);
+        ZPOS64_T mask = s->name_index_size - 1;
+        ZPOS64_T slot;
+        for (slot = hash & mask; s->name_index[slot].num_file_plus_one != 0; slot = (slot + 1) & mask)
         {
-            if (unzStringFileNameCompare(szCurrentFileName,
-                                            szFileName,iCaseSensitivity)==0)
+            char szCurrentFileName[UNZ_MAXFILENAMEINZIP+1];
+            if (s->name_index[slot].hash != hash)
+                continue;
+            s->num_file = s->name_index[slot].num_file_plus_one - 1;
+            s->pos_in_central_dir = s->name_index[slot].pos_in_central_dir;
+            err = unz64local_GetCurrentFileInfoInternal(file,&s->cur_file_info,
+                                                       &s->cur_file_info_internal,
+                                                       szCurrentFileName,sizeof(szCurrentFileName)-1,
+                                                       NULL,0,NULL,0);
+            s->current_file_ok = (err == UNZ_OK);
+            if ((err == UNZ_OK) &&
+                (unzStringFileNameCompare(szCurrentFileName,szFileName,iCaseSensitivity)==0))
                 return UNZ_OK;
-            err = unzGoToNextFile(file);
+        }
+        err = UNZ_END_OF_LIST_OF_FILE;
+    }
+    else
+    {
+        err = unzGoToFirstFile(file);
+
+        while (err == UNZ_OK)
+        {
+            char szCurrentFileName[UNZ_MAXFILENAMEINZIP+1];
+            err = unzGetCurrentFileInfo64(file,NULL,
+                                        szCurrentFileName,sizeof(szCurrentFileName)-1,
+                                        NULL,0,NULL,0);
+            if (err == UNZ_OK)
+            {
+                if (unzStringFileNameCompare(szCurrentFileName,
+                                                szFileName,iCaseSensitivity)==0)
+                    return UNZ_OK;
+                err = unzGoToNextFile(file);
+            }
         }
     }
 
@@ -1283,6 +1409,7 @@ extern int ZEXPORT unzLocateFile (unzFile file, const char *szFileName, int iCas
     s->pos_in_central_dir = pos_in_central_dirSaved ;
     s->cur_file_info = cur_file_infoSaved;
     s->cur_file_info_internal = cur_file_info_internalSaved;
+    s->current_file_ok = 1; /* checked on entry */
     return err;
 }
 
@@ -1763,7 +1890,7 @@ extern int ZEXPORT unzReadCurrentFile  (unzFile file, voidp buf, unsigned len)
 
         if ((pfile_in_zip_read_info->compression_method==0) || (pfile_in_zip_read_info->raw))
         {
-            uInt uDoCopy,i ;
+            uInt uDoCopy;
 
             if ((pfile_in_zip_read_info->stream.avail_in == 0) &&
                 (pfile_in_zip_read_info->rest_read_compressed == 0))
@@ -1775,15 +1902,16 @@ extern int ZEXPORT unzReadCurrentFile  (unzFile file, voidp buf, unsigned len)
             else
                 uDoCopy = pfile_in_zip_read_info->stream.avail_in ;
 
-            for (i=0;i<uDoCopy;i++)
-                *(pfile_in_zip_read_info->stream.next_out+i) =
-                        *(pfile_in_zip_read_info->stream.next_in+i);
+            memcpy(pfile_in_zip_read_info->stream.next_out,
+                   pfile_in_zip_read_info->stream.next_in, uDoCopy);
 
             pfile_in_zip_read_info->total_out_64 = pfile_in_zip_read_info->total_out_64 + uDoCopy;
 
-            pfile_in_zip_read_info->crc32 = crc32(pfile_in_zip_read_info->crc32,
-                                pfile_in_zip_read_info->stream.next_out,
-                                uDoCopy);
+            /* the crc of raw data is never checked */
+            if (!pfile_in_zip_read_info->raw)
+                pfile_in_zip_read_info->crc32 = crc32(pfile_in_zip_read_info->crc32,
+                                    pfile_in_zip_read_info->stream.next_out,
+                                    uDoCopy);
             pfile_in_zip_read_info->rest_read_uncompressed-=uDoCopy;
             pfile_in_zip_read_info->stream.avail_in -= uDoCopy;
             pfile_in_zip_read_info->stream.avail_out -= uDoCopy;
@@ -1883,6 +2011,189 @@ extern int ZEXPORT unzReadCurrentFile  (unzFile file, voidp buf, unsigned len)
 }
 
 
+extern uLong ZEXPORT unzCrc32 (uLong crc, const void* buf, uLong len)
+{
+    const unsigned char* p = (const unsigned char*)buf;
+#if defined(__ARM_FEATURE_CRC32)
+    uint32_t c = ~(uint32_t)crc;
+    while ((len > 0) && (((uintptr_t)p & 7) != 0))
+    {
+        c = __crc32b(c, *p++);
+        len--;
+    }
+    while (len >= 8)
+    {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        c = __crc32d(c, v);
+        p += 8;
+        len -= 8;
+    }
+    while (len > 0)
+    {
+        c = __crc32b(c, *p++);
+        len--;
+    }
+    return (uLong)~c;
+#else
+    /* zLib takes the length as an uInt */
+    while (len > 0)
+    {
+        uInt uThis = (len > 0x40000000) ? 0x40000000 : (uInt)len;
+        crc = crc32(crc, p, uThis);
+        p += uThis;
+        len -= uThis;
+    }
+    return crc;
+#endif
+}
+
+extern int ZEXPORT unzDecompressBuffer (const void* src, uLong srcLen,
+                                        void* dst, uLong dstLen,
+                                        int method, uLong crc)
+{
+    if (method == 0)
+    {
+        if (srcLen != dstLen)
+            return UNZ_BADZIPFILE;
+        if (dst != src)
+            memcpy(dst, src, dstLen);
+    }
+    else if (method == Z_DEFLATED)
+    {
+        z_stream stream;
+        int err;
+        memset(&stream, 0, sizeof(stream));
+        err = inflateInit2(&stream, -MAX_WBITS);
+        if (err != Z_OK)
+            return err;
+        stream.next_in = (Bytef*)src;
+        stream.avail_in = (uInt)srcLen;
+        stream.next_out = (Bytef*)dst;
+        stream.avail_out = (uInt)dstLen;
+        err = inflate(&stream, Z_FINISH);
+        inflateEnd(&stream);
+        /* a stream that fills dst exactly may end without Z_STREAM_END */
+        if ((err != Z_STREAM_END) && !((err == Z_OK || err == Z_BUF_ERROR) && (stream.avail_out == 0)))
+            return (err < 0) ? err : Z_DATA_ERROR;
+        if (stream.total_out != dstLen)
+            return Z_DATA_ERROR;
+    }
+    else
+        return UNZ_BADZIPFILE;
+
+    if (unzCrc32(0, dst, dstLen) != crc)
+        return UNZ_CRCERROR;
+    return UNZ_OK;
+}
+
+extern int ZEXPORT unzReadCurrentFileBulk (unzFile file, voidp buf, unsigned len)
+{
+    int err=UNZ_OK;
+    unz64_s* s;
+    file_in_zip64_read_info_s* pfile_in_zip_read_info;
+    if (file==NULL)
+        return UNZ_PARAMERROR;
+    s=(unz64_s*)file;
+    pfile_in_zip_read_info=s->pfile_in_zip_read;
+
+    if ((pfile_in_zip_read_info==NULL) || (pfile_in_zip_read_info->read_buffer==NULL))
+        return UNZ_PARAMERROR;
+    if ((pfile_in_zip_read_info->raw) || (s->encrypted) ||
+        (pfile_in_zip_read_info->total_out_64!=0) ||
+        (len<pfile_in_zip_read_info->rest_read_uncompressed))
+        return UNZ_PARAMERROR;
+    len = (unsigned)pfile_in_zip_read_info->rest_read_uncompressed;
+
+    if (ZSEEK64(pfile_in_zip_read_info->z_filefunc,
+              pfile_in_zip_read_info->filestream,
+              pfile_in_zip_read_info->pos_in_zipfile +
+                 pfile_in_zip_read_info->byte_before_the_zipfile,
+              ZLIB_FILEFUNC_SEEK_SET)!=0)
+        return UNZ_ERRNO;
+
+    if (pfile_in_zip_read_info->compression_method==0)
+    {
+        if (pfile_in_zip_read_info->rest_read_compressed!=len)
+            return UNZ_BADZIPFILE;
+        if (ZREAD64(pfile_in_zip_read_info->z_filefunc,
+                  pfile_in_zip_read_info->filestream,
+                  buf, len)!=len)
+            return UNZ_ERRNO;
+        pfile_in_zip_read_info->pos_in_zipfile += len;
+        pfile_in_zip_read_info->rest_read_compressed = 0;
+        pfile_in_zip_read_info->stream.total_out += len;
+    }
+    else if (pfile_in_zip_read_info->compression_method==Z_DEFLATED)
+    {
+        /* the buffer of unzOpenCurrentFile is too small to keep inflate busy */
+        char* read_buffer = pfile_in_zip_read_info->read_buffer;
+        uInt uReadSize = UNZ_BULK_BUFSIZE;
+        if (pfile_in_zip_read_info->rest_read_compressed<uReadSize)
+            uReadSize = (uInt)pfile_in_zip_read_info->rest_read_compressed;
+        if (uReadSize>UNZ_BUFSIZE)
+        {
+            read_buffer = (char*)ALLOC(uReadSize);
+            if (read_buffer==NULL)
+                return UNZ_INTERNALERROR;
+        }
+
+        pfile_in_zip_read_info->stream.next_out = (Bytef*)buf;
+        pfile_in_zip_read_info->stream.avail_out = (uInt)len;
+        while (pfile_in_zip_read_info->stream.avail_out>0)
+        {
+            if (pfile_in_zip_read_info->stream.avail_in==0)
+            {
+                uInt uReadThis = uReadSize;
+                if (pfile_in_zip_read_info->rest_read_compressed<uReadThis)
+                    uReadThis = (uInt)pfile_in_zip_read_info->rest_read_compressed;
+                if (uReadThis==0)
+                {
+                    err = Z_DATA_ERROR;
+                    break;
+                }
+                if (ZREAD64(pfile_in_zip_read_info->z_filefunc,
+                          pfile_in_zip_read_info->filestream,
+                          read_buffer, uReadThis)!=uReadThis)
+                {
+                    err = UNZ_ERRNO;
+                    break;
+                }
+                pfile_in_zip_read_info->pos_in_zipfile += uReadThis;
+                pfile_in_zip_read_info->rest_read_compressed -= uReadThis;
+                pfile_in_zip_read_info->stream.next_in = (Bytef*)read_buffer;
+                pfile_in_zip_read_info->stream.avail_in = uReadThis;
+            }
+
+            err=inflate(&pfile_in_zip_read_info->stream,Z_NO_FLUSH);
+            if ((err>=0) && (pfile_in_zip_read_info->stream.msg!=NULL))
+                err = Z_DATA_ERROR;
+            if (err==Z_STREAM_END)
+            {
+                err = (pfile_in_zip_read_info->stream.avail_out==0) ? Z_OK : Z_DATA_ERROR;
+                break;
+            }
+            if (err!=Z_OK)
+                break;
+        }
+        /* the data is all in buf now, so the buffer is not needed for the rest */
+        pfile_in_zip_read_info->stream.avail_in = 0;
+        if (read_buffer!=pfile_in_zip_read_info->read_buffer)
+            TRYFREE(read_buffer);
+        if (err!=Z_OK)
+            return err;
+    }
+    else
+        return UNZ_PARAMERROR;
+
+    pfile_in_zip_read_info->total_out_64 = len;
+    pfile_in_zip_read_info->rest_read_uncompressed = 0;
+    pfile_in_zip_read_info->crc32 = unzCrc32(0, buf, len);
+    if (pfile_in_zip_read_info->crc32!=pfile_in_zip_read_info->crc32_wait)
+        return UNZ_CRCERROR;
+    return (int)len;
+}
+
 /*
   Give the current position in uncompressed data
 */
@@ -390,6 +390,47 @@ extern int ZEXPORT unzReadCurrentFile OF((unzFile file,
     (UNZ_ERRNO for IO error, or zLib error for uncompress error)
 */
 
+extern int ZEXPORT unzReadCurrentFileBulk OF((unzFile file,
+                      voidp buf,
+                      unsigned len));
+/*
+  Read the whole current file (opened by unzOpenCurrentFile, and not read yet)
+  buf must hold the uncompressed size of the file, len the size of buf.
+  A stored file is read straight into buf. A deflated file is inflated into buf
+    as one stream, from large reads of the compressed data, which keeps inflate
+    in its fast loop. The CRC is checked once over all of buf.
+
+  return the number of byte copied
+  return UNZ_PARAMERROR for files that are opened raw or with a password, or
+    that were already read from; read those with unzReadCurrentFile
+  return <0 with error code if there is an error
+    (UNZ_ERRNO for IO error, UNZ_CRCERROR, or zLib error for uncompress error)
+*/
+
+extern int ZEXPORT unzDecompressBuffer OF((const void* src,
+                      uLong srcLen,
+                      voidp dst,
+                      uLong dstLen,
+                      int method,
+                      uLong crc));
+/*
+  Decompress a whole file from memory
+  src is the data of the file in the zipfile, starting at
+    unzGetCurrentFileZStreamPos64, or as read by unzReadCurrentFile from a file
+    opened raw. method is its compression method (0 or Z_DEFLATED), dstLen its
+    uncompressed size and crc its CRC.
+  This does not use an unzFile, so several threads can call it at once.
+
+  return UNZ_OK, UNZ_CRCERROR, UNZ_BADZIPFILE for other methods or sizes,
+    or zLib error for uncompress error
+*/
+
+extern uLong ZEXPORT unzCrc32 OF((uLong crc, const void* buf, uLong len));
+/*
+  Same as the crc32 of zLib, using the ARMv8 CRC32 instructions when the
+    compiler targets them.
+*/
+
 extern z_off_t ZEXPORT unztell OF((unzFile file));
 
 extern ZPOS64_T ZEXPORT unztell64 OF((unzFile file));
@@ -18,6 +18,7 @@
                                  ZIP64 data is automaticly added to items that needs it, and existing ZIP64 data need to be removed.
    Oct-2009 - Mathias Svensson - Added support for BZIP2 as compression mode (bzip2 lib is required)
    Jan-2010 - back to unzip and minizip 1.0 name scheme, with compatibility layer
+   Oct-2026 - Added APPEND_STATUS_ADDAFTERZIP, and skip the crc of raw writes
 
 */
 
@@ -890,11 +891,20 @@ extern zipFile ZEXPORT zipOpen3 (const void *pathname, int append, zipcharpc* gl
     /* now we add file in a zipfile */
 #    ifndef NO_ADDFILEINEXISTINGZIP
     ziinit.globalcomment = NULL;
-    if (append == APPEND_STATUS_ADDINZIP)
+    if ((append == APPEND_STATUS_ADDINZIP) || (append == APPEND_STATUS_ADDAFTERZIP))
     {
       // Read and Cache Central Directory Records
       err = LoadCentralDirectoryRecord(&ziinit);
     }
+    // keep the old central directory, it is replaced by the one written at the end
+    if ((err == ZIP_OK) && (append == APPEND_STATUS_ADDAFTERZIP))
+    {
+      if (ZSEEK64(ziinit.z_filefunc,ziinit.filestream,0,ZLIB_FILEFUNC_SEEK_END) != 0)
+      {
+        ZCLOSE64(ziinit.z_filefunc,ziinit.filestream);
+        err = ZIP_ERRNO;
+      }
+    }
 
     if (globalcomment)
     {
@@ -1411,7 +1421,9 @@ extern int ZEXPORT zipWriteInFileInZip (zipFile file,const void* buf,unsigned in
     if (zi->in_opened_file_inzip == 0)
         return ZIP_PARAMERROR;
 
-    zi->ci.crc32 = crc32(zi->ci.crc32,buf,(uInt)len);
+    /* the crc of raw data is given to zipCloseFileInZipRaw */
+    if (!zi->ci.raw)
+        zi->ci.crc32 = crc32(zi->ci.crc32,buf,(uInt)len);
 
 #ifdef HAVE_BZIP2
     if(zi->ci.method == Z_BZIP2ED && (!zi->ci.raw))
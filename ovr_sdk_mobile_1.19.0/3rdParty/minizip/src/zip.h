@@ -112,6 +112,7 @@ typedef const char* zipcharpc;
 #define APPEND_STATUS_CREATE        (0)
 #define APPEND_STATUS_CREATEAFTER   (1)
 #define APPEND_STATUS_ADDINZIP      (2)
+#define APPEND_STATUS_ADDAFTERZIP   (3)
 
 extern zipFile ZEXPORT zipOpen OF((const char *pathname, int append));
 extern zipFile ZEXPORT zipOpen64 OF((const void *pathname, int append));
@@ -124,6 +125,10 @@ extern zipFile ZEXPORT zipOpen64 OF((const void *pathname, int append));
          (useful if the file contain a self extractor code)
      if the file pathname exist and append==APPEND_STATUS_ADDINZIP, we will
        add files in existing zip (be sure you don't add file that doesn't exist)
+     if the file pathname exist and append==APPEND_STATUS_ADDAFTERZIP, files are
+       added as with APPEND_STATUS_ADDINZIP, but written after the end of the
+       existing zip instead of over its central directory, so the existing zip
+       stays valid until the new central directory is written by zipClose
      If the zipfile cannot be opened, the return value is NULL.
      Else, the return value is a zipFile Handle, usable with other function
        of this zip package.
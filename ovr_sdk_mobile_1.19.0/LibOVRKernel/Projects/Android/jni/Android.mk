@@ -47,6 +47,9 @@ LOCAL_SRC_FILES  := ../../../Src/Kernel/OVR_Alg.cpp \
                     ../../../Src/Kernel/OVR_MemBuffer.cpp \
                     ../../../Src/Kernel/OVR_Lexer.cpp \
                     ../../../Src/Kernel/OVR_LogUtils.cpp \
+                    ../../../Src/Kernel/OVR_DeferredLog.cpp \
+                    ../../../Src/Kernel/OVR_Allocators.cpp \
+                    ../../../Src/Kernel/OVR_Atom.cpp \
                     ../../../Src/Android/JniUtils.cpp \
                     ../../../Src/Kernel/OVR_Signal.cpp
 
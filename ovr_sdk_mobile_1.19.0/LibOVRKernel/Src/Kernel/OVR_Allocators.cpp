@@ -0,0 +1,765 @@
+/************************************************************************************
+
+Filename    :   OVR_Allocators.cpp
+Content     :   Installable allocators: thread caching, arena and tracking.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "OVR_Allocators.h"
+
+#include "OVR_LogUtils.h"
+#include <atomic>
+#include <string.h>
+
+namespace OVR {
+
+// Every block handed out by these allocators is preceded by a header of this size,
+// which keeps the 16 byte alignment of the backing allocator.
+static const size_t HeaderSize = 16;
+
+static inline size_t AlignUp( size_t const size, size_t const align )
+{
+    return ( size + align - 1 ) & ~( align - 1 );
+}
+
+
+//------------------------------------------------------------------------
+// ***** ThreadCachingAllocator
+
+static const size_t SizeClassSizes[ThreadCachingAllocator::NumSizeClasses] =
+{
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+static const UInt32 LargeSizeClass = 0xFFFF;
+static const size_t MinChunkSize = 64 * 1024;
+
+struct CachingHeader
+{
+    UInt32  SizeClass;
+};
+
+// Generations are unique across instances so a cache never mistakes the blocks of a
+// destroyed allocator for those of a new one at the same address.
+static std::atomic< unsigned > NextCachingGeneration( 1 );
+
+static inline int GetSizeClass( size_t const size )
+{
+    // small classes are checked linearly, which is cheaper than a search for 12 entries
+    for ( int i = 0; i < ThreadCachingAllocator::NumSizeClasses; ++i )
+    {
+        if ( size <= SizeClassSizes[i] )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+struct ThreadCachingAllocator::ThreadCache
+{
+    ThreadCache()
+        : Owner( NULL )
+        , Generation( 0 )
+    {
+        Reset();
+    }
+
+    // Returns the cached blocks to the owner when the thread exits.
+    ~ThreadCache()
+    {
+        if ( Owner != NULL && Owner->Generation == Generation )
+        {
+            for ( int i = 0; i < NumSizeClasses; ++i )
+            {
+                if ( Counts[i] > 0 )
+                {
+                    Owner->SpillCache( *this, i, Counts[i] );
+                }
+            }
+        }
+    }
+
+    void Reset()
+    {
+        for ( int i = 0; i < NumSizeClasses; ++i )
+        {
+            Lists[i] = NULL;
+            Counts[i] = 0;
+        }
+    }
+
+    ThreadCachingAllocator *    Owner;
+    unsigned                    Generation;
+    FreeBlock *                 Lists[NumSizeClasses];
+    int                         Counts[NumSizeClasses];
+};
+
+ThreadCachingAllocator::ThreadCachingAllocator( Allocator * backing )
+    : Backing( backing )
+    , Chunks( NULL )
+    , Generation( NextCachingGeneration.fetch_add( 1 ) )
+{
+    OVR_ASSERT( backing != NULL );
+    for ( int i = 0; i < NumSizeClasses; ++i )
+    {
+        CentralLists[i] = NULL;
+    }
+    memset( &CurStats, 0, sizeof( CurStats ) );
+}
+
+ThreadCachingAllocator::~ThreadCachingAllocator()
+{
+    // only the destroying thread's cache can be detached here, which is why installed
+    // allocators should be static
+    ThreadCache & cache = CurrentThreadCache();
+    if ( cache.Owner == this )
+    {
+        cache.Reset();
+        cache.Owner = NULL;
+    }
+    FreeChunks();
+}
+
+ThreadCachingAllocator::ThreadCache & ThreadCachingAllocator::CurrentThreadCache()
+{
+    static thread_local ThreadCache cache;
+    return cache;
+}
+
+ThreadCachingAllocator::ThreadCache & ThreadCachingAllocator::GetThreadCache()
+{
+    ThreadCache & cache = CurrentThreadCache();
+    if ( cache.Owner != this || cache.Generation != Generation )
+    {
+        // first use on this thread, or the cached blocks belong to a dead allocator
+        cache.Reset();
+        cache.Owner = this;
+        cache.Generation = Generation;
+    }
+    return cache;
+}
+
+void ThreadCachingAllocator::RefillCache( ThreadCache & cache, int const sizeClass )
+{
+    Lock::Locker locker( &CentralLock );
+
+    if ( CentralLists[sizeClass] == NULL )
+    {
+        // carve a new chunk into blocks of this size class
+        size_t const blockSize = HeaderSize + SizeClassSizes[sizeClass];
+        size_t const chunkSize = MinChunkSize > blockSize * BatchSize ? MinChunkSize : blockSize * BatchSize;
+        UByte * chunk = static_cast< UByte* >( Backing->Alloc( chunkSize ) );
+        if ( chunk == NULL )
+        {
+            return;
+        }
+        *reinterpret_cast< void** >( chunk ) = Chunks;
+        Chunks = chunk;
+        CurStats.ChunkBytes += chunkSize;
+
+        // the first block slot holds the chunk link
+        for ( size_t offset = blockSize; offset + blockSize <= chunkSize; offset += blockSize )
+        {
+            FreeBlock * block = reinterpret_cast< FreeBlock* >( chunk + offset );
+            block->Next = CentralLists[sizeClass];
+            CentralLists[sizeClass] = block;
+        }
+    }
+
+    for ( int i = 0; i < BatchSize && CentralLists[sizeClass] != NULL; ++i )
+    {
+        FreeBlock * block = CentralLists[sizeClass];
+        CentralLists[sizeClass] = block->Next;
+        block->Next = cache.Lists[sizeClass];
+        cache.Lists[sizeClass] = block;
+        cache.Counts[sizeClass]++;
+    }
+    CurStats.CentralRefills++;
+}
+
+void ThreadCachingAllocator::SpillCache( ThreadCache & cache, int const sizeClass, int const count )
+{
+    // unlink the blocks before taking the lock
+    FreeBlock * first = cache.Lists[sizeClass];
+    FreeBlock * last = first;
+    for ( int i = 1; i < count && last->Next != NULL; ++i )
+    {
+        last = last->Next;
+    }
+    int moved = 1;
+    for ( FreeBlock * b = first; b != last; b = b->Next )
+    {
+        moved++;
+    }
+    cache.Lists[sizeClass] = last->Next;
+    cache.Counts[sizeClass] -= moved;
+
+    Lock::Locker locker( &CentralLock );
+    last->Next = CentralLists[sizeClass];
+    CentralLists[sizeClass] = first;
+    CurStats.CentralSpills++;
+}
+
+void ThreadCachingAllocator::FreeChunks()
+{
+    Lock::Locker locker( &CentralLock );
+    while ( Chunks != NULL )
+    {
+        void * next = *reinterpret_cast< void** >( Chunks );
+        Backing->Free( Chunks );
+        Chunks = next;
+    }
+    for ( int i = 0; i < NumSizeClasses; ++i )
+    {
+        CentralLists[i] = NULL;
+    }
+    CurStats.ChunkBytes = 0;
+    // any block still cached by a thread now points into freed memory
+    Generation = NextCachingGeneration.fetch_add( 1 );
+}
+
+void* ThreadCachingAllocator::Alloc( size_t size )
+{
+    int const sizeClass = GetSizeClass( size );
+    if ( sizeClass < 0 )
+    {
+        UByte * p = static_cast< UByte* >( Backing->Alloc( HeaderSize + size ) );
+        if ( p == NULL )
+        {
+            return NULL;
+        }
+        reinterpret_cast< CachingHeader* >( p )->SizeClass = LargeSizeClass;
+        return p + HeaderSize;
+    }
+
+    ThreadCache & cache = GetThreadCache();
+    if ( cache.Lists[sizeClass] == NULL )
+    {
+        RefillCache( cache, sizeClass );
+        if ( cache.Lists[sizeClass] == NULL )
+        {
+            return NULL;
+        }
+    }
+    FreeBlock * block = cache.Lists[sizeClass];
+    cache.Lists[sizeClass] = block->Next;
+    cache.Counts[sizeClass]--;
+
+    UByte * p = reinterpret_cast< UByte* >( block );
+    reinterpret_cast< CachingHeader* >( p )->SizeClass = static_cast< UInt32 >( sizeClass );
+    return p + HeaderSize;
+}
+
+void* ThreadCachingAllocator::Realloc( void* p, size_t newSize )
+{
+    if ( p == NULL )
+    {
+        return Alloc( newSize );
+    }
+
+    UByte * header = static_cast< UByte* >( p ) - HeaderSize;
+    UInt32 const sizeClass = reinterpret_cast< CachingHeader* >( header )->SizeClass;
+    if ( sizeClass == LargeSizeClass )
+    {
+        UByte * newHeader = static_cast< UByte* >( Backing->Realloc( header, HeaderSize + newSize ) );
+        return newHeader != NULL ? newHeader + HeaderSize : NULL;
+    }
+
+    size_t const oldCapacity = SizeClassSizes[sizeClass];
+    if ( newSize <= oldCapacity )
+    {
+        return p;
+    }
+    void * newP = Alloc( newSize );
+    if ( newP == NULL )
+    {
+        return NULL;
+    }
+    memcpy( newP, p, oldCapacity );
+    Free( p );
+    return newP;
+}
+
+void ThreadCachingAllocator::Free( void* p )
+{
+    if ( p == NULL )
+    {
+        return;
+    }
+
+    UByte * header = static_cast< UByte* >( p ) - HeaderSize;
+    UInt32 const sizeClass = reinterpret_cast< CachingHeader* >( header )->SizeClass;
+    if ( sizeClass == LargeSizeClass )
+    {
+        Backing->Free( header );
+        return;
+    }
+
+    ThreadCache & cache = GetThreadCache();
+    FreeBlock * block = reinterpret_cast< FreeBlock* >( header );
+    block->Next = cache.Lists[sizeClass];
+    cache.Lists[sizeClass] = block;
+    cache.Counts[sizeClass]++;
+    if ( cache.Counts[sizeClass] > MaxCachedBlocks )
+    {
+        SpillCache( cache, sizeClass, BatchSize );
+    }
+}
+
+void ThreadCachingAllocator::GetStats( Stats & stats )
+{
+    Lock::Locker locker( &CentralLock );
+    stats = CurStats;
+}
+
+void ThreadCachingAllocator::onSystemShutdown()
+{
+    FreeChunks();
+}
+
+
+//------------------------------------------------------------------------
+// ***** ArenaAllocator
+
+// The arena that allocations on this thread currently go to, if any.
+static thread_local ArenaAllocator * ActiveArena = NULL;
+
+struct ArenaHeader
+{
+    size_t  Size;
+};
+
+ArenaAllocator::Scope::Scope( ArenaAllocator & arena )
+    : Arena( arena )
+    , PrevActive( ActiveArena )
+    , Mark( arena.Used )
+{
+    ActiveArena = &arena;
+}
+
+ArenaAllocator::Scope::~Scope()
+{
+    Arena.Used = Mark;
+    Arena.CurStats.UsedBytes = Mark;
+    ActiveArena = PrevActive;
+}
+
+ArenaAllocator::ArenaAllocator( Allocator * backing, size_t const capacity )
+    : Backing( backing )
+    , Base( NULL )
+    , Capacity( AlignUp( capacity, HeaderSize ) )
+    , Used( 0 )
+{
+    OVR_ASSERT( backing != NULL );
+    Base = static_cast< UByte* >( Backing->Alloc( Capacity ) );
+    if ( Base == NULL )
+    {
+        Capacity = 0;
+    }
+    memset( &CurStats, 0, sizeof( CurStats ) );
+    CurStats.Capacity = Capacity;
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+    OVR_ASSERT( ActiveArena != this );
+    Backing->Free( Base );
+}
+
+bool ArenaAllocator::Owns( void const * p ) const
+{
+    UByte const * b = static_cast< UByte const* >( p );
+    return b >= Base && b < Base + Capacity;
+}
+
+void * ArenaAllocator::BumpAlloc( size_t size )
+{
+    size_t const total = HeaderSize + AlignUp( size, HeaderSize );
+    if ( Used + total > Capacity )
+    {
+        CurStats.OverflowAllocs++;
+        return Backing->Alloc( size );
+    }
+
+    UByte * header = Base + Used;
+    reinterpret_cast< ArenaHeader* >( header )->Size = size;
+    Used += total;
+
+    CurStats.ArenaAllocs++;
+    CurStats.UsedBytes = Used;
+    if ( Used > CurStats.HighWaterBytes )
+    {
+        CurStats.HighWaterBytes = Used;
+    }
+    return header + HeaderSize;
+}
+
+void* ArenaAllocator::Alloc( size_t size )
+{
+    if ( ActiveArena == this )
+    {
+        return BumpAlloc( size );
+    }
+    return Backing->Alloc( size );
+}
+
+void* ArenaAllocator::Realloc( void* p, size_t newSize )
+{
+    if ( p == NULL )
+    {
+        return Alloc( newSize );
+    }
+    if ( !Owns( p ) )
+    {
+        return Backing->Realloc( p, newSize );
+    }
+
+    UByte * header = static_cast< UByte* >( p ) - HeaderSize;
+    size_t const oldSize = reinterpret_cast< ArenaHeader* >( header )->Size;
+    if ( newSize <= oldSize )
+    {
+        return p;
+    }
+
+    // the most recent allocation can grow in place
+    size_t const oldEnd = static_cast< size_t >( header - Base ) + HeaderSize + AlignUp( oldSize, HeaderSize );
+    size_t const newEnd = static_cast< size_t >( header - Base ) + HeaderSize + AlignUp( newSize, HeaderSize );
+    if ( ActiveArena == this && oldEnd == Used && newEnd <= Capacity )
+    {
+        reinterpret_cast< ArenaHeader* >( header )->Size = newSize;
+        Used = newEnd;
+        CurStats.UsedBytes = Used;
+        if ( Used > CurStats.HighWaterBytes )
+        {
+            CurStats.HighWaterBytes = Used;
+        }
+        return p;
+    }
+
+    void * newP = Alloc( newSize );
+    if ( newP != NULL )
+    {
+        memcpy( newP, p, oldSize );
+    }
+    return newP;
+}
+
+void ArenaAllocator::Free( void* p )
+{
+    if ( p == NULL || Owns( p ) )
+    {
+        // released when the scope closes
+        return;
+    }
+    Backing->Free( p );
+}
+
+void ArenaAllocator::GetStats( Stats & stats ) const
+{
+    stats = CurStats;
+}
+
+
+//------------------------------------------------------------------------
+// ***** TrackingAllocator
+
+struct TrackingHeader
+{
+    size_t  Size;
+    int     Site;
+};
+
+TrackingAllocator::TrackingAllocator( Allocator * backing )
+    : Backing( backing )
+{
+    OVR_ASSERT( backing != NULL );
+    memset( Sites, 0, sizeof( Sites ) );
+    memset( &CurStats, 0, sizeof( CurStats ) );
+}
+
+TrackingAllocator::~TrackingAllocator()
+{
+}
+
+// Site 0 collects every allocation without a known call site.
+int TrackingAllocator::FindSite( const char* file, unsigned line )
+{
+    if ( file == NULL )
+    {
+        return 0;
+    }
+    size_t const h = ( reinterpret_cast< size_t >( file ) >> 3 ) * 31 + line;
+    int index = static_cast< int >( h % ( MaxSites - 1 ) ) + 1;
+    for ( int probe = 0; probe < MaxSites - 1; ++probe )
+    {
+        SiteStats & site = Sites[index];
+        if ( site.File == file && site.Line == line )
+        {
+            return index;
+        }
+        if ( site.File == NULL )
+        {
+            site.File = file;
+            site.Line = line;
+            return index;
+        }
+        index = index + 1 < MaxSites ? index + 1 : 1;
+    }
+    CurStats.DroppedSites++;
+    return 0;
+}
+
+void * TrackingAllocator::TrackedAlloc( size_t size, int const site )
+{
+    UByte * header = static_cast< UByte* >( Backing->Alloc( HeaderSize + size ) );
+    if ( header == NULL )
+    {
+        return NULL;
+    }
+    reinterpret_cast< TrackingHeader* >( header )->Size = size;
+    reinterpret_cast< TrackingHeader* >( header )->Site = site;
+
+    SiteStats & s = Sites[site];
+    s.LiveBytes += size;
+    s.LiveAllocs++;
+    s.TotalAllocs++;
+    if ( s.LiveBytes > s.PeakBytes )
+    {
+        s.PeakBytes = s.LiveBytes;
+    }
+    CurStats.LiveBytes += size;
+    CurStats.LiveAllocs++;
+    CurStats.TotalAllocs++;
+    if ( CurStats.LiveBytes > CurStats.PeakBytes )
+    {
+        CurStats.PeakBytes = CurStats.LiveBytes;
+    }
+    return header + HeaderSize;
+}
+
+void* TrackingAllocator::Alloc( size_t size )
+{
+    Lock::Locker locker( &TrackLock );
+    return TrackedAlloc( size, 0 );
+}
+
+void* TrackingAllocator::AllocDebug( size_t size, const char* file, unsigned line )
+{
+    Lock::Locker locker( &TrackLock );
+    return TrackedAlloc( size, FindSite( file, line ) );
+}
+
+void* TrackingAllocator::Realloc( void* p, size_t newSize )
+{
+    if ( p == NULL )
+    {
+        return Alloc( newSize );
+    }
+
+    Lock::Locker locker( &TrackLock );
+    UByte * header = static_cast< UByte* >( p ) - HeaderSize;
+    size_t const oldSize = reinterpret_cast< TrackingHeader* >( header )->Size;
+    int const site = reinterpret_cast< TrackingHeader* >( header )->Site;
+
+    UByte * newHeader = static_cast< UByte* >( Backing->Realloc( header, HeaderSize + newSize ) );
+    if ( newHeader == NULL )
+    {
+        return NULL;
+    }
+    reinterpret_cast< TrackingHeader* >( newHeader )->Size = newSize;
+
+    SiteStats & s = Sites[site];
+    s.LiveBytes = s.LiveBytes - oldSize + newSize;
+    if ( s.LiveBytes > s.PeakBytes )
+    {
+        s.PeakBytes = s.LiveBytes;
+    }
+    CurStats.LiveBytes = CurStats.LiveBytes - oldSize + newSize;
+    if ( CurStats.LiveBytes > CurStats.PeakBytes )
+    {
+        CurStats.PeakBytes = CurStats.LiveBytes;
+    }
+    return newHeader + HeaderSize;
+}
+
+void TrackingAllocator::Free( void* p )
+{
+    if ( p == NULL )
+    {
+        return;
+    }
+
+    Lock::Locker locker( &TrackLock );
+    UByte * header = static_cast< UByte* >( p ) - HeaderSize;
+    size_t const size = reinterpret_cast< TrackingHeader* >( header )->Size;
+    int const site = reinterpret_cast< TrackingHeader* >( header )->Site;
+
+    SiteStats & s = Sites[site];
+    s.LiveBytes -= size;
+    s.LiveAllocs--;
+    CurStats.LiveBytes -= size;
+    CurStats.LiveAllocs--;
+
+    Backing->Free( header );
+}
+
+void TrackingAllocator::GetStats( Stats & stats )
+{
+    Lock::Locker locker( &TrackLock );
+    stats = CurStats;
+}
+
+int TrackingAllocator::GetTopSites( SiteStats * sites, int const maxSites )
+{
+    Lock::Locker locker( &TrackLock );
+    int count = 0;
+    for ( int i = 0; i < MaxSites; ++i )
+    {
+        SiteStats const & s = Sites[i];
+        if ( s.TotalAllocs == 0 )
+        {
+            continue;
+        }
+        // insertion into the sorted output
+        int pos = count < maxSites ? count : maxSites;
+        while ( pos > 0 && sites[pos - 1].LiveBytes < s.LiveBytes )
+        {
+            if ( pos < maxSites )
+            {
+                sites[pos] = sites[pos - 1];
+            }
+            pos--;
+        }
+        if ( pos < maxSites )
+        {
+            sites[pos] = s;
+            if ( count < maxSites )
+            {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void TrackingAllocator::LogStats( int const maxSites )
+{
+    Stats stats;
+    GetStats( stats );
+    OVR_LOG( "TrackingAllocator: %zu live bytes in %zu allocations, peak %zu bytes, %zu total allocations",
+            stats.LiveBytes, stats.LiveAllocs, stats.PeakBytes, stats.TotalAllocs );
+
+    static const int MaxLogSites = 64;
+    SiteStats sites[MaxLogSites];
+    int const count = GetTopSites( sites, maxSites < MaxLogSites ? maxSites : MaxLogSites );
+    for ( int i = 0; i < count; ++i )
+    {
+        SiteStats const & s = sites[i];
+        OVR_LOG( "  %s(%u): %zu live bytes in %zu allocations, peak %zu bytes, %zu total allocations",
+                s.File != NULL ? s.File : "<unknown>", s.Line,
+                s.LiveBytes, s.LiveAllocs, s.PeakBytes, s.TotalAllocs );
+    }
+}
+
+void TrackingAllocator::onSystemShutdown()
+{
+    Stats stats;
+    GetStats( stats );
+    if ( stats.LiveAllocs != 0 )
+    {
+        OVR_WARN( "TrackingAllocator: %zu allocations still live at shutdown", stats.LiveAllocs );
+        LogStats( 16 );
+    }
+}
+
+//------------------------------------------------------------------------
+// ***** AllocationCounter
+
+AllocationCounter::AllocationCounter()
+    : Backing( Allocator::GetInstance() )
+    , NumAllocs( 0 )
+    , NumReallocs( 0 )
+    , NumFrees( 0 )
+    , NumAllocBytes( 0 )
+{
+    OVR_ASSERT( Backing != NULL );
+    Allocator::setInstance( NULL );
+    Allocator::setInstance( this );
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    OVR_ASSERT( Allocator::GetInstance() == this );
+    Allocator::setInstance( NULL );
+    Allocator::setInstance( Backing );
+}
+
+void* AllocationCounter::Alloc( size_t size )
+{
+    NumAllocs.Increment_NoSync();
+    NumAllocBytes.ExchangeAdd_NoSync( size );
+    return Backing->Alloc( size );
+}
+
+void* AllocationCounter::AllocDebug( size_t size, const char* file, unsigned line )
+{
+    NumAllocs.Increment_NoSync();
+    NumAllocBytes.ExchangeAdd_NoSync( size );
+    return Backing->AllocDebug( size, file, line );
+}
+
+void* AllocationCounter::Realloc( void* p, size_t newSize )
+{
+    if ( p == NULL )
+    {
+        NumAllocs.Increment_NoSync();
+    }
+    else
+    {
+        NumReallocs.Increment_NoSync();
+    }
+    NumAllocBytes.ExchangeAdd_NoSync( newSize );
+    return Backing->Realloc( p, newSize );
+}
+
+void AllocationCounter::Free( void* p )
+{
+    if ( p != NULL )
+    {
+        NumFrees.Increment_NoSync();
+    }
+    Backing->Free( p );
+}
+
+void* AllocationCounter::AllocAligned( size_t size, size_t align )
+{
+    NumAllocs.Increment_NoSync();
+    NumAllocBytes.ExchangeAdd_NoSync( size );
+    return Backing->AllocAligned( size, align );
+}
+
+void AllocationCounter::FreeAligned( void* p )
+{
+    if ( p != NULL )
+    {
+        NumFrees.Increment_NoSync();
+    }
+    Backing->FreeAligned( p );
+}
+
+AllocationCounter::Stats AllocationCounter::GetStats() const
+{
+    Stats stats;
+    stats.Allocs = NumAllocs;
+    stats.Reallocs = NumReallocs;
+    stats.Frees = NumFrees;
+    stats.AllocBytes = NumAllocBytes;
+    return stats;
+}
+
+} // namespace OVR
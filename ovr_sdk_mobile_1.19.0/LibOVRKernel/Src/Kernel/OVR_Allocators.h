@@ -0,0 +1,287 @@
+/************************************************************************************
+
+Filename    :   OVR_Allocators.h
+Content     :   Installable allocators: thread caching, arena and tracking.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#ifndef OVR_Allocators_h
+#define OVR_Allocators_h
+
+#include "OVR_Allocator.h"
+#include "OVR_Atomic.h"
+
+namespace OVR {
+
+// All of these allocators can be passed to System::Init, for example:
+//
+//    static ThreadCachingAllocator cachingAllocator( DefaultAllocator::InitSystemSingleton() );
+//    System::Init( Log::ConfigureDefaultLog( LogMask_All ), &cachingAllocator );
+//
+// An installed allocator must outlive every allocation made through it, so they are
+// normally static objects. Allocators that wrap another allocator forward large or
+// untracked requests to it.
+
+
+//------------------------------------------------------------------------
+// ***** ThreadCachingAllocator
+//
+// Small-object allocator with per-thread free lists. Requests up to MaxSmallSize bytes
+// are rounded up to a size class and served from the calling thread's cache without
+// locking. Caches refill from, and spill back to, a central free list in batches.
+// Memory for small blocks is carved from chunks that are only returned to the backing
+// allocator on System::Destroy. Larger requests go straight to the backing allocator.
+//
+// Blocks freed on a different thread than the one that allocated them go to the
+// freeing thread's cache.
+
+class ThreadCachingAllocator : public Allocator
+{
+public:
+    enum
+    {
+        NumSizeClasses  = 12,
+        MaxSmallSize    = 1024,
+        BatchSize       = 32,           // blocks moved between a thread cache and the central list
+        MaxCachedBlocks = BatchSize * 2 // per size class, per thread
+    };
+
+    struct Stats
+    {
+        size_t  ChunkBytes;             // bytes allocated from the backing allocator for small blocks
+        size_t  CentralRefills;         // batches handed out by the central free list
+        size_t  CentralSpills;          // batches returned to the central free list
+    };
+
+    explicit ThreadCachingAllocator( Allocator * backing );
+    virtual ~ThreadCachingAllocator();
+
+    virtual void*   Alloc( size_t size );
+    virtual void*   Realloc( void* p, size_t newSize );
+    virtual void    Free( void* p );
+
+    void            GetStats( Stats & stats );
+
+protected:
+    virtual void    onSystemShutdown();
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock * Next;
+    };
+
+    struct ThreadCache;
+    friend struct ThreadCache;
+
+    Allocator *     Backing;
+    Lock            CentralLock;
+    FreeBlock *     CentralLists[NumSizeClasses];
+    void *          Chunks;         // singly linked through the first word of each chunk
+    unsigned        Generation;     // bumped on shutdown so thread caches drop stale blocks
+    Stats           CurStats;
+
+    static ThreadCache &    CurrentThreadCache();
+    ThreadCache &   GetThreadCache();
+    void            RefillCache( ThreadCache & cache, int const sizeClass );
+    void            SpillCache( ThreadCache & cache, int const sizeClass, int const count );
+    void            FreeChunks();
+
+    ThreadCachingAllocator( ThreadCachingAllocator const & );
+    ThreadCachingAllocator & operator=( ThreadCachingAllocator const & );
+};
+
+
+//------------------------------------------------------------------------
+// ***** ArenaAllocator
+//
+// Linear allocator for per-frame and per-load temporaries. While a Scope is open on a
+// thread, allocations made on that thread are bumped out of a single fixed-size block,
+// Free is a no-op for them, and closing the Scope releases everything allocated since
+// it was opened in one step. Scopes nest. Allocations made outside of a Scope, on other
+// threads, or after the block is exhausted go to the backing allocator.
+//
+// Anything allocated inside a Scope must not be used after the Scope is closed, which
+// includes containers that grew inside the Scope.
+//
+//    {
+//        ArenaAllocator::Scope scope( frameArena );
+//        JSON * json = JSON::Parse( text );
+//        ...
+//        json->Release();
+//    }   // all of the parse temporaries are released here
+
+class ArenaAllocator : public Allocator
+{
+public:
+    struct Stats
+    {
+        size_t  Capacity;
+        size_t  UsedBytes;              // currently bumped
+        size_t  HighWaterBytes;         // most ever bumped
+        size_t  ArenaAllocs;            // allocations served by the arena
+        size_t  OverflowAllocs;         // allocations inside a scope that did not fit
+    };
+
+    class Scope
+    {
+    public:
+        explicit    Scope( ArenaAllocator & arena );
+                    ~Scope();
+
+    private:
+        ArenaAllocator &    Arena;
+        ArenaAllocator *    PrevActive;
+        size_t              Mark;
+
+        Scope( Scope const & );
+        Scope & operator=( Scope const & );
+    };
+
+    ArenaAllocator( Allocator * backing, size_t const capacity );
+    virtual ~ArenaAllocator();
+
+    virtual void*   Alloc( size_t size );
+    virtual void*   Realloc( void* p, size_t newSize );
+    virtual void    Free( void* p );
+
+    // True if p was allocated from the arena block.
+    bool            Owns( void const * p ) const;
+
+    void            GetStats( Stats & stats ) const;
+
+private:
+    Allocator *     Backing;
+    UByte *         Base;
+    size_t          Capacity;
+    size_t          Used;
+    Stats           CurStats;
+
+    void *          BumpAlloc( size_t size );
+
+    ArenaAllocator( ArenaAllocator const & );
+    ArenaAllocator & operator=( ArenaAllocator const & );
+};
+
+
+//------------------------------------------------------------------------
+// ***** TrackingAllocator
+//
+// Wraps another allocator and records, per call site, the live bytes, live allocations,
+// high-water mark and total number of allocations. Call sites are only known for
+// AllocDebug, which OVR_ALLOC uses in OVR_BUILD_DEBUG builds; everything else is recorded
+// under an unknown site. Every allocation carries a small header.
+
+class TrackingAllocator : public Allocator
+{
+public:
+    enum
+    {
+        MaxSites = 1024
+    };
+
+    struct SiteStats
+    {
+        const char *    File;
+        unsigned        Line;
+        size_t          LiveBytes;
+        size_t          LiveAllocs;
+        size_t          PeakBytes;
+        size_t          TotalAllocs;
+    };
+
+    struct Stats
+    {
+        size_t          LiveBytes;
+        size_t          LiveAllocs;
+        size_t          PeakBytes;
+        size_t          TotalAllocs;
+        size_t          DroppedSites;   // allocations whose site did not fit in the site table
+    };
+
+    explicit TrackingAllocator( Allocator * backing );
+    virtual ~TrackingAllocator();
+
+    virtual void*   Alloc( size_t size );
+    virtual void*   AllocDebug( size_t size, const char* file, unsigned line );
+    virtual void*   Realloc( void* p, size_t newSize );
+    virtual void    Free( void* p );
+
+    void            GetStats( Stats & stats );
+    // Copies up to maxSites sites, sorted by live bytes. Returns the number copied.
+    int             GetTopSites( SiteStats * sites, int const maxSites );
+    // Logs the totals and the sites with the most live bytes.
+    void            LogStats( int const maxSites );
+
+protected:
+    // Logs anything that is still allocated.
+    virtual void    onSystemShutdown();
+
+private:
+    Allocator *     Backing;
+    Lock            TrackLock;
+    SiteStats       Sites[MaxSites];
+    Stats           CurStats;
+
+    int             FindSite( const char* file, unsigned line );
+    void *          TrackedAlloc( size_t size, int const site );
+
+    TrackingAllocator( TrackingAllocator const & );
+    TrackingAllocator & operator=( TrackingAllocator const & );
+};
+
+
+//------------------------------------------------------------------------
+// ***** AllocationCounter
+//
+// Counts the calls made through the global allocator while it is in scope, for
+// benchmarks that report allocation counts. It installs itself in front of the current
+// global allocator and forwards everything to it without adding a header, so blocks can
+// cross the counter's lifetime in either direction. Counters must not overlap in time
+// with other threads installing allocators.
+//
+//    AllocationCounter counter;
+//    LoadSomething();
+//    OVR_LOG( "%zu allocations", counter.GetStats().Allocs );
+
+class AllocationCounter : public Allocator
+{
+public:
+    struct Stats
+    {
+        size_t          Allocs;         // including reallocs of NULL
+        size_t          Reallocs;
+        size_t          Frees;
+        size_t          AllocBytes;
+    };
+
+    AllocationCounter();
+    virtual ~AllocationCounter();
+
+    virtual void*   Alloc( size_t size );
+    virtual void*   AllocDebug( size_t size, const char* file, unsigned line );
+    virtual void*   Realloc( void* p, size_t newSize );
+    virtual void    Free( void* p );
+    virtual void*   AllocAligned( size_t size, size_t align );
+    virtual void    FreeAligned( void* p );
+
+    Stats           GetStats() const;
+
+private:
+    Allocator *     Backing;
+    AtomicInt< size_t > NumAllocs;
+    AtomicInt< size_t > NumReallocs;
+    AtomicInt< size_t > NumFrees;
+    AtomicInt< size_t > NumAllocBytes;
+
+    AllocationCounter( AllocationCounter const & );
+    AllocationCounter & operator=( AllocationCounter const & );
+};
+
+} // namespace OVR
+
+#endif // OVR_Allocators_h
@@ -0,0 +1,190 @@
+/************************************************************************************
+
+Filename    :   OVR_Atom.cpp
+Content     :   Interned strings with constant time equality.
+Created     :   10/18/2026
+Notes       :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+************************************************************************************/
+
+#include "OVR_Atom.h"
+#include "OVR_FlatHash.h"
+#include "OVR_Atomic.h"
+
+#include <stdlib.h>
+
+namespace OVR {
+
+// The hash of an empty string is the Bernstein seed.
+const ovrAtom::Entry ovrAtom::EmptyEntry = { 5381, 0, &ovrAtom::EmptyEntry, { 0 } };
+
+//-----------------------------------------------------------------------------------
+// ***** AtomTable
+
+// Atoms can be created by static initializers and used by static destructors, so the
+// table does not go through the installable allocator and is never freed.
+struct AtomTableAllocator
+{
+    static void* Alloc(size_t size)     { return malloc(size); }
+    static void  Free(void* p)          { free(p); }
+};
+
+struct AtomKey
+{
+    const char* Data;
+    size_t      Size;
+    size_t      Hash;
+
+    bool operator == (const AtomKey& other) const
+    {
+        return Hash == other.Hash && Size == other.Size && memcmp(Data, other.Data, Size) == 0;
+    }
+};
+
+struct AtomKeyHash
+{
+    size_t operator()(const AtomKey& key) const { return key.Hash; }
+};
+
+struct AtomTable
+{
+    typedef ovrAtom::Entry Entry;
+
+    Lock                                                            TableLock;
+    FlatHash<AtomKey, const Entry*, AtomKeyHash, AtomTableAllocator>   Entries;
+    size_t                                                          NumBytes;
+
+    AtomTable() : NumBytes(0) { }
+
+    static AtomTable& Get()
+    {
+        static AtomTable* table = new AtomTable();
+        return *table;
+    }
+
+    const Entry* Find(const AtomKey& key) const
+    {
+        if (key.Size == 0)
+            return &ovrAtom::EmptyEntry;
+        const Entry* const* pentry = Entries.GetWithHash(key, key.Hash);
+        return pentry ? *pentry : NULL;
+    }
+
+    // Must be called with TableLock held.
+    const Entry* Intern(const char* str, size_t size, size_t hash)
+    {
+        AtomKey key = { str, size, hash };
+        const Entry* existing = Find(key);
+        if (existing != NULL)
+            return existing;
+
+        Entry* entry = (Entry*)malloc(sizeof(Entry) + size);
+        memcpy(entry->Data, str, size);
+        entry->Data[size] = 0;
+        entry->Size   = size;
+        entry->Hash   = hash;
+        entry->NoCase = entry;
+
+        // Intern the lower-case form first so that the entry is complete when it is added.
+        for (size_t i = 0; i < size; i++)
+        {
+            if (str[i] >= 'A' && str[i] <= 'Z')
+            {
+                char* lower = (char*)malloc(size);
+                for (size_t j = 0; j < size; j++)
+                    lower[j] = (char)OVR_tolower(str[j]);
+                entry->NoCase = Intern(lower, size, String::BernsteinHashFunction(lower, size));
+                free(lower);
+                break;
+            }
+        }
+
+        key.Data = entry->Data;
+        Entries.AddWithHash(key, entry, hash);
+        NumBytes += sizeof(Entry) + size;
+        return entry;
+    }
+};
+
+//-----------------------------------------------------------------------------------
+// ***** ovrAtom
+
+ovrAtom::ovrAtom(const char* str)
+    : pEntry(Intern(str, str ? OVR_strlen(str) : 0))
+{
+}
+
+ovrAtom::ovrAtom(const char* str, size_t size)
+    : pEntry(Intern(str, size))
+{
+}
+
+ovrAtom::ovrAtom(const String& str)
+    : pEntry(Intern(str.ToCStr(), str.GetSize()))
+{
+}
+
+const ovrAtom::Entry* ovrAtom::Intern(const char* str, size_t size)
+{
+    if (size == 0)
+        return &EmptyEntry;
+
+    AtomTable& table = AtomTable::Get();
+    const size_t hash = String::BernsteinHashFunction(str, size);
+    Lock::Locker locker(&table.TableLock);
+    return table.Intern(str, size, hash);
+}
+
+bool ovrAtom::Find(const char* str, ovrAtom& atom)
+{
+    const size_t size = str ? OVR_strlen(str) : 0;
+    AtomKey key = { str, size, String::BernsteinHashFunction(str, size) };
+
+    AtomTable& table = AtomTable::Get();
+    Lock::Locker locker(&table.TableLock);
+    const Entry* entry = table.Find(key);
+    if (entry == NULL)
+        return false;
+    atom.pEntry = entry;
+    return true;
+}
+
+bool ovrAtom::FindNoCase(const char* str, ovrAtom& atom)
+{
+    const size_t size = str ? OVR_strlen(str) : 0;
+    if (size == 0)
+    {
+        atom.pEntry = &EmptyEntry;
+        return true;
+    }
+    char buffer[256];
+    char* lower = (size < sizeof(buffer)) ? buffer : (char*)malloc(size);
+    for (size_t i = 0; i < size; i++)
+        lower[i] = (char)OVR_tolower(str[i]);
+    AtomKey key = { lower, size, String::BernsteinHashFunction(lower, size) };
+
+    const Entry* entry;
+    {
+        AtomTable& table = AtomTable::Get();
+        Lock::Locker locker(&table.TableLock);
+        entry = table.Find(key);
+    }
+    if (lower != buffer)
+        free(lower);
+    if (entry == NULL)
+        return false;
+    atom.pEntry = entry;
+    return true;
+}
+
+void ovrAtom::GetStats(int& numAtoms, size_t& numBytes)
+{
+    AtomTable& table = AtomTable::Get();
+    Lock::Locker locker(&table.TableLock);
+    numAtoms = (int)table.Entries.GetSize();
+    numBytes = table.NumBytes;
+}
+
+} // namespace OVR
@@ -0,0 +1,98 @@
+/************************************************************************************
+
+Filename    :   OVR_Atom.h
+Content     :   Interned strings with constant time equality.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#ifndef OVR_Atom_h
+#define OVR_Atom_h
+
+#include "OVR_String.h"
+
+namespace OVR {
+
+//-----------------------------------------------------------------------------------
+// ***** ovrAtom
+//
+// An ovrAtom refers to a string in a global, thread-safe intern table. Two atoms are
+// equal exactly when they refer to the same entry, so comparing them is a pointer
+// compare, and the hash of every entry is computed once when it is interned. An atom
+// is the size of a pointer and copying it never allocates.
+//
+// Every entry also knows the atom for its lower-case (ASCII) form, which makes case
+// insensitive comparisons between atoms a pointer compare as well.
+//
+// Interned strings are never freed, so atoms are meant for names, tags and keys drawn
+// from a bounded set, not for arbitrary text such as user input or formatted labels.
+
+class ovrAtom
+{
+public:
+    ovrAtom() : pEntry(&EmptyEntry) { }
+    ovrAtom(const char* str);
+    ovrAtom(const char* str, size_t size);
+    ovrAtom(const String& str);
+
+    void        operator = (const char* str)        { *this = ovrAtom(str); }
+    void        operator = (const String& str)      { *this = ovrAtom(str); }
+
+    const char* ToCStr() const                      { return pEntry->Data; }
+    size_t      GetSize() const                     { return pEntry->Size; }
+    bool        IsEmpty() const                     { return pEntry->Size == 0; }
+    // Case-sensitive hash, the same value as String::BernsteinHashFunction.
+    size_t      GetHash() const                     { return pEntry->Hash; }
+
+    // The atom for the lower-case form of this string.
+    ovrAtom     GetNoCase() const                   { return ovrAtom(pEntry->NoCase); }
+
+    bool        EqualsNoCase(const ovrAtom& other) const { return pEntry->NoCase == other.pEntry->NoCase; }
+    int         CompareNoCase(const char* str) const { return OVR_stricmp(pEntry->Data, str ? str : ""); }
+
+    bool        operator == (const ovrAtom& other) const { return pEntry == other.pEntry; }
+    bool        operator != (const ovrAtom& other) const { return pEntry != other.pEntry; }
+    bool        operator == (const char* str) const { return OVR_strcmp(pEntry->Data, str ? str : "") == 0; }
+    bool        operator != (const char* str) const { return !operator == (str); }
+
+    // Looks up an atom without interning the string. Returns false if str has never
+    // been interned, in which case no atom can be equal to it.
+    static bool Find(const char* str, ovrAtom& atom);
+    // Looks up the lower-case atom for str without interning anything. Returns false if
+    // no interned string is equal to str ignoring case.
+    static bool FindNoCase(const char* str, ovrAtom& atom);
+
+    // Number of interned strings and the bytes used by them.
+    static void GetStats(int& numAtoms, size_t& numBytes);
+
+    struct HashFunctor
+    {
+        size_t operator()(const ovrAtom& atom) const { return atom.GetHash(); }
+    };
+
+private:
+    struct Entry
+    {
+        size_t          Hash;
+        size_t          Size;
+        const Entry*    NoCase;
+        char            Data[1];
+    };
+
+    const Entry*    pEntry;
+
+    static const Entry  EmptyEntry;
+
+    explicit ovrAtom(const Entry* entry) : pEntry(entry) { }
+
+    static const Entry* Intern(const char* str, size_t size);
+
+    friend struct AtomTable;
+};
+
+} // namespace OVR
+
+#endif // OVR_Atom_h
@@ -0,0 +1,998 @@
+/************************************************************************************
+
+Filename    :   OVR_DeferredLog.cpp
+Content     :   Deferred, lock-free logging backend for OVR_LOG / OVR_WARN.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "OVR_DeferredLog.h"
+
+#include "OVR_LogUtils.h"
+#include "OVR_Threads.h"
+#include "OVR_Signal.h"
+
+#include <atomic>
+#include <chrono>
+#include <stddef.h>
+#include <string.h>
+
+namespace OVR {
+
+static const int		MAX_RINGS = 128;
+static const int		MAX_TAGS = 512;				// must be a power of 2
+static const int		MAX_TAG_LENGTH = 32;
+static const uint32_t	RING_SLOTS = 256;			// must be a power of 2
+static const int		RECORD_PAYLOAD_SIZE = 224;
+static const int		MAX_SPEC_LENGTH = 32;
+static const int		MAX_FORMATTED_LENGTH = 1024;
+
+static const uint16_t	RECORD_FLAG_TRUNCATED = 1;
+
+//==============================================================
+// ovrLogFormatSpec
+//
+// One parsed printf conversion specification. The same parser is used
+// when capturing arguments on the producer thread and when formatting
+// them again on the writer thread, so both sides always agree on the
+// argument layout.
+enum ovrLogLength
+{
+	LOG_LENGTH_NONE,
+	LOG_LENGTH_HH,
+	LOG_LENGTH_H,
+	LOG_LENGTH_L,
+	LOG_LENGTH_LL,
+	LOG_LENGTH_Z,
+	LOG_LENGTH_J,
+	LOG_LENGTH_T,
+	LOG_LENGTH_LONG_DOUBLE
+};
+
+struct ovrLogFormatSpec
+{
+	char const *	Start;			// points at the '%'
+	int				Length;			// length of the spec including the '%' and conversion
+	int				NumStars;		// number of '*' width / precision arguments
+	ovrLogLength	LengthMod;
+	char			Conversion;
+};
+
+// Returns a pointer past the spec, or nullptr if the spec is malformed.
+static char const * ParseFormatSpec( char const * p, ovrLogFormatSpec & spec )
+{
+	spec.Start = p;
+	spec.NumStars = 0;
+	spec.LengthMod = LOG_LENGTH_NONE;
+	spec.Conversion = 0;
+
+	p++;	// skip '%'
+	while ( *p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' )
+	{
+		p++;
+	}
+	if ( *p == '*' )
+	{
+		spec.NumStars++;
+		p++;
+	}
+	while ( *p >= '0' && *p <= '9' )
+	{
+		p++;
+	}
+	if ( *p == '.' )
+	{
+		p++;
+		if ( *p == '*' )
+		{
+			spec.NumStars++;
+			p++;
+		}
+		while ( *p >= '0' && *p <= '9' )
+		{
+			p++;
+		}
+	}
+	switch ( *p )
+	{
+		case 'h':	p++; if ( *p == 'h' ) { spec.LengthMod = LOG_LENGTH_HH; p++; } else { spec.LengthMod = LOG_LENGTH_H; } break;
+		case 'l':	p++; if ( *p == 'l' ) { spec.LengthMod = LOG_LENGTH_LL; p++; } else { spec.LengthMod = LOG_LENGTH_L; } break;
+		case 'q':	p++; spec.LengthMod = LOG_LENGTH_LL; break;
+		case 'z':	p++; spec.LengthMod = LOG_LENGTH_Z; break;
+		case 'j':	p++; spec.LengthMod = LOG_LENGTH_J; break;
+		case 't':	p++; spec.LengthMod = LOG_LENGTH_T; break;
+		case 'L':	p++; spec.LengthMod = LOG_LENGTH_LONG_DOUBLE; break;
+		default:	break;
+	}
+	if ( *p == 0 )
+	{
+		return nullptr;
+	}
+	spec.Conversion = *p++;
+	spec.Length = static_cast< int >( p - spec.Start );
+	return p;
+}
+
+//==============================================================
+// ovrLogRecord
+struct ovrLogRecord
+{
+	uint64_t		TimeStamp;
+	char const *	Format;
+	int16_t			Prio;
+	int16_t			TagId;
+	uint16_t		PayloadSize;
+	uint16_t		Flags;
+	uint8_t			Payload[RECORD_PAYLOAD_SIZE];
+};
+
+//==============================================================
+// ovrLogArgWriter
+class ovrLogArgWriter
+{
+public:
+	explicit ovrLogArgWriter( ovrLogRecord & record )
+		: Record( record )
+		, Size( 0 )
+	{
+	}
+
+	bool Write( void const * data, int const size )
+	{
+		if ( Size + size > RECORD_PAYLOAD_SIZE )
+		{
+			return false;
+		}
+		memcpy( &Record.Payload[Size], data, size );
+		Size += size;
+		return true;
+	}
+
+	bool WriteInt( int64_t const value ) { return Write( &value, sizeof( value ) ); }
+	bool WriteUInt( uint64_t const value ) { return Write( &value, sizeof( value ) ); }
+	bool WriteDouble( double const value ) { return Write( &value, sizeof( value ) ); }
+
+	bool WriteString( char const * s )
+	{
+		if ( s == nullptr )
+		{
+			s = "(null)";
+		}
+		int const avail = RECORD_PAYLOAD_SIZE - Size - static_cast< int >( sizeof( uint16_t ) );
+		if ( avail < 0 )
+		{
+			return false;
+		}
+		int len = 0;
+		while ( s[len] != 0 && len < avail )
+		{
+			len++;
+		}
+		if ( s[len] != 0 )
+		{
+			Record.Flags |= RECORD_FLAG_TRUNCATED;
+		}
+		uint16_t const len16 = static_cast< uint16_t >( len );
+		Write( &len16, sizeof( len16 ) );
+		return Write( s, len );
+	}
+
+	int		GetSize() const { return Size; }
+
+private:
+	ovrLogRecord &	Record;
+	int				Size;
+};
+
+//==============================================================
+// ovrLogArgReader
+class ovrLogArgReader
+{
+public:
+	explicit ovrLogArgReader( ovrLogRecord const & record )
+		: Record( record )
+		, Offset( 0 )
+	{
+	}
+
+	template< typename T >
+	T Read()
+	{
+		T value = T();
+		if ( Offset + static_cast< int >( sizeof( T ) ) <= Record.PayloadSize )
+		{
+			memcpy( &value, &Record.Payload[Offset], sizeof( T ) );
+			Offset += sizeof( T );
+		}
+		return value;
+	}
+
+	// Copies the string into buffer, which must be at least RECORD_PAYLOAD_SIZE + 1 bytes.
+	void ReadString( char * buffer )
+	{
+		int const len = Read< uint16_t >();
+		int const avail = Record.PayloadSize - Offset;
+		int const copy = len < avail ? len : avail;
+		memcpy( buffer, &Record.Payload[Offset], copy );
+		buffer[copy] = 0;
+		Offset += copy;
+	}
+
+private:
+	ovrLogRecord const &	Record;
+	int						Offset;
+};
+
+// Copies the raw arguments described by fmt into the record.
+// Returns false if the message cannot be deferred.
+static bool CaptureArgs( char const * fmt, va_list args, ovrLogRecord & record )
+{
+	ovrLogArgWriter writer( record );
+
+	for ( char const * p = fmt; *p != 0; )
+	{
+		if ( *p != '%' )
+		{
+			p++;
+			continue;
+		}
+		ovrLogFormatSpec spec;
+		p = ParseFormatSpec( p, spec );
+		if ( p == nullptr )
+		{
+			return false;
+		}
+		for ( int i = 0; i < spec.NumStars; i++ )
+		{
+			if ( !writer.WriteInt( va_arg( args, int ) ) )
+			{
+				return false;
+			}
+		}
+
+		bool ok = true;
+		switch ( spec.Conversion )
+		{
+			case '%':
+				break;
+			case 'd':
+			case 'i':
+				switch ( spec.LengthMod )
+				{
+					case LOG_LENGTH_L:	ok = writer.WriteInt( va_arg( args, long ) ); break;
+					case LOG_LENGTH_LL:	ok = writer.WriteInt( va_arg( args, long long ) ); break;
+					case LOG_LENGTH_Z:	ok = writer.WriteInt( static_cast< int64_t >( va_arg( args, size_t ) ) ); break;
+					case LOG_LENGTH_J:	ok = writer.WriteInt( va_arg( args, intmax_t ) ); break;
+					case LOG_LENGTH_T:	ok = writer.WriteInt( va_arg( args, ptrdiff_t ) ); break;
+					default:			ok = writer.WriteInt( va_arg( args, int ) ); break;
+				}
+				break;
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+			case 'c':
+				switch ( spec.LengthMod )
+				{
+					case LOG_LENGTH_L:	ok = writer.WriteUInt( va_arg( args, unsigned long ) ); break;
+					case LOG_LENGTH_LL:	ok = writer.WriteUInt( va_arg( args, unsigned long long ) ); break;
+					case LOG_LENGTH_Z:	ok = writer.WriteUInt( va_arg( args, size_t ) ); break;
+					case LOG_LENGTH_J:	ok = writer.WriteUInt( va_arg( args, uintmax_t ) ); break;
+					case LOG_LENGTH_T:	ok = writer.WriteUInt( static_cast< uint64_t >( va_arg( args, ptrdiff_t ) ) ); break;
+					default:			ok = writer.WriteUInt( va_arg( args, unsigned int ) ); break;
+				}
+				break;
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A':
+				if ( spec.LengthMod == LOG_LENGTH_LONG_DOUBLE )
+				{
+					ok = writer.WriteDouble( static_cast< double >( va_arg( args, long double ) ) );
+				}
+				else
+				{
+					ok = writer.WriteDouble( va_arg( args, double ) );
+				}
+				break;
+			case 'p':
+				ok = writer.WriteUInt( reinterpret_cast< uintptr_t >( va_arg( args, void * ) ) );
+				break;
+			case 's':
+				if ( spec.LengthMod != LOG_LENGTH_NONE )
+				{
+					return false;	// wide strings are not supported
+				}
+				ok = writer.WriteString( va_arg( args, char const * ) );
+				break;
+			default:
+				return false;	// %n and unknown conversions are logged synchronously
+		}
+		if ( !ok )
+		{
+			return false;
+		}
+	}
+
+	record.PayloadSize = static_cast< uint16_t >( writer.GetSize() );
+	return true;
+}
+
+template< typename T >
+static int FormatArg( char * out, size_t const outSize, char const * spec, int const numStars, int const * stars, T const value )
+{
+	switch ( numStars )
+	{
+		case 0:		return snprintf( out, outSize, spec, value );
+		case 1:		return snprintf( out, outSize, spec, stars[0], value );
+		default:	return snprintf( out, outSize, spec, stars[0], stars[1], value );
+	}
+}
+
+// Formats a captured record back into text.
+static void FormatRecord( ovrLogRecord const & record, char * out, int const outSize )
+{
+	ovrLogArgReader reader( record );
+	char stringArg[RECORD_PAYLOAD_SIZE + 1];
+	int pos = 0;
+
+	for ( char const * p = record.Format; *p != 0 && pos < outSize - 1; )
+	{
+		if ( *p != '%' )
+		{
+			out[pos++] = *p++;
+			continue;
+		}
+		ovrLogFormatSpec spec;
+		p = ParseFormatSpec( p, spec );
+		if ( p == nullptr || spec.Length >= MAX_SPEC_LENGTH )
+		{
+			break;
+		}
+		char specStr[MAX_SPEC_LENGTH];
+		memcpy( specStr, spec.Start, spec.Length );
+		specStr[spec.Length] = 0;
+
+		int stars[2] = { 0, 0 };
+		for ( int i = 0; i < spec.NumStars; i++ )
+		{
+			stars[i] = static_cast< int >( reader.Read< int64_t >() );
+		}
+
+		char * dst = out + pos;
+		size_t const dstSize = static_cast< size_t >( outSize - pos );
+		int written = 0;
+		switch ( spec.Conversion )
+		{
+			case '%':
+				written = snprintf( dst, dstSize, "%%" );
+				break;
+			case 'd':
+			case 'i':
+			{
+				int64_t const v = reader.Read< int64_t >();
+				switch ( spec.LengthMod )
+				{
+					case LOG_LENGTH_L:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< long >( v ) ); break;
+					case LOG_LENGTH_LL:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< long long >( v ) ); break;
+					case LOG_LENGTH_Z:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< size_t >( v ) ); break;
+					case LOG_LENGTH_J:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< intmax_t >( v ) ); break;
+					case LOG_LENGTH_T:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< ptrdiff_t >( v ) ); break;
+					default:			written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< int >( v ) ); break;
+				}
+				break;
+			}
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+			case 'c':
+			{
+				uint64_t const v = reader.Read< uint64_t >();
+				switch ( spec.LengthMod )
+				{
+					case LOG_LENGTH_L:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< unsigned long >( v ) ); break;
+					case LOG_LENGTH_LL:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< unsigned long long >( v ) ); break;
+					case LOG_LENGTH_Z:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< size_t >( v ) ); break;
+					case LOG_LENGTH_J:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< uintmax_t >( v ) ); break;
+					case LOG_LENGTH_T:	written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< ptrdiff_t >( v ) ); break;
+					default:			written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< unsigned int >( v ) ); break;
+				}
+				break;
+			}
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A':
+			{
+				double const v = reader.Read< double >();
+				if ( spec.LengthMod == LOG_LENGTH_LONG_DOUBLE )
+				{
+					written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< long double >( v ) );
+				}
+				else
+				{
+					written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, v );
+				}
+				break;
+			}
+			case 'p':
+				written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars,
+						reinterpret_cast< void * >( static_cast< uintptr_t >( reader.Read< uint64_t >() ) ) );
+				break;
+			case 's':
+				reader.ReadString( stringArg );
+				written = FormatArg( dst, dstSize, specStr, spec.NumStars, stars, static_cast< char const * >( stringArg ) );
+				break;
+			default:
+				break;
+		}
+		if ( written > 0 )
+		{
+			pos += ( written < static_cast< int >( dstSize ) ) ? written : static_cast< int >( dstSize ) - 1;
+		}
+	}
+	out[pos] = 0;
+}
+
+//==============================================================
+// ovrLogRing
+//
+// Single-producer (the owning thread), single-consumer (the writer thread) ring.
+class ovrLogRing
+{
+public:
+	ovrLogRing()
+		: Head( 0 )
+		, Busy( 0 )
+		, Enqueued( 0 )
+		, Truncated( 0 )
+		, Tail( 0 )
+		, Retired( false )
+	{
+	}
+
+	// producer side
+	std::atomic< uint32_t >	Head;
+	std::atomic< int >		Busy;		// inside Enqueue(), see Stop()
+	std::atomic< uint64_t >	Enqueued;
+	std::atomic< uint64_t >	Truncated;
+	uint8_t					ProducerPad[64];
+
+	// consumer side
+	std::atomic< uint32_t >	Tail;
+	std::atomic< bool >		Retired;
+
+	ovrLogRecord			Records[RING_SLOTS];
+};
+
+// Marks the calling thread's ring as retired when the thread exits so the writer can free it.
+class ovrLogRingOwner
+{
+public:
+	ovrLogRingOwner() : Ring( nullptr ) {}
+	~ovrLogRingOwner()
+	{
+		if ( Ring != nullptr )
+		{
+			Ring->Retired.store( true, std::memory_order_release );
+		}
+	}
+
+	ovrLogRing *	Ring;
+};
+
+//==============================================================
+// ovrLogTagEntry
+//
+// Open-addressed cache from tag / file-name pointer to a stripped tag. File
+// tags come from __FILE__ and are always string literals, so the pointer alone
+// identifies them. Explicit tags are verified against the cached text because
+// callers are allowed to pass a temporary buffer.
+struct ovrLogTagEntry
+{
+	std::atomic< char const * >	Key;
+	std::atomic< int >			Ready;
+	char						Name[MAX_TAG_LENGTH];
+};
+
+static ovrLogTagEntry			TagEntries[MAX_TAGS];
+
+static std::atomic< bool >		Active( false );
+static std::atomic< bool >		ExitWriter( false );
+static std::atomic< bool >		WriterFinished( false );
+static std::atomic< int >		FlushRequested( 0 );
+static std::atomic< int >		FlushCompleted( 0 );
+static std::atomic< uint64_t >	Written( 0 );
+static std::atomic< uint64_t >	DroppedRateLimit( 0 );
+static std::atomic< uint64_t >	Synchronous( 0 );
+static ovrDeferredLogParms		Parms;
+static Thread *					WriterThread = nullptr;
+// Never destroyed so producers flushing for a warning can still raise it while Stop() runs.
+static ovrSignal *				WakeSignal = nullptr;
+
+static thread_local ovrLogRingOwner	ThreadRing;
+static thread_local bool			OnWriterThread = false;
+
+// Never destroyed so producer threads can still retire their rings during process exit.
+static Mutex & RingsMutex()
+{
+	static Mutex * mutex = new Mutex();
+	return *mutex;
+}
+
+// Fixed storage so logging works before System::Init has installed the allocator.
+static ovrLogRing *				Rings[MAX_RINGS];
+static int						NumRings = 0;
+
+// Totals of rings that have been freed after their thread exited.
+static ovrDeferredLogStats RetiredStats;
+
+static uint64_t GetTimeStamp()
+{
+	return static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >(
+			std::chrono::steady_clock::now().time_since_epoch() ).count() );
+}
+
+static int FindTagId( char const * key, bool const isFile )
+{
+	uintptr_t const h = reinterpret_cast< uintptr_t >( key );
+	int index = static_cast< int >( ( h >> 3 ) ^ ( h >> 12 ) ) & ( MAX_TAGS - 1 );
+	for ( int probe = 0; probe < MAX_TAGS; )
+	{
+		ovrLogTagEntry & entry = TagEntries[index];
+		char const * cur = entry.Key.load( std::memory_order_acquire );
+		if ( cur == key )
+		{
+			if ( entry.Ready.load( std::memory_order_acquire ) == 0 )
+			{
+				return -1;	// another thread is filling this entry in
+			}
+			if ( !isFile && strcmp( entry.Name, key ) != 0 )
+			{
+				return -1;	// a temporary tag buffer was reused with different contents
+			}
+			return index;
+		}
+		if ( cur == nullptr )
+		{
+			if ( !entry.Key.compare_exchange_strong( cur, key, std::memory_order_acq_rel ) )
+			{
+				continue;	// lost the race for this slot, look at it again
+			}
+			if ( isFile )
+			{
+				FilePathToTag( key, entry.Name, sizeof( entry.Name ) );
+			}
+			else
+			{
+				OVR_strcpy( entry.Name, sizeof( entry.Name ), key );
+			}
+			entry.Ready.store( 1, std::memory_order_release );
+			return ( isFile || strcmp( entry.Name, key ) == 0 ) ? index : -1;
+		}
+		index = ( index + 1 ) & ( MAX_TAGS - 1 );
+		probe++;
+	}
+	return -1;
+}
+
+static ovrLogRing * GetThreadRing()
+{
+	if ( ThreadRing.Ring == nullptr )
+	{
+		Mutex::Locker locker( &RingsMutex() );
+		if ( NumRings >= MAX_RINGS )
+		{
+			return nullptr;
+		}
+		ovrLogRing * ring = new ovrLogRing();
+		Rings[NumRings++] = ring;
+		ThreadRing.Ring = ring;
+	}
+	return ThreadRing.Ring;
+}
+
+static bool EnqueueRecord( ovrLogRing * ring, int const prio, char const * key, bool const isFile, char const * fmt, va_list args )
+{
+	int const tagId = FindTagId( key, isFile );
+	if ( tagId < 0 )
+	{
+		Synchronous.fetch_add( 1, std::memory_order_relaxed );
+		return false;
+	}
+
+	// a full ring is written in place rather than dropped, the writer is falling behind anyway
+	uint32_t const head = ring->Head.load( std::memory_order_relaxed );
+	uint32_t const tail = ring->Tail.load( std::memory_order_acquire );
+	if ( head - tail >= RING_SLOTS )
+	{
+		Synchronous.fetch_add( 1, std::memory_order_relaxed );
+		return false;
+	}
+
+	ovrLogRecord & record = ring->Records[head & ( RING_SLOTS - 1 )];
+	record.Format = fmt;
+	record.Prio = static_cast< int16_t >( prio );
+	record.TagId = static_cast< int16_t >( tagId );
+	record.Flags = 0;
+
+	va_list argsCopy;
+	va_copy( argsCopy, args );
+	bool const captured = CaptureArgs( fmt, argsCopy, record );
+	va_end( argsCopy );
+	if ( !captured )
+	{
+		Synchronous.fetch_add( 1, std::memory_order_relaxed );
+		return false;
+	}
+	if ( ( record.Flags & RECORD_FLAG_TRUNCATED ) != 0 )
+	{
+		ring->Truncated.store( ring->Truncated.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+	}
+	record.TimeStamp = GetTimeStamp();
+
+	ring->Enqueued.store( ring->Enqueued.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+	ring->Head.store( head + 1, std::memory_order_release );
+	return true;
+}
+
+// Warnings and errors are written in place, so they are not lost if the app crashes.
+static bool IsUrgent( int const prio )
+{
+#if defined( OVR_OS_ANDROID )
+	return prio >= ANDROID_LOG_WARN;
+#else
+	OVR_UNUSED( prio );
+	return false;
+#endif
+}
+
+static bool Enqueue( int const prio, char const * key, bool const isFile, char const * fmt, va_list args )
+{
+	if ( !Active.load( std::memory_order_relaxed ) )
+	{
+		return false;
+	}
+	if ( IsUrgent( prio ) )
+	{
+		// the messages queued before this one are written first
+		if ( !OnWriterThread )
+		{
+			ovrDeferredLog::Flush();
+		}
+		return false;
+	}
+
+	ovrLogRing * ring = GetThreadRing();
+	if ( ring == nullptr )
+	{
+		Synchronous.fetch_add( 1, std::memory_order_relaxed );
+		return false;
+	}
+
+	// Marked busy before Active is checked again, so Stop() can wait for every producer that
+	// saw it set to finish its push before the writer drains the rings for the last time.
+	// The flag is in the thread's own ring, so logging threads do not contend for it.
+	ring->Busy.store( 1, std::memory_order_seq_cst );
+	bool const deferred = Active.load( std::memory_order_seq_cst ) && EnqueueRecord( ring, prio, key, isFile, fmt, args );
+	ring->Busy.store( 0, std::memory_order_release );
+	return deferred;
+}
+
+static bool HasPendingRecords()
+{
+	Mutex::Locker locker( &RingsMutex() );
+	for ( int i = 0; i < NumRings; i++ )
+	{
+		if ( Rings[i]->Head.load( std::memory_order_acquire ) != Rings[i]->Tail.load( std::memory_order_acquire ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static void WriteMessage( int const prio, char const * tag, char const * msg )
+{
+#if defined( OVR_OS_ANDROID )
+	__android_log_write( prio, tag, msg );
+#else
+	OVR_UNUSED( prio );
+	fprintf( stdout, "%s: %s\n", tag, msg );
+#endif
+}
+
+//==============================================================
+// ovrLogWriter
+//
+// State owned by the writer thread.
+class ovrLogWriter
+{
+public:
+	ovrLogWriter()
+		: Tokens( 0.0 )
+		, LastRefillTime( 0 )
+		, LastReportTime( 0 )
+		, ReportedDroppedRateLimit( 0 )
+	{
+	}
+
+	void	Drain();
+
+private:
+	double		Tokens;
+	uint64_t	LastRefillTime;
+	uint64_t	LastReportTime;
+	uint64_t	ReportedDroppedRateLimit;
+
+	void	Refill( uint64_t const now );
+	void	Emit( ovrLogRecord const & record );
+	void	ReportDrops( uint64_t const now );
+};
+
+void ovrLogWriter::Refill( uint64_t const now )
+{
+	double const rate = static_cast< double >( Parms.MaxMessagesPerSecond );
+	if ( LastRefillTime == 0 )
+	{
+		Tokens = rate;
+	}
+	else
+	{
+		Tokens += rate * static_cast< double >( now - LastRefillTime ) * 1e-9;
+		if ( Tokens > rate )
+		{
+			Tokens = rate;
+		}
+	}
+	LastRefillTime = now;
+}
+
+void ovrLogWriter::Emit( ovrLogRecord const & record )
+{
+	if ( Parms.MaxMessagesPerSecond > 0 )
+	{
+		if ( Tokens < 1.0 )
+		{
+			DroppedRateLimit.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+		Tokens -= 1.0;
+	}
+
+	char formatted[MAX_FORMATTED_LENGTH];
+	FormatRecord( record, formatted, sizeof( formatted ) );
+	WriteMessage( record.Prio, TagEntries[record.TagId].Name, formatted );
+	Written.fetch_add( 1, std::memory_order_relaxed );
+}
+
+void ovrLogWriter::ReportDrops( uint64_t const now )
+{
+	if ( now - LastReportTime < 1000000000ull )
+	{
+		return;
+	}
+	LastReportTime = now;
+
+	uint64_t const droppedRateLimit = DroppedRateLimit.load( std::memory_order_relaxed );
+	if ( droppedRateLimit == ReportedDroppedRateLimit )
+	{
+		return;
+	}
+
+	char msg[128];
+	snprintf( msg, sizeof( msg ), "dropped %llu messages (rate limited)",
+			static_cast< unsigned long long >( droppedRateLimit - ReportedDroppedRateLimit ) );
+#if defined( OVR_OS_ANDROID )
+	WriteMessage( ANDROID_LOG_WARN, "DeferredLog", msg );
+#else
+	WriteMessage( 0, "DeferredLog", msg );
+#endif
+	ReportedDroppedRateLimit = droppedRateLimit;
+}
+
+void ovrLogWriter::Drain()
+{
+	// Take a snapshot of the rings so producers registering new threads are never blocked for long.
+	// Rings are only freed by this thread, so the snapshot stays valid.
+	ovrLogRing * rings[MAX_RINGS];
+	uint32_t heads[MAX_RINGS];
+	int numRings = 0;
+	{
+		Mutex::Locker locker( &RingsMutex() );
+		numRings = NumRings;
+		memcpy( rings, Rings, numRings * sizeof( rings[0] ) );
+	}
+	for ( int i = 0; i < numRings; i++ )
+	{
+		heads[i] = rings[i]->Head.load( std::memory_order_acquire );
+	}
+
+	uint64_t const now = GetTimeStamp();
+	Refill( now );
+
+	// Merge the rings in time stamp order.
+	for ( ; ; )
+	{
+		int best = -1;
+		uint64_t bestTime = 0;
+		for ( int i = 0; i < numRings; i++ )
+		{
+			uint32_t const tail = rings[i]->Tail.load( std::memory_order_relaxed );
+			if ( tail == heads[i] )
+			{
+				continue;
+			}
+			uint64_t const t = rings[i]->Records[tail & ( RING_SLOTS - 1 )].TimeStamp;
+			if ( best < 0 || t < bestTime )
+			{
+				best = i;
+				bestTime = t;
+			}
+		}
+		if ( best < 0 )
+		{
+			break;
+		}
+		ovrLogRing * ring = rings[best];
+		uint32_t const tail = ring->Tail.load( std::memory_order_relaxed );
+		Emit( ring->Records[tail & ( RING_SLOTS - 1 )] );
+		ring->Tail.store( tail + 1, std::memory_order_release );
+	}
+
+	// Free the rings of threads that have exited and have been fully drained.
+	{
+		Mutex::Locker locker( &RingsMutex() );
+		for ( int i = NumRings - 1; i >= 0; i-- )
+		{
+			ovrLogRing * ring = Rings[i];
+			if ( ring->Retired.load( std::memory_order_acquire ) &&
+					ring->Head.load( std::memory_order_acquire ) == ring->Tail.load( std::memory_order_relaxed ) )
+			{
+				RetiredStats.Enqueued += ring->Enqueued.load( std::memory_order_relaxed );
+				RetiredStats.Truncated += ring->Truncated.load( std::memory_order_relaxed );
+				Rings[i] = Rings[--NumRings];
+				delete ring;
+			}
+		}
+	}
+
+	ReportDrops( now );
+}
+
+static threadReturn_t WriterThreadFn( Thread * thread, void * data )
+{
+	thread->SetThreadName( "DeferredLog" );
+	OnWriterThread = true;
+
+	ovrLogWriter * writer = static_cast< ovrLogWriter * >( data );
+	while ( !ExitWriter.load( std::memory_order_acquire ) )
+	{
+		WakeSignal->Wait( Parms.FlushIntervalMs );
+		int const request = FlushRequested.load( std::memory_order_acquire );
+		writer->Drain();
+		FlushCompleted.store( request, std::memory_order_release );
+	}
+	writer->Drain();
+	FlushCompleted.store( FlushRequested.load( std::memory_order_acquire ), std::memory_order_release );
+	WriterFinished.store( true, std::memory_order_release );
+
+	delete writer;
+	return (threadReturn_t)0;
+}
+
+//==============================================================
+// ovrDeferredLog
+
+void ovrDeferredLog::Start( ovrDeferredLogParms const & parms )
+{
+	if ( WriterThread != nullptr )
+	{
+		return;
+	}
+
+	Parms = parms;
+	ExitWriter.store( false );
+	WriterFinished.store( false );
+	if ( WakeSignal == nullptr )
+	{
+		WakeSignal = ovrSignal::Create( true );
+	}
+
+	Thread::CreateParams createParams(
+			WriterThreadFn,
+			new ovrLogWriter(),
+			128 * 1024,
+			-1,
+			Thread::Running,
+			Thread::BelowNormalPriority );
+	WriterThread = new Thread( createParams );
+
+	Active.store( true, std::memory_order_release );
+}
+
+void ovrDeferredLog::Stop()
+{
+	if ( WriterThread == nullptr )
+	{
+		return;
+	}
+
+	// New messages go down the synchronous path while the writer drains what is left.
+	// Producers that already saw Active set finish their push before the final drain.
+	Active.store( false, std::memory_order_seq_cst );
+	{
+		Mutex::Locker locker( &RingsMutex() );
+		for ( int i = 0; i < NumRings; i++ )
+		{
+			while ( Rings[i]->Busy.load( std::memory_order_seq_cst ) != 0 )
+			{
+				Thread::MSleep( 0 );
+			}
+		}
+	}
+
+	ExitWriter.store( true, std::memory_order_release );
+	WakeSignal->Raise();
+	WriterThread->Join();
+	delete WriterThread;
+	WriterThread = nullptr;
+}
+
+void ovrDeferredLog::Flush()
+{
+	if ( WakeSignal == nullptr || !HasPendingRecords() )
+	{
+		return;
+	}
+	int const request = FlushRequested.fetch_add( 1, std::memory_order_acq_rel ) + 1;
+	while ( FlushCompleted.load( std::memory_order_acquire ) < request && !WriterFinished.load( std::memory_order_acquire ) )
+	{
+		WakeSignal->Raise();
+		Thread::MSleep( 1 );
+	}
+}
+
+bool ovrDeferredLog::IsActive()
+{
+	return Active.load( std::memory_order_relaxed );
+}
+
+bool ovrDeferredLog::EnqueueFileTag( int const prio, char const * fileTag, char const * fmt, va_list args )
+{
+	return Enqueue( prio, fileTag, true, fmt, args );
+}
+
+bool ovrDeferredLog::EnqueueTag( int const prio, char const * tag, char const * fmt, va_list args )
+{
+	return Enqueue( prio, tag, false, fmt, args );
+}
+
+void ovrDeferredLog::GetStats( ovrDeferredLogStats & stats )
+{
+	Mutex::Locker locker( &RingsMutex() );
+
+	stats = RetiredStats;
+	for ( int i = 0; i < NumRings; i++ )
+	{
+		stats.Enqueued += Rings[i]->Enqueued.load( std::memory_order_relaxed );
+		stats.Truncated += Rings[i]->Truncated.load( std::memory_order_relaxed );
+	}
+	stats.Written = Written.load( std::memory_order_relaxed );
+	stats.DroppedRateLimit = DroppedRateLimit.load( std::memory_order_relaxed );
+	stats.Synchronous = Synchronous.load( std::memory_order_relaxed );
+}
+
+} // namespace OVR
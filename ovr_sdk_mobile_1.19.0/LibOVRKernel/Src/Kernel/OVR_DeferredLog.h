@@ -0,0 +1,87 @@
+/************************************************************************************
+
+Filename    :   OVR_DeferredLog.h
+Content     :   Deferred, lock-free logging backend for OVR_LOG / OVR_WARN.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_DeferredLog_h )
+#define OVR_DeferredLog_h
+
+#include "OVR_Types.h"
+#include <stdarg.h>
+#include <stdint.h>
+
+namespace OVR {
+
+//==============================================================
+// ovrDeferredLogParms
+struct ovrDeferredLogParms
+{
+	ovrDeferredLogParms()
+		: MaxMessagesPerSecond( 0 )
+		, FlushIntervalMs( 10 )
+	{
+	}
+
+	// Messages beyond this rate are dropped by the writer thread, which logs how many
+	// once a second. 0 disables rate limiting.
+	int		MaxMessagesPerSecond;
+	// How often the writer thread wakes up to drain the per-thread rings.
+	int		FlushIntervalMs;
+};
+
+//==============================================================
+// ovrDeferredLogStats
+struct ovrDeferredLogStats
+{
+	uint64_t	Enqueued;			// records pushed into a per-thread ring
+	uint64_t	Written;			// records formatted and written by the writer thread
+	uint64_t	DroppedRateLimit;	// records dropped by the writer's rate limiter
+	uint64_t	Truncated;			// records whose string arguments did not fit and were clipped
+	uint64_t	Synchronous;		// messages that could not be deferred and were logged in place
+};
+
+//==============================================================
+// ovrDeferredLog
+//
+// Off unless an app starts it, see ovrSettings::UseDeferredLog. When started,
+// LogWithTag() and LogWithFileTag() no longer format informational messages on
+// the calling thread. Instead the format string pointer, a cached tag id and
+// the raw arguments are copied into a single-producer / single-consumer ring
+// owned by the calling thread. A background thread drains all rings in
+// timestamp order, formats the messages and writes them to logcat (or stdout on
+// other platforms).
+//
+// Format strings must be string literals (or otherwise outlive the writer
+// thread), which is already the case for every OVR_LOG call site. String
+// arguments are copied at call time. Warnings and errors first flush the
+// messages queued before them and are then logged synchronously, so they are
+// not lost if the app crashes right after. Messages that find their ring full,
+// "%n" conversions and messages with too many arguments are also logged
+// synchronously.
+class ovrDeferredLog
+{
+public:
+	static void		Start( ovrDeferredLogParms const & parms = ovrDeferredLogParms() );
+	// Flushes every pending message and stops the writer thread.
+	static void		Stop();
+	// Blocks until every message enqueued before the call has been written.
+	static void		Flush();
+
+	static bool		IsActive();
+
+	// Returns false if the message could not be deferred and must be logged synchronously.
+	static bool		EnqueueFileTag( int const prio, char const * fileTag, char const * fmt, va_list args );
+	static bool		EnqueueTag( int const prio, char const * tag, char const * fmt, va_list args );
+
+	static void		GetStats( ovrDeferredLogStats & stats );
+};
+
+} // namespace OVR
+
+#endif // OVR_DeferredLog_h
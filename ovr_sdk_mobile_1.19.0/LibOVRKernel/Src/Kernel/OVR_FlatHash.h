@@ -0,0 +1,568 @@
+/************************************************************************************
+
+PublicHeader:   None
+Filename    :   OVR_FlatHash.h
+Content     :   Open-addressing hash table with SIMD group probing
+Created     :   10/18/2026
+Notes       :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+************************************************************************************/
+
+#ifndef OVR_FlatHash_h
+#define OVR_FlatHash_h
+
+#include "OVR_Hash.h"
+
+#if defined(__SSE2__) || defined(OVR_CPU_X86_64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define OVR_FLATHASH_SSE2
+#elif defined(__ARM_NEON) || defined(OVR_CPU_ARM_NEON)
+#  include <arm_neon.h>
+#  define OVR_FLATHASH_NEON
+#endif
+
+#if defined(OVR_CC_MSVC)
+#  include <intrin.h>
+#endif
+
+// 'new' operator is redefined/used in this file.
+#undef new
+
+namespace OVR {
+
+//-----------------------------------------------------------------------------------
+// ***** FlatHash
+//
+// Open-addressing hash table in the style of a "Swiss table". Every slot has a one
+// byte control value that is either empty, deleted, or the low 7 bits of the hash of
+// the key stored in the slot. Control bytes are probed 16 at a time with SSE2 or NEON,
+// so most lookups compare against a single key, and a miss usually stops at the first
+// group of control bytes that has an empty slot.
+//
+// FlatHash has the same interface as Hash, with a few differences:
+//
+//   1. Get, Find and Remove take any key type K for which HashF()(K) and
+//      (C == K) are defined, so a String keyed table can be searched with a
+//      const char* or StringDataPtr without building a temporary String.
+//      HashF()(K) must return the same value as for the equivalent C.
+//
+//   2. The hash of a key can be computed once with CalcHash and passed to the
+//      ...WithHash functions.
+//
+//   3. Removing an element never moves other elements, so iterators stay
+//      valid across Remove, including removal of the current element.
+//      Adding elements invalidates all iterators and element pointers.
+
+// Matches control bytes 16 at a time. Match results are bit masks with one set bit
+// per matching slot, at bit (slot << Shift).
+class FlatHashGroup
+{
+public:
+    enum
+    {
+        Width   = 16,
+        Empty   = -128,     // 0x80
+        Deleted = -2        // 0xFE
+    };
+
+    typedef UInt64 MaskType;
+
+#if defined(OVR_FLATHASH_SSE2)
+    enum { Shift = 0 };
+
+    explicit FlatHashGroup(const SByte* ctrl)
+        : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+    { }
+
+    MaskType Match(SByte h2) const
+    {
+        return (MaskType)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), Ctrl));
+    }
+    MaskType MatchEmptyOrDeleted() const
+    {
+        // both have the high bit set
+        return (MaskType)_mm_movemask_epi8(Ctrl);
+    }
+
+private:
+    __m128i Ctrl;
+#elif defined(OVR_FLATHASH_NEON)
+    enum { Shift = 2 };
+
+    explicit FlatHashGroup(const SByte* ctrl)
+        : Ctrl(vld1q_s8(ctrl))
+    { }
+
+    MaskType Match(SByte h2) const
+    {
+        return ToMask(vceqq_s8(Ctrl, vdupq_n_s8(h2)));
+    }
+    MaskType MatchEmptyOrDeleted() const
+    {
+        return ToMask(vcltq_s8(Ctrl, vdupq_n_s8(0)));
+    }
+
+private:
+    int8x16_t Ctrl;
+
+    // Narrows the byte mask to a nibble per slot and keeps one bit of each nibble.
+    static MaskType ToMask(uint8x16_t bytes)
+    {
+        uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(bytes), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+    }
+#else
+    enum { Shift = 0 };
+
+    explicit FlatHashGroup(const SByte* ctrl)
+        : Ctrl(ctrl)
+    { }
+
+    MaskType Match(SByte h2) const
+    {
+        MaskType mask = 0;
+        for (int i = 0; i < Width; i++)
+        {
+            if (Ctrl[i] == h2)
+                mask |= MaskType(1) << i;
+        }
+        return mask;
+    }
+    MaskType MatchEmptyOrDeleted() const
+    {
+        MaskType mask = 0;
+        for (int i = 0; i < Width; i++)
+        {
+            if (Ctrl[i] < 0)
+                mask |= MaskType(1) << i;
+        }
+        return mask;
+    }
+
+private:
+    const SByte* Ctrl;
+#endif
+
+public:
+    MaskType MatchEmpty() const { return Match((SByte)Empty); }
+
+    // Returns the slot of the lowest set bit of a non-zero mask.
+    static OVR_FORCE_INLINE int LowestSlot(MaskType mask)
+    {
+#if defined(OVR_CC_MSVC)
+        unsigned long index;
+#  if defined(OVR_64BIT_POINTERS)
+        _BitScanForward64(&index, mask);
+#  else
+        if ((UInt32)mask != 0)
+            _BitScanForward(&index, (UInt32)mask);
+        else
+        {
+            _BitScanForward(&index, (UInt32)(mask >> 32));
+            index += 32;
+        }
+#  endif
+        return (int)(index >> Shift);
+#else
+        return __builtin_ctzll(mask) >> Shift;
+#endif
+    }
+};
+
+
+template<class C, class U,
+         class HashF = FixedSizeHash<C>,
+         class Allocator = ContainerAllocator<C> >
+class FlatHash
+{
+public:
+    OVR_MEMORY_REDEFINE_NEW(FlatHash)
+
+    typedef U                                       ValueType;
+    typedef FlatHash<C, U, HashF, Allocator>        SelfType;
+    typedef HashNode<C, U, HashF>                   Node;
+
+    FlatHash() : pCtrl(NULL), pNodes(NULL), Capacity(0), Size(0), NumDeleted(0)     { }
+    FlatHash(int sizeHint) : pCtrl(NULL), pNodes(NULL), Capacity(0), Size(0), NumDeleted(0)
+    {
+        SetCapacity(sizeHint);
+    }
+    FlatHash(const SelfType& src) : pCtrl(NULL), pNodes(NULL), Capacity(0), Size(0), NumDeleted(0)
+    {
+        Assign(src);
+    }
+    ~FlatHash()
+    {
+        Clear();
+    }
+
+    void operator = (const SelfType& src)
+    {
+        if (&src != this)
+            Assign(src);
+    }
+
+    // Removes all entries and frees the table.
+    void Clear()
+    {
+        if (pCtrl == NULL)
+            return;
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            if (IsFull(pCtrl[i]))
+                pNodes[i].~Node();
+        }
+        Allocator::Free(pCtrl);
+        pCtrl      = NULL;
+        pNodes     = NULL;
+        Capacity   = 0;
+        Size       = 0;
+        NumDeleted = 0;
+    }
+
+    bool    IsEmpty() const     { return Size == 0; }
+    size_t  GetSize() const     { return Size; }
+    int     GetSizeI() const    { return (int)Size; }
+
+    // Makes room for newSize entries without growing.
+    void SetCapacity(size_t newSize)
+    {
+        size_t capacity = FlatHashGroup::Width;
+        while (MaxLoad(capacity) < newSize)
+            capacity <<= 1;
+        if (capacity > Capacity)
+            Rehash(capacity);
+    }
+
+    // The hash value used by the ...WithHash functions.
+    template<class K>
+    static size_t CalcHash(const K& key)    { return HashF()(key); }
+
+    // Sets the value for key, adding the key if it is not in the table.
+    void Set(const C& key, const U& value)
+    {
+        SetWithHash(key, value, CalcHash(key));
+    }
+    void SetWithHash(const C& key, const U& value, size_t hashValue)
+    {
+        intptr_t index = findIndex(key, hashValue);
+        if (index >= 0)
+            pNodes[index].Second = value;
+        else
+            add(key, value, hashValue);
+    }
+
+    // Adds a key that must not already be in the table.
+    void Add(const C& key, const U& value)
+    {
+        AddWithHash(key, value, CalcHash(key));
+    }
+    void AddWithHash(const C& key, const U& value, size_t hashValue)
+    {
+        OVR_ASSERT(findIndex(key, hashValue) < 0);
+        add(key, value, hashValue);
+    }
+
+    template<class K>
+    void Remove(const K& key)
+    {
+        RemoveWithHash(key, CalcHash(key));
+    }
+    template<class K>
+    void RemoveWithHash(const K& key, size_t hashValue)
+    {
+        intptr_t index = findIndex(key, hashValue);
+        if (index >= 0)
+            removeIndex((size_t)index);
+    }
+
+    // Copies the value into pvalue and returns true if the key was found.
+    template<class K>
+    bool Get(const K& key, U* pvalue) const
+    {
+        intptr_t index = findIndex(key, CalcHash(key));
+        if (index < 0)
+            return false;
+        if (pvalue)
+            *pvalue = pNodes[index].Second;
+        return true;
+    }
+
+    // Returns a pointer to the value, or NULL if the key was not found.
+    template<class K>
+    U* Get(const K& key)                                    { return GetWithHash(key, CalcHash(key)); }
+    template<class K>
+    const U* Get(const K& key) const                        { return GetWithHash(key, CalcHash(key)); }
+    template<class K>
+    U* GetWithHash(const K& key, size_t hashValue)
+    {
+        intptr_t index = findIndex(key, hashValue);
+        return index >= 0 ? &pNodes[index].Second : NULL;
+    }
+    template<class K>
+    const U* GetWithHash(const K& key, size_t hashValue) const
+    {
+        return const_cast<SelfType*>(this)->GetWithHash(key, hashValue);
+    }
+
+    // *** Iterators
+
+    class ConstIterator
+    {
+    public:
+        ConstIterator() : pHash(NULL), Index(0)     { }
+
+        const Node& operator * () const
+        {
+            OVR_ASSERT(pHash != NULL && Index < pHash->Capacity);
+            return pHash->pNodes[Index];
+        }
+        const Node* operator -> () const    { return &(operator*()); }
+
+        void operator ++ ()
+        {
+            if (pHash != NULL && Index < pHash->Capacity)
+                Index = pHash->nextFull(Index + 1);
+        }
+
+        bool operator == (const ConstIterator& it) const
+        {
+            if (IsEnd() && it.IsEnd())
+                return true;
+            return pHash == it.pHash && Index == it.Index;
+        }
+        bool operator != (const ConstIterator& it) const    { return !(*this == it); }
+
+        bool IsEnd() const  { return pHash == NULL || Index >= pHash->Capacity; }
+
+    protected:
+        friend class FlatHash<C, U, HashF, Allocator>;
+
+        ConstIterator(const SelfType* h, size_t index) : pHash(h), Index(index) { }
+
+        const SelfType* pHash;
+        size_t          Index;
+    };
+
+    class Iterator : public ConstIterator
+    {
+    public:
+        Iterator() : ConstIterator()    { }
+
+        Node& operator * () const
+        {
+            OVR_ASSERT(ConstIterator::pHash != NULL && ConstIterator::Index < ConstIterator::pHash->Capacity);
+            return ConstIterator::pHash->pNodes[ConstIterator::Index];
+        }
+        Node* operator -> () const      { return &(operator*()); }
+
+        // Removes the current element. The iterator can still be advanced.
+        void Remove()
+        {
+            OVR_ASSERT(!ConstIterator::IsEnd());
+            const_cast<SelfType*>(ConstIterator::pHash)->removeIndex(ConstIterator::Index);
+        }
+
+    private:
+        friend class FlatHash<C, U, HashF, Allocator>;
+
+        Iterator(SelfType* h, size_t index) : ConstIterator(h, index)   { }
+    };
+
+    Iterator        Begin()             { return Iterator(this, nextFull(0)); }
+    Iterator        End()               { return Iterator(this, Capacity); }
+    ConstIterator   Begin() const       { return ConstIterator(this, nextFull(0)); }
+    ConstIterator   End() const         { return ConstIterator(this, Capacity); }
+
+    template<class K>
+    Iterator Find(const K& key)                                         { return FindWithHash(key, CalcHash(key)); }
+    template<class K>
+    ConstIterator Find(const K& key) const                              { return FindWithHash(key, CalcHash(key)); }
+    template<class K>
+    Iterator FindWithHash(const K& key, size_t hashValue)
+    {
+        intptr_t index = findIndex(key, hashValue);
+        return Iterator(this, index >= 0 ? (size_t)index : Capacity);
+    }
+    template<class K>
+    ConstIterator FindWithHash(const K& key, size_t hashValue) const
+    {
+        return const_cast<SelfType*>(this)->FindWithHash(key, hashValue);
+    }
+
+private:
+    SByte*  pCtrl;          // Capacity control bytes, followed by the node storage,
+                            // which keeps the allocation's alignment since Capacity
+                            // is a multiple of 16
+    Node*   pNodes;
+    size_t  Capacity;       // zero or a power of two multiple of the group width
+    size_t  Size;
+    size_t  NumDeleted;
+
+    static bool IsFull(SByte ctrl)  { return ctrl >= 0; }
+
+    // Tables are rehashed when used plus deleted slots would exceed 7/8 of capacity,
+    // which guarantees every probe sequence reaches an empty slot.
+    static size_t MaxLoad(size_t capacity)  { return capacity - capacity / 8; }
+
+    // Chain-style hash functions often have poor low bits, so the hash is mixed before
+    // it is split into a group index and the stored 7 bit fingerprint.
+    static OVR_FORCE_INLINE size_t MixHash(size_t hashValue)
+    {
+        UInt64 h = (UInt64)hashValue;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return (size_t)h;
+    }
+    static OVR_FORCE_INLINE SByte H2(size_t h)      { return (SByte)(h & 0x7F); }
+    static OVR_FORCE_INLINE size_t H1(size_t h)     { return h >> 7; }
+
+    template<class K>
+    intptr_t findIndex(const K& key, size_t hashValue) const
+    {
+        if (Size == 0)
+            return -1;
+
+        const size_t h          = MixHash(hashValue);
+        const SByte  h2         = H2(h);
+        const size_t groupMask  = Capacity / FlatHashGroup::Width - 1;
+        size_t       group      = H1(h) & groupMask;
+
+        // triangular probing visits every group of a power of two table
+        for (size_t step = 1; ; step++)
+        {
+            const size_t         base = group * FlatHashGroup::Width;
+            const FlatHashGroup  g(pCtrl + base);
+            for (FlatHashGroup::MaskType mask = g.Match(h2); mask != 0; mask &= mask - 1)
+            {
+                const size_t index = base + FlatHashGroup::LowestSlot(mask);
+                if (pNodes[index].First == key)
+                    return (intptr_t)index;
+            }
+            if (g.MatchEmpty() != 0)
+                return -1;
+            group = (group + step) & groupMask;
+        }
+    }
+
+    // Returns the first empty or deleted slot on the probe sequence of h.
+    size_t findInsertSlot(size_t h) const
+    {
+        const size_t groupMask  = Capacity / FlatHashGroup::Width - 1;
+        size_t       group      = H1(h) & groupMask;
+        for (size_t step = 1; ; step++)
+        {
+            const size_t                    base = group * FlatHashGroup::Width;
+            const FlatHashGroup::MaskType   mask = FlatHashGroup(pCtrl + base).MatchEmptyOrDeleted();
+            if (mask != 0)
+                return base + FlatHashGroup::LowestSlot(mask);
+            group = (group + step) & groupMask;
+        }
+    }
+
+    void add(const C& key, const U& value, size_t hashValue)
+    {
+        if (Size + NumDeleted + 1 > MaxLoad(Capacity))
+        {
+            // grow if mostly live, otherwise just drop the tombstones
+            size_t newCapacity = Capacity == 0 ? (size_t)FlatHashGroup::Width : Capacity;
+            if (Size + 1 > MaxLoad(newCapacity) / 2)
+                newCapacity <<= 1;
+            Rehash(newCapacity);
+        }
+
+        const size_t h     = MixHash(hashValue);
+        const size_t index = findInsertSlot(h);
+        if (pCtrl[index] == (SByte)FlatHashGroup::Deleted)
+            NumDeleted--;
+        pCtrl[index] = H2(h);
+        new (&pNodes[index]) Node(typename Node::NodeRef(key, value));
+        Size++;
+    }
+
+    void removeIndex(size_t index)
+    {
+        OVR_ASSERT(IsFull(pCtrl[index]));
+        pNodes[index].~Node();
+        Size--;
+
+        // A probe only continues past a group that had no empty slots, and a group that
+        // was ever full can never have an empty slot again, so a group that still has
+        // one is not on any other key's probe sequence.
+        const size_t base = index & ~(size_t)(FlatHashGroup::Width - 1);
+        if (FlatHashGroup(pCtrl + base).MatchEmpty() != 0)
+        {
+            pCtrl[index] = (SByte)FlatHashGroup::Empty;
+        }
+        else
+        {
+            pCtrl[index] = (SByte)FlatHashGroup::Deleted;
+            NumDeleted++;
+        }
+    }
+
+    size_t nextFull(size_t index) const
+    {
+        while (index < Capacity && !IsFull(pCtrl[index]))
+            index++;
+        return index;
+    }
+
+    void allocTable(size_t capacity)
+    {
+        pCtrl    = (SByte*)Allocator::Alloc(capacity + capacity * sizeof(Node));
+        pNodes   = (Node*)(pCtrl + capacity);
+        Capacity = capacity;
+        memset(pCtrl, FlatHashGroup::Empty, capacity);
+    }
+
+    void Rehash(size_t newCapacity)
+    {
+        SByte*  oldCtrl     = pCtrl;
+        Node*   oldNodes    = pNodes;
+        size_t  oldCapacity = Capacity;
+
+        allocTable(newCapacity);
+        NumDeleted = 0;
+
+        for (size_t i = 0; i < oldCapacity; i++)
+        {
+            if (!IsFull(oldCtrl[i]))
+                continue;
+            const size_t h     = MixHash(HashF()(oldNodes[i].First));
+            const size_t index = findInsertSlot(h);
+            pCtrl[index] = H2(h);
+            new (&pNodes[index]) Node(oldNodes[i]);
+            oldNodes[i].~Node();
+        }
+        if (oldCtrl != NULL)
+            Allocator::Free(oldCtrl);
+    }
+
+    void Assign(const SelfType& src)
+    {
+        Clear();
+        if (src.Size == 0)
+            return;
+
+        // same layout, so no rehashing
+        allocTable(src.Capacity);
+        memcpy(pCtrl, src.pCtrl, Capacity);
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            if (IsFull(pCtrl[i]))
+                new (&pNodes[i]) Node(src.pNodes[i]);
+        }
+        Size       = src.Size;
+        NumDeleted = src.NumDeleted;
+    }
+};
+
+} // OVR
+
+#endif
@@ -25,6 +25,13 @@ of patent rights can be found in the PATENTS file in the same directory.
 
 namespace OVR {
 
+//==============================
+// ovrLexerToken::Equals
+bool ovrLexerToken::Equals( char const * s ) const
+{
+	return OVR_strncmp( Text, s, Length ) == 0 && s[Length] == '\0';
+}
+
 //==============================
 // ovrLexer::ovrLexer
 ovrLexer::ovrLexer( const char * source, const size_t sourceLength, char const * punctuation )
@@ -33,6 +40,8 @@ ovrLexer::ovrLexer( const char * source, const size_t sourceLength, char const *
 	, p( Source )
 	, Error( LEX_RESULT_OK )
 	, Punctuation( NULL )
+	, Scratch( NULL )
+	, ScratchSize( 0 )
 {
 	size_t len = punctuation == NULL ? 0 :OVR_strlen( punctuation );
 	if ( len == 0 )
@@ -45,6 +54,7 @@ ovrLexer::ovrLexer( const char * source, const size_t sourceLength, char const *
 		Punctuation = new char[len + 1];
 		OVR_strcpy( Punctuation, len + 1, punctuation );
 	}
+	InitCharClasses();
 }
 
 //==============================
@@ -71,6 +81,13 @@ ovrLexer::ovrLexer( MemBufferT< uint8_t > const & source, char const * punctuati
 //==============================
 // ovrLexer::ovrLexer
 ovrLexer::ovrLexer( const ovrLexer & other )
+	: Source( NULL )
+	, SourceLength( 0 )
+	, p( NULL )
+	, Error( LEX_RESULT_OK )
+	, Punctuation( NULL )
+	, Scratch( NULL )
+	, ScratchSize( 0 )
 {
 	operator=( other );
 }
@@ -78,6 +95,13 @@ ovrLexer::ovrLexer( const ovrLexer & other )
 //==============================
 // ovrLexer::ovrLexer
 ovrLexer::ovrLexer( ovrLexer && other )
+	: Source( NULL )
+	, SourceLength( 0 )
+	, p( NULL )
+	, Error( LEX_RESULT_OK )
+	, Punctuation( NULL )
+	, Scratch( NULL )
+	, ScratchSize( 0 )
 {
 	operator=( std::move(other) );
 }
@@ -87,8 +111,10 @@ ovrLexer::ovrLexer( ovrLexer && other )
 ovrLexer::~ovrLexer()
 {
 	OVR_ASSERT( Error == LEX_RESULT_OK || Error == LEX_RESULT_EOF );
-	delete Punctuation;
+	delete [] Punctuation;
 	Punctuation = NULL;
+	delete [] Scratch;
+	Scratch = NULL;
 }
 
 //==============================
@@ -106,6 +132,7 @@ ovrLexer & ovrLexer::operator=( const ovrLexer & other )
 	p = other.p;
 	Error = other.Error;
 	
+	delete [] Punctuation;
 	size_t len = other.Punctuation == NULL ? 0 : OVR_strlen( other.Punctuation );
 	if ( len == 0 )
 	{
@@ -117,7 +144,9 @@ ovrLexer & ovrLexer::operator=( const ovrLexer & other )
 		Punctuation = new char[len + 1];
 		OVR_strcpy( Punctuation, len + 1, other.Punctuation );
 	}
+	InitCharClasses();
 
+	// tokens returned by other stay in other's scratch buffer
 	return *this;
 }
 
@@ -131,16 +160,24 @@ ovrLexer & ovrLexer::operator=( ovrLexer && other )
 		return *this;
 	}
 
+	delete [] Punctuation;
+	delete [] Scratch;
+
 	Source = other.Source;
 	SourceLength = other.SourceLength;
 	p = other.p;
 	Error = other.Error;
 	Punctuation = other.Punctuation;
+	Scratch = other.Scratch;
+	ScratchSize = other.ScratchSize;
+	memcpy( CharClass, other.CharClass, sizeof( CharClass ) );
 
 	other.Source = nullptr;
 	other.SourceLength = 0;
 	other.p = nullptr;
 	other.Punctuation = nullptr;
+	other.Scratch = nullptr;
+	other.ScratchSize = 0;
 
 	return *this;
 }
@@ -165,251 +202,235 @@ bool ovrLexer::FindChar( char const * buffer, uint32_t const ch )
 }
 
 //==============================
-// ovrLexer::IsWhitespace
-bool ovrLexer::IsWhitespace( uint32_t const ch )
-{
-	return ( ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' );
-}
-
-//==============================
-// ovrLexer::IsQuote
-bool ovrLexer::IsQuote( uint32_t const ch )
-{
-	bool result = ch == '\"';
-	OVR_ASSERT( result == false || ch <= 255 );	// quotes are assumed elsewhere to be single-byte characters!
-	return result;
-}
-
-//==============================
-// ovrLexer::SkipWhitespace
-ovrLexer::ovrResult ovrLexer::SkipWhitespace( char const * & p, char const * source, size_t const sourceLength )
+// ovrLexer::InitCharClasses
+// Builds the table used to classify each byte of the source. Every byte of a multi-byte
+// UTF-8 character has the high bit set, so no such byte can be mistaken for whitespace,
+// a quote or ASCII punctuation. Only the first byte of non-ASCII punctuation is marked,
+// and the character is decoded to check it when that byte is seen.
+void ovrLexer::InitCharClasses()
 {
-	const char * cur = p; // copy p because we only want to advance if it is whitespace
-	uint32_t ch;
+	memset( CharClass, 0, sizeof( CharClass ) );
+	CharClass[(uint8_t)' '] = CHAR_WHITESPACE;
+	CharClass[(uint8_t)'\t'] = CHAR_WHITESPACE;
+	CharClass[(uint8_t)'\r'] = CHAR_WHITESPACE;
+	CharClass[(uint8_t)'\n'] = CHAR_WHITESPACE;
+	CharClass[(uint8_t)'\"'] = CHAR_QUOTE;
+	CharClass[(uint8_t)'\\'] = CHAR_ESCAPE;
+	CharClass[0] = CHAR_TERMINATOR;
+
+	const char * cur = Punctuation;
 	for ( ; ; )
 	{
-		if ( p >= source + sourceLength )
+		uint8_t const firstByte = static_cast< uint8_t >( *cur );
+		uint32_t const ch = UTF8Util::DecodeNextChar( &cur );
+		if ( ch == '\0' )
 		{
-			return LEX_RESULT_EOF;
-		}
-		
-		ch = UTF8Util::DecodeNextChar( &cur );
-		
-		if ( ch == '\0' || !IsWhitespace( ch ) )
-		{
-			return LEX_RESULT_OK;
+			break;
 		}
-		p = cur;
+		CharClass[firstByte] |= ( ch < 0x80 ) ? CHAR_PUNCTUATION : CHAR_PUNCTUATION_MB;
 	}
 }
 
 //==============================
-// ovrLexer::IsPunctuation
-bool ovrLexer::IsPunctuation( char const * punctuation, uint32_t const ch )
+// ovrLexer::SkipWhitespace
+// Returns false if the end of the source was reached.
+bool ovrLexer::SkipWhitespace()
 {
-	const char * p = punctuation;
-	uint32_t curPunc =  UTF8Util::DecodeNextChar( &p );
-	while( curPunc != '\0' )
+	char const * const end = Source + SourceLength;
+	for ( ; p < end; p++ )
 	{
-		if ( curPunc == ch )
+		if ( ( CharClass[static_cast< uint8_t >( *p )] & CHAR_WHITESPACE ) == 0 )
 		{
 			return true;
 		}
-		curPunc = UTF8Util::DecodeNextChar( &p );
 	}
 	return false;
 }
 
 //==============================
-// ovrLexer::CopyResult
-void ovrLexer::CopyResult( char const * buffer, char * token, size_t const maxTokenSize )
+// ovrLexer::SkipToEndOfLine
+void ovrLexer::SkipToEndOfLine()
 {
-	// NOTE: if any multi-byte characters are ever treated as quotes, this code must change
-	if ( IsQuote( *buffer ) )
+	char const * const end = Source + SourceLength;
+	while ( p < end && *p != '\0' )
 	{
-		size_t len = UTF8Util::GetLength( buffer );
-		const uint32_t lastChar = UTF8Util::GetCharAt( len - 1, buffer );
-		if ( IsQuote( lastChar ) )
+		if ( *p++ == '\n' )
 		{
-			// The first char and last char are single-byte quotes, we can now just step past the first and not copy the last. 
-			char const * start = buffer + 1;
-			len = OVR_strlen( start );	// We do not care about UTF length here since we know the quotes are a single bytes
-			OVR_strncpy( token, maxTokenSize, start, len - 1 );
 			return;
 		}
 	}
-
-	OVR_strcpy( token, maxTokenSize, buffer );
 }
 
 //==============================
-// ovrLexer::PeekNextChar
-uint32_t ovrLexer::PeekNextChar()
+// ovrLexer::TranslateEscapeCode
+uint8_t ovrLexer::TranslateEscapeCode( uint8_t const inCh ) 
 {
-	if ( p >= Source + SourceLength )
+	switch( inCh )
 	{
-		return '\0';
+		case 'n': return '\n';
+		case 'r': return '\r';
+		case 't': return '\t';
+		case '"': return '\"';
+		case '\'': return '\'';
+		default: return '\0';
 	}
-
-	// save state
-	ovrResult error = Error;
-	const char * tp = p;
-	
-	uint32_t ch = UTF8Util::DecodeNextChar( &p );
-	
-	// restore state
-	Error = error;
-	p = tp;	
-
-	return ch;
-}
-
-//==============================
-// ovrLexer::SkipToEndOfLine
-ovrLexer::ovrResult ovrLexer::SkipToEndOfLine()
-{
-	uint32_t ch;
-	do
-	{
-		if ( p >= Source + SourceLength )
-		{
-			return LEX_RESULT_EOF;
-		}
-
-		ch = UTF8Util::DecodeNextChar( &p );
-	} while ( ch != '\n' && ch != '\0' );
-
-	return LEX_RESULT_OK;
 }
 
 //==============================
-// ovrLexer::EmitCodePoint
-// helper function to ensure we never emit a character beyond the end of the buffer and that if we
-// try to we always 0-terminate at the end of the buffer.
-void ovrLexer::EmitCodePoint( uint32_t const ch, char * buffer, ptrdiff_t & bufferOfs, size_t const bufferSize, 
-		char * token, size_t const maxTokenSize ) const
+// ovrLexer::StripQuotes
+// A token can only start with a quote if the quote was escaped. If it also ends with one,
+// both are removed.
+void ovrLexer::StripQuotes( ovrLexerToken & token )
 {
-	if ( static_cast< size_t >( bufferOfs ) < bufferSize )
-	{
-		UTF8Util::EncodeChar( buffer, &bufferOfs, ch );
-	}
-	else
+	if ( token.Length > 0 && token.Text[0] == '\"' && token.Text[token.Length - 1] == '\"' )
 	{
-		// not enough room to emit, so stuff a null character at the end
-		bufferOfs = bufferSize - 1;
-		UTF8Util::EncodeChar( buffer, &bufferOfs, '\0' );
+		token.Text++;
+		token.Length = token.Length > 1 ? token.Length - 2 : 0;
 	}
 }
 
 //==============================
-// ovrLexer::TranslateEscapeCode
-uint32_t ovrLexer::TranslateEscapeCode( uint32_t const inCh ) 
+// ovrLexer::AppendToScratch
+void ovrLexer::AppendToScratch( size_t const offset, char const * text, size_t const length )
 {
-	switch( inCh )
+	if ( offset + length > ScratchSize )
 	{
-		case 'n': return '\n';
-		case 'r': return '\r';
-		case 't': return '\t';
-		case '"': return '\"';
-		case '\'': return '\'';
-		default: return '\0';
+		size_t newSize = ScratchSize < 256 ? 256 : ScratchSize * 2;
+		while ( newSize < offset + length )
+		{
+			newSize *= 2;
+		}
+		char * newScratch = new char[newSize];
+		if ( Scratch != NULL )
+		{
+			memcpy( newScratch, Scratch, offset );
+			delete [] Scratch;
+		}
+		Scratch = newScratch;
+		ScratchSize = newSize;
 	}
+	memcpy( Scratch + offset, text, length );
 }
 
 //==============================
-// ovrLexer::NextToken
-ovrLexer::ovrResult ovrLexer::NextToken( char * token, size_t const maxTokenSize )
+// ovrLexer::LexToken
+// Finds the next token without copying it unless it is split in the source. The source
+// ends at SourceLength or at the first 0 byte, whichever comes first. Returns
+// LEX_RESULT_EOF with an empty token once there are no more tokens, and LEX_RESULT_ERROR
+// with the whole characters that fit if the token and a 0-terminator do not fit in
+// maxTokenSize bytes.
+ovrLexer::ovrResult ovrLexer::LexToken( ovrLexerToken & token, size_t const maxTokenSize )
 {
-	if ( token == NULL || maxTokenSize <= 0 )
+	token.Text = "";
+	token.Length = 0;
+
+	char const * const end = Source + SourceLength;
+	if ( !SkipWhitespace() || *p == '\0' )
 	{
-		OVR_ASSERT( token != NULL && maxTokenSize > 0 );
-		return LEX_RESULT_ERROR;
+		return LEX_RESULT_EOF;
 	}
 
-	token[0] = '\0';
-
-	size_t const BUFF_SIZE = 8192;
-	char buffer[BUFF_SIZE];
-
-	SkipWhitespace( p, Source, SourceLength );
-
 	bool inQuotes = false;
 	bool inComment = false;
-	bool isPunc = false;
-	
-	char const * lastp = p;
+	bool inScratch = false;	// true once the token was copied to the scratch buffer
+	bool started = false;	// true once a character or an opening quote was read
+	char const * text = p;
+	size_t length = 0;
 
-	ptrdiff_t bufferOfs = 0;
 	for ( ; ; )
 	{
-		if ( p > Source + SourceLength )
+		uint8_t const ch = ( p < end ) ? static_cast< uint8_t >( *p ) : 0;
+		uint8_t const charClass = CharClass[ch];
+
+		// stop at the end of the source without consuming it
+		if ( ( charClass & CHAR_TERMINATOR ) != 0 )
 		{
-			EmitCodePoint( '\0', buffer, bufferOfs, BUFF_SIZE, token, maxTokenSize );
-			CopyResult( buffer, token, maxTokenSize );
-			return LEX_RESULT_EOF;
+			if ( !started )
+			{
+				return LEX_RESULT_EOF;
+			}
+			break;
 		}
 
-		lastp = p;
-		uint32_t ch = UTF8Util::DecodeNextChar( &p );
+		char const * const lastp = p;
+		p++;
 
-		// exit if we just read whitespace or a null byte
-		if ( ch == '\0' || ( !inQuotes && !inComment && IsWhitespace( ch ) ) )
+		// exit if we just read whitespace
+		if ( !inQuotes && !inComment && ( charClass & CHAR_WHITESPACE ) != 0 )
 		{
 			break;
 		}
 
-		isPunc = IsPunctuation( Punctuation, ch );
 		if ( inComment )
 		{
-			if ( ch == '*' && PeekNextChar() == '/' )
+			if ( ch == '*' && p < end && *p == '/' )
 			{
 				inComment = false;
 				// consume the '/' character
-				ch = UTF8Util::DecodeNextChar( &p );
+				p++;
 				// skip any whitespace that may follow the comment
-				ovrResult res = SkipWhitespace( p, Source, SourceLength );
-				if ( res != LEX_RESULT_OK ) { return res; }
+				SkipWhitespace();
 			}
 			continue;
 		}
-		else if ( inQuotes && ch == '\\' )
+		else if ( inQuotes && ( charClass & CHAR_ESCAPE ) != 0 )
 		{
-			ch = TranslateEscapeCode( PeekNextChar() );
-			if ( ch == '\0' ) 
+			char const code = static_cast< char >( TranslateEscapeCode( p < end ? static_cast< uint8_t >( *p ) : 0 ) );
+			if ( code == '\0' ) 
 			{
 				return LEX_RESULT_UNKNOWN_ESCAPE; 
 			}
-			UTF8Util::DecodeNextChar( &p );	// consume the escape code
-		}
-		else if ( !inQuotes && !inComment && isPunc )
-		{
-			if ( ch == '/' && PeekNextChar() == '*' )
+			p++;	// consume the escape code
+			if ( !inScratch )
 			{
-				inComment = true;
-				continue;
+				AppendToScratch( 0, text, length );
+				inScratch = true;
 			}
-			else if ( ch == '/' && PeekNextChar() == '/' )
+			AppendToScratch( length, &code, 1 );
+			length++;
+			if ( length + 1 >= maxTokenSize )
 			{
-				SkipToEndOfLine();
-				// skip any whitespace that may start the next line
-				ovrResult res = SkipWhitespace( p, Source, SourceLength );
-				if ( res != LEX_RESULT_OK ) { return res; }
-				continue;
+				break;
 			}
-			else if ( bufferOfs > 0 )
+			continue;
+		}
+		else if ( !inQuotes && ( charClass & ( CHAR_PUNCTUATION | CHAR_PUNCTUATION_MB ) ) != 0 )
+		{
+			char const * puncEnd = p;
+			bool isPunc = ( charClass & CHAR_PUNCTUATION ) != 0;
+			if ( !isPunc )
 			{
-				// we're already in a token, undo the read of the punctuation and exit
-				p = lastp;
-				break;
+				puncEnd = lastp;
+				isPunc = FindChar( Punctuation, UTF8Util::DecodeNextChar( &puncEnd ) );
 			}
-			else
+			if ( isPunc )
 			{
+				if ( ch == '/' && p < end && *p == '*' )
+				{
+					inComment = true;
+					continue;
+				}
+				else if ( ch == '/' && p < end && *p == '/' )
+				{
+					SkipToEndOfLine();
+					// skip any whitespace that may start the next line
+					SkipWhitespace();
+					continue;
+				}
+				else if ( length > 0 )
+				{
+					// we're already in a token, undo the read of the punctuation and exit
+					p = lastp;
+					break;
+				}
 				// if this is the first character of a token, just emit the punctuation
-				EmitCodePoint( ch, buffer, bufferOfs, BUFF_SIZE, token, maxTokenSize );
-				break;
+				p = puncEnd;
+				token.Text = lastp;
+				token.Length = static_cast< size_t >( puncEnd - lastp );
+				return LEX_RESULT_OK;
 			}
 		}
-		else if ( IsQuote( ch ) )
+		else if ( ( charClass & CHAR_QUOTE ) != 0 )
 		{
 			if ( inQuotes )	// if we were in quotes, end the token at the closing quote
 			{
@@ -417,26 +438,109 @@ ovrLexer::ovrResult ovrLexer::NextToken( char * token, size_t const maxTokenSize
 			}
 			// otherwise set the quote flag and skip emission of the quote character
 			inQuotes = true;
+			started = true;
 			continue;
 		}
 
-		int encodeSize = UTF8Util::GetEncodeCharSize( ch );
-		if ( static_cast< size_t >( bufferOfs + encodeSize ) >= BUFF_SIZE - 1 || static_cast< size_t >( bufferOfs + encodeSize + 1 ) >= maxTokenSize )
+		// emit this byte along with the run of ordinary bytes that follows it
+		uint8_t const stopClasses = inQuotes ? ( CHAR_QUOTE | CHAR_ESCAPE | CHAR_TERMINATOR )
+				: ( CHAR_WHITESPACE | CHAR_PUNCTUATION | CHAR_PUNCTUATION_MB | CHAR_QUOTE | CHAR_TERMINATOR );
+		while ( p < end && ( CharClass[static_cast< uint8_t >( *p )] & stopClasses ) == 0 )
+		{
+			p++;
+		}
+		size_t const runLength = static_cast< size_t >( p - lastp );
+		if ( !inScratch && ( length == 0 || text + length == lastp ) )
+		{
+			if ( length == 0 )
+			{
+				text = lastp;
+			}
+		}
+		else
+		{
+			// the token was split by a comment or quote, so it must be copied
+			if ( !inScratch )
+			{
+				AppendToScratch( 0, text, length );
+				inScratch = true;
+			}
+			AppendToScratch( length, lastp, runLength );
+		}
+		length += runLength;
+		started = true;
+		if ( length + 1 >= maxTokenSize )
 		{
-			// truncation
-			UTF8Util::EncodeChar( buffer, &bufferOfs, '\0' );
-			CopyResult( buffer, token, maxTokenSize );
-			return LEX_RESULT_ERROR;
+			break;
 		}
-		UTF8Util::EncodeChar( buffer, &bufferOfs, ch );
 	}
 
-	// always emit a null byte
-	EmitCodePoint( '\0', buffer, bufferOfs, BUFF_SIZE, token, maxTokenSize );
-	CopyResult( buffer, token, maxTokenSize );
+	token.Text = inScratch ? Scratch : text;
+	if ( length > 0 && length + 1 >= maxTokenSize )
+	{
+		// truncation, keeping only whole characters
+		length = maxTokenSize >= 2 ? maxTokenSize - 2 : 0;
+		while ( length > 0 && ( static_cast< uint8_t >( token.Text[length] ) & 0xC0 ) == 0x80 )
+		{
+			length--;
+		}
+		token.Length = length;
+		return LEX_RESULT_ERROR;
+	}
+	token.Length = length;
 	return LEX_RESULT_OK;
 }
 
+//==============================
+// ovrLexer::NextToken
+ovrLexer::ovrResult ovrLexer::NextToken( ovrLexerToken & token )
+{
+	ovrResult const res = LexToken( token, SIZE_MAX );
+	StripQuotes( token );
+	return res;
+}
+
+//==============================
+// ovrLexer::PeekToken
+ovrLexer::ovrResult ovrLexer::PeekToken( ovrLexerToken & token )
+{
+	// save state
+	ovrResult error = Error;
+	const char * tp = p;
+	
+	ovrResult res = NextToken( token );
+	
+	// restore state
+	Error = error;
+	p = tp;
+
+	return res;
+}
+
+//==============================
+// ovrLexer::NextToken
+ovrLexer::ovrResult ovrLexer::NextToken( char * token, size_t const maxTokenSize )
+{
+	if ( token == NULL || maxTokenSize <= 0 )
+	{
+		OVR_ASSERT( token != NULL && maxTokenSize > 0 );
+		return LEX_RESULT_ERROR;
+	}
+
+	ovrLexerToken t;
+	ovrResult const res = LexToken( t, maxTokenSize );
+	StripQuotes( t );
+	if ( t.Length >= maxTokenSize )
+	{
+		// a punctuation token is copied with the same truncation as OVR_strcpy
+		t.Length = maxTokenSize - 1;
+	}
+
+	memcpy( token, t.Text, t.Length );
+	token[t.Length] = '\0';
+	return res;
+}
+
 //==============================
 // ovrLexer::PeekToken
 ovrLexer::ovrResult ovrLexer::PeekToken( char * token, size_t const maxTokenSize )
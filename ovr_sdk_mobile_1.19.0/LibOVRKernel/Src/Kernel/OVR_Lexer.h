@@ -17,11 +17,32 @@ of patent rights can be found in the PATENTS file in the same directory.
 #define OVR_LEXER_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 namespace OVR {
 
 template< class C > class MemBufferT;
 
+//==============================================================
+// ovrLexerToken
+//
+// A token returned by ovrLexer without copying it. Text points into the
+// lexer's source buffer, or into a scratch buffer owned by the lexer when the
+// token had to be assembled (quoted strings with escape codes, or tokens that
+// a comment was removed from). Text is not 0-terminated and is only valid
+// until the lexer is advanced again or destroyed.
+//==============================================================
+struct ovrLexerToken
+{
+	ovrLexerToken() : Text( "" ), Length( 0 ) { }
+
+	// returns true if the token is exactly the 0-terminated string s
+	bool	Equals( char const * s ) const;
+
+	char const *	Text;
+	size_t			Length;
+};
+
 //==============================================================
 // ovrLexer
 //
@@ -36,6 +57,12 @@ template< class C > class MemBufferT;
 //
 // If the / and * characters are passed as punctuation, then the lexer
 // will also treat // and /* */ as C-style comments.
+//
+// Characters are classified with a 256-entry table built from the
+// punctuation string, so the source is scanned a byte at a time and only
+// non-ASCII punctuation needs a UTF-8 decode. NextToken( ovrLexerToken & )
+// returns tokens without copying them; NextToken( char *, size_t ) copies
+// the same token into the caller's buffer.
 //==============================================================
 class ovrLexer 
 {
@@ -66,6 +93,8 @@ public:
 
 	ovrResult	NextToken( char * token, size_t const maxTokenSize );
 	ovrResult	PeekToken( char * token, size_t const maxTokenSize );
+	ovrResult	NextToken( ovrLexerToken & token );
+	ovrResult	PeekToken( ovrLexerToken & token );
 	ovrResult	ExpectToken( char const * expectedToken, char * token, size_t const maxTokenSize );
 	ovrResult	ExpectPunctuation( char const * punc, char * token, size_t const maxTokenSize );
 
@@ -81,19 +110,26 @@ public:
 	ovrResult	GetError() const { return Error; }
 
 private:
+	// character classes
+	enum
+	{
+		CHAR_WHITESPACE		= 1 << 0,
+		CHAR_PUNCTUATION	= 1 << 1,	// single-byte punctuation
+		CHAR_PUNCTUATION_MB	= 1 << 2,	// first byte of at least one multi-byte punctuation character
+		CHAR_QUOTE			= 1 << 3,
+		CHAR_ESCAPE			= 1 << 4,
+		CHAR_TERMINATOR		= 1 << 5	// the 0 byte
+	};
+
 	static	bool		FindChar( char const * buffer, uint32_t const ch );
-	static	bool		IsWhitespace( uint32_t const ch );
-	static	bool		IsQuote( uint32_t const ch );
-	static	ovrResult	SkipWhitespace( char const * & p, char const * source, size_t const sourceLength );
-	static	bool		IsPunctuation( char const * punctuation, uint32_t const ch );
-	static	void		CopyResult( char const * buffer, char * token, size_t const maxTokenSize );
-	static	uint32_t	TranslateEscapeCode( uint32_t const inCh );
-	
-	uint32_t 		PeekNextChar();
-	ovrResult 		SkipToEndOfLine();
+	static	uint8_t		TranslateEscapeCode( uint8_t const inCh );
+	static	void		StripQuotes( ovrLexerToken & token );
 
-	void			EmitCodePoint( uint32_t const ch, char * buffer, ptrdiff_t & bufferOfs, size_t const bufferSize, 
-							char * token, size_t const maxTokenSize ) const;
+	void			InitCharClasses();
+	bool			SkipWhitespace();
+	void			SkipToEndOfLine();
+	ovrResult		LexToken( ovrLexerToken & token, size_t const maxTokenSize );
+	void			AppendToScratch( size_t const offset, char const * text, size_t const length );
 
 private:
 	const char *	Source;
@@ -101,6 +137,9 @@ private:
 	const char *	p;	// pointer to current position
 	ovrResult		Error;	
 	char *			Punctuation;	// UTF-8 string holding characters to lex as punctuation (may be empty)
+	char *			Scratch;		// holds tokens that are not contiguous in the source
+	size_t			ScratchSize;
+	uint8_t			CharClass[256];
 };
 
 } // namespace OVR
@@ -10,6 +10,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 *************************************************************************************/
 
 #include "OVR_LogUtils.h"
+#include "OVR_DeferredLog.h"
 
 #if defined( WIN32 ) || defined( WIN64 ) || defined( _WIN32 ) || defined( _WIN64 )
 #define NOMINMAX	// stop Windows.h from redefining min and max and breaking std::min / std::max
@@ -26,6 +27,12 @@ void LogWithTag( const int prio, const char * tag, const char * fmt, ... )
 #if defined( OVR_OS_ANDROID )
 	va_list ap;
 	va_start( ap, fmt );
+	// warnings and errors are not deferred, but first flush the messages queued before them
+	if ( OVR::ovrDeferredLog::IsActive() && OVR::ovrDeferredLog::EnqueueTag( prio, tag, fmt, ap ) )
+	{
+		va_end( ap );
+		return;
+	}
 	__android_log_vprint( prio, tag, fmt, ap );
 	va_end( ap );
 #elif defined( OVR_OS_WIN32 )
@@ -76,6 +83,19 @@ void LogWithFileTag( const int prio, const char * fileTag, const char * fmt, ...
 #if defined( OVR_OS_ANDROID )
 	va_list ap, ap2;
 
+	// When deferred logging is active the tag lookup and formatting happen on the writer thread.
+	// Warnings and errors are not deferred, but first flush the messages queued before them.
+	if ( OVR::ovrDeferredLog::IsActive() )
+	{
+		va_start( ap, fmt );
+		const bool deferred = OVR::ovrDeferredLog::EnqueueFileTag( prio, fileTag, fmt, ap );
+		va_end( ap );
+		if ( deferred )
+		{
+			return;
+		}
+	}
+
 	// fileTag will be something like "jni/App.cpp", which we
 	// want to strip down to just "App"
 	char strippedTag[128];
@@ -42,15 +42,14 @@ String::DataDesc String::NullData = {String_LengthIsSize, 1, {0} };
 
 String::String()
 {
-    pData = &NullData;
-    pData->AddRef();
+    SetLocalEmpty();
 };
 
 String::String(const char* pdata)
 {
     // Obtain length in bytes; it doesn't matter if _data is UTF8.
     size_t size = pdata ? OVR_strlen(pdata) : 0; 
-    pData = AllocDataCopy1(size, 0, pdata, size);
+    InitData(size, 0, pdata, size);
 };
 
 String::String(const char* pdata1, const char* pdata2, const char* pdata3)
@@ -60,40 +59,40 @@ String::String(const char* pdata1, const char* pdata2, const char* pdata3)
     size_t size2 = pdata2 ? OVR_strlen(pdata2) : 0; 
     size_t size3 = pdata3 ? OVR_strlen(pdata3) : 0; 
 
-    DataDesc *pdataDesc = AllocDataCopy2(size1 + size2 + size3, 0,
-                                         pdata1, size1, pdata2, size2);
-    memcpy(pdataDesc->Data + size1 + size2, pdata3, size3);   
-    pData = pdataDesc;    
+    char* pdest = InitData(size1 + size2 + size3, 0, pdata1, size1, pdata2, size2);
+    memcpy(pdest + size1 + size2, pdata3, size3);   
 }
 
 String::String(const char* pdata, size_t size)
 {
     OVR_ASSERT((size == 0) || (pdata != 0));
-    pData = AllocDataCopy1(size, 0, pdata, size);
+    InitData(size, 0, pdata, size);
 };
 
 
 String::String(const InitStruct& src, size_t size)
 {
-    pData = AllocData(size, 0);
-    src.InitString(GetData()->Data, size);
+    src.InitString(InitData(size, 0, 0, 0), size);
 }
 
 String::String(const String& src)
 {    
-    pData = src.GetData();
-    pData->AddRef();
+    DataDesc* psdata = src.GetHeapData();
+    pData = psdata;
+    if (psdata)
+        psdata->AddRef();
+    else
+        Local = src.Local;
 }
 
 String::String(const StringBuffer& src)
 {
-    pData = AllocDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize());
+    InitData(src.GetSize(), 0, src.ToCStr(), src.GetSize());
 }
 
 String::String(const wchar_t* data)
 {
-    pData = &NullData;
-    pData->AddRef();
+    SetLocalEmpty();
     // Simplified logic for wchar_t constructor.
     if (data)    
         *this = data;    
@@ -137,6 +136,52 @@ String::DataDesc* String::AllocDataCopy2(size_t size, size_t lengthIsSize,
     return pdesc;
 }
 
+char* String::InitData(size_t size, size_t lengthIsSize,
+                       const char* pdata1, size_t copySize1,
+                       const char* pdata2, size_t copySize2)
+{
+    OVR_ASSERT(copySize1 + copySize2 <= size);
+    if (size <= LocalCapacity)
+    {
+        pData = NULL;
+        Local.Size = size | lengthIsSize;
+        memcpy(Local.Data, pdata1, copySize1);
+        memcpy(Local.Data + copySize1, pdata2, copySize2);
+        Local.Data[size] = 0;
+        return Local.Data;
+    }
+    pData = AllocDataCopy2(size, lengthIsSize, pdata1, copySize1, pdata2, copySize2);
+    return pData->Data;
+}
+
+char* String::ReplaceData(size_t size, size_t lengthIsSize,
+                          const char* pdata1, size_t copySize1,
+                          const char* pdata2, size_t copySize2,
+                          const char* pdata3, size_t copySize3)
+{
+    OVR_ASSERT(copySize1 + copySize2 + copySize3 <= size);
+    if (size <= LocalCapacity)
+    {
+        // The pieces can point into Local, so assemble them on the side.
+        char buffer[LocalCapacity];
+        memcpy(buffer, pdata1, copySize1);
+        memcpy(buffer + copySize1, pdata2, copySize2);
+        memcpy(buffer + copySize1 + copySize2, pdata3, copySize3);
+        ReleaseData();
+        pData = NULL;
+        Local.Size = size | lengthIsSize;
+        memcpy(Local.Data, buffer, copySize1 + copySize2 + copySize3);
+        Local.Data[size] = 0;
+        return Local.Data;
+    }
+
+    DataDesc* pnewData = AllocDataCopy2(size, lengthIsSize, pdata1, copySize1, pdata2, copySize2);
+    memcpy(pnewData->Data + copySize1 + copySize2, pdata3, copySize3);
+    ReleaseData();
+    SetData(pnewData);
+    return pnewData->Data;
+}
+
 
 size_t String::GetLength() const 
 {
@@ -218,9 +263,8 @@ void String::AppendChar(uint32_t ch)
     UTF8Util::EncodeChar(buff, &encodeSize, ch);
     OVR_ASSERT(encodeSize >= 0);
 
-    SetData(AllocDataCopy2(size + (size_t)encodeSize, 0,
-                           pdata->Data, size, buff, (size_t)encodeSize));
-    pdata->Release();
+    ReplaceData(size + (size_t)encodeSize, 0,
+                pdata->Data, size, buff, (size_t)encodeSize);
 }
 
 
@@ -233,12 +277,9 @@ void String::AppendString(const wchar_t* pstr, intptr_t len)
     size_t      oldSize = pdata->GetSize();    
     size_t      encodeSize = (size_t)UTF8Util::GetEncodeStringSize(pstr, len);
 
-    DataDesc*   pnewData = AllocDataCopy1(oldSize + (size_t)encodeSize, 0,
-                                          pdata->Data, oldSize);
-    UTF8Util::EncodeString(pnewData->Data + oldSize,  pstr, len);
-
-    SetData(pnewData);
-    pdata->Release();
+    char*       pnewData = ReplaceData(oldSize + (size_t)encodeSize, 0,
+                                       pdata->Data, oldSize);
+    UTF8Util::EncodeString(pnewData + oldSize,  pstr, len);
 }
 
 
@@ -252,25 +293,18 @@ void String::AppendString(const char* putf8str, intptr_t utf8StrSz)
     DataDesc*   pdata = GetData();
     size_t      oldSize = pdata->GetSize();
 
-    SetData(AllocDataCopy2(oldSize + (size_t)utf8StrSz, 0,
-                           pdata->Data, oldSize, putf8str, (size_t)utf8StrSz));
-    pdata->Release();
+    ReplaceData(oldSize + (size_t)utf8StrSz, 0,
+                pdata->Data, oldSize, putf8str, (size_t)utf8StrSz);
 }
 
 void    String::AssignString(const InitStruct& src, size_t size)
 {
-    DataDesc*   poldData = GetData();
-    DataDesc*   pnewData = AllocData(size, 0);
-    src.InitString(pnewData->Data, size);
-    SetData(pnewData);
-    poldData->Release();
+    src.InitString(ReplaceData(size, 0, 0, 0), size);
 }
 
 void    String::AssignString(const char* putf8str, size_t size)
 {
-    DataDesc* poldData = GetData();
-    SetData(AllocDataCopy1(size, 0, putf8str, size));
-    poldData->Release();
+    ReplaceData(size, 0, putf8str, size);
 }
 
 void    String::operator = (const char* pstr)
@@ -280,32 +314,36 @@ void    String::operator = (const char* pstr)
 
 void    String::operator = (const wchar_t* pwstr)
 {
-    DataDesc*   poldData = GetData();
     size_t      size = pwstr ? (size_t)UTF8Util::GetEncodeStringSize(pwstr) : 0;
 
-    DataDesc*   pnewData = AllocData(size, 0);
-    UTF8Util::EncodeString(pnewData->Data, pwstr);
-    SetData(pnewData);
-    poldData->Release();
+    char*       pnewData = ReplaceData(size, 0, 0, 0);
+    if (pwstr)
+        UTF8Util::EncodeString(pnewData, pwstr);
 }
 
 
 void    String::operator = (const String& src)
 {     
-    DataDesc*    psdata = src.GetData();
-    DataDesc*    pdata = GetData();    
+    DataDesc*    psdata = src.GetHeapData();
 
-    SetData(psdata);
-    psdata->AddRef();
-    pdata->Release();
+    if (psdata)
+    {
+        psdata->AddRef();
+        ReleaseData();
+        SetData(psdata);
+    }
+    else if (&src != this)
+    {
+        ReleaseData();
+        pData = NULL;
+        Local = src.Local;
+    }
 }
 
 
 void    String::operator = (const StringBuffer& src)
 { 
-    DataDesc* polddata = GetData();    
-    SetData(AllocDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize()));
-    polddata->Release();
+    ReplaceData(src.GetSize(), 0, src.ToCStr(), src.GetSize());
 }
 
 void    String::operator += (const String& src)
@@ -316,9 +354,8 @@ void    String::operator += (const String& src)
                 srcSize  = psrcData->GetSize();
     size_t      lflag    = pourData->GetLengthFlag() & psrcData->GetLengthFlag();
 
-    SetData(AllocDataCopy2(ourSize + srcSize, lflag,
-                           pourData->Data, ourSize, psrcData->Data, srcSize));
-    pourData->Release();
+    ReplaceData(ourSize + srcSize, lflag,
+                pourData->Data, ourSize, psrcData->Data, srcSize);
 }
 
 
@@ -354,10 +391,9 @@ void    String::Remove(size_t posAt, intptr_t removeLength)
     intptr_t bytePos    = UTF8Util::GetByteIndex(posAt, pdata->Data, oldSize);
     intptr_t removeSize = UTF8Util::GetByteIndex(removeLength, pdata->Data + bytePos, oldSize-bytePos);
 
-    SetData(AllocDataCopy2(oldSize - removeSize, pdata->GetLengthFlag(),
-                           pdata->Data, bytePos,
-                           pData->Data + bytePos + removeSize, (oldSize - bytePos - removeSize)));
-    pdata->Release();
+    ReplaceData(oldSize - removeSize, pdata->GetLengthFlag(),
+                pdata->Data, bytePos,
+                pdata->Data + bytePos + removeSize, (oldSize - bytePos - removeSize));
 }
 
 
@@ -384,9 +420,8 @@ String   String::Substring(size_t start, size_t end) const
 
 void String::Clear()
 {   
-    NullData.AddRef();
-    GetData()->Release();
-    SetData(&NullData);
+    ReleaseData();
+    SetLocalEmpty();
 }
 
 
@@ -450,12 +485,9 @@ String& String::Insert(const char* substr, size_t posAt, intptr_t strSize)
 
     OVR_ASSERT(byteIndex <= oldSize);
     
-    DataDesc* pnewData = AllocDataCopy2(oldSize + insertSize, 0,
-                                        poldData->Data, byteIndex, substr, insertSize);
-    memcpy(pnewData->Data + byteIndex + insertSize,
-           poldData->Data + byteIndex, oldSize - byteIndex);
-    SetData(pnewData);
-    poldData->Release();
+    ReplaceData(oldSize + insertSize, 0,
+                poldData->Data, byteIndex, substr, insertSize,
+                poldData->Data + byteIndex, oldSize - byteIndex);
     return *this;
 }
 
@@ -534,7 +566,9 @@ size_t String::BernsteinHashFunctionCIS(const void* pdataIn, size_t size, size_t
     while (size > 0)
     {
         size--;
-        h = ((h << 5) + h) ^ OVR_tolower(pdata[size]);
+        // branchless OVR_tolower, this is on the path of every StringHash lookup
+        const unsigned c = pdata[size];
+        h = ((h << 5) + h) ^ (c + ((unsigned)((c - 'A') < 26u) << 5));
     }
 
     // Alternative: "sdbm" hash function, suggested at same web page above.
@@ -47,7 +47,11 @@ class StringBuffer;
 // ***** String Class 
 
 // String is UTF8 based string class with copy-on-write implementation
-// for assignment.
+// for assignment. Strings of up to LocalCapacity bytes are stored inline
+// and never touch the heap or the reference count. A pointer returned by
+// ToCStr() on a short string points into the String object itself, so it
+// is only valid for as long as the String is neither modified nor moved
+// (for example by a growing Array).
 
 class String
 {
@@ -106,6 +110,24 @@ protected:
         HT_Mask     = 3
     };
 
+public:
+    enum
+    {
+        // Strings up to this many bytes are stored inline.
+        LocalCapacity = 19
+    };
+
+protected:
+    // Inline storage for short strings, laid out like DataDesc. RefCount is
+    // never used, inline data is always copied.
+    struct LocalDataDesc
+    {
+        size_t   Size;
+        int32_t  RefCount;
+        char     Data[LocalCapacity + 1];
+    };
+
+    // NULL when the string is stored in Local.
     union {
         DataDesc* pData;
         size_t    HeapTypeBits;
@@ -114,16 +136,38 @@ protected:
         DataDesc* pData;
         size_t    HeapTypeBits;
     } DataDescUnion;
+    LocalDataDesc Local;
 
     inline HeapType    GetHeapType() const { return (HeapType) (HeapTypeBits & HT_Mask); }
 
-    inline DataDesc*   GetData() const
+    // Returns the heap data, or NULL if the string is stored inline.
+    inline DataDesc*   GetHeapData() const
     {
         DataDescUnion u;
         u.pData    = pData;
         u.HeapTypeBits = (u.HeapTypeBits & ~(size_t)HT_Mask);
         return u.pData;
     }
+
+    inline DataDesc*   GetData() const
+    {
+        DataDesc* pdesc = GetHeapData();
+        return pdesc ? pdesc : (DataDesc*)const_cast<LocalDataDesc*>(&Local);
+    }
+
+    inline void        ReleaseData()
+    {
+        DataDesc* pdesc = GetHeapData();
+        if (pdesc)
+            pdesc->Release();
+    }
+
+    inline void        SetLocalEmpty()
+    {
+        pData         = NULL;
+        Local.Size    = size_t(1) << Flag_LengthIsSizeShift;
+        Local.Data[0] = 0;
+    }
     
     inline void        SetData(DataDesc* pdesc)
     {
@@ -141,6 +185,18 @@ protected:
                                const char* pdata1, size_t copySize1,
                                const char* pdata2, size_t copySize2);
 
+    // Replaces the contents with size bytes, starting with up to three pieces that
+    // may point into the current contents. Returns the new data so that the caller
+    // can fill in any bytes after the pieces.
+    char*       ReplaceData(size_t size, size_t lengthIsSize,
+                            const char* pdata1, size_t copySize1,
+                            const char* pdata2 = 0, size_t copySize2 = 0,
+                            const char* pdata3 = 0, size_t copySize3 = 0);
+    // Same as ReplaceData for a string that has no contents yet.
+    char*       InitData(size_t size, size_t lengthIsSize,
+                         const char* pdata1, size_t copySize1,
+                         const char* pdata2 = 0, size_t copySize2 = 0);
+
     // Special constructor to avoid data initalization when used in derived class.
     struct NoConstructor { };
     String(const NoConstructor&) { }
@@ -168,7 +224,7 @@ public:
     // Destructor (Captain Obvious guarantees!)
     ~String()
     {
-        GetData()->Release();
+        ReleaseData();
     }
 
     // Declaration of NullString
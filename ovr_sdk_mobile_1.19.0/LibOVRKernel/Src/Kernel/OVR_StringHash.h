@@ -30,24 +30,85 @@ limitations under the License.
 #define OVR_StringHash_h
 
 #include "OVR_String.h"
-#include "OVR_Hash.h"
+#include "OVR_FlatHash.h"
 
 namespace OVR {
 
+//-----------------------------------------------------------------------------------
+// *** StringHash keys
+
+// Case-insensitive key for looking up a StringHash with characters that are not
+// stored in a String.
+struct NoCaseStringKey
+{
+    StringDataPtr Str;
+
+    explicit NoCaseStringKey(const StringDataPtr& str) : Str(str) { }
+};
+
+inline bool operator == (const String& a, const StringDataPtr& b)
+{
+    return a.GetSize() == b.GetSize() && memcmp(a.ToCStr(), b.ToCStr(), b.GetSize()) == 0;
+}
+
+inline bool operator == (const String& a, const NoCaseStringKey& b)
+{
+    const size_t size = b.Str.GetSize();
+    if (a.GetSize() != size)
+        return false;
+    const char* pa = a.ToCStr();
+    const char* pb = b.Str.ToCStr();
+    for (size_t i = 0; i < size; i++)
+    {
+        if (OVR_tolower((UByte)pa[i]) != OVR_tolower((UByte)pb[i]))
+            return false;
+    }
+    return true;
+}
+
+// Case-insensitive hash for every key type StringHash can be searched with, so that
+// case-sensitive and case-insensitive lookups probe the same slots.
+struct StringHashFunctor
+{
+    size_t operator()(const String& data) const
+    {
+        return String::BernsteinHashFunctionCIS(data.ToCStr(), data.GetSize());
+    }
+    size_t operator()(const String::NoCaseKey& data) const
+    {
+        return String::BernsteinHashFunctionCIS(data.pStr->ToCStr(), data.pStr->GetSize());
+    }
+    size_t operator()(const char* data) const
+    {
+        return String::BernsteinHashFunctionCIS(data, OVR_strlen(data));
+    }
+    size_t operator()(const StringDataPtr& data) const
+    {
+        return String::BernsteinHashFunctionCIS(data.ToCStr(), data.GetSize());
+    }
+    size_t operator()(const NoCaseStringKey& data) const
+    {
+        return String::BernsteinHashFunctionCIS(data.Str.ToCStr(), data.Str.GetSize());
+    }
+};
+
 //-----------------------------------------------------------------------------------
 // *** StringHash
 
 // This is a custom string hash table that supports case-insensitive
 // searches through special functions such as GetCaseInsensitive, etc.
 // This class is used for Flash labels, exports and other case-insensitive tables.
+//
+// Get, Find and Remove also accept a const char* or StringDataPtr, which is
+// compared case-sensitively without building a temporary String.
 
 template<class U, class Allocator = ContainerAllocator<U> >
-class StringHash : public Hash<String, U, String::NoCaseHashFunctor, Allocator>
+class StringHash : public FlatHash<String, U, StringHashFunctor, Allocator>
 {
 public:
-    typedef U                                                        ValueType;
-    typedef StringHash<U, Allocator>                                 SelfType;
-    typedef Hash<String, U, String::NoCaseHashFunctor, Allocator>    BaseType;
+    typedef U                                                   ValueType;
+    typedef StringHash<U, Allocator>                            SelfType;
+    typedef FlatHash<String, U, StringHashFunctor, Allocator>   BaseType;
 
 public:    
 
@@ -56,18 +117,30 @@ public:
     bool    GetCaseInsensitive(const String& key, U* pvalue) const
     {
         String::NoCaseKey ikey(key);
-        return BaseType::GetAlt(ikey, pvalue);
+        return BaseType::Get(ikey, pvalue);
+    }
+    bool    GetCaseInsensitive(const char* key, U* pvalue) const
+    {
+        return BaseType::Get(NoCaseStringKey(key), pvalue);
     }
     // Pointer-returning get variety.
     const U* GetCaseInsensitive(const String& key) const   
     {
         String::NoCaseKey ikey(key);
-        return BaseType::GetAlt(ikey);
+        return BaseType::Get(ikey);
+    }
+    const U* GetCaseInsensitive(const char* key) const
+    {
+        return BaseType::Get(NoCaseStringKey(key));
     }
     U*  GetCaseInsensitive(const String& key)
     {
         String::NoCaseKey ikey(key);
-        return BaseType::GetAlt(ikey);
+        return BaseType::Get(ikey);
+    }
+    U*  GetCaseInsensitive(const char* key)
+    {
+        return BaseType::Get(NoCaseStringKey(key));
     }
 
     
@@ -79,14 +152,22 @@ public:
     base_iterator    FindCaseInsensitive(const String& key)
     {
         String::NoCaseKey ikey(key);
-        return BaseType::FindAlt(ikey);
+        return BaseType::Find(ikey);
+    }
+    base_iterator    FindCaseInsensitive(const char* key)
+    {
+        return BaseType::Find(NoCaseStringKey(key));
     }
 
     // MERGE_MOBILE_SDK
     const_base_iterator    FindCaseInsensitive(const String& key) const
     {
         String::NoCaseKey ikey(key);
-        return BaseType::FindAlt(ikey);
+        return BaseType::Find(ikey);
+    }
+    const_base_iterator    FindCaseInsensitive(const char* key) const
+    {
+        return BaseType::Find(NoCaseStringKey(key));
     }
     // MERGE_MOBILE_SDK
 
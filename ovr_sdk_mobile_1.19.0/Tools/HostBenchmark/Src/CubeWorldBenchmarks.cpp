@@ -0,0 +1,168 @@
+/************************************************************************************
+
+Filename    :   CubeWorldBenchmarks.cpp
+Content     :   Benchmarks of the instance transforms of the cube world samples.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <string.h>
+#include <math.h>
+
+#include "Kernel/OVR_Array.h"
+#include "SystemClock.h"
+#include "VrApi_Helpers.h"
+#include "VrCubeWorld_Instances.h"
+
+using namespace OVR;
+
+//==============================================================
+// CubeWorld
+// The instance transforms of a cube world with 100k cubes, each with its own rotation
+// rates like the 16 shared ones of VrCubeWorld_SurfaceView.
+//==============================================================
+
+static const int NUM_CUBES = 100000;
+
+static void MakeCubes( ovrCubeInstances & instances, const int numCubes )
+{
+	ovrBenchmarkRandom random( 5 );
+	const float extent = 50.0f + sqrtf( (float)numCubes );
+	ovrCubeInstances_Create( &instances, numCubes );
+	for ( int i = 0; i < numCubes; i++ )
+	{
+		const ovrVector3f position = { random.NextFloat( -extent, extent ), random.NextFloat( -extent, extent ), random.NextFloat( -extent, extent ) };
+		const ovrVector3f rotation = { random.NextFloat( 0.0f, 1.0f ), random.NextFloat( 0.0f, 1.0f ), random.NextFloat( 0.0f, 1.0f ) };
+		ovrCubeInstances_Set( &instances, i, &position, &rotation );
+	}
+}
+
+static ovrMatrix4f ReferenceTransform( const ovrCubeInstances & instances, const int index, const ovrVector3f & currentRotation )
+{
+	ovrMatrix4f transform = ovrMatrix4f_CreateRotation(
+								instances.RotationX[index] * currentRotation.x,
+								instances.RotationY[index] * currentRotation.y,
+								instances.RotationZ[index] * currentRotation.z );
+	transform.M[3][0] = instances.PositionX[index];
+	transform.M[3][1] = instances.PositionY[index];
+	transform.M[3][2] = instances.PositionZ[index];
+	return transform;
+}
+
+// One ovrMatrix4f_CreateRotation() per cube on one thread.
+OVR_BENCHMARK( CubeWorld, InstanceTransformsScalar, BENCHMARK_MACRO )
+{
+	ovrCubeInstances instances;
+	MakeCubes( instances, NUM_CUBES );
+	Array< ovrMatrix4f > transforms;
+	transforms.Resize( NUM_CUBES );
+
+	float time = 0.0f;
+	int iterations = 0;
+	const double startTime = SystemClock::GetTimeInSeconds();
+	while ( state.KeepRunning() )
+	{
+		iterations++;
+		time += 1.0f / 72.0f;
+		const ovrVector3f currentRotation = { time, time, time };
+		for ( int i = 0; i < NUM_CUBES; i++ )
+		{
+			transforms[i] = ReferenceTransform( instances, i, currentRotation );
+		}
+		DoNotOptimize( transforms[NUM_CUBES - 1] );
+	}
+	ovrCubeInstances_Destroy( &instances );
+	state.SetItemsPerIteration( NUM_CUBES );
+	state.SetCounter( "matricesPerMs", (double)iterations * NUM_CUBES / ( ( SystemClock::GetTimeInSeconds() - startTime ) * 1000.0 ) );
+}
+
+// Batches of four cubes with SSE2 or NEON, on the calling thread and the given number of
+// workers. The matrices per millisecond count all threads.
+OVR_BENCHMARK_ARGS( CubeWorld, InstanceTransforms, BENCHMARK_MACRO, 0, 1, 2, 3, 7 )
+{
+	ovrCubeInstances instances;
+	MakeCubes( instances, NUM_CUBES );
+	Array< ovrMatrix4f > transforms;
+	transforms.Resize( NUM_CUBES );
+	ovrInstanceJobs jobs;
+	ovrInstanceJobs_Create( &jobs, state.GetArg() );
+
+	float time = 0.0f;
+	int iterations = 0;
+	const double startTime = SystemClock::GetTimeInSeconds();
+	while ( state.KeepRunning() )
+	{
+		iterations++;
+		time += 1.0f / 72.0f;
+		const ovrVector3f currentRotation = { time, time, time };
+		ovrInstanceJobs_WriteTransforms( &jobs, &instances, &currentRotation, transforms.GetDataPtr() );
+		DoNotOptimize( transforms[NUM_CUBES - 1] );
+	}
+	ovrInstanceJobs_Destroy( &jobs );
+	ovrCubeInstances_Destroy( &instances );
+	state.SetItemsPerIteration( NUM_CUBES );
+	state.SetCounter( "matricesPerMs", (double)iterations * NUM_CUBES / ( ( SystemClock::GetTimeInSeconds() - startTime ) * 1000.0 ) );
+}
+
+// Compares the batched transforms with ovrMatrix4f_CreateRotation(), over a few minutes of
+// simulation, and checks that partial batches write nothing past their end.
+OVR_BENCHMARK( CubeWorld, InstanceTransformsMatch, BENCHMARK_MICRO )
+{
+	static const int NUM_MATCH_CUBES = 10003;
+	ovrCubeInstances instances;
+	MakeCubes( instances, NUM_MATCH_CUBES );
+	Array< ovrMatrix4f > transforms;
+	transforms.Resize( NUM_MATCH_CUBES + 1 );
+	ovrInstanceJobs jobs;
+	ovrInstanceJobs_Create( &jobs, 2 );
+
+	const char * error = NULL;
+	double maxError = 0.0;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		for ( int step = 0; step < 8 && error == NULL; step++ )
+		{
+			const float time = step * 37.3f;
+			const ovrVector3f currentRotation = { time, -0.5f * time, 2.0f * time };
+			memset( transforms.GetDataPtr(), 0xFF, transforms.GetSizeI() * sizeof( ovrMatrix4f ) );
+			ovrInstanceJobs_WriteTransforms( &jobs, &instances, &currentRotation, transforms.GetDataPtr() );
+			// A partial batch that does not start on a batch.
+			ovrCubeInstances_WriteTransforms( &instances, &currentRotation, 5, 2, transforms.GetDataPtr() );
+			for ( int i = 0; i < NUM_MATCH_CUBES; i++ )
+			{
+				const ovrMatrix4f reference = ReferenceTransform( instances, i, currentRotation );
+				for ( int j = 0; j < 16; j++ )
+				{
+					const double difference = fabs( (double)transforms[i].M[j / 4][j % 4] - reference.M[j / 4][j % 4] );
+					maxError = ( difference > maxError ) ? difference : maxError;
+				}
+			}
+			const uint8_t * sentinel = (const uint8_t *)&transforms[NUM_MATCH_CUBES];
+			for ( size_t i = 0; i < sizeof( ovrMatrix4f ); i++ )
+			{
+				if ( sentinel[i] != 0xFF )
+				{
+					error = "a transform was written past the last instance";
+					break;
+				}
+			}
+		}
+		if ( !( maxError < 1e-5 ) )
+		{
+			error = "the transforms differ from ovrMatrix4f_CreateRotation()";
+		}
+	}
+	ovrInstanceJobs_Destroy( &jobs );
+	ovrCubeInstances_Destroy( &instances );
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+		return;
+	}
+	state.SetCounter( "maxError", maxError );
+}
@@ -0,0 +1,648 @@
+/************************************************************************************
+
+Filename    :   FileBenchmarks.cpp
+Content     :   Benchmarks of reading local files with and without the read service.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Std.h"
+#include "Kernel/OVR_Threads.h"
+#include "OVR_FileSys.h"
+#include "OVR_ReadService.h"
+#include "PackageFiles.h"
+#include "SystemClock.h"
+#include "zip.h"
+
+using namespace OVR;
+
+//==============================================================
+// ReadService
+// A burst of loads from a folder of local files, issued from several loader threads at
+// once: runs of small reads close together, like the entries of a pack file, that are
+// needed right away, and large reads, like textures and models, that are not. The files
+// are in the page cache after the first run, so these measure the cost and the order of
+// the reads rather than the storage.
+//==============================================================
+
+static const int NUM_READ_FILES = 4;
+static const size_t READ_FILE_SIZE = 4 * 1024 * 1024;
+static const int NUM_READS = 512;
+static const int NUM_LOADER_THREADS = 4;
+
+static uint8_t ReadFileByte( const int file, const size_t offset )
+{
+	const uint32_t x = (uint32_t)( offset >> 2 ) * 2654435761u + (uint32_t)file * 40503u;
+	return (uint8_t)( ( x >> 24 ) ^ offset );
+}
+
+static bool ReadDataMatches( const int file, const size_t offset, const uint8_t * data, const size_t length )
+{
+	for ( size_t i = 0; i < length; i++ )
+	{
+		if ( data[i] != ReadFileByte( file, offset + i ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// A temporary folder with NUM_READ_FILES files, written once.
+class ovrBenchmarkReadFolder
+{
+public:
+	ovrBenchmarkReadFolder()
+		: NumFiles( 0 )
+	{
+		OVR_strcpy( Path, sizeof( Path ), "/tmp/ovr_benchmark_XXXXXX" );
+		if ( mkdtemp( Path ) == NULL )
+		{
+			Path[0] = '\0';
+			return;
+		}
+		uint8_t * buffer = (uint8_t *)malloc( READ_FILE_SIZE );
+		for ( ; NumFiles < NUM_READ_FILES; NumFiles++ )
+		{
+			for ( size_t i = 0; i < READ_FILE_SIZE; i++ )
+			{
+				buffer[i] = ReadFileByte( NumFiles, i );
+			}
+			char fileName[128];
+			FILE * f = fopen( GetFileName( NumFiles, fileName ), "wb" );
+			if ( f == NULL )
+			{
+				break;
+			}
+			const size_t written = fwrite( buffer, 1, READ_FILE_SIZE, f );
+			fclose( f );
+			if ( written != READ_FILE_SIZE )
+			{
+				break;
+			}
+		}
+		free( buffer );
+	}
+
+	// Runs after OVR::System::Destroy(), so this does not allocate.
+	~ovrBenchmarkReadFolder()
+	{
+		if ( Path[0] == '\0' )
+		{
+			return;
+		}
+		char fileName[128];
+		for ( int i = 0; i < NUM_READ_FILES; i++ )
+		{
+			unlink( GetFileName( i, fileName ) );
+		}
+		rmdir( Path );
+	}
+
+	bool			IsValid() const { return NumFiles == NUM_READ_FILES; }
+	const char *	GetFileName( const int index, char ( &fileName )[128] ) const
+	{
+		OVR_sprintf( fileName, sizeof( fileName ), "%s/pack_%d.bin", Path, index );
+		return fileName;
+	}
+
+private:
+	char			Path[64];
+	int				NumFiles;
+};
+
+static const ovrBenchmarkReadFolder & GetReadFolder()
+{
+	static ovrBenchmarkReadFolder folder;
+	return folder;
+}
+
+struct ovrBenchmarkRead
+{
+	int					File;
+	size_t				Offset;
+	size_t				Length;
+	ovrReadPriority		Priority;
+	double				DoneTime;
+	int					DoneOrder;
+};
+
+static void MakeReads( Array< ovrBenchmarkRead > & reads )
+{
+	ovrBenchmarkRandom random( 7 );
+	reads.Clear();
+	while ( reads.GetSizeI() < NUM_READS )
+	{
+		ovrBenchmarkRead read = {};
+		read.File = random.NextUInt() % NUM_READ_FILES;
+		if ( random.NextUInt() % 8 == 0 )
+		{
+			read.Length = ( 256 + random.NextUInt() % 768 ) * 1024;
+			read.Offset = ( random.NextUInt() % ( ( READ_FILE_SIZE - read.Length ) / 4096 ) ) * 4096;
+			read.Priority = ( random.NextUInt() % 2 == 0 ) ? OVR_READ_PRIORITY_NORMAL : OVR_READ_PRIORITY_LOW;
+			reads.PushBack( read );
+			continue;
+		}
+		const int count = 1 + random.NextUInt() % 8;
+		size_t offset = ( random.NextUInt() % ( READ_FILE_SIZE / 4096 - 64 ) ) * 4096;
+		read.Priority = ( random.NextUInt() % 2 == 0 ) ? OVR_READ_PRIORITY_URGENT : OVR_READ_PRIORITY_HIGH;
+		for ( int i = 0; i < count && reads.GetSizeI() < NUM_READS; i++ )
+		{
+			read.Offset = offset;
+			read.Length = 4096 + random.NextUInt() % 12288;
+			offset += read.Length + random.NextUInt() % 2048;
+			reads.PushBack( read );
+		}
+	}
+}
+
+static size_t CountReadBytes( const Array< ovrBenchmarkRead > & reads )
+{
+	size_t bytes = 0;
+	for ( int i = 0; i < reads.GetSizeI(); i++ )
+	{
+		bytes += reads[i].Length;
+	}
+	return bytes;
+}
+
+static bool DoubleLess( const double & a, const double & b )
+{
+	return a < b;
+}
+
+// Reports the time from the start of the burst until each read finished.
+static void SetLatencyCounters( ovrBenchmarkState & state, const Array< ovrBenchmarkRead > & reads, const double startTime )
+{
+	Array< double > all;
+	Array< double > urgent;
+	for ( int i = 0; i < reads.GetSizeI(); i++ )
+	{
+		const double milliseconds = ( reads[i].DoneTime - startTime ) * 1000.0;
+		all.PushBack( milliseconds );
+		if ( reads[i].Priority == OVR_READ_PRIORITY_URGENT )
+		{
+			urgent.PushBack( milliseconds );
+		}
+	}
+	Alg::QuickSort( all, DoubleLess );
+	Alg::QuickSort( urgent, DoubleLess );
+	state.SetCounter( "p50ms", all[all.GetSizeI() / 2] );
+	state.SetCounter( "p99ms", all[all.GetSizeI() * 99 / 100] );
+	if ( urgent.GetSizeI() > 0 )
+	{
+		state.SetCounter( "urgentP99ms", urgent[urgent.GetSizeI() * 99 / 100] );
+	}
+}
+
+// Each loader reads its share of the burst in order, opening a file for each read, the
+// way loaders use ovrStream_File.
+OVR_BENCHMARK( ReadService, BlockingLoaders, BENCHMARK_MACRO )
+{
+	const ovrBenchmarkReadFolder & folder = GetReadFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the files" );
+		return;
+	}
+	Array< ovrBenchmarkRead > reads;
+	MakeReads( reads );
+
+	struct ovrLoaderThread
+	{
+		const ovrBenchmarkReadFolder *	Folder;
+		ovrBenchmarkRead *				Reads;
+		int								First;
+		bool							Failed;
+
+		static threadReturn_t ThreadFunction( Thread *, void * data )
+		{
+			ovrLoaderThread & parms = *static_cast< ovrLoaderThread * >( data );
+			for ( int i = parms.First; i < NUM_READS; i += NUM_LOADER_THREADS )
+			{
+				ovrBenchmarkRead & read = parms.Reads[i];
+				char fileName[128];
+				FILE * f = fopen( parms.Folder->GetFileName( read.File, fileName ), "rb" );
+				if ( f == NULL )
+				{
+					parms.Failed = true;
+					continue;
+				}
+				MemBufferT< uint8_t > buffer( read.Length );
+				fseek( f, (long)read.Offset, SEEK_SET );
+				parms.Failed |= ( fread( buffer, read.Length, 1, f ) != 1 );
+				fclose( f );
+				DoNotOptimize( buffer[read.Length - 1] );
+				read.DoneTime = SystemClock::GetTimeInSeconds();
+			}
+			return NULL;
+		}
+	};
+
+	double startTime = 0.0;
+	bool failed = false;
+	while ( state.KeepRunning() )
+	{
+		startTime = SystemClock::GetTimeInSeconds();
+		ovrLoaderThread parms[NUM_LOADER_THREADS];
+		Thread * threads[NUM_LOADER_THREADS];
+		for ( int i = 0; i < NUM_LOADER_THREADS; i++ )
+		{
+			parms[i].Folder = &folder;
+			parms[i].Reads = reads.GetDataPtr();
+			parms[i].First = i;
+			parms[i].Failed = false;
+			threads[i] = new Thread( ovrLoaderThread::ThreadFunction, &parms[i] );
+			threads[i]->Start();
+		}
+		for ( int i = 0; i < NUM_LOADER_THREADS; i++ )
+		{
+			threads[i]->Join();
+			delete threads[i];
+			failed |= parms[i].Failed;
+		}
+	}
+	if ( failed )
+	{
+		state.SkipWithError( "a read failed" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_READS );
+	state.SetBytesPerIteration( (double)CountReadBytes( reads ) );
+	SetLatencyCounters( state, reads, startTime );
+}
+
+// Counts the finished reads of a burst.
+struct ovrReadBurst
+{
+	Mutex				DoneMutex;
+	WaitCondition		DoneWake;
+	int					NumDone;
+	int					NumFailed;
+
+	static void OnReadDone( ovrReadRequest & request, void * userData );
+};
+
+struct ovrReadBurstRead
+{
+	ovrReadBurst *		Burst;
+	ovrBenchmarkRead *	Read;
+};
+
+void ovrReadBurst::OnReadDone( ovrReadRequest & request, void * userData )
+{
+	ovrReadBurstRead & burstRead = *static_cast< ovrReadBurstRead * >( userData );
+	burstRead.Read->DoneTime = SystemClock::GetTimeInSeconds();
+	DoNotOptimize( request.GetData() );
+
+	ovrReadBurst & burst = *burstRead.Burst;
+	Mutex::Locker locker( &burst.DoneMutex );
+	burst.NumFailed += ( request.GetStatus() != OVR_READ_COMPLETE );
+	if ( ++burst.NumDone == NUM_READS )
+	{
+		burst.DoneWake.NotifyAll();
+	}
+}
+
+// The loaders queue their share of the burst on the read service, with priorities, and
+// the benchmark waits until all of them are done. The argument is the number of workers.
+OVR_BENCHMARK_ARGS( ReadService, AsyncLoaders, BENCHMARK_MACRO, 1, 2, 4 )
+{
+	const ovrBenchmarkReadFolder & folder = GetReadFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the files" );
+		return;
+	}
+	Array< ovrBenchmarkRead > reads;
+	MakeReads( reads );
+
+	ovrReadService service;
+	service.Init( NULL, state.GetArg() );
+
+	ovrReadBurst burst;
+	Array< ovrReadBurstRead > burstReads;
+	burstReads.Resize( NUM_READS );
+	for ( int i = 0; i < NUM_READS; i++ )
+	{
+		burstReads[i].Burst = &burst;
+		burstReads[i].Read = &reads[i];
+	}
+
+	struct ovrLoaderThread
+	{
+		const ovrBenchmarkReadFolder *	Folder;
+		ovrReadService *				Service;
+		ovrReadBurstRead *				BurstReads;
+		int								First;
+
+		static threadReturn_t ThreadFunction( Thread *, void * data )
+		{
+			ovrLoaderThread & parms = *static_cast< ovrLoaderThread * >( data );
+			for ( int i = parms.First; i < NUM_READS; i += NUM_LOADER_THREADS )
+			{
+				const ovrBenchmarkRead & read = *parms.BurstReads[i].Read;
+				char fileName[128];
+				ovrReadRequest * request = parms.Service->Read( parms.Folder->GetFileName( read.File, fileName ),
+						read.Offset, read.Length, read.Priority, ovrReadBurst::OnReadDone, &parms.BurstReads[i] );
+				request->Release();
+			}
+			return NULL;
+		}
+	};
+
+	double startTime = 0.0;
+	int numFileReads = 0;
+	while ( state.KeepRunning() )
+	{
+		burst.NumDone = 0;
+		burst.NumFailed = 0;
+		const int firstFileReads = service.GetNumFileReads();
+		startTime = SystemClock::GetTimeInSeconds();
+		ovrLoaderThread parms[NUM_LOADER_THREADS];
+		Thread * threads[NUM_LOADER_THREADS];
+		for ( int i = 0; i < NUM_LOADER_THREADS; i++ )
+		{
+			parms[i].Folder = &folder;
+			parms[i].Service = &service;
+			parms[i].BurstReads = burstReads.GetDataPtr();
+			parms[i].First = i;
+			threads[i] = new Thread( ovrLoaderThread::ThreadFunction, &parms[i] );
+			threads[i]->Start();
+		}
+		for ( int i = 0; i < NUM_LOADER_THREADS; i++ )
+		{
+			threads[i]->Join();
+			delete threads[i];
+		}
+		{
+			Mutex::Locker locker( &burst.DoneMutex );
+			while ( burst.NumDone < NUM_READS )
+			{
+				burst.DoneWake.Wait( &burst.DoneMutex );
+			}
+		}
+		numFileReads = service.GetNumFileReads() - firstFileReads;
+		if ( burst.NumFailed > 0 )
+		{
+			break;
+		}
+	}
+	service.Shutdown();
+
+	if ( burst.NumFailed > 0 )
+	{
+		state.SkipWithError( "a read failed" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_READS );
+	state.SetBytesPerIteration( (double)CountReadBytes( reads ) );
+	state.SetCounter( "fileReads", numFileReads );
+	SetLatencyCounters( state, reads, startTime );
+}
+
+//==============================================================
+// A package with a file stored as is and a deflated one, served through the read service
+// like apk: uris.
+
+static const size_t PACKED_FILE_SIZE = 300 * 1024;
+
+static bool WriteReadPackage( char ( &path )[64] )
+{
+	OVR_strcpy( path, sizeof( path ), "/tmp/ovr_benchmark_XXXXXX.zip" );
+	const int fd = mkstemps( path, 4 );
+	if ( fd < 0 )
+	{
+		return false;
+	}
+	close( fd );
+
+	zipFile zip = zipOpen( path, APPEND_STATUS_CREATE );
+	if ( zip == NULL )
+	{
+		unlink( path );
+		return false;
+	}
+	Array< uint8_t > data;
+	data.Resize( PACKED_FILE_SIZE );
+	for ( int i = 0; i < data.GetSizeI(); i++ )
+	{
+		data[i] = ReadFileByte( 0, i );
+	}
+	const zip_fileinfo info = {};
+	// the entries before the stored one move its data away from the start of the file
+	zipOpenNewFileInZip( zip, "assets/deflated.bin", &info, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_DEFAULT_COMPRESSION );
+	zipWriteInFileInZip( zip, data.GetDataPtr(), data.GetSizeI() );
+	zipCloseFileInZip( zip );
+	zipOpenNewFileInZip( zip, "assets/stored.bin", &info, NULL, 0, NULL, 0, NULL, 0, 0 );
+	zipWriteInFileInZip( zip, data.GetDataPtr(), data.GetSizeI() );
+	zipCloseFileInZip( zip );
+	zipClose( zip, NULL );
+	return true;
+}
+
+//==============================================================
+// ovrBenchmarkPackageFileSys
+// Serves "apk:///name" from one package, the way ovrFileSysLocal serves apk: uris.
+class ovrBenchmarkPackageFileSys : public ovrFileSys
+{
+public:
+	explicit ovrBenchmarkPackageFileSys( const char * path )
+		: Path( path )
+		, Zip( ovr_OpenOtherApplicationPackage( path ) )
+	{
+	}
+
+	virtual ~ovrBenchmarkPackageFileSys()
+	{
+		ovr_CloseOtherApplicationPackage( Zip );
+	}
+
+	virtual ovrStream *		OpenStream( char const * uri, ovrStreamMode const mode ) { return NULL; }
+	virtual void			CloseStream( ovrStream * & stream ) {}
+	virtual bool			ReadFile( char const * uri, MemBufferT< uint8_t > & outBuffer )
+	{
+		return ovr_ReadFileFromOtherApplicationPackage( Zip, NameInZip( uri ), outBuffer );
+	}
+	virtual bool			FileExists( char const * uri ) { return ovr_OtherPackageFileExists( Zip, NameInZip( uri ) ); }
+	virtual bool			GetLocalPathForURI( char const * uri, String & outputPath ) { return false; }
+	virtual bool			GetLocalRangeForURI( char const * uri, String & outPath, size_t & outOffset, size_t & outLength, bool & outMap )
+	{
+		if ( !ovr_GetStoredFileRangeInPackage( Zip, NameInZip( uri ), outOffset, outLength ) )
+		{
+			return false;
+		}
+		outPath = Path;
+		outMap = true;
+		return true;
+	}
+
+private:
+	const char *			Path;
+	void *					Zip;
+
+	static const char *		NameInZip( char const * uri ) { return uri + strlen( "apk:///" ); }
+};
+
+static void RecordDoneOrder( ovrReadRequest & request, void * userData )
+{
+	static std::atomic< int > nextOrder( 0 );
+	static_cast< ovrBenchmarkRead * >( userData )->DoneOrder = nextOrder.fetch_add( 1, std::memory_order_relaxed );
+}
+
+// Checks the data of reads that are coalesced, that canceled reads don't finish, that reads
+// are served in priority order, and that a file stored as is in a package is mapped while
+// a deflated one is still read.
+OVR_BENCHMARK( ReadService, Matches, BENCHMARK_MICRO )
+{
+	const ovrBenchmarkReadFolder & folder = GetReadFolder();
+	char packagePath[64];
+	if ( !folder.IsValid() || !WriteReadPackage( packagePath ) )
+	{
+		state.SkipWithError( "could not write the files" );
+		return;
+	}
+	Array< ovrBenchmarkRead > reads;
+	MakeReads( reads );
+
+	// Reads far enough apart that they can't be coalesced, in random priorities.
+	Array< ovrBenchmarkRead > ordered;
+	ovrBenchmarkRandom random( 3 );
+	for ( int i = 0; i < 64; i++ )
+	{
+		ovrBenchmarkRead read = {};
+		read.File = i % NUM_READ_FILES;
+		read.Offset = i * ( ovrReadService::MAX_COALESCE_GAP + 8192 );
+		read.Length = 4096;
+		read.Priority = (ovrReadPriority)( random.NextUInt() % OVR_READ_PRIORITY_MAX );
+		ordered.PushBack( read );
+	}
+
+	const char * error = NULL;
+	int numFileReads = 0;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		char fileName[128];
+
+		// Everything is queued before the workers start.
+		ovrReadService service;
+		service.Init( NULL, 0 );
+		Array< ovrReadRequest * > requests;
+		for ( int i = 0; i < reads.GetSizeI(); i++ )
+		{
+			requests.PushBack( service.Read( folder.GetFileName( reads[i].File, fileName ), reads[i].Offset, reads[i].Length, reads[i].Priority ) );
+		}
+		for ( int i = 0; i < requests.GetSizeI(); i += 16 )
+		{
+			if ( !service.Cancel( requests[i] ) )
+			{
+				error = "a queued read could not be canceled";
+			}
+		}
+		service.Init( NULL, 2 );
+		int numRead = 0;
+		for ( int i = 0; i < requests.GetSizeI(); i++ )
+		{
+			const ovrReadStatus status = requests[i]->Wait();
+			if ( i % 16 == 0 )
+			{
+				if ( status != OVR_READ_CANCELED )
+				{
+					error = "a canceled read finished";
+				}
+			}
+			else if ( status != OVR_READ_COMPLETE || requests[i]->GetLength() != reads[i].Length ||
+					!ReadDataMatches( reads[i].File, reads[i].Offset, requests[i]->GetData(), reads[i].Length ) )
+			{
+				error = "the data of a read differs from the file";
+			}
+			else
+			{
+				numRead++;
+			}
+			requests[i]->Release();
+		}
+		numFileReads = service.GetNumFileReads();
+		if ( error == NULL && numFileReads >= numRead )
+		{
+			error = "no reads were coalesced";
+		}
+		service.Shutdown();
+
+		// One worker serves these in priority order, and in order within a priority.
+		service.Init( NULL, 0 );
+		requests.Clear();
+		for ( int i = 0; i < ordered.GetSizeI(); i++ )
+		{
+			requests.PushBack( service.Read( folder.GetFileName( ordered[i].File, fileName ), ordered[i].Offset, ordered[i].Length,
+					ordered[i].Priority, RecordDoneOrder, &ordered[i] ) );
+		}
+		service.Init( NULL, 1 );
+		// Waiting boosts a queued read, so wait in the expected order.
+		for ( int priority = 0; priority < OVR_READ_PRIORITY_MAX; priority++ )
+		{
+			for ( int i = 0; i < requests.GetSizeI(); i++ )
+			{
+				if ( ordered[i].Priority == priority )
+				{
+					requests[i]->Wait();
+				}
+			}
+		}
+		for ( int i = 0; i < ordered.GetSizeI() && error == NULL; i++ )
+		{
+			for ( int j = 0; j < ordered.GetSizeI(); j++ )
+			{
+				const bool before = ordered[j].Priority < ordered[i].Priority || ( ordered[j].Priority == ordered[i].Priority && j < i );
+				if ( before && ordered[j].DoneOrder > ordered[i].DoneOrder )
+				{
+					error = "reads were not served in priority order";
+					break;
+				}
+			}
+		}
+		for ( int i = 0; i < requests.GetSizeI(); i++ )
+		{
+			requests[i]->Release();
+		}
+		service.Shutdown();
+
+		// Package files, by uri.
+		ovrBenchmarkPackageFileSys fileSys( packagePath );
+		service.Init( &fileSys, 2 );
+		ovrReadRequest * stored = service.ReadUri( "apk:///assets/stored.bin", OVR_READ_PRIORITY_HIGH );
+		ovrReadRequest * deflated = service.ReadUri( "apk:///assets/deflated.bin", OVR_READ_PRIORITY_HIGH );
+		if ( stored->Wait() != OVR_READ_COMPLETE || !stored->IsMapped() || stored->GetLength() != PACKED_FILE_SIZE ||
+				!ReadDataMatches( 0, 0, stored->GetData(), PACKED_FILE_SIZE ) )
+		{
+			error = "the stored package file was not mapped";
+		}
+		if ( deflated->Wait() != OVR_READ_COMPLETE || deflated->IsMapped() || deflated->GetLength() != PACKED_FILE_SIZE ||
+				!ReadDataMatches( 0, 0, deflated->GetData(), PACKED_FILE_SIZE ) )
+		{
+			error = "the deflated package file was not read";
+		}
+		stored->Release();
+		deflated->Release();
+		service.Shutdown();
+	}
+	unlink( packagePath );
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+		return;
+	}
+	state.SetCounter( "fileReads", numFileReads );
+}
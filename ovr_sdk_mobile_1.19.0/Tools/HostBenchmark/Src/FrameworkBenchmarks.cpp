@@ -0,0 +1,521 @@
+/************************************************************************************
+
+Filename    :   FrameworkBenchmarks.cpp
+Content     :   Benchmarks of the VrAppFramework debug drawing, program cache and profiler.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+#include "HostShims.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Math.h"
+#include "Kernel/OVR_Threads.h"
+#include "DebugLines.h"
+#include "GlProgram.h"
+#include "OVR_PerfTimer.h"
+#include "OVR_Profiler.h"
+#include "SurfaceRender.h"
+
+using namespace OVR;
+
+static const int NUM_DEBUG_LINES = 100000;
+
+static void MakeLines( Array< Vector3f > & points, const int numLines )
+{
+	ovrBenchmarkRandom random;
+	points.Resize( numLines * 2 );
+	for ( int i = 0; i < points.GetSizeI(); i++ )
+	{
+		points[i] = Vector3f( random.NextFloat( -10.0f, 10.0f ), random.NextFloat( -10.0f, 10.0f ), random.NextFloat( -10.0f, 10.0f ) );
+	}
+}
+
+// Runs frames of the debug lines with numAdded lines added per frame, each living for
+// lifetime( line ) frames, and reports the surfaces and GL calls per frame.
+template< typename _lifetime_ >
+static void RunDebugLineFrames( ovrBenchmarkState & state, const int numAdded, const int numPrefilled, _lifetime_ lifetime )
+{
+	Array< Vector3f > points;
+	MakeLines( points, Alg::Max( numAdded, numPrefilled ) );
+	const Vector4f color( 1.0f, 0.5f, 0.25f, 1.0f );
+
+	OvrDebugLines * debugLines = OvrDebugLines::Create();
+	debugLines->Init();
+
+	long long frame = 1;
+	debugLines->BeginFrame( frame );
+	for ( int i = 0; i < numPrefilled; i++ )
+	{
+		debugLines->AddLine( points[i * 2 + 0], points[i * 2 + 1], color, color, 1LL << 40, ( i & 1 ) != 0 );
+	}
+
+	Array< ovrDrawSurface > surfaceList;
+	const long long glCallsBefore = ovrHostShims::GetNumGlCalls();
+	long long iterations = 0;
+	while ( state.KeepRunning() )
+	{
+		frame++;
+		debugLines->BeginFrame( frame );
+		for ( int i = 0; i < numAdded; i++ )
+		{
+			debugLines->AddLine( points[i * 2 + 0], points[i * 2 + 1], color, color, frame + lifetime( i ), ( i & 1 ) != 0 );
+		}
+		surfaceList.Resize( 0 );
+		debugLines->AppendSurfaceList( surfaceList );
+		DoNotOptimize( surfaceList.GetDataPtr() );
+		iterations++;
+	}
+	if ( iterations > 0 )
+	{
+		state.SetCounter( "glCalls", (double)( ovrHostShims::GetNumGlCalls() - glCallsBefore ) / iterations );
+		state.SetCounter( "surfaces", surfaceList.GetSizeI() );
+	}
+	state.SetItemsPerIteration( Alg::Max( numAdded, numPrefilled ) );
+
+	debugLines->Shutdown();
+	OvrDebugLines::Free( debugLines );
+}
+
+struct ovrOneFrame
+{
+	int operator()( const int ) const { return 1; }
+};
+
+struct ovrMixedLifetime
+{
+	int operator()( const int i ) const { return 1 + ( ( i * 7919 ) % 60 ); }
+};
+
+// 100k lines added and drawn for one frame.
+OVR_BENCHMARK( DebugLines, Transient, BENCHMARK_MICRO )
+{
+	RunDebugLineFrames( state, NUM_DEBUG_LINES, 0, ovrOneFrame() );
+}
+
+// 100k lines added once and drawn every frame.
+OVR_BENCHMARK( DebugLines, Persistent, BENCHMARK_MICRO )
+{
+	RunDebugLineFrames( state, 0, NUM_DEBUG_LINES, ovrOneFrame() );
+}
+
+// 100k lines live at any time, with lifetimes of 1 to 60 frames.
+OVR_BENCHMARK( DebugLines, MixedLifetimes, BENCHMARK_MICRO )
+{
+	RunDebugLineFrames( state, NUM_DEBUG_LINES / 30, 0, ovrMixedLifetime() );
+}
+
+// 100k points, bounds and axes added and drawn for one frame.
+OVR_BENCHMARK( DebugLines, TransientShapes, BENCHMARK_MICRO )
+{
+	Array< Vector3f > points;
+	MakeLines( points, NUM_DEBUG_LINES );
+	const Vector4f color( 1.0f, 0.5f, 0.25f, 1.0f );
+	const Matrix4f axes = Matrix4f::RotationY( 0.5f );
+
+	OvrDebugLines * debugLines = OvrDebugLines::Create();
+	debugLines->Init();
+
+	Array< ovrDrawSurface > surfaceList;
+	long long frame = 1;
+	while ( state.KeepRunning() )
+	{
+		frame++;
+		debugLines->BeginFrame( frame );
+		for ( int i = 0; i < NUM_DEBUG_LINES; i += 3 )
+		{
+			debugLines->AddPoint( points[i], 0.1f, color, frame + 1, true );
+			debugLines->AddAxes( points[i + 1], axes, 0.1f, color, frame + 1, false );
+			debugLines->AddBounds( Posef( Quatf(), points[i + 2] ), Bounds3f( Vector3f( -0.1f ), Vector3f( 0.1f ) ), color );
+		}
+		surfaceList.Resize( 0 );
+		debugLines->AppendSurfaceList( surfaceList );
+		DoNotOptimize( surfaceList.GetDataPtr() );
+	}
+	state.SetItemsPerIteration( NUM_DEBUG_LINES );
+
+	debugLines->Shutdown();
+	OvrDebugLines::Free( debugLines );
+}
+
+// 100k lines added for one frame from four threads.
+OVR_BENCHMARK( DebugLines, TransientThreaded, BENCHMARK_MACRO )
+{
+	static const int NUM_THREADS = 4;
+	Array< Vector3f > points;
+	MakeLines( points, NUM_DEBUG_LINES );
+	const Vector4f color( 1.0f, 0.5f, 0.25f, 1.0f );
+
+	OvrDebugLines * debugLines = OvrDebugLines::Create();
+	debugLines->Init();
+
+	struct ovrAddLinesThread
+	{
+		OvrDebugLines *		DebugLines;
+		const Vector3f *	Points;
+		Vector4f			Color;
+		long long			EndFrame;
+		int					First;
+		int					Count;
+
+		static threadReturn_t ThreadFunction( Thread *, void * data )
+		{
+			const ovrAddLinesThread & parms = *static_cast< ovrAddLinesThread * >( data );
+			for ( int i = parms.First; i < parms.First + parms.Count; i++ )
+			{
+				parms.DebugLines->AddLine( parms.Points[i * 2 + 0], parms.Points[i * 2 + 1], parms.Color, parms.Color, parms.EndFrame, true );
+			}
+			return NULL;
+		}
+	};
+
+	Array< ovrDrawSurface > surfaceList;
+	long long frame = 1;
+	while ( state.KeepRunning() )
+	{
+		frame++;
+		debugLines->BeginFrame( frame );
+		ovrAddLinesThread parms[NUM_THREADS];
+		Thread * threads[NUM_THREADS];
+		for ( int i = 0; i < NUM_THREADS; i++ )
+		{
+			parms[i].DebugLines = debugLines;
+			parms[i].Points = points.GetDataPtr();
+			parms[i].Color = color;
+			parms[i].EndFrame = frame + 1;
+			parms[i].First = i * NUM_DEBUG_LINES / NUM_THREADS;
+			parms[i].Count = NUM_DEBUG_LINES / NUM_THREADS;
+			threads[i] = new Thread( ovrAddLinesThread::ThreadFunction, &parms[i] );
+			threads[i]->Start();
+		}
+		for ( int i = 0; i < NUM_THREADS; i++ )
+		{
+			threads[i]->Join();
+			delete threads[i];
+		}
+		surfaceList.Resize( 0 );
+		debugLines->AppendSurfaceList( surfaceList );
+		DoNotOptimize( surfaceList.GetDataPtr() );
+	}
+	state.SetItemsPerIteration( NUM_DEBUG_LINES );
+
+	debugLines->Shutdown();
+	OvrDebugLines::Free( debugLines );
+}
+
+//==============================================================
+// GlProgram
+// The host GL stubs compile and link instantly, so these measure the CPU work of
+// GlProgram::Build() and report the GL calls it makes.
+//==============================================================
+
+static const char * ProgramVertexSrc =
+	"attribute highp vec4 Position;\n"
+	"attribute highp vec2 TexCoord;\n"
+	"varying highp vec2 oTexCoord;\n"
+	"void main()\n"
+	"{\n"
+	"	gl_Position = TransformVertex( Position );\n"
+	"	oTexCoord = TexCoord;\n"
+	"}\n";
+
+static const char * ProgramFragmentSrc =
+	"uniform sampler2D Texture0;\n"
+	"uniform lowp vec4 UniformColor;\n"
+	"varying highp vec2 oTexCoord;\n"
+	"void main()\n"
+	"{\n"
+	"	gl_FragColor = UniformColor * texture2D( Texture0, oTexCoord );\n"
+	"}\n";
+
+static const ovrProgramParm ProgramParms[] =
+{
+	{ "Texture0",		ovrProgramParmType::TEXTURE_SAMPLED },
+	{ "UniformColor",	ovrProgramParmType::FLOAT_VECTOR4 },
+};
+
+static GlProgram BuildTestProgram( const char * directives )
+{
+	return GlProgram::Build( directives, ProgramVertexSrc, directives, ProgramFragmentSrc,
+			ProgramParms, sizeof( ProgramParms ) / sizeof( ProgramParms[0] ) );
+}
+
+// A temporary directory for program binaries, removed with its files.
+class ovrProgramBinaryDirectory
+{
+public:
+	ovrProgramBinaryDirectory()
+	{
+		OVR_strcpy( Path, sizeof( Path ), "/tmp/ovr_benchmark_XXXXXX" );
+		if ( mkdtemp( Path ) == NULL )
+		{
+			Path[0] = '\0';
+		}
+	}
+
+	~ovrProgramBinaryDirectory()
+	{
+		if ( Path[0] != '\0' )
+		{
+			RemoveFiles();
+			rmdir( Path );
+		}
+	}
+
+	const char *	GetPath() const { return ( Path[0] != '\0' ) ? Path : NULL; }
+
+	void			RemoveFiles()
+	{
+		DIR * dir = opendir( Path );
+		if ( dir == NULL )
+		{
+			return;
+		}
+		for ( struct dirent * entry = readdir( dir ); entry != NULL; entry = readdir( dir ) )
+		{
+			if ( entry->d_name[0] != '.' )
+			{
+				char fileName[256];
+				OVR_sprintf( fileName, sizeof( fileName ), "%s/%s", Path, entry->d_name );
+				unlink( fileName );
+			}
+		}
+		closedir( dir );
+	}
+
+private:
+	char			Path[64];
+};
+
+static bool SameUniform( const ovrUniform & a, const ovrUniform & b )
+{
+	return a.Location == b.Location && a.Binding == b.Binding && a.Type == b.Type;
+}
+
+static bool SameUniforms( const GlProgram & a, const GlProgram & b )
+{
+	for ( int i = 0; i < ovrUniform::MAX_UNIFORMS; i++ )
+	{
+		if ( !SameUniform( a.Uniforms[i], b.Uniforms[i] ) )
+		{
+			return false;
+		}
+	}
+	return SameUniform( a.ViewID, b.ViewID ) && SameUniform( a.ModelMatrix, b.ModelMatrix ) &&
+			SameUniform( a.SceneMatrices, b.SceneMatrices ) && SameUniform( a.ViewMatrix, b.ViewMatrix ) &&
+			SameUniform( a.ProjectionMatrix, b.ProjectionMatrix ) &&
+			a.numTextureBindings == b.numTextureBindings && a.numUniformBufferBindings == b.numUniformBufferBindings &&
+			a.uMvp == b.uMvp && a.uColor == b.uColor && a.uTexm == b.uTexm && a.uJoints == b.uJoints &&
+			a.uJointsBinding == b.uJointsBinding;
+}
+
+// Checks when programs are compiled, shared, loaded from binaries and recompiled after
+// the driver refuses a binary.
+OVR_BENCHMARK( GlProgram, CacheMatches, BENCHMARK_MICRO )
+{
+	ovrProgramBinaryDirectory directory;
+	if ( directory.GetPath() == NULL )
+	{
+		state.SkipWithError( "could not create a directory" );
+		return;
+	}
+
+	const char * error = NULL;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		GlProgram::SetBinaryCachePath( directory.GetPath() );
+		const ovrProgramCacheStats before = GlProgram::GetCacheStats();
+		ovrProgramCacheStats expected = before;
+		#define CHECK_STATS( message ) \
+			if ( error == NULL ) \
+			{ \
+				const ovrProgramCacheStats s = GlProgram::GetCacheStats(); \
+				if ( s.Compiled != expected.Compiled || s.Shared != expected.Shared || \
+						s.LoadedBinaries != expected.LoadedBinaries || s.RejectedBinaries != expected.RejectedBinaries ) \
+				{ \
+					error = message; \
+				} \
+			}
+
+		// a miss, and then a hit on the live program
+		GlProgram a = BuildTestProgram( NULL );
+		GlProgram b = BuildTestProgram( NULL );
+		expected.Compiled++;
+		expected.Shared++;
+		CHECK_STATS( "the second build was not shared" );
+		if ( a.Program != b.Program || !SameUniforms( a, b ) )
+		{
+			error = "the shared program differs";
+		}
+
+		// other directives are another program
+		GlProgram c = BuildTestProgram( "#define VARIANT 1\n" );
+		expected.Compiled++;
+		CHECK_STATS( "a variant was not compiled" );
+		if ( c.Program == a.Program )
+		{
+			error = "a variant shares the program";
+		}
+
+		// only the last free deletes the program, which is then loaded from its binary
+		const GlProgram layout = a;
+		GlProgram::Free( a );
+		GlProgram d = BuildTestProgram( NULL );
+		expected.Shared++;
+		CHECK_STATS( "a program was deleted while in use" );
+		GlProgram::Free( b );
+		GlProgram::Free( d );
+		GlProgram::Free( c );
+		GlProgram e = BuildTestProgram( NULL );
+		expected.LoadedBinaries++;
+		CHECK_STATS( "the program was not loaded from its binary" );
+		if ( !SameUniforms( layout, e ) )
+		{
+			error = "the program loaded from its binary has other uniforms";
+		}
+		GlProgram::Free( e );
+
+		// a binary that the driver refuses is compiled again and replaced
+		ovrHostShims::SetProgramBinaryVersion( 2 );
+		GlProgram f = BuildTestProgram( NULL );
+		expected.RejectedBinaries++;
+		expected.Compiled++;
+		CHECK_STATS( "a refused binary was not compiled again" );
+		GlProgram::Free( f );
+		GlProgram g = BuildTestProgram( NULL );
+		expected.LoadedBinaries++;
+		CHECK_STATS( "the binary was not replaced" );
+		GlProgram::Free( g );
+		ovrHostShims::SetProgramBinaryVersion( 1 );
+
+		// a prefetched program is compiled once, and deleted if it is never built
+		GlProgram::Prefetch( "#define VARIANT 2\n", ProgramVertexSrc, "#define VARIANT 2\n", ProgramFragmentSrc,
+				ProgramParms, sizeof( ProgramParms ) / sizeof( ProgramParms[0] ) );
+		GlProgram h = BuildTestProgram( "#define VARIANT 2\n" );
+		expected.Compiled++;
+		CHECK_STATS( "a prefetched program was not finished by its build" );
+		GlProgram::Free( h );
+		GlProgram::Prefetch( "#define VARIANT 3\n", ProgramVertexSrc, "#define VARIANT 3\n", ProgramFragmentSrc,
+				ProgramParms, sizeof( ProgramParms ) / sizeof( ProgramParms[0] ) );
+		GlProgram::ShutdownCache();
+		CHECK_STATS( "an unbuilt prefetched program was linked" );
+		#undef CHECK_STATS
+
+		GlProgram::SetBinaryCachePath( NULL );
+		directory.RemoveFiles();
+	}
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+	}
+}
+
+static void RunProgramBuilds( ovrBenchmarkState & state, const bool keepLive, const char * binaryPath )
+{
+	GlProgram::SetBinaryCachePath( binaryPath );
+	GlProgram live = BuildTestProgram( NULL );
+	if ( !keepLive )
+	{
+		GlProgram::Free( live );
+	}
+
+	const long long glCallsBefore = ovrHostShims::GetNumGlCalls();
+	long long iterations = 0;
+	while ( state.KeepRunning() )
+	{
+		GlProgram program = BuildTestProgram( NULL );
+		GlProgram::Free( program );
+		iterations++;
+	}
+	if ( iterations > 0 )
+	{
+		state.SetCounter( "glCalls", (double)( ovrHostShims::GetNumGlCalls() - glCallsBefore ) / iterations );
+	}
+
+	if ( keepLive )
+	{
+		GlProgram::Free( live );
+	}
+	GlProgram::ShutdownCache();
+	GlProgram::SetBinaryCachePath( NULL );
+}
+
+// Builds and frees a program that is not in use, as without the cache.
+OVR_BENCHMARK( GlProgram, BuildCompiled, BENCHMARK_MICRO )
+{
+	RunProgramBuilds( state, false, NULL );
+}
+
+// Builds and frees a program that is also in use elsewhere.
+OVR_BENCHMARK( GlProgram, BuildShared, BENCHMARK_MICRO )
+{
+	RunProgramBuilds( state, true, NULL );
+}
+
+// Builds and frees a program that was saved by an earlier run.
+OVR_BENCHMARK( GlProgram, BuildBinary, BENCHMARK_MICRO )
+{
+	ovrProgramBinaryDirectory directory;
+	if ( directory.GetPath() == NULL )
+	{
+		state.SkipWithError( "could not create a directory" );
+		return;
+	}
+	RunProgramBuilds( state, false, directory.GetPath() );
+}
+
+static const int NUM_PROFILE_ZONES = 1000;
+
+// Empty zones, so the time is the profiler's. A recorded zone is two reads of the counter
+// and two event writes, and when not recording each event is one relaxed load.
+static void RunProfileZones( ovrBenchmarkState & state, const bool record )
+{
+	if ( record )
+	{
+		ovrProfiler::Start();
+	}
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < NUM_PROFILE_ZONES; i++ )
+		{
+			ovrProfileZone zone( "BenchmarkZone" );
+		}
+	}
+	ovrProfiler::Stop();
+	state.SetItemsPerIteration( NUM_PROFILE_ZONES );
+}
+
+OVR_BENCHMARK( Profiler, ZoneNotRecording, BENCHMARK_MICRO )
+{
+	RunProfileZones( state, false );
+}
+
+OVR_BENCHMARK( Profiler, ZoneRecording, BENCHMARK_MICRO )
+{
+	RunProfileZones( state, true );
+}
+
+// The same scopes timed with ovrPerfTimer and an accumulator, which does not log every scope.
+OVR_BENCHMARK( Profiler, PerfTimer, BENCHMARK_MICRO )
+{
+	ovrPerfTimerAccumulator accumulator( "BenchmarkPerfTimer" );
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < NUM_PROFILE_ZONES; i++ )
+		{
+			ovrPerfTimer timer( "BenchmarkPerfTimer", &accumulator );
+		}
+	}
+	DoNotOptimize( accumulator.GetTotalTime() );
+	state.SetItemsPerIteration( NUM_PROFILE_ZONES );
+}
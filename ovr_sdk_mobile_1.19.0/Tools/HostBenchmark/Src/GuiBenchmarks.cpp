@@ -0,0 +1,879 @@
+/************************************************************************************
+
+Filename    :   GuiBenchmarks.cpp
+Content     :   Benchmarks of the VrGUI collision primitives, menu hit tests, menu submits,
+                the menu object pools and menu file loads.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "Kernel/OVR_Allocators.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Math.h"
+#include "Kernel/OVR_MemBuffer.h"
+#include "OVR_Geometry.h"
+#include "CollisionPrimitive.h"
+#include "GuiSys.h"
+#include "VRMenuMgr.h"
+#include "DefaultComponent.h"
+#include "Reflection.h"
+#include "ReflectionCache.h"
+#include "OVR_Locale.h"
+#include "HostGui.h"
+#include "HostShims.h"
+
+using namespace OVR;
+
+static const int NUM_GUI_RAYS = 64;
+
+// A cylindrical panel in front of the origin, facing it, with about numTriangles triangles
+// and some jitter so that the triangles are not all the same size.
+struct ovrGuiMesh
+{
+	Array< Vector3f >		Vertices;
+	Array< TriangleIndex >	Indices;
+	Array< Vector2f >		UVs;
+};
+
+static void MakeCurvedPanel( ovrGuiMesh & mesh, const int numTriangles )
+{
+	ovrBenchmarkRandom random;
+	const int n = Alg::Max( 1, (int)sqrtf( numTriangles * 0.5f ) );
+	const float radius = 2.0f;
+	for ( int y = 0; y <= n; y++ )
+	{
+		for ( int x = 0; x <= n; x++ )
+		{
+			const float jitter = ( x > 0 && x < n && y > 0 && y < n ) ? 0.25f / n : 0.0f;
+			const float u = (float)x / n + random.NextFloat( -jitter, jitter );
+			const float v = (float)y / n + random.NextFloat( -jitter, jitter );
+			const float angle = ( u - 0.5f ) * 1.5f;
+			mesh.Vertices.PushBack( Vector3f( radius * sinf( angle ), v * 2.0f - 1.0f, -radius * cosf( angle ) ) );
+			mesh.UVs.PushBack( Vector2f( u, 1.0f - v ) );
+		}
+	}
+	for ( int y = 0; y < n; y++ )
+	{
+		for ( int x = 0; x < n; x++ )
+		{
+			const int i = y * ( n + 1 ) + x;
+			mesh.Indices.PushBack( (TriangleIndex)( i ) );
+			mesh.Indices.PushBack( (TriangleIndex)( i + 1 ) );
+			mesh.Indices.PushBack( (TriangleIndex)( i + n + 1 ) );
+			mesh.Indices.PushBack( (TriangleIndex)( i + 1 ) );
+			mesh.Indices.PushBack( (TriangleIndex)( i + n + 2 ) );
+			mesh.Indices.PushBack( (TriangleIndex)( i + n + 1 ) );
+		}
+	}
+}
+
+// Rays from around the origin towards the panel, some of which miss it.
+static void MakeGuiRays( Array< Vector3f > & starts, Array< Vector3f > & dirs, const int numRays )
+{
+	ovrBenchmarkRandom random;
+	for ( int i = 0; i < numRays; i++ )
+	{
+		const Vector3f start( random.NextFloat( -0.1f, 0.1f ), random.NextFloat( -0.1f, 0.1f ), random.NextFloat( -0.1f, 0.1f ) );
+		const float angle = random.NextFloat( -1.0f, 1.0f );
+		const Vector3f target( 2.0f * sinf( angle ), random.NextFloat( -1.5f, 1.5f ), -2.0f * cosf( angle ) );
+		starts.PushBack( start );
+		dirs.PushBack( ( target - start ).Normalized() );
+	}
+}
+
+static const Vector3f GUI_SCALE( 1.25f, 1.25f, 1.0f );
+
+// OvrTriCollisionPrimitive::IntersectRay as it was before the tree, testing every triangle in order.
+static bool IntersectRayBruteForce( const OvrTriCollisionPrimitive & primitive, const ovrGuiMesh & mesh,
+		Vector3f const & localStart, Vector3f const & localDir, Vector3f const & scale, OvrCollisionResult & result )
+{
+	float t0;
+	float t1;
+	if ( !primitive.IntersectRayBounds( localStart, localDir, scale, CONTENT_SOLID, t0, t1 ) )
+	{
+		return false;
+	}
+
+	result.TriIndex = -1;
+	for ( int i = 0; i < mesh.Indices.GetSizeI(); i += 3 )
+	{
+		float t_;
+		float u_;
+		float v_;
+		Vector3f verts[3];
+		verts[0] = mesh.Vertices[mesh.Indices[i]] * scale;
+		verts[1] = mesh.Vertices[mesh.Indices[i + 1]] * scale;
+		verts[2] = mesh.Vertices[mesh.Indices[i + 2]] * scale;
+		if ( Intersect_RayTriangle( localStart, localDir, verts[0], verts[1], verts[2], t_, u_, v_ ) )
+		{
+			if ( t_ < result.t )
+			{
+				result.t = t_;
+				result.TriIndex = i / 3;
+				result.uv = mesh.UVs[mesh.Indices[i + 0]] * ( 1.0f - u_ - v_ ) +
+							mesh.UVs[mesh.Indices[i + 1]] * u_ +
+							mesh.UVs[mesh.Indices[i + 2]] * v_;
+				result.Barycentric = Vector2f( u_, v_ );
+			}
+		}
+	}
+	return result.TriIndex >= 0;
+}
+
+// Checks that the tree returns exactly the results of testing every triangle, including
+// for rays that start with a limited distance and for a scale with a zero axis.
+OVR_BENCHMARK_ARGS( Gui, TriCollisionMatches, BENCHMARK_MICRO, 100, 10000 )
+{
+	ovrGuiMesh mesh;
+	MakeCurvedPanel( mesh, state.GetArg() );
+	OvrTriCollisionPrimitive primitive( mesh.Vertices, mesh.Indices, mesh.UVs, CONTENT_SOLID );
+
+	Array< Vector3f > starts;
+	Array< Vector3f > dirs;
+	MakeGuiRays( starts, dirs, 1024 );
+	const Vector3f scales[] = { Vector3f( 1.0f ), GUI_SCALE, Vector3f( 1.0f, 0.0f, 1.0f ), Vector3f( -1.0f, 1.0f, -1.0f ) };
+
+	int hits = 0;
+	while ( state.KeepRunning() )
+	{
+		hits = 0;
+		for ( int s = 0; s < 4; s++ )
+		{
+			for ( int i = 0; i < starts.GetSizeI(); i++ )
+			{
+				OvrCollisionResult expected;
+				OvrCollisionResult actual;
+				if ( i & 1 )
+				{
+					expected.t = actual.t = 2.0f;
+				}
+				const bool expectedHit = IntersectRayBruteForce( primitive, mesh, starts[i], dirs[i], scales[s], expected );
+				const bool actualHit = primitive.IntersectRay( starts[i], dirs[i], scales[s], CONTENT_SOLID, actual );
+				if ( expectedHit != actualHit || expected.t != actual.t || expected.TriIndex != actual.TriIndex ||
+						expected.uv != actual.uv || expected.Barycentric != actual.Barycentric )
+				{
+					state.SkipWithError( "tree and brute force results differ" );
+					return;
+				}
+				hits += expectedHit;
+			}
+		}
+	}
+	state.SetCounter( "hits", hits );
+	state.SetItemsPerIteration( 4 * starts.GetSizeI() );
+}
+
+static void RunTriCollision( ovrBenchmarkState & state, const bool bruteForce )
+{
+	ovrGuiMesh mesh;
+	MakeCurvedPanel( mesh, state.GetArg() );
+	OvrTriCollisionPrimitive primitive( mesh.Vertices, mesh.Indices, mesh.UVs, CONTENT_SOLID );
+
+	Array< Vector3f > starts;
+	Array< Vector3f > dirs;
+	MakeGuiRays( starts, dirs, NUM_GUI_RAYS );
+
+	while ( state.KeepRunning() )
+	{
+		int hits = 0;
+		for ( int i = 0; i < NUM_GUI_RAYS; i++ )
+		{
+			OvrCollisionResult result;
+			if ( bruteForce )
+			{
+				hits += IntersectRayBruteForce( primitive, mesh, starts[i], dirs[i], GUI_SCALE, result );
+			}
+			else
+			{
+				hits += primitive.IntersectRay( starts[i], dirs[i], GUI_SCALE, CONTENT_SOLID, result );
+			}
+		}
+		DoNotOptimize( hits );
+	}
+	state.SetCounter( "triangles", mesh.Indices.GetSizeI() / 3 );
+	state.SetItemsPerIteration( NUM_GUI_RAYS );
+}
+
+OVR_BENCHMARK_ARGS( Gui, TriCollisionRay, BENCHMARK_MICRO, 100, 1000, 10000, 100000 )
+{
+	RunTriCollision( state, false );
+}
+
+OVR_BENCHMARK_ARGS( Gui, TriCollisionRayBruteForce, BENCHMARK_MICRO, 100, 1000, 10000, 100000 )
+{
+	RunTriCollision( state, true );
+}
+
+OVR_BENCHMARK_ARGS( Gui, TriCollisionInit, BENCHMARK_MICRO, 1000, 100000 )
+{
+	ovrGuiMesh mesh;
+	MakeCurvedPanel( mesh, state.GetArg() );
+	while ( state.KeepRunning() )
+	{
+		OvrTriCollisionPrimitive primitive( mesh.Vertices, mesh.Indices, mesh.UVs, CONTENT_SOLID );
+		DoNotOptimize( primitive );
+	}
+	state.SetItemsPerIteration( mesh.Indices.GetSizeI() / 3 );
+}
+
+static const int MENU_GROUPS = 50;
+static const int MENU_PANELS_PER_GROUP = 40;
+static const int NUM_MENU_RAYS = 256;
+
+// A root with groups of small panels laid out on a wall, like a large grid of thumbnails.
+// The panels only have bounds, so both hit tests do the same work per object.
+struct ovrHitTestMenu
+{
+	menuHandle_t			Root;
+	Array< menuHandle_t >	Groups;
+	Array< menuHandle_t >	Panels;
+	Array< Vector3f >		RayStarts;
+	Array< Vector3f >		RayDirs;
+};
+
+static void CreateHitTestMenu( OvrVRMenuMgr & menuMgr, ovrHitTestMenu & menu )
+{
+	Array< VRMenuComponent* > comps;
+	Array< VRMenuSurfaceParms > surfParms;
+	VRMenuObjectParms rootParms( VRMENU_CONTAINER, comps, surfParms, "", Posef(), Vector3f( 1.0f ),
+			Posef(), Vector3f( 1.0f ), VRMenuFontParms(), VRMenuId_t( 0 ),
+			VRMenuObjectFlags_t(), VRMenuObjectInitFlags_t() );
+	menu.Root = menuMgr.CreateObject( rootParms );
+	for ( int g = 0; g < MENU_GROUPS; g++ )
+	{
+		const Posef groupPose( Quatf( Vector3f( 0.0f, 1.0f, 0.0f ), 0.02f * ( g % 10 - 5 ) ),
+				Vector3f( 1.2f * ( g % 10 - 5 ), 1.0f * ( g / 10 - 2 ), 0.0f ) );
+		VRMenuObjectParms groupParms( VRMENU_CONTAINER, comps, surfParms, "", groupPose, Vector3f( 1.0f ),
+				Posef(), Vector3f( 1.0f ), VRMenuFontParms(), VRMenuId_t( 1 + g ),
+				VRMenuObjectFlags_t(), VRMenuObjectInitFlags_t() );
+		const menuHandle_t groupHandle = menuMgr.CreateObject( groupParms );
+		menuMgr.ToObject( menu.Root )->AddChild( menuMgr, groupHandle );
+		menu.Groups.PushBack( groupHandle );
+		for ( int i = 0; i < MENU_PANELS_PER_GROUP; i++ )
+		{
+			const Posef panelPose( Quatf(), Vector3f( 0.13f * ( i % 8 ), 0.17f * ( i / 8 ), 0.0f ) );
+			VRMenuObjectParms panelParms( VRMENU_STATIC, comps, surfParms, "", panelPose, Vector3f( 1.0f ),
+					Posef(), Vector3f( 1.0f ), VRMenuFontParms(), VRMenuId_t( 1 + MENU_GROUPS + menu.Panels.GetSizeI() ),
+					VRMenuObjectFlags_t( VRMENUOBJECT_HIT_ONLY_BOUNDS ), VRMenuObjectInitFlags_t() );
+			const menuHandle_t panelHandle = menuMgr.CreateObject( panelParms );
+			menuMgr.ToObject( panelHandle )->SetLocalBoundsExpand( Vector3f( -0.05f, -0.07f, -0.01f ), Vector3f( 0.05f, 0.07f, 0.01f ) );
+			menuMgr.ToObject( groupHandle )->AddChild( menuMgr, panelHandle );
+			menu.Panels.PushBack( panelHandle );
+		}
+	}
+
+	ovrBenchmarkRandom random;
+	for ( int i = 0; i < NUM_MENU_RAYS; i++ )
+	{
+		const Vector3f start( random.NextFloat( -0.5f, 0.5f ), random.NextFloat( -0.5f, 0.5f ), 2.0f );
+		const Vector3f target( random.NextFloat( -7.0f, 7.0f ), random.NextFloat( -3.0f, 3.0f ), random.NextFloat( -2.5f, -2.0f ) );
+		menu.RayStarts.PushBack( start );
+		menu.RayDirs.PushBack( ( target - start ).Normalized() );
+	}
+}
+
+// The recursive test relies on the cull bounds that are computed when the menu is submitted.
+static void SubmitHitTestMenu( OvrGuiSys & guiSys, const ovrHitTestMenu & menu, const Posef & worldPose )
+{
+	const Matrix4f viewMatrix;
+	guiSys.GetVRMenuMgr().SubmitForRendering( guiSys, viewMatrix, menu.Root, worldPose, VRMenuRenderFlags_t() );
+	guiSys.GetVRMenuMgr().Finish( viewMatrix );
+}
+
+// Checks that the hierarchy returns exactly the object and distance of the recursive test
+// while panels and groups move, groups are hidden and shown, and the whole menu moves.
+OVR_BENCHMARK( Gui, MenuHitTestMatches, BENCHMARK_MICRO )
+{
+	OvrGuiSys * guiSys = ovrHostGui::Create();
+	OvrVRMenuMgr & menuMgr = guiSys->GetVRMenuMgr();
+	ovrHitTestMenu menu;
+	CreateHitTestMenu( menuMgr, menu );
+
+	const ContentFlags_t contents( CONTENT_SOLID );
+	const int NUM_STEPS = 8;
+	const Posef movedGroupPose = menuMgr.ToObject( menu.Groups[11] )->GetLocalPose();
+	const char * error = NULL;
+	int hits = 0;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		hits = 0;
+		Posef worldPose( Quatf(), Vector3f( 0.0f, 0.0f, -2.0f ) );
+		for ( int step = 0; step < NUM_STEPS && error == NULL; step++ )
+		{
+			switch ( step )
+			{
+				case 1:
+				case 5:
+					// some panels move, so the hierarchy is refit
+					for ( int i = step; i < menu.Panels.GetSizeI(); i += 97 )
+					{
+						VRMenuObject * panel = menuMgr.ToObject( menu.Panels[i] );
+						Vector3f pos = panel->GetLocalPosition();
+						pos.z = ( step == 1 ) ? 0.05f : 0.0f;
+						panel->SetLocalPosition( pos );
+					}
+					break;
+				case 2:
+				case 7:
+					// the whole menu moves
+					worldPose = Posef( Quatf( Vector3f( 0.2f, 1.0f, 0.1f ).Normalized(), 0.1f * step ),
+							Vector3f( 0.1f * step, -0.2f, -2.0f - 0.1f * step ) );
+					break;
+				case 3:
+					// a group moves and grows
+					menuMgr.ToObject( menu.Groups[11] )->SetLocalPosition( Vector3f( 0.3f, 0.2f, 0.5f ) );
+					menuMgr.ToObject( menu.Groups[12] )->SetLocalScale( Vector3f( 1.5f ) );
+					break;
+				case 4:
+					menuMgr.ToObject( menu.Groups[22] )->SetVisible( false );
+					break;
+				case 6:
+					menuMgr.ToObject( menu.Groups[22] )->SetVisible( true );
+					break;
+			}
+			SubmitHitTestMenu( *guiSys, menu, worldPose );
+
+			const VRMenuObject * root = menuMgr.ToObject( menu.Root );
+			for ( int i = 0; i < NUM_MENU_RAYS; i++ )
+			{
+				HitTestResult expected;
+				HitTestResult actual;
+				const menuHandle_t expectedHandle = root->HitTest( *guiSys, worldPose, menu.RayStarts[i], menu.RayDirs[i], contents, expected );
+				const menuHandle_t actualHandle = menuMgr.HitTest( *guiSys, menu.Root, worldPose, menu.RayStarts[i], menu.RayDirs[i], contents, actual );
+				if ( expectedHandle != actualHandle || ( expectedHandle.IsValid() && expected.t != actual.t ) )
+				{
+					error = "hierarchy and recursive results differ";
+					break;
+				}
+				hits += expectedHandle.IsValid();
+			}
+		}
+
+		// put the menu back for the next iteration
+		menuMgr.ToObject( menu.Groups[11] )->SetLocalPose( movedGroupPose );
+		menuMgr.ToObject( menu.Groups[12] )->SetLocalScale( Vector3f( 1.0f ) );
+	}
+
+	menuMgr.FreeObject( menu.Root );
+	ovrHostGui::Destroy( guiSys );
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+		return;
+	}
+	state.SetCounter( "hits", hits );
+	state.SetItemsPerIteration( NUM_STEPS * NUM_MENU_RAYS );
+}
+
+static void RunMenuHitTest( ovrBenchmarkState & state, const bool recursive )
+{
+	OvrGuiSys * guiSys = ovrHostGui::Create();
+	OvrVRMenuMgr & menuMgr = guiSys->GetVRMenuMgr();
+	ovrHitTestMenu menu;
+	CreateHitTestMenu( menuMgr, menu );
+	const Posef worldPose( Quatf(), Vector3f( 0.0f, 0.0f, -2.0f ) );
+	SubmitHitTestMenu( *guiSys, menu, worldPose );
+
+	const ContentFlags_t contents( CONTENT_SOLID );
+	const VRMenuObject * root = menuMgr.ToObject( menu.Root );
+	while ( state.KeepRunning() )
+	{
+		int hits = 0;
+		for ( int i = 0; i < NUM_MENU_RAYS; i++ )
+		{
+			HitTestResult result;
+			if ( recursive )
+			{
+				hits += root->HitTest( *guiSys, worldPose, menu.RayStarts[i], menu.RayDirs[i], contents, result ).IsValid();
+			}
+			else
+			{
+				hits += menuMgr.HitTest( *guiSys, menu.Root, worldPose, menu.RayStarts[i], menu.RayDirs[i], contents, result ).IsValid();
+			}
+		}
+		DoNotOptimize( hits );
+	}
+
+	menuMgr.FreeObject( menu.Root );
+	ovrHostGui::Destroy( guiSys );
+	state.SetCounter( "objects", menu.Panels.GetSizeI() );
+	state.SetItemsPerIteration( NUM_MENU_RAYS );
+}
+
+OVR_BENCHMARK( Gui, MenuHitTest, BENCHMARK_MICRO )
+{
+	RunMenuHitTest( state, false );
+}
+
+OVR_BENCHMARK( Gui, MenuHitTestRecursive, BENCHMARK_MICRO )
+{
+	RunMenuHitTest( state, true );
+}
+
+static const int NUM_SUBMIT_OBJECTS = 5000;
+static const int SUBMIT_CHILDREN_PER_OBJECT = 8;
+
+// A tree of objects with 8 children each. The objects have no surfaces and no text, so
+// nothing is added to the draw list or the font surface and only the hierarchy walk, the
+// transforms and the bounds are measured.
+static void CreateSubmitMenu( OvrVRMenuMgr & menuMgr, Array< menuHandle_t > & handles )
+{
+	Array< VRMenuComponent* > comps;
+	Array< VRMenuSurfaceParms > surfParms;
+	for ( int i = 0; i < NUM_SUBMIT_OBJECTS; i++ )
+	{
+		const Posef pose( Quatf( Vector3f( 0.0f, 0.0f, 1.0f ), 0.01f * i ), Vector3f( 0.1f, 0.05f, -0.01f ) );
+		VRMenuObjectParms parms( i == 0 ? VRMENU_CONTAINER : VRMENU_STATIC, comps, surfParms, "",
+				pose, Vector3f( 1.0f ), Posef(), Vector3f( 1.0f ), VRMenuFontParms(), VRMenuId_t( i ),
+				VRMenuObjectFlags_t(), VRMenuObjectInitFlags_t() );
+		const menuHandle_t handle = menuMgr.CreateObject( parms );
+		if ( i > 0 )
+		{
+			menuMgr.ToObject( handles[( i - 1 ) / SUBMIT_CHILDREN_PER_OBJECT] )->AddChild( menuMgr, handle );
+		}
+		handles.PushBack( handle );
+	}
+}
+
+// Submits the tree every frame with the argument's percentage of the objects moving, from the
+// leaves up so that moving 1% does not just move the root.
+static void RunMenuSubmit( ovrBenchmarkState & state, const bool cache )
+{
+	OvrGuiSys * guiSys = ovrHostGui::Create();
+	OvrVRMenuMgr & menuMgr = guiSys->GetVRMenuMgr();
+	if ( !cache )
+	{
+		ovrHostGui::CallConsoleFunction( *guiSys, "debugMenuTransformCache", "0" );
+	}
+	Array< menuHandle_t > handles;
+	CreateSubmitMenu( menuMgr, handles );
+
+	const int numChanging = NUM_SUBMIT_OBJECTS * state.GetArg() / 100;
+	const Matrix4f viewMatrix;
+	const Posef worldPose( Quatf(), Vector3f( 0.0f, 0.0f, -2.0f ) );
+	// the first submit builds the world state of every object
+	menuMgr.SubmitForRendering( *guiSys, viewMatrix, handles[0], worldPose, VRMenuRenderFlags_t() );
+	menuMgr.Finish( viewMatrix );
+
+	int frame = 0;
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < numChanging; i++ )
+		{
+			VRMenuObject * obj = menuMgr.ToObject( handles[NUM_SUBMIT_OBJECTS - 1 - i * ( NUM_SUBMIT_OBJECTS / numChanging )] );
+			Vector3f pos = obj->GetLocalPosition();
+			pos.z = ( frame & 1 ) ? -0.02f : -0.01f;
+			obj->SetLocalPosition( pos );
+		}
+		menuMgr.SubmitForRendering( *guiSys, viewMatrix, handles[0], worldPose, VRMenuRenderFlags_t() );
+		menuMgr.Finish( viewMatrix );
+		frame++;
+	}
+
+	ovrHostGui::CallConsoleFunction( *guiSys, "debugMenuTransformCache", "1" );
+	// frees the whole tree
+	menuMgr.FreeObject( handles[0] );
+	ovrHostGui::Destroy( guiSys );
+	state.SetCounter( "changing", numChanging );
+	state.SetItemsPerIteration( NUM_SUBMIT_OBJECTS );
+}
+
+OVR_BENCHMARK_ARGS( Gui, MenuSubmit, BENCHMARK_MACRO, 0, 1, 100 )
+{
+	RunMenuSubmit( state, true );
+}
+
+// The same with the world state of every object rebuilt on every submit.
+OVR_BENCHMARK_ARGS( Gui, MenuSubmitUncached, BENCHMARK_MACRO, 0, 1, 100 )
+{
+	RunMenuSubmit( state, false );
+}
+
+static const int NUM_POOL_PANELS = 2000;
+
+// A browser-sized grid of panels, each with a label and a default component, like a folder
+// browser thumbnail. There are no surfaces, so no textures are loaded and only the object,
+// component and text allocations are measured. The components are owned by the objects
+// once they are created, so the parms are made again for every build.
+static void MakePanelParms( Array< VRMenuObjectParms const * > & panelParms )
+{
+	Array< VRMenuSurfaceParms > surfParms;
+	for ( int i = 0; i < NUM_POOL_PANELS; i++ )
+	{
+		Array< VRMenuComponent* > comps;
+		comps.PushBack( new OvrDefaultComponent() );
+		const Posef pose( Quatf(), Vector3f( 0.2f * ( i % 50 ), 0.2f * ( i / 50 ), 0.0f ) );
+		panelParms.PushBack( new VRMenuObjectParms( VRMENU_BUTTON, comps, surfParms, "Panel",
+				pose, Vector3f( 1.0f ), Posef(), Vector3f( 1.0f ), VRMenuFontParms(), VRMenuId_t( 1 + i ),
+				VRMenuObjectFlags_t(), VRMenuObjectInitFlags_t() ) );
+	}
+}
+
+static menuHandle_t BuildPanels( OvrVRMenuMgr & menuMgr, const Array< VRMenuObjectParms const * > & panelParms )
+{
+	Array< VRMenuComponent* > comps;
+	Array< VRMenuSurfaceParms > surfParms;
+	VRMenuObjectParms rootParms( VRMENU_CONTAINER, comps, surfParms, "", Posef(), Vector3f( 1.0f ),
+			Posef(), Vector3f( 1.0f ), VRMenuFontParms(), VRMenuId_t( 0 ),
+			VRMenuObjectFlags_t(), VRMenuObjectInitFlags_t() );
+	const menuHandle_t rootHandle = menuMgr.CreateObject( rootParms );
+	Array< menuHandle_t > handles;
+	menuMgr.CreateObjects( panelParms, handles );
+	VRMenuObject * root = menuMgr.ToObject( rootHandle );
+	for ( int i = 0; i < handles.GetSizeI(); i++ )
+	{
+		root->AddChild( menuMgr, handles[i] );
+	}
+	return rootHandle;
+}
+
+// Builds and frees the grid every iteration, and times only the build or only the free.
+static void RunMenuPanels( ovrBenchmarkState & state, const bool timeFree )
+{
+	OvrGuiSys * guiSys = ovrHostGui::Create();
+	OvrVRMenuMgr & menuMgr = guiSys->GetVRMenuMgr();
+
+	size_t allocs = 0;
+	int builds = 0;
+	while ( state.KeepRunning() )
+	{
+		state.PauseTiming();
+		Array< VRMenuObjectParms const * > panelParms;
+		MakePanelParms( panelParms );
+		if ( !timeFree )
+		{
+			state.ResumeTiming();
+		}
+
+		menuHandle_t rootHandle;
+		{
+			AllocationCounter counter;
+			rootHandle = BuildPanels( menuMgr, panelParms );
+			allocs += counter.GetStats().Allocs;
+		}
+		builds++;
+
+		if ( timeFree )
+		{
+			state.ResumeTiming();
+		}
+		else
+		{
+			state.PauseTiming();
+		}
+		menuMgr.FreeObject( rootHandle );
+		if ( !timeFree )
+		{
+			state.ResumeTiming();
+		}
+
+		state.PauseTiming();
+		for ( int i = 0; i < panelParms.GetSizeI(); i++ )
+		{
+			delete panelParms[i];
+		}
+		state.ResumeTiming();
+	}
+
+	Array< ovrPoolStats > poolStats;
+	menuMgr.GetPoolStats( poolStats );
+	int slabs = 0;
+	for ( int i = 0; i < poolStats.GetSizeI(); i++ )
+	{
+		slabs += poolStats[i].NumSlabs;
+	}
+	ovrHostGui::Destroy( guiSys );
+	if ( builds > 0 )
+	{
+		state.SetCounter( "allocsPerBuild", (double)allocs / builds );
+	}
+	state.SetCounter( "slabs", slabs );
+	state.SetItemsPerIteration( NUM_POOL_PANELS );
+}
+
+// Builds the grid with one CreateObjects() call, so the pools grow once per build at most.
+OVR_BENCHMARK( Gui, MenuPanelsBuild, BENCHMARK_MACRO )
+{
+	RunMenuPanels( state, false );
+}
+
+// Frees the grid, which returns the objects and components to their pools.
+OVR_BENCHMARK( Gui, MenuPanelsFree, BENCHMARK_MACRO )
+{
+	RunMenuPanels( state, true );
+}
+
+static const int NUM_LOAD_PANELS = 200;
+
+// The host build does not load string tables, so every @string/ key is its own text.
+class ovrHostLocale : public ovrLocale
+{
+public:
+	virtual char const *	GetName() const { return "host"; }
+	virtual char const *	GetLanguageCode() const { return "en"; }
+	virtual bool			IsSystemDefaultLocale() const { return true; }
+	virtual bool			LoadStringsFromAndroidFormatXMLFile( ovrFileSys &, char const * ) { return false; }
+	virtual bool			AddStringsFromAndroidFormatXMLBuffer( char const *, char const *, size_t const ) { return false; }
+	virtual bool			GetString( char const *, char const * defaultStr, String & out ) const
+	{
+		out = defaultStr;
+		return false;
+	}
+	virtual void			ReplaceLocalizedText( char const * inText, char * out, size_t const outSize ) const
+	{
+		OVR_strcpy( out, outSize, inText );
+	}
+};
+
+// A menu file shaped like the sample menus: a root and a grid of panels, each with a
+// surface, a label and font parms, and a localized label on every other panel.
+static void MakeMenuText( MemBufferT< uint8_t > & buffer )
+{
+	ovrBenchmarkRandom random;
+	StringBuffer text;
+	text.AppendString( "itemParms {\n"
+			"\tVRMenuObjectParms {\n"
+			"\t\tType = VRMENU_CONTAINER;\n"
+			"\t\tFlags = VRMENUOBJECT_RENDER_HIERARCHY_ORDER | VRMENUOBJECT_DONT_RENDER_TEXT;\n"
+			"\t\tComponents {\n\t\t}\n"
+			"\t\tText = \"\";\n"
+			"\t\tLocalPose {\n\t\t\tPosition = ( 0.0f, 0.0f, 0.0f );\n\t\t\tOrientation = ( 0.0f, 0.0f, 0.0f, 1.0f );\n\t\t}\n"
+			"\t\tLocalScale = ( 1.0f, 1.0f, 1.0f );\n"
+			"\t\tParentId = -1;\n"
+			"\t\tId = 0;\n"
+			"\t\tName = \"root\";\n"
+			"\t}\n" );
+	for ( int i = 0; i < NUM_LOAD_PANELS; i++ )
+	{
+		text.AppendFormat( "\t// panel %d\n"
+				"\tVRMenuObjectParms {\n"
+				"\t\tType = VRMENU_BUTTON;\n"
+				"\t\tFlags = VRMENUOBJECT_RENDER_HIERARCHY_ORDER;\n"
+				"\t\tTexelCoords = true;\n"
+				"\t\tSurfaceParms {\n"
+				"\t\t\tVRMenuSurfaceParms {\n"
+				"\t\t\t\tSurfaceName = \"panel_%d\";\n"
+				"\t\t\t\tImageNames {\n\t\t\t\t\tString[0] = \"apk:///assets/panel_%d.ktx\";\n\t\t\t\t}\n"
+				"\t\t\t\tTextureTypes {\n\t\t\t\t\teSurfaceTextureType[0] = SURFACE_TEXTURE_DIFFUSE;\n\t\t\t\t}\n"
+				"\t\t\t\tColor = ( %f, %f, %f, 1.0f );\n"
+				"\t\t\t\tBorder = ( 16.0f, 16.0f, 16.0f, 16.0f );\n"
+				"\t\t\t\tDims = ( 128.0f, 96.0f );\n"
+				"\t\t\t}\n"
+				"\t\t}\n"
+				"\t\tText = \"%s%d\";\n"
+				"\t\tLocalPose {\n\t\t\tPosition = ( %f, %f, 0.0f );\n\t\t\tOrientation = ( 0.0f, 0.0f, 0.0f, 1.0f );\n\t\t}\n"
+				"\t\tLocalScale = ( 128.0f, 96.0f, 1.0f );\n"
+				"\t\tTextLocalPose {\n\t\t\tPosition = ( 0.0f, -56.0f, 0.0f );\n\t\t\tOrientation = ( 0.0f, 0.0f, 0.0f, 1.0f );\n\t\t}\n"
+				"\t\tFontParms {\n\t\t\tAlignHoriz = HORIZONTAL_CENTER;\n\t\t\tAlignVert = VERTICAL_BASELINE;\n\t\t\tScale = 0.5f;\n\t\t}\n"
+				"\t\tParentName = \"root\";\n"
+				"\t\tId = %d;\n"
+				"\t\tName = \"panel_%d\";\n"
+				"\t}\n",
+				i, i, i, random.NextFloat( 0.0f, 1.0f ), random.NextFloat( 0.0f, 1.0f ), random.NextFloat( 0.0f, 1.0f ),
+				( i & 1 ) ? "@string/panel_" : "Panel ", i, 144.0f * ( i % 20 ), 112.0f * ( i / 20 ), 1 + i, i );
+	}
+	text.AppendString( "}\n" );
+
+	// the parser expects the file to be 0-terminated, like VRMenu::InitFromReflectionData
+	buffer.Realloc( text.GetSize() + 1 );
+	memcpy( static_cast< uint8_t * >( buffer ), text.ToCStr(), text.GetSize() + 1 );
+}
+
+static bool LoadMenu( ovrReflection & refl, const ovrLocale & locale, const MemBufferT< uint8_t > & buffer,
+		Array< VRMenuObjectParms const * > & itemParms )
+{
+	const ovrParseResult parseRes = VRMenuObject::ParseItemParms( refl, locale, "benchmark", buffer, itemParms );
+	return parseRes && itemParms.GetSizeI() == 1 + NUM_LOAD_PANELS;
+}
+
+// Loads the menu file every iteration, from text or by replaying the recording in the cache.
+static void RunMenuLoad( ovrBenchmarkState & state, const bool cached )
+{
+	ovrHostLocale locale;
+	MemBufferT< uint8_t > buffer;
+	MakeMenuText( buffer );
+	ovrReflection * refl = ovrReflection::Create();
+
+	size_t allocs = 0;
+	int loads = 0;
+	bool ok = true;
+	while ( state.KeepRunning() && ok )
+	{
+		if ( !cached )
+		{
+			state.PauseTiming();
+			refl->GetCache().Clear();
+			state.ResumeTiming();
+		}
+		Array< VRMenuObjectParms const * > itemParms;
+		{
+			AllocationCounter counter;
+			ok = LoadMenu( *refl, locale, buffer, itemParms );
+			allocs += counter.GetStats().Allocs;
+		}
+		loads++;
+		DeletePointerArray( itemParms );
+	}
+
+	if ( !ok )
+	{
+		state.SkipWithError( "the menu file did not parse" );
+	}
+	else if ( loads > 0 )
+	{
+		MemBufferT< uint8_t > cacheFile;
+		refl->GetCache().Write( *refl, cacheFile );
+		state.SetCounter( "allocsPerLoad", (double)allocs / loads );
+		state.SetCounter( "cacheFileBytes", (double)cacheFile.GetSize() );
+	}
+	ovrReflection::Destroy( refl );
+	state.SetItemsPerIteration( 1 + NUM_LOAD_PANELS );
+	state.SetBytesPerIteration( (double)buffer.GetSize() );
+}
+
+// Lexes and parses the text, which is what every launch did before the cache was kept.
+OVR_BENCHMARK( Gui, MenuLoadText, BENCHMARK_MACRO )
+{
+	RunMenuLoad( state, false );
+}
+
+// Replays the recording, which is what a launch does once the cache file was written.
+OVR_BENCHMARK( Gui, MenuLoadCached, BENCHMARK_MACRO )
+{
+	RunMenuLoad( state, true );
+}
+
+static bool SameItemParms( const VRMenuObjectParms & a, const VRMenuObjectParms & b )
+{
+	if ( a.Type != b.Type || a.Flags.GetValue() != b.Flags.GetValue() || a.Id != b.Id || a.Text != b.Text || a.Name != b.Name
+			|| a.ParentName != b.ParentName || !a.LocalPose.Translation.Compare( b.LocalPose.Translation )
+			|| !a.LocalScale.Compare( b.LocalScale ) || a.SurfaceParms.GetSizeI() != b.SurfaceParms.GetSizeI() )
+	{
+		return false;
+	}
+	for ( int i = 0; i < a.SurfaceParms.GetSizeI(); i++ )
+	{
+		if ( a.SurfaceParms[i].SurfaceName != b.SurfaceParms[i].SurfaceName
+				|| a.SurfaceParms[i].ImageNames[0] != b.SurfaceParms[i].ImageNames[0] )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Reads the cache file into a new reflection, as the next launch would.
+static int LoadCacheFile( const char * fileName )
+{
+	ovrReflection * refl = ovrReflection::Create();
+	refl->GetCache().SetFileName( fileName );
+	refl->GetCache().Load( *refl );
+	const int numEntries = refl->GetCache().GetNumEntries();
+	ovrReflection::Destroy( refl );
+	return numEntries;
+}
+
+// Writes the cache file after parsing the text, and checks that a new reflection reads it
+// and replays exactly the parms that were parsed. Then checks that a corrupted or truncated
+// file is ignored.
+OVR_BENCHMARK( Gui, MenuLoadCacheMatches, BENCHMARK_MACRO )
+{
+	ovrHostLocale locale;
+	MemBufferT< uint8_t > buffer;
+	MakeMenuText( buffer );
+
+	char path[64];
+	OVR_strcpy( path, sizeof( path ), "/tmp/ovr_benchmark_XXXXXX" );
+	if ( mkdtemp( path ) == NULL )
+	{
+		state.SkipWithError( "failed to create a temporary directory" );
+		return;
+	}
+	char fileName[128];
+	OVR_sprintf( fileName, sizeof( fileName ), "%s/reflection.cache", path );
+
+	// the corrupted and truncated files are expected to be reported
+	const int logPriority = ovrHostShims::GetLogPriority();
+	ovrHostShims::SetLogPriority( ANDROID_LOG_ERROR );
+
+	const char * error = NULL;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		unlink( fileName );
+
+		Array< VRMenuObjectParms const * > textParms;
+		ovrReflection * refl = ovrReflection::Create();
+		refl->GetCache().SetFileName( fileName );
+		refl->GetCache().Load( *refl );
+		const bool parsed = LoadMenu( *refl, locale, buffer, textParms );
+		refl->GetCache().Save( *refl );
+		ovrReflection::Destroy( refl );
+
+		Array< VRMenuObjectParms const * > cachedParms;
+		refl = ovrReflection::Create();
+		refl->GetCache().SetFileName( fileName );
+		refl->GetCache().Load( *refl );
+		const int numEntries = refl->GetCache().GetNumEntries();
+		const bool replayed = LoadMenu( *refl, locale, buffer, cachedParms );
+		ovrReflection::Destroy( refl );
+
+		if ( !parsed || !replayed )
+		{
+			error = "the menu file did not parse";
+		}
+		else if ( numEntries != 1 )
+		{
+			error = "the cache file was not read";
+		}
+		else
+		{
+			for ( int i = 0; i < textParms.GetSizeI(); i++ )
+			{
+				if ( !SameItemParms( *textParms[i], *cachedParms[i] ) )
+				{
+					error = "the cached parms differ from the parsed parms";
+					break;
+				}
+			}
+		}
+		DeletePointerArray( textParms );
+		DeletePointerArray( cachedParms );
+		if ( error != NULL )
+		{
+			break;
+		}
+
+		MemBufferFile file( fileName );
+		MemBufferT< uint8_t > corrupted( (size_t)file.Length );
+		memcpy( static_cast< uint8_t * >( corrupted ), file.Buffer, file.Length );
+		corrupted[file.Length / 2] ^= 0x55;
+		MemBuffer( static_cast< uint8_t * >( corrupted ), file.Length ).WriteToFile( fileName );
+		if ( LoadCacheFile( fileName ) != 0 )
+		{
+			error = "a corrupted cache file was read";
+			break;
+		}
+		MemBuffer( file.Buffer, file.Length / 2 ).WriteToFile( fileName );
+		if ( LoadCacheFile( fileName ) != 0 )
+		{
+			error = "a truncated cache file was read";
+		}
+	}
+	ovrHostShims::SetLogPriority( logPriority );
+	unlink( fileName );
+	rmdir( path );
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+	}
+}
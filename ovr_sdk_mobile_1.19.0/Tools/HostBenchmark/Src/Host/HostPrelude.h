@@ -0,0 +1,39 @@
+/************************************************************************************
+
+Filename    :   HostPrelude.h
+Content     :   Included before every source file of the host build.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_HostPrelude_h )
+#define OVR_HostPrelude_h
+
+// The sources are compiled as for Android (ANDROID is defined), so this fills in what
+// bionic has and glibc does not.
+
+#include <stddef.h>
+#include <string.h>
+#include <sched.h>
+#include <sys/time.h>
+
+#if !defined( SCHED_NORMAL )
+#define SCHED_NORMAL	SCHED_OTHER
+#endif
+
+#if defined( __GLIBC__ ) && ( __GLIBC__ < 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ < 38 ) )
+#define OVR_HOST_NEEDS_STRLCPY
+#if defined( __cplusplus )
+extern "C" {
+#endif
+size_t strlcpy( char * dst, const char * src, size_t size );
+size_t strlcat( char * dst, const char * src, size_t size );
+#if defined( __cplusplus )
+}
+#endif
+#endif
+
+#endif // OVR_HostPrelude_h
@@ -0,0 +1,18 @@
+/************************************************************************************
+
+Filename    :   api-level.h
+Content     :   Android API level for the host build.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_Host_api_level_h )
+#define OVR_Host_api_level_h
+
+// The GL headers of the host have the GLint64 types of API level 21 and later.
+#define __ANDROID_API__		24
+
+#endif // OVR_Host_api_level_h
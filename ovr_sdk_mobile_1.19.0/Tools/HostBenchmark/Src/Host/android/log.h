@@ -0,0 +1,43 @@
+/************************************************************************************
+
+Filename    :   log.h
+Content     :   Android log interface for the host build, implemented in HostShims.cpp.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_Host_log_h )
+#define OVR_Host_log_h
+
+#include <stdarg.h>
+
+typedef enum android_LogPriority
+{
+	ANDROID_LOG_UNKNOWN = 0,
+	ANDROID_LOG_DEFAULT,
+	ANDROID_LOG_VERBOSE,
+	ANDROID_LOG_DEBUG,
+	ANDROID_LOG_INFO,
+	ANDROID_LOG_WARN,
+	ANDROID_LOG_ERROR,
+	ANDROID_LOG_FATAL,
+	ANDROID_LOG_SILENT
+} android_LogPriority;
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+int		__android_log_write( int prio, const char * tag, const char * text );
+int		__android_log_print( int prio, const char * tag, const char * fmt, ... ) __attribute__(( __format__( printf, 3, 4 ) ));
+int		__android_log_vprint( int prio, const char * tag, const char * fmt, va_list ap );
+void	__android_log_assert( const char * cond, const char * tag, const char * fmt, ... ) __attribute__(( __noreturn__ ));
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif // OVR_Host_log_h
@@ -0,0 +1,32 @@
+/************************************************************************************
+
+Filename    :   jni.h
+Content     :   Opaque JNI types for the host build. Nothing in the host build calls Java.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_Host_jni_h )
+#define OVR_Host_jni_h
+
+#include <stdint.h>
+
+#define JNIEXPORT
+
+typedef uint8_t		jboolean;
+typedef int32_t		jint;
+typedef int64_t		jlong;
+typedef float		jfloat;
+
+typedef struct _JNIEnv JNIEnv;
+typedef struct _JavaVM JavaVM;
+typedef struct _jmethodID * jmethodID;
+typedef struct _jfieldID * jfieldID;
+typedef struct _jobject * jobject;
+typedef jobject jclass;
+typedef jobject jstring;
+
+#endif // OVR_Host_jni_h
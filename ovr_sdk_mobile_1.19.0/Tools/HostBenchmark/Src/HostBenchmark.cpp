@@ -0,0 +1,501 @@
+/************************************************************************************
+
+Filename    :   HostBenchmark.cpp
+Content     :   Registers and times the benchmarks of the host benchmark suite.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_JSON.h"
+#include "Kernel/OVR_LogUtils.h"
+#include "Kernel/OVR_StringHash.h"
+
+namespace OVR {
+
+//==============================================================
+// ovrBenchmarkState
+
+ovrBenchmarkState::ovrBenchmarkState( const int arg, const long long iterations ) :
+	Arg( arg ),
+	Iterations( iterations ),
+	Remaining( iterations ),
+	StartNanoSeconds( 0.0 ),
+	ElapsedNanoSeconds( 0.0 ),
+	Stopped( false ),
+	ItemsPerIteration( 0.0 ),
+	BytesPerIteration( 0.0 ),
+	NumCounters( 0 ),
+	Error( NULL )
+{
+}
+
+void ovrBenchmarkState::PauseTiming()
+{
+	ElapsedNanoSeconds += SystemClock::GetTimeInNanoSeconds() - StartNanoSeconds;
+}
+
+void ovrBenchmarkState::ResumeTiming()
+{
+	StartNanoSeconds = SystemClock::GetTimeInNanoSeconds();
+}
+
+void ovrBenchmarkState::SetCounter( const char * name, const double value )
+{
+	for ( int i = 0; i < NumCounters; i++ )
+	{
+		if ( strcmp( CounterNames[i], name ) == 0 )
+		{
+			CounterValues[i] = value;
+			return;
+		}
+	}
+	if ( NumCounters < MAX_COUNTERS )
+	{
+		CounterNames[NumCounters] = name;
+		CounterValues[NumCounters] = value;
+		NumCounters++;
+	}
+}
+
+void ovrBenchmarkState::SkipWithError( const char * message )
+{
+	Error = message;
+	Remaining = 0;
+}
+
+//==============================================================
+// registry
+// Benchmarks register themselves before main() and OVR::System::Init(), so the
+// registry can't use the OVR allocator.
+
+struct ovrBenchmarkEntry
+{
+	char					Name[128];
+	ovrBenchmarkKind		Kind;
+	ovrBenchmarkFunction	Function;
+	int						Arg;
+};
+
+static const int			MAX_BENCHMARKS = 512;
+static ovrBenchmarkEntry	Benchmarks[MAX_BENCHMARKS];
+static int					NumBenchmarks = 0;
+
+static void RegisterBenchmark( const char * group, const char * name, const ovrBenchmarkKind kind,
+		ovrBenchmarkFunction function, const int arg, const bool hasArg )
+{
+	if ( NumBenchmarks >= MAX_BENCHMARKS )
+	{
+		fprintf( stderr, "Too many benchmarks, %s/%s is not registered\n", group, name );
+		return;
+	}
+	ovrBenchmarkEntry & entry = Benchmarks[NumBenchmarks++];
+	if ( hasArg )
+	{
+		snprintf( entry.Name, sizeof( entry.Name ), "%s/%s/%d", group, name, arg );
+	}
+	else
+	{
+		snprintf( entry.Name, sizeof( entry.Name ), "%s/%s", group, name );
+	}
+	entry.Kind = kind;
+	entry.Function = function;
+	entry.Arg = arg;
+}
+
+ovrBenchmarkRegistrar::ovrBenchmarkRegistrar( const char * group, const char * name, const ovrBenchmarkKind kind,
+		ovrBenchmarkFunction function, const int * args, const int numArgs )
+{
+	if ( numArgs == 0 )
+	{
+		RegisterBenchmark( group, name, kind, function, 0, false );
+	}
+	for ( int i = 0; i < numArgs; i++ )
+	{
+		RegisterBenchmark( group, name, kind, function, args[i], true );
+	}
+}
+
+//==============================================================
+// ovrBenchmarkOptions
+
+ovrBenchmarkOptions::ovrBenchmarkOptions() :
+	Filter( NULL ),
+	MinSeconds( 0.1 ),
+	Repetitions( 5 ),
+	Label( NULL ),
+	OutputPath( NULL ),
+	BaselinePath( NULL ),
+	MaxSlowdown( 0.1 ),
+	ListOnly( false )
+{
+}
+
+//==============================================================
+// ovrBenchmarkRunner
+
+struct ovrBenchmarkResult
+{
+	const ovrBenchmarkEntry *	Entry;
+	long long					Iterations;		// per repetition
+	Array< double >				NanoSeconds;	// per iteration, one per repetition
+	double						Min;
+	double						Median;
+	double						Mean;
+	double						StdDev;
+	double						ItemsPerIteration;
+	double						BytesPerIteration;
+	const char *				CounterNames[ovrBenchmarkState::MAX_COUNTERS];
+	double						CounterValues[ovrBenchmarkState::MAX_COUNTERS];
+	int							NumCounters;
+	const char *				Error;
+	double						BaselineMedian;	// 0 if not in the baseline
+	bool						Regressed;
+};
+
+static bool EntryLess( const ovrBenchmarkEntry * a, const ovrBenchmarkEntry * b )
+{
+	return strcmp( a->Name, b->Name ) < 0;
+}
+
+static const long long	MAX_ITERATIONS = 1000000000LL;
+
+ovrBenchmarkState ovrBenchmarkRunner::RunOnce( const ovrBenchmarkEntry & entry, const long long iterations )
+{
+	ovrBenchmarkState state( entry.Arg, iterations );
+	entry.Function( state );
+	// a function that returns without running the loop measured nothing
+	if ( state.Error == NULL && !state.Stopped )
+	{
+		state.Error = "the benchmark did not finish its KeepRunning() loop";
+	}
+	return state;
+}
+
+void ovrBenchmarkRunner::RunBenchmark( const ovrBenchmarkEntry & entry, const ovrBenchmarkOptions & options, ovrBenchmarkResult & result )
+{
+	result.Entry = &entry;
+	result.Error = NULL;
+	result.NumCounters = 0;
+	result.BaselineMedian = 0.0;
+	result.Regressed = false;
+
+	// Find the number of iterations that take at least the minimum time.
+	const double minNanoSeconds = options.MinSeconds * 1e9;
+	long long iterations = 1;
+	for ( ; ; )
+	{
+		const ovrBenchmarkState state = RunOnce( entry, iterations );
+		if ( state.Error != NULL )
+		{
+			result.Error = state.Error;
+			return;
+		}
+		if ( state.ElapsedNanoSeconds >= minNanoSeconds || iterations >= MAX_ITERATIONS )
+		{
+			break;
+		}
+		double multiplier = ( state.ElapsedNanoSeconds > 0.0 ) ? minNanoSeconds * 1.4 / state.ElapsedNanoSeconds : 10.0;
+		multiplier = Alg::Min( multiplier, 10.0 );
+		iterations = Alg::Max( iterations + 1, (long long)( iterations * multiplier ) );
+		iterations = Alg::Min( iterations, MAX_ITERATIONS );
+	}
+	result.Iterations = iterations;
+
+	for ( int i = 0; i < options.Repetitions; i++ )
+	{
+		const ovrBenchmarkState state = RunOnce( entry, iterations );
+		if ( state.Error != NULL )
+		{
+			result.Error = state.Error;
+			return;
+		}
+		result.NanoSeconds.PushBack( state.ElapsedNanoSeconds / iterations );
+		result.ItemsPerIteration = state.ItemsPerIteration;
+		result.BytesPerIteration = state.BytesPerIteration;
+		result.NumCounters = state.NumCounters;
+		for ( int j = 0; j < state.NumCounters; j++ )
+		{
+			result.CounterNames[j] = state.CounterNames[j];
+			result.CounterValues[j] = state.CounterValues[j];
+		}
+	}
+
+	Array< double > sorted = result.NanoSeconds;
+	Alg::QuickSort( sorted );
+	const int count = sorted.GetSizeI();
+	result.Min = sorted[0];
+	result.Median = ( count & 1 ) ? sorted[count / 2] : 0.5 * ( sorted[count / 2 - 1] + sorted[count / 2] );
+	double sum = 0.0;
+	for ( int i = 0; i < count; i++ )
+	{
+		sum += sorted[i];
+	}
+	result.Mean = sum / count;
+	double sumSquares = 0.0;
+	for ( int i = 0; i < count; i++ )
+	{
+		sumSquares += ( sorted[i] - result.Mean ) * ( sorted[i] - result.Mean );
+	}
+	result.StdDev = ( count > 1 ) ? sqrt( sumSquares / ( count - 1 ) ) : 0.0;
+}
+
+static void FormatTime( char * buffer, const size_t bufferSize, const double nanoSeconds )
+{
+	if ( nanoSeconds < 1e4 )
+	{
+		snprintf( buffer, bufferSize, "%9.1f ns", nanoSeconds );
+	}
+	else if ( nanoSeconds < 1e7 )
+	{
+		snprintf( buffer, bufferSize, "%9.2f us", nanoSeconds * 1e-3 );
+	}
+	else
+	{
+		snprintf( buffer, bufferSize, "%9.2f ms", nanoSeconds * 1e-6 );
+	}
+}
+
+static void FormatRate( char * buffer, const size_t bufferSize, const double perSecond, const char * unit )
+{
+	if ( perSecond >= 1e9 )
+	{
+		snprintf( buffer, bufferSize, "%7.2f G%s/s", perSecond * 1e-9, unit );
+	}
+	else if ( perSecond >= 1e6 )
+	{
+		snprintf( buffer, bufferSize, "%7.2f M%s/s", perSecond * 1e-6, unit );
+	}
+	else
+	{
+		snprintf( buffer, bufferSize, "%7.2f k%s/s", perSecond * 1e-3, unit );
+	}
+}
+
+static void PrintResult( const ovrBenchmarkResult & result )
+{
+	if ( result.Error != NULL )
+	{
+		printf( "%-48s FAILED: %s\n", result.Entry->Name, result.Error );
+		return;
+	}
+	char time[32];
+	FormatTime( time, sizeof( time ), result.Median );
+	char rate[32] = "";
+	if ( result.BytesPerIteration > 0.0 )
+	{
+		FormatRate( rate, sizeof( rate ), result.BytesPerIteration * 1e9 / result.Median, "B" );
+	}
+	else if ( result.ItemsPerIteration > 0.0 )
+	{
+		FormatRate( rate, sizeof( rate ), result.ItemsPerIteration * 1e9 / result.Median, "items" );
+	}
+	char baseline[48] = "";
+	if ( result.BaselineMedian > 0.0 )
+	{
+		snprintf( baseline, sizeof( baseline ), " %+6.1f%%%s", ( result.Median / result.BaselineMedian - 1.0 ) * 100.0,
+				result.Regressed ? " REGRESSED" : "" );
+	}
+	printf( "%-48s %s %5.1f%% %12lld %16s%s\n", result.Entry->Name, time,
+			result.Median > 0.0 ? result.StdDev / result.Median * 100.0 : 0.0, result.Iterations, rate, baseline );
+	fflush( stdout );
+}
+
+static void LoadBaseline( const char * path, StringHash< double > & medians )
+{
+	const char * error = NULL;
+	JSON * json = JSON::Load( path, &error );
+	if ( json == NULL )
+	{
+		fprintf( stderr, "Could not load the baseline %s: %s\n", path, error != NULL ? error : "" );
+		return;
+	}
+	const JsonReader root( json );
+	if ( root.IsObject() )
+	{
+		const JsonReader benchmarks( root.GetChildByName( "benchmarks" ) );
+		if ( benchmarks.IsArray() )
+		{
+			while ( !benchmarks.IsEndOfArray() )
+			{
+				const JsonReader benchmark( benchmarks.GetNextArrayElement() );
+				if ( benchmark.IsObject() )
+				{
+					const String name = benchmark.GetChildStringByName( "name" );
+					const double median = benchmark.GetChildDoubleByName( "medianNs" );
+					if ( !name.IsEmpty() && median > 0.0 )
+					{
+						medians.Set( name, median );
+					}
+				}
+			}
+		}
+	}
+	json->Release();
+}
+
+static JSON * CreateContext( const ovrBenchmarkOptions & options )
+{
+	JSON * context = JSON::CreateObject();
+
+	char date[64];
+	const time_t now = time( NULL );
+	struct tm utc;
+	gmtime_r( &now, &utc );
+	strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%SZ", &utc );
+	context->AddStringItem( "date", date );
+
+	char hostName[256] = "";
+	gethostname( hostName, sizeof( hostName ) - 1 );
+	context->AddStringItem( "host", hostName );
+	context->AddNumberItem( "numCpus", (double)sysconf( _SC_NPROCESSORS_ONLN ) );
+#if defined( __aarch64__ )
+	context->AddStringItem( "arch", "arm64" );
+#elif defined( __arm__ )
+	context->AddStringItem( "arch", "arm" );
+#elif defined( __x86_64__ )
+	context->AddStringItem( "arch", "x86_64" );
+#else
+	context->AddStringItem( "arch", "unknown" );
+#endif
+	context->AddStringItem( "compiler", __VERSION__ );
+#if defined( OVR_BUILD_DEBUG )
+	context->AddStringItem( "build", "debug" );
+#else
+	context->AddStringItem( "build", "release" );
+#endif
+	context->AddStringItem( "label", options.Label != NULL ? options.Label : "" );
+	context->AddStringItem( "filter", options.Filter != NULL ? options.Filter : "" );
+	context->AddNumberItem( "minSeconds", options.MinSeconds );
+	context->AddNumberItem( "repetitions", options.Repetitions );
+	return context;
+}
+
+static JSON * CreateResult( const ovrBenchmarkResult & result )
+{
+	JSON * benchmark = JSON::CreateObject();
+	benchmark->AddStringItem( "name", result.Entry->Name );
+	benchmark->AddStringItem( "kind", result.Entry->Kind == BENCHMARK_MACRO ? "macro" : "micro" );
+	if ( result.Error != NULL )
+	{
+		benchmark->AddStringItem( "error", result.Error );
+		return benchmark;
+	}
+	benchmark->AddNumberItem( "iterations", (double)result.Iterations );
+	benchmark->AddNumberItem( "medianNs", result.Median );
+	benchmark->AddNumberItem( "meanNs", result.Mean );
+	benchmark->AddNumberItem( "minNs", result.Min );
+	benchmark->AddNumberItem( "stdDevNs", result.StdDev );
+	JSON * repetitions = JSON::CreateArray();
+	for ( int i = 0; i < result.NanoSeconds.GetSizeI(); i++ )
+	{
+		repetitions->AddArrayNumber( result.NanoSeconds[i] );
+	}
+	benchmark->AddItem( "repetitionsNs", repetitions );
+	if ( result.ItemsPerIteration > 0.0 )
+	{
+		benchmark->AddNumberItem( "itemsPerSecond", result.ItemsPerIteration * 1e9 / result.Median );
+	}
+	if ( result.BytesPerIteration > 0.0 )
+	{
+		benchmark->AddNumberItem( "bytesPerSecond", result.BytesPerIteration * 1e9 / result.Median );
+	}
+	if ( result.NumCounters > 0 )
+	{
+		JSON * counters = JSON::CreateObject();
+		for ( int i = 0; i < result.NumCounters; i++ )
+		{
+			counters->AddNumberItem( result.CounterNames[i], result.CounterValues[i] );
+		}
+		benchmark->AddItem( "counters", counters );
+	}
+	if ( result.BaselineMedian > 0.0 )
+	{
+		benchmark->AddNumberItem( "baselineMedianNs", result.BaselineMedian );
+		benchmark->AddBoolItem( "regressed", result.Regressed );
+	}
+	return benchmark;
+}
+
+int ovrBenchmarkRunner::Run( const ovrBenchmarkOptions & options )
+{
+	Array< const ovrBenchmarkEntry * > entries;
+	for ( int i = 0; i < NumBenchmarks; i++ )
+	{
+		if ( options.Filter == NULL || strstr( Benchmarks[i].Name, options.Filter ) != NULL )
+		{
+			entries.PushBack( &Benchmarks[i] );
+		}
+	}
+	Alg::QuickSort( entries, EntryLess );
+
+	if ( options.ListOnly )
+	{
+		for ( int i = 0; i < entries.GetSizeI(); i++ )
+		{
+			printf( "%s\n", entries[i]->Name );
+		}
+		return 0;
+	}
+
+	StringHash< double > baseline;
+	if ( options.BaselinePath != NULL )
+	{
+		LoadBaseline( options.BaselinePath, baseline );
+	}
+
+	printf( "%-48s %12s %6s %12s %16s\n", "benchmark", "median", "stddev", "iterations", "rate" );
+
+	JSON * benchmarks = JSON::CreateArray();
+	int numFailed = 0;
+	for ( int i = 0; i < entries.GetSizeI(); i++ )
+	{
+		ovrBenchmarkResult result;
+		RunBenchmark( *entries[i], options, result );
+		if ( result.Error == NULL )
+		{
+			double baselineMedian = 0.0;
+			if ( baseline.Get( entries[i]->Name, &baselineMedian ) )
+			{
+				result.BaselineMedian = baselineMedian;
+				result.Regressed = ( result.Median > baselineMedian * ( 1.0 + options.MaxSlowdown ) );
+			}
+		}
+		numFailed += ( result.Error != NULL || result.Regressed ) ? 1 : 0;
+		PrintResult( result );
+		benchmarks->AddArrayElement( CreateResult( result ) );
+	}
+
+	if ( options.OutputPath != NULL )
+	{
+		JSON * root = JSON::CreateObject();
+		root->AddItem( "context", CreateContext( options ) );
+		root->AddItem( "benchmarks", benchmarks );
+		if ( !root->Save( options.OutputPath ) )
+		{
+			fprintf( stderr, "Could not write %s\n", options.OutputPath );
+			numFailed++;
+		}
+		root->Release();
+	}
+	else
+	{
+		benchmarks->Release();
+	}
+
+	return numFailed;
+}
+
+} // namespace OVR
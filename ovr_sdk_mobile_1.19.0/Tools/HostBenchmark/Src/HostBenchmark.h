@@ -0,0 +1,190 @@
+/************************************************************************************
+
+Filename    :   HostBenchmark.h
+Content     :   Registers and times the benchmarks of the host benchmark suite.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_HostBenchmark_h )
+#define OVR_HostBenchmark_h
+
+#include "SystemClock.h"
+
+namespace OVR {
+
+enum ovrBenchmarkKind
+{
+	BENCHMARK_MICRO,	// one operation on warm data
+	BENCHMARK_MACRO		// a whole load or frame of work
+};
+
+//==============================================================
+// ovrBenchmarkState
+// Passed to a benchmark function, which does its setup and then runs the measured code
+// in a loop:
+//
+//	while ( state.KeepRunning() )
+//	{
+//		...
+//	}
+//
+// Only the time spent in the loop is measured. The function is called several times,
+// first to find how many iterations fill the minimum time, and then once per repetition.
+class ovrBenchmarkState
+{
+public:
+					ovrBenchmarkState( const int arg, const long long iterations );
+
+	// The argument the benchmark was registered with, or 0.
+	int				GetArg() const { return Arg; }
+
+	bool			KeepRunning()
+	{
+		if ( Remaining > 0 )
+		{
+			if ( Remaining == Iterations )
+			{
+				StartNanoSeconds = SystemClock::GetTimeInNanoSeconds();
+			}
+			Remaining--;
+			return true;
+		}
+		if ( !Stopped )
+		{
+			ElapsedNanoSeconds += SystemClock::GetTimeInNanoSeconds() - StartNanoSeconds;
+			Stopped = true;
+		}
+		return false;
+	}
+
+	// Excludes work done inside the loop, like resetting the data, from the measurement.
+	void			PauseTiming();
+	void			ResumeTiming();
+
+	// Work done by one iteration, reported as items and bytes per second.
+	void			SetItemsPerIteration( const double items ) { ItemsPerIteration = items; }
+	void			SetBytesPerIteration( const double bytes ) { BytesPerIteration = bytes; }
+	// A value measured by the benchmark that is reported as is, like a count per iteration.
+	// Up to MAX_COUNTERS are kept. The name is not copied.
+	void			SetCounter( const char * name, const double value );
+
+	// Stops the benchmark and reports it as failed. Call before returning from the function.
+	void			SkipWithError( const char * message );
+
+	static const int	MAX_COUNTERS = 4;
+
+private:
+	friend class ovrBenchmarkRunner;
+
+	int				Arg;
+	long long		Iterations;
+	long long		Remaining;
+	double			StartNanoSeconds;
+	double			ElapsedNanoSeconds;
+	bool			Stopped;
+	double			ItemsPerIteration;
+	double			BytesPerIteration;
+	const char *	CounterNames[MAX_COUNTERS];
+	double			CounterValues[MAX_COUNTERS];
+	int				NumCounters;
+	const char *	Error;
+};
+
+typedef void ( *ovrBenchmarkFunction )( ovrBenchmarkState & state );
+
+//==============================================================
+// ovrBenchmarkRegistrar
+// Adds a benchmark to the suite when the program starts. Use OVR_BENCHMARK() or
+// OVR_BENCHMARK_ARGS() instead of declaring these directly.
+class ovrBenchmarkRegistrar
+{
+public:
+	ovrBenchmarkRegistrar( const char * group, const char * name, const ovrBenchmarkKind kind,
+			ovrBenchmarkFunction function, const int * args, const int numArgs );
+};
+
+//==============================================================
+// ovrBenchmarkOptions
+struct ovrBenchmarkOptions
+{
+					ovrBenchmarkOptions();
+
+	const char *	Filter;				// only run benchmarks whose name contains this
+	double			MinSeconds;			// minimum time of each repetition
+	int				Repetitions;
+	const char *	Label;				// recorded in the results, like a commit hash
+	const char *	OutputPath;			// JSON results, if not NULL
+	const char *	BaselinePath;		// JSON results to compare against, if not NULL
+	double			MaxSlowdown;		// a median this much slower than the baseline is a regression
+	bool			ListOnly;
+};
+
+struct ovrBenchmarkEntry;
+struct ovrBenchmarkResult;
+
+//==============================================================
+// ovrBenchmarkRunner
+class ovrBenchmarkRunner
+{
+public:
+	// Runs the registered benchmarks in name order and prints a line for each. Returns the
+	// number of benchmarks that failed or regressed against the baseline.
+	static int					Run( const ovrBenchmarkOptions & options );
+
+private:
+	static ovrBenchmarkState	RunOnce( const ovrBenchmarkEntry & entry, const long long iterations );
+	static void					RunBenchmark( const ovrBenchmarkEntry & entry, const ovrBenchmarkOptions & options, ovrBenchmarkResult & result );
+};
+
+//==============================================================
+// ovrBenchmarkRandom
+// Deterministic random numbers, so that every run benchmarks the same data.
+class ovrBenchmarkRandom
+{
+public:
+	explicit		ovrBenchmarkRandom( const unsigned int seed = 1 ) : State( seed != 0 ? seed : 1 ) {}
+
+	unsigned int	NextUInt()
+	{
+		// xorshift32
+		State ^= State << 13;
+		State ^= State >> 17;
+		State ^= State << 5;
+		return State;
+	}
+	// [0, 1)
+	float			NextFloat() { return ( NextUInt() >> 8 ) * ( 1.0f / 16777216.0f ); }
+	float			NextFloat( const float min, const float max ) { return min + ( max - min ) * NextFloat(); }
+
+private:
+	unsigned int	State;
+};
+
+// Keeps the compiler from removing a computation whose result is not used.
+template< typename _type_ >
+inline void DoNotOptimize( const _type_ & value )
+{
+	__asm__ volatile( "" : : "g"( &value ) : "memory" );
+}
+
+} // namespace OVR
+
+// Defines a benchmark function, named "group/name" in the results.
+#define OVR_BENCHMARK( group_, name_, kind_ ) \
+	static void Benchmark_##group_##_##name_( OVR::ovrBenchmarkState & state ); \
+	static OVR::ovrBenchmarkRegistrar Registrar_##group_##_##name_( #group_, #name_, kind_, Benchmark_##group_##_##name_, NULL, 0 ); \
+	static void Benchmark_##group_##_##name_( OVR::ovrBenchmarkState & state )
+
+// Defines a benchmark that is run once for each argument, named "group/name/arg" in the results.
+#define OVR_BENCHMARK_ARGS( group_, name_, kind_, ... ) \
+	static void Benchmark_##group_##_##name_( OVR::ovrBenchmarkState & state ); \
+	static const int Args_##group_##_##name_[] = { __VA_ARGS__ }; \
+	static OVR::ovrBenchmarkRegistrar Registrar_##group_##_##name_( #group_, #name_, kind_, Benchmark_##group_##_##name_, \
+			Args_##group_##_##name_, sizeof( Args_##group_##_##name_ ) / sizeof( Args_##group_##_##name_[0] ) ); \
+	static void Benchmark_##group_##_##name_( OVR::ovrBenchmarkState & state )
+
+#endif // OVR_HostBenchmark_h
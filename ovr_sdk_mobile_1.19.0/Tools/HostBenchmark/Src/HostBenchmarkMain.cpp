@@ -0,0 +1,106 @@
+/************************************************************************************
+
+Filename    :   HostBenchmarkMain.cpp
+Content     :   Command line of the host benchmark suite.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <android/log.h>
+
+#include "Kernel/OVR_System.h"
+#include "HostBenchmark.h"
+#include "HostShims.h"
+
+using namespace OVR;
+
+static void PrintUsage( const char * program )
+{
+	printf( "Usage: %s [options]\n", program );
+	printf( "  --filter <text>       run the benchmarks whose name contains text\n" );
+	printf( "  --list                list the benchmarks instead of running them\n" );
+	printf( "  --min-time <seconds>  minimum time of each repetition, default 0.1\n" );
+	printf( "  --repetitions <n>     default 5\n" );
+	printf( "  --out <path>          write the results as JSON\n" );
+	printf( "  --label <text>        recorded in the results, like a commit hash\n" );
+	printf( "  --baseline <path>     compare against results written with --out\n" );
+	printf( "  --max-slowdown <pct>  slowdown of the median that is a regression, default 10\n" );
+	printf( "  --verbose             print all log messages, not only warnings and errors\n" );
+	printf( "The exit status is 1 if a benchmark failed or regressed against the baseline.\n" );
+}
+
+int main( int argc, char * argv[] )
+{
+	ovrBenchmarkOptions options;
+	bool verbose = false;
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char * arg = argv[i];
+		const char * value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+		if ( strcmp( arg, "--list" ) == 0 )
+		{
+			options.ListOnly = true;
+			continue;
+		}
+		if ( strcmp( arg, "--verbose" ) == 0 )
+		{
+			verbose = true;
+			continue;
+		}
+		if ( strcmp( arg, "--help" ) == 0 || value == NULL )
+		{
+			PrintUsage( argv[0] );
+			return ( strcmp( arg, "--help" ) == 0 ) ? 0 : 1;
+		}
+		if ( strcmp( arg, "--filter" ) == 0 )
+		{
+			options.Filter = value;
+		}
+		else if ( strcmp( arg, "--min-time" ) == 0 )
+		{
+			options.MinSeconds = atof( value );
+		}
+		else if ( strcmp( arg, "--repetitions" ) == 0 )
+		{
+			options.Repetitions = atoi( value ) > 0 ? atoi( value ) : 1;
+		}
+		else if ( strcmp( arg, "--out" ) == 0 )
+		{
+			options.OutputPath = value;
+		}
+		else if ( strcmp( arg, "--label" ) == 0 )
+		{
+			options.Label = value;
+		}
+		else if ( strcmp( arg, "--baseline" ) == 0 )
+		{
+			options.BaselinePath = value;
+		}
+		else if ( strcmp( arg, "--max-slowdown" ) == 0 )
+		{
+			options.MaxSlowdown = atof( value ) * 0.01;
+		}
+		else
+		{
+			PrintUsage( argv[0] );
+			return 1;
+		}
+		i++;
+	}
+
+	ovrHostShims::SetLogPriority( verbose ? ANDROID_LOG_VERBOSE : ANDROID_LOG_WARN );
+	OVR::System::Init( OVR::Log::ConfigureDefaultLog( OVR::LogMask_All ) );
+	ovrHostShims::InitGl();
+
+	const int numFailed = ovrBenchmarkRunner::Run( options );
+
+	OVR::System::Destroy();
+
+	return ( numFailed > 0 ) ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+/************************************************************************************
+
+Filename    :   HostGui.cpp
+Content     :   Stands in for the App and the GUI system for menu tests on the host.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostGui.h"
+
+#include "Kernel/OVR_LogUtils.h"
+#include "App.h"
+#include "BitmapFont.h"
+#include "DebugLines.h"
+#include "GuiSys.h"
+#include "VRMenuMgr.h"
+
+// Calling an interface that the host does not provide is a bug in the benchmark.
+#define HOST_GUI_UNSUPPORTED() OVR_FAIL( "%s is not supported on the host", __FUNCTION__ )
+
+namespace OVR {
+
+// App.cpp is not part of the host build.
+App::~App()
+{
+}
+
+//==============================================================
+// ovrHostApp
+class ovrHostApp : public App
+{
+public:
+	virtual void				TtjCommand( JNIEnv & jni, const char * commandString ) { HOST_GUI_UNSUPPORTED(); }
+
+	virtual VrAppInterface *	GetAppInterface() { return NULL; }
+	virtual void				RecenterYaw( const bool showBlack ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void				SetRecenterYawFrameStart( const long long frameNumber ) { HOST_GUI_UNSUPPORTED(); }
+	virtual long long			GetRecenterYawFrameStart() const { return 0; }
+	virtual void				SendIntent( const char * actionName, const char * toPackageName,
+										const char * toClassName, const char * command, const char * uri ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void				SendLaunchIntent( const char * toPackageName, const char * command, const char * uri,
+										const char * action ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void				FinishActivity( const ovrAppFinishType type ) { HOST_GUI_UNSUPPORTED(); }
+	virtual bool				ShowSystemUI( const ovrSystemUIType type ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void				FatalError( const ovrAppFatalError error, const char * fileName, const unsigned int lineNumber,
+										const char * messageFormat, ... ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void				ShowDependencyError() { HOST_GUI_UNSUPPORTED(); }
+
+	virtual OvrDebugLines &		GetDebugLines() { HOST_GUI_UNSUPPORTED(); }
+	virtual const OvrStoragePaths &	GetStoragePaths() { HOST_GUI_UNSUPPORTED(); }
+
+	virtual int					GetSystemProperty( const ovrSystemProperty propType ) { return 0; }
+	virtual int					GetSystemStatus( const ovrSystemStatus statusType ) { return 0; }
+	virtual const VrDeviceStatus &	GetDeviceStatus() const { return DeviceStatus; }
+
+	virtual	const ovrEyeBufferParms &	GetEyeBufferParms() const { return EyeBufferParms; }
+	virtual void				SetEyeBufferParms( const ovrEyeBufferParms & parms ) { EyeBufferParms = parms; }
+	virtual int					GetSwapInterval() const { return 1; }
+	virtual void				SetSwapInterval( const int swapInterval ) { }
+	virtual bool				GetFramebufferIsSrgb() const { return false; }
+	virtual bool				GetFramebufferIsProtected() const { return false; }
+	virtual Matrix4f const &	GetLastViewMatrix() const { return LastViewMatrix; }
+	virtual void				SetLastViewMatrix( Matrix4f const & m ) { LastViewMatrix = m; }
+	virtual void				RecenterLastViewMatrix() { }
+
+	virtual ovrMobile *			GetOvrMobile() { return NULL; }
+	virtual ovrFileSys &		GetFileSys() { HOST_GUI_UNSUPPORTED(); }
+	virtual ovrReadService &	GetReadService() { HOST_GUI_UNSUPPORTED(); }
+	virtual	ovrTextureManager *	GetTextureManager() { return NULL; }
+	virtual	ovrTextureStreamer *	GetTextureStreamer() { return NULL; }
+
+	virtual const char *		GetPackageName() const { return "HostBenchmark"; }
+	virtual bool				GetInstalledPackagePath( char const * packageName,
+										char * outPackagePath, size_t const outMaxSize ) const { return false; }
+
+	virtual const ovrJava *		GetJava() const { return NULL; }
+	virtual jclass &			GetVrActivityClass() { HOST_GUI_UNSUPPORTED(); }
+
+	// there is no console on the host, the functions are called by CallConsoleFunction()
+	virtual void				RegisterConsoleFunction( char const * name, consoleFn_t function )
+	{
+		ovrConsoleFunction f = { name, function };
+		ConsoleFunctions.PushBack( f );
+	}
+
+	bool						CallConsoleFunction( char const * name, char const * parms )
+	{
+		for ( int i = 0; i < ConsoleFunctions.GetSizeI(); i++ )
+		{
+			if ( OVR_strcmp( ConsoleFunctions[i].Name, name ) == 0 )
+			{
+				ConsoleFunctions[i].Function( this, parms );
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	struct ovrConsoleFunction
+	{
+		char const *	Name;
+		consoleFn_t		Function;
+	};
+
+	Array< ovrConsoleFunction >	ConsoleFunctions;
+	VrDeviceStatus				DeviceStatus;
+	ovrEyeBufferParms			EyeBufferParms;
+	Matrix4f					LastViewMatrix;
+};
+
+//==============================================================
+// ovrHostFont
+// A font without glyphs.
+class ovrHostFont : public BitmapFont
+{
+public:
+	virtual bool		Load( ovrFileSys & fileSys, const char * uri ) { return false; }
+
+	virtual float		CalcTextWidth( char const * text ) const { return 0.0f; }
+	virtual void		CalcTextMetrics( char const * text, size_t & len, float & width, float & height,
+								float & ascent, float & descent, float & fontHeight, float * lineWidths,
+								int const maxLines, int & numLines ) const
+	{
+		len = OVR_strlen( text );
+		width = height = ascent = descent = fontHeight = 0.0f;
+		numLines = 0;
+	}
+	virtual void		TruncateText( String & inOutText, int const maxLines ) const { }
+	virtual bool		WordWrapText( String & inOutText, const float widthMeters, const float fontScale = 1.0f ) const { return false; }
+	virtual bool		WordWrapText( String & inOutText, const float widthMeters, OVR::Array< OVR::String > wholeStrsList,
+								const float fontScale = 1.0f ) const { return false; }
+	virtual float		GetLastFitChars( String & inOutText, const float widthMeters, const float fontScale = 1.0f ) const { return 0.0f; }
+	virtual float		GetFirstFitChars( String & inOutText, const float widthMeters, const int numLines,
+								const float fontScale = 1.0f ) const { return 0.0f; }
+	virtual ovrSurfaceDef	TextSurface( const char * text, float scale, const Vector4f & color, HorizontalJustification hjust,
+								VerticalJustification vjust, fontParms_t const * fp = nullptr ) const { return ovrSurfaceDef(); }
+	virtual Vector2f	GetScaleFactor() const { return Vector2f( 1.0f ); }
+	virtual void		GetGlyphMetrics( const uint32_t charCode, float & width, float & height,
+								float & advancex, float & advancey ) const
+	{
+		width = height = advancex = advancey = 0.0f;
+	}
+};
+
+//==============================================================
+// ovrHostGuiSys
+class ovrHostGuiSys : public OvrGuiSys
+{
+public:
+						ovrHostGuiSys();
+	virtual				~ovrHostGuiSys();
+
+	virtual void		Init( App * app, SoundEffectPlayer & soundEffectPlayer,
+								char const * fontName, OvrDebugLines * debugLines ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void		Init( App * app_, SoundEffectPlayer & soundEffectPlayer,
+								char const * fontName, BitmapFontSurface * fontSurface,
+								OvrDebugLines * debugLines ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void		Shutdown() { HOST_GUI_UNSUPPORTED(); }
+
+	virtual void		Frame( ovrFrameInput const & vrFrame, Matrix4f const & centerViewMatrix ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void		Frame( ovrFrameInput const & vrFrame, Matrix4f const & centerViewMatrix,
+								Matrix4f const & traceMat ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void		AppendSurfaceList( Matrix4f const & centerViewMatrix, Array< ovrDrawSurface > * surfaceList ) const
+	{
+		MenuMgr->AppendSurfaceList( centerViewMatrix, *surfaceList );
+	}
+	virtual bool		OnKeyEvent( int const keyCode, const int repeatCount, KeyEventType const eventType ) { return false; }
+	virtual void		ResetMenuOrientations( Matrix4f const & viewMatrix ) { }
+	virtual HitTestResult	TestRayIntersection( const Vector3f & start, const Vector3f & dir ) const { return HitTestResult(); }
+
+	virtual void		AddMenu( VRMenu * menu ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void		DestroyMenu( VRMenu * menu ) { HOST_GUI_UNSUPPORTED(); }
+	virtual VRMenu *	GetMenu( char const * menuName ) const { return NULL; }
+	virtual Array< String >	GetAllMenuNames() const { return Array< String >(); }
+	virtual void		OpenMenu( char const * name ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void		CloseMenu( const char * name, bool const closeInstantly ) { HOST_GUI_UNSUPPORTED(); }
+	virtual void		CloseMenu( VRMenu * menu, bool const closeInstantly ) { HOST_GUI_UNSUPPORTED(); }
+	virtual bool		IsMenuActive( char const * menuName ) const { return false; }
+	virtual bool		IsAnyMenuActive() const { return false; }
+	virtual bool		IsAnyMenuOpen() const { return false; }
+
+	virtual	void		ShowInfoText( float const duration, const char * fmt, ... ) { }
+	virtual	void		ShowInfoText( float const duration, Vector3f const & offset, Vector4f const & color, const char * fmt, ... ) { }
+
+	virtual App *					GetApp() const { return const_cast< ovrHostApp * >( &HostApp ); }
+	virtual OvrVRMenuMgr &			GetVRMenuMgr() { return *MenuMgr; }
+	virtual OvrVRMenuMgr const &	GetVRMenuMgr() const { return *MenuMgr; }
+	virtual OvrGazeCursor &			GetGazeCursor() { HOST_GUI_UNSUPPORTED(); }
+	virtual BitmapFont &			GetDefaultFont() { return Font; }
+	virtual BitmapFont const &		GetDefaultFont() const { return Font; }
+	virtual BitmapFontSurface &		GetDefaultFontSurface() { HOST_GUI_UNSUPPORTED(); }
+	virtual OvrDebugLines &			GetDebugLines() { return *DebugLines; }
+	virtual SoundEffectPlayer &		GetSoundEffectPlayer() { HOST_GUI_UNSUPPORTED(); }
+	virtual ovrTextureManager &		GetTextureManager() { HOST_GUI_UNSUPPORTED(); }
+	virtual ovrReflection &			GetReflection() { HOST_GUI_UNSUPPORTED(); }
+	virtual ovrReflection const &	GetReflection() const { HOST_GUI_UNSUPPORTED(); }
+
+private:
+	ovrHostApp			HostApp;
+	ovrHostFont			Font;
+	OvrDebugLines *		DebugLines;
+	OvrVRMenuMgr *		MenuMgr;
+
+	virtual void		MakeActive( VRMenu * menu ) { HOST_GUI_UNSUPPORTED(); }
+};
+
+//==============================
+// ovrHostGuiSys::ovrHostGuiSys
+ovrHostGuiSys::ovrHostGuiSys()
+	: DebugLines( OvrDebugLines::Create() )
+	, MenuMgr( NULL )
+{
+	DebugLines->Init();
+	MenuMgr = OvrVRMenuMgr::Create( *this );
+	MenuMgr->Init( *this );
+}
+
+//==============================
+// ovrHostGuiSys::~ovrHostGuiSys
+ovrHostGuiSys::~ovrHostGuiSys()
+{
+	MenuMgr->Shutdown();
+	OvrVRMenuMgr::Destroy( MenuMgr );
+	DebugLines->Shutdown();
+	OvrDebugLines::Free( DebugLines );
+}
+
+//==============================
+// ovrHostGui::Create
+OvrGuiSys * ovrHostGui::Create()
+{
+	return new ovrHostGuiSys();
+}
+
+//==============================
+// ovrHostGui::CallConsoleFunction
+bool ovrHostGui::CallConsoleFunction( OvrGuiSys & guiSys, const char * name, const char * parms )
+{
+	return static_cast< ovrHostApp * >( guiSys.GetApp() )->CallConsoleFunction( name, parms );
+}
+
+//==============================
+// ovrHostGui::Destroy
+void ovrHostGui::Destroy( OvrGuiSys * & guiSys )
+{
+	delete guiSys;
+	guiSys = NULL;
+}
+
+} // namespace OVR
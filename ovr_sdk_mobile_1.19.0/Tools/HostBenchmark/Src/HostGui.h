@@ -0,0 +1,39 @@
+/************************************************************************************
+
+Filename    :   HostGui.h
+Content     :   Stands in for the App and the GUI system for menu tests on the host.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_HostGui_h )
+#define OVR_HostGui_h
+
+namespace OVR {
+
+class OvrGuiSys;
+
+//==============================================================
+// ovrHostGui
+// The GUI system of VrGUI needs an App, which needs the whole framework. This one has a
+// real menu manager and debug lines, and is enough to create, submit and hit test menus
+// whose objects have no textures. The default font has no glyphs, so text has no size.
+// Console functions registered with the app, like the menu manager's debug switches, are
+// kept and can be called by name. Calling anything else, like the texture manager or the
+// gaze cursor, aborts.
+class ovrHostGui
+{
+public:
+	// Must be called after ovrHostShims::InitGl(), since the menu manager builds its programs.
+	static OvrGuiSys *	Create();
+	static void			Destroy( OvrGuiSys * & guiSys );
+	// Returns false if no console function with this name was registered.
+	static bool			CallConsoleFunction( OvrGuiSys & guiSys, const char * name, const char * parms );
+};
+
+} // namespace OVR
+
+#endif // OVR_HostGui_h
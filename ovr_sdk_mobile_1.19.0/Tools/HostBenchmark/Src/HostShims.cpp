@@ -0,0 +1,745 @@
+/************************************************************************************
+
+Filename    :   HostShims.cpp
+Content     :   Stands in for the Android log, EGL and GLES on the host.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostShims.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <android/log.h>
+
+#include "Kernel/OVR_Array.h"
+#include "Console.h"
+#include "OVR_GlUtils.h"
+#include "VrApi.h"
+#include "VrApi_Input.h"
+
+//==============================================================
+// Android log
+
+static int			LogPriority = ANDROID_LOG_WARN;
+
+extern "C" int __android_log_write( int prio, const char * tag, const char * text )
+{
+	if ( prio < LogPriority )
+	{
+		return 0;
+	}
+	static const char priorityChars[] = "??VDIWEFS";
+	const char priorityChar = ( prio >= 0 && prio <= ANDROID_LOG_SILENT ) ? priorityChars[prio] : '?';
+	return fprintf( stderr, "%c/%s: %s\n", priorityChar, tag != NULL ? tag : "", text );
+}
+
+extern "C" int __android_log_vprint( int prio, const char * tag, const char * fmt, va_list ap )
+{
+	if ( prio < LogPriority )
+	{
+		return 0;
+	}
+	char text[1024];
+	vsnprintf( text, sizeof( text ), fmt, ap );
+	return __android_log_write( prio, tag, text );
+}
+
+extern "C" int __android_log_print( int prio, const char * tag, const char * fmt, ... )
+{
+	va_list ap;
+	va_start( ap, fmt );
+	const int result = __android_log_vprint( prio, tag, fmt, ap );
+	va_end( ap );
+	return result;
+}
+
+extern "C" void __android_log_assert( const char * cond, const char * tag, const char * fmt, ... )
+{
+	char text[1024] = "";
+	if ( fmt != NULL )
+	{
+		va_list ap;
+		va_start( ap, fmt );
+		vsnprintf( text, sizeof( text ), fmt, ap );
+		va_end( ap );
+	}
+	fprintf( stderr, "F/%s: assertion failed: %s %s\n", tag != NULL ? tag : "", cond != NULL ? cond : "", text );
+	abort();
+}
+
+#if defined( OVR_HOST_NEEDS_STRLCPY )
+
+extern "C" size_t strlcpy( char * dst, const char * src, size_t size )
+{
+	const size_t length = strlen( src );
+	if ( size > 0 )
+	{
+		const size_t count = ( length < size - 1 ) ? length : size - 1;
+		memcpy( dst, src, count );
+		dst[count] = '\0';
+	}
+	return length;
+}
+
+extern "C" size_t strlcat( char * dst, const char * src, size_t size )
+{
+	const size_t length = strnlen( dst, size );
+	if ( length == size )
+	{
+		return length + strlen( src );
+	}
+	return length + strlcpy( dst + length, src, size - length );
+}
+
+#endif
+
+//==============================================================
+// EGL
+// The framework only asks for extension entry points and config attributes outside
+// of GlSetup, which the host build does not compile.
+
+extern "C" EGLint EGLAPIENTRY eglGetError( void )
+{
+	return EGL_SUCCESS;
+}
+
+extern "C" EGLDisplay EGLAPIENTRY eglGetCurrentDisplay( void )
+{
+	return EGL_NO_DISPLAY;
+}
+
+extern "C" EGLBoolean EGLAPIENTRY eglGetConfigs( EGLDisplay dpy, EGLConfig * configs, EGLint config_size, EGLint * num_config )
+{
+	if ( num_config != NULL )
+	{
+		*num_config = 0;
+	}
+	return EGL_FALSE;
+}
+
+extern "C" EGLBoolean EGLAPIENTRY eglGetConfigAttrib( EGLDisplay dpy, EGLConfig config, EGLint attribute, EGLint * value )
+{
+	return EGL_FALSE;
+}
+
+extern "C" __eglMustCastToProperFunctionPointerType EGLAPIENTRY eglGetProcAddress( const char * procname )
+{
+	return NULL;
+}
+
+//==============================================================
+// GLES3
+
+namespace OVR {
+
+static long long		NumGlCalls = 0;
+static GLuint			NextGlName = 1;
+static Array< uint8_t >	MappedBuffer;
+static int				ProgramBinaryVersion = 1;
+static GLuint			RejectedBinaryProgram = 0;
+
+// What glGetProgramBinary() returns, and glProgramBinary() accepts.
+struct ovrHostProgramBinary
+{
+	char		Magic[8];
+	int32_t		Version;
+	int32_t		Pad;
+};
+
+static const GLenum HOST_PROGRAM_BINARY_FORMAT = 1;
+
+// Returns a zero of the return type, which is GL_NO_ERROR, GL_FALSE and NULL.
+template< typename _return_type_, typename... _arg_types_ >
+static _return_type_ GL_APIENTRY StubNoOp( _arg_types_... )
+{
+	NumGlCalls++;
+	return _return_type_();
+}
+
+template< typename _return_type_, typename... _arg_types_ >
+static void SetStub( _return_type_ ( GL_APIENTRY * & function )( _arg_types_... ) )
+{
+	function = &StubNoOp< _return_type_, _arg_types_... >;
+}
+
+static void GL_APIENTRY StubGenNames( GLsizei n, GLuint * names )
+{
+	NumGlCalls++;
+	for ( GLsizei i = 0; i < n; i++ )
+	{
+		names[i] = NextGlName++;
+	}
+}
+
+static GLuint GL_APIENTRY StubCreateProgram()
+{
+	NumGlCalls++;
+	return NextGlName++;
+}
+
+static GLuint GL_APIENTRY StubCreateShader( GLenum type )
+{
+	NumGlCalls++;
+	return NextGlName++;
+}
+
+static GLenum GL_APIENTRY StubCheckFramebufferStatus( GLenum target )
+{
+	NumGlCalls++;
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static const GLubyte * GL_APIENTRY StubGetString( GLenum name )
+{
+	NumGlCalls++;
+	switch ( name )
+	{
+		case GL_VENDOR:		return (const GLubyte *)"Oculus";
+		case GL_RENDERER:	return (const GLubyte *)"Host stub";
+		case GL_VERSION:	return (const GLubyte *)"OpenGL ES 3.0 host stub";
+		case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte *)"OpenGL ES GLSL ES 3.00";
+		default:			return (const GLubyte *)"";
+	}
+}
+
+static void GL_APIENTRY StubGetIntegerv( GLenum pname, GLint * data )
+{
+	NumGlCalls++;
+	switch ( pname )
+	{
+		case GL_MAX_TEXTURE_SIZE:				data[0] = 16384; break;
+		case GL_MAX_VERTEX_UNIFORM_VECTORS:		data[0] = 1024; break;
+		case GL_MAX_FRAGMENT_UNIFORM_VECTORS:	data[0] = 1024; break;
+		case GL_MAX_UNIFORM_BLOCK_SIZE:			data[0] = 65536; break;
+		case GL_MAX_TEXTURE_IMAGE_UNITS:		data[0] = 16; break;
+		case GL_MAX_VERTEX_ATTRIBS:				data[0] = 16; break;
+		case GL_NUM_PROGRAM_BINARY_FORMATS:		data[0] = 1; break;
+		default:								data[0] = 0; break;
+	}
+}
+
+static void GL_APIENTRY StubGetInteger64v( GLenum pname, GLint64 * data )
+{
+	NumGlCalls++;
+	data[0] = 0;
+}
+
+static void GL_APIENTRY StubGetShaderiv( GLuint shader, GLenum pname, GLint * params )
+{
+	NumGlCalls++;
+	params[0] = ( pname == GL_COMPILE_STATUS ) ? GL_TRUE : 0;
+}
+
+static void GL_APIENTRY StubGetProgramiv( GLuint program, GLenum pname, GLint * params )
+{
+	NumGlCalls++;
+	switch ( pname )
+	{
+		case GL_LINK_STATUS:			params[0] = ( program != RejectedBinaryProgram ) ? GL_TRUE : GL_FALSE; break;
+		case GL_VALIDATE_STATUS:		params[0] = GL_TRUE; break;
+		case GL_PROGRAM_BINARY_LENGTH:	params[0] = sizeof( ovrHostProgramBinary ); break;
+		default:						params[0] = 0; break;
+	}
+}
+
+static void GL_APIENTRY StubGetProgramBinary( GLuint program, GLsizei bufSize, GLsizei * length, GLenum * binaryFormat, void * binary )
+{
+	NumGlCalls++;
+	if ( bufSize < (GLsizei)sizeof( ovrHostProgramBinary ) )
+	{
+		if ( length != NULL )
+		{
+			*length = 0;
+		}
+		return;
+	}
+	ovrHostProgramBinary b = { { 'H', 'O', 'S', 'T', 'P', 'R', 'O', 'G' }, ProgramBinaryVersion, 0 };
+	memcpy( binary, &b, sizeof( b ) );
+	if ( length != NULL )
+	{
+		*length = sizeof( b );
+	}
+	*binaryFormat = HOST_PROGRAM_BINARY_FORMAT;
+}
+
+static void GL_APIENTRY StubProgramBinary( GLuint program, GLenum binaryFormat, const void * binary, GLsizei length )
+{
+	NumGlCalls++;
+	ovrHostProgramBinary b = {};
+	if ( length == (GLsizei)sizeof( b ) )
+	{
+		memcpy( &b, binary, sizeof( b ) );
+	}
+	const bool valid = binaryFormat == HOST_PROGRAM_BINARY_FORMAT && memcmp( b.Magic, "HOSTPROG", 8 ) == 0 &&
+						b.Version == ProgramBinaryVersion;
+	if ( !valid )
+	{
+		RejectedBinaryProgram = program;
+	}
+}
+
+static void GL_APIENTRY StubGetInfoLog( GLuint object, GLsizei bufSize, GLsizei * length, GLchar * infoLog )
+{
+	NumGlCalls++;
+	if ( length != NULL )
+	{
+		*length = 0;
+	}
+	if ( bufSize > 0 && infoLog != NULL )
+	{
+		infoLog[0] = '\0';
+	}
+}
+
+static void GL_APIENTRY StubGetQueryiv( GLenum target, GLenum pname, GLint * params )
+{
+	NumGlCalls++;
+	params[0] = 0;
+}
+
+static void GL_APIENTRY StubGetQueryObjectuiv( GLuint id, GLenum pname, GLuint * params )
+{
+	NumGlCalls++;
+	params[0] = 0;
+}
+
+static void * GL_APIENTRY StubMapBufferRange( GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access )
+{
+	NumGlCalls++;
+	if ( MappedBuffer.GetSize() < (size_t)length )
+	{
+		MappedBuffer.Resize( length );
+	}
+	return MappedBuffer.GetDataPtr();
+}
+
+static GLboolean GL_APIENTRY StubUnmapBuffer( GLenum target )
+{
+	NumGlCalls++;
+	return GL_TRUE;
+}
+
+static GLsync GL_APIENTRY StubFenceSync( GLenum condition, GLbitfield flags )
+{
+	NumGlCalls++;
+	return (GLsync)(size_t)NextGlName++;
+}
+
+static GLenum GL_APIENTRY StubClientWaitSync( GLsync sync, GLbitfield flags, GLuint64 timeout )
+{
+	NumGlCalls++;
+	return GL_ALREADY_SIGNALED;
+}
+
+void ovrHostShims::SetLogPriority( const int priority )
+{
+	LogPriority = priority;
+}
+
+int ovrHostShims::GetLogPriority()
+{
+	return LogPriority;
+}
+
+void ovrHostShims::InitGl()
+{
+	SetStub( GLES3::glActiveTexture );
+	SetStub( GLES3::glAttachShader );
+	SetStub( GLES3::glBindAttribLocation );
+	SetStub( GLES3::glBindBuffer );
+	SetStub( GLES3::glBindFramebuffer );
+	SetStub( GLES3::glBindRenderbuffer );
+	SetStub( GLES3::glBindTexture );
+	SetStub( GLES3::glBlendColor );
+	SetStub( GLES3::glBlendEquation );
+	SetStub( GLES3::glBlendEquationSeparate );
+	SetStub( GLES3::glBlendFunc );
+	SetStub( GLES3::glBlendFuncSeparate );
+	SetStub( GLES3::glBufferData );
+	SetStub( GLES3::glBufferSubData );
+	SetStub( GLES3::glCheckFramebufferStatus );
+	SetStub( GLES3::glClear );
+	SetStub( GLES3::glClearColor );
+	SetStub( GLES3::glClearDepthf );
+	SetStub( GLES3::glClearStencil );
+	SetStub( GLES3::glColorMask );
+	SetStub( GLES3::glCompileShader );
+	SetStub( GLES3::glCompressedTexImage2D );
+	SetStub( GLES3::glCompressedTexSubImage2D );
+	SetStub( GLES3::glCopyTexImage2D );
+	SetStub( GLES3::glCopyTexSubImage2D );
+	SetStub( GLES3::glCreateProgram );
+	SetStub( GLES3::glCreateShader );
+	SetStub( GLES3::glCullFace );
+	SetStub( GLES3::glDeleteBuffers );
+	SetStub( GLES3::glDeleteFramebuffers );
+	SetStub( GLES3::glDeleteProgram );
+	SetStub( GLES3::glDeleteRenderbuffers );
+	SetStub( GLES3::glDeleteShader );
+	SetStub( GLES3::glDeleteTextures );
+	SetStub( GLES3::glDepthFunc );
+	SetStub( GLES3::glDepthMask );
+	SetStub( GLES3::glDepthRangef );
+	SetStub( GLES3::glDetachShader );
+	SetStub( GLES3::glDisable );
+	SetStub( GLES3::glDisableVertexAttribArray );
+	SetStub( GLES3::glDrawArrays );
+	SetStub( GLES3::glDrawElements );
+	SetStub( GLES3::glEnable );
+	SetStub( GLES3::glEnableVertexAttribArray );
+	SetStub( GLES3::glFinish );
+	SetStub( GLES3::glFlush );
+	SetStub( GLES3::glFramebufferRenderbuffer );
+	SetStub( GLES3::glFramebufferTexture2D );
+	SetStub( GLES3::glFrontFace );
+	SetStub( GLES3::glGenBuffers );
+	SetStub( GLES3::glGenerateMipmap );
+	SetStub( GLES3::glGenFramebuffers );
+	SetStub( GLES3::glGenRenderbuffers );
+	SetStub( GLES3::glGenTextures );
+	SetStub( GLES3::glGetActiveAttrib );
+	SetStub( GLES3::glGetActiveUniform );
+	SetStub( GLES3::glGetAttachedShaders );
+	SetStub( GLES3::glGetAttribLocation );
+	SetStub( GLES3::glGetBooleanv );
+	SetStub( GLES3::glGetBufferParameteriv );
+	SetStub( GLES3::glGetError );
+	SetStub( GLES3::glGetFloatv );
+	SetStub( GLES3::glGetFramebufferAttachmentParameteriv );
+	SetStub( GLES3::glGetIntegerv );
+	SetStub( GLES3::glGetProgramiv );
+	SetStub( GLES3::glGetProgramInfoLog );
+	SetStub( GLES3::glGetRenderbufferParameteriv );
+	SetStub( GLES3::glGetShaderiv );
+	SetStub( GLES3::glGetShaderInfoLog );
+	SetStub( GLES3::glGetShaderPrecisionFormat );
+	SetStub( GLES3::glGetShaderSource );
+	SetStub( GLES3::glGetString );
+	SetStub( GLES3::glGetTexParameterfv );
+	SetStub( GLES3::glGetTexParameteriv );
+	SetStub( GLES3::glGetUniformfv );
+	SetStub( GLES3::glGetUniformiv );
+	SetStub( GLES3::glGetUniformLocation );
+	SetStub( GLES3::glGetVertexAttribfv );
+	SetStub( GLES3::glGetVertexAttribiv );
+	SetStub( GLES3::glGetVertexAttribPointerv );
+	SetStub( GLES3::glHint );
+	SetStub( GLES3::glIsBuffer );
+	SetStub( GLES3::glIsEnabled );
+	SetStub( GLES3::glIsFramebuffer );
+	SetStub( GLES3::glIsProgram );
+	SetStub( GLES3::glIsRenderbuffer );
+	SetStub( GLES3::glIsShader );
+	SetStub( GLES3::glIsTexture );
+	SetStub( GLES3::glLineWidth );
+	SetStub( GLES3::glLinkProgram );
+	SetStub( GLES3::glPixelStorei );
+	SetStub( GLES3::glPolygonOffset );
+	SetStub( GLES3::glReadPixels );
+	SetStub( GLES3::glReleaseShaderCompiler );
+	SetStub( GLES3::glRenderbufferStorage );
+	SetStub( GLES3::glSampleCoverage );
+	SetStub( GLES3::glScissor );
+	SetStub( GLES3::glShaderBinary );
+	SetStub( GLES3::glShaderSource );
+	SetStub( GLES3::glStencilFunc );
+	SetStub( GLES3::glStencilFuncSeparate );
+	SetStub( GLES3::glStencilMask );
+	SetStub( GLES3::glStencilMaskSeparate );
+	SetStub( GLES3::glStencilOp );
+	SetStub( GLES3::glStencilOpSeparate );
+	SetStub( GLES3::glTexImage2D );
+	SetStub( GLES3::glTexParameterf );
+	SetStub( GLES3::glTexParameterfv );
+	SetStub( GLES3::glTexParameteri );
+	SetStub( GLES3::glTexParameteriv );
+	SetStub( GLES3::glTexSubImage2D );
+	SetStub( GLES3::glUniform1f );
+	SetStub( GLES3::glUniform1fv );
+	SetStub( GLES3::glUniform1i );
+	SetStub( GLES3::glUniform1iv );
+	SetStub( GLES3::glUniform2f );
+	SetStub( GLES3::glUniform2fv );
+	SetStub( GLES3::glUniform2i );
+	SetStub( GLES3::glUniform2iv );
+	SetStub( GLES3::glUniform3f );
+	SetStub( GLES3::glUniform3fv );
+	SetStub( GLES3::glUniform3i );
+	SetStub( GLES3::glUniform3iv );
+	SetStub( GLES3::glUniform4f );
+	SetStub( GLES3::glUniform4fv );
+	SetStub( GLES3::glUniform4i );
+	SetStub( GLES3::glUniform4iv );
+	SetStub( GLES3::glUniformMatrix2fv );
+	SetStub( GLES3::glUniformMatrix3fv );
+	SetStub( GLES3::glUniformMatrix4fv );
+	SetStub( GLES3::glUseProgram );
+	SetStub( GLES3::glValidateProgram );
+	SetStub( GLES3::glVertexAttrib1f );
+	SetStub( GLES3::glVertexAttrib1fv );
+	SetStub( GLES3::glVertexAttrib2f );
+	SetStub( GLES3::glVertexAttrib2fv );
+	SetStub( GLES3::glVertexAttrib3f );
+	SetStub( GLES3::glVertexAttrib3fv );
+	SetStub( GLES3::glVertexAttrib4f );
+	SetStub( GLES3::glVertexAttrib4fv );
+	SetStub( GLES3::glVertexAttribPointer );
+	SetStub( GLES3::glViewport );
+	SetStub( GLES3::glReadBuffer );
+	SetStub( GLES3::glDrawRangeElements );
+	SetStub( GLES3::glTexImage3D );
+	SetStub( GLES3::glTexSubImage3D );
+	SetStub( GLES3::glCopyTexSubImage3D );
+	SetStub( GLES3::glCompressedTexImage3D );
+	SetStub( GLES3::glCompressedTexSubImage3D );
+	SetStub( GLES3::glGenQueries );
+	SetStub( GLES3::glDeleteQueries );
+	SetStub( GLES3::glIsQuery );
+	SetStub( GLES3::glBeginQuery );
+	SetStub( GLES3::glEndQuery );
+	SetStub( GLES3::glGetQueryiv );
+	SetStub( GLES3::glGetQueryObjectuiv );
+	SetStub( GLES3::glUnmapBuffer );
+	SetStub( GLES3::glGetBufferPointerv );
+	SetStub( GLES3::glDrawBuffers );
+	SetStub( GLES3::glUniformMatrix2x3fv );
+	SetStub( GLES3::glUniformMatrix3x2fv );
+	SetStub( GLES3::glUniformMatrix2x4fv );
+	SetStub( GLES3::glUniformMatrix4x2fv );
+	SetStub( GLES3::glUniformMatrix3x4fv );
+	SetStub( GLES3::glUniformMatrix4x3fv );
+	SetStub( GLES3::glBlitFramebuffer );
+	SetStub( GLES3::glRenderbufferStorageMultisample );
+	SetStub( GLES3::glFramebufferTextureLayer );
+	SetStub( GLES3::glMapBufferRange );
+	SetStub( GLES3::glFlushMappedBufferRange );
+	SetStub( GLES3::glBindVertexArray );
+	SetStub( GLES3::glDeleteVertexArrays );
+	SetStub( GLES3::glGenVertexArrays );
+	SetStub( GLES3::glIsVertexArray );
+	SetStub( GLES3::glGetIntegeri_v );
+	SetStub( GLES3::glBeginTransformFeedback );
+	SetStub( GLES3::glEndTransformFeedback );
+	SetStub( GLES3::glBindBufferRange );
+	SetStub( GLES3::glBindBufferBase );
+	SetStub( GLES3::glTransformFeedbackVaryings );
+	SetStub( GLES3::glGetTransformFeedbackVarying );
+	SetStub( GLES3::glVertexAttribIPointer );
+	SetStub( GLES3::glGetVertexAttribIiv );
+	SetStub( GLES3::glGetVertexAttribIuiv );
+	SetStub( GLES3::glVertexAttribI4i );
+	SetStub( GLES3::glVertexAttribI4ui );
+	SetStub( GLES3::glVertexAttribI4iv );
+	SetStub( GLES3::glVertexAttribI4uiv );
+	SetStub( GLES3::glGetUniformuiv );
+	SetStub( GLES3::glGetFragDataLocation );
+	SetStub( GLES3::glUniform1ui );
+	SetStub( GLES3::glUniform2ui );
+	SetStub( GLES3::glUniform3ui );
+	SetStub( GLES3::glUniform4ui );
+	SetStub( GLES3::glUniform1uiv );
+	SetStub( GLES3::glUniform2uiv );
+	SetStub( GLES3::glUniform3uiv );
+	SetStub( GLES3::glUniform4uiv );
+	SetStub( GLES3::glClearBufferiv );
+	SetStub( GLES3::glClearBufferuiv );
+	SetStub( GLES3::glClearBufferfv );
+	SetStub( GLES3::glClearBufferfi );
+	SetStub( GLES3::glGetStringi );
+	SetStub( GLES3::glCopyBufferSubData );
+	SetStub( GLES3::glGetUniformIndices );
+	SetStub( GLES3::glGetActiveUniformsiv );
+	SetStub( GLES3::glGetUniformBlockIndex );
+	SetStub( GLES3::glGetActiveUniformBlockiv );
+	SetStub( GLES3::glGetActiveUniformBlockName );
+	SetStub( GLES3::glUniformBlockBinding );
+	SetStub( GLES3::glDrawArraysInstanced );
+	SetStub( GLES3::glDrawElementsInstanced );
+	SetStub( GLES3::glFenceSync );
+	SetStub( GLES3::glIsSync );
+	SetStub( GLES3::glDeleteSync );
+	SetStub( GLES3::glClientWaitSync );
+	SetStub( GLES3::glWaitSync );
+	SetStub( GLES3::glGetInteger64v );
+	SetStub( GLES3::glGetSynciv );
+	SetStub( GLES3::glGetInteger64i_v );
+	SetStub( GLES3::glGetBufferParameteri64v );
+	SetStub( GLES3::glGenSamplers );
+	SetStub( GLES3::glDeleteSamplers );
+	SetStub( GLES3::glIsSampler );
+	SetStub( GLES3::glBindSampler );
+	SetStub( GLES3::glSamplerParameteri );
+	SetStub( GLES3::glSamplerParameteriv );
+	SetStub( GLES3::glSamplerParameterf );
+	SetStub( GLES3::glSamplerParameterfv );
+	SetStub( GLES3::glGetSamplerParameteriv );
+	SetStub( GLES3::glGetSamplerParameterfv );
+	SetStub( GLES3::glVertexAttribDivisor );
+	SetStub( GLES3::glBindTransformFeedback );
+	SetStub( GLES3::glDeleteTransformFeedbacks );
+	SetStub( GLES3::glGenTransformFeedbacks );
+	SetStub( GLES3::glIsTransformFeedback );
+	SetStub( GLES3::glPauseTransformFeedback );
+	SetStub( GLES3::glResumeTransformFeedback );
+	SetStub( GLES3::glGetProgramBinary );
+	SetStub( GLES3::glProgramBinary );
+	SetStub( GLES3::glProgramParameteri );
+	SetStub( GLES3::glInvalidateFramebuffer );
+	SetStub( GLES3::glInvalidateSubFramebuffer );
+	SetStub( GLES3::glTexStorage2D );
+	SetStub( GLES3::glTexStorage3D );
+	SetStub( GLES3::glGetInternalformativ );
+
+	GLES3::glGenBuffers = StubGenNames;
+	GLES3::glGenFramebuffers = StubGenNames;
+	GLES3::glGenQueries = StubGenNames;
+	GLES3::glGenRenderbuffers = StubGenNames;
+	GLES3::glGenSamplers = StubGenNames;
+	GLES3::glGenTextures = StubGenNames;
+	GLES3::glGenTransformFeedbacks = StubGenNames;
+	GLES3::glGenVertexArrays = StubGenNames;
+	GLES3::glCreateProgram = StubCreateProgram;
+	GLES3::glCreateShader = StubCreateShader;
+	GLES3::glCheckFramebufferStatus = StubCheckFramebufferStatus;
+	GLES3::glGetString = StubGetString;
+	GLES3::glGetIntegerv = StubGetIntegerv;
+	GLES3::glGetInteger64v = StubGetInteger64v;
+	GLES3::glGetShaderiv = StubGetShaderiv;
+	GLES3::glGetProgramiv = StubGetProgramiv;
+	GLES3::glGetShaderInfoLog = StubGetInfoLog;
+	GLES3::glGetProgramInfoLog = StubGetInfoLog;
+	GLES3::glGetQueryiv = StubGetQueryiv;
+	GLES3::glGetQueryObjectuiv = StubGetQueryObjectuiv;
+	GLES3::glMapBufferRange = StubMapBufferRange;
+	GLES3::glUnmapBuffer = StubUnmapBuffer;
+	GLES3::glFenceSync = StubFenceSync;
+	GLES3::glClientWaitSync = StubClientWaitSync;
+	GLES3::glGetProgramBinary = StubGetProgramBinary;
+	GLES3::glProgramBinary = StubProgramBinary;
+
+	NumGlCalls = 0;
+}
+
+long long ovrHostShims::GetNumGlCalls()
+{
+	return NumGlCalls;
+}
+
+void ovrHostShims::SetProgramBinaryVersion( const int version )
+{
+	ProgramBinaryVersion = version;
+}
+
+} // namespace OVR
+
+//==============================================================
+// VrApi
+// Only what VrFrameBuilder uses, with a headset whose touchpad is set by the caller.
+
+static double					HostTimeInSeconds = 0.0;
+static ovrInputStateHeadset		HostHeadsetState;
+static const ovrDeviceID		HOST_HEADSET_DEVICE_ID = 0;	// VrFrameBuilder reads input states by device index
+
+extern "C" double vrapi_GetTimeInSeconds()
+{
+	return HostTimeInSeconds;
+}
+
+extern "C" int vrapi_GetSystemStatusInt( const ovrJava * java, const ovrSystemStatus statusType )
+{
+	return 0;
+}
+
+extern "C" double vrapi_GetPredictedDisplayTime( ovrMobile * ovr, long long frameIndex )
+{
+	return HostTimeInSeconds;
+}
+
+extern "C" ovrTracking2 vrapi_GetPredictedTracking2( ovrMobile * ovr, double absTimeInSeconds )
+{
+	ovrTracking2 tracking;
+	memset( &tracking, 0, sizeof( tracking ) );
+	tracking.HeadPose.Pose.Orientation.w = 1.0f;
+	return tracking;
+}
+
+extern "C" ovrPosef vrapi_GetTrackingTransform( ovrMobile * ovr, ovrTrackingTransform whichTransform )
+{
+	ovrPosef pose;
+	memset( &pose, 0, sizeof( pose ) );
+	pose.Orientation.w = 1.0f;
+	return pose;
+}
+
+extern "C" ovrResult vrapi_EnumerateInputDevices( ovrMobile * ovr, const uint32_t index, ovrInputCapabilityHeader * capsHeader )
+{
+	if ( index != 0 )
+	{
+		return ovrError_NoDevice;
+	}
+	capsHeader->Type = ovrControllerType_Headset;
+	capsHeader->DeviceID = HOST_HEADSET_DEVICE_ID;
+	return ovrSuccess;
+}
+
+extern "C" ovrResult vrapi_GetInputDeviceCapabilities( ovrMobile * ovr, ovrInputCapabilityHeader * capsHeader )
+{
+	if ( capsHeader->Type != ovrControllerType_Headset || capsHeader->DeviceID != HOST_HEADSET_DEVICE_ID )
+	{
+		return ovrError_NoDevice;
+	}
+	ovrInputHeadsetCapabilities * caps = reinterpret_cast< ovrInputHeadsetCapabilities * >( capsHeader );
+	caps->ControllerCapabilities = 0;
+	caps->ButtonCapabilities = ovrButton_Back;
+	caps->TrackpadMaxX = 299;
+	caps->TrackpadMaxY = 199;
+	caps->TrackpadSizeX = 30.0f;
+	caps->TrackpadSizeY = 20.0f;
+	return ovrSuccess;
+}
+
+extern "C" ovrResult vrapi_GetCurrentInputState( ovrMobile * ovr, const ovrDeviceID deviceID, ovrInputStateHeader * inputState )
+{
+	if ( deviceID != HOST_HEADSET_DEVICE_ID || inputState->ControllerType != ovrControllerType_Headset )
+	{
+		return ovrError_NoDevice;
+	}
+	*reinterpret_cast< ovrInputStateHeadset * >( inputState ) = HostHeadsetState;
+	return ovrSuccess;
+}
+
+namespace OVR {
+
+void ovrHostShims::SetTimeInSeconds( const double timeInSeconds )
+{
+	HostTimeInSeconds = timeInSeconds;
+}
+
+void ovrHostShims::SetHeadsetTrackpad( const bool touched, const float x, const float y, const double timeInSeconds )
+{
+	HostHeadsetState.Header.ControllerType = ovrControllerType_Headset;
+	HostHeadsetState.Header.TimeInSeconds = timeInSeconds;
+	HostHeadsetState.Buttons = 0;
+	HostHeadsetState.TrackpadStatus = touched ? 1 : 0;
+	HostHeadsetState.TrackpadPosition.x = x;
+	HostHeadsetState.TrackpadPosition.y = y;
+}
+
+} // namespace OVR
+
+//==============================================================
+// Console
+// Console.cpp receives its commands through JNI and is not part of the host build.
+
+namespace OVR {
+
+void RegisterConsoleFunction( const char * name, consoleFn_t function )
+{
+}
+
+} // namespace OVR
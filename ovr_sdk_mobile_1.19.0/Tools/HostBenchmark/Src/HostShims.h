@@ -0,0 +1,51 @@
+/************************************************************************************
+
+Filename    :   HostShims.h
+Content     :   Stands in for the Android log, EGL and GLES on the host.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_HostShims_h )
+#define OVR_HostShims_h
+
+namespace OVR {
+
+//==============================================================
+// ovrHostShims
+// The host build compiles the framework as for Android, against the headers in Host/.
+// Log messages go to stderr. The GLES3 entry points of the OpenGL loader are pointed at
+// stubs that do no rendering: objects get unique names, shaders compile and programs
+// link, mapped buffers are scratch memory, and queries return 0. Program binaries are
+// a tag that glProgramBinary() accepts while the binary version is unchanged. There are
+// no GL extensions and eglGetProcAddress() returns NULL. Only one thread may use GL.
+// The VrApi time is set by the caller, and there is one input device, a headset with a
+// touchpad, whose state is also set by the caller. There is no console, so functions
+// registered with it are never called.
+class ovrHostShims
+{
+public:
+	// Messages with a lower priority are dropped. Defaults to ANDROID_LOG_WARN.
+	static void		SetLogPriority( const int priority );
+	static int		GetLogPriority();
+
+	// Must be called before any GL call.
+	static void		InitGl();
+	// GL calls made since InitGl().
+	static long long	GetNumGlCalls();
+	// Changes the version of the program binaries, so that the driver refuses the earlier
+	// ones, like after an update. Starts at 1.
+	static void		SetProgramBinaryVersion( const int version );
+
+	// Sets what vrapi_GetTimeInSeconds() and vrapi_GetPredictedDisplayTime() return.
+	static void		SetTimeInSeconds( const double timeInSeconds );
+	// Sets the headset touchpad state, as sampled at timeInSeconds.
+	static void		SetHeadsetTrackpad( const bool touched, const float x, const float y, const double timeInSeconds );
+};
+
+} // namespace OVR
+
+#endif // OVR_HostShims_h
@@ -0,0 +1,220 @@
+/************************************************************************************
+
+Filename    :   HostTurboJpeg.cpp
+Content     :   Stands in for the TurboJPEG API of the samples with the libjpeg API of
+				the host libjpeg-turbo.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jpeglib.h>
+
+#include "turbojpeg.h"
+
+// Only what OVR_TurboJpeg.cpp uses, RGBX pixels and 4:4:4 compression.
+
+struct ovrHostTurboJpeg
+{
+	jpeg_error_mgr			Error;
+	jmp_buf					Jump;
+	bool					Decompress;
+	jpeg_decompress_struct	DInfo;
+	jpeg_compress_struct	CInfo;
+};
+
+static char ErrorString[JMSG_LENGTH_MAX] = "No error";
+
+static void ErrorExit( j_common_ptr cinfo )
+{
+	ovrHostTurboJpeg * tj = reinterpret_cast< ovrHostTurboJpeg * >( cinfo->err );
+	( *cinfo->err->format_message )( cinfo, ErrorString );
+	longjmp( tj->Jump, 1 );
+}
+
+static void OutputMessage( j_common_ptr )
+{
+}
+
+static ovrHostTurboJpeg * CreateHandle( const bool decompress )
+{
+	ovrHostTurboJpeg * tj = new ovrHostTurboJpeg();
+	tj->Decompress = decompress;
+	jpeg_std_error( &tj->Error );
+	tj->Error.error_exit = ErrorExit;
+	tj->Error.output_message = OutputMessage;
+	if ( decompress )
+	{
+		tj->DInfo.err = &tj->Error;
+		jpeg_create_decompress( &tj->DInfo );
+	}
+	else
+	{
+		tj->CInfo.err = &tj->Error;
+		jpeg_create_compress( &tj->CInfo );
+	}
+	return tj;
+}
+
+DLLEXPORT tjhandle DLLCALL tjInitCompress( void )
+{
+	return CreateHandle( false );
+}
+
+DLLEXPORT tjhandle DLLCALL tjInitDecompress( void )
+{
+	return CreateHandle( true );
+}
+
+DLLEXPORT int DLLCALL tjDestroy( tjhandle handle )
+{
+	ovrHostTurboJpeg * tj = static_cast< ovrHostTurboJpeg * >( handle );
+	if ( tj->Decompress )
+	{
+		jpeg_destroy_decompress( &tj->DInfo );
+	}
+	else
+	{
+		jpeg_destroy_compress( &tj->CInfo );
+	}
+	delete tj;
+	return 0;
+}
+
+DLLEXPORT char * DLLCALL tjGetErrorStr( void )
+{
+	return ErrorString;
+}
+
+DLLEXPORT void DLLCALL tjFree( unsigned char * buffer )
+{
+	free( buffer );
+}
+
+DLLEXPORT tjscalingfactor * DLLCALL tjGetScalingFactors( int * numscalingfactors )
+{
+	// the same factors as libjpeg-turbo, largest first
+	static tjscalingfactor factors[16];
+	for ( int i = 0; i < 16; i++ )
+	{
+		factors[i].num = 16 - i;
+		factors[i].denom = 8;
+		while ( ( factors[i].num & 1 ) == 0 && ( factors[i].denom & 1 ) == 0 )
+		{
+			factors[i].num >>= 1;
+			factors[i].denom >>= 1;
+		}
+	}
+	*numscalingfactors = 16;
+	return factors;
+}
+
+DLLEXPORT int DLLCALL tjDecompressHeader3( tjhandle handle, unsigned char * jpegBuf, unsigned long jpegSize,
+		int * width, int * height, int * jpegSubsamp, int * jpegColorspace )
+{
+	ovrHostTurboJpeg * tj = static_cast< ovrHostTurboJpeg * >( handle );
+	if ( setjmp( tj->Jump ) )
+	{
+		jpeg_abort_decompress( &tj->DInfo );
+		return -1;
+	}
+	jpeg_mem_src( &tj->DInfo, jpegBuf, jpegSize );
+	jpeg_read_header( &tj->DInfo, TRUE );
+	*width = tj->DInfo.image_width;
+	*height = tj->DInfo.image_height;
+	*jpegSubsamp = TJSAMP_444;
+	*jpegColorspace = TJCS_YCbCr;
+	jpeg_abort_decompress( &tj->DInfo );
+	return 0;
+}
+
+DLLEXPORT int DLLCALL tjDecompress2( tjhandle handle, unsigned char * jpegBuf, unsigned long jpegSize,
+		unsigned char * dstBuf, int width, int pitch, int height, int pixelFormat, int flags )
+{
+	ovrHostTurboJpeg * tj = static_cast< ovrHostTurboJpeg * >( handle );
+	if ( pixelFormat != TJPF_RGBX )
+	{
+		strcpy( ErrorString, "tjDecompress2: only TJPF_RGBX is supported" );
+		return -1;
+	}
+	const int rowPitch = pitch;
+	if ( setjmp( tj->Jump ) )
+	{
+		jpeg_abort_decompress( &tj->DInfo );
+		return -1;
+	}
+	jpeg_mem_src( &tj->DInfo, jpegBuf, jpegSize );
+	jpeg_read_header( &tj->DInfo, TRUE );
+
+	// the largest scaling factor that fits in width x height
+	int numFactors = 0;
+	const tjscalingfactor * factors = tjGetScalingFactors( &numFactors );
+	tjscalingfactor sf = factors[numFactors - 1];
+	for ( int i = 0; i < numFactors; i++ )
+	{
+		if ( ( width == 0 || (int)TJSCALED( (int)tj->DInfo.image_width, factors[i] ) <= width ) &&
+				( height == 0 || (int)TJSCALED( (int)tj->DInfo.image_height, factors[i] ) <= height ) )
+		{
+			sf = factors[i];
+			break;
+		}
+	}
+	tj->DInfo.scale_num = sf.num;
+	tj->DInfo.scale_denom = sf.denom;
+	tj->DInfo.out_color_space = JCS_EXT_RGBX;
+	jpeg_start_decompress( &tj->DInfo );
+	const size_t stride = ( rowPitch != 0 ) ? rowPitch : tj->DInfo.output_width * 4;
+	while ( tj->DInfo.output_scanline < tj->DInfo.output_height )
+	{
+		JSAMPROW row = dstBuf + tj->DInfo.output_scanline * stride;
+		jpeg_read_scanlines( &tj->DInfo, &row, 1 );
+	}
+	jpeg_finish_decompress( &tj->DInfo );
+	return 0;
+}
+
+DLLEXPORT int DLLCALL tjCompress2( tjhandle handle, unsigned char * srcBuf, int width, int pitch, int height,
+		int pixelFormat, unsigned char ** jpegBuf, unsigned long * jpegSize, int jpegSubsamp, int jpegQual, int flags )
+{
+	ovrHostTurboJpeg * tj = static_cast< ovrHostTurboJpeg * >( handle );
+	if ( pixelFormat != TJPF_RGBX || jpegSubsamp != TJSAMP_444 )
+	{
+		strcpy( ErrorString, "tjCompress2: only TJPF_RGBX and TJSAMP_444 are supported" );
+		return -1;
+	}
+	const size_t stride = ( pitch != 0 ) ? pitch : width * 4;
+	if ( setjmp( tj->Jump ) )
+	{
+		jpeg_abort_compress( &tj->CInfo );
+		return -1;
+	}
+	*jpegBuf = NULL;
+	*jpegSize = 0;
+	jpeg_mem_dest( &tj->CInfo, jpegBuf, jpegSize );
+	tj->CInfo.image_width = width;
+	tj->CInfo.image_height = height;
+	tj->CInfo.input_components = 4;
+	tj->CInfo.in_color_space = JCS_EXT_RGBX;
+	jpeg_set_defaults( &tj->CInfo );
+	jpeg_set_quality( &tj->CInfo, jpegQual, TRUE );
+	for ( int i = 0; i < tj->CInfo.num_components; i++ )
+	{
+		tj->CInfo.comp_info[i].h_samp_factor = 1;
+		tj->CInfo.comp_info[i].v_samp_factor = 1;
+	}
+	jpeg_start_compress( &tj->CInfo, TRUE );
+	while ( tj->CInfo.next_scanline < tj->CInfo.image_height )
+	{
+		JSAMPROW row = srcBuf + tj->CInfo.next_scanline * stride;
+		jpeg_write_scanlines( &tj->CInfo, &row, 1 );
+	}
+	jpeg_finish_compress( &tj->CInfo );
+	return 0;
+}
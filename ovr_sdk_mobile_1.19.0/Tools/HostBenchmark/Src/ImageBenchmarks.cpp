@@ -0,0 +1,612 @@
+/************************************************************************************
+
+Filename    :   ImageBenchmarks.cpp
+Content     :   Benchmarks of image scaling, image decoding and package reads.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_MappedFile.h"
+#include "Kernel/OVR_MemBuffer.h"
+#include "Kernel/OVR_String.h"
+#include "ImageData.h"
+#include "OVR_TurboJpeg.h"
+#include "PackageFiles.h"
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include "ThumbnailCache.h"
+#include "turbojpeg.h"
+#include "unzip.h"
+#include "zip.h"
+
+using namespace OVR;
+
+// An RGBA image with smooth gradients and some noise, so that it compresses like a photo.
+static void MakeImage( Array< uint8_t > & image, const int width, const int height )
+{
+	ovrBenchmarkRandom random;
+	image.Resize( width * height * 4 );
+	for ( int y = 0; y < height; y++ )
+	{
+		for ( int x = 0; x < width; x++ )
+		{
+			uint8_t * p = &image[( y * width + x ) * 4];
+			const int noise = random.NextUInt() & 15;
+			p[0] = (uint8_t)( ( x * 255 / width + noise ) & 255 );
+			p[1] = (uint8_t)( ( y * 255 / height + noise ) & 255 );
+			p[2] = (uint8_t)( ( ( x + y ) * 127 / ( width + height ) + noise ) & 255 );
+			p[3] = 255;
+		}
+	}
+}
+
+OVR_BENCHMARK_ARGS( Image, QuarterImageSize, BENCHMARK_MICRO, 512, 2048 )
+{
+	Array< uint8_t > image;
+	MakeImage( image, state.GetArg(), state.GetArg() );
+	while ( state.KeepRunning() )
+	{
+		unsigned char * quarter = QuarterImageSize( image.GetDataPtr(), state.GetArg(), state.GetArg(), true );
+		DoNotOptimize( quarter );
+		free( quarter );
+	}
+	state.SetBytesPerIteration( image.GetSizeI() );
+}
+
+static void ScaleImage( ovrBenchmarkState & state, const ImageFilter filter )
+{
+	static const int SIZE = 1024;
+	Array< uint8_t > image;
+	MakeImage( image, SIZE, SIZE );
+	while ( state.KeepRunning() )
+	{
+		unsigned char * scaled = ScaleImageRGBA( image.GetDataPtr(), SIZE, SIZE, SIZE * 3 / 4, SIZE * 3 / 4, filter );
+		DoNotOptimize( scaled );
+		free( scaled );
+	}
+	state.SetBytesPerIteration( image.GetSizeI() );
+}
+
+OVR_BENCHMARK( Image, ScaleNearest, BENCHMARK_MICRO )
+{
+	ScaleImage( state, IMAGE_FILTER_NEAREST );
+}
+
+OVR_BENCHMARK( Image, ScaleLinear, BENCHMARK_MICRO )
+{
+	ScaleImage( state, IMAGE_FILTER_LINEAR );
+}
+
+OVR_BENCHMARK( Image, ScaleCubic, BENCHMARK_MICRO )
+{
+	ScaleImage( state, IMAGE_FILTER_CUBIC );
+}
+
+static void AppendToArray( void * context, void * data, int size )
+{
+	Array< uint8_t > & out = *static_cast< Array< uint8_t > * >( context );
+	const int offset = out.GetSizeI();
+	out.Resize( offset + size );
+	memcpy( &out[offset], data, size );
+}
+
+OVR_BENCHMARK_ARGS( Image, StbPngDecode, BENCHMARK_MACRO, 512, 2048 )
+{
+	Array< uint8_t > image;
+	MakeImage( image, state.GetArg(), state.GetArg() );
+	Array< uint8_t > png;
+	stbi_write_png_to_func( AppendToArray, &png, state.GetArg(), state.GetArg(), 4, image.GetDataPtr(), state.GetArg() * 4 );
+	while ( state.KeepRunning() )
+	{
+		int width = 0;
+		int height = 0;
+		int comp = 0;
+		stbi_uc * decoded = stbi_load_from_memory( png.GetDataPtr(), png.GetSizeI(), &width, &height, &comp, 4 );
+		if ( decoded == NULL )
+		{
+			state.SkipWithError( "stbi_load_from_memory failed" );
+			break;
+		}
+		stbi_image_free( decoded );
+	}
+	state.SetBytesPerIteration( image.GetSizeI() );
+}
+
+//==============================================================
+// Packages
+//==============================================================
+
+static const int NUM_PACKAGE_ENTRIES = 1024;
+static const int PACKAGE_FILE_SIZE = 1024 * 1024;
+
+// A temporary package, written once, with a deflated and a stored copy of an image and
+// NUM_PACKAGE_ENTRIES small files, like the assets of a large app.
+class ovrBenchmarkPackage
+{
+public:
+	ovrBenchmarkPackage()
+	{
+		OVR_strcpy( Path, sizeof( Path ), "/tmp/ovr_benchmark_XXXXXX.zip" );
+		const int fd = mkstemps( Path, 4 );
+		if ( fd < 0 )
+		{
+			Path[0] = '\0';
+			return;
+		}
+		close( fd );
+
+		zipFile zip = zipOpen( Path, APPEND_STATUS_CREATE );
+		if ( zip == NULL )
+		{
+			unlink( Path );
+			Path[0] = '\0';
+			return;
+		}
+		Array< uint8_t > image;
+		MakeImage( image, 512, PACKAGE_FILE_SIZE / ( 512 * 4 ) );
+		const zip_fileinfo info = {};
+		zipOpenNewFileInZip( zip, "assets/deflated.raw", &info, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_DEFAULT_COMPRESSION );
+		zipWriteInFileInZip( zip, image.GetDataPtr(), image.GetSizeI() );
+		zipCloseFileInZip( zip );
+		zipOpenNewFileInZip( zip, "assets/stored.raw", &info, NULL, 0, NULL, 0, NULL, 0, 0 );
+		zipWriteInFileInZip( zip, image.GetDataPtr(), image.GetSizeI() );
+		zipCloseFileInZip( zip );
+		for ( int i = 0; i < NUM_PACKAGE_ENTRIES; i++ )
+		{
+			char name[64];
+			OVR_sprintf( name, sizeof( name ), "res/raw/entry_%04d.txt", i );
+			zipOpenNewFileInZip( zip, name, &info, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_DEFAULT_COMPRESSION );
+			zipWriteInFileInZip( zip, name, (unsigned int)strlen( name ) );
+			zipCloseFileInZip( zip );
+		}
+		zipClose( zip, NULL );
+	}
+
+	~ovrBenchmarkPackage()
+	{
+		if ( Path[0] != '\0' )
+		{
+			unlink( Path );
+		}
+	}
+
+	const char *	GetPath() const { return ( Path[0] != '\0' ) ? Path : NULL; }
+
+private:
+	char			Path[64];
+};
+
+static const char * GetPackagePath()
+{
+	static ovrBenchmarkPackage package;
+	return package.GetPath();
+}
+
+static void ReadPackageFile( ovrBenchmarkState & state, const char * nameInZip )
+{
+	void * zip = ( GetPackagePath() != NULL ) ? ovr_OpenOtherApplicationPackage( GetPackagePath() ) : NULL;
+	if ( zip == NULL )
+	{
+		state.SkipWithError( "could not write the package" );
+		return;
+	}
+	while ( state.KeepRunning() )
+	{
+		MemBufferT< uint8_t > buffer;
+		if ( !ovr_ReadFileFromOtherApplicationPackage( zip, nameInZip, buffer ) )
+		{
+			state.SkipWithError( "ovr_ReadFileFromOtherApplicationPackage failed" );
+			break;
+		}
+		DoNotOptimize( static_cast< uint8_t * >( buffer ) );
+	}
+	state.SetBytesPerIteration( PACKAGE_FILE_SIZE );
+	ovr_CloseOtherApplicationPackage( zip );
+}
+
+OVR_BENCHMARK( Package, ReadDeflated, BENCHMARK_MACRO )
+{
+	ReadPackageFile( state, "assets/deflated.raw" );
+}
+
+OVR_BENCHMARK( Package, ReadStored, BENCHMARK_MACRO )
+{
+	ReadPackageFile( state, "assets/stored.raw" );
+}
+
+OVR_BENCHMARK( Package, LocateFile, BENCHMARK_MICRO )
+{
+	unzFile zip = ( GetPackagePath() != NULL ) ? unzOpen( GetPackagePath() ) : NULL;
+	if ( zip == NULL )
+	{
+		state.SkipWithError( "could not write the package" );
+		return;
+	}
+	static const int NUM_LOOKUPS = 16;
+	char names[NUM_LOOKUPS][64];
+	for ( int i = 0; i < NUM_LOOKUPS; i++ )
+	{
+		OVR_sprintf( names[i], sizeof( names[i] ), "res/raw/entry_%04d.txt", ( i * 397 ) % NUM_PACKAGE_ENTRIES );
+	}
+	while ( state.KeepRunning() )
+	{
+		int found = 0;
+		for ( int i = 0; i < NUM_LOOKUPS; i++ )
+		{
+			found += ( unzLocateFile( zip, names[i], 2 ) == UNZ_OK );
+		}
+		DoNotOptimize( found );
+	}
+	state.SetItemsPerIteration( NUM_LOOKUPS );
+	unzClose( zip );
+}
+
+//==============================================================
+// Thumbnails
+//==============================================================
+
+static const int THUMBNAIL_SOURCE_WIDTH = 2048;
+static const int THUMBNAIL_SOURCE_HEIGHT = 1024;
+static const int THUMBNAIL_WIDTH = 256;		// of the Oculus360Photos browser
+static const int THUMBNAIL_HEIGHT = 160;
+
+// A temporary folder, written once, of large panorama JPEGs as a browser would scan them.
+// The files share the same image but each has its index in a comment segment, so that
+// they all have different contents.
+class ovrBenchmarkJpegFolder
+{
+public:
+	ovrBenchmarkJpegFolder( const int numFiles ) :
+		NumFiles( 0 )
+	{
+		OVR_strcpy( Path, sizeof( Path ), "/tmp/ovr_benchmark_XXXXXX" );
+		if ( mkdtemp( Path ) == NULL )
+		{
+			Path[0] = '\0';
+			return;
+		}
+
+		Array< uint8_t > image;
+		MakeImage( image, THUMBNAIL_SOURCE_WIDTH, THUMBNAIL_SOURCE_HEIGHT );
+		tjhandle tj = tjInitCompress();
+		unsigned char * jpg = NULL;
+		unsigned long jpgSize = 0;
+		const int result = tjCompress2( tj, image.GetDataPtr(), THUMBNAIL_SOURCE_WIDTH, THUMBNAIL_SOURCE_WIDTH * 4,
+				THUMBNAIL_SOURCE_HEIGHT, TJPF_RGBX, &jpg, &jpgSize, TJSAMP_444, 90, 0 );
+		tjDestroy( tj );
+		if ( result != 0 )
+		{
+			return;
+		}
+
+		for ( ; NumFiles < numFiles; NumFiles++ )
+		{
+			char comment[16];
+			const int commentLength = OVR_sprintf( comment, sizeof( comment ), "%d", NumFiles );
+			const uint8_t marker[4] = { 0xFF, 0xFE, 0, (uint8_t)( commentLength + 2 ) };
+			char fileName[128];
+			FILE * f = fopen( GetFileName( NumFiles, fileName ), "wb" );
+			if ( f == NULL )
+			{
+				break;
+			}
+			// the comment goes right after the SOI marker
+			fwrite( jpg, 1, 2, f );
+			fwrite( marker, 1, sizeof( marker ), f );
+			fwrite( comment, 1, commentLength, f );
+			fwrite( jpg + 2, 1, jpgSize - 2, f );
+			fclose( f );
+		}
+		tjFree( jpg );
+	}
+
+	// Runs after OVR::System::Destroy(), so this does not allocate.
+	~ovrBenchmarkJpegFolder()
+	{
+		if ( Path[0] == '\0' )
+		{
+			return;
+		}
+		char fileName[128];
+		for ( int i = 0; i < NumFiles; i++ )
+		{
+			unlink( GetFileName( i, fileName ) );
+		}
+		unlink( GetPackPath( fileName ) );
+		rmdir( Path );
+	}
+
+	int				GetNumFiles() const { return NumFiles; }
+	const char *	GetFileName( const int index, char ( &fileName )[128] ) const
+	{
+		OVR_sprintf( fileName, sizeof( fileName ), "%s/pano_%04d.jpg", Path, index );
+		return fileName;
+	}
+	const char *	GetPackPath( char ( &fileName )[128] ) const
+	{
+		OVR_sprintf( fileName, sizeof( fileName ), "%s/thumbnails.pack", Path );
+		return fileName;
+	}
+
+private:
+	char			Path[64];
+	int				NumFiles;
+};
+
+static const ovrBenchmarkJpegFolder & GetJpegFolder( ovrBenchmarkState & state )
+{
+	static ovrBenchmarkJpegFolder folder( state.GetArg() );
+	return folder;
+}
+
+// Loads a thumbnail the way the video and photo browsers did before the thumbnail cache,
+// by decoding the whole image and shrinking it.
+static unsigned char * LoadThumbnailFullDecode( const char * fileName )
+{
+	MappedFile file;
+	MappedView view;
+	if ( !file.OpenRead( fileName, true ) || !view.Open( &file ) || view.MapView() == NULL )
+	{
+		return NULL;
+	}
+	int width = 0;
+	int height = 0;
+	unsigned char * image = TurboJpegLoadFromMemory( view.GetFront(), view.GetLength(), &width, &height );
+	if ( image == NULL )
+	{
+		return NULL;
+	}
+	unsigned char * thumbnail = ScaleImageRGBA( image, width, height, THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT, IMAGE_FILTER_CUBIC );
+	free( image );
+	return thumbnail;
+}
+
+// Loads a thumbnail the way VideoBrowser::LoadJpegThumbnail() does, from the cache, or
+// otherwise with a scaled decode that is then added to the cache.
+static unsigned char * LoadThumbnailCached( OvrThumbnailCache & cache, const char * fileName )
+{
+	const uint64_t key = OvrThumbnailCache::CalculateKey( fileName );
+	int width = 0;
+	int height = 0;
+	unsigned char * cached = cache.Find( key, width, height );
+	if ( cached != NULL )
+	{
+		return cached;
+	}
+
+	MappedFile file;
+	MappedView view;
+	if ( !file.OpenRead( fileName, true ) || !view.Open( &file ) || view.MapView() == NULL )
+	{
+		return NULL;
+	}
+	unsigned char * image = TurboJpegLoadScaledFromMemory( view.GetFront(), view.GetLength(),
+			THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT, &width, &height );
+	if ( image == NULL )
+	{
+		return NULL;
+	}
+	unsigned char * thumbnail = ScaleImageRGBA( image, width, height, THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT, IMAGE_FILTER_CUBIC );
+	free( image );
+	if ( thumbnail != NULL )
+	{
+		cache.Add( key, thumbnail, THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT );
+	}
+	return thumbnail;
+}
+
+OVR_BENCHMARK_ARGS( Thumbnail, ScanFullDecode, BENCHMARK_MACRO, 1000 )
+{
+	const ovrBenchmarkJpegFolder & folder = GetJpegFolder( state );
+	if ( folder.GetNumFiles() != state.GetArg() )
+	{
+		state.SkipWithError( "could not write the images" );
+		return;
+	}
+	char fileName[128];
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < folder.GetNumFiles(); i++ )
+		{
+			unsigned char * thumbnail = LoadThumbnailFullDecode( folder.GetFileName( i, fileName ) );
+			if ( thumbnail == NULL )
+			{
+				state.SkipWithError( "could not load a thumbnail" );
+				return;
+			}
+			free( thumbnail );
+		}
+	}
+	state.SetItemsPerIteration( folder.GetNumFiles() );
+}
+
+// A first scan, with an empty cache, including writing the pack.
+OVR_BENCHMARK_ARGS( Thumbnail, ScanCold, BENCHMARK_MACRO, 1000 )
+{
+	const ovrBenchmarkJpegFolder & folder = GetJpegFolder( state );
+	if ( folder.GetNumFiles() != state.GetArg() )
+	{
+		state.SkipWithError( "could not write the images" );
+		return;
+	}
+	char fileName[128];
+	char packPath[128];
+	while ( state.KeepRunning() )
+	{
+		unlink( folder.GetPackPath( packPath ) );
+		OvrThumbnailCache cache;
+		if ( !cache.Open( folder.GetPackPath( packPath ) ) )
+		{
+			state.SkipWithError( "could not open the thumbnail cache" );
+			return;
+		}
+		for ( int i = 0; i < folder.GetNumFiles(); i++ )
+		{
+			unsigned char * thumbnail = LoadThumbnailCached( cache, folder.GetFileName( i, fileName ) );
+			if ( thumbnail == NULL )
+			{
+				state.SkipWithError( "could not load a thumbnail" );
+				return;
+			}
+			free( thumbnail );
+		}
+		cache.Close();
+	}
+	state.SetItemsPerIteration( folder.GetNumFiles() );
+}
+
+// A later scan, with every thumbnail in the pack, including opening it.
+OVR_BENCHMARK_ARGS( Thumbnail, ScanWarm, BENCHMARK_MACRO, 1000 )
+{
+	const ovrBenchmarkJpegFolder & folder = GetJpegFolder( state );
+	if ( folder.GetNumFiles() != state.GetArg() )
+	{
+		state.SkipWithError( "could not write the images" );
+		return;
+	}
+	char fileName[128];
+	char packPath[128];
+	{
+		OvrThumbnailCache cache;
+		if ( !cache.Open( folder.GetPackPath( packPath ) ) )
+		{
+			state.SkipWithError( "could not open the thumbnail cache" );
+			return;
+		}
+		for ( int i = 0; i < folder.GetNumFiles(); i++ )
+		{
+			free( LoadThumbnailCached( cache, folder.GetFileName( i, fileName ) ) );
+		}
+		cache.Close();
+	}
+
+	int hits = 0;
+	while ( state.KeepRunning() )
+	{
+		hits = 0;
+		OvrThumbnailCache cache;
+		cache.Open( folder.GetPackPath( packPath ) );
+		for ( int i = 0; i < folder.GetNumFiles(); i++ )
+		{
+			int width = 0;
+			int height = 0;
+			unsigned char * thumbnail = cache.Find( OvrThumbnailCache::CalculateKey( folder.GetFileName( i, fileName ) ), width, height );
+			hits += ( thumbnail != NULL );
+			free( thumbnail );
+		}
+		cache.Close();
+	}
+	if ( hits != folder.GetNumFiles() )
+	{
+		state.SkipWithError( "thumbnails are missing from the cache" );
+		return;
+	}
+	state.SetItemsPerIteration( folder.GetNumFiles() );
+}
+
+static bool FindThumbnails( OvrThumbnailCache & cache, const Array< uint8_t > & thumbnails, const int count )
+{
+	const size_t size = THUMBNAIL_WIDTH * THUMBNAIL_HEIGHT * 4;
+	for ( int i = 0; i < count; i++ )
+	{
+		int width = 0;
+		int height = 0;
+		unsigned char * thumbnail = cache.Find( i + 1, width, height );
+		const bool found = thumbnail != NULL && width == THUMBNAIL_WIDTH && height == THUMBNAIL_HEIGHT &&
+							memcmp( thumbnail, &thumbnails[i * size], size ) == 0;
+		free( thumbnail );
+		if ( !found )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Checks that thumbnails are found while they wait to be written, after the pack is opened
+// again and after an append to it was cut off, and that a pack in the format from before
+// thumbnails were zipped is started over.
+OVR_BENCHMARK( Thumbnail, CacheMatches, BENCHMARK_MACRO )
+{
+	static const int NUM_THUMBNAILS = 16;
+	char path[64];
+	OVR_strcpy( path, sizeof( path ), "/tmp/ovr_benchmark_XXXXXX" );
+	if ( mkdtemp( path ) == NULL )
+	{
+		state.SkipWithError( "could not create a folder" );
+		return;
+	}
+	char packPath[128];
+	OVR_sprintf( packPath, sizeof( packPath ), "%s/thumbnails.pack", path );
+
+	Array< uint8_t > thumbnails;
+	MakeImage( thumbnails, THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT * NUM_THUMBNAILS );
+	const size_t size = THUMBNAIL_WIDTH * THUMBNAIL_HEIGHT * 4;
+
+	const char * error = NULL;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		FILE * f = fopen( packPath, "wb" );
+		if ( f != NULL )
+		{
+			fwrite( "OVTC\1\0\0\0", 1, 8, f );
+			fclose( f );
+		}
+		OvrThumbnailCache cache;
+		if ( !cache.Open( packPath ) )
+		{
+			error = "could not open the thumbnail cache";
+			break;
+		}
+		for ( int i = 0; i < NUM_THUMBNAILS; i++ )
+		{
+			cache.Add( i + 1, &thumbnails[i * size], THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT );
+		}
+		if ( !FindThumbnails( cache, thumbnails, NUM_THUMBNAILS ) )
+		{
+			error = "a thumbnail was not found before it was written";
+		}
+		cache.Close();
+
+		for ( int pass = 0; pass < 2 && error == NULL; pass++ )
+		{
+			if ( pass == 1 )
+			{
+				// what is left of an append that did not finish
+				f = fopen( packPath, "ab" );
+				if ( f != NULL )
+				{
+					fwrite( thumbnails.GetDataPtr(), 1, size, f );
+					fclose( f );
+				}
+			}
+			if ( !cache.Open( packPath ) )
+			{
+				error = "could not open the thumbnail cache again";
+			}
+			else if ( !FindThumbnails( cache, thumbnails, NUM_THUMBNAILS ) )
+			{
+				error = ( pass == 0 ) ? "a thumbnail was not found in the pack" :
+										"a thumbnail was not found after an append was cut off";
+			}
+			cache.Close();
+		}
+	}
+	unlink( packPath );
+	rmdir( path );
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+	}
+}
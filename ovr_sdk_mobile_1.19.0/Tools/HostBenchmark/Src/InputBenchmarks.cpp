@@ -0,0 +1,417 @@
+/************************************************************************************
+
+Filename    :   InputBenchmarks.cpp
+Content     :   Replays a recorded input session through the VrAppFramework input path.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+#include "HostShims.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Array.h"
+#include "InputEventRing.h"
+#include "MessageQueue.h"
+#include "VrFrameBuilder.h"
+
+using namespace OVR;
+
+//==============================================================
+// A recorded input session
+// Input as the JNI entry points receive it: left stick samples at 250 Hz, joypad button
+// presses with a burst of more presses than fit in one frame, and touchpad samples at 100 Hz
+// that repeat a tap, a double tap, a swipe and a long press. The right stick stays centered
+// so that VrFrameBuilder does not add stick key events of its own.
+
+enum ovrRecordedInputType
+{
+	RECORDED_JOYSTICKS,
+	RECORDED_KEY,
+	RECORDED_TRACKPAD
+};
+
+struct ovrRecordedInput
+{
+	double		Time;
+	int			Type;			// ovrRecordedInputType
+	float		Values[4];		// the sticks, or touched, x and y of the trackpad
+	int			KeyCode;		// with BUTTON_JOYPAD_FLAG
+	bool		Down;
+};
+
+enum ovrGesture
+{
+	GESTURE_SINGLE_TAP,
+	GESTURE_DOUBLE_TAP,
+	GESTURE_SWIPE,
+	GESTURE_LONG_PRESS,
+	GESTURE_MAX
+};
+
+struct ovrRecordedSession
+{
+	Array< ovrRecordedInput >	Events;					// in time order
+	Array< double >				FrameTimes;				// 60 Hz with a few stalls
+	int							NumGestures[GESTURE_MAX];
+};
+
+static bool RecordedInputLess( const ovrRecordedInput & a, const ovrRecordedInput & b )
+{
+	return a.Time < b.Time;
+}
+
+static void AddRecordedKey( ovrRecordedSession & session, const double time, const ovrKeyCode keyCode, const bool down )
+{
+	ovrRecordedInput event = {};
+	event.Time = time;
+	event.Type = RECORDED_KEY;
+	event.KeyCode = keyCode | BUTTON_JOYPAD_FLAG;
+	event.Down = down;
+	session.Events.PushBack( event );
+}
+
+static void RecordSession( ovrRecordedSession & session )
+{
+	const double duration = 28.0;
+
+	// The event times are offset so that no two are equal.
+	for ( int i = 0; i * 0.004 < duration; i++ )
+	{
+		const double time = i * 0.004 + 0.0001;
+		ovrRecordedInput event = {};
+		event.Time = time;
+		event.Type = RECORDED_JOYSTICKS;
+		// multiples of 1/64 survive being printed with %f
+		event.Values[0] = floorf( sinf( (float)time * 2.0f ) * 48.0f ) / 64.0f;
+		event.Values[1] = floorf( cosf( (float)time * 3.0f ) * 48.0f ) / 64.0f;
+		session.Events.PushBack( event );
+	}
+
+	static const ovrKeyCode buttons[] =
+	{
+		OVR_KEY_BUTTON_A, OVR_KEY_BUTTON_B, OVR_KEY_BUTTON_X, OVR_KEY_BUTTON_Y,
+		OVR_KEY_DPAD_UP, OVR_KEY_DPAD_DOWN, OVR_KEY_ESCAPE
+	};
+	const int numButtons = sizeof( buttons ) / sizeof( buttons[0] );
+	for ( int i = 0; i * 0.25 < duration; i++ )
+	{
+		const double time = i * 0.25 + 0.0013;
+		AddRecordedKey( session, time, buttons[i % numButtons], true );
+		AddRecordedKey( session, time + 0.08, buttons[i % numButtons], false );
+	}
+	for ( int i = 0; i < 12; i++ )
+	{
+		const double time = 10.0005 + i * 0.002;
+		AddRecordedKey( session, time, OVR_KEY_BUTTON_B, true );
+		AddRecordedKey( session, time + 0.001, OVR_KEY_BUTTON_B, false );
+	}
+
+	// Touches of the gestures, with the finger moving from StartX to EndX.
+	struct ovrTouch
+	{
+		double	Start;
+		double	End;
+		float	StartX;
+		float	EndX;
+	};
+	Array< ovrTouch > touches;
+	memset( session.NumGestures, 0, sizeof( session.NumGestures ) );
+	for ( double cycle = 0.5; cycle + 5.0 < duration; cycle += 5.6 )
+	{
+		const ovrTouch tap = { cycle, cycle + 0.1, 150.0f, 150.0f };
+		const ovrTouch doubleTap0 = { cycle + 1.2, cycle + 1.28, 150.0f, 150.0f };
+		const ovrTouch doubleTap1 = { cycle + 1.36, cycle + 1.44, 150.0f, 150.0f };
+		const ovrTouch swipe = { cycle + 2.4, cycle + 2.6, 240.0f, 60.0f };
+		const ovrTouch longPress = { cycle + 3.6, cycle + 4.6, 150.0f, 150.0f };
+		touches.PushBack( tap );
+		touches.PushBack( doubleTap0 );
+		touches.PushBack( doubleTap1 );
+		touches.PushBack( swipe );
+		touches.PushBack( longPress );
+		for ( int i = 0; i < GESTURE_MAX; i++ )
+		{
+			session.NumGestures[i]++;
+		}
+	}
+	for ( int i = 0; i * 0.01 < duration; i++ )
+	{
+		const double time = i * 0.01 + 0.0007;
+		ovrRecordedInput event = {};
+		event.Time = time;
+		event.Type = RECORDED_TRACKPAD;
+		event.Values[2] = 100.0f;
+		for ( int j = 0; j < touches.GetSizeI(); j++ )
+		{
+			if ( time >= touches[j].Start && time < touches[j].End )
+			{
+				const float f = (float)( ( time - touches[j].Start ) / ( touches[j].End - touches[j].Start ) );
+				event.Values[0] = 1.0f;
+				event.Values[1] = touches[j].StartX + ( touches[j].EndX - touches[j].StartX ) * f;
+				break;
+			}
+		}
+		session.Events.PushBack( event );
+	}
+
+	Alg::QuickSort( session.Events, RecordedInputLess );
+
+	// Stalls during the burst of presses and in the middle of a swipe.
+	for ( double time = 0.0; time < duration + 1.0; )
+	{
+		session.FrameTimes.PushBack( time );
+		const bool stall = ( time > 10.0 && time < 10.02 ) || ( time > 2.95 && time < 2.97 );
+		time += stall ? 0.1 : 1.0 / 60.0;
+	}
+}
+
+// Posts the events up to time as the JNI entry points would have, and returns the index of
+// the next event.
+static int PostRecordedInput( const ovrRecordedSession & session, int next, const double time, ovrInputEventRing & ring )
+{
+	for ( ; next < session.Events.GetSizeI() && session.Events[next].Time <= time; next++ )
+	{
+		const ovrRecordedInput & event = session.Events[next];
+		switch ( event.Type )
+		{
+			case RECORDED_JOYSTICKS:
+				ring.PostJoySticks( event.Time, event.Values[0], event.Values[1], event.Values[2], event.Values[3] );
+				break;
+			case RECORDED_KEY:
+				ring.PostKey( event.Time, event.KeyCode, event.Down, 0 );
+				break;
+			case RECORDED_TRACKPAD:
+				ovrHostShims::SetHeadsetTrackpad( event.Values[0] != 0.0f, event.Values[1], event.Values[2], event.Time );
+				break;
+		}
+	}
+	return next;
+}
+
+static ovrJava MakeHostJava()
+{
+	ovrJava java;
+	memset( &java, 0, sizeof( java ) );
+	return java;
+}
+
+// Checks that every frame has the key events that happened before it, in order and with their
+// own times, that key events which do not fit in a frame are in the next one, that the sticks
+// are the latest sample before those, and that all of the touchpad gestures are recognized.
+OVR_BENCHMARK( Input, ReplayMatches, BENCHMARK_MICRO )
+{
+	ovrRecordedSession session;
+	RecordSession( session );
+	const ovrJava java = MakeHostJava();
+
+	Array< ovrRecordedInput > expectedKeys;
+	for ( int i = 0; i < session.Events.GetSizeI(); i++ )
+	{
+		if ( session.Events[i].Type == RECORDED_KEY && ( session.Events[i].KeyCode & ~BUTTON_JOYPAD_FLAG ) != OVR_KEY_ESCAPE )
+		{
+			expectedKeys.PushBack( session.Events[i] );
+		}
+	}
+
+	const char * error = NULL;
+	int fullFrames = 0;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		ovrInputEventRing ring;
+		VrFrameBuilder builder;
+		ovrHostShims::SetHeadsetTrackpad( false, 0.0f, 0.0f, 0.0 );
+
+		float sticks[2][2] = {};
+		int numGestures[GESTURE_MAX] = {};
+		int nextEvent = 0;
+		int nextStick = 0;
+		int nextKey = 0;
+		fullFrames = 0;
+		for ( int frame = 0; frame < session.FrameTimes.GetSizeI() && error == NULL; frame++ )
+		{
+			const double time = session.FrameTimes[frame];
+			nextEvent = PostRecordedInput( session, nextEvent, time, ring );
+
+			ovrHostShims::SetTimeInSeconds( time );
+			builder.AdvanceVrFrame( ring, NULL, java, VRAPI_TRACKING_TRANSFORM_SYSTEM_CENTER_EYE_LEVEL, -1 );
+			const VrInput & input = builder.Get().Input;
+
+			fullFrames += ( input.NumKeyEvents == MAX_KEY_EVENTS_PER_FRAME );
+			for ( int i = 0; i < input.NumKeyEvents && error == NULL; i++, nextKey++ )
+			{
+				if ( nextKey >= expectedKeys.GetSizeI() )
+				{
+					error = "there are more key events than were posted";
+					break;
+				}
+				const ovrRecordedInput & expected = expectedKeys[nextKey];
+				if ( input.KeyEvents[i].KeyCode != ( expected.KeyCode & ~BUTTON_JOYPAD_FLAG ) ||
+						input.KeyEvents[i].EventType != ( expected.Down ? KEY_EVENT_DOWN : KEY_EVENT_UP ) ||
+						input.KeyEvents[i].TimeInSeconds != expected.Time )
+				{
+					error = "a key event differs from the one posted";
+				}
+				else if ( expected.Time > time )
+				{
+					error = "a key event is in a frame before it happened";
+				}
+			}
+
+			// The joystick events behind key events that are left for the next frame are
+			// also left for the next frame.
+			const double stickTime = ( nextKey < expectedKeys.GetSizeI() && expectedKeys[nextKey].Time <= time ) ?
+										expectedKeys[nextKey].Time : time;
+			for ( ; nextStick < nextEvent && session.Events[nextStick].Time <= stickTime; nextStick++ )
+			{
+				if ( session.Events[nextStick].Type == RECORDED_JOYSTICKS )
+				{
+					memcpy( sticks, session.Events[nextStick].Values, sizeof( sticks ) );
+				}
+			}
+			if ( error == NULL && memcmp( input.sticks, sticks, sizeof( sticks ) ) != 0 )
+			{
+				error = "the sticks are not the latest sample";
+			}
+
+			numGestures[GESTURE_SINGLE_TAP] += ( input.buttonPressed & BUTTON_TOUCH_SINGLE ) != 0;
+			numGestures[GESTURE_DOUBLE_TAP] += ( input.buttonPressed & BUTTON_TOUCH_DOUBLE ) != 0;
+			numGestures[GESTURE_SWIPE] += ( input.buttonPressed & ( BUTTON_SWIPE_FORWARD | BUTTON_SWIPE_BACK | BUTTON_SWIPE_UP | BUTTON_SWIPE_DOWN ) ) != 0;
+			numGestures[GESTURE_LONG_PRESS] += ( input.buttonPressed & BUTTON_TOUCH_LONGPRESS ) != 0;
+		}
+
+		if ( error == NULL && nextKey != expectedKeys.GetSizeI() )
+		{
+			error = "key events were lost";
+		}
+		if ( error == NULL && fullFrames == 0 )
+		{
+			error = "no frame was filled with key events";
+		}
+		if ( error == NULL && memcmp( numGestures, session.NumGestures, sizeof( numGestures ) ) != 0 )
+		{
+			error = "the touchpad gestures differ from the ones recorded";
+		}
+		if ( error == NULL && ring.GetNumDropped() != 0 )
+		{
+			error = "events were dropped";
+		}
+	}
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+		return;
+	}
+	state.SetCounter( "fullFrames", fullFrames );
+}
+
+static int CountRecordedInputs( const ovrRecordedSession & session )
+{
+	int count = 0;
+	for ( int i = 0; i < session.Events.GetSizeI(); i++ )
+	{
+		count += ( session.Events[i].Type != RECORDED_TRACKPAD );
+	}
+	return count;
+}
+
+// Sends the joystick and key events of the session from the JNI entry points to the VR thread
+// through the input ring, one frame at a time, on one thread.
+OVR_BENCHMARK( Input, ReplayRing, BENCHMARK_MICRO )
+{
+	ovrRecordedSession session;
+	RecordSession( session );
+	ovrInputEventRing ring;
+	while ( state.KeepRunning() )
+	{
+		int received = 0;
+		int nextEvent = 0;
+		for ( int frame = 0; frame < session.FrameTimes.GetSizeI(); frame++ )
+		{
+			nextEvent = PostRecordedInput( session, nextEvent, session.FrameTimes[frame], ring );
+			for ( const ovrInputEvent * event = ring.Peek(); event != NULL; event = ring.Peek() )
+			{
+				received += ( event->Type == INPUT_EVENT_KEY ) ? event->Key.KeyCode : (int)event->JoySticks[0][0];
+				ring.Pop();
+			}
+		}
+		DoNotOptimize( received );
+	}
+	state.SetItemsPerIteration( CountRecordedInputs( session ) );
+}
+
+// The same through the message queue, as "joy" and "key" commands, the way they were sent
+// before the input ring.
+OVR_BENCHMARK( Input, ReplayMessageQueue, BENCHMARK_MICRO )
+{
+	ovrRecordedSession session;
+	RecordSession( session );
+	ovrMessageQueue queue( 100 );
+	while ( state.KeepRunning() )
+	{
+		float sticks[2][2] = {};
+		int received = 0;
+		int nextEvent = 0;
+		for ( int frame = 0; frame < session.FrameTimes.GetSizeI(); frame++ )
+		{
+			for ( ; nextEvent < session.Events.GetSizeI() && session.Events[nextEvent].Time <= session.FrameTimes[frame]; nextEvent++ )
+			{
+				const ovrRecordedInput & event = session.Events[nextEvent];
+				if ( event.Type == RECORDED_JOYSTICKS )
+				{
+					queue.PostPrintfIfSpaceAvailable( 12, "joy %f %f %f %f", event.Values[0], event.Values[1], event.Values[2], event.Values[3] );
+				}
+				else if ( event.Type == RECORDED_KEY )
+				{
+					queue.PostPrintfIfSpaceAvailable( 12, "key %i %i %i", event.KeyCode, event.Down, 0 );
+				}
+			}
+			for ( const char * msg = queue.GetNextMessage(); msg != NULL; msg = queue.GetNextMessage() )
+			{
+				if ( strncmp( msg, "joy ", 4 ) == 0 )
+				{
+					sscanf( msg, "joy %f %f %f %f", &sticks[0][0], &sticks[0][1], &sticks[1][0], &sticks[1][1] );
+					received += (int)sticks[0][0];
+				}
+				else if ( strncmp( msg, "key ", 4 ) == 0 )
+				{
+					int keyCode, down, repeatCount;
+					sscanf( msg, "key %i %i %i", &keyCode, &down, &repeatCount );
+					received += keyCode;
+				}
+				free( (void *)msg );
+			}
+		}
+		DoNotOptimize( received );
+	}
+	state.SetItemsPerIteration( CountRecordedInputs( session ) );
+}
+
+// Builds the frame input for every frame of the session.
+OVR_BENCHMARK( Input, ReplayFrames, BENCHMARK_MICRO )
+{
+	ovrRecordedSession session;
+	RecordSession( session );
+	const ovrJava java = MakeHostJava();
+	while ( state.KeepRunning() )
+	{
+		ovrInputEventRing ring;
+		VrFrameBuilder builder;
+		int nextEvent = 0;
+		for ( int frame = 0; frame < session.FrameTimes.GetSizeI(); frame++ )
+		{
+			nextEvent = PostRecordedInput( session, nextEvent, session.FrameTimes[frame], ring );
+			ovrHostShims::SetTimeInSeconds( session.FrameTimes[frame] );
+			builder.AdvanceVrFrame( ring, NULL, java, VRAPI_TRACKING_TRANSFORM_SYSTEM_CENTER_EYE_LEVEL, -1 );
+		}
+		DoNotOptimize( builder.Get().Input.buttonState );
+	}
+	state.SetItemsPerIteration( session.FrameTimes.GetSizeI() );
+}
@@ -0,0 +1,597 @@
+/************************************************************************************
+
+Filename    :   KernelBenchmarks.cpp
+Content     :   Benchmarks of the LibOVRKernel containers, strings, JSON, lexer and
+                allocators.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <stdio.h>
+
+#include "Kernel/OVR_Allocators.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Atom.h"
+#include "Kernel/OVR_FlatHash.h"
+#include "Kernel/OVR_Hash.h"
+#include "Kernel/OVR_JSON.h"
+#include "Kernel/OVR_Lexer.h"
+#include "Kernel/OVR_Math.h"
+#include "Kernel/OVR_String.h"
+#include "Kernel/OVR_StringHash.h"
+
+using namespace OVR;
+
+// A JSON document shaped like a glTF file, with numObjects nodes and accessors.
+static String MakeJsonDocument( const int numObjects )
+{
+	ovrBenchmarkRandom random;
+	StringBuffer json;
+	json += "{\n\t\"asset\": { \"version\": \"2.0\", \"generator\": \"HostBenchmark\" },\n\t\"nodes\": [\n";
+	for ( int i = 0; i < numObjects; i++ )
+	{
+		json.AppendFormat( "\t\t{ \"name\": \"node_%d\", \"mesh\": %d, \"translation\": [ %f, %f, %f ], \"rotation\": [ 0.0, 0.0, 0.0, 1.0 ], \"visible\": %s }%s\n",
+				i, i % 16, random.NextFloat( -100.0f, 100.0f ), random.NextFloat( -100.0f, 100.0f ), random.NextFloat( -100.0f, 100.0f ),
+				( i & 1 ) ? "true" : "false", ( i + 1 < numObjects ) ? "," : "" );
+	}
+	json += "\t],\n\t\"accessors\": [\n";
+	for ( int i = 0; i < numObjects; i++ )
+	{
+		json.AppendFormat( "\t\t{ \"bufferView\": %d, \"byteOffset\": %d, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\", \"min\": [ -1.0, -1.0, -1.0 ], \"max\": [ 1.0, 1.0, 1.0 ] }%s\n",
+				i, i * 12, 24 + i % 100, ( i + 1 < numObjects ) ? "," : "" );
+	}
+	json += "\t]\n}\n";
+	return String( json.ToCStr() );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, JsonParse, BENCHMARK_MICRO, 64, 4096 )
+{
+	const String json = MakeJsonDocument( state.GetArg() );
+	while ( state.KeepRunning() )
+	{
+		JSON * root = JSON::Parse( json.ToCStr() );
+		DoNotOptimize( root );
+		root->Release();
+	}
+	state.SetBytesPerIteration( (double)json.GetSize() );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, JsonReaderWalk, BENCHMARK_MICRO, 4096 )
+{
+	const String json = MakeJsonDocument( state.GetArg() );
+	JSON * root = JSON::Parse( json.ToCStr() );
+	while ( state.KeepRunning() )
+	{
+		const JsonReader reader( root );
+		const JsonReader nodes( reader.GetChildByName( "nodes" ) );
+		float sum = 0.0f;
+		while ( !nodes.IsEndOfArray() )
+		{
+			const JsonReader node( nodes.GetNextArrayElement() );
+			sum += node.GetChildInt32ByName( "mesh" );
+			const JsonReader translation( node.GetChildByName( "translation" ) );
+			while ( !translation.IsEndOfArray() )
+			{
+				sum += translation.GetNextArrayFloat();
+			}
+		}
+		DoNotOptimize( sum );
+	}
+	state.SetItemsPerIteration( state.GetArg() );
+	root->Release();
+}
+
+OVR_BENCHMARK_ARGS( Kernel, JsonPrint, BENCHMARK_MICRO, 4096 )
+{
+	const String json = MakeJsonDocument( state.GetArg() );
+	JSON * root = JSON::Parse( json.ToCStr() );
+	while ( state.KeepRunning() )
+	{
+		char * text = root->PrintValue( 0, true );
+		DoNotOptimize( text );
+		OVR_FREE( text );
+	}
+	state.SetBytesPerIteration( (double)json.GetSize() );
+	root->Release();
+}
+
+// Shaped like a VRMenu reflection file.
+static void MakeLexerSource( StringBuffer & source )
+{
+	ovrBenchmarkRandom random;
+	for ( int i = 0; i < 512; i++ )
+	{
+		source.AppendFormat( "itemParms[%d] = { Name = \"item_%d\"; Flags = VRMENUOBJECT_RENDER_HIERARCHY_ORDER | VRMENUOBJECT_DONT_HIT_TEXT; "
+				"LocalPose = { Orientation = ( 0, 0, 0, 1 ); Position = ( %f, %f, %f ); }; Id = %d; }\n",
+				i, i, random.NextFloat( -1.0f, 1.0f ), random.NextFloat( -1.0f, 1.0f ), random.NextFloat( -3.0f, -1.0f ), 1000 + i );
+	}
+}
+
+// Returns views of the source.
+OVR_BENCHMARK( Kernel, LexerTokens, BENCHMARK_MICRO )
+{
+	StringBuffer source;
+	MakeLexerSource( source );
+	int numTokens = 0;
+	while ( state.KeepRunning() )
+	{
+		ovrLexer lexer( source.ToCStr(), source.GetSize(), "{}[]();=|," );
+		ovrLexerToken token;
+		numTokens = 0;
+		while ( lexer.NextToken( token ) == ovrLexer::LEX_RESULT_OK )
+		{
+			numTokens++;
+		}
+		DoNotOptimize( numTokens );
+	}
+	state.SetItemsPerIteration( numTokens );
+	state.SetBytesPerIteration( (double)source.GetSize() );
+}
+
+// Copies every token, as the reflection parser does.
+OVR_BENCHMARK( Kernel, LexerTokensCopy, BENCHMARK_MICRO )
+{
+	StringBuffer source;
+	MakeLexerSource( source );
+	int numTokens = 0;
+	while ( state.KeepRunning() )
+	{
+		ovrLexer lexer( source.ToCStr(), source.GetSize(), "{}[]();=|," );
+		char token[1024];
+		numTokens = 0;
+		while ( lexer.NextToken( token, sizeof( token ) ) == ovrLexer::LEX_RESULT_OK )
+		{
+			numTokens++;
+		}
+		DoNotOptimize( numTokens );
+	}
+	state.SetItemsPerIteration( numTokens );
+	state.SetBytesPerIteration( (double)source.GetSize() );
+}
+
+static void MakeKeys( Array< String > & keys, const int count, const char * prefix )
+{
+	keys.Resize( count );
+	for ( int i = 0; i < count; i++ )
+	{
+		keys[i] = String::Format( "%s%d", prefix, i * 7919 );
+	}
+}
+
+static const int NUM_HASH_LOOKUPS = 1024;
+
+// Looks up keys that are in the table, or with miss, the same keys with another prefix.
+// Hash< String > is looked up the way callers holding a const char * had to before
+// StringHash, with a temporary String.
+template< class H, bool TEMPORARY_STRING >
+static void RunStringHashFind( ovrBenchmarkState & state, const bool miss )
+{
+	Array< String > keys;
+	MakeKeys( keys, state.GetArg(), "res/raw/texture_" );
+	H hash;
+	for ( int i = 0; i < keys.GetSizeI(); i++ )
+	{
+		hash.Set( keys[i], i );
+	}
+	Array< String > lookups;
+	MakeKeys( lookups, state.GetArg(), miss ? "res/raw/missing_" : "res/raw/texture_" );
+	while ( state.KeepRunning() )
+	{
+		int sum = 0;
+		for ( int i = 0; i < NUM_HASH_LOOKUPS; i++ )
+		{
+			int value = 0;
+			const char * key = lookups[( i * 31 ) % lookups.GetSizeI()].ToCStr();
+			if ( TEMPORARY_STRING )
+			{
+				hash.Get( String( key ), &value );
+			}
+			else
+			{
+				hash.Get( key, &value );
+			}
+			sum += value;
+		}
+		DoNotOptimize( sum );
+	}
+	state.SetItemsPerIteration( NUM_HASH_LOOKUPS );
+}
+
+typedef Hash< String, int, String::NoCaseHashFunctor > ovrStringKeyHash;
+
+OVR_BENCHMARK_ARGS( Kernel, StringHashFind, BENCHMARK_MICRO, 64, 16384 )
+{
+	RunStringHashFind< StringHash< int >, false >( state, false );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, StringHashMiss, BENCHMARK_MICRO, 16384 )
+{
+	RunStringHashFind< StringHash< int >, false >( state, true );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, HashStringFind, BENCHMARK_MICRO, 64, 16384 )
+{
+	RunStringHashFind< ovrStringKeyHash, true >( state, false );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, HashStringMiss, BENCHMARK_MICRO, 16384 )
+{
+	RunStringHashFind< ovrStringKeyHash, true >( state, true );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, StringHashFindCaseInsensitive, BENCHMARK_MICRO, 16384 )
+{
+	Array< String > keys;
+	MakeKeys( keys, state.GetArg(), "Res/Raw/Texture_" );
+	StringHash< int > hash;
+	for ( int i = 0; i < keys.GetSizeI(); i++ )
+	{
+		hash.SetCaseInsensitive( keys[i], i );
+	}
+	Array< String > lookups;
+	MakeKeys( lookups, state.GetArg(), "RES/RAW/TEXTURE_" );
+	while ( state.KeepRunning() )
+	{
+		int sum = 0;
+		for ( int i = 0; i < NUM_HASH_LOOKUPS; i++ )
+		{
+			int value = 0;
+			hash.GetCaseInsensitive( lookups[( i * 31 ) % lookups.GetSizeI()], &value );
+			sum += value;
+		}
+		DoNotOptimize( sum );
+	}
+	state.SetItemsPerIteration( NUM_HASH_LOOKUPS );
+}
+
+// Integer keys are spread out so that consecutive keys do not have consecutive hash values,
+// and a miss key is always between two keys that are in the table.
+static const int HASH_KEY_STRIDE = 1021;
+
+// Builds a table of the argument's number of keys, and destroys it.
+template< class H >
+static void RunHashIntInsert( ovrBenchmarkState & state )
+{
+	while ( state.KeepRunning() )
+	{
+		H hash;
+		for ( int i = 0; i < state.GetArg(); i++ )
+		{
+			hash.Add( i * HASH_KEY_STRIDE, i );
+		}
+		DoNotOptimize( hash );
+	}
+	state.SetItemsPerIteration( state.GetArg() );
+}
+
+template< class H >
+static void RunHashIntFind( ovrBenchmarkState & state, const bool miss )
+{
+	H hash;
+	for ( int i = 0; i < state.GetArg(); i++ )
+	{
+		hash.Set( i * HASH_KEY_STRIDE, i );
+	}
+	while ( state.KeepRunning() )
+	{
+		int sum = 0;
+		for ( int i = 0; i < NUM_HASH_LOOKUPS; i++ )
+		{
+			int value = 0;
+			hash.Get( ( ( i * 7919 ) % state.GetArg() ) * HASH_KEY_STRIDE + ( miss ? 1 : 0 ), &value );
+			sum += value;
+		}
+		DoNotOptimize( sum );
+	}
+	state.SetItemsPerIteration( NUM_HASH_LOOKUPS );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, HashIntInsert, BENCHMARK_MACRO, 1024, 16384, 1048576 )
+{
+	RunHashIntInsert< Hash< int, int > >( state );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, FlatHashIntInsert, BENCHMARK_MACRO, 1024, 16384, 1048576 )
+{
+	RunHashIntInsert< FlatHash< int, int > >( state );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, HashIntFind, BENCHMARK_MICRO, 16384, 1048576 )
+{
+	RunHashIntFind< Hash< int, int > >( state, false );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, FlatHashIntFind, BENCHMARK_MICRO, 16384, 1048576 )
+{
+	RunHashIntFind< FlatHash< int, int > >( state, false );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, HashIntMiss, BENCHMARK_MICRO, 16384, 1048576 )
+{
+	RunHashIntFind< Hash< int, int > >( state, true );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, FlatHashIntMiss, BENCHMARK_MICRO, 16384, 1048576 )
+{
+	RunHashIntFind< FlatHash< int, int > >( state, true );
+}
+
+OVR_BENCHMARK( Kernel, StringAppendPath, BENCHMARK_MICRO )
+{
+	static const char * parts[] = { "apk:///", "assets/", "menus/", "panel_", "left", ".txt" };
+	while ( state.KeepRunning() )
+	{
+		String path;
+		for ( int i = 0; i < 6; i++ )
+		{
+			path += parts[i];
+		}
+		DoNotOptimize( path );
+	}
+}
+
+OVR_BENCHMARK( Kernel, StringFormat, BENCHMARK_MICRO )
+{
+	int i = 0;
+	while ( state.KeepRunning() )
+	{
+		const String text = String::Format( "surface_%d_%s_%5.2f", i++, "opaque", 1.25f );
+		DoNotOptimize( text );
+	}
+}
+
+OVR_BENCHMARK( Kernel, StringCompareNoCase, BENCHMARK_MICRO )
+{
+	Array< String > a;
+	Array< String > b;
+	MakeKeys( a, 256, "SurfaceName_" );
+	MakeKeys( b, 256, "surfacename_" );
+	while ( state.KeepRunning() )
+	{
+		int equal = 0;
+		for ( int i = 0; i < a.GetSizeI(); i++ )
+		{
+			equal += ( String::CompareNoCase( a[i].ToCStr(), b[i].ToCStr() ) == 0 );
+		}
+		DoNotOptimize( equal );
+	}
+	state.SetItemsPerIteration( 256 );
+}
+
+// Short names like the ones given to menu objects, nodes and surfaces, copied and renamed.
+OVR_BENCHMARK( Kernel, StringCopyAppend, BENCHMARK_MICRO )
+{
+	Array< String > names;
+	MakeKeys( names, 256, "panel_" );
+	AllocationCounter counter;
+	long long iterations = 0;
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < names.GetSizeI(); i++ )
+		{
+			String copy( names[i] );
+			copy += "_x";
+			DoNotOptimize( copy );
+		}
+		iterations++;
+	}
+	if ( iterations > 0 )
+	{
+		state.SetCounter( "allocsPerCopy", (double)counter.GetStats().Allocs / ( iterations * names.GetSizeI() ) );
+	}
+	state.SetItemsPerIteration( 256 );
+}
+
+// The atoms of the names of StringCompareNoCase.
+OVR_BENCHMARK( Kernel, AtomCompareNoCase, BENCHMARK_MICRO )
+{
+	Array< String > a;
+	Array< String > b;
+	MakeKeys( a, 256, "SurfaceName_" );
+	MakeKeys( b, 256, "surfacename_" );
+	Array< ovrAtom > atomsA;
+	Array< ovrAtom > atomsB;
+	for ( int i = 0; i < a.GetSizeI(); i++ )
+	{
+		atomsA.PushBack( ovrAtom( a[i] ) );
+		atomsB.PushBack( ovrAtom( b[i] ) );
+	}
+	while ( state.KeepRunning() )
+	{
+		int equal = 0;
+		for ( int i = 0; i < atomsA.GetSizeI(); i++ )
+		{
+			equal += atomsA[i].EqualsNoCase( atomsB[i] );
+		}
+		DoNotOptimize( equal );
+	}
+	state.SetItemsPerIteration( 256 );
+}
+
+OVR_BENCHMARK( Kernel, AtomFromString, BENCHMARK_MICRO )
+{
+	Array< String > names;
+	MakeKeys( names, 256, "VRMenuObject_" );
+	for ( int i = 0; i < names.GetSizeI(); i++ )
+	{
+		ovrAtom atom( names[i] );
+		DoNotOptimize( atom );
+	}
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < names.GetSizeI(); i++ )
+		{
+			ovrAtom atom( names[i].ToCStr() );
+			DoNotOptimize( atom );
+		}
+	}
+	state.SetItemsPerIteration( 256 );
+}
+
+OVR_BENCHMARK( Kernel, ArrayPushBack, BENCHMARK_MICRO )
+{
+	while ( state.KeepRunning() )
+	{
+		Array< Vector3f > points;
+		for ( int i = 0; i < 1024; i++ )
+		{
+			points.PushBack( Vector3f( (float)i, 0.0f, 0.0f ) );
+		}
+		DoNotOptimize( points.GetDataPtr() );
+	}
+	state.SetItemsPerIteration( 1024 );
+}
+
+OVR_BENCHMARK( Kernel, MatrixMultiply, BENCHMARK_MICRO )
+{
+	ovrBenchmarkRandom random;
+	Matrix4f matrices[64];
+	for ( int i = 0; i < 64; i++ )
+	{
+		matrices[i] = Matrix4f::RotationY( random.NextFloat( 0.0f, MATH_FLOAT_TWOPI ) ) *
+				Matrix4f::Translation( random.NextFloat(), random.NextFloat(), random.NextFloat() );
+	}
+	while ( state.KeepRunning() )
+	{
+		Matrix4f m = Matrix4f::Identity();
+		for ( int i = 0; i < 64; i++ )
+		{
+			m = m * matrices[i];
+		}
+		DoNotOptimize( m );
+	}
+	state.SetItemsPerIteration( 64 );
+}
+
+// The allocators the allocator benchmarks are run with, by argument.
+enum ovrBenchmarkAllocator
+{
+	BENCHMARK_ALLOCATOR_DEFAULT,
+	BENCHMARK_ALLOCATOR_THREAD_CACHING,
+	BENCHMARK_ALLOCATOR_ARENA,
+	BENCHMARK_ALLOCATOR_TRACKING
+};
+
+// Installs an allocator as the global allocator while in scope. Most of these allocators put
+// a header in front of their blocks, so nothing allocated before it is installed may be
+// freed while it is, and the other way round.
+class ovrScopedAllocator
+{
+public:
+	explicit ovrScopedAllocator( Allocator * allocator ) :
+		Prev( Allocator::GetInstance() )
+	{
+		Allocator::setInstance( NULL );
+		Allocator::setInstance( allocator );
+	}
+	~ovrScopedAllocator()
+	{
+		Allocator::setInstance( NULL );
+		Allocator::setInstance( Prev );
+	}
+
+private:
+	Allocator *	Prev;
+};
+
+typedef void ( *ovrAllocatorWorkload )( const char * text );
+
+// Runs the workload with the argument's allocator installed. With the arena, every
+// iteration runs in its own scope, the way a frame or a load would.
+static void RunAllocatorWorkload( ovrBenchmarkState & state, ovrAllocatorWorkload workload, const char * text )
+{
+	Allocator * backing = Allocator::GetInstance();
+	ThreadCachingAllocator * caching = NULL;
+	ArenaAllocator * arena = NULL;
+	TrackingAllocator * tracking = NULL;
+	Allocator * allocator = backing;
+	switch ( state.GetArg() )
+	{
+		case BENCHMARK_ALLOCATOR_THREAD_CACHING:	allocator = caching = new ThreadCachingAllocator( backing ); break;
+		case BENCHMARK_ALLOCATOR_ARENA:				allocator = arena = new ArenaAllocator( backing, 16 * 1024 * 1024 ); break;
+		case BENCHMARK_ALLOCATOR_TRACKING:			allocator = tracking = new TrackingAllocator( backing ); break;
+		default: break;
+	}
+
+	{
+		ovrScopedAllocator installed( allocator );
+		while ( state.KeepRunning() )
+		{
+			if ( arena != NULL )
+			{
+				ArenaAllocator::Scope scope( *arena );
+				workload( text );
+			}
+			else
+			{
+				workload( text );
+			}
+		}
+	}
+
+	if ( caching != NULL )
+	{
+		ThreadCachingAllocator::Stats stats;
+		caching->GetStats( stats );
+		state.SetCounter( "chunkBytes", (double)stats.ChunkBytes );
+		delete caching;
+	}
+	if ( arena != NULL )
+	{
+		ArenaAllocator::Stats stats;
+		arena->GetStats( stats );
+		state.SetCounter( "highWaterBytes", (double)stats.HighWaterBytes );
+		state.SetCounter( "overflowAllocs", (double)stats.OverflowAllocs );
+		delete arena;
+	}
+	if ( tracking != NULL )
+	{
+		TrackingAllocator::Stats stats;
+		tracking->GetStats( stats );
+		state.SetCounter( "peakBytes", (double)stats.PeakBytes );
+		delete tracking;
+	}
+}
+
+static void JsonParseWorkload( const char * text )
+{
+	JSON * root = JSON::Parse( text );
+	DoNotOptimize( root );
+	root->Release();
+}
+
+// Builds the kind of paths a folder browser makes for its thumbnails.
+static void StringBuildWorkload( const char * )
+{
+	Array< String > strings;
+	StringBuffer joined;
+	for ( int i = 0; i < 500; i++ )
+	{
+		String s( "panel_" );
+		s += String::Format( "%d", i );
+		s += "/thumbnail.png";
+		strings.PushBack( s );
+		joined.AppendFormat( "%s;", s.ToCStr() );
+	}
+	DoNotOptimize( joined.ToCStr() );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, AllocatorJsonParse, BENCHMARK_MICRO, BENCHMARK_ALLOCATOR_DEFAULT,
+		BENCHMARK_ALLOCATOR_THREAD_CACHING, BENCHMARK_ALLOCATOR_ARENA, BENCHMARK_ALLOCATOR_TRACKING )
+{
+	const String json = MakeJsonDocument( 1024 );
+	RunAllocatorWorkload( state, JsonParseWorkload, json.ToCStr() );
+	state.SetBytesPerIteration( (double)json.GetSize() );
+}
+
+OVR_BENCHMARK_ARGS( Kernel, AllocatorStringBuild, BENCHMARK_MICRO, BENCHMARK_ALLOCATOR_DEFAULT,
+		BENCHMARK_ALLOCATOR_THREAD_CACHING, BENCHMARK_ALLOCATOR_ARENA, BENCHMARK_ALLOCATOR_TRACKING )
+{
+	RunAllocatorWorkload( state, StringBuildWorkload, NULL );
+	state.SetItemsPerIteration( 500 );
+}
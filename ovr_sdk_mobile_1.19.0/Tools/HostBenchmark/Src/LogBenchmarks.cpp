@@ -0,0 +1,184 @@
+/************************************************************************************
+
+Filename    :   LogBenchmarks.cpp
+Content     :   Checks and benchmarks of the synchronous and deferred log.
+Created     :   10/19/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <android/log.h>
+
+#include "Kernel/OVR_DeferredLog.h"
+#include "Kernel/OVR_LogUtils.h"
+#include "Kernel/OVR_Threads.h"
+#include "HostShims.h"
+
+using namespace OVR;
+
+// Half of a thread's ring, so that the writer keeps up and no message is written in place.
+static const int LOG_CALLS_PER_FLUSH = 128;
+
+// Drops every message in the host log, so that the benchmarks measure the cost to the
+// calling thread and not the terminal.
+class ovrSilentLog
+{
+public:
+	ovrSilentLog() : Priority( ovrHostShims::GetLogPriority() ) { ovrHostShims::SetLogPriority( ANDROID_LOG_SILENT ); }
+	~ovrSilentLog() { ovrHostShims::SetLogPriority( Priority ); }
+
+private:
+	int		Priority;
+};
+
+static void LogMessage( const int i, const char * path )
+{
+	OVR_LOG( "HostBenchmark message %d: %f %s", i, i * 0.5f, path );
+}
+
+static threadReturn_t LogThreadFunction( Thread *, void * data )
+{
+	const int first = *static_cast< const int * >( data );
+	for ( int i = first; i < first + LOG_CALLS_PER_FLUSH; i++ )
+	{
+		LogMessage( i, "deferred" );
+	}
+	return NULL;
+}
+
+// Formats and writes the message on the calling thread.
+OVR_BENCHMARK( Log, Synchronous, BENCHMARK_MICRO )
+{
+	ovrSilentLog silent;
+	int i = 0;
+	while ( state.KeepRunning() )
+	{
+		LogMessage( i++, "synchronous" );
+	}
+}
+
+// Copies the arguments into the calling thread's ring.
+OVR_BENCHMARK( Log, Deferred, BENCHMARK_MICRO )
+{
+	ovrSilentLog silent;
+	ovrDeferredLog::Start();
+	ovrDeferredLogStats before;
+	ovrDeferredLog::GetStats( before );
+
+	int i = 0;
+	while ( state.KeepRunning() )
+	{
+		LogMessage( i++, "deferred" );
+		if ( i % LOG_CALLS_PER_FLUSH == 0 )
+		{
+			state.PauseTiming();
+			ovrDeferredLog::Flush();
+			state.ResumeTiming();
+		}
+	}
+
+	ovrDeferredLog::Stop();
+	ovrDeferredLogStats after;
+	ovrDeferredLog::GetStats( after );
+	if ( i > 0 )
+	{
+		state.SetCounter( "synchronous", (double)( after.Synchronous - before.Synchronous ) / i );
+	}
+}
+
+// Four threads log at the same time, each into its own ring.
+OVR_BENCHMARK( Log, DeferredThreaded, BENCHMARK_MACRO )
+{
+	static const int NUM_THREADS = 4;
+	ovrSilentLog silent;
+	ovrDeferredLog::Start();
+
+	int first = 0;
+	while ( state.KeepRunning() )
+	{
+		int firsts[NUM_THREADS];
+		Thread * threads[NUM_THREADS];
+		for ( int i = 0; i < NUM_THREADS; i++ )
+		{
+			firsts[i] = first;
+			first += LOG_CALLS_PER_FLUSH;
+			threads[i] = new Thread( LogThreadFunction, &firsts[i] );
+			threads[i]->Start();
+		}
+		for ( int i = 0; i < NUM_THREADS; i++ )
+		{
+			threads[i]->Join();
+			delete threads[i];
+		}
+		state.PauseTiming();
+		ovrDeferredLog::Flush();
+		state.ResumeTiming();
+	}
+	state.SetItemsPerIteration( NUM_THREADS * LOG_CALLS_PER_FLUSH );
+
+	ovrDeferredLog::Stop();
+}
+
+// Stops the deferred log while threads are logging, and checks that every message that was
+// queued is written. Then checks that a warning is written only after the messages queued
+// before it.
+OVR_BENCHMARK( Log, DeferredMatches, BENCHMARK_MACRO )
+{
+	static const int NUM_THREADS = 4;
+	ovrSilentLog silent;
+
+	const char * error = NULL;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		ovrDeferredLogStats before;
+		ovrDeferredLog::GetStats( before );
+		ovrDeferredLog::Start();
+		int firsts[NUM_THREADS];
+		Thread * threads[NUM_THREADS];
+		for ( int i = 0; i < NUM_THREADS; i++ )
+		{
+			firsts[i] = i * LOG_CALLS_PER_FLUSH;
+			threads[i] = new Thread( LogThreadFunction, &firsts[i] );
+			threads[i]->Start();
+		}
+		ovrDeferredLog::Stop();
+		for ( int i = 0; i < NUM_THREADS; i++ )
+		{
+			threads[i]->Join();
+			delete threads[i];
+		}
+		ovrDeferredLogStats after;
+		ovrDeferredLog::GetStats( after );
+		if ( after.Written - before.Written != after.Enqueued - before.Enqueued )
+		{
+			error = "messages queued before Stop() were not written";
+			break;
+		}
+
+		ovrDeferredLog::GetStats( before );
+		ovrDeferredLog::Start();
+		for ( int i = 0; i < LOG_CALLS_PER_FLUSH; i++ )
+		{
+			LogMessage( i, "deferred" );
+		}
+		OVR_WARN( "HostBenchmark warning" );
+		ovrDeferredLog::GetStats( after );
+		ovrDeferredLog::Stop();
+		if ( after.Enqueued - before.Enqueued != LOG_CALLS_PER_FLUSH )
+		{
+			error = "informational messages were not deferred";
+		}
+		else if ( after.Written - before.Written != LOG_CALLS_PER_FLUSH )
+		{
+			error = "a warning was written before the messages queued before it";
+		}
+	}
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+	}
+}
@@ -0,0 +1,847 @@
+/************************************************************************************
+
+Filename    :   ModelBenchmarks.cpp
+Content     :   Benchmarks of model loading, culling, skinning, tracing and collision.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+#include "HostShims.h"
+
+#include <string.h>
+#include <math.h>
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Allocators.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Atom.h"
+#include "Kernel/OVR_String.h"
+#include "GlProgram.h"
+#include "SurfaceRender.h"
+#include "ModelFile.h"
+#include "ModelRender.h"
+#include "ModelTrace.h"
+#include "ModelCollision.h"
+
+using namespace OVR;
+
+//==============================================================
+// Synthetic glB files
+//==============================================================
+
+static const int NUM_GLB_MESHES = 16;
+
+static void AppendBytes( Array< uint8_t > & data, const void * bytes, const int numBytes )
+{
+	const int offset = data.GetSizeI();
+	data.Resize( offset + numBytes );
+	memcpy( &data[offset], bytes, numBytes );
+}
+
+static void AppendUInt32( Array< uint8_t > & data, const uint32_t value )
+{
+	AppendBytes( data, &value, sizeof( value ) );
+}
+
+// A glB file with numNodes nodes spread over a 200 meter cube around the origin, that share
+// NUM_GLB_MESHES grid meshes with positions, normals, texture coordinates and 16-bit indices.
+static void MakeGlbFile( Array< uint8_t > & glb, const int numNodes, const int gridSize )
+{
+	Array< uint8_t > bin;
+	StringBuffer meshes;
+	StringBuffer accessors;
+	StringBuffer bufferViews;
+
+	const int numVertices = ( gridSize + 1 ) * ( gridSize + 1 );
+	const int numIndices = gridSize * gridSize * 6;
+	for ( int m = 0; m < NUM_GLB_MESHES; m++ )
+	{
+		const float height = 0.1f * ( m + 1 );
+		const int positionOffset = bin.GetSizeI();
+		for ( int y = 0; y <= gridSize; y++ )
+		{
+			for ( int x = 0; x <= gridSize; x++ )
+			{
+				const float p[3] = { (float)x / gridSize - 0.5f, height * sinf( x * 0.7f + y * 0.3f ), (float)y / gridSize - 0.5f };
+				AppendBytes( bin, p, sizeof( p ) );
+			}
+		}
+		const int normalOffset = bin.GetSizeI();
+		for ( int i = 0; i < numVertices; i++ )
+		{
+			const float n[3] = { 0.0f, 1.0f, 0.0f };
+			AppendBytes( bin, n, sizeof( n ) );
+		}
+		const int uvOffset = bin.GetSizeI();
+		for ( int y = 0; y <= gridSize; y++ )
+		{
+			for ( int x = 0; x <= gridSize; x++ )
+			{
+				const float uv[2] = { (float)x / gridSize, (float)y / gridSize };
+				AppendBytes( bin, uv, sizeof( uv ) );
+			}
+		}
+		const int indexOffset = bin.GetSizeI();
+		for ( int y = 0; y < gridSize; y++ )
+		{
+			for ( int x = 0; x < gridSize; x++ )
+			{
+				const uint16_t v0 = (uint16_t)( y * ( gridSize + 1 ) + x );
+				const uint16_t v1 = (uint16_t)( v0 + 1 );
+				const uint16_t v2 = (uint16_t)( v0 + gridSize + 1 );
+				const uint16_t v3 = (uint16_t)( v2 + 1 );
+				const uint16_t quad[6] = { v0, v2, v1, v1, v2, v3 };
+				AppendBytes( bin, quad, sizeof( quad ) );
+			}
+		}
+		while ( ( bin.GetSizeI() & 3 ) != 0 )
+		{
+			bin.PushBack( 0 );
+		}
+
+		const int view = m * 4;
+		bufferViews.AppendFormat( "%s{ \"buffer\": 0, \"byteOffset\": %d, \"byteLength\": %d, \"target\": 34962 },"
+				"{ \"buffer\": 0, \"byteOffset\": %d, \"byteLength\": %d, \"target\": 34962 },"
+				"{ \"buffer\": 0, \"byteOffset\": %d, \"byteLength\": %d, \"target\": 34962 },"
+				"{ \"buffer\": 0, \"byteOffset\": %d, \"byteLength\": %d, \"target\": 34963 }",
+				( m > 0 ) ? "," : "",
+				positionOffset, numVertices * 12, normalOffset, numVertices * 12, uvOffset, numVertices * 8, indexOffset, numIndices * 2 );
+		accessors.AppendFormat( "%s{ \"bufferView\": %d, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\", \"min\": [ -0.5, %f, -0.5 ], \"max\": [ 0.5, %f, 0.5 ] },"
+				"{ \"bufferView\": %d, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC3\" },"
+				"{ \"bufferView\": %d, \"componentType\": 5126, \"count\": %d, \"type\": \"VEC2\" },"
+				"{ \"bufferView\": %d, \"componentType\": 5123, \"count\": %d, \"type\": \"SCALAR\" }",
+				( m > 0 ) ? "," : "",
+				view + 0, numVertices, -height, height, view + 1, numVertices, view + 2, numVertices, view + 3, numIndices );
+		meshes.AppendFormat( "%s{ \"name\": \"mesh_%d\", \"primitives\": [ { \"attributes\": { \"POSITION\": %d, \"NORMAL\": %d, \"TEXCOORD_0\": %d }, \"indices\": %d } ] }",
+				( m > 0 ) ? "," : "", m, view + 0, view + 1, view + 2, view + 3 );
+	}
+
+	ovrBenchmarkRandom random;
+	StringBuffer nodes;
+	StringBuffer sceneNodes;
+	for ( int i = 0; i < numNodes; i++ )
+	{
+		nodes.AppendFormat( "%s{ \"name\": \"node_%d\", \"mesh\": %d, \"translation\": [ %f, %f, %f ], \"scale\": [ 4.0, 4.0, 4.0 ] }",
+				( i > 0 ) ? "," : "", i, i % NUM_GLB_MESHES,
+				random.NextFloat( -100.0f, 100.0f ), random.NextFloat( -100.0f, 100.0f ), random.NextFloat( -100.0f, 100.0f ) );
+		sceneNodes.AppendFormat( "%s%d", ( i > 0 ) ? "," : "", i );
+	}
+
+	StringBuffer json;
+	json.AppendFormat( "{ \"asset\": { \"version\": \"2.0\", \"generator\": \"HostBenchmark\" },"
+			"\"buffers\": [ { \"byteLength\": %d } ], \"bufferViews\": [ %s ], \"accessors\": [ %s ],"
+			"\"meshes\": [ %s ], \"nodes\": [ %s ], \"scenes\": [ { \"name\": \"scene\", \"nodes\": [ %s ] } ], \"scene\": 0 }",
+			bin.GetSizeI(), bufferViews.ToCStr(), accessors.ToCStr(), meshes.ToCStr(), nodes.ToCStr(), sceneNodes.ToCStr() );
+	while ( ( json.GetSize() & 3 ) != 0 )
+	{
+		json += " ";
+	}
+
+	const int totalLength = 12 + 8 + (int)json.GetSize() + 8 + bin.GetSizeI();
+	glb.Clear();
+	AppendUInt32( glb, 0x46546C67 );	// "glTF"
+	AppendUInt32( glb, 2 );
+	AppendUInt32( glb, totalLength );
+	AppendUInt32( glb, (uint32_t)json.GetSize() );
+	AppendUInt32( glb, 0x4E4F534A );	// "JSON"
+	AppendBytes( glb, json.ToCStr(), (int)json.GetSize() );
+	AppendUInt32( glb, bin.GetSizeI() );
+	AppendUInt32( glb, 0x004E4942 );	// "BIN"
+	AppendBytes( glb, bin.GetDataPtr(), bin.GetSizeI() );
+}
+
+// The programs only need to exist, GL is stubbed out.
+static GlProgram BuildModelProgram()
+{
+	static const char * vertexShader =
+		"attribute highp vec4 Position;\n"
+		"void main() { gl_Position = TransformVertex( Position ); }\n";
+	static const char * fragmentShader =
+		"void main() { gl_FragColor = vec4( 1.0 ); }\n";
+	return GlProgram::Build( vertexShader, fragmentShader, NULL, 0 );
+}
+
+OVR_BENCHMARK_ARGS( Model, LoadGlb, BENCHMARK_MACRO, 64, 1024 )
+{
+	Array< uint8_t > glb;
+	MakeGlbFile( glb, state.GetArg(), 16 );
+	GlProgram program = BuildModelProgram();
+	const ModelGlPrograms programs( &program );
+	const MaterialParms materialParms;
+
+	const long long glCallsBefore = ovrHostShims::GetNumGlCalls();
+	long long iterations = 0;
+	while ( state.KeepRunning() )
+	{
+		ModelFile * model = LoadModelFileFromMemory( "benchmark.glb", glb.GetDataPtr(), glb.GetSizeI(), programs, materialParms );
+		if ( model == NULL )
+		{
+			state.SkipWithError( "LoadModelFileFromMemory failed" );
+			break;
+		}
+		delete model;
+		iterations++;
+	}
+	if ( iterations > 0 )
+	{
+		state.SetCounter( "glCalls", (double)( ovrHostShims::GetNumGlCalls() - glCallsBefore ) / iterations );
+
+		// One more load outside of the timed loop, so that counting does not slow the loads down.
+		AllocationCounter::Stats allocStats;
+		{
+			AllocationCounter counter;
+			delete LoadModelFileFromMemory( "benchmark.glb", glb.GetDataPtr(), glb.GetSizeI(), programs, materialParms );
+			allocStats = counter.GetStats();
+		}
+		int numAtoms = 0;
+		size_t atomBytes = 0;
+		ovrAtom::GetStats( numAtoms, atomBytes );
+		state.SetCounter( "allocsPerLoad", (double)allocStats.Allocs );
+		state.SetCounter( "allocBytesPerLoad", (double)allocStats.AllocBytes );
+		state.SetCounter( "atoms", numAtoms );
+	}
+	state.SetBytesPerIteration( glb.GetSizeI() );
+	GlProgram::Free( program );
+}
+
+OVR_BENCHMARK_ARGS( Model, BuildSurfaceList, BENCHMARK_MICRO, 256, 1024 )
+{
+	Array< uint8_t > glb;
+	MakeGlbFile( glb, state.GetArg(), 2 );
+	GlProgram program = BuildModelProgram();
+	const ModelGlPrograms programs( &program );
+	const MaterialParms materialParms;
+	ModelFile * model = LoadModelFileFromMemory( "benchmark.glb", glb.GetDataPtr(), glb.GetSizeI(), programs, materialParms );
+	if ( model == NULL )
+	{
+		state.SkipWithError( "LoadModelFileFromMemory failed" );
+		GlProgram::Free( program );
+		return;
+	}
+
+	ModelState modelState;
+	modelState.GenerateStateFromModelFile( model );
+	modelState.SetMatrix( Matrix4f::Identity() );
+	Array< ModelNodeState * > emitNodes;
+	for ( int i = 0; i < modelState.subSceneStates.GetSizeI(); i++ )
+	{
+		for ( int j = 0; j < modelState.subSceneStates[i].nodeStates.GetSizeI(); j++ )
+		{
+			modelState.nodeStates[modelState.subSceneStates[i].nodeStates[j]].AddNodesToEmitList( emitNodes );
+		}
+	}
+
+	const Matrix4f viewMatrix = Matrix4f::LookAtRH( Vector3f( 0.0f, 0.0f, 0.0f ), Vector3f( 0.3f, 0.1f, -1.0f ), Vector3f( 0.0f, 1.0f, 0.0f ) );
+	const Matrix4f projectionMatrix = Matrix4f::PerspectiveRH( DegreeToRad( 90.0f ), 1.0f, 0.1f, 1000.0f );
+	const Array< ovrDrawSurface > emitSurfaces;
+	Array< ovrDrawSurface > surfaceList;
+	while ( state.KeepRunning() )
+	{
+		surfaceList.Clear();
+		BuildModelSurfaceList( surfaceList, emitNodes, emitSurfaces, viewMatrix, projectionMatrix );
+		DoNotOptimize( surfaceList.GetDataPtr() );
+	}
+	state.SetItemsPerIteration( emitNodes.GetSizeI() );
+	state.SetCounter( "visible", surfaceList.GetSizeI() );
+
+	delete model;
+	GlProgram::Free( program );
+}
+
+static const int NUM_SKIN_SURFACES = 4;
+static const int NUM_SKIN_JOINTS = 32;
+
+enum ovrSkinPaletteMode
+{
+	SKIN_PALETTE_PER_SURFACE,		// no cache, the joint buffer of each surface is updated
+	SKIN_PALETTE_CACHED,			// one palette per character, calculated on the calling thread
+	SKIN_PALETTE_CACHED_WORKERS,	// one palette per character, calculated on worker threads
+	SKIN_PALETTE_CACHED_STATIC		// cached, and the characters do not move, so nothing is uploaded
+};
+
+// A root, a chain of joints and a skinned node with a few surfaces, like a character.
+static void MakeSkinnedModel( ModelFile & mf )
+{
+	mf.FileName = "SkinPaletteBenchmark";
+	mf.Models.Resize( 1 );
+	mf.Models[0].surfaces.Resize( NUM_SKIN_SURFACES );
+	for ( int i = 0; i < NUM_SKIN_SURFACES; i++ )
+	{
+		ovrSurfaceDef & surfaceDef = mf.Models[0].surfaces[i].surfaceDef;
+		surfaceDef.geo.localBounds = Bounds3f( Vector3f( -1.0f, 0.0f, -1.0f ), Vector3f( 1.0f, 2.0f, 1.0f ) );
+		surfaceDef.graphicsCommand.uniformJoints.Create( GLBUFFER_TYPE_UNIFORM, NUM_SKIN_JOINTS * sizeof( Matrix4f ), NULL );
+	}
+
+	mf.Nodes.Resize( NUM_SKIN_JOINTS + 2 );
+	for ( int j = 1; j <= NUM_SKIN_JOINTS; j++ )
+	{
+		mf.Nodes[j].parentIndex = j - 1;
+		mf.Nodes[j - 1].children.PushBack( j );
+		mf.Nodes[j].translation = Vector3f( 0.0f, 0.1f, 0.0f );
+	}
+	const int skinnedNode = NUM_SKIN_JOINTS + 1;
+	mf.Nodes[skinnedNode].parentIndex = 0;
+	mf.Nodes[0].children.PushBack( skinnedNode );
+	mf.Nodes[skinnedNode].skinIndex = 0;
+	mf.Nodes[skinnedNode].model = &mf.Models[0];
+
+	mf.Skins.Resize( 1 );
+	mf.Skins[0].skeletonRootIndex = 0;
+	for ( int j = 1; j <= NUM_SKIN_JOINTS; j++ )
+	{
+		mf.Skins[0].jointIndexes.PushBack( j );
+		mf.Skins[0].inverseBindMatrices.PushBack( Matrix4f::Translation( 0.0f, -0.1f * j, 0.0f ) );
+	}
+}
+
+static void AnimateSkinnedModel( ModelState & modelState, const float angle )
+{
+	for ( int j = 1; j <= NUM_SKIN_JOINTS; j++ )
+	{
+		modelState.nodeStates[j].rotation = Quatf( Vector3f( 0.0f, 0.0f, 1.0f ), angle * 0.1f );
+		modelState.nodeStates[j].CalculateLocalTransform();
+	}
+	modelState.nodeStates[0].RecalculateMatrix();
+}
+
+// Builds the surface list of a crowd of skinned characters every frame. The characters are
+// animated outside of the timed part, since the palettes only depend on the pose.
+static void RunSkinPalette( ovrBenchmarkState & state, const ovrSkinPaletteMode mode )
+{
+	const int numCharacters = state.GetArg();
+	ModelFile mf;
+	MakeSkinnedModel( mf );
+
+	Array< ModelState > modelStates;
+	modelStates.Resize( numCharacters );
+	Array< ModelNodeState * > emitNodes;
+	for ( int i = 0; i < numCharacters; i++ )
+	{
+		modelStates[i].GenerateStateFromModelFile( &mf );
+		modelStates[i].SetMatrix( Matrix4f::Translation( (float)( i % 10 ) - 4.5f, 0.0f, -2.0f - (float)( i / 10 ) ) );
+		emitNodes.PushBack( &modelStates[i].nodeStates[NUM_SKIN_JOINTS + 1] );
+	}
+
+	const Array< ovrDrawSurface > emitSurfaces;
+	const Matrix4f viewMatrix = Matrix4f::Translation( 0.0f, -1.7f, 0.0f );
+	const Matrix4f projectionMatrix = Matrix4f::PerspectiveRH( DegreeToRad( 90.0f ), 1.0f, 0.1f, 100.0f );
+	Array< ovrDrawSurface > surfaceList;
+
+	ovrSkinPaletteCache palettes( ( mode == SKIN_PALETTE_CACHED_WORKERS ) ? ovrSkinPaletteCache::DEFAULT_MAX_WORKERS : 0 );
+	ovrSkinPaletteCache * skinPalettes = ( mode != SKIN_PALETTE_PER_SURFACE ) ? &palettes : NULL;
+
+	int frame = 0;
+	while ( state.KeepRunning() )
+	{
+		if ( mode != SKIN_PALETTE_CACHED_STATIC || frame == 0 )
+		{
+			state.PauseTiming();
+			for ( int i = 0; i < numCharacters; i++ )
+			{
+				AnimateSkinnedModel( modelStates[i], (float)( frame + i ) * 0.01f );
+			}
+			state.ResumeTiming();
+		}
+		BuildModelSurfaceList( surfaceList, emitNodes, emitSurfaces, viewMatrix, projectionMatrix, skinPalettes );
+		DoNotOptimize( surfaceList.GetDataPtr() );
+		frame++;
+	}
+
+	state.SetItemsPerIteration( numCharacters );
+	state.SetCounter( "surfaces", surfaceList.GetSizeI() );
+	state.SetCounter( "uploads", ( skinPalettes != NULL ) ? skinPalettes->GetNumUploaded() : surfaceList.GetSizeI() );
+	palettes.Clear();
+}
+
+OVR_BENCHMARK_ARGS( Model, SkinPalettePerSurface, BENCHMARK_MICRO, 16, 64 )
+{
+	RunSkinPalette( state, SKIN_PALETTE_PER_SURFACE );
+}
+
+OVR_BENCHMARK_ARGS( Model, SkinPaletteCached, BENCHMARK_MICRO, 16, 64 )
+{
+	RunSkinPalette( state, SKIN_PALETTE_CACHED );
+}
+
+OVR_BENCHMARK_ARGS( Model, SkinPaletteCachedWorkers, BENCHMARK_MICRO, 16, 64 )
+{
+	RunSkinPalette( state, SKIN_PALETTE_CACHED_WORKERS );
+}
+
+OVR_BENCHMARK_ARGS( Model, SkinPaletteCachedStatic, BENCHMARK_MICRO, 16, 64 )
+{
+	RunSkinPalette( state, SKIN_PALETTE_CACHED_STATIC );
+}
+
+//==============================================================
+// ovrKdTreeBuilder
+// Builds the kd-tree of a ModelTrace the way the ovrscene exporter lays it out: children
+// are adjacent, leaves point at the neighbouring node through each face of their cell,
+// and leaves with more than RT_KDTREE_MAX_LEAF_TRIANGLES triangles continue in the
+// overflow array. Splits are at the middle of the longest axis of the cell.
+class ovrKdTreeBuilder
+{
+public:
+	explicit	ovrKdTreeBuilder( ModelTrace & trace ) : Trace( trace ) {}
+
+	void		Build()
+	{
+		const int numTriangles = Trace.indices.GetSizeI() / 3;
+		Bounds3f bounds;
+		bounds.Clear();
+		TriangleBounds.Resize( numTriangles );
+		Array< int > triangles;
+		triangles.Resize( numTriangles );
+		for ( int i = 0; i < numTriangles; i++ )
+		{
+			Bounds3f & b = TriangleBounds[i];
+			b.Clear();
+			for ( int j = 0; j < 3; j++ )
+			{
+				b.AddPoint( Trace.vertices[Trace.indices[i * 3 + j]] );
+			}
+			bounds = Bounds3f::Union( bounds, b );
+			triangles[i] = i;
+		}
+		bounds = Bounds3f::Expand( bounds, Vector3f( -0.01f ), Vector3f( 0.01f ) );
+
+		Trace.nodes.Clear();
+		Trace.leafs.Clear();
+		Trace.overflow.Clear();
+		Trace.nodes.PushDefault();
+		const int ropes[6] = { -1, -1, -1, -1, -1, -1 };
+		BuildNode( 0, bounds, triangles, ropes, 0 );
+
+		Trace.header.numVertices = Trace.vertices.GetSizeI();
+		Trace.header.numUvs = Trace.uvs.GetSizeI();
+		Trace.header.numIndices = Trace.indices.GetSizeI();
+		Trace.header.numNodes = Trace.nodes.GetSizeI();
+		Trace.header.numLeafs = Trace.leafs.GetSizeI();
+		Trace.header.numOverflow = Trace.overflow.GetSizeI();
+		Trace.header.bounds = bounds;
+	}
+
+private:
+	// Trace() visits at most 128 leaves, so the leaves hold more triangles than fit in
+	// kdtree_leaf_t and continue in the overflow array.
+	static const int	SPLIT_TRIANGLES = 16;
+	static const int	MAX_DEPTH = 24;
+
+	ModelTrace &		Trace;
+	Array< Bounds3f >	TriangleBounds;
+
+	void		BuildNode( const int nodeIndex, const Bounds3f & cell, const Array< int > & triangles, const int ropes[6], const int depth )
+	{
+		if ( triangles.GetSizeI() > SPLIT_TRIANGLES && depth < MAX_DEPTH )
+		{
+			// Split in the middle of the axis that leaves the fewest triangles on either side.
+			Array< int > left;
+			Array< int > right;
+			int axis = -1;
+			float split = 0.0f;
+			for ( int a = 0; a < 3; a++ )
+			{
+				const float s = ( cell.b[0][a] + cell.b[1][a] ) * 0.5f;
+				Array< int > l;
+				Array< int > r;
+				for ( int i = 0; i < triangles.GetSizeI(); i++ )
+				{
+					// Triangles that only touch the split plane go to one side.
+					const Bounds3f & b = TriangleBounds[triangles[i]];
+					if ( b.b[0][a] < s || b.b[1][a] <= s )
+					{
+						l.PushBack( triangles[i] );
+					}
+					if ( b.b[1][a] > s )
+					{
+						r.PushBack( triangles[i] );
+					}
+				}
+				if ( axis < 0 || Alg::Max( l.GetSizeI(), r.GetSizeI() ) < Alg::Max( left.GetSizeI(), right.GetSizeI() ) )
+				{
+					axis = a;
+					split = s;
+					left = l;
+					right = r;
+				}
+			}
+
+			// Stop when a split mostly duplicates triangles instead of separating them.
+			if ( Alg::Max( left.GetSizeI(), right.GetSizeI() ) <= triangles.GetSizeI() * 4 / 5 &&
+					left.GetSizeI() + right.GetSizeI() <= triangles.GetSizeI() * 5 / 4 )
+			{
+				const int child = Trace.nodes.GetSizeI();
+				Trace.nodes.PushDefault();
+				Trace.nodes.PushDefault();
+				Trace.nodes[nodeIndex].data = ( (unsigned int)child << 3 ) | ( (unsigned int)axis << 1 );
+				Trace.nodes[nodeIndex].dist = split;
+
+				Bounds3f leftCell = cell;
+				leftCell.b[1][axis] = split;
+				Bounds3f rightCell = cell;
+				rightCell.b[0][axis] = split;
+
+				int leftRopes[6];
+				int rightRopes[6];
+				memcpy( leftRopes, ropes, sizeof( leftRopes ) );
+				memcpy( rightRopes, ropes, sizeof( rightRopes ) );
+				leftRopes[axis * 2 + 1] = child + 1;
+				rightRopes[axis * 2 + 0] = child;
+
+				BuildNode( child + 0, leftCell, left, leftRopes, depth + 1 );
+				BuildNode( child + 1, rightCell, right, rightRopes, depth + 1 );
+				return;
+			}
+		}
+
+		const int leafIndex = Trace.leafs.GetSizeI();
+		Trace.leafs.PushDefault();
+		kdtree_leaf_t & leaf = Trace.leafs[leafIndex];
+		leaf.bounds = cell;
+		memcpy( leaf.ropes, ropes, sizeof( leaf.ropes ) );
+		for ( int i = 0; i < RT_KDTREE_MAX_LEAF_TRIANGLES; i++ )
+		{
+			leaf.triangles[i] = -1;
+		}
+		if ( triangles.GetSizeI() <= RT_KDTREE_MAX_LEAF_TRIANGLES )
+		{
+			for ( int i = 0; i < triangles.GetSizeI(); i++ )
+			{
+				leaf.triangles[i] = triangles[i];
+			}
+		}
+		else
+		{
+			leaf.triangles[0] = (int)( 0x80000000u | (unsigned int)Trace.overflow.GetSizeI() );
+			Trace.overflow.Append( triangles.GetDataPtr(), triangles.GetSize() );
+			Trace.overflow.PushBack( -1 );
+		}
+		Trace.nodes[nodeIndex].data = ( (unsigned int)leafIndex << 3 ) | 1;
+		Trace.nodes[nodeIndex].dist = 0.0f;
+	}
+};
+
+// A gridSize x gridSize heightfield of rolling hills, 100 meters across.
+static void MakeTerrainTrace( ModelTrace & trace, const int gridSize )
+{
+	trace.vertices.Resize( ( gridSize + 1 ) * ( gridSize + 1 ) );
+	trace.uvs.Resize( trace.vertices.GetSize() );
+	for ( int y = 0; y <= gridSize; y++ )
+	{
+		for ( int x = 0; x <= gridSize; x++ )
+		{
+			const float u = (float)x / gridSize;
+			const float v = (float)y / gridSize;
+			trace.vertices[y * ( gridSize + 1 ) + x] = Vector3f( u * 100.0f - 50.0f, 4.0f * sinf( u * 17.0f ) * cosf( v * 13.0f ), v * 100.0f - 50.0f );
+			trace.uvs[y * ( gridSize + 1 ) + x] = Vector2f( u, v );
+		}
+	}
+	trace.indices.Resize( gridSize * gridSize * 6 );
+	for ( int y = 0; y < gridSize; y++ )
+	{
+		for ( int x = 0; x < gridSize; x++ )
+		{
+			const int v0 = y * ( gridSize + 1 ) + x;
+			const int v2 = v0 + gridSize + 1;
+			int * quad = &trace.indices[( y * gridSize + x ) * 6];
+			quad[0] = v0;
+			quad[1] = v2;
+			quad[2] = v0 + 1;
+			quad[3] = v0 + 1;
+			quad[4] = v2;
+			quad[5] = v2 + 1;
+		}
+	}
+	ovrKdTreeBuilder( trace ).Build();
+}
+
+// Rays from above the terrain that go down at an angle, like gaze rays from a standing user.
+static const int NUM_TRACE_RAYS = 256;
+
+static void MakeTraceRays( Vector3f * starts, Vector3f * ends )
+{
+	ovrBenchmarkRandom random;
+	for ( int i = 0; i < NUM_TRACE_RAYS; i++ )
+	{
+		starts[i] = Vector3f( random.NextFloat( -45.0f, 45.0f ), 6.0f, random.NextFloat( -45.0f, 45.0f ) );
+		const Vector3f dir = Vector3f( random.NextFloat( -1.0f, 1.0f ), -random.NextFloat( 0.2f, 1.0f ), random.NextFloat( -1.0f, 1.0f ) ).Normalized();
+		ends[i] = starts[i] + dir * 80.0f;
+	}
+}
+
+OVR_BENCHMARK_ARGS( Model, KdTreeTrace, BENCHMARK_MICRO, 64, 256 )
+{
+	ModelTrace trace;
+	MakeTerrainTrace( trace, state.GetArg() );
+	Vector3f starts[NUM_TRACE_RAYS];
+	Vector3f ends[NUM_TRACE_RAYS];
+	MakeTraceRays( starts, ends );
+
+	// The kd-tree must find the same hits as testing every triangle.
+	for ( int i = 0; i < NUM_TRACE_RAYS; i += 8 )
+	{
+		const traceResult_t fast = trace.Trace( starts[i], ends[i] );
+		const traceResult_t exhaustive = trace.Trace_Exhaustive( starts[i], ends[i] );
+		if ( ( fast.triangleIndex < 0 ) != ( exhaustive.triangleIndex < 0 ) || fabsf( fast.fraction - exhaustive.fraction ) > 1e-4f )
+		{
+			state.SkipWithError( "the kd-tree trace does not match the exhaustive trace" );
+			return;
+		}
+	}
+
+	int numHits = 0;
+	while ( state.KeepRunning() )
+	{
+		numHits = 0;
+		for ( int i = 0; i < NUM_TRACE_RAYS; i++ )
+		{
+			const traceResult_t result = trace.Trace( starts[i], ends[i] );
+			numHits += ( result.triangleIndex >= 0 );
+		}
+		DoNotOptimize( numHits );
+	}
+	state.SetItemsPerIteration( NUM_TRACE_RAYS );
+	state.SetCounter( "hits", numHits );
+	state.SetCounter( "leafs", trace.leafs.GetSizeI() );
+}
+
+OVR_BENCHMARK_ARGS( Model, TraceExhaustive, BENCHMARK_MICRO, 64 )
+{
+	ModelTrace trace;
+	MakeTerrainTrace( trace, state.GetArg() );
+	Vector3f starts[NUM_TRACE_RAYS];
+	Vector3f ends[NUM_TRACE_RAYS];
+	MakeTraceRays( starts, ends );
+
+	static const int NUM_RAYS = 16;
+	while ( state.KeepRunning() )
+	{
+		int numHits = 0;
+		for ( int i = 0; i < NUM_RAYS; i++ )
+		{
+			const traceResult_t result = trace.Trace_Exhaustive( starts[i], ends[i] );
+			numHits += ( result.triangleIndex >= 0 );
+		}
+		DoNotOptimize( numHits );
+	}
+	state.SetItemsPerIteration( NUM_RAYS );
+}
+
+//==============================================================
+// Collision
+//==============================================================
+
+static void AddBoxPolytope( ModelCollision & collision, const Vector3f & mins, const Vector3f & maxs )
+{
+	collision.Polytopes.PushDefault();
+	CollisionPolytope & polytope = collision.Polytopes.Back();
+	polytope.Add( Planef( Vector3f( -1.0f, 0.0f, 0.0f ), mins.x ) );
+	polytope.Add( Planef( Vector3f( 1.0f, 0.0f, 0.0f ), -maxs.x ) );
+	polytope.Add( Planef( Vector3f( 0.0f, -1.0f, 0.0f ), mins.y ) );
+	polytope.Add( Planef( Vector3f( 0.0f, 1.0f, 0.0f ), -maxs.y ) );
+	polytope.Add( Planef( Vector3f( 0.0f, 0.0f, -1.0f ), mins.z ) );
+	polytope.Add( Planef( Vector3f( 0.0f, 0.0f, 1.0f ), -maxs.z ) );
+}
+
+// numBoxes pillars and walls scattered over a 100 meter floor.
+static void MakeCollisionScene( ModelCollision & collision, ModelCollision & ground, const int numBoxes )
+{
+	ovrBenchmarkRandom random;
+	for ( int i = 0; i < numBoxes; i++ )
+	{
+		const Vector3f center( random.NextFloat( -50.0f, 50.0f ), 0.0f, random.NextFloat( -50.0f, 50.0f ) );
+		const Vector3f extents( random.NextFloat( 0.2f, 2.0f ), random.NextFloat( 1.0f, 3.0f ), random.NextFloat( 0.2f, 2.0f ) );
+		AddBoxPolytope( collision, center - Vector3f( extents.x, 0.0f, extents.z ), center + extents );
+	}
+	AddBoxPolytope( ground, Vector3f( -60.0f, -1.0f, -60.0f ), Vector3f( 60.0f, 0.0f, 60.0f ) );
+}
+
+// numPolytopes rotated and tilted prisms with 5 to 10 sides, some without a top, so that
+// they are not bounded, scattered over a 200 meter floor.
+static void MakeTiltedCollisionScene( ModelCollision & collision, const int numPolytopes )
+{
+	ovrBenchmarkRandom random( 3 );
+	for ( int i = 0; i < numPolytopes; i++ )
+	{
+		const Vector3f center( random.NextFloat( -100.0f, 100.0f ), random.NextFloat( 0.0f, 2.0f ), random.NextFloat( -100.0f, 100.0f ) );
+		const Quatf rotation = Quatf( Vector3f( 0.0f, 1.0f, 0.0f ), random.NextFloat( 0.0f, MATH_FLOAT_TWOPI ) ) *
+				Quatf( Vector3f( 1.0f, 0.0f, 0.0f ), random.NextFloat( -0.3f, 0.3f ) );
+		const int numSides = 5 + ( random.NextUInt() % 6 );
+		const float radius = random.NextFloat( 0.2f, 2.0f );
+		const float height = random.NextFloat( 0.5f, 3.0f );
+
+		collision.Polytopes.PushDefault();
+		CollisionPolytope & polytope = collision.Polytopes.Back();
+		for ( int j = 0; j < numSides; j++ )
+		{
+			const float angle = j * MATH_FLOAT_TWOPI / numSides;
+			const Vector3f normal = rotation.Rotate( Vector3f( cosf( angle ), 0.0f, sinf( angle ) ) );
+			polytope.Add( Planef( center + normal * radius, normal ) );
+		}
+		const Vector3f up = rotation.Rotate( Vector3f( 0.0f, 1.0f, 0.0f ) );
+		polytope.Add( Planef( center - up * height, -up ) );
+		if ( ( i % 64 ) != 0 )
+		{
+			polytope.Add( Planef( center + up * height, up ) );
+		}
+	}
+}
+
+// Checks that the collision tree gives the same results as testing every polytope. The
+// time is mostly the brute force tests.
+OVR_BENCHMARK( Model, CollisionTreeMatches, BENCHMARK_MACRO )
+{
+	ModelCollision collision;
+	MakeTiltedCollisionScene( collision, 10000 );
+	ModelCollision ground;
+	AddBoxPolytope( ground, Vector3f( -110.0f, -1.0f, -110.0f ), Vector3f( 110.0f, 0.0f, 110.0f ) );
+	ModelCollision treeCollision = collision;
+	treeCollision.BuildTree();
+	ModelCollision treeGround = ground;
+	treeGround.BuildTree();
+
+	static const int NUM_QUERIES = 512;
+	ovrBenchmarkRandom random( 5 );
+	int numHits = 0;
+	while ( state.KeepRunning() )
+	{
+		numHits = 0;
+		for ( int i = 0; i < NUM_QUERIES; i++ )
+		{
+			const Vector3f p( random.NextFloat( -100.0f, 100.0f ), random.NextFloat( 0.0f, 4.0f ), random.NextFloat( -100.0f, 100.0f ) );
+			const Vector3f dir = Vector3f( random.NextFloat( -1.0f, 1.0f ), random.NextFloat( -0.2f, 0.2f ), random.NextFloat( -1.0f, 1.0f ) ).Normalized();
+			const float distance = random.NextFloat( 0.0f, 4.0f );
+
+			numHits += collision.TestPoint( p );
+			if ( collision.TestPoint( p ) != treeCollision.TestPoint( p ) )
+			{
+				state.SkipWithError( "TestPoint differs" );
+				return;
+			}
+
+			float length = distance;
+			float treeLength = distance;
+			Planef plane;
+			Planef treePlane;
+			const bool hit = collision.TestRay( p, dir, length, &plane );
+			if ( hit != treeCollision.TestRay( p, dir, treeLength, &treePlane ) ||
+					memcmp( &length, &treeLength, sizeof( length ) ) != 0 ||
+					( hit && memcmp( &plane, &treePlane, sizeof( plane ) ) != 0 ) )
+			{
+				state.SkipWithError( "TestRay differs" );
+				return;
+			}
+
+			Vector3f popped = p;
+			Vector3f treePopped = p;
+			if ( collision.PopOut( popped ) != treeCollision.PopOut( treePopped ) ||
+					memcmp( &popped, &treePopped, sizeof( popped ) ) != 0 )
+			{
+				state.SkipWithError( "PopOut differs" );
+				return;
+			}
+
+			const Vector3f foot( p.x, 0.0f, p.z );
+			const Vector3f moved = SlideMove( foot, 1.6f, dir, distance * 0.1f, collision, ground );
+			const Vector3f treeMoved = SlideMove( foot, 1.6f, dir, distance * 0.1f, treeCollision, treeGround );
+			if ( memcmp( &moved, &treeMoved, sizeof( moved ) ) != 0 )
+			{
+				state.SkipWithError( "SlideMove differs" );
+				return;
+			}
+		}
+	}
+	state.SetItemsPerIteration( NUM_QUERIES );
+	state.SetCounter( "inside", numHits );
+}
+
+static void RunCollisionTestRay( ovrBenchmarkState & state, const bool buildTree )
+{
+	ModelCollision collision;
+	ModelCollision ground;
+	MakeCollisionScene( collision, ground, state.GetArg() );
+	if ( buildTree )
+	{
+		collision.BuildTree();
+	}
+
+	static const int NUM_RAYS = 64;
+	Vector3f starts[NUM_RAYS];
+	Vector3f dirs[NUM_RAYS];
+	ovrBenchmarkRandom random( 7 );
+	for ( int i = 0; i < NUM_RAYS; i++ )
+	{
+		starts[i] = Vector3f( random.NextFloat( -50.0f, 50.0f ), 1.6f, random.NextFloat( -50.0f, 50.0f ) );
+		dirs[i] = Vector3f( random.NextFloat( -1.0f, 1.0f ), 0.0f, random.NextFloat( -1.0f, 1.0f ) ).Normalized();
+	}
+
+	int numHits = 0;
+	while ( state.KeepRunning() )
+	{
+		numHits = 0;
+		for ( int i = 0; i < NUM_RAYS; i++ )
+		{
+			float length = 20.0f;
+			numHits += collision.TestRay( starts[i], dirs[i], length, NULL );
+		}
+		DoNotOptimize( numHits );
+	}
+	state.SetItemsPerIteration( NUM_RAYS );
+	state.SetCounter( "hits", numHits );
+}
+
+OVR_BENCHMARK_ARGS( Model, CollisionTestRay, BENCHMARK_MICRO, 64, 1024, 10000 )
+{
+	RunCollisionTestRay( state, true );
+}
+
+OVR_BENCHMARK_ARGS( Model, CollisionTestRayBruteForce, BENCHMARK_MICRO, 64, 1024, 10000 )
+{
+	RunCollisionTestRay( state, false );
+}
+
+static void RunSlideMoves( ovrBenchmarkState & state, const bool buildTree )
+{
+	ModelCollision collision;
+	ModelCollision ground;
+	MakeCollisionScene( collision, ground, state.GetArg() );
+	if ( buildTree )
+	{
+		collision.BuildTree();
+		ground.BuildTree();
+	}
+
+	static const int NUM_MOVES = 64;
+	SlideMover movers[NUM_MOVES];
+	ovrBenchmarkRandom random( 11 );
+	for ( int i = 0; i < NUM_MOVES; i++ )
+	{
+		movers[i].FootPos = Vector3f( random.NextFloat( -50.0f, 50.0f ), 0.0f, random.NextFloat( -50.0f, 50.0f ) );
+		movers[i].EyeHeight = 1.6f;
+		movers[i].MoveDirection = Vector3f( random.NextFloat( -1.0f, 1.0f ), 0.0f, random.NextFloat( -1.0f, 1.0f ) ).Normalized();
+		movers[i].MoveDistance = 0.05f;
+	}
+
+	while ( state.KeepRunning() )
+	{
+		SlideMover moved[NUM_MOVES];
+		memcpy( moved, movers, sizeof( movers ) );
+		SlideMoves( moved, NUM_MOVES, collision, ground );
+		DoNotOptimize( moved );
+	}
+	state.SetItemsPerIteration( NUM_MOVES );
+}
+
+OVR_BENCHMARK_ARGS( Model, SlideMove, BENCHMARK_MICRO, 64, 1024, 10000 )
+{
+	RunSlideMoves( state, true );
+}
+
+OVR_BENCHMARK_ARGS( Model, SlideMoveBruteForce, BENCHMARK_MICRO, 64, 1024, 10000 )
+{
+	RunSlideMoves( state, false );
+}
@@ -0,0 +1,1102 @@
+/************************************************************************************
+
+Filename    :   PackageBenchmarks.cpp
+Content     :   Benchmarks of reading whole files from a package, and of writing cache packs.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Std.h"
+#include "OVR_PackWriter.h"
+#include "PackageFiles.h"
+#include "unzip.h"
+#include "zip.h"
+
+using namespace OVR;
+
+//==============================================================
+// Package
+// A package with the kinds of files that are loaded whole at startup: text like json and
+// shaders, vertex data and already compressed images, which are stored. The package is in
+// the page cache after the first run, so these measure the decompression.
+//==============================================================
+
+static const int NUM_PACKAGE_FILES = 20;
+
+static bool IsStoredPackageFile( const int index ) { return ( index % 5 ) == 4; }
+
+// Text like json and shaders, made of random words.
+static void MakeText( ovrBenchmarkRandom & random, uint8_t * data, const int length )
+{
+	static const char * words[] = { "\"name\": ", "\"uri\": ", "{ ", " }", ", ", "vec4 ", "uniform ",
+									"texture2D( ", "0.5", "1.0", "\n\t", "assets/", ".ktx", "true", "null" };
+	for ( int i = 0; i < length; )
+	{
+		const char * word = words[random.NextUInt() % ( sizeof( words ) / sizeof( words[0] ) )];
+		for ( ; *word != '\0' && i < length; word++, i++ )
+		{
+			data[i] = (uint8_t)*word;
+		}
+	}
+}
+
+static void MakePackageFile( const int index, Array< uint8_t > & data )
+{
+	ovrBenchmarkRandom random( 17 + index );
+	data.Resize( ( 64 * 1024 ) << ( index % 5 ) );
+	if ( IsStoredPackageFile( index ) )
+	{
+		for ( int i = 0; i < data.GetSizeI(); i++ )
+		{
+			data[i] = (uint8_t)( random.NextUInt() >> 24 );
+		}
+	}
+	else if ( ( index & 1 ) == 0 )
+	{
+		MakeText( random, data.GetDataPtr(), data.GetSizeI() );
+	}
+	else
+	{
+		// positions on a grid with noisy normals
+		float * floats = (float *)data.GetDataPtr();
+		for ( int i = 0; i < data.GetSizeI() / 4; i++ )
+		{
+			floats[i] = ( i % 6 ) < 3 ? (float)( ( i / 6 ) % 64 ) : random.NextFloat( -1.0f, 1.0f );
+		}
+	}
+}
+
+static const char * GetPackageFileName( const int index, char ( &name )[64] )
+{
+	OVR_sprintf( name, sizeof( name ), "assets/file_%02d.bin", index );
+	return name;
+}
+
+// A temporary package with NUM_PACKAGE_FILES files, written once.
+class ovrBenchmarkFilePackage
+{
+public:
+	ovrBenchmarkFilePackage()
+		: UncompressedSize( 0 )
+	{
+		OVR_strcpy( Path, sizeof( Path ), "/tmp/ovr_benchmark_XXXXXX.zip" );
+		const int fd = mkstemps( Path, 4 );
+		if ( fd < 0 )
+		{
+			Path[0] = '\0';
+			return;
+		}
+		close( fd );
+
+		zipFile zip = zipOpen( Path, APPEND_STATUS_CREATE );
+		if ( zip == NULL )
+		{
+			return;
+		}
+		const zip_fileinfo info = {};
+		Array< uint8_t > data;
+		for ( int i = 0; i < NUM_PACKAGE_FILES; i++ )
+		{
+			MakePackageFile( i, data );
+			char name[64];
+			const int method = IsStoredPackageFile( i ) ? 0 : Z_DEFLATED;
+			zipOpenNewFileInZip( zip, GetPackageFileName( i, name ), &info, NULL, 0, NULL, 0, NULL, method,
+					method == 0 ? 0 : Z_DEFAULT_COMPRESSION );
+			zipWriteInFileInZip( zip, data.GetDataPtr(), data.GetSizeI() );
+			zipCloseFileInZip( zip );
+			UncompressedSize += data.GetSizeI();
+		}
+		zipClose( zip, NULL );
+	}
+
+	// Runs after OVR::System::Destroy(), so this does not allocate.
+	~ovrBenchmarkFilePackage()
+	{
+		if ( Path[0] != '\0' )
+		{
+			unlink( Path );
+		}
+	}
+
+	bool			IsValid() const { return UncompressedSize > 0; }
+	const char *	GetPath() const { return Path; }
+	size_t			GetUncompressedSize() const { return UncompressedSize; }
+
+private:
+	char			Path[64];
+	size_t			UncompressedSize;
+};
+
+static const ovrBenchmarkFilePackage & GetPackage()
+{
+	static ovrBenchmarkFilePackage package;
+	return package;
+}
+
+typedef int ( *ovrReadCurrentFileFunc )( unzFile file, voidp buf, unsigned len );
+
+// Reads every file of the package into its own buffer, the way
+// ovr_ReadFileFromOtherApplicationPackage() does.
+static bool ReadPackageFiles( void * zip, ovrReadCurrentFileFunc readCurrentFile, Array< uint8_t > & buffer )
+{
+	for ( int i = 0; i < NUM_PACKAGE_FILES; i++ )
+	{
+		char name[64];
+		unz_file_info info;
+		if ( unzLocateFile( zip, GetPackageFileName( i, name ), 2 ) != UNZ_OK ||
+				unzGetCurrentFileInfo( zip, &info, NULL, 0, NULL, 0, NULL, 0 ) != UNZ_OK ||
+				unzOpenCurrentFile( zip ) != UNZ_OK )
+		{
+			return false;
+		}
+		buffer.Resize( info.uncompressed_size );
+		const int readRet = readCurrentFile( zip, buffer.GetDataPtr(), buffer.GetSizeI() );
+		if ( unzCloseCurrentFile( zip ) != UNZ_OK || readRet != buffer.GetSizeI() )
+		{
+			return false;
+		}
+		DoNotOptimize( buffer[buffer.GetSizeI() - 1] );
+	}
+	return true;
+}
+
+static void BenchmarkReadPackageFiles( ovrBenchmarkState & state, ovrReadCurrentFileFunc readCurrentFile )
+{
+	const ovrBenchmarkFilePackage & package = GetPackage();
+	void * zip = package.IsValid() ? ovr_OpenOtherApplicationPackage( package.GetPath() ) : NULL;
+	if ( zip == NULL )
+	{
+		state.SkipWithError( "could not write the package" );
+		return;
+	}
+	Array< uint8_t > buffer;
+	bool read = true;
+	while ( state.KeepRunning() && read )
+	{
+		read = ReadPackageFiles( zip, readCurrentFile, buffer );
+	}
+	ovr_CloseOtherApplicationPackage( zip );
+	if ( !read )
+	{
+		state.SkipWithError( "could not read the package" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_PACKAGE_FILES );
+	state.SetBytesPerIteration( (double)package.GetUncompressedSize() );
+}
+
+// The chunked unzReadCurrentFile(), which inflates a 16 kB input buffer at a time.
+OVR_BENCHMARK( Package, ReadCurrentFile, BENCHMARK_MACRO )
+{
+	BenchmarkReadPackageFiles( state, unzReadCurrentFile );
+}
+
+// unzReadCurrentFileBulk(), which inflates straight into the file buffer.
+OVR_BENCHMARK( Package, ReadCurrentFileBulk, BENCHMARK_MACRO )
+{
+	BenchmarkReadPackageFiles( state, unzReadCurrentFileBulk );
+}
+
+// ovr_ReadFilesFromOtherApplicationPackage() with the given number of threads besides
+// the calling one.
+OVR_BENCHMARK_ARGS( Package, ReadFiles, BENCHMARK_MACRO, 0, 1, 3 )
+{
+	const ovrBenchmarkFilePackage & package = GetPackage();
+	void * zip = package.IsValid() ? ovr_OpenOtherApplicationPackage( package.GetPath() ) : NULL;
+	if ( zip == NULL )
+	{
+		state.SkipWithError( "could not write the package" );
+		return;
+	}
+	char names[NUM_PACKAGE_FILES][64];
+	ovrPackageFileRead files[NUM_PACKAGE_FILES];
+	for ( int i = 0; i < NUM_PACKAGE_FILES; i++ )
+	{
+		files[i].NameInZip = GetPackageFileName( i, names[i] );
+	}
+	bool read = true;
+	while ( state.KeepRunning() && read )
+	{
+		read = ovr_ReadFilesFromOtherApplicationPackage( zip, files, NUM_PACKAGE_FILES, state.GetArg() );
+	}
+	ovr_CloseOtherApplicationPackage( zip );
+	if ( !read )
+	{
+		state.SkipWithError( "could not read the package" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_PACKAGE_FILES );
+	state.SetBytesPerIteration( (double)package.GetUncompressedSize() );
+}
+
+// Copies the package with one byte of the data of a file flipped.
+static bool WriteCorruptPackage( const char * path, const size_t offset, char ( &corruptPath )[64] )
+{
+	FILE * f = fopen( path, "rb" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+	Array< uint8_t > data;
+	fseek( f, 0, SEEK_END );
+	data.Resize( ftell( f ) );
+	fseek( f, 0, SEEK_SET );
+	const bool read = fread( data.GetDataPtr(), 1, data.GetSizeI(), f ) == data.GetSize();
+	fclose( f );
+	if ( !read || offset >= data.GetSize() )
+	{
+		return false;
+	}
+	data[offset] ^= 0x10;
+
+	OVR_strcpy( corruptPath, sizeof( corruptPath ), "/tmp/ovr_benchmark_XXXXXX.zip" );
+	const int fd = mkstemps( corruptPath, 4 );
+	if ( fd < 0 )
+	{
+		return false;
+	}
+	const bool written = write( fd, data.GetDataPtr(), data.GetSize() ) == (ssize_t)data.GetSize();
+	close( fd );
+	return written;
+}
+
+// Checks that every way of reading gives the files that were written, and that a flipped
+// byte in a stored file fails the CRC check.
+OVR_BENCHMARK( Package, Matches, BENCHMARK_MICRO )
+{
+	const ovrBenchmarkFilePackage & package = GetPackage();
+	void * zip = package.IsValid() ? ovr_OpenOtherApplicationPackage( package.GetPath() ) : NULL;
+	if ( zip == NULL )
+	{
+		state.SkipWithError( "could not write the package" );
+		return;
+	}
+
+	const int STORED_FILE = 4;
+	char names[NUM_PACKAGE_FILES][64];
+	ovrPackageFileRead files[NUM_PACKAGE_FILES];
+	for ( int i = 0; i < NUM_PACKAGE_FILES; i++ )
+	{
+		files[i].NameInZip = GetPackageFileName( i, names[i] );
+	}
+	size_t storedOffset = 0;
+	size_t storedLength = 0;
+	const bool stored = ovr_GetStoredFileRangeInPackage( zip, files[STORED_FILE].NameInZip, storedOffset, storedLength );
+
+	const char * error = NULL;
+	Array< uint8_t > data;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		if ( !ovr_ReadFilesFromOtherApplicationPackage( zip, files, NUM_PACKAGE_FILES, 2 ) )
+		{
+			error = "ovr_ReadFilesFromOtherApplicationPackage() failed";
+			break;
+		}
+		for ( int i = 0; i < NUM_PACKAGE_FILES && error == NULL; i++ )
+		{
+			MakePackageFile( i, data );
+			MemBufferT< uint8_t > single;
+			if ( !ovr_ReadFileFromOtherApplicationPackage( zip, files[i].NameInZip, single ) )
+			{
+				error = "ovr_ReadFileFromOtherApplicationPackage() failed";
+			}
+			else if ( files[i].Buffer.GetSize() != data.GetSize() ||
+					memcmp( (const uint8_t *)files[i].Buffer, data.GetDataPtr(), data.GetSize() ) != 0 )
+			{
+				error = "ovr_ReadFilesFromOtherApplicationPackage() read the wrong data";
+			}
+			else if ( single.GetSize() != data.GetSize() ||
+					memcmp( (const uint8_t *)single, data.GetDataPtr(), data.GetSize() ) != 0 )
+			{
+				error = "ovr_ReadFileFromOtherApplicationPackage() read the wrong data";
+			}
+		}
+		if ( error == NULL && unzCrc32( 0, data.GetDataPtr(), data.GetSize() ) != crc32( 0, data.GetDataPtr(), data.GetSize() ) )
+		{
+			error = "unzCrc32() differs from crc32()";
+		}
+	}
+	ovr_CloseOtherApplicationPackage( zip );
+
+	char corruptPath[64] = {};
+	if ( error == NULL && !stored )
+	{
+		error = "the stored file is not stored";
+	}
+	else if ( error == NULL && !WriteCorruptPackage( package.GetPath(), storedOffset + storedLength / 2, corruptPath ) )
+	{
+		error = "could not write the corrupt package";
+	}
+	else if ( error == NULL )
+	{
+		void * corruptZip = ovr_OpenOtherApplicationPackage( corruptPath );
+		if ( corruptZip == NULL )
+		{
+			error = "could not open the corrupt package";
+		}
+		else
+		{
+			data.Resize( storedLength );
+			if ( unzLocateFile( corruptZip, files[STORED_FILE].NameInZip, 2 ) != UNZ_OK ||
+					unzOpenCurrentFile( corruptZip ) != UNZ_OK )
+			{
+				error = "could not open the corrupt file";
+			}
+			else
+			{
+				if ( unzReadCurrentFileBulk( corruptZip, data.GetDataPtr(), data.GetSizeI() ) != UNZ_CRCERROR )
+				{
+					error = "unzReadCurrentFileBulk() did not fail the CRC check";
+				}
+				unzCloseCurrentFile( corruptZip );
+			}
+			if ( error == NULL )
+			{
+				if ( ovr_ReadFilesFromOtherApplicationPackage( corruptZip, files, NUM_PACKAGE_FILES, 2 ) )
+				{
+					error = "ovr_ReadFilesFromOtherApplicationPackage() did not fail the CRC check";
+				}
+				else if ( files[STORED_FILE].Buffer.GetSize() != 0 || files[0].Buffer.GetSize() == 0 )
+				{
+					error = "ovr_ReadFilesFromOtherApplicationPackage() kept the wrong files";
+				}
+			}
+			ovr_CloseOtherApplicationPackage( corruptZip );
+		}
+		unlink( corruptPath );
+	}
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+	}
+}
+
+//==============================================================
+// PackWriter
+// A cache of 10k small generated files, like thumbnail metadata and cooked assets, written
+// as loose files and as a pack by ovrPackWriter. A quarter of them are JPEGs, which the pack
+// stores. The cold reads drop the files from the page cache first, but the directory
+// entries of the loose files stay cached, so they understate what the pack saves on a
+// device.
+//==============================================================
+
+static const int NUM_CACHE_ENTRIES = 10000;
+static const int NUM_APPENDED_ENTRIES = 100;
+static const int NUM_CACHE_LOOKUPS = 100;
+
+static const char * CACHE_PACK = "cache.zip";
+static const char * APPEND_PACK = "append.zip";
+static const char * CHECK_PACK = "check.zip";
+static const char * COMPACT_PACK = "compact.zip";
+
+static bool IsCacheImage( const int index ) { return ( index % 4 ) == 3; }
+
+static const char * GetCacheEntryName( const char * folder, const int index, char ( &name )[64] )
+{
+	OVR_sprintf( name, sizeof( name ), "%s/%05d.%s", folder, index, IsCacheImage( index ) ? "jpg" : "json" );
+	return name;
+}
+
+// The entries one after another, where entry i starts at offsets[i].
+static void MakeCacheEntries( const int numEntries, Array< uint8_t > & data, Array< int > & offsets )
+{
+	ovrBenchmarkRandom random( 31 );
+	offsets.Resize( numEntries + 1 );
+	offsets[0] = 0;
+	for ( int i = 0; i < numEntries; i++ )
+	{
+		offsets[i + 1] = offsets[i] + 512 + (int)( random.NextUInt() % 3584 );
+	}
+	data.Resize( offsets[numEntries] );
+	for ( int i = 0; i < numEntries; i++ )
+	{
+		uint8_t * entry = data.GetDataPtr() + offsets[i];
+		const int length = offsets[i + 1] - offsets[i];
+		if ( IsCacheImage( i ) )
+		{
+			for ( int j = 0; j < length; j++ )
+			{
+				entry[j] = (uint8_t)( random.NextUInt() >> 24 );
+			}
+		}
+		else
+		{
+			MakeText( random, entry, length );
+		}
+	}
+}
+
+static bool WriteLooseFile( const char * path, const uint8_t * data, const size_t length )
+{
+	FILE * f = fopen( path, "wb" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+	const bool written = fwrite( data, 1, length, f ) == length;
+	return fclose( f ) == 0 && written;
+}
+
+static bool ReadLooseFile( const char * path, Array< uint8_t > & buffer )
+{
+	FILE * f = fopen( path, "rb" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+	fseek( f, 0, SEEK_END );
+	buffer.Resize( ftell( f ) );
+	fseek( f, 0, SEEK_SET );
+	const bool read = fread( buffer.GetDataPtr(), 1, buffer.GetSize(), f ) == buffer.GetSize();
+	fclose( f );
+	return read;
+}
+
+// Adds entries [first, first + count) under folder.
+static bool AddCacheEntries( ovrPackWriter & writer, const char * folder, const int first, const int count,
+		const Array< uint8_t > & data, const Array< int > & offsets )
+{
+	for ( int i = first; i < first + count; i++ )
+	{
+		char name[64];
+		if ( !writer.AddFile( GetCacheEntryName( folder, i, name ), data.GetDataPtr() + offsets[i], offsets[i + 1] - offsets[i] ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool WriteCachePack( const char * path, const bool append, const int numThreads, const char * folder,
+		const int count, const Array< uint8_t > & data, const Array< int > & offsets )
+{
+	ovrPackWriter writer;
+	if ( !writer.Open( path, append, numThreads ) )
+	{
+		return false;
+	}
+	if ( !AddCacheEntries( writer, folder, 0, count, data, offsets ) )
+	{
+		writer.Abort();
+		return false;
+	}
+	return writer.Close();
+}
+
+// Writes back and drops the pages of the file from the page cache.
+static void EvictFile( const char * path )
+{
+	const int fd = open( path, O_RDONLY );
+	if ( fd >= 0 )
+	{
+		fdatasync( fd );
+		posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+		close( fd );
+	}
+}
+
+static long long GetFileLength( const char * path )
+{
+	struct stat st;
+	return ( stat( path, &st ) == 0 ) ? (long long)st.st_size : -1;
+}
+
+// A temporary folder with the cache written once as loose files and as a pack.
+class ovrBenchmarkCacheFolder
+{
+public:
+	ovrBenchmarkCacheFolder()
+		: CacheSize( 0 )
+	{
+		OVR_strcpy( Path, sizeof( Path ), "/tmp/ovr_benchmark_XXXXXX" );
+		if ( mkdtemp( Path ) == NULL )
+		{
+			Path[0] = '\0';
+			return;
+		}
+		Array< uint8_t > data;
+		Array< int > offsets;
+		MakeCacheEntries( NUM_CACHE_ENTRIES, data, offsets );
+		char path[128];
+		for ( int i = 0; i < NUM_CACHE_ENTRIES; i++ )
+		{
+			if ( !WriteLooseFile( GetLoosePath( i, path ), data.GetDataPtr() + offsets[i], offsets[i + 1] - offsets[i] ) )
+			{
+				return;
+			}
+		}
+		if ( WriteCachePack( GetFilePath( CACHE_PACK, path ), false, ovrPackWriter::DEFAULT_NUM_THREADS, "cache",
+				NUM_CACHE_ENTRIES, data, offsets ) )
+		{
+			CacheSize = data.GetSize();
+		}
+	}
+
+	// Runs after OVR::System::Destroy(), so this does not allocate.
+	~ovrBenchmarkCacheFolder()
+	{
+		if ( Path[0] == '\0' )
+		{
+			return;
+		}
+		char path[128];
+		for ( int i = 0; i < NUM_CACHE_ENTRIES; i++ )
+		{
+			unlink( GetLoosePath( i, path ) );
+		}
+		const char * packs[] = { CACHE_PACK, APPEND_PACK, CHECK_PACK, COMPACT_PACK };
+		for ( size_t i = 0; i < sizeof( packs ) / sizeof( packs[0] ); i++ )
+		{
+			unlink( GetFilePath( packs[i], path ) );
+			OVR_strcat( path, sizeof( path ), ".tmp" );
+			unlink( path );
+		}
+		rmdir( Path );
+	}
+
+	bool			IsValid() const { return CacheSize > 0; }
+	size_t			GetCacheSize() const { return CacheSize; }
+
+	const char *	GetLoosePath( const int index, char ( &path )[128] ) const
+	{
+		OVR_sprintf( path, sizeof( path ), "%s/%05d.%s", Path, index, IsCacheImage( index ) ? "jpg" : "json" );
+		return path;
+	}
+
+	const char *	GetFilePath( const char * name, char ( &path )[128] ) const
+	{
+		OVR_sprintf( path, sizeof( path ), "%s/%s", Path, name );
+		return path;
+	}
+
+private:
+	char			Path[64];
+	size_t			CacheSize;
+};
+
+static const ovrBenchmarkCacheFolder & GetCacheFolder()
+{
+	static ovrBenchmarkCacheFolder folder;
+	return folder;
+}
+
+// Every entry written to its own file. The loose files are not synced, while the pack is
+// synced before and after its central directory.
+OVR_BENCHMARK( PackWriter, WriteLooseFiles, BENCHMARK_MACRO )
+{
+	const ovrBenchmarkCacheFolder & folder = GetCacheFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the cache" );
+		return;
+	}
+	Array< uint8_t > data;
+	Array< int > offsets;
+	MakeCacheEntries( NUM_CACHE_ENTRIES, data, offsets );
+	char path[128];
+	bool written = true;
+	while ( state.KeepRunning() && written )
+	{
+		state.PauseTiming();
+		for ( int i = 0; i < NUM_CACHE_ENTRIES; i++ )
+		{
+			unlink( folder.GetLoosePath( i, path ) );
+		}
+		state.ResumeTiming();
+		for ( int i = 0; i < NUM_CACHE_ENTRIES && written; i++ )
+		{
+			written = WriteLooseFile( folder.GetLoosePath( i, path ), data.GetDataPtr() + offsets[i], offsets[i + 1] - offsets[i] );
+		}
+	}
+	if ( !written )
+	{
+		state.SkipWithError( "could not write a file" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_CACHE_ENTRIES );
+	state.SetBytesPerIteration( (double)data.GetSize() );
+}
+
+// A new pack written by ovrPackWriter with the given number of threads besides the calling
+// one.
+OVR_BENCHMARK_ARGS( PackWriter, WritePack, BENCHMARK_MACRO, 0, 1, 3 )
+{
+	const ovrBenchmarkCacheFolder & folder = GetCacheFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the cache" );
+		return;
+	}
+	Array< uint8_t > data;
+	Array< int > offsets;
+	MakeCacheEntries( NUM_CACHE_ENTRIES, data, offsets );
+	char path[128];
+	folder.GetFilePath( CACHE_PACK, path );
+	bool written = true;
+	while ( state.KeepRunning() && written )
+	{
+		state.PauseTiming();
+		unlink( path );
+		state.ResumeTiming();
+		written = WriteCachePack( path, false, state.GetArg(), "cache", NUM_CACHE_ENTRIES, data, offsets );
+	}
+	if ( !written )
+	{
+		state.SkipWithError( "could not write the pack" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_CACHE_ENTRIES );
+	state.SetBytesPerIteration( (double)data.GetSize() );
+	state.SetCounter( "packBytes", (double)GetFileLength( path ) );
+}
+
+// Adds NUM_APPENDED_ENTRIES to a pack of the cache, which writes them and a new central
+// directory after the end of the pack. Once the old central directories outweigh the
+// files, an append copies the pack instead; the copies are counted.
+OVR_BENCHMARK( PackWriter, Append, BENCHMARK_MACRO )
+{
+	const ovrBenchmarkCacheFolder & folder = GetCacheFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the cache" );
+		return;
+	}
+	Array< uint8_t > data;
+	Array< int > offsets;
+	MakeCacheEntries( NUM_CACHE_ENTRIES, data, offsets );
+	char path[128];
+	folder.GetFilePath( APPEND_PACK, path );
+	unlink( path );
+	bool written = WriteCachePack( path, false, ovrPackWriter::DEFAULT_NUM_THREADS, "cache", NUM_CACHE_ENTRIES, data, offsets );
+	long long length = GetFileLength( path );
+	int appends = 0;
+	int copies = 0;
+	int iterations = 0;
+	while ( state.KeepRunning() && written )
+	{
+		// stay below the 65535 files of a pack
+		if ( appends == 500 )
+		{
+			state.PauseTiming();
+			unlink( path );
+			written = WriteCachePack( path, false, ovrPackWriter::DEFAULT_NUM_THREADS, "cache", NUM_CACHE_ENTRIES, data, offsets );
+			length = GetFileLength( path );
+			appends = 0;
+			state.ResumeTiming();
+		}
+		char appendFolder[32];
+		OVR_sprintf( appendFolder, sizeof( appendFolder ), "append%03d", appends++ );
+		written = written && WriteCachePack( path, true, ovrPackWriter::DEFAULT_NUM_THREADS, appendFolder,
+											NUM_APPENDED_ENTRIES, data, offsets );
+		const long long newLength = GetFileLength( path );
+		copies += ( newLength < length );
+		length = newLength;
+		iterations++;
+	}
+	if ( !written )
+	{
+		state.SkipWithError( "could not append to the pack" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_APPENDED_ENTRIES );
+	state.SetCounter( "copiesPerAppend", iterations > 0 ? (double)copies / iterations : 0.0 );
+}
+
+// Reads every entry from its own file.
+OVR_BENCHMARK( PackWriter, ReadLooseFilesCold, BENCHMARK_MACRO )
+{
+	const ovrBenchmarkCacheFolder & folder = GetCacheFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the cache" );
+		return;
+	}
+	char path[128];
+	Array< uint8_t > buffer;
+	bool read = true;
+	while ( state.KeepRunning() && read )
+	{
+		state.PauseTiming();
+		for ( int i = 0; i < NUM_CACHE_ENTRIES; i++ )
+		{
+			EvictFile( folder.GetLoosePath( i, path ) );
+		}
+		state.ResumeTiming();
+		for ( int i = 0; i < NUM_CACHE_ENTRIES && read; i++ )
+		{
+			read = ReadLooseFile( folder.GetLoosePath( i, path ), buffer );
+			DoNotOptimize( buffer[0] );
+		}
+	}
+	if ( !read )
+	{
+		state.SkipWithError( "could not read a file" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_CACHE_ENTRIES );
+	state.SetBytesPerIteration( (double)folder.GetCacheSize() );
+}
+
+// Opens the pack and reads every entry in the order of the central directory, which is how
+// a cache is loaded whole.
+OVR_BENCHMARK( PackWriter, ReadPackCold, BENCHMARK_MACRO )
+{
+	const ovrBenchmarkCacheFolder & folder = GetCacheFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the cache" );
+		return;
+	}
+	char path[128];
+	folder.GetFilePath( CACHE_PACK, path );
+	Array< uint8_t > buffer;
+	int numRead = 0;
+	bool read = true;
+	while ( state.KeepRunning() && read )
+	{
+		state.PauseTiming();
+		EvictFile( path );
+		state.ResumeTiming();
+		void * zip = ovr_OpenOtherApplicationPackage( path );
+		read = zip != NULL;
+		numRead = 0;
+		int ret = read ? unzGoToFirstFile( zip ) : UNZ_ERRNO;
+		for ( ; ret == UNZ_OK && read; ret = unzGoToNextFile( zip ) )
+		{
+			unz_file_info info;
+			if ( unzGetCurrentFileInfo( zip, &info, NULL, 0, NULL, 0, NULL, 0 ) != UNZ_OK || unzOpenCurrentFile( zip ) != UNZ_OK )
+			{
+				read = false;
+				break;
+			}
+			buffer.Resize( info.uncompressed_size );
+			const int readRet = unzReadCurrentFileBulk( zip, buffer.GetDataPtr(), buffer.GetSizeI() );
+			read = unzCloseCurrentFile( zip ) == UNZ_OK && readRet == buffer.GetSizeI();
+			DoNotOptimize( buffer[0] );
+			numRead++;
+		}
+		read = read && ret == UNZ_END_OF_LIST_OF_FILE && numRead == NUM_CACHE_ENTRIES;
+		ovr_CloseOtherApplicationPackage( zip );
+	}
+	if ( !read )
+	{
+		state.SkipWithError( "could not read the pack" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_CACHE_ENTRIES );
+	state.SetBytesPerIteration( (double)folder.GetCacheSize() );
+}
+
+// Reads NUM_CACHE_LOOKUPS entries by name from their own files.
+OVR_BENCHMARK( PackWriter, LookupLooseFilesCold, BENCHMARK_MACRO )
+{
+	const ovrBenchmarkCacheFolder & folder = GetCacheFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the cache" );
+		return;
+	}
+	char path[128];
+	Array< uint8_t > buffer;
+	bool read = true;
+	while ( state.KeepRunning() && read )
+	{
+		state.PauseTiming();
+		for ( int i = 0; i < NUM_CACHE_LOOKUPS; i++ )
+		{
+			EvictFile( folder.GetLoosePath( ( i * 397 ) % NUM_CACHE_ENTRIES, path ) );
+		}
+		state.ResumeTiming();
+		for ( int i = 0; i < NUM_CACHE_LOOKUPS && read; i++ )
+		{
+			read = ReadLooseFile( folder.GetLoosePath( ( i * 397 ) % NUM_CACHE_ENTRIES, path ), buffer );
+			DoNotOptimize( buffer[0] );
+		}
+	}
+	if ( !read )
+	{
+		state.SkipWithError( "could not read a file" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_CACHE_LOOKUPS );
+}
+
+// Opens the pack and reads NUM_CACHE_LOOKUPS entries by name. unzLocateFile() walks the
+// central directory, so each lookup is linear in the entries of the pack.
+OVR_BENCHMARK( PackWriter, LookupPackCold, BENCHMARK_MACRO )
+{
+	const ovrBenchmarkCacheFolder & folder = GetCacheFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the cache" );
+		return;
+	}
+	char path[128];
+	folder.GetFilePath( CACHE_PACK, path );
+	bool read = true;
+	while ( state.KeepRunning() && read )
+	{
+		state.PauseTiming();
+		EvictFile( path );
+		state.ResumeTiming();
+		void * zip = ovr_OpenOtherApplicationPackage( path );
+		read = zip != NULL;
+		for ( int i = 0; i < NUM_CACHE_LOOKUPS && read; i++ )
+		{
+			char name[64];
+			MemBufferT< uint8_t > buffer;
+			read = ovr_ReadFileFromOtherApplicationPackage( zip, GetCacheEntryName( "cache", ( i * 397 ) % NUM_CACHE_ENTRIES, name ), buffer );
+			DoNotOptimize( buffer );
+		}
+		ovr_CloseOtherApplicationPackage( zip );
+	}
+	if ( !read )
+	{
+		state.SkipWithError( "could not read the pack" );
+		return;
+	}
+	state.SetItemsPerIteration( NUM_CACHE_LOOKUPS );
+}
+
+// Checks that the pack at path has exactly the entries [0, count) of each folder, with the
+// data that was written, and that the stored ones are aligned.
+static const char * CheckCachePack( const char * path, const char * const * folders, const int numFolders, const int count,
+		const Array< uint8_t > & data, const Array< int > & offsets )
+{
+	void * zip = ovr_OpenOtherApplicationPackage( path );
+	if ( zip == NULL )
+	{
+		return "could not open the pack";
+	}
+	const char * error = NULL;
+	unz_global_info globalInfo;
+	if ( unzGetGlobalInfo( zip, &globalInfo ) != UNZ_OK || globalInfo.number_entry != (uLong)( numFolders * count ) )
+	{
+		error = "the pack has the wrong number of files";
+	}
+	for ( int f = 0; f < numFolders && error == NULL; f++ )
+	{
+		for ( int i = 0; i < count && error == NULL; i++ )
+		{
+			char name[64];
+			GetCacheEntryName( folders[f], i, name );
+			const size_t length = offsets[i + 1] - offsets[i];
+			MemBufferT< uint8_t > buffer;
+			size_t storedOffset = 0;
+			size_t storedLength = 0;
+			const bool stored = ovr_GetStoredFileRangeInPackage( zip, name, storedOffset, storedLength );
+			if ( !ovr_ReadFileFromOtherApplicationPackage( zip, name, buffer ) )
+			{
+				error = "could not read a file of the pack";
+			}
+			else if ( buffer.GetSize() != length || memcmp( (const uint8_t *)buffer, data.GetDataPtr() + offsets[i], length ) != 0 )
+			{
+				error = "a file of the pack has the wrong data";
+			}
+			else if ( stored != IsCacheImage( i ) )
+			{
+				error = IsCacheImage( i ) ? "an image was compressed" : "a text file was stored";
+			}
+			else if ( stored && ( storedOffset % ( length >= ovrPackWriter::PAGE_ALIGNED_LENGTH ?
+										ovrPackWriter::PAGE_ALIGNMENT : ovrPackWriter::STORED_ALIGNMENT ) ) != 0 )
+			{
+				error = "a stored file is not aligned";
+			}
+		}
+	}
+	ovr_CloseOtherApplicationPackage( zip );
+	return error;
+}
+
+// Writes a pack, appends to it, aborts an append, recovers from an append that did not
+// finish and compacts a pack of old central directories, checking the pack after each.
+OVR_BENCHMARK( PackWriter, Matches, BENCHMARK_MICRO )
+{
+	const ovrBenchmarkCacheFolder & folder = GetCacheFolder();
+	if ( !folder.IsValid() )
+	{
+		state.SkipWithError( "could not write the cache" );
+		return;
+	}
+	static const int NUM_CHECK_ENTRIES = 200;
+	static const int NUM_COMPACT_ENTRIES = 50;
+	static const char * const folders[] = { "a", "b", "c" };
+	Array< uint8_t > data;
+	Array< int > offsets;
+	// the last entry is an image long enough to be page aligned
+	MakeCacheEntries( NUM_CHECK_ENTRIES, data, offsets );
+	offsets[NUM_CHECK_ENTRIES] = offsets[NUM_CHECK_ENTRIES - 1] + 96 * 1024;
+	data.Resize( offsets[NUM_CHECK_ENTRIES] );
+	OVR_ASSERT( IsCacheImage( NUM_CHECK_ENTRIES - 1 ) );
+
+	char path[128];
+	char tmpPath[128];
+	char compactPath[128];
+	folder.GetFilePath( CHECK_PACK, path );
+	OVR_sprintf( tmpPath, sizeof( tmpPath ), "%s.tmp", path );
+	folder.GetFilePath( COMPACT_PACK, compactPath );
+
+	const char * error = NULL;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		unlink( path );
+		if ( !WriteCachePack( path, false, 2, folders[0], NUM_CHECK_ENTRIES, data, offsets ) )
+		{
+			error = "could not write the pack";
+			break;
+		}
+		if ( GetFileLength( tmpPath ) >= 0 )
+		{
+			error = "the new pack was left next to the pack";
+			break;
+		}
+		if ( ( error = CheckCachePack( path, folders, 1, NUM_CHECK_ENTRIES, data, offsets ) ) != NULL )
+		{
+			break;
+		}
+
+		// an append in place, compressed by the calling thread
+		const long long firstLength = GetFileLength( path );
+		if ( !WriteCachePack( path, true, 0, folders[1], NUM_CHECK_ENTRIES, data, offsets ) )
+		{
+			error = "could not append to the pack";
+			break;
+		}
+		if ( ( error = CheckCachePack( path, folders, 2, NUM_CHECK_ENTRIES, data, offsets ) ) != NULL )
+		{
+			break;
+		}
+		if ( GetFileLength( path ) <= firstLength )
+		{
+			error = "the append did not add to the end of the pack";
+			break;
+		}
+
+		// names already in the pack are rejected, and an abort leaves the pack as it was
+		const long long appendedLength = GetFileLength( path );
+		{
+			ovrPackWriter writer;
+			if ( !writer.Open( path, true ) )
+			{
+				error = "could not open the pack to append";
+				break;
+			}
+			if ( writer.GetNumFiles() != 2 * NUM_CHECK_ENTRIES || !writer.HasFile( "B/00001.JSON" ) )
+			{
+				error = "the writer did not find the files of the pack";
+			}
+			else if ( writer.AddFile( "a/00000.json", "x", 1 ) || writer.AddFile( "B/00001.JSON", "x", 1 ) )
+			{
+				error = "a file that is already in the pack was added";
+			}
+			else if ( !AddCacheEntries( writer, folders[2], 0, NUM_CHECK_ENTRIES, data, offsets ) )
+			{
+				error = "could not add to the pack";
+			}
+			writer.Abort();
+		}
+		if ( error == NULL && GetFileLength( path ) != appendedLength )
+		{
+			error = "the abort did not restore the pack";
+		}
+		if ( error != NULL || ( error = CheckCachePack( path, folders, 2, NUM_CHECK_ENTRIES, data, offsets ) ) != NULL )
+		{
+			break;
+		}
+
+		// the start of an append that did not finish is dropped
+		static const uint8_t localHeader[] = { 'P', 'K', 3, 4, 20, 0, 0, 0, 8, 0 };
+		FILE * f = fopen( path, "ab" );
+		if ( f != NULL )
+		{
+			fwrite( localHeader, 1, sizeof( localHeader ), f );
+			fwrite( data.GetDataPtr(), 1, 5000, f );
+			fclose( f );
+		}
+		if ( GetFileLength( path ) != appendedLength + (long long)sizeof( localHeader ) + 5000 )
+		{
+			error = "could not write the unfinished append";
+			break;
+		}
+		if ( !WriteCachePack( path, true, 2, folders[2], NUM_CHECK_ENTRIES, data, offsets ) )
+		{
+			error = "could not append after an unfinished append";
+			break;
+		}
+		if ( ( error = CheckCachePack( path, folders, 3, NUM_CHECK_ENTRIES, data, offsets ) ) != NULL )
+		{
+			break;
+		}
+
+		// Tiny files with a central directory larger than themselves. The first append
+		// leaves more unused space than files, so the second copies the pack.
+		unlink( compactPath );
+		if ( !WriteCachePack( compactPath, false, 1, "tiny", 0, data, offsets ) )
+		{
+			error = "could not write the pack to compact";
+			break;
+		}
+		{
+			ovrPackWriter writer;
+			bool written = writer.Open( compactPath, true );
+			for ( int i = 0; i < NUM_COMPACT_ENTRIES && written; i++ )
+			{
+				char name[64];
+				written = writer.AddFile( GetCacheEntryName( "tiny", i, name ), data.GetDataPtr() + i, 1 );
+			}
+			if ( !written || !writer.Close() )
+			{
+				error = "could not write the tiny files";
+				break;
+			}
+		}
+		const long long tinyLength = GetFileLength( compactPath );
+		ovrPackWriter writer;
+		if ( !writer.Open( compactPath, true ) || !writer.Close() )
+		{
+			error = "could not append to the pack to compact";
+			break;
+		}
+		const long long appendLength = GetFileLength( compactPath );
+		if ( !writer.Open( compactPath, true ) || !writer.Close() )
+		{
+			error = "could not compact the pack";
+			break;
+		}
+		const long long compactLength = GetFileLength( compactPath );
+		if ( !( appendLength > tinyLength && compactLength < appendLength ) )
+		{
+			error = "the pack was not compacted";
+			break;
+		}
+		void * zip = ovr_OpenOtherApplicationPackage( compactPath );
+		for ( int i = 0; i < NUM_COMPACT_ENTRIES && error == NULL; i++ )
+		{
+			char name[64];
+			MemBufferT< uint8_t > buffer;
+			if ( zip == NULL || !ovr_ReadFileFromOtherApplicationPackage( zip, GetCacheEntryName( "tiny", i, name ), buffer ) ||
+					buffer.GetSize() != 1 || *(const uint8_t *)buffer != data[i] )
+			{
+				error = "the compacted pack has the wrong files";
+			}
+		}
+		ovr_CloseOtherApplicationPackage( zip );
+	}
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+	}
+}
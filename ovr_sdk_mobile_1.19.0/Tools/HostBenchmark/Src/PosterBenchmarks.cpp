@@ -0,0 +1,218 @@
+/************************************************************************************
+
+Filename    :   PosterBenchmarks.cpp
+Content     :   Checks and benchmarks of the Cinema poster loader.
+Created     :   10/19/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_MemBuffer.h"
+#include "Kernel/OVR_Threads.h"
+#include "GlTexture.h"
+#include "PosterLoader.h"
+#include "stb_image_write.h"
+
+using namespace OVR;
+using namespace OculusCinema;
+
+// The size that MovieManager draws posters at, and how many it uploads per frame.
+static const int POSTER_WIDTH = 228;
+static const int POSTER_HEIGHT = 344;
+static const int MAX_POSTER_UPLOADS_PER_FRAME = 8;
+
+//==============================================================
+// ovrBenchmarkPosterFile
+// A poster at twice the display size in a temporary directory. Every movie of the library
+// uses it, so the benchmarks measure decoding and uploading and not the file cache.
+class ovrBenchmarkPosterFile
+{
+public:
+	ovrBenchmarkPosterFile() :
+		Written( false )
+	{
+		OVR_strcpy( Path, sizeof( Path ), "/tmp/ovr_benchmark_XXXXXX" );
+		if ( mkdtemp( Path ) == NULL )
+		{
+			Path[0] = '\0';
+			return;
+		}
+
+		const int width = POSTER_WIDTH * 2;
+		const int height = POSTER_HEIGHT * 2;
+		Array< uint8_t > image;
+		image.Resize( width * height * 4 );
+		for ( int y = 0; y < height; y++ )
+		{
+			for ( int x = 0; x < width; x++ )
+			{
+				uint8_t * p = &image[( y * width + x ) * 4];
+				p[0] = static_cast< uint8_t >( x * 255 / width );
+				p[1] = static_cast< uint8_t >( y * 255 / height );
+				p[2] = static_cast< uint8_t >( ( x ^ y ) & 0xFF );
+				p[3] = 255;
+			}
+		}
+		Written = stbi_write_png( GetFileName(), width, height, 4, image.GetDataPtr(), width * 4 ) != 0;
+	}
+
+	~ovrBenchmarkPosterFile()
+	{
+		if ( Path[0] != '\0' )
+		{
+			unlink( GetFileName() );
+			rmdir( Path );
+		}
+	}
+
+	bool			IsWritten() const { return Written; }
+	const char *	GetFileName()
+	{
+		OVR_sprintf( FileName, sizeof( FileName ), "%s/poster.png", Path );
+		return FileName;
+	}
+
+private:
+	char			Path[64];
+	char			FileName[128];
+	bool			Written;
+};
+
+static ovrBenchmarkPosterFile & GetPosterFile()
+{
+	static ovrBenchmarkPosterFile file;
+	return file;
+}
+
+// Loads every poster the way MovieManager did before the poster loader: one texture per
+// poster, decoded, uploaded and mipmapped in turn on the GL thread.
+OVR_BENCHMARK_ARGS( Poster, LoadSequential, BENCHMARK_MACRO, 100, 1000 )
+{
+	ovrBenchmarkPosterFile & file = GetPosterFile();
+	if ( !file.IsWritten() )
+	{
+		state.SkipWithError( "could not write the poster" );
+		return;
+	}
+	const int numMovies = state.GetArg();
+	Array< GlTexture > textures;
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < numMovies; i++ )
+		{
+			int w = 0;
+			int h = 0;
+			GlTexture texture = LoadTextureFromBuffer( file.GetFileName(), MemBufferFile( file.GetFileName() ),
+					TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), w, h );
+			BuildTextureMipmaps( texture );
+			MakeTextureTrilinear( texture );
+			MakeTextureClamped( texture );
+			textures.PushBack( texture );
+		}
+		state.PauseTiming();
+		for ( int i = 0; i < textures.GetSizeI(); i++ )
+		{
+			DeleteTexture( textures[i] );
+		}
+		textures.Clear();
+		state.ResumeTiming();
+	}
+	state.SetItemsPerIteration( numMovies );
+}
+
+// Queues every poster, which is when the library is interactive with placeholder posters,
+// and then uploads the decoded ones a batch per frame until all are loaded. Reports when
+// the library was interactive and the longest upload frame, and checks that every poster
+// is returned exactly once and was loaded.
+OVR_BENCHMARK_ARGS( Poster, LoadStaged, BENCHMARK_MACRO, 100, 1000 )
+{
+	ovrBenchmarkPosterFile & file = GetPosterFile();
+	if ( !file.IsWritten() )
+	{
+		state.SkipWithError( "could not write the poster" );
+		return;
+	}
+	const int numMovies = state.GetArg();
+	Array< int > movies;
+	movies.Resize( numMovies );
+	Array< int > returned;
+	returned.Resize( numMovies );
+
+	int frames = 0;
+	int textures = 0;
+	double interactiveSeconds = 0.0;
+	double longestFrameSeconds = 0.0;
+	const char * error = NULL;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		const double startTime = SystemClock::GetTimeInSeconds();
+		PosterLoader loader;
+		loader.Init( POSTER_WIDTH, POSTER_HEIGHT );
+		for ( int i = 0; i < numMovies; i++ )
+		{
+			returned[i] = 0;
+			loader.LoadPoster( &movies[i], i, file.GetFileName(), NULL );
+		}
+		interactiveSeconds = SystemClock::GetTimeInSeconds() - startTime;
+
+		frames = 0;
+		longestFrameSeconds = 0.0;
+		Array< PosterLoader::Result > results;
+		while ( loader.GetNumPending() > 0 )
+		{
+			results.Clear();
+			const double frameStart = SystemClock::GetTimeInSeconds();
+			loader.Update( results, MAX_POSTER_UPLOADS_PER_FRAME );
+			longestFrameSeconds = Alg::Max( longestFrameSeconds, SystemClock::GetTimeInSeconds() - frameStart );
+			for ( int i = 0; i < results.GetSizeI(); i++ )
+			{
+				const int tag = results[i].Tag;
+				if ( tag < 0 || tag >= numMovies || results[i].UserData != &movies[tag] || !results[i].Loaded )
+				{
+					error = "a poster was not loaded";
+				}
+				else
+				{
+					returned[tag]++;
+				}
+			}
+			if ( results.GetSizeI() > 0 )
+			{
+				frames++;
+			}
+			else
+			{
+				Thread::MSleep( 1 );
+			}
+		}
+		textures = loader.GetNumTextures();
+		loader.Shutdown();
+
+		for ( int i = 0; i < numMovies && error == NULL; i++ )
+		{
+			if ( returned[i] != 1 )
+			{
+				error = "a poster was not returned exactly once";
+			}
+		}
+	}
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+		return;
+	}
+	state.SetItemsPerIteration( numMovies );
+	state.SetCounter( "interactiveMs", interactiveSeconds * 1000.0 );
+	state.SetCounter( "longestFrameMs", longestFrameSeconds * 1000.0 );
+	state.SetCounter( "uploadFrames", frames );
+	state.SetCounter( "textures", textures );
+}
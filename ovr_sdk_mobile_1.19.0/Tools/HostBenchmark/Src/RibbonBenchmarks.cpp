@@ -0,0 +1,254 @@
+/************************************************************************************
+
+Filename    :   RibbonBenchmarks.cpp
+Content     :   Checks and benchmarks of the VrController ribbon trails.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <math.h>
+
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Math.h"
+#include "PointList.h"
+#include "Ribbon.h"
+
+using namespace OVR;
+
+static const float TRAIL_WIDTH = 0.025f;
+
+// Points on a helix around each trail's own axis, 2 cm apart along the axis so that none
+// are skipped.
+static Vector3f TrailPoint( const int trail, const int step )
+{
+	const float a = step * 0.1f + trail;
+	return Vector3f( ( trail % 10 ) + cosf( a ) * 0.2f, ( trail / 10 ) + sinf( a ) * 0.2f, step * 0.02f );
+}
+
+struct ovrTrailTestPoint
+{
+	Vector3f	Position;
+	double		Time;
+};
+
+static bool BoundsContain( const Bounds3f & bounds, const Bounds3f & inner )
+{
+	const float e = 1e-4f;
+	return	inner.GetMins().x >= bounds.GetMins().x - e && inner.GetMins().y >= bounds.GetMins().y - e &&
+			inner.GetMins().z >= bounds.GetMins().z - e && inner.GetMaxs().x <= bounds.GetMaxs().x + e &&
+			inner.GetMaxs().y <= bounds.GetMaxs().y + e && inner.GetMaxs().z <= bounds.GetMaxs().z + e;
+}
+
+// Adds points to trails on two pages, with some frames skipped and some trails cleared.
+// Odd trails add points often enough to overwrite their rings within a life time. Checks
+// after every few updates that each page's bounds cover the points that are still drawn,
+// but no points that faded out more than a life time ago, and then that nothing is drawn
+// once all points have faded out.
+OVR_BENCHMARK( TrailBatch, Matches, BENCHMARK_MICRO )
+{
+	static const int NUM_TRAILS = 180;
+	static const int NUM_POINTS = 200;
+	static const int NUM_STEPS = 1500;
+	static const int CHECK_STEPS = 10;
+	static const double STEP_SECONDS = 0.01;
+	static const float LIFE_TIME = 5.0f;
+
+	const char * error = NULL;
+	int numPages = 0;
+	int numSurfaces = 0;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		ovrBenchmarkRandom random;
+		ovrTrailBatch batch( NUM_TRAILS, NUM_POINTS, TRAIL_WIDTH, LIFE_TIME );
+		Array< Array< ovrTrailTestPoint > > points;
+		Array< int > firstPoints;	// points before this were cleared
+		points.Resize( NUM_TRAILS );
+		firstPoints.Resize( NUM_TRAILS );
+		for ( int i = 0; i < NUM_TRAILS; i++ )
+		{
+			batch.AddTrail( Vector4f( 0.0f, 0.5f, 1.0f, 1.0f ) );
+			firstPoints[i] = 0;
+		}
+		numPages = batch.GetNumPages();
+
+		Array< ovrDrawSurface > surfaceList;
+		for ( int step = 0; step < NUM_STEPS && error == NULL; step++ )
+		{
+			const double time = step * STEP_SECONDS;
+			if ( step == NUM_STEPS / 2 )
+			{
+				batch.ClearTrail( 5 );
+				batch.ClearTrail( NUM_TRAILS - 5 );
+				firstPoints[5] = points[5].GetSizeI();
+				firstPoints[NUM_TRAILS - 5] = points[NUM_TRAILS - 5].GetSizeI();
+			}
+			for ( int i = 0; i < NUM_TRAILS; i++ )
+			{
+				if ( random.NextFloat() > ( ( i & 1 ) ? 0.9f : 0.3f ) )
+				{
+					continue;
+				}
+				const ovrTrailTestPoint p = { TrailPoint( i, step ), time };
+				if ( batch.AddPoint( i, p.Position, p.Time ) )
+				{
+					points[i].PushBack( p );
+				}
+			}
+			batch.Update( time );
+			if ( step % CHECK_STEPS != 0 )
+			{
+				continue;
+			}
+
+			for ( int page = 0; page < numPages && error == NULL; page++ )
+			{
+				const Bounds3f & bounds = batch.GetPageBounds( page );
+				Bounds3f drawn( Bounds3f::Init );
+				Bounds3f added( Bounds3f::Init );
+				const Vector3f pad( TRAIL_WIDTH );
+				for ( int i = 0; i < NUM_TRAILS; i++ )
+				{
+					if ( batch.GetTrailPage( i ) != page )
+					{
+						continue;
+					}
+					const Array< ovrTrailTestPoint > & trailPoints = points[i];
+					const int firstDrawn = Alg::Max( firstPoints[i], trailPoints.GetSizeI() - NUM_POINTS );
+					for ( int j = 0; j < trailPoints.GetSizeI(); j++ )
+					{
+						const double age = time - trailPoints[j].Time;
+						// leave a margin for the float times of the batch
+						if ( j >= firstDrawn && age < LIFE_TIME - 0.01 )
+						{
+							drawn.AddPoint( trailPoints[j].Position - pad );
+							drawn.AddPoint( trailPoints[j].Position + pad );
+						}
+						if ( age < 2.0 * LIFE_TIME )
+						{
+							added.AddPoint( trailPoints[j].Position - pad );
+							added.AddPoint( trailPoints[j].Position + pad );
+						}
+					}
+				}
+				if ( !drawn.IsInverted() && !BoundsContain( bounds, drawn ) )
+				{
+					error = "the bounds of a page miss points that are drawn";
+				}
+				else if ( !BoundsContain( added, bounds ) )
+				{
+					error = "the bounds of a page cover points that faded out";
+				}
+			}
+
+			surfaceList.Resize( 0 );
+			batch.GenerateSurfaceList( surfaceList );
+			if ( error == NULL && surfaceList.GetSizeI() != numPages )
+			{
+				error = "a page with points is not drawn";
+			}
+			numSurfaces = surfaceList.GetSizeI();
+		}
+
+		if ( error == NULL )
+		{
+			batch.Update( NUM_STEPS * STEP_SECONDS + 2.0 * LIFE_TIME );
+			surfaceList.Resize( 0 );
+			batch.GenerateSurfaceList( surfaceList );
+			if ( surfaceList.GetSizeI() != 0 )
+			{
+				error = "pages whose points faded out are drawn";
+			}
+		}
+	}
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+		return;
+	}
+	state.SetCounter( "pages", numPages );
+	state.SetCounter( "surfaces", numSurfaces );
+}
+
+static const int NUM_BENCHMARK_TRAILS = 200;
+static const int NUM_BENCHMARK_POINTS = 256;
+static const double FRAME_SECONDS = 1.0 / 72.0;
+
+// Adds a point to each of 200 full trails of 256 points every frame, which overwrites their
+// oldest points, and uploads the points.
+OVR_BENCHMARK( TrailBatch, AddAndUpload, BENCHMARK_MACRO )
+{
+	ovrTrailBatch batch( NUM_BENCHMARK_TRAILS, NUM_BENCHMARK_POINTS, TRAIL_WIDTH, 10.0f );
+	for ( int i = 0; i < NUM_BENCHMARK_TRAILS; i++ )
+	{
+		batch.AddTrail( Vector4f( 0.0f, 0.5f, 1.0f, 1.0f ) );
+	}
+	for ( int step = 0; step < NUM_BENCHMARK_POINTS; step++ )
+	{
+		for ( int i = 0; i < NUM_BENCHMARK_TRAILS; i++ )
+		{
+			batch.AddPoint( i, TrailPoint( i, step ), step * FRAME_SECONDS );
+		}
+	}
+	batch.Update( NUM_BENCHMARK_POINTS * FRAME_SECONDS );
+
+	int step = NUM_BENCHMARK_POINTS;
+	long long uploadedVertices = 0;
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < NUM_BENCHMARK_TRAILS; i++ )
+		{
+			batch.AddPoint( i, TrailPoint( i, step ), step * FRAME_SECONDS );
+		}
+		batch.Update( step * FRAME_SECONDS );
+		uploadedVertices += batch.GetLastUpdateVertices();
+		step++;
+	}
+	const long long frames = step - NUM_BENCHMARK_POINTS;
+	if ( frames > 0 )
+	{
+		state.SetCounter( "uploadedVertices", (double)uploadedVertices / frames );
+	}
+	state.SetCounter( "surfaces", batch.GetNumPages() );
+	state.SetItemsPerIteration( NUM_BENCHMARK_TRAILS );
+}
+
+// The same trails as point lists that each rebuild an ovrRibbon every frame.
+OVR_BENCHMARK( Ribbon, Update, BENCHMARK_MACRO )
+{
+	Array< ovrPointList_Circular * > pointLists;
+	for ( int i = 0; i < NUM_BENCHMARK_TRAILS; i++ )
+	{
+		ovrPointList_Circular * points = new ovrPointList_Circular( NUM_BENCHMARK_POINTS + 1 );
+		for ( int step = 0; step < NUM_BENCHMARK_POINTS; step++ )
+		{
+			points->AddToTail( TrailPoint( i, step ) );
+		}
+		pointLists.PushBack( points );
+	}
+	ovrRibbon ribbon( *pointLists[0], TRAIL_WIDTH, Vector4f( 0.0f, 0.5f, 1.0f, 1.0f ) );
+	const Matrix4f centerViewMatrix = Matrix4f::LookAtRH( Vector3f( 5.0f, 5.0f, -5.0f ), Vector3f( 5.0f, 5.0f, 0.0f ), Vector3f( 0.0f, 1.0f, 0.0f ) );
+
+	int step = NUM_BENCHMARK_POINTS;
+	while ( state.KeepRunning() )
+	{
+		for ( int i = 0; i < NUM_BENCHMARK_TRAILS; i++ )
+		{
+			pointLists[i]->RemoveHead();
+			pointLists[i]->AddToTail( TrailPoint( i, step ) );
+			ribbon.Update( *pointLists[i], centerViewMatrix, true );
+		}
+		step++;
+	}
+
+	for ( int i = 0; i < NUM_BENCHMARK_TRAILS; i++ )
+	{
+		delete pointLists[i];
+	}
+	state.SetCounter( "surfaces", NUM_BENCHMARK_TRAILS );
+	state.SetItemsPerIteration( NUM_BENCHMARK_TRAILS );
+}
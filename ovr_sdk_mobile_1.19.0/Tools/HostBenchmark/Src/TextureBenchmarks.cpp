@@ -0,0 +1,586 @@
+/************************************************************************************
+
+Filename    :   TextureBenchmarks.cpp
+Content     :   Checks and benchmarks of the VrAppFramework texture streamer and encoder.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostBenchmark.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Threads.h"
+#include "ImageData.h"
+#include "OVR_TextureEncoder.h"
+#include "OVR_TextureStreamer.h"
+
+using namespace OVR;
+
+// Records the uploads and advances a fake clock by the number of bytes uploaded.
+class ovrTextureUploaderMock : public ovrTextureUploader
+{
+public:
+	struct ovrUpload
+	{
+		GLuint	Texture;
+		int		Level;
+		size_t	Bytes;
+		int		Frame;
+		bool	LevelDone;
+	};
+
+	explicit ovrTextureUploaderMock( const double secondsPerByte )
+		: SecondsPerByte( secondsPerByte )
+		, Time( 0.0 )
+		, Frame( 0 )
+		, NextTexture( 1 )
+		, LevelRangeError( false )
+	{
+	}
+
+	virtual GLuint CreateTexture( const bool mipmapped ) { return NextTexture++; }
+	virtual void DeleteTexture( const GLuint texture ) {}
+	virtual void DefineLevel( const GLuint texture, const int level, const eTextureFormat format, const bool useSrgb,
+			const int width, const int height, const void * data, const size_t dataSize )
+	{
+		if ( data != NULL )
+		{
+			Add( texture, level, dataSize );
+		}
+	}
+	virtual void UploadRows( const GLuint texture, const int level, const eTextureFormat format, const bool useSrgb,
+			const int y, const int width, const int height, const void * data )
+	{
+		Add( texture, level, width * height * 4 );
+	}
+	virtual void SetLevelRange( const GLuint texture, const int baseLevel, const int maxLevel )
+	{
+		// only the level that was just finished starts being sampled
+		if ( Uploads.GetSizeI() == 0 || Uploads.Back().Texture != texture || Uploads.Back().Level != baseLevel )
+		{
+			LevelRangeError = true;
+			return;
+		}
+		Uploads.Back().LevelDone = true;
+	}
+	virtual double GetTimeInSeconds() const { return Time; }
+
+	double				SecondsPerByte;
+	double				Time;
+	int					Frame;
+	GLuint				NextTexture;
+	bool				LevelRangeError;
+	Array< ovrUpload >	Uploads;
+
+private:
+	void Add( const GLuint texture, const int level, const size_t bytes )
+	{
+		ovrUpload upload = { texture, level, bytes, Frame, false };
+		Uploads.PushBack( upload );
+		Time += bytes * SecondsPerByte;
+	}
+};
+
+static void MakeTestPixels( const int width, const int height, uint8_t * p )
+{
+	for ( int i = 0; i < width * height; i++ )
+	{
+		p[i * 4 + 0] = static_cast< uint8_t >( i );
+		p[i * 4 + 1] = static_cast< uint8_t >( i >> 8 );
+		p[i * 4 + 2] = static_cast< uint8_t >( i >> 16 );
+		p[i * 4 + 3] = 255;
+	}
+}
+
+static void MakeTestImage( const int width, const int height, MemBufferT< uint8_t > & buffer )
+{
+	// uncompressed 32 bit TGA, top-left origin
+	buffer.Realloc( 18 + width * height * 4 );
+	uint8_t * p = buffer;
+	memset( p, 0, 18 );
+	p[2] = 2;
+	p[12] = static_cast< uint8_t >( width & 0xFF );
+	p[13] = static_cast< uint8_t >( width >> 8 );
+	p[14] = static_cast< uint8_t >( height & 0xFF );
+	p[15] = static_cast< uint8_t >( height >> 8 );
+	p[16] = 32;
+	p[17] = 0x28;
+	MakeTestPixels( width, height, p + 18 );
+}
+
+static int NumMipLevels( int width, int height )
+{
+	int numLevels = 1;
+	for ( ; width > 1 || height > 1; numLevels++ )
+	{
+		width = Alg::Max( width >> 1, 1 );
+		height = Alg::Max( height >> 1, 1 );
+	}
+	return numLevels;
+}
+
+static size_t MipChainSize( int width, int height )
+{
+	size_t size = 0;
+	for ( int i = NumMipLevels( width, height ); i > 0; i-- )
+	{
+		size += width * height * 4;
+		width = Alg::Max( width >> 1, 1 );
+		height = Alg::Max( height >> 1, 1 );
+	}
+	return size;
+}
+
+// Streams files and decoded images through the mock, and returns NULL if every level was
+// uploaded within the budget, from the smallest level of each texture up.
+static const char * StreamTestTextures()
+{
+	static const int sizes[][2] = { { 1024, 1024 }, { 256, 256 }, { 512, 128 }, { 33, 17 }, { 1, 1 }, { 2048, 512 }, { 200, 100 } };
+	static const int numTextures = sizeof( sizes ) / sizeof( sizes[0] );
+	static const int numFiles = numTextures - 1;	// the last one is already decoded
+	const size_t bytesPerFrame = 1024 * 1024;
+	const double secondsPerFrame = 0.0005;
+	const double secondsPerByte = 1e-9;
+
+	ovrTextureUploaderMock mock( secondsPerByte );
+	ovrTextureStreamer streamer;
+	streamer.Init( &mock );
+	streamer.SetBudget( bytesPerFrame, secondsPerFrame );
+
+	const char * error = NULL;
+	size_t expectedBytes = 0;
+	for ( int i = 0; i < numTextures; i++ )
+	{
+		const int width = sizes[i][0];
+		const int height = sizes[i][1];
+		MemBufferT< uint8_t > buffer;
+		GlTexture texture;
+		if ( i < numFiles )
+		{
+			MakeTestImage( width, height, buffer );
+			texture = streamer.LoadTexture( "test.tga", buffer, TextureFlags_t() );
+		}
+		else
+		{
+			buffer.Realloc( width * height * 4 );
+			MakeTestPixels( width, height, buffer );
+			texture = streamer.LoadRGBATexture( buffer, width, height, TextureFlags_t() );
+		}
+		if ( texture.Width != width || texture.Height != height || !streamer.IsLoading( texture ) )
+		{
+			error = "a texture was not queued with its size";
+		}
+		expectedBytes += MipChainSize( width, height );
+	}
+
+	for ( int frame = 0; streamer.GetNumLoading() > 0 && frame < 100000 && error == NULL; frame++ )
+	{
+		mock.Frame = frame;
+		const int firstUpload = mock.Uploads.GetSizeI();
+		const double frameStart = mock.Time;
+		streamer.Update();
+
+		size_t frameBytes = 0;
+		for ( int i = firstUpload; i < mock.Uploads.GetSizeI(); i++ )
+		{
+			frameBytes += mock.Uploads[i].Bytes;
+		}
+		// a level larger than the budget only goes by itself
+		const int numUploads = mock.Uploads.GetSizeI() - firstUpload;
+		if ( frameBytes > bytesPerFrame && numUploads > 1 )
+		{
+			error = "a frame went over the byte budget";
+		}
+		// the time budget is checked after each upload, so only the last one can go over
+		if ( numUploads > 1 && mock.Time - mock.Uploads.Back().Bytes * secondsPerByte - frameStart >= secondsPerFrame )
+		{
+			error = "a frame went over the time budget";
+		}
+		if ( numUploads == 0 )
+		{
+			Thread::MSleep( 1 );	// waiting for the decode threads
+		}
+	}
+	if ( error == NULL && mock.LevelRangeError )
+	{
+		error = "a level was sampled before it was uploaded";
+	}
+
+	// every level is finished, in order from the smallest
+	size_t totalBytes = 0;
+	for ( int t = 0; t < numTextures && error == NULL; t++ )
+	{
+		const GLuint texture = static_cast< GLuint >( t + 1 );
+		int expectedLevel = NumMipLevels( sizes[t][0], sizes[t][1] ) - 1;
+		for ( int i = 0; i < mock.Uploads.GetSizeI(); i++ )
+		{
+			const ovrTextureUploaderMock::ovrUpload & upload = mock.Uploads[i];
+			if ( upload.Texture != texture )
+			{
+				continue;
+			}
+			totalBytes += upload.Bytes;
+			if ( upload.Level != expectedLevel )
+			{
+				error = "a level was uploaded out of order";
+				break;
+			}
+			if ( upload.LevelDone )
+			{
+				expectedLevel--;
+			}
+		}
+		if ( error == NULL && expectedLevel != -1 )
+		{
+			error = "a texture did not finish";
+		}
+	}
+	if ( error == NULL && ( totalBytes != expectedBytes || streamer.GetNumLoading() != 0 ) )
+	{
+		error = "the uploads do not add up to the mip chains";
+	}
+
+	streamer.Shutdown();
+	return error;
+}
+
+// Checks the per-frame budget and the upload order against a mock uploader.
+OVR_BENCHMARK( TextureStreamer, Matches, BENCHMARK_MACRO )
+{
+	const char * error = NULL;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		error = StreamTestTextures();
+	}
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+	}
+}
+
+// Frees textures in every stage of loading, which must not leak or upload to a freed texture.
+OVR_BENCHMARK( TextureStreamer, FreeWhileLoading, BENCHMARK_MICRO )
+{
+	ovrTextureUploaderMock mock( 0.0 );
+	ovrTextureStreamer streamer;
+	streamer.Init( &mock );
+	streamer.SetBudget( 64 * 1024, 1.0 );
+
+	const char * error = NULL;
+	while ( state.KeepRunning() && error == NULL )
+	{
+		GlTexture textures[4];
+		for ( int i = 0; i < 4; i++ )
+		{
+			MemBufferT< uint8_t > buffer( 128 * 128 * 4 );
+			MakeTestPixels( 128, 128, buffer );
+			textures[i] = streamer.LoadRGBATexture( buffer, 128, 128, TextureFlags_t() );
+		}
+		// queued or decoding
+		streamer.FreeTexture( textures[0] );
+		while ( streamer.GetNumLoading() == 3 && mock.Uploads.GetSizeI() == 0 )
+		{
+			streamer.Update();
+			Thread::MSleep( 0 );
+		}
+		// uploading
+		const GLuint freed = textures[1].texture;
+		streamer.FreeTexture( textures[1] );
+		const int firstUpload = mock.Uploads.GetSizeI();
+		while ( streamer.GetNumLoading() > 0 )
+		{
+			streamer.Update();
+			Thread::MSleep( 0 );
+		}
+		for ( int i = firstUpload; i < mock.Uploads.GetSizeI(); i++ )
+		{
+			if ( mock.Uploads[i].Texture == freed )
+			{
+				error = "a freed texture was uploaded";
+			}
+		}
+		streamer.FreeTexture( textures[2] );
+		streamer.FreeTexture( textures[3] );
+		mock.Uploads.Clear();
+	}
+	streamer.Shutdown();
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+	}
+}
+
+// Smooth gradients with noise. The noise limits the PSNR of the first level, and averages
+// out in the smaller levels.
+static void MakeEncoderTestImage( const int width, const int height, uint8_t * p )
+{
+	ovrBenchmarkRandom random;
+	for ( int y = 0; y < height; y++ )
+	{
+		for ( int x = 0; x < width; x++ )
+		{
+			const float u = x * ( 1.0f / 32.0f );
+			const float v = y * ( 1.0f / 32.0f );
+			const float r = 128.0f + 90.0f * sinf( u ) + random.NextFloat( -8.0f, 8.0f );
+			const float g = 128.0f + 90.0f * cosf( v * 1.3f ) + random.NextFloat( -8.0f, 8.0f );
+			const float b = 128.0f + 60.0f * sinf( u + v ) + random.NextFloat( -8.0f, 8.0f );
+			uint8_t * texel = p + ( y * width + x ) * 4;
+			texel[0] = static_cast< uint8_t >( Alg::Clamp( r, 0.0f, 255.0f ) );
+			texel[1] = static_cast< uint8_t >( Alg::Clamp( g, 0.0f, 255.0f ) );
+			texel[2] = static_cast< uint8_t >( Alg::Clamp( b, 0.0f, 255.0f ) );
+			texel[3] = 255;
+		}
+	}
+}
+
+// Of the RGB channels, alpha is not encoded.
+static double ImagePsnr( const uint8_t * a, const uint8_t * b, const int width, const int height )
+{
+	double sumSq = 0.0;
+	for ( int i = 0; i < width * height; i++ )
+	{
+		for ( int c = 0; c < 3; c++ )
+		{
+			const int d = static_cast< int >( a[i * 4 + c] ) - static_cast< int >( b[i * 4 + c] );
+			sumSq += d * d;
+		}
+	}
+	const double mse = sumSq / ( static_cast< double >( width ) * height * 3 );
+	return ( mse > 0.0 ) ? 10.0 * log10( 255.0 * 255.0 / mse ) : 99.0;
+}
+
+// The PSNR of the image with every block set to its mean color.
+static double BlockMeanPsnr( const uint8_t * rgba, const int width, const int height, const int blockSize )
+{
+	Array< uint8_t > flat;
+	flat.Resize( width * height * 4 );
+	for ( int by = 0; by < height; by += blockSize )
+	{
+		for ( int bx = 0; bx < width; bx += blockSize )
+		{
+			const int bw = Alg::Min( blockSize, width - bx );
+			const int bh = Alg::Min( blockSize, height - by );
+			for ( int c = 0; c < 4; c++ )
+			{
+				int sum = 0;
+				for ( int y = by; y < by + bh; y++ )
+				{
+					for ( int x = bx; x < bx + bw; x++ )
+					{
+						sum += rgba[( y * width + x ) * 4 + c];
+					}
+				}
+				const uint8_t mean = static_cast< uint8_t >( ( sum + bw * bh / 2 ) / ( bw * bh ) );
+				for ( int y = by; y < by + bh; y++ )
+				{
+					for ( int x = bx; x < bx + bw; x++ )
+					{
+						flat[( y * width + x ) * 4 + c] = mean;
+					}
+				}
+			}
+		}
+	}
+	return ImagePsnr( rgba, flat.GetDataPtr(), width, height );
+}
+
+struct ovrEncoderTestFormat
+{
+	eTextureFormat	Format;
+	int				BlockSize;
+	double			MinPsnr;	// of the first level with TEXTURE_ENCODE_FAST
+};
+
+static const ovrEncoderTestFormat EncoderTestFormats[] =
+{
+	{ Texture_ETC2_RGB,	4, 34.0 },
+	{ Texture_ASTC_4x4,	4, 36.0 },
+	{ Texture_ASTC_6x6,	6, 33.5 },
+};
+
+// A solid block does not decode exactly, since the colors of the blocks are quantized.
+static const double MAX_SOLID_BLOCK_PSNR = 36.0;
+
+// Encodes full mip chains of images whose sizes are not multiples of the block sizes, and
+// decodes every level. The first level has to be close to the image, and no level can be
+// worse than setting each block to its mean color, which catches blocks that are decoded
+// from the wrong texels. The smaller levels of any image have colors that vary too much
+// within a block for the one color line of these block modes, so they are not held to
+// the same PSNR as the first level.
+OVR_BENCHMARK( TextureEncoder, Matches, BENCHMARK_MACRO )
+{
+	static const int sizes[][2] = { { 256, 256 }, { 257, 131 }, { 67, 45 }, { 5, 3 }, { 1, 1 } };
+	static const int numSizes = sizeof( sizes ) / sizeof( sizes[0] );
+	static const int numFormats = sizeof( EncoderTestFormats ) / sizeof( EncoderTestFormats[0] );
+
+	ovrTextureEncoder encoder;
+	encoder.Init();
+
+	const char * error = NULL;
+	double minPsnr[numFormats];
+	while ( state.KeepRunning() && error == NULL )
+	{
+		for ( int f = 0; f < numFormats; f++ )
+		{
+			minPsnr[f] = 99.0;
+		}
+		for ( int s = 0; s < numSizes && error == NULL; s++ )
+		{
+			const int width = sizes[s][0];
+			const int height = sizes[s][1];
+			Array< uint8_t > image;
+			image.Resize( width * height * 4 );
+			MakeEncoderTestImage( width, height, image.GetDataPtr() );
+
+			// down to a width or height of 1
+			int expectedLevels = 1;
+			for ( int w = width, h = height; Alg::Min( w, h ) >= 2 && expectedLevels < ovrDecodedTexture::MAX_LEVELS; w >>= 1, h >>= 1 )
+			{
+				expectedLevels++;
+			}
+
+			for ( int f = 0; f < numFormats && error == NULL; f++ )
+			{
+				const ovrEncoderTestFormat & format = EncoderTestFormats[f];
+				double fastPsnr = 0.0;
+				for ( int q = TEXTURE_ENCODE_FAST; q <= TEXTURE_ENCODE_HIGH && error == NULL; q++ )
+				{
+					ovrDecodedTexture encoded;
+					if ( !encoder.EncodeMipChain( image.GetDataPtr(), width, height, ovrDecodedTexture::MAX_LEVELS,
+							format.Format, false, static_cast< ovrTextureEncodeQuality >( q ), encoded ) )
+					{
+						error = "a format could not be encoded";
+						break;
+					}
+					if ( encoded.NumLevels != expectedLevels )
+					{
+						error = "the mip chain is not complete";
+						break;
+					}
+
+					const uint8_t * level = image.GetDataPtr();
+					unsigned char * quartered = NULL;
+					Array< uint8_t > decoded;
+					double firstLevelPsnr = 0.0;
+					for ( int l = 0; l < encoded.NumLevels && error == NULL; l++ )
+					{
+						const int w = encoded.GetLevelWidth( l );
+						const int h = encoded.GetLevelHeight( l );
+						if ( l > 0 )
+						{
+							unsigned char * next = QuarterImageSize( level, encoded.GetLevelWidth( l - 1 ), encoded.GetLevelHeight( l - 1 ), false );
+							free( quartered );
+							quartered = next;
+							level = quartered;
+						}
+						if ( encoded.LevelSize[l] != ovrTextureEncoder::GetEncodedSize( format.Format, w, h ) )
+						{
+							error = "a level has the wrong size";
+							break;
+						}
+						decoded.Resize( w * h * 4 );
+						DecodeTextureBlocks( encoded.GetLevelData( l ), w, h, format.Format, decoded.GetDataPtr() );
+						const double psnr = ImagePsnr( level, decoded.GetDataPtr(), w, h );
+						const double flatPsnr = BlockMeanPsnr( level, w, h, format.BlockSize );
+						if ( psnr < Alg::Min( flatPsnr, MAX_SOLID_BLOCK_PSNR ) - 0.5 )
+						{
+							error = "a level decodes worse than its mean block colors";
+						}
+						if ( l == 0 )
+						{
+							firstLevelPsnr = psnr;
+						}
+					}
+					free( quartered );
+
+					if ( error != NULL )
+					{
+						break;
+					}
+					if ( q == TEXTURE_ENCODE_FAST )
+					{
+						fastPsnr = firstLevelPsnr;
+						if ( firstLevelPsnr < format.MinPsnr )
+						{
+							error = "the first level decodes too far from the image";
+						}
+					}
+					else if ( firstLevelPsnr < fastPsnr - 0.1 )
+					{
+						error = "a higher quality is worse than TEXTURE_ENCODE_FAST";
+					}
+					minPsnr[f] = Alg::Min( minPsnr[f], firstLevelPsnr );
+				}
+			}
+		}
+	}
+	encoder.Shutdown();
+
+	if ( error != NULL )
+	{
+		state.SkipWithError( error );
+		return;
+	}
+	state.SetCounter( "etc2Psnr", minPsnr[0] );
+	state.SetCounter( "astc4x4Psnr", minPsnr[1] );
+	state.SetCounter( "astc6x6Psnr", minPsnr[2] );
+}
+
+// Encodes a pano sized image with the quality given as the argument, like the photos sample
+// does before uploading a pano, and reports the PSNR of the result.
+static void RunEncodeBenchmark( ovrBenchmarkState & state, const eTextureFormat format )
+{
+	static const int WIDTH = 1024;
+	static const int HEIGHT = 512;
+	const ovrTextureEncodeQuality quality = static_cast< ovrTextureEncodeQuality >( state.GetArg() );
+
+	Array< uint8_t > image;
+	image.Resize( WIDTH * HEIGHT * 4 );
+	MakeEncoderTestImage( WIDTH, HEIGHT, image.GetDataPtr() );
+	Array< uint8_t > blocks;
+	blocks.Resize( static_cast< int >( ovrTextureEncoder::GetEncodedSize( format, WIDTH, HEIGHT ) ) );
+
+	ovrTextureEncoder encoder;
+	encoder.Init();
+	bool encoded = true;
+	while ( state.KeepRunning() )
+	{
+		encoded &= encoder.Encode( image.GetDataPtr(), WIDTH, HEIGHT, format, quality, blocks.GetDataPtr() );
+	}
+	encoder.Shutdown();
+	if ( !encoded )
+	{
+		state.SkipWithError( "the format could not be encoded" );
+		return;
+	}
+
+	Array< uint8_t > decoded;
+	decoded.Resize( WIDTH * HEIGHT * 4 );
+	DecodeTextureBlocks( blocks.GetDataPtr(), WIDTH, HEIGHT, format, decoded.GetDataPtr() );
+	state.SetItemsPerIteration( WIDTH * HEIGHT );
+	state.SetBytesPerIteration( WIDTH * HEIGHT * 4 );
+	state.SetCounter( "psnr", ImagePsnr( image.GetDataPtr(), decoded.GetDataPtr(), WIDTH, HEIGHT ) );
+}
+
+OVR_BENCHMARK_ARGS( TextureEncoder, EncodeEtc2, BENCHMARK_MACRO, TEXTURE_ENCODE_FAST, TEXTURE_ENCODE_NORMAL, TEXTURE_ENCODE_HIGH )
+{
+	RunEncodeBenchmark( state, Texture_ETC2_RGB );
+}
+
+OVR_BENCHMARK_ARGS( TextureEncoder, EncodeAstc4x4, BENCHMARK_MACRO, TEXTURE_ENCODE_FAST, TEXTURE_ENCODE_NORMAL, TEXTURE_ENCODE_HIGH )
+{
+	RunEncodeBenchmark( state, Texture_ASTC_4x4 );
+}
+
+OVR_BENCHMARK_ARGS( TextureEncoder, EncodeAstc6x6, BENCHMARK_MACRO, TEXTURE_ENCODE_FAST, TEXTURE_ENCODE_NORMAL, TEXTURE_ENCODE_HIGH )
+{
+	RunEncodeBenchmark( state, Texture_ASTC_6x6 );
+}
@@ -44,6 +44,8 @@ class App;
 class OvrStoragePaths;
 class ovrFileSys;
 class ovrTextureManager;
+class ovrTextureStreamer;
+class ovrReadService;
 
 enum ovrIntentType
 {
@@ -89,6 +91,7 @@ struct ovrSettings
 	ovrTrackingTransform TrackingTransform;			// Default is VRAPI_TRACKING_TRANSFORM_SYSTEM_CENTER_FLOOR_LEVEL
 	ovrEyeBufferParms	EyeBufferParms;
 	ovrRenderMode		RenderMode;					// Default is RENDERMODE_STEREO.
+	bool				UseDeferredLog;				// Format and write OVR_LOG messages on a background thread, see ovrDeferredLog. Default is false.
 #if defined( OVR_OS_WIN32 )
 	ovrWindowCreationParms	WindowParms;
 #endif
@@ -289,8 +292,13 @@ public:
 
 	virtual ovrMobile *					GetOvrMobile() = 0;
 	virtual ovrFileSys &				GetFileSys() = 0;
+	// Reads files on worker threads, which are started by the first call. Valid from before
+	// OneTimeInit() until after OneTimeShutdown().
+	virtual ovrReadService &			GetReadService() = 0;
 	// it's possible that this could return NULL if it's called before InitGLObjects()
 	virtual	ovrTextureManager *			GetTextureManager() = 0;
+	// Loads textures over several frames. NULL before InitGLObjects(), like the texture manager.
+	virtual	ovrTextureStreamer *		GetTextureStreamer() = 0;
 
 	//-----------------------------------------------------------------
 	// Localization
@@ -86,7 +86,9 @@ public:
 
 	virtual ovrMobile *					GetOvrMobile();
 	virtual ovrFileSys &				GetFileSys();
+	virtual ovrReadService &			GetReadService();
 	virtual	ovrTextureManager *			GetTextureManager();
+	virtual	ovrTextureStreamer *		GetTextureStreamer();
 
 	//-----------------------------------------------------------------
 	// Localization
@@ -114,6 +116,7 @@ public:
 	// Public functions and variables used by native function calls from Java.
 public:
 	ovrMessageQueue &	GetMessageQueue();
+	ovrInputEventRing &	GetInputEvents() { return InputEvents; }
 	void				SetActivity( JNIEnv * jni, jobject activity );
 	void				StartVrThread();
 	void				StopVrThread();
@@ -173,7 +176,7 @@ private:
 	float				SuggestedEyeFovDegreesX;
 	float				SuggestedEyeFovDegreesY;
 
-	ovrInputEvents		InputEvents;
+	ovrInputEventRing	InputEvents;					// joystick and key events for the VR thread
 	VrFrameBuilder		TheVrFrame;					// passed to VrAppInterface::Frame()
 	long long			EnteredVrModeFrame;			// frame number when VR mode was last entered
 
@@ -201,7 +204,10 @@ private:
 	double					ErrorMessageEndTime;
 
 	ovrFileSys *		FileSys;
+	ovrReadService *	ReadService;		// created by the first GetReadService()
+	Mutex				ReadServiceMutex;
 	ovrTextureManager *	TextureManager;
+	ovrTextureStreamer *	TextureStreamer;
 
 	//-----------------------------------------------------------------
 
@@ -19,6 +19,10 @@ namespace OVR {
 
 //==============================================================
 // OvrDebugLines
+//
+// Lines live until BeginFrame is called with a frame number at or past their endFrame.
+// The Add functions can be called from any thread. Lines added on threads other than the
+// one that called Init are drawn from the next AppendSurfaceList.
 class OvrDebugLines
 {
 public:
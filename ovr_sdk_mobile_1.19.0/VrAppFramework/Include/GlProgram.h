@@ -29,7 +29,8 @@ namespace OVR
 #define MAX_JOINTS_STRING		STRINGIZE_VALUE( MAX_JOINTS )
 
 // No attempt is made to support sharing shaders between programs,
-// it isn't worth avoiding the duplication.
+// it isn't worth avoiding the duplication. Identical programs are shared
+// though, see GlProgram::Build().
 
 // Shader uniforms Texture0 - Texture7 are bound to texture units 0 - 7
 
@@ -98,11 +99,40 @@ struct ovrUniformData
 	int				Count;	// number of items of ovrProgramParmType in the Data buffer
 };
 
+// Counts of how GlProgram::Build() got its programs.
+struct ovrProgramCacheStats
+{
+	ovrProgramCacheStats()
+		: Compiled( 0 )
+		, Shared( 0 )
+		, LoadedBinaries( 0 )
+		, RejectedBinaries( 0 )
+	{
+	}
+
+	int		Compiled;			// compiled and linked from source
+	int		Shared;				// the program of an earlier Build() that was not yet freed
+	int		LoadedBinaries;		// loaded from the binary cache
+	int		RejectedBinaries;	// binaries that were out of date or refused by the driver
+};
+
 //==============================================================
 // GlProgram
 // Freely copyable. In general, the compilation unit that calls Build() should
 // be the compilation unit that calls Free(). Other copies of the object should
 // never Free().
+//
+// Programs are cached by a hash of their version, directives, sources and parms.
+// Building a program that was already built and not yet freed returns the same GL
+// program with the same uniform locations, and the GL program is only deleted when
+// every Build() of it has been matched by a Free(). As the programs are shared,
+// uniform values set directly with glUniform*() are shared as well.
+//
+// When a binary cache path is set, linked programs are saved there together with
+// their uniform locations, and later runs load them instead of compiling them, as
+// long as the driver is the same and accepts them.
+//
+// All of these functions must be called on the thread of the GL context.
 struct GlProgram
 {
 	GlProgram()
@@ -147,6 +177,24 @@ struct GlProgram
 
 	static void					Free( GlProgram & program );
 
+	// Starts compiling and linking a program without waiting for the driver, so that the
+	// compiles of several programs can overlap, on drivers that compile on other threads.
+	// A later Build() with the same arguments waits for the program and returns it.
+	static void					Prefetch( const char * vertexDirectives, const char * vertexSrc,
+										  const char * fragmentDirectives, const char * fragmentSrc,
+										  const ovrProgramParm * parms, const int numParms,
+										  const int programVersion = GLSL_PROGRAM_VERSION );
+
+	// Call before the GL context is destroyed. Deletes the prefetched programs that were
+	// never built, and forgets the programs that were not freed, so that they are not
+	// shared with a later context.
+	static void					ShutdownCache();
+
+	// Directory where linked program binaries are saved, or NULL to not save them.
+	static void					SetBinaryCachePath( const char * path );
+
+	static ovrProgramCacheStats	GetCacheStats();
+
 	static void					SetUseMultiview( const bool useMultiview_ );
 
 	bool						IsValid() const { return Program != 0; }
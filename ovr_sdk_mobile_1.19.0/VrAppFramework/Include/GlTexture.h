@@ -14,6 +14,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_Types.h"
 #include "Kernel/OVR_BitFlags.h"
 #include "Kernel/OVR_MemBuffer.h"
+#include "Kernel/OVR_Alg.h"
 #include "OVR_GlUtils.h"
 
 #include "VrApi_Types.h"
@@ -222,6 +223,52 @@ GlTexture	LoadTextureFromUri( class ovrFileSys & fileSys, const char * uri,
 
 unsigned char * LoadPVRBuffer( const char * fileName, int & width, int & height );
 
+bool		IsCompressedTextureFormat( const eTextureFormat format );
+
+// The mip levels of a 2D texture in CPU memory, ready to be uploaded.
+class ovrDecodedTexture
+{
+public:
+	static const int		MAX_LEVELS = 16;
+
+	ovrDecodedTexture()
+		: Format( Texture_None )
+		, UseSrgb( false )
+		, Width( 0 )
+		, Height( 0 )
+		, NumLevels( 0 )
+	{
+	}
+
+	int		GetLevelWidth( const int level ) const { return Alg::Max( Width >> level, 1 ); }
+	int		GetLevelHeight( const int level ) const { return Alg::Max( Height >> level, 1 ); }
+	const uint8_t *	GetLevelData( const int level ) const { return static_cast< const uint8_t * >( Data ) + LevelOffset[level]; }
+
+	eTextureFormat			Format;
+	bool					UseSrgb;
+	int						Width;
+	int						Height;
+	int						NumLevels;
+	size_t					LevelOffset[MAX_LEVELS];
+	size_t					LevelSize[MAX_LEVELS];
+	MemBufferT< uint8_t >	Data;
+};
+
+// Reads the size of the image from the file header without decoding it. isStreamable is
+// set if DecodeTextureFromBuffer() can decode the file.
+bool		GetTextureSizeFromBuffer( const char * fileName, const uint8_t * buffer, const size_t bufferLength,
+				int & width, int & height, bool & isStreamable );
+
+// The CPU side of LoadTextureFromBuffer() for 2D textures. Nothing is uploaded, so this can
+// be called on any thread. Images loaded by stb_image have their mip levels generated here
+// instead of with glGenerateMipmap. Only stb_image files and single face KTX files are
+// supported.
+bool		DecodeTextureFromBuffer( const char * fileName, const uint8_t * buffer, const size_t bufferLength,
+				const TextureFlags_t & flags, ovrDecodedTexture & decoded );
+// The same for an RGBA image that is already decoded. The image is copied.
+bool		DecodeTextureFromRGBA( const uint8_t * image, const int width, const int height,
+				const TextureFlags_t & flags, ovrDecodedTexture & decoded );
+
 // glDeleteTextures()
 // Can be safely called on a 0 texture without checking.
 void		FreeTexture( GlTexture texId );
@@ -0,0 +1,89 @@
+/************************************************************************************
+
+Filename    :   InputEventRing.h
+Content     :   Fixed-capacity ring of timestamped joystick and key events.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_InputEventRing_h )
+#define OVR_InputEventRing_h
+
+#include "Kernel/OVR_Types.h"
+#include <atomic>
+#include <stdint.h>
+
+namespace OVR {
+
+enum ovrInputEventType
+{
+	INPUT_EVENT_JOYSTICKS,
+	INPUT_EVENT_KEY
+};
+
+struct ovrInputEvent
+{
+	double				TimeInSeconds;		// when the event happened, on the vrapi_GetTimeInSeconds() clock
+	ovrInputEventType	Type;
+	union
+	{
+		float			JoySticks[2][2];	// INPUT_EVENT_JOYSTICKS, laid out like VrInput::sticks
+		struct
+		{
+			int			KeyCode;			// ovrKeyCode, with BUTTON_JOYPAD_FLAG for joypad buttons
+			int			RepeatCount;
+			bool		Down;
+		}				Key;				// INPUT_EVENT_KEY
+	};
+};
+
+//==============================================================
+// ovrInputEventRing
+// Carries input from the threads that receive it to the VR thread without locks or
+// allocations. Any thread can post, and only the VR thread reads. Each slot has a
+// sequence number that tells whether it holds an event that has been fully written.
+//
+// Joystick events are state, so the reader only keeps the latest one, and they are
+// refused once the ring is nearly full so that there is always room for key events,
+// which are transitions that cannot be lost.
+class ovrInputEventRing
+{
+public:
+	static const int	CAPACITY = 256;				// power of 2
+	static const int	RESERVED_FOR_KEYS = 16;
+
+						ovrInputEventRing();
+
+	// Thread safe. Return false if the event was dropped because the ring is full.
+	bool				PostJoySticks( const double timeInSeconds, const float lx, const float ly, const float rx, const float ry );
+	bool				PostKey( const double timeInSeconds, const int keyCode, const bool down, const int repeatCount );
+
+	// Only the reading thread may call these. Returns the oldest event, or NULL if there
+	// are none, which stays in the ring until Pop() is called.
+	const ovrInputEvent *	Peek() const;
+	void				Pop();
+
+	// Events dropped because the ring was full.
+	int					GetNumDropped() const { return NumDropped.load( std::memory_order_relaxed ); }
+
+private:
+	struct ovrSlot
+	{
+		std::atomic< uint32_t >	Sequence;		// position + 1 when written, position + CAPACITY when read
+		ovrInputEvent			Event;
+	};
+
+	ovrSlot					Slots[CAPACITY];
+	std::atomic< uint32_t >	Head;				// next position to post to
+	std::atomic< uint32_t >	Tail;				// next position to read
+	std::atomic< int >		NumDropped;
+
+	bool				Post( const ovrInputEvent & event, const int minFree );
+};
+
+} // namespace OVR
+
+#endif // OVR_InputEventRing_h
@@ -44,6 +44,11 @@ public:
 	virtual bool			FileExists( char const * uri ) = 0;
 	// Gets the local path for the specified URI. File must exist. Returns false if path is not accessible directly by the file system.
 	virtual bool			GetLocalPathForURI( char const * uri, String &outputPath ) = 0;
+	// Gets the local file and the range of it that hold the data of the specified URI, for
+	// reading it without a stream. Returns false if the data is not stored as is in a local
+	// file, as for compressed files in an apk. outMap is true if the range is in a package
+	// and is better mapped than read.
+	virtual bool			GetLocalRangeForURI( char const * uri, String & outPath, size_t & outOffset, size_t & outLength, bool & outMap ) = 0;
 };
 
 } // namespace OVR
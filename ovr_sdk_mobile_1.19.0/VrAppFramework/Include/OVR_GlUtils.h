@@ -24,6 +24,7 @@ struct ovrOpenGLExtensions
 	bool EXT_disjoint_timer_query;
 	bool EXT_sRGB_texture_decode;
 	bool EXT_texture_border_clamp;
+	bool KHR_texture_compression_astc_ldr;
 	bool OVR_multiview2;
 };
 
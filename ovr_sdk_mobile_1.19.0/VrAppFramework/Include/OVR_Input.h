@@ -348,6 +348,7 @@ struct VrInput
 		ovrKeyCode		KeyCode;		// Android key code from <android/keycodes.h>
 		int				RepeatCount;	// > 0 if down event from a key that is held down.
 		KeyEventType	EventType;		// up, down, short-press, long-press
+		double			TimeInSeconds;	// when the event happened, on the vrapi_GetTimeInSeconds() clock
 	}	KeyEvents[MAX_KEY_EVENTS_PER_FRAME];
 
 
@@ -0,0 +1,116 @@
+/************************************************************************************
+
+Filename    :   OVR_PackWriter.h
+Content     :   Writes generated assets into zip packs, compressing them on worker threads.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_PackWriter_h )
+#define OVR_PackWriter_h
+
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_String.h"
+#include "Kernel/OVR_StringHash.h"
+#include "Kernel/OVR_Threads.h"
+#include "Kernel/OVR_MemBuffer.h"
+#include <stdio.h>
+
+namespace OVR {
+
+//==============================================================
+// ovrPackWriter
+// Writes a zip file that ovr_OpenOtherApplicationPackage() and apk: streams read like an
+// application package, so a cache of thousands of small files is one file to open. Files
+// are compressed on worker threads and written in the order they were added as they
+// finish, so only MAX_PENDING_BYTES of them are held in memory. Files that are already
+// compressed, like JPEG and KTX, and files added with store set are stored and aligned, so
+// the range that ovr_GetStoredFileRangeInPackage() gives can be mapped and used in place.
+//
+// A new pack is written next to its path and renamed over it by Close(). An append writes
+// the new files and then a new central directory after the end of the pack, so the files
+// already in the pack stay readable until Close() and after an append that does not
+// finish: the next Open() drops the unfinished tail. The pack should not be opened for
+// reading while an append is in progress. Packs are limited to 4 GB and 65535 files.
+//
+// AddFile() and Close() are called from one thread.
+class ovrPackWriter
+{
+public:
+	static const int		DEFAULT_NUM_THREADS = 2;
+	static const int		DEFAULT_COMPRESSION_LEVEL = 6;
+	static const size_t		MAX_PENDING_BYTES = 32 * 1024 * 1024;	// added but not yet written
+	static const size_t		STORED_ALIGNMENT = 4;
+	static const size_t		PAGE_ALIGNMENT = 4096;
+	static const size_t		PAGE_ALIGNED_LENGTH = 64 * 1024;		// stored files this long start on a page
+
+							ovrPackWriter();
+							~ovrPackWriter();	// aborts if still open
+
+	// Starts a new pack at path, or adds to the one there when append is set. Appending to a
+	// pack that has more unused space, from earlier appends, than files copies the files
+	// into a new pack instead. With zero threads the files are compressed by the calling
+	// thread; otherwise it helps while it waits.
+	bool					Open( char const * path, const bool append,
+								const int numThreads = DEFAULT_NUM_THREADS,
+								const int compressionLevel = DEFAULT_COMPRESSION_LEVEL );
+	// Adds a file, copying its data. Fails if a file with the name is already in the pack.
+	bool					AddFile( char const * name, void const * data, const size_t length,
+								const bool store = false );
+	// Adds a file and takes its buffer.
+	bool					AddFile( char const * name, MemBufferT< uint8_t > & buffer,
+								const bool store = false );
+	// Writes the files that are still pending and the central directory. If anything could
+	// not be written, the pack is left as it was before Open() and false is returned.
+	bool					Close();
+	// Leaves the pack as it was before Open().
+	void					Abort();
+
+	bool					IsOpen() const { return Zip != NULL; }
+	bool					HasFile( char const * name ) const { return Names.GetCaseInsensitive( name ) != NULL; }
+	// The files in the pack, including the ones added since Open().
+	int						GetNumFiles() const { return (int)Names.GetSize(); }
+
+private:
+	struct ovrPackEntry;
+
+	String					Path;
+	String					WritePath;			// Path, or the new pack that is renamed over it
+	size_t					OriginalLength;		// of the pack when appending to it in place
+	void *					Zip;
+	FILE *					File;				// that Zip writes
+	bool					SyncOnClose;
+	bool					Failed;
+	int						CompressionLevel;
+	uint32_t				DosDate;
+	StringHash< bool >		Names;
+
+	Array< Thread * >		Threads;
+	Mutex					QueueMutex;
+	WaitCondition			QueueWake;			// a file was added or exiting
+	WaitCondition			DoneWake;			// a file was compressed
+	Array< ovrPackEntry * >	Queue;				// not written yet, in the order they were added
+	int						NextWrite;
+	int						NextCompress;
+	size_t					PendingBytes;
+	bool					Exiting;
+
+	static threadReturn_t	ThreadFn( Thread * thread, void * data );
+	static void *			OpenCallback( void * opaque, const void * fileName, int mode );
+	static int				CloseCallback( void * opaque, void * stream );
+
+	void					StopThreads();
+	bool					CopyFiles( void * pack );
+	void					Compress( ovrPackEntry & entry ) const;
+	bool					WriteFinished( const bool waitForAll );
+	bool					WriteFile( char const * name, uint8_t const * data, const size_t length,
+								const int method, const uint32_t crc, const size_t uncompressedLength );
+	void					Restore();
+};
+
+} // namespace OVR
+
+#endif // OVR_PackWriter_h
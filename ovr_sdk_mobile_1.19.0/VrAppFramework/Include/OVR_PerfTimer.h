@@ -14,6 +14,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "Kernel/OVR_LogUtils.h"
 #include "SystemClock.h"
+#include "OVR_Profiler.h"
 
 namespace OVR
 {
@@ -135,8 +136,14 @@ private:
 //
 // On exiting the scope, ovrPerfTimer will deconstruct and output the
 // time spent in the scope.
+//
+// If OVR_USE_PROFILER is defined instead, all of the macros below record zones with
+// ovrProfiler (see OVR_Profiler.h) and nothing is logged. Accumulated timers become one
+// zone per pass, and reports are left to the trace viewer.
 
-#if defined( OVR_USE_PERF_TIMER )
+#if defined( OVR_USE_PROFILER )
+#	define OVR_PERF_TIMER( name_ )	ovrProfileZone name_##_Timer( #name_ )
+#elif defined( OVR_USE_PERF_TIMER )
 #	define OVR_PERF_TIMER( name_ )	ovrPerfTimer name_##_Timer( #name_, nullptr )
 #else
 #	define OVR_PERF_TIMER( name_ ) 
@@ -150,7 +157,15 @@ private:
 // defined, use OVR_PERF_ACCUMULATOR() at file scope, then in the other compilation
 // unit, use OVR_PERF_ACCUMULATR_EXTERN() to declare the extern definition of the
 // accumulator.
-#if defined( OVR_USE_PERF_TIMER )
+#if defined( OVR_USE_PROFILER )
+#	define OVR_PERF_ACCUMULATOR( name_ )
+#	define OVR_PERF_ACCUMULATE( name_ ) ovrProfileZone name_##_Timer( #name_ )
+#	define OVR_PERF_REPORT( name_ )
+#	define OVR_PERF_REPORT_MSG( name_, msg_ )
+#	define OVR_PERF_ACCUMULATOR_EXTERN( name_ )
+#	define OVR_PERF_TIMER_STOP( name_ ) name_##_Timer.End()
+#	define OVR_PERF_TIMER_STOP_MSG( name_, msg_ ) name_##_Timer.End()
+#elif defined( OVR_USE_PERF_TIMER )
 #	define OVR_PERF_ACCUMULATOR( name_ ) ovrPerfTimerAccumulator name_##_Accumulator( #name_ )
 #	define OVR_PERF_ACCUMULATE( name_ ) ovrPerfTimer name_##_Timer( #name_, & name_##_Accumulator )
 #	define OVR_PERF_REPORT( name_ ) name_##_Accumulator.Report( nullptr )
@@ -0,0 +1,186 @@
+/************************************************************************************
+
+Filename    :   OVR_Profiler.h
+Content     :   Records nested timing zones, counters and frame markers per thread.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_Profiler_h )
+#define OVR_Profiler_h
+
+#include "Kernel/OVR_Types.h"
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+namespace OVR {
+
+enum ovrProfileEventType
+{
+	PROFILE_EVENT_ZONE_BEGIN,
+	PROFILE_EVENT_ZONE_END,
+	PROFILE_EVENT_COUNTER,
+	PROFILE_EVENT_FRAME
+};
+
+struct ovrProfileEvent
+{
+	uint64_t		Ticks;
+	const char *	Name;		// not copied, so it must be a string literal
+	double			Value;		// counter value or frame number
+	uint32_t		Type;		// ovrProfileEventType
+};
+
+//==============================================================
+// ovrProfileRing
+// The events of one thread. Only the thread that owns the ring writes to it, and once it is
+// full the oldest events are overwritten, so the ring always holds the last events.
+// Begun is advanced before an event is written and Head after, so a reader can tell which
+// of the events it copied may have been overwritten while it copied them.
+struct ovrProfileRing
+{
+	std::atomic< uint64_t >	Begun;
+	std::atomic< uint64_t >	Head;
+	uint64_t				Mask;
+	ovrProfileEvent *		Events;
+	int						ThreadId;
+	char					ThreadName[32];
+};
+
+//==============================================================
+// ovrProfiler
+// Nothing is recorded until Start() is called. Zones are recorded as begin and end events
+// with the raw ticks of the CPU's counter on ARM64 and of the monotonic clock elsewhere,
+// into a ring per thread without locks. A capture copies the rings of every thread, and
+// is written as a Chrome trace (chrome://tracing or ui.perfetto.dev) or as a compact binary
+// file that can be turned into a Chrome trace later.
+//
+// The framework marks the start of every frame on the VR thread, and the adb console
+// commands "profileStart [eventsPerThread]", "profileStop" and "profileWrite [path] [maxFrames]"
+// control the profiler in any app. A path ending in ".json" is written as a Chrome trace.
+class ovrProfiler
+{
+public:
+	static const int	DEFAULT_EVENTS_PER_THREAD = 16384;
+	static const int	MAX_THREADS = 64;
+
+	// Rings are created the first time a thread records an event after Start(), with
+	// eventsPerThread rounded up to a power of 2. Rings that already exist keep their size.
+	static void			Start( const int eventsPerThread = DEFAULT_EVENTS_PER_THREAD );
+	static void			Stop();
+	static bool			IsRecording() { return Recording.load( std::memory_order_relaxed ); }
+
+	static void			BeginZone( const char * name ) { Record( PROFILE_EVENT_ZONE_BEGIN, name, 0.0 ); }
+	static void			EndZone( const char * name ) { Record( PROFILE_EVENT_ZONE_END, name, 0.0 ); }
+	static void			Counter( const char * name, const double value ) { Record( PROFILE_EVENT_COUNTER, name, value ); }
+	static void			FrameMarker( const long long frameNumber ) { Record( PROFILE_EVENT_FRAME, "Frame", (double)frameNumber ); }
+	// Threads are named after their system name. This overrides it for the calling thread.
+	static void			SetThreadName( const char * name );
+
+	// Events since Start() of every thread, limited to the last maxFrames frame markers if
+	// maxFrames is not 0. Recording does not need to be stopped.
+	static bool			WriteChromeTrace( const char * path, const int maxFrames = 0 );
+	static bool			WriteCapture( const char * path, const int maxFrames = 0 );
+	static bool			ConvertCaptureToChromeTrace( const char * capturePath, const char * tracePath );
+
+	static void			RegisterConsoleFunctions();
+
+	static uint64_t		GetTicks()
+	{
+#if defined( __aarch64__ )
+		uint64_t ticks;
+		__asm__ volatile( "mrs %0, cntvct_el0" : "=r"( ticks ) );
+		return ticks;
+#else
+		return static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >(
+				std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+	}
+	static uint64_t		GetTicksPerSecond();
+
+private:
+	static std::atomic< bool >				Recording;
+	static thread_local ovrProfileRing *	ThreadRing;
+
+	static ovrProfileRing *	CreateThreadRing();
+
+	static void			Record( const uint32_t type, const char * name, const double value )
+	{
+		if ( !Recording.load( std::memory_order_relaxed ) )
+		{
+			return;
+		}
+		ovrProfileRing * ring = ThreadRing;
+		if ( ring == nullptr )
+		{
+			ring = CreateThreadRing();
+			if ( ring == nullptr )
+			{
+				return;
+			}
+		}
+		const uint64_t head = ring->Head.load( std::memory_order_relaxed );
+		ring->Begun.store( head + 1, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_release );
+		ovrProfileEvent & event = ring->Events[head & ring->Mask];
+		event.Ticks = GetTicks();
+		event.Name = name;
+		event.Value = value;
+		event.Type = type;
+		ring->Head.store( head + 1, std::memory_order_release );
+	}
+};
+
+//==============================================================
+// ovrProfileZone
+class ovrProfileZone
+{
+public:
+	explicit ovrProfileZone( const char * name )
+		: Name( name )
+	{
+		ovrProfiler::BeginZone( name );
+	}
+
+	~ovrProfileZone()
+	{
+		End();
+	}
+
+	// Ends the zone before the end of the scope.
+	void	End()
+	{
+		if ( Name != nullptr )
+		{
+			ovrProfiler::EndZone( Name );
+			Name = nullptr;
+		}
+	}
+
+private:
+	const char *	Name;
+
+	ovrProfileZone( const ovrProfileZone & ) = delete;
+	ovrProfileZone & operator = ( const ovrProfileZone & ) = delete;
+};
+
+// Define OVR_USE_PROFILER before including this file, or for the whole build with
+// LOCAL_CFLAGS, to record zones. OVR_PERF_TIMER() and the other OVR_PerfTimer.h macros
+// also record zones instead of logging when it is defined.
+#if defined( OVR_USE_PROFILER )
+#	define OVR_PROFILE_ZONE( name_ )				ovrProfileZone name_##_Zone( #name_ )
+#	define OVR_PROFILE_ZONE_END( name_ )			name_##_Zone.End()
+#	define OVR_PROFILE_COUNTER( name_, value_ )	ovrProfiler::Counter( #name_, value_ )
+#else
+#	define OVR_PROFILE_ZONE( name_ )
+#	define OVR_PROFILE_ZONE_END( name_ )
+#	define OVR_PROFILE_COUNTER( name_, value_ )
+#endif
+
+} // namespace OVR
+
+#endif // OVR_Profiler_h
@@ -0,0 +1,184 @@
+/************************************************************************************
+
+Filename    :   OVR_ReadService.h
+Content     :   Reads files on worker threads, in priority order.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_ReadService_h )
+#define OVR_ReadService_h
+
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_String.h"
+#include "Kernel/OVR_StringHash.h"
+#include "Kernel/OVR_Threads.h"
+#include "Kernel/OVR_MemBuffer.h"
+#include <atomic>
+
+namespace OVR {
+
+class ovrFileSys;
+class ovrReadService;
+class MappedFile;
+class MappedView;
+
+enum ovrReadPriority
+{
+	OVR_READ_PRIORITY_URGENT,		// something is waiting on it, like the current frame
+	OVR_READ_PRIORITY_HIGH,
+	OVR_READ_PRIORITY_NORMAL,
+	OVR_READ_PRIORITY_LOW,			// prefetching
+	OVR_READ_PRIORITY_MAX
+};
+
+enum ovrReadStatus
+{
+	OVR_READ_PENDING,
+	OVR_READ_COMPLETE,
+	OVR_READ_FAILED,
+	OVR_READ_CANCELED
+};
+
+class ovrReadRequest;
+
+// Called on a worker thread when a request completes or fails, before Wait() returns.
+// Not called for canceled requests.
+typedef void ( *ovrReadCallback )( ovrReadRequest & request, void * userData );
+
+//==============================================================
+// ovrReadRequest
+// A read queued on an ovrReadService. The request is the handle to the read and holds
+// its data; the caller gets a reference to it and must Release() it when done.
+class ovrReadRequest
+{
+public:
+	ovrReadStatus		GetStatus() const { return Status.load( std::memory_order_acquire ); }
+	// Blocks until the request is no longer pending and returns its status. A request that
+	// is still queued is moved to OVR_READ_PRIORITY_URGENT first.
+	ovrReadStatus		Wait();
+
+	// Valid once the status is OVR_READ_COMPLETE, until the request is released.
+	uint8_t const *		GetData() const { return Data; }
+	size_t				GetLength() const { return Length; }
+	// True if the data is mapped from the file instead of read into memory.
+	bool				IsMapped() const;
+
+	void				AddRef() { RefCount.fetch_add( 1, std::memory_order_relaxed ); }
+	void				Release();
+
+private:
+	friend class ovrReadService;
+
+	struct ovrReadFile;
+
+	// The memory that holds the data of one or more requests.
+	struct ovrReadBlock
+	{
+		std::atomic< int >		RefCount;
+		MemBufferT< uint8_t >	Memory;
+		MappedView *			View;
+	};
+
+							ovrReadRequest();
+							~ovrReadRequest();
+
+	ovrReadService *		Service;
+	std::atomic< int >		RefCount;
+	std::atomic< ovrReadStatus >	Status;
+
+	// Guarded by the service mutex.
+	String					Uri;			// set for ReadUri() until it is resolved to a file
+	ovrReadFile *			File;
+	size_t					Offset;
+	size_t					Length;
+	bool					Map;
+	ovrReadPriority			Priority;
+	bool					Queued;
+	bool					Canceled;		// canceled while it was being read
+	bool					Finished;		// the callback has returned
+
+	ovrReadCallback			Callback;
+	void *					UserData;
+	ovrReadBlock *			Block;
+	uint8_t const *			Data;
+
+	static void				ReleaseBlock( ovrReadBlock * block );
+};
+
+//==============================================================
+// ovrReadService
+// Reads files and ranges of files on worker threads, so loaders and the frame thread
+// don't block on storage. Requests are served highest priority first, and in order within
+// a priority. Queued reads that are close together in the same file are made with one
+// read. Files stored uncompressed in an apk are mapped instead of read, so they don't
+// go through the package mutex, and compressed ones still go through ovrFileSys on a
+// worker thread.
+class ovrReadService
+{
+public:
+	static const int		DEFAULT_NUM_THREADS = 2;
+	static const size_t		MAX_COALESCE_GAP = 16 * 1024;			// bytes read and thrown away between two requests
+	static const size_t		MAX_COALESCED_LENGTH = 1024 * 1024;
+	static const int		MAX_IDLE_FILES = 16;					// kept open with nothing queued
+
+							ovrReadService();
+							~ovrReadService();
+
+	// fileSys is only needed for ReadUri() and must outlive the service.
+	void					Init( ovrFileSys * fileSys = NULL, const int numThreads = DEFAULT_NUM_THREADS );
+	// Cancels the requests that are still queued and waits for the ones being read.
+	void					Shutdown();
+
+	// Reads length bytes at offset in a local file. Reading past the end of the file fails.
+	ovrReadRequest *		Read( char const * path, const size_t offset, const size_t length,
+								const ovrReadPriority priority, ovrReadCallback callback = NULL, void * userData = NULL );
+	// Maps length bytes at offset in a local file, for data that is used in place.
+	ovrReadRequest *		Map( char const * path, const size_t offset, const size_t length,
+								const ovrReadPriority priority, ovrReadCallback callback = NULL, void * userData = NULL );
+	// Reads the whole resource at uri.
+	ovrReadRequest *		ReadUri( char const * uri, const ovrReadPriority priority,
+								ovrReadCallback callback = NULL, void * userData = NULL );
+
+	// Returns true if the request will not complete. A request that is being read is
+	// canceled when the read finishes.
+	bool					Cancel( ovrReadRequest * request );
+
+	// Reads made from files, after coalescing.
+	int						GetNumFileReads() const { return NumFileReads.load( std::memory_order_relaxed ); }
+
+private:
+	typedef ovrReadRequest::ovrReadFile ovrReadFile;
+
+	ovrFileSys *			FileSys;
+	Array< Thread * >		Threads;
+
+	Mutex					QueueMutex;
+	WaitCondition			QueueWake;		// a request was queued
+	WaitCondition			FinishedWake;	// a request finished
+	Array< ovrReadRequest * >	Queue[OVR_READ_PRIORITY_MAX];
+	StringHash< ovrReadFile * >	Files;
+	bool					Exiting;
+	std::atomic< int >		NumFileReads;
+
+	friend class ovrReadRequest;
+
+	static threadReturn_t	ThreadFn( Thread * thread, void * data );
+
+	ovrReadRequest *		Submit( ovrReadRequest * request, const ovrReadPriority priority );
+	ovrReadFile *			FindOrAddFile( char const * path );
+	void					CloseIdleFiles();
+	ovrReadRequest *		PopNext();
+	void					Unqueue( ovrReadRequest * request );
+	void					Gather( ovrReadRequest * seed, Array< ovrReadRequest * > & batch );
+	void					ReadBatch( Array< ovrReadRequest * > & batch );
+	void					ResolveUri( ovrReadRequest * request );
+	void					Finish( ovrReadRequest * request, ovrReadRequest::ovrReadBlock * block, uint8_t const * data, const size_t length );
+};
+
+} // namespace OVR
+
+#endif // OVR_ReadService_h
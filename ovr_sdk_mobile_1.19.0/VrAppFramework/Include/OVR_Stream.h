@@ -45,6 +45,10 @@ public:
 	void				Close();
 
 	bool				GetLocalPathFromUri( const char *uri, String &outputPath );
+
+	// Gets the local file and the range of it that hold the stream's data, if the data is
+	// stored there as is. outMap is true if the range is better mapped than read.
+	bool				GetLocalRange( String & outPath, size_t & outOffset, size_t & outLength, bool & outMap );
 	
 	// Reads the specified number of bytes from the stream into outBuffer. 
 	// outBytesRead will contain the number of bytes read into outBuffer.
@@ -84,6 +88,7 @@ private:
 
 private:
 	virtual bool			GetLocalPathFromUri_Internal( const char *uri, String &outputPath ) = 0;
+	virtual bool			GetLocalRange_Internal( String & outPath, size_t & outOffset, size_t & outLength, bool & outMap ) = 0;
 	virtual bool			Open_Internal( char const * Uri, ovrStreamMode const mode ) = 0;
 	virtual void			Close_Internal() = 0;
 	virtual bool			Read_Internal( MemBufferT< uint8_t > & outBuffer, size_t const bytesToRead, size_t & outBytesRead ) = 0;
@@ -0,0 +1,106 @@
+/************************************************************************************
+
+Filename    :   OVR_TextureEncoder.h
+Content     :   Compresses RGBA images to ETC2 and ASTC on the CPU.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_TextureEncoder_h )
+#define OVR_TextureEncoder_h
+
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Atomic.h"
+#include "Kernel/OVR_Threads.h"
+#include "GlTexture.h"
+
+namespace OVR {
+
+enum ovrTextureEncodeQuality
+{
+	TEXTURE_ENCODE_FAST,	// one candidate per block mode
+	TEXTURE_ENCODE_NORMAL,	// all block modes, one refinement pass
+	TEXTURE_ENCODE_HIGH		// searches neighboring endpoints and weight grids
+};
+
+//==============================================================
+// ovrTextureEncoder
+// Compresses images fast enough to be done at load time, so that large images like
+// panoramas take a quarter (ASTC 4x4) to an eighth (ETC2) or less of the memory and
+// bandwidth of RGBA once uploaded.
+//
+// ETC2 RGB blocks use the individual, differential and planar modes; the T and H modes
+// are never chosen. ASTC blocks are LDR RGB with one partition and a single plane of
+// 3 bit weights. 6x6 blocks store a 4x4 or a 5x5 grid of weights. Alpha is ignored.
+//
+// The rows of blocks are split between the worker threads and the calling thread, and the
+// inner loops of the block searches use SSE or NEON when available.
+class ovrTextureEncoder
+{
+public:
+	static const int		DEFAULT_NUM_THREADS = 3;
+
+							ovrTextureEncoder();
+							~ovrTextureEncoder();
+
+	// numThreads worker threads are started to help the thread that calls Encode().
+	void					Init( const int numThreads = DEFAULT_NUM_THREADS );
+	void					Shutdown();
+
+	// Texture_ETC2_RGB, Texture_ASTC_4x4 and Texture_ASTC_6x6, and the sRGB versions of the ASTC
+	// formats, whose blocks are the same.
+	static bool				CanEncode( const eTextureFormat format );
+	static size_t			GetEncodedSize( const eTextureFormat format, const int width, const int height );
+
+	// Encodes one RGBA image into GetEncodedSize() bytes of blocks. Blocks until done.
+	// Calls from several threads are run one after the other.
+	bool					Encode( const uint8_t * rgba, const int width, const int height,
+								const eTextureFormat format, const ovrTextureEncodeQuality quality, uint8_t * blocks );
+
+	// Builds up to numLevels mip levels from an RGBA image, halving it with QuarterImageSize(),
+	// and encodes all of them. The chain stops before a level that would have to be made from
+	// a level with a width or height of 1, so encoded.NumLevels can be less than numLevels.
+	bool					EncodeMipChain( const uint8_t * rgba, const int width, const int height, const int numLevels,
+								const eTextureFormat format, const bool useSrgb, const ovrTextureEncodeQuality quality,
+								ovrDecodedTexture & encoded );
+
+private:
+	struct ovrEncodeJob
+	{
+		const uint8_t *				Rgba;
+		int							Width;
+		int							Height;
+		eTextureFormat				Format;
+		ovrTextureEncodeQuality		Quality;
+		uint8_t *					Blocks;
+		int							NumRows;	// rows of blocks
+		AtomicInt< int >			NextRow;
+	};
+
+	Array< Thread * >		Threads;
+	Mutex					EncodeMutex;	// one Encode() at a time
+
+	Mutex					JobMutex;
+	WaitCondition			JobWake;
+	WaitCondition			JobDone;
+	ovrEncodeJob *			Job;
+	int						JobSequence;
+	int						NumActiveWorkers;	// workers that are encoding rows of Job
+	bool					Exiting;
+
+	static threadReturn_t	ThreadFn( Thread * thread, void * data );
+	// Encodes rows of the job until there are none left.
+	void					EncodeRows( ovrEncodeJob & job );
+};
+
+// Decodes blocks produced by ovrTextureEncoder back to RGBA, with alpha set to 255, to
+// measure the error of the encoder. Other ETC2 and ASTC block modes decode as magenta.
+void	DecodeTextureBlocks( const uint8_t * blocks, const int width, const int height,
+			const eTextureFormat format, uint8_t * rgba );
+
+} // namespace OVR
+
+#endif // OVR_TextureEncoder_h
@@ -0,0 +1,155 @@
+/************************************************************************************
+
+Filename    :   OVR_TextureStreamer.h
+Content     :   Decodes textures on worker threads and uploads them under a per-frame budget.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_TextureStreamer_h )
+#define OVR_TextureStreamer_h
+
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_String.h"
+#include "Kernel/OVR_Threads.h"
+#include "GlTexture.h"
+
+namespace OVR {
+
+//==============================================================
+// ovrTextureUploader
+// The GL calls made by ovrTextureStreamer, so that the upload scheduling can be run
+// against a mock without a GPU.
+class ovrTextureUploader
+{
+public:
+	virtual				~ovrTextureUploader() {}
+
+	virtual GLuint		CreateTexture( const bool mipmapped ) = 0;
+	virtual void		DeleteTexture( const GLuint texture ) = 0;
+	// Defines a mip level. If data is NULL an uncompressed level is only allocated, and is
+	// filled in with UploadRows().
+	virtual void		DefineLevel( const GLuint texture, const int level, const eTextureFormat format, const bool useSrgb,
+							const int width, const int height, const void * data, const size_t dataSize ) = 0;
+	virtual void		UploadRows( const GLuint texture, const int level, const eTextureFormat format, const bool useSrgb,
+							const int y, const int width, const int height, const void * data ) = 0;
+	// Limits sampling to the levels that have been uploaded.
+	virtual void		SetLevelRange( const GLuint texture, const int baseLevel, const int maxLevel ) = 0;
+	virtual double		GetTimeInSeconds() const = 0;
+};
+
+//==============================================================
+// ovrTextureUploaderGl
+class ovrTextureUploaderGl : public ovrTextureUploader
+{
+public:
+	virtual GLuint		CreateTexture( const bool mipmapped );
+	virtual void		DeleteTexture( const GLuint texture );
+	virtual void		DefineLevel( const GLuint texture, const int level, const eTextureFormat format, const bool useSrgb,
+							const int width, const int height, const void * data, const size_t dataSize );
+	virtual void		UploadRows( const GLuint texture, const int level, const eTextureFormat format, const bool useSrgb,
+							const int y, const int width, const int height, const void * data );
+	virtual void		SetLevelRange( const GLuint texture, const int baseLevel, const int maxLevel );
+	virtual double		GetTimeInSeconds() const;
+};
+
+//==============================================================
+// ovrTextureStreamer
+// Loads textures in two stages instead of in one call to LoadTextureFromBuffer(). Files are
+// decoded and their mip levels generated on worker threads, and Update() uploads the
+// decoded levels on the GL thread, limited to a number of bytes and a time per frame.
+// Each texture is uploaded starting with its smallest mip level, and only the levels that
+// have been uploaded are sampled, so a blurry version shows up right away and sharpens
+// over the next frames. Upload of a large uncompressed level is split into rows.
+class ovrTextureStreamer
+{
+public:
+	static const int		DEFAULT_NUM_THREADS = 2;
+
+							ovrTextureStreamer();
+							~ovrTextureStreamer();
+
+	// If uploader is NULL the textures are uploaded with GL. The uploader must outlive the streamer.
+	void					Init( ovrTextureUploader * uploader = NULL, const int numThreads = DEFAULT_NUM_THREADS );
+	// Stops loading. Textures that have not finished stay incomplete, and are still
+	// deleted with FreeTexture().
+	void					Shutdown();
+
+	// Defaults to 2MB and 2 milliseconds per frame. An upload that does not fit in the
+	// remaining budget waits for the next frame, unless nothing was uploaded yet this frame,
+	// so a level that is larger than the budget still goes.
+	void					SetBudget( const size_t bytesPerFrame, const double secondsPerFrame );
+
+	// Must be called on the GL thread. Takes the contents of buffer. The returned texture has
+	// the size read from the file header and can be used right away; it is incomplete, and
+	// samples as black, until its first mip level is uploaded. Files that can't be streamed
+	// are loaded with LoadTextureFromBuffer().
+	GlTexture				LoadTexture( const char * fileName, MemBufferT< uint8_t > & buffer, const TextureFlags_t & flags );
+	// The same for an image that was already decoded to RGBA, like on a loading thread. Only
+	// the mip levels are generated on the worker threads.
+	GlTexture				LoadRGBATexture( MemBufferT< uint8_t > & pixels, const int width, const int height,
+								const TextureFlags_t & flags );
+	// Deletes a texture returned by LoadTexture(), whether or not it has finished loading.
+	void					FreeTexture( GlTexture & texture );
+
+	bool					IsLoading( const GlTexture & texture ) const;
+	int						GetNumLoading() const { return Loading.GetSizeI(); }
+
+	// Uploads decoded levels within the budget. Call once per frame on the GL thread.
+	void					Update();
+
+	size_t					GetLastUpdateBytes() const { return LastUpdateBytes; }
+	double					GetLastUpdateSeconds() const { return LastUpdateSeconds; }
+
+private:
+	struct ovrStreamingTexture
+	{
+		GLuint					Texture;
+		int						Sequence;
+		String					FileName;
+		MemBufferT< uint8_t >	Buffer;
+		int						Width;			// set if Buffer holds RGBA pixels instead of a file
+		int						Height;
+		TextureFlags_t			Flags;
+		ovrDecodedTexture *		Decoded;		// NULL until decoded, and if decoding failed
+		int						NextLevel;		// next level to upload, counting down
+		int						NextRow;		// first row of NextLevel that has not been uploaded
+		bool					Cancelled;
+	};
+
+	ovrTextureUploaderGl	GlUploader;
+	ovrTextureUploader *	Uploader;
+	Array< Thread * >		Threads;
+
+	size_t					BytesPerFrame;
+	double					SecondsPerFrame;
+	size_t					LastUpdateBytes;
+	double					LastUpdateSeconds;
+	int						NextSequence;
+
+	// touched by the GL thread only
+	Array< ovrStreamingTexture * >	Loading;	// every texture that has not finished loading
+	Array< ovrStreamingTexture * >	Ready;		// decoded textures that are being uploaded
+
+	Mutex					QueueMutex;
+	WaitCondition			QueueWake;
+	Array< ovrStreamingTexture * >	DecodeQueue;
+	Array< ovrStreamingTexture * >	Decoded;
+	bool					Exiting;
+
+	GlTexture				Queue( const char * fileName, MemBufferT< uint8_t > & buffer, const int width, const int height,
+								const bool isRGBA, const TextureFlags_t & flags );
+	static threadReturn_t	ThreadFn( Thread * thread, void * data );
+	void					CollectDecoded();
+	ovrStreamingTexture *	NextToUpload() const;
+	// Returns the number of bytes uploaded, 0 if nothing fit in remainingBytes.
+	size_t					UploadNext( ovrStreamingTexture * st, const size_t remainingBytes, const bool mustUpload );
+	void					Finish( ovrStreamingTexture * st );
+};
+
+} // namespace OVR
+
+#endif // OVR_TextureStreamer_h
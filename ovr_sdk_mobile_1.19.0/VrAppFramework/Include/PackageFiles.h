@@ -21,6 +21,18 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 namespace OVR {
 
+//==============================================================
+// ovrPackageFileRead
+// One file of a batch read from a package.
+//==============================================================
+struct ovrPackageFileRead
+{
+	ovrPackageFileRead() : NameInZip( NULL ) {}
+
+	const char *			NameInZip;
+	MemBufferT< uint8_t >	Buffer;		// empty if the file could not be read
+};
+
 //==============================================================
 // OvrApkFile
 // RAII class for application packages
@@ -52,10 +64,22 @@ void			ovr_CloseOtherApplicationPackage( void * & zipFile );
 // These are probably NOT thread safe!
 bool			ovr_OtherPackageFileExists( void * zipFile, const char * nameInZip );
 
+// Gets where the data of a file stored without compression is in the package, so that it can
+// be read or mapped without going through the zip library. Returns false if the file is not
+// found or is compressed.
+bool			ovr_GetStoredFileRangeInPackage( void * zipFile, const char * nameInZip, size_t & offset, size_t & length );
+
 // Returns NULL buffer if the file is not found.
 bool			ovr_ReadFileFromOtherApplicationPackage( void * zipFile, const char * nameInZip, int & length, void * & buffer );
 bool			ovr_ReadFileFromOtherApplicationPackage( void * zipFile, const char * nameInZip, MemBufferT< uint8_t > & buffer );
 
+// Reads many files at once. The compressed data is read in one pass under the package lock,
+// then the files are decompressed and checked on the calling thread and numThreads others,
+// so other readers of the package are not held up by the decompression. Returns false if
+// any file could not be read; the buffers of the files that were read are still filled.
+// Does not use the cache path.
+bool			ovr_ReadFilesFromOtherApplicationPackage( void * zipFile, ovrPackageFileRead * files, const int numFiles, const int numThreads );
+
 
 //--------------------------------------------------------------
 // Functions for reading assets from this process's application package
@@ -85,6 +109,8 @@ bool			ovr_ReadFileFromApplicationPackage( const char * nameInZip, int & length,
 // Returns an empty MemBufferFile if the file is not found.
 bool			ovr_ReadFileFromApplicationPackage( const char * nameInZip, MemBufferFile & memBufferFile );
 
+bool			ovr_ReadFilesFromApplicationPackage( ovrPackageFileRead * files, const int numFiles, const int numThreads );
+
 
 }	// namespace OVR
 
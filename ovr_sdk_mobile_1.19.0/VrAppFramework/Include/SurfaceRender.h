@@ -14,6 +14,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_Math.h"
 #include "Kernel/OVR_Array.h"
 #include "Kernel/OVR_String.h"
+#include "Kernel/OVR_Atom.h"
 
 #include "OVR_GlUtils.h"
 #include "GlTexture.h"
@@ -31,8 +32,9 @@ struct ovrSurfaceDef
 
 	// Name from the model file, can be used to control surfaces with code.
 	// May be multiple semi-colon separated names if multiple source meshes
-	// were merged into one surface.
-	String				surfaceName;
+	// were merged into one surface. Interned, so only assign names from a
+	// bounded set.
+	ovrAtom				surfaceName;
 
 	// There is a space savings to be had with triangle strips
 	// if primitive restart is supported, but it is a net speed
@@ -68,7 +70,8 @@ struct ovrDrawCounters
 struct ovrDrawSurface
 {
 	ovrDrawSurface() :
-		surface( NULL )
+		  surface( NULL )
+		, joints( NULL )
 	{
 
 	}
@@ -77,12 +80,14 @@ struct ovrDrawSurface
 					const ovrSurfaceDef * surface_ ) :
 		  modelMatrix( modelMatrix_ )
 		, surface( surface_ )
+		, joints( NULL )
 	{
 
 	}
 
 	ovrDrawSurface( const ovrSurfaceDef * surface_ ) :
 		  surface( surface_ )
+		, joints( NULL )
 	{
 
 	}
@@ -91,10 +96,14 @@ struct ovrDrawSurface
 	{
 		modelMatrix = Matrix4f();
 		surface = NULL;
+		joints = NULL;
 	}
 
 	Matrix4f					modelMatrix;
 	const ovrSurfaceDef *		surface;
+	// If not NULL, this is bound instead of surface->graphicsCommand.uniformJoints, so that
+	// instances of the same surface can be drawn with different joint matrices.
+	const GlBuffer *			joints;
 };
 
 class ovrSurfaceRender
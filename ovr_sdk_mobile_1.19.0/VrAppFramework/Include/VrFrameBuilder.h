@@ -14,41 +14,10 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "OVR_Input.h"
 #include "KeyState.h"
+#include "InputEventRing.h"
 
 namespace OVR {
 
-static const int MAX_INPUT_KEY_EVENTS = 16;
-
-struct ovrInputEvents
-{
-	ovrInputEvents() :
-		JoySticks(),
-		TouchPosition(),
-		TouchAction( -1 ),
-		NumKeyEvents( 0 ),
-		KeyEvents() {}
-
-	float JoySticks[2][2];
-	float TouchPosition[2];
-	int TouchAction;
-	int NumKeyEvents;
-	struct ovrKeyEvents_t
-	{
-		ovrKeyEvents_t()
-			: KeyCode( OVR_KEY_NONE )
-			, RepeatCount( 0 )
-			, Down( false ) 
-			, IsJoypadButton( false )
-		{
-		}
-
-		ovrKeyCode	KeyCode;
-		int			RepeatCount;
-		bool		Down : 1;
-		bool		IsJoypadButton : 1;
-	} KeyEvents[MAX_INPUT_KEY_EVENTS];
-};
-
 class VrFrameBuilder
 {
 public:
@@ -56,7 +25,9 @@ public:
 
 	void				Init( ovrJava * java );
 
-	void				AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobile * ovr,
+	// Drains the input events, leaving the key events that do not fit in this frame for
+	// the next one.
+	void				AdvanceVrFrame( ovrInputEventRing & inputEvents, ovrMobile * ovr,
 										const ovrJava & java,
 										const ovrTrackingTransform trackingTransform,
 										const long long enteredVrModeFrameNumber );
@@ -65,6 +36,8 @@ public:
 private:
 	ovrFrameInput vrFrame;
 
+	float		JoySticks[2][2];		// latest joystick event
+
 	double		lastTouchpadTime;
 	double		touchpadTimer;
 	bool		lastTouchDown;
@@ -77,7 +50,8 @@ private:
 	bool		TreatRemoteTouchpadTouchedAsButtonDown[2];
 
 	void 		InterpretTouchpad( VrInput & input, const double currentTime, const float min_swipe_distance );
-	void		AddKeyEventToFrame( ovrKeyCode const keyCode, KeyEventType const eventType, int const repeatCount );
+	void		AddKeyEventToFrame( ovrKeyCode const keyCode, KeyEventType const eventType, int const repeatCount,
+								double const timeInSeconds );
 
 	// Joystick support to enable BUTTON_*STICK_UP, BUTTON_*STICK_DOWN, BUTTON_*STICK_LEFT and BUTTON_*STICK_RIGHT
 	struct ovrJoyStick_t
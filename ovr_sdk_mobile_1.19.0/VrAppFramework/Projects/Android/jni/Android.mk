@@ -49,6 +49,7 @@ LOCAL_SRC_FILES  := ../../../Src/BitmapFont.cpp \
                     ../../../Src/SurfaceRender.cpp \
                     ../../../Src/DebugLines.cpp \
                     ../../../Src/VrFrameBuilder.cpp \
+                    ../../../Src/InputEventRing.cpp \
                     ../../../Src/Console.cpp \
                     ../../../Src/OVR_GlUtils.cpp \
                     ../../../Src/OVR_Geometry.cpp \
@@ -57,8 +58,13 @@ LOCAL_SRC_FILES  := ../../../Src/BitmapFont.cpp \
                     ../../../Src/OVR_FileSys.cpp \
                     ../../../Src/OVR_LogTimer.cpp \
                     ../../../Src/OVR_Stream.cpp \
+                    ../../../Src/OVR_PackWriter.cpp \
+                    ../../../Src/OVR_ReadService.cpp \
                     ../../../Src/JobManager.cpp \
                     ../../../Src/OVR_TextureManager.cpp \
+                    ../../../Src/OVR_Profiler.cpp \
+                    ../../../Src/OVR_TextureEncoder.cpp \
+                    ../../../Src/OVR_TextureStreamer.cpp \
                     ../../../Src/SystemClock.cpp
 
 # GL platform interface
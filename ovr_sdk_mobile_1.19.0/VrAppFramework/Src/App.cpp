@@ -14,13 +14,13 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #if defined( OVR_OS_ANDROID )
 #include <jni.h>
 #include <android/native_window_jni.h>	// for native window JNI
-#include <android/input.h>				// for AMOTION_EVENT_ACTION_*
 #include <unistd.h>						// gettid(), etc
 #endif
 
 #include <math.h>
 
 #include "Kernel/OVR_System.h"
+#include "Kernel/OVR_DeferredLog.h"
 #include "Kernel/OVR_Math.h"
 #include "Kernel/OVR_TypesafeNumber.h"
 #include "Kernel/OVR_JSON.h"
@@ -44,7 +44,9 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Console.h"
 #include "OVR_Uri.h"
 #include "OVR_FileSys.h"
+#include "OVR_ReadService.h"
 #include "OVR_TextureManager.h"
+#include "OVR_TextureStreamer.h"
 #include "OVR_Input.h"
 
 #include "embedded/dependency_error_de.h"
@@ -56,6 +58,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "embedded/dependency_error_ko.h"
 
 //#define OVR_USE_PERF_TIMER
+//#define OVR_USE_PROFILER
 #include "OVR_PerfTimer.h"
 
 static double AppLocalConstructTime = -1.0;	// time when AppLocal was constructed
@@ -208,7 +211,9 @@ AppLocal::AppLocal( JNIEnv & jni_, jobject activityObject_, VrAppInterface & int
 	, ErrorTextureSize( 0 )
 	, ErrorMessageEndTime( -1.0 )
 	, FileSys( nullptr )
+	, ReadService( nullptr )
 	, TextureManager( nullptr )
+	, TextureStreamer( nullptr )
 {
 	OVR_LOG( "----------------- AppLocal::AppLocal() -----------------");
 
@@ -249,6 +254,7 @@ AppLocal::AppLocal( JNIEnv & jni_, jobject activityObject_, VrAppInterface & int
 	VrSettings.SwapInterval = 1;
 	VrSettings.TrackingTransform = VRAPI_TRACKING_TRANSFORM_SYSTEM_CENTER_FLOOR_LEVEL;
 	VrSettings.RenderMode = RENDERMODE_STEREO;
+	VrSettings.UseDeferredLog = false;
 
 	// Default ovrModeParms
 	VrSettings.ModeParms = vrapi_DefaultModeParms( &Java );
@@ -296,6 +302,8 @@ AppLocal::~AppLocal()
 	OVR_LOG( "---------- ~AppLocal() ----------" );
 
 	delete StoragePaths;
+
+	ovrDeferredLog::Stop();
 }
 
 void AppLocal::StartVrThread()
@@ -662,8 +670,23 @@ void AppLocal::InitGlObjects()
 
 	GlProgram::SetUseMultiview( UseMultiview );
 
+#if defined( OVR_OS_ANDROID )
+	// Keep linked programs so that later runs do not compile them again.
+	{
+		String programCachePath;
+		if ( StoragePaths->GetPathIfValidPermission( EST_INTERNAL_STORAGE, EFT_CACHE, "",
+				permissionFlags_t( PERMISSION_WRITE ) | PERMISSION_READ, programCachePath ) )
+		{
+			GlProgram::SetBinaryCachePath( programCachePath.ToCStr() );
+		}
+	}
+#endif
+
 	TextureManager = ovrTextureManager::Create();
 
+	TextureStreamer = new ovrTextureStreamer();
+	TextureStreamer->Init();
+
 	SurfaceRender.Init();
 
 	EyeBuffers = new ovrEyeBuffers;
@@ -733,6 +756,8 @@ void AppLocal::ShutdownGlObjects()
 
 	SurfaceRender.Shutdown();
 
+	GlProgram::ShutdownCache();
+
 	GL_Shutdown( glSetup );
 
 	GraphicsObjectsInitialized = false;
@@ -839,14 +864,6 @@ void AppLocal::EnterVrMode()
 		OVR_LOG( "Time to finish OneTimeInit = %f", SystemClock::GetTimeInSeconds() - AppLocalConstructTime );
 		AppLocalConstructTime = -1.0;
 	}
-
-#if defined( OVR_OS_ANDROID )
-	// Reset InputEvents.TouchAction since we would not have received messages telling us it had changed.
-	if ( InputEvents.TouchAction == AMOTION_EVENT_ACTION_DOWN || InputEvents.TouchAction == AMOTION_EVENT_ACTION_MOVE )
-	{
-		InputEvents.TouchAction = AMOTION_EVENT_ACTION_UP;
-	}
-#endif
 }
 
 void AppLocal::LeaveVrMode()
@@ -892,6 +909,12 @@ void AppLocal::Configure()
 	// Make sure the app didn't mess up the Java pointers.
 	VrSettings.ModeParms.Java = Java;
 
+	// Stopped when the app is destroyed.
+	if ( VrSettings.UseDeferredLog )
+	{
+		ovrDeferredLog::Start();
+	}
+
 	// FIXME: have apps set these flags directly.
 
 	if ( VrSettings.UseProtectedFramebuffer )
@@ -972,32 +995,6 @@ void AppLocal::Command( const char * msg )
 		return;
 	}
 
-	if ( MatchesHead( "joy ", msg ) )
-	{
-		sscanf( msg, "joy %f %f %f %f",
-				&InputEvents.JoySticks[0][0],
-				&InputEvents.JoySticks[0][1],
-				&InputEvents.JoySticks[1][0],
-				&InputEvents.JoySticks[1][1] );
-		return;
-	}
-
-	if ( MatchesHead( "key ", msg ) )
-	{
-		int keyCode, down, repeatCount;
-		sscanf( msg, "key %i %i %i", &keyCode, &down, &repeatCount );
-		if ( InputEvents.NumKeyEvents < MAX_INPUT_KEY_EVENTS )
-		{
-			//OVR_LOG( "Adding key event: keyCode = %i, down = %s, repeat = %i", keyCode, down ? "true" : "false", repeatCount );
-			InputEvents.KeyEvents[InputEvents.NumKeyEvents].KeyCode = static_cast< ovrKeyCode >( keyCode & ~BUTTON_JOYPAD_FLAG );
-			InputEvents.KeyEvents[InputEvents.NumKeyEvents].RepeatCount = repeatCount;
-			InputEvents.KeyEvents[InputEvents.NumKeyEvents].Down = ( down != 0 );
-			InputEvents.KeyEvents[InputEvents.NumKeyEvents].IsJoypadButton = ( keyCode & BUTTON_JOYPAD_FLAG ) != 0;
-			InputEvents.NumKeyEvents++;
-		}
-		return;	
-	}
-
 	if ( MatchesHead( "intent ", msg ) )
 	{
 		OVR_LOG( "%p msg: intent", this );
@@ -1075,7 +1072,7 @@ void AppLocal::FrameworkInputProcessing( const VrInput & input )
 }
 
 #if defined( OVR_OS_WIN32 )
-static void GetInputEvents( ovrInputEvents & inputEvents )
+static void GetInputEvents( ovrInputEventRing & inputEvents )
 {
 }
 #endif
@@ -1141,6 +1138,7 @@ void * AppLocal::VrThreadFunction()
 		// Init the adb 'console' and register console functions
 		InitConsole( Java );
 		RegisterConsoleFunction( "print", OVR::DebugPrint );
+		ovrProfiler::RegisterConsoleFunctions();
 	}
 
 	while( !( VrThreadSynced && ReadyToExit ) )
@@ -1203,12 +1201,22 @@ void * AppLocal::VrThreadFunction()
 			OVR_PERF_TIMER( VrThreadFunction_Loop_AdvanceVrFrame );
 			// Update ovrFrameInput.
 			TheVrFrame.AdvanceVrFrame( InputEvents, OvrMobile, *GetJava(), VrSettings.TrackingTransform, EnteredVrModeFrame );
-			InputEvents.NumKeyEvents = 0;
 		}
 
+		// Frame markers are recorded even without OVR_USE_PROFILER, so that captures of zones
+		// in other files can be split into frames.
+		ovrProfiler::FrameMarker( TheVrFrame.Get().FrameNumber );
+
 		// Resend any debug lines that have expired.
 		GetDebugLines().BeginFrame( TheVrFrame.Get().FrameNumber );
 
+		// Upload textures that finished decoding since the last frame.
+		{
+			OVR_PERF_TIMER( VrThreadFunction_Loop_TextureStreamer );
+			TextureStreamer->Update();
+			ovrProfiler::Counter( "TextureStreamerBytes", (double)TextureStreamer->GetLastUpdateBytes() );
+		}
+
 		// Process input.
 		{
 			OVR_PERF_TIMER( VrThreadFunction_Loop_FrameworkInputProcessing );
@@ -1250,6 +1258,7 @@ void * AppLocal::VrThreadFunction()
 		{
 			GetDebugLines().AppendSurfaceList( res.Surfaces );
 		}
+		ovrProfiler::Counter( "Surfaces", res.Surfaces.GetSizeI() );
 
 		// stop the loop perf timer now or it will show the wait on Timewarp in vrapi_SubmitFrame
 		OVR_PERF_TIMER_STOP( VrThreadFunction_Loop );
@@ -1275,6 +1284,10 @@ void * AppLocal::VrThreadFunction()
 		delete appInterface;
 		appInterface = NULL;
 
+		TextureStreamer->Shutdown();
+		delete TextureStreamer;
+		TextureStreamer = nullptr;
+
 		ovrTextureManager::Destroy( TextureManager );
 
 		ShutdownGlObjects();
@@ -1283,6 +1296,13 @@ void * AppLocal::VrThreadFunction()
 
 		ShutdownInput();
 
+		if ( ReadService != nullptr )
+		{
+			ReadService->Shutdown();
+			delete ReadService;
+			ReadService = nullptr;
+		}
+
 		ovrFileSys::Destroy( FileSys );
 
 #if defined( OVR_OS_ANDROID )
@@ -1475,11 +1495,28 @@ ovrFileSys & AppLocal::GetFileSys()
 	return *FileSys;
 }
 
+ovrReadService & AppLocal::GetReadService()
+{
+	// Most apps never read through the service, so its threads are only started on first use.
+	Mutex::Locker locker( &ReadServiceMutex );
+	if ( ReadService == nullptr )
+	{
+		ReadService = new ovrReadService();
+		ReadService->Init( FileSys );
+	}
+	return *ReadService;
+}
+
 ovrTextureManager * AppLocal::GetTextureManager()
 {
 	return TextureManager;
 }
 
+ovrTextureStreamer * AppLocal::GetTextureStreamer()
+{
+	return TextureStreamer;
+}
+
 void AppLocal::RegisterConsoleFunction( char const * name, consoleFn_t function )
 {
 	OVR::RegisterConsoleFunction( name, function );
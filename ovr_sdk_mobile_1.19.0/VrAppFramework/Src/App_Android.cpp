@@ -22,11 +22,6 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include <android/native_window_jni.h>	// for native window JNI
 #include "OVR_Input.h"
 
-// do not queue input events if less than this number of slots are available in the
-// message queue. This prevents input from overflowing the queue if the message
-// queue is not be serviced by VrThreadFunction.
-static const int	MIN_SLOTS_AVAILABLE_FOR_INPUT = 12;
-
 void ComposeIntentMessage( char const * packageName, char const * uri, char const * jsonText, 
 		char * out, size_t outSize );
 
@@ -167,27 +162,32 @@ void Java_com_oculus_vrappframework_VrApp_nativeSurfaceDestroyed( JNIEnv *jni, j
 	appLocal->pendingNativeWindow = NULL;
 }
 
+// The event times are android.os.SystemClock.uptimeMillis(), which is CLOCK_MONOTONIC like
+// vrapi_GetTimeInSeconds().
 void Java_com_oculus_vrappframework_VrActivity_nativeJoypadAxis( JNIEnv *jni, jclass clazz,
-		jlong appPtr, jfloat lx, jfloat ly, jfloat rx, jfloat ry )
+		jlong appPtr, jfloat lx, jfloat ly, jfloat rx, jfloat ry, jlong eventTime )
 {
 	OVR::AppLocal * appLocal = (OVR::AppLocal *)appPtr;
-	// Suspend input until EnteredVrMode( INTENT_LAUNCH ) has finished to avoid overflowing the message queue on long loads.
+	// Suspend input until EnteredVrMode( INTENT_LAUNCH ) has finished to avoid filling the input ring on long loads.
 	if ( appLocal->IntentType != OVR::INTENT_LAUNCH )
 	{
-		appLocal->GetMessageQueue().PostPrintfIfSpaceAvailable( MIN_SLOTS_AVAILABLE_FOR_INPUT, "joy %f %f %f %f", lx, ly, rx, ry );
+		appLocal->GetInputEvents().PostJoySticks( eventTime * 0.001, lx, ly, rx, ry );
 	}
 }
 
 void Java_com_oculus_vrappframework_VrActivity_nativeKeyEvent( JNIEnv *jni, jclass clazz,
-		jlong appPtr, jint key, jboolean down, jint repeatCount )
+		jlong appPtr, jint key, jboolean down, jint repeatCount, jlong eventTime )
 {
 	OVR::AppLocal * appLocal = (OVR::AppLocal *)appPtr;
-	// Suspend input until EnteredVrMode( INTENT_LAUNCH ) has finished to avoid overflowing the message queue on long loads.
+	// Suspend input until EnteredVrMode( INTENT_LAUNCH ) has finished to avoid filling the input ring on long loads.
 	if ( appLocal->IntentType != OVR::INTENT_LAUNCH )
 	{
 		OVR::ovrKeyCode keyCode = OVR::OSKeyToKeyCode( key );
 		//OVR_LOG( "nativeKeyEvent: key = %i, keyCode = %i, down = %s, repeatCount = %i", key, keyCode, down ? "true" : "false", repeatCount );
-		appLocal->GetMessageQueue().PostPrintfIfSpaceAvailable( MIN_SLOTS_AVAILABLE_FOR_INPUT, "key %i %i %i", keyCode, down, repeatCount );
+		if ( !appLocal->GetInputEvents().PostKey( eventTime * 0.001, keyCode, down != 0, repeatCount ) )
+		{
+			OVR_WARN( "nativeKeyEvent: input ring full, key %i dropped", keyCode );
+		}
 	}
 }
 
@@ -856,7 +856,8 @@ ovrSurfaceDef BitmapFontLocal::TextSurface( const char * text,
 	s.graphicsCommand.Program = FontProgram;
 	s.graphicsCommand.UniformData[0].Data = (void *)&FontTexture;
 
-	s.surfaceName = text;
+	// not the text itself, surface names are interned
+	s.surfaceName = "text";
 	return s;
 }
 
@@ -1352,7 +1353,7 @@ bool BitmapFontLocal::Load( ovrFileSys & fileSys, char const * uri )
 	}
 
 	// create the shaders for font rendering if not already created
-	if ( FontProgram.VertexShader == 0 || FontProgram.FragmentShader == 0 )
+	if ( !FontProgram.IsValid() )
 	{
 		static ovrProgramParm fontUniformParms[] =
 		{
@@ -12,9 +12,13 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "DebugLines.h"
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <atomic>
 
 #include "OVR_GlUtils.h"
+#include "Kernel/OVR_Alg.h"
 #include "Kernel/OVR_LogUtils.h"
+#include "Kernel/OVR_Threads.h"
 
 #include "GlGeometry.h"
 #include "GlProgram.h"
@@ -31,6 +35,24 @@ static const char * DebugLineVertexSrc =
 	"   outColor = VertexColor;\n"
 	"}\n";
 
+// The instance attributes reuse the framework's attribute locations: the axes of the
+// instance in Normal, Tangent and Binormal, the origin in TexCoord and the color in TexCoord1.
+static const char * DebugShapeVertexSrc =
+	"attribute vec4 Position;\n"
+	"attribute vec4 VertexColor;\n"
+	"attribute vec3 Normal;\n"
+	"attribute vec3 Tangent;\n"
+	"attribute vec3 Binormal;\n"
+	"attribute vec3 TexCoord;\n"
+	"attribute vec4 TexCoord1;\n"
+	"varying lowp vec4 outColor;\n"
+	"void main()\n"
+	"{\n"
+	"   vec3 p = TexCoord + Normal * Position.x + Tangent * Position.y + Binormal * Position.z;\n"
+	"   gl_Position = TransformVertex( vec4( p, 1.0 ) );\n"
+	"   outColor = VertexColor * TexCoord1;\n"
+	"}\n";
+
 static const char * DebugLineFragmentSrc =
 	"varying lowp vec4 outColor;\n"
 	"void main()\n"
@@ -38,29 +60,431 @@ static const char * DebugLineFragmentSrc =
 	"	gl_FragColor = outColor;\n"
 	"}\n";
 
+enum ovrDebugShape
+{
+	DEBUG_SHAPE_LINE,		// a line, stored as its two vertices
+	DEBUG_SHAPE_STAR,		// three lines through the origin in the instance color
+	DEBUG_SHAPE_AXES,		// three lines through the origin in red, green and blue
+	DEBUG_SHAPE_BOX,		// the edges of the unit cube
+	DEBUG_SHAPE_MAX
+};
+
+struct ovrDebugLineVertex
+{
+	Vector3f	Position;
+	uint32_t	Color;		// RGBA8
+};
+
+struct ovrDebugShapeInstance
+{
+	Vector3f	Origin;
+	Vector3f	Axes[3];
+	uint32_t	Color;		// RGBA8
+};
+
+static uint32_t PackColor( const Vector4f & color )
+{
+	const uint32_t r = (uint32_t)( Alg::Clamp( color.x, 0.0f, 1.0f ) * 255.0f + 0.5f );
+	const uint32_t g = (uint32_t)( Alg::Clamp( color.y, 0.0f, 1.0f ) * 255.0f + 0.5f );
+	const uint32_t b = (uint32_t)( Alg::Clamp( color.z, 0.0f, 1.0f ) * 255.0f + 0.5f );
+	const uint32_t a = (uint32_t)( Alg::Clamp( color.w, 0.0f, 1.0f ) * 255.0f + 0.5f );
+	return r | ( g << 8 ) | ( b << 16 ) | ( a << 24 );
+}
+
+static const uint32_t COLOR_WHITE	= 0xFFFFFFFF;
+static const uint32_t COLOR_RED		= 0xFF0000FF;
+static const uint32_t COLOR_GREEN	= 0xFF00FF00;
+static const uint32_t COLOR_BLUE	= 0xFFFF0000;
+
 //==============================================================
-// OvrDebugLinesLocal
-//
-class OvrDebugLinesLocal : public OvrDebugLines
+// ovrDebugDrawChunk
+// A fixed slot in one of the vertex buffers of a pool, and the CPU copy of the lines or
+// instances in it. Only the elements added since the last upload are uploaded.
+struct ovrDebugDrawChunk
+{
+	ovrDebugDrawChunk() :
+		DrawSurf( &Surface ),
+		Buffer( 0 ),
+		BufferOffset( 0 ),
+		Data( NULL ),
+		Count( 0 ),
+		UploadedCount( 0 )
+	{
+	}
+
+	ovrSurfaceDef		Surface;
+	ovrDrawSurface		DrawSurf;
+	unsigned			Buffer;			// 0 until the block of the chunk is created
+	int					BufferOffset;	// in bytes
+	uint8_t *			Data;
+	int					Count;
+	int					UploadedCount;
+};
+
+//==============================================================
+// ovrDebugDrawPool
+// The chunks of one shape. Chunks are created on the CPU when all chunks are in use, and
+// their vertex buffers and vertex array objects are created in blocks when a chunk is first
+// uploaded, so adding lines never calls GL. Released chunks are handed out again in the
+// order they were released, so the buffers are used as a ring and a slot is rewritten as
+// late as possible after the GPU last read it.
+class ovrDebugDrawPool
 {
 public:
-	struct DebugLines_t
+	static const int	CHUNKS_PER_BLOCK = 8;
+
+						ovrDebugDrawPool();
+						~ovrDebugDrawPool();
+
+	// Creates the mesh of the shape. The line shape only has an index buffer, that
+	// indexes the vertices of a chunk in order.
+	void				Init( const ovrDebugShape shape, const GlProgram & program,
+								const ovrDebugLineVertex * meshVertices, const int numMeshVertices,
+								const TriangleIndex * meshIndices, const int numMeshIndices );
+	void				Shutdown();
+
+	ovrDebugDrawChunk *	Alloc( const bool depthTest );
+	void				Release( ovrDebugDrawChunk * chunk );
+
+	// Uploads the elements added since the last upload and sets up the chunk's surface.
+	// Returns the number of bytes uploaded.
+	int					Upload( ovrDebugDrawChunk & chunk, unsigned & boundBuffer );
+
+	int					GetElementSize() const { return ElementSize; }
+	int					GetChunkCapacity() const { return ChunkCapacity; }
+	int					GetNumChunks() const { return Chunks.GetSizeI(); }
+
+private:
+	ovrDebugShape					Shape;
+	int								ElementSize;
+	int								ChunkCapacity;
+	GlProgram						Program;
+	unsigned						MeshVertexBuffer;
+	unsigned						MeshIndexBuffer;
+	int								MeshIndexCount;
+	Array< unsigned >				Buffers;	// one per block
+	Array< ovrDebugDrawChunk * >	Chunks;
+	Array< ovrDebugDrawChunk * >	FreeRing;
+	int								FreeHead;
+	int								FreeCount;
+
+	void				Grow();
+	void				CreateBlock( const int block );
+};
+
+ovrDebugDrawPool::ovrDebugDrawPool() :
+	Shape( DEBUG_SHAPE_LINE ),
+	ElementSize( 0 ),
+	ChunkCapacity( 0 ),
+	MeshVertexBuffer( 0 ),
+	MeshIndexBuffer( 0 ),
+	MeshIndexCount( 0 ),
+	FreeHead( 0 ),
+	FreeCount( 0 )
+{
+}
+
+ovrDebugDrawPool::~ovrDebugDrawPool()
+{
+	for ( int i = 0; i < Chunks.GetSizeI(); i++ )
+	{
+		delete [] Chunks[i]->Data;
+		delete Chunks[i];
+	}
+}
+
+void ovrDebugDrawPool::Init( const ovrDebugShape shape, const GlProgram & program,
+		const ovrDebugLineVertex * meshVertices, const int numMeshVertices,
+		const TriangleIndex * meshIndices, const int numMeshIndices )
+{
+	Shape = shape;
+	Program = program;
+	if ( shape == DEBUG_SHAPE_LINE )
+	{
+		ElementSize = sizeof( ovrDebugLineVertex ) * 2;
+		ChunkCapacity = 4096;
+	}
+	else
 	{
-		DebugLines_t()
-		: DrawSurf( & Surf )
+		ElementSize = sizeof( ovrDebugShapeInstance );
+		ChunkCapacity = 1024;
+	}
+
+	if ( numMeshVertices > 0 )
+	{
+		glGenBuffers( 1, &MeshVertexBuffer );
+		glBindBuffer( GL_ARRAY_BUFFER, MeshVertexBuffer );
+		glBufferData( GL_ARRAY_BUFFER, numMeshVertices * sizeof( ovrDebugLineVertex ), meshVertices, GL_STATIC_DRAW );
+		glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	}
+	glGenBuffers( 1, &MeshIndexBuffer );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, MeshIndexBuffer );
+	glBufferData( GL_ELEMENT_ARRAY_BUFFER, numMeshIndices * sizeof( TriangleIndex ), meshIndices, GL_STATIC_DRAW );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	MeshIndexCount = numMeshIndices;
+}
+
+void ovrDebugDrawPool::Shutdown()
+{
+	for ( int i = 0; i < Chunks.GetSizeI(); i++ )
+	{
+		ovrDebugDrawChunk * chunk = Chunks[i];
+		if ( chunk->Surface.geo.vertexArrayObject != 0 )
 		{
+			glDeleteVertexArrays( 1, &chunk->Surface.geo.vertexArrayObject );
+			chunk->Surface.geo.vertexArrayObject = 0;
 		}
+		chunk->Buffer = 0;
+		chunk->UploadedCount = 0;
+	}
+	if ( Buffers.GetSizeI() > 0 )
+	{
+		glDeleteBuffers( Buffers.GetSizeI(), Buffers.GetDataPtr() );
+		Buffers.Clear();
+	}
+	if ( MeshVertexBuffer != 0 )
+	{
+		glDeleteBuffers( 1, &MeshVertexBuffer );
+		MeshVertexBuffer = 0;
+	}
+	if ( MeshIndexBuffer != 0 )
+	{
+		glDeleteBuffers( 1, &MeshIndexBuffer );
+		MeshIndexBuffer = 0;
+	}
+}
 
-		ovrSurfaceDef 		Surf;
-		ovrDrawSurface 		DrawSurf;
-		VertexAttribs 		Attr;
-		Array<long long> 	EndFrame;
-	};
+void ovrDebugDrawPool::Grow()
+{
+	const int oldSize = Chunks.GetSizeI();
+	const int newSize = oldSize + CHUNKS_PER_BLOCK;
+	for ( int i = oldSize; i < newSize; i++ )
+	{
+		ovrDebugDrawChunk * chunk = new ovrDebugDrawChunk();
+		chunk->Data = new uint8_t[ChunkCapacity * ElementSize];
+		Chunks.PushBack( chunk );
+	}
+
+	// the ring is empty, so the new chunks go in order
+	FreeRing.Resize( newSize );
+	FreeHead = 0;
+	FreeCount = CHUNKS_PER_BLOCK;
+	for ( int i = 0; i < CHUNKS_PER_BLOCK; i++ )
+	{
+		FreeRing[i] = Chunks[oldSize + i];
+	}
+}
+
+ovrDebugDrawChunk * ovrDebugDrawPool::Alloc( const bool depthTest )
+{
+	if ( FreeCount == 0 )
+	{
+		Grow();
+	}
+	ovrDebugDrawChunk * chunk = FreeRing[FreeHead];
+	FreeHead = ( FreeHead + 1 ) % FreeRing.GetSizeI();
+	FreeCount--;
+
+	chunk->Count = 0;
+	chunk->UploadedCount = 0;
+
+	ovrGraphicsCommand & gc = chunk->Surface.graphicsCommand;
+	gc.Program = Program;
+	gc.GpuState.blendDst = GL_ONE_MINUS_SRC_ALPHA;
+	gc.GpuState.depthEnable = gc.GpuState.depthMaskEnable = depthTest;
+	gc.GpuState.lineWidth = 2.0f;
+	return chunk;
+}
+
+void ovrDebugDrawPool::Release( ovrDebugDrawChunk * chunk )
+{
+	FreeRing[( FreeHead + FreeCount ) % FreeRing.GetSizeI()] = chunk;
+	FreeCount++;
+}
+
+void ovrDebugDrawPool::CreateBlock( const int block )
+{
+	const int chunkBytes = ChunkCapacity * ElementSize;
+	unsigned buffer = 0;
+	glGenBuffers( 1, &buffer );
+	glBindBuffer( GL_ARRAY_BUFFER, buffer );
+	glBufferData( GL_ARRAY_BUFFER, CHUNKS_PER_BLOCK * chunkBytes, NULL, GL_DYNAMIC_DRAW );
+	Buffers.PushBack( buffer );
+
+	for ( int i = 0; i < CHUNKS_PER_BLOCK; i++ )
+	{
+		ovrDebugDrawChunk * chunk = Chunks[block * CHUNKS_PER_BLOCK + i];
+		chunk->Buffer = buffer;
+		chunk->BufferOffset = i * chunkBytes;
+
+		GlGeometry & geo = chunk->Surface.geo;
+		geo.primitiveType = GL_LINES;
+		glGenVertexArrays( 1, &geo.vertexArrayObject );
+		glBindVertexArray( geo.vertexArrayObject );
+
+		if ( Shape == DEBUG_SHAPE_LINE )
+		{
+			glBindBuffer( GL_ARRAY_BUFFER, buffer );
+			glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_POSITION );
+			glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof( ovrDebugLineVertex ),
+					(void *)( chunk->BufferOffset + offsetof( ovrDebugLineVertex, Position ) ) );
+			glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_COLOR );
+			glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( ovrDebugLineVertex ),
+					(void *)( chunk->BufferOffset + offsetof( ovrDebugLineVertex, Color ) ) );
+		}
+		else
+		{
+			glBindBuffer( GL_ARRAY_BUFFER, MeshVertexBuffer );
+			glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_POSITION );
+			glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof( ovrDebugLineVertex ),
+					(void *)offsetof( ovrDebugLineVertex, Position ) );
+			glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_COLOR );
+			glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( ovrDebugLineVertex ),
+					(void *)offsetof( ovrDebugLineVertex, Color ) );
+
+			glBindBuffer( GL_ARRAY_BUFFER, buffer );
+			const int instanceLocations[5] =
+			{
+				VERTEX_ATTRIBUTE_LOCATION_NORMAL,
+				VERTEX_ATTRIBUTE_LOCATION_TANGENT,
+				VERTEX_ATTRIBUTE_LOCATION_BINORMAL,
+				VERTEX_ATTRIBUTE_LOCATION_UV0,
+				VERTEX_ATTRIBUTE_LOCATION_UV1
+			};
+			const size_t instanceOffsets[5] =
+			{
+				offsetof( ovrDebugShapeInstance, Axes[0] ),
+				offsetof( ovrDebugShapeInstance, Axes[1] ),
+				offsetof( ovrDebugShapeInstance, Axes[2] ),
+				offsetof( ovrDebugShapeInstance, Origin ),
+				offsetof( ovrDebugShapeInstance, Color )
+			};
+			for ( int j = 0; j < 5; j++ )
+			{
+				glEnableVertexAttribArray( instanceLocations[j] );
+				if ( j == 4 )
+				{
+					glVertexAttribPointer( instanceLocations[j], 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( ovrDebugShapeInstance ),
+							(void *)( chunk->BufferOffset + instanceOffsets[j] ) );
+				}
+				else
+				{
+					glVertexAttribPointer( instanceLocations[j], 3, GL_FLOAT, GL_FALSE, sizeof( ovrDebugShapeInstance ),
+							(void *)( chunk->BufferOffset + instanceOffsets[j] ) );
+				}
+				glVertexAttribDivisor( instanceLocations[j], 1 );
+			}
+		}
+
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, MeshIndexBuffer );
+		glBindVertexArray( 0 );
+	}
+
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+int ovrDebugDrawPool::Upload( ovrDebugDrawChunk & chunk, unsigned & boundBuffer )
+{
+	if ( chunk.Buffer == 0 )
+	{
+		int index = 0;
+		while ( Chunks[index] != &chunk )
+		{
+			index++;
+		}
+		for ( int block = Buffers.GetSizeI(); block <= index / CHUNKS_PER_BLOCK; block++ )
+		{
+			CreateBlock( block );
+		}
+		boundBuffer = 0;
+	}
+
+	int uploadedBytes = 0;
+	if ( chunk.Count > chunk.UploadedCount )
+	{
+		if ( boundBuffer != chunk.Buffer )
+		{
+			glBindBuffer( GL_ARRAY_BUFFER, chunk.Buffer );
+			boundBuffer = chunk.Buffer;
+		}
+		uploadedBytes = ( chunk.Count - chunk.UploadedCount ) * ElementSize;
+		glBufferSubData( GL_ARRAY_BUFFER, chunk.BufferOffset + chunk.UploadedCount * ElementSize,
+				uploadedBytes, chunk.Data + chunk.UploadedCount * ElementSize );
+		chunk.UploadedCount = chunk.Count;
+	}
+
+	GlGeometry & geo = chunk.Surface.geo;
+	if ( Shape == DEBUG_SHAPE_LINE )
+	{
+		geo.vertexCount = chunk.Count * 2;
+		geo.indexCount = chunk.Count * 2;
+		chunk.Surface.numInstances = 1;
+	}
+	else
+	{
+		geo.vertexCount = MeshIndexCount;
+		geo.indexCount = MeshIndexCount;
+		chunk.Surface.numInstances = chunk.Count;
+	}
+	return uploadedBytes;
+}
+
+//==============================================================
+// ovrDebugDrawBucket
+// The lines and shapes that expire at the same frame.
+struct ovrDebugDrawBucket
+{
+	long long						EndFrame;
+	// [depthTest][shape], only the last chunk of each list may have room
+	Array< ovrDebugDrawChunk * >	Chunks[2][DEBUG_SHAPE_MAX];
+};
+
+struct ovrDebugPendingLine
+{
+	long long			EndFrame;
+	ovrDebugLineVertex	Vertices[2];
+	bool				DepthTest;
+};
 
-	typedef unsigned short LineIndex_t;
+struct ovrDebugPendingShape
+{
+	long long				EndFrame;
+	ovrDebugShapeInstance	Instance;
+	ovrDebugShape			Shape;
+	bool					DepthTest;
+};
+
+//==============================================================
+// ovrDebugLinesThreadBuffer
+// Lines added on a thread other than the one that owns the debug lines. The owner moves
+// them into the buckets once per frame.
+struct ovrDebugLinesThreadBuffer
+{
+	ThreadId						Thread;
+	Mutex							Lock;
+	Array< ovrDebugPendingLine >	Lines;
+	Array< ovrDebugPendingShape >	Shapes;
+};
+
+struct ovrDebugLinesThreadCache
+{
+	unsigned int					InstanceId;
+	ovrDebugLinesThreadBuffer *		Buffer;	// NULL on the owning thread
+};
 
-	static const int MAX_DEBUG_LINES = 2048;
+static thread_local ovrDebugLinesThreadCache	DebugLinesThreadCache = { 0, NULL };
+static std::atomic< unsigned int >				NextDebugLinesInstanceId( 1 );
 
+//==============================================================
+// OvrDebugLinesLocal
+//
+// Lines, points, axes and bounds are kept in buckets by the frame they expire at, so
+// expiring them releases the chunks of the buckets without touching the lines. The chunks
+// of a bucket stay in their vertex buffer slots until the bucket expires, so persistent
+// lines are uploaded once and each frame only uploads what was added.
+class OvrDebugLinesLocal : public OvrDebugLines
+{
+public:
 						OvrDebugLinesLocal();
 	virtual				~OvrDebugLinesLocal();
 
@@ -84,25 +508,48 @@ public:
 	virtual void		AddBounds( Posef const & pose, Bounds3f const & bounds, Vector4f const & color );
 
 
-	virtual void		    AddAxes( const Vector3f & origin, const Matrix4f & axes, const float size, 
-						    		const Vector4f & color, const long long endFrame, 
+	virtual void		    AddAxes( const Vector3f & origin, const Matrix4f & axes, const float size,
+						    		const Vector4f & color, const long long endFrame,
 						    		const bool depthTest );
 
 
 private:
-	DebugLines_t		DepthTested;
-	DebugLines_t		NonDepthTested;
-
 	bool				Initialized;
 	GlProgram			LineProgram;
+	GlProgram			ShapeProgram;
+	ovrDebugDrawPool	Pools[DEBUG_SHAPE_MAX];
 
-	void		RemoveExpired( const long long frameNum, DebugLines_t & lines );
+	const unsigned int	InstanceId;
+	ThreadId			OwnerThread;
+	long long			CurrentFrame;
+
+	Array< ovrDebugDrawBucket * >	Buckets;		// sorted by EndFrame
+	Array< ovrDebugDrawBucket * >	FreeBuckets;
+	ovrDebugDrawBucket *			LastBucket;		// the bucket of the last line
+
+	Mutex								ThreadBuffersLock;
+	Array< ovrDebugLinesThreadBuffer * >	ThreadBuffers;
+
+	ovrDebugLinesThreadBuffer *	GetThreadBuffer();
+	void				CollectThreadBuffers();
+
+	ovrDebugDrawBucket &	FindBucket( const long long endFrame );
+	uint8_t *			AllocElement( const long long endFrame, const bool depthTest, const ovrDebugShape shape );
+
+	void				AddLineVertices( const ovrDebugLineVertex & v0, const ovrDebugLineVertex & v1,
+								const long long endFrame, const bool depthTest );
+	void				AddShape( const ovrDebugShape shape, const ovrDebugShapeInstance & instance,
+								const long long endFrame, const bool depthTest );
 };
 
 //==============================
 // OvrDebugLinesLocal::OvrDebugLinesLocal
 OvrDebugLinesLocal::OvrDebugLinesLocal() :
-	Initialized( false )
+	Initialized( false ),
+	InstanceId( NextDebugLinesInstanceId.fetch_add( 1, std::memory_order_relaxed ) ),
+	OwnerThread( GetCurrentThreadId() ),
+	CurrentFrame( 0 ),
+	LastBucket( NULL )
 {
 }
 
@@ -110,7 +557,22 @@ OvrDebugLinesLocal::OvrDebugLinesLocal() :
 // OvrDebugLinesLocal::OvrDebugLinesLocal
 OvrDebugLinesLocal::~OvrDebugLinesLocal()
 {
-	Shutdown();
+	if ( Initialized )
+	{
+		Shutdown();
+	}
+	for ( int i = 0; i < Buckets.GetSizeI(); i++ )
+	{
+		delete Buckets[i];
+	}
+	for ( int i = 0; i < FreeBuckets.GetSizeI(); i++ )
+	{
+		delete FreeBuckets[i];
+	}
+	for ( int i = 0; i < ThreadBuffers.GetSizeI(); i++ )
+	{
+		delete ThreadBuffers[i];
+	}
 }
 
 //==============================
@@ -123,34 +585,58 @@ void OvrDebugLinesLocal::Init()
 		return;
 	}
 
+	OwnerThread = GetCurrentThreadId();
+
 	// this is only freed by the OS when the program exits
-	if ( LineProgram.VertexShader == 0 || LineProgram.FragmentShader == 0 )
+	if ( !LineProgram.IsValid() )
 	{
 		LineProgram = GlProgram::Build( DebugLineVertexSrc, DebugLineFragmentSrc, NULL, 0 );
 	}
+	if ( !ShapeProgram.IsValid() )
+	{
+		ShapeProgram = GlProgram::Build( DebugShapeVertexSrc, DebugLineFragmentSrc, NULL, 0 );
+	}
 
-	// the indices will never change once we've set them up, we just won't necessarily
-	// use all of the index buffer to render.
-	const int MAX_INDICES = MAX_DEBUG_LINES * 2;
-	Array<LineIndex_t> indices;
-	indices.Reserve( MAX_INDICES );
-
-	for ( LineIndex_t i = 0; i < MAX_INDICES; ++i )
+	// the line indices never change, each chunk draws the first part of them
+	Array< TriangleIndex > lineIndices;
+	lineIndices.Resize( 4096 * 2 );
+	for ( int i = 0; i < lineIndices.GetSizeI(); i++ )
 	{
-		indices.PushBack(i);
+		lineIndices[i] = (TriangleIndex)i;
 	}
+	Pools[DEBUG_SHAPE_LINE].Init( DEBUG_SHAPE_LINE, LineProgram, NULL, 0, lineIndices.GetDataPtr(), lineIndices.GetSizeI() );
+	OVR_ASSERT( Pools[DEBUG_SHAPE_LINE].GetChunkCapacity() * 2 == lineIndices.GetSizeI() );
+
+	const TriangleIndex starIndices[6] = { 0, 1, 2, 3, 4, 5 };
+	const ovrDebugLineVertex starVertices[6] =
+	{
+		{ Vector3f( 0.0f, 0.0f, -1.0f ), COLOR_WHITE }, { Vector3f( 0.0f, 0.0f, 1.0f ), COLOR_WHITE },
+		{ Vector3f( -1.0f, 0.0f, 0.0f ), COLOR_WHITE }, { Vector3f( 1.0f, 0.0f, 0.0f ), COLOR_WHITE },
+		{ Vector3f( 0.0f, -1.0f, 0.0f ), COLOR_WHITE }, { Vector3f( 0.0f, 1.0f, 0.0f ), COLOR_WHITE }
+	};
+	Pools[DEBUG_SHAPE_STAR].Init( DEBUG_SHAPE_STAR, ShapeProgram, starVertices, 6, starIndices, 6 );
 
-	for ( int i = 0; i < 2; i++ )
+	const ovrDebugLineVertex axesVertices[6] =
 	{
-		DebugLines_t & dl = i == 0 ? NonDepthTested : DepthTested;
-		dl.Surf.geo.Create( dl.Attr, indices );
-		dl.Surf.geo.primitiveType = GL_LINES;
-		ovrGraphicsCommand & gc = dl.Surf.graphicsCommand;
-		gc.GpuState.blendDst = GL_ONE_MINUS_SRC_ALPHA;
-		gc.GpuState.depthEnable = gc.GpuState.depthMaskEnable = i == 1;
-		gc.GpuState.lineWidth = 2.0f;
-		gc.Program = LineProgram;
+		{ Vector3f( 0.0f, 0.0f, -1.0f ), COLOR_BLUE }, { Vector3f( 0.0f, 0.0f, 1.0f ), COLOR_BLUE },
+		{ Vector3f( -1.0f, 0.0f, 0.0f ), COLOR_RED }, { Vector3f( 1.0f, 0.0f, 0.0f ), COLOR_RED },
+		{ Vector3f( 0.0f, -1.0f, 0.0f ), COLOR_GREEN }, { Vector3f( 0.0f, 1.0f, 0.0f ), COLOR_GREEN }
+	};
+	Pools[DEBUG_SHAPE_AXES].Init( DEBUG_SHAPE_AXES, ShapeProgram, axesVertices, 6, starIndices, 6 );
+
+	ovrDebugLineVertex boxVertices[8];
+	for ( int i = 0; i < 8; i++ )
+	{
+		boxVertices[i].Position = Vector3f( (float)( i & 1 ), (float)( ( i >> 1 ) & 1 ), (float)( ( i >> 2 ) & 1 ) );
+		boxVertices[i].Color = COLOR_WHITE;
 	}
+	const TriangleIndex boxIndices[24] =
+	{
+		0, 1, 2, 3, 4, 5, 6, 7,		// x edges
+		0, 2, 1, 3, 4, 6, 5, 7,		// y edges
+		0, 4, 1, 5, 2, 6, 3, 7		// z edges
+	};
+	Pools[DEBUG_SHAPE_BOX].Init( DEBUG_SHAPE_BOX, ShapeProgram, boxVertices, 8, boxIndices, 24 );
 
 	Initialized = true;
 }
@@ -164,27 +650,187 @@ void OvrDebugLinesLocal::Shutdown()
 		OVR_ASSERT_WITH_TAG( !Initialized, "DebugLines" );
 		return;
 	}
-	DepthTested.Surf.geo.Free();
-	NonDepthTested.Surf.geo.Free();
+	for ( int i = 0; i < DEBUG_SHAPE_MAX; i++ )
+	{
+		Pools[i].Shutdown();
+	}
 	GlProgram::Free( LineProgram );
+	GlProgram::Free( ShapeProgram );
 	Initialized = false;
 }
 
+//==============================
+// OvrDebugLinesLocal::GetThreadBuffer
+// Returns NULL on the owning thread, which adds to the buckets directly.
+ovrDebugLinesThreadBuffer * OvrDebugLinesLocal::GetThreadBuffer()
+{
+	ovrDebugLinesThreadCache & cache = DebugLinesThreadCache;
+	if ( cache.InstanceId == InstanceId )
+	{
+		return cache.Buffer;
+	}
+
+	const ThreadId thread = GetCurrentThreadId();
+	ovrDebugLinesThreadBuffer * buffer = NULL;
+	if ( thread != OwnerThread )
+	{
+		Mutex::Locker locker( &ThreadBuffersLock );
+		for ( int i = 0; i < ThreadBuffers.GetSizeI(); i++ )
+		{
+			if ( ThreadBuffers[i]->Thread == thread )
+			{
+				buffer = ThreadBuffers[i];
+				break;
+			}
+		}
+		if ( buffer == NULL )
+		{
+			buffer = new ovrDebugLinesThreadBuffer();
+			buffer->Thread = thread;
+			ThreadBuffers.PushBack( buffer );
+		}
+	}
+	cache.InstanceId = InstanceId;
+	cache.Buffer = buffer;
+	return buffer;
+}
+
+//==============================
+// OvrDebugLinesLocal::CollectThreadBuffers
+void OvrDebugLinesLocal::CollectThreadBuffers()
+{
+	Mutex::Locker locker( &ThreadBuffersLock );
+	for ( int i = 0; i < ThreadBuffers.GetSizeI(); i++ )
+	{
+		ovrDebugLinesThreadBuffer & buffer = *ThreadBuffers[i];
+		Mutex::Locker bufferLocker( &buffer.Lock );
+		for ( int j = 0; j < buffer.Lines.GetSizeI(); j++ )
+		{
+			const ovrDebugPendingLine & line = buffer.Lines[j];
+			AddLineVertices( line.Vertices[0], line.Vertices[1], line.EndFrame, line.DepthTest );
+		}
+		for ( int j = 0; j < buffer.Shapes.GetSizeI(); j++ )
+		{
+			const ovrDebugPendingShape & shape = buffer.Shapes[j];
+			AddShape( shape.Shape, shape.Instance, shape.EndFrame, shape.DepthTest );
+		}
+		buffer.Lines.Clear();
+		buffer.Shapes.Clear();
+	}
+}
+
+//==============================
+// OvrDebugLinesLocal::FindBucket
+ovrDebugDrawBucket & OvrDebugLinesLocal::FindBucket( const long long endFrame )
+{
+	// lines that are already expired are drawn once
+	const long long bucketFrame = Alg::Max( endFrame, CurrentFrame + 1 );
+	if ( LastBucket != NULL && LastBucket->EndFrame == bucketFrame )
+	{
+		return *LastBucket;
+	}
+
+	int low = 0;
+	int high = Buckets.GetSizeI();
+	while ( low < high )
+	{
+		const int mid = ( low + high ) >> 1;
+		if ( Buckets[mid]->EndFrame < bucketFrame )
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	if ( low == Buckets.GetSizeI() || Buckets[low]->EndFrame != bucketFrame )
+	{
+		ovrDebugDrawBucket * bucket;
+		if ( FreeBuckets.GetSizeI() > 0 )
+		{
+			bucket = FreeBuckets.Pop();
+		}
+		else
+		{
+			bucket = new ovrDebugDrawBucket();
+		}
+		bucket->EndFrame = bucketFrame;
+		Buckets.InsertAt( low, bucket );
+	}
+	LastBucket = Buckets[low];
+	return *LastBucket;
+}
+
+//==============================
+// OvrDebugLinesLocal::AllocElement
+uint8_t * OvrDebugLinesLocal::AllocElement( const long long endFrame, const bool depthTest, const ovrDebugShape shape )
+{
+	ovrDebugDrawPool & pool = Pools[shape];
+	Array< ovrDebugDrawChunk * > & chunks = FindBucket( endFrame ).Chunks[depthTest ? 1 : 0][shape];
+	ovrDebugDrawChunk * chunk = ( chunks.GetSizeI() > 0 ) ? chunks.Back() : NULL;
+	if ( chunk == NULL || chunk->Count == pool.GetChunkCapacity() )
+	{
+		chunk = pool.Alloc( depthTest );
+		chunks.PushBack( chunk );
+	}
+	return chunk->Data + ( chunk->Count++ ) * pool.GetElementSize();
+}
+
+//==============================
+// OvrDebugLinesLocal::AddLineVertices
+void OvrDebugLinesLocal::AddLineVertices( const ovrDebugLineVertex & v0, const ovrDebugLineVertex & v1,
+		const long long endFrame, const bool depthTest )
+{
+	ovrDebugLineVertex * vertices = reinterpret_cast< ovrDebugLineVertex * >( AllocElement( endFrame, depthTest, DEBUG_SHAPE_LINE ) );
+	vertices[0] = v0;
+	vertices[1] = v1;
+}
+
+//==============================
+// OvrDebugLinesLocal::AddShape
+void OvrDebugLinesLocal::AddShape( const ovrDebugShape shape, const ovrDebugShapeInstance & instance,
+		const long long endFrame, const bool depthTest )
+{
+	ovrDebugLinesThreadBuffer * buffer = GetThreadBuffer();
+	if ( buffer != NULL )
+	{
+		Mutex::Locker locker( &buffer->Lock );
+		ovrDebugPendingShape & pending = buffer->Shapes.PushDefault();
+		pending.EndFrame = endFrame;
+		pending.Instance = instance;
+		pending.Shape = shape;
+		pending.DepthTest = depthTest;
+		return;
+	}
+	*reinterpret_cast< ovrDebugShapeInstance * >( AllocElement( endFrame, depthTest, shape ) ) = instance;
+}
+
 //==============================
 // OvrDebugLinesLocal::AppendSurfaceList
 void OvrDebugLinesLocal::AppendSurfaceList( Array< ovrDrawSurface > & surfaceList )
 {
-	for ( int j = 0; j < 2; j++ )
+	CollectThreadBuffers();
+
+	unsigned boundBuffer = 0;
+	for ( int depthTest = 0; depthTest < 2; depthTest++ )
 	{
-		DebugLines_t & dl = j == 0 ? NonDepthTested : DepthTested;
-		int verts = dl.Attr.position.GetSizeI();
-		if ( verts == 0 )
+		for ( int i = 0; i < Buckets.GetSizeI(); i++ )
 		{
-			continue;
+			for ( int shape = 0; shape < DEBUG_SHAPE_MAX; shape++ )
+			{
+				const Array< ovrDebugDrawChunk * > & chunks = Buckets[i]->Chunks[depthTest][shape];
+				for ( int j = 0; j < chunks.GetSizeI(); j++ )
+				{
+					Pools[shape].Upload( *chunks[j], boundBuffer );
+					surfaceList.PushBack( chunks[j]->DrawSurf );
+				}
+			}
 		}
-		dl.Surf.geo.Update( dl.Attr );
-		dl.Surf.geo.indexCount = verts;
-		surfaceList.PushBack( dl.DrawSurf );
+	}
+	if ( boundBuffer != 0 )
+	{
+		glBindBuffer( GL_ARRAY_BUFFER, 0 );
 	}
 }
 
@@ -196,14 +842,25 @@ void OvrDebugLinesLocal::AddLine( const Vector3f & start, const Vector3f & end,
 		const long long endFrame, const bool depthTest )
 {
 	//OVR_LOG( "OvrDebugLinesLocal::AddDebugLine" );
-	DebugLines_t & dl = depthTest ? DepthTested : NonDepthTested;
-	dl.Attr.position.PushBack( start );
-	dl.Attr.position.PushBack( end );
-	dl.Attr.color.PushBack( startColor );
-	dl.Attr.color.PushBack( endColor );
-	dl.EndFrame.PushBack( endFrame );
-    //OVR_ASSERT( DepthTested.EndFrame.GetSizeI() < MAX_DEBUG_LINES );
-    //OVR_ASSERT( NonDepthTested.EndFrame.GetSizeI() < MAX_DEBUG_LINES );
+	ovrDebugLineVertex v0;
+	v0.Position = start;
+	v0.Color = PackColor( startColor );
+	ovrDebugLineVertex v1;
+	v1.Position = end;
+	v1.Color = PackColor( endColor );
+
+	ovrDebugLinesThreadBuffer * buffer = GetThreadBuffer();
+	if ( buffer != NULL )
+	{
+		Mutex::Locker locker( &buffer->Lock );
+		ovrDebugPendingLine & pending = buffer->Lines.PushDefault();
+		pending.EndFrame = endFrame;
+		pending.Vertices[0] = v0;
+		pending.Vertices[1] = v1;
+		pending.DepthTest = depthTest;
+		return;
+	}
+	AddLineVertices( v0, v1, endFrame, depthTest );
 }
 
 //==============================
@@ -212,13 +869,13 @@ void OvrDebugLinesLocal::AddPoint(	const Vector3f & pos, const float size, const
 		const long long endFrame, const bool depthTest )
 {
 	float const hs = size * 0.5f;
-	Vector3f const fwd( 0.0f, 0.0f, hs );
-	Vector3f const right( hs, 0.0f, 0.0f );
-	Vector3f const up( 0.0f, hs, 0.0f );
-
-	AddLine( pos - fwd, pos + fwd, color, color, endFrame, depthTest );
-	AddLine( pos - right , pos + right, color, color, endFrame, depthTest );
-	AddLine( pos - up, pos + up, color, color, endFrame, depthTest );
+	ovrDebugShapeInstance instance;
+	instance.Origin = pos;
+	instance.Axes[0] = Vector3f( hs, 0.0f, 0.0f );
+	instance.Axes[1] = Vector3f( 0.0f, hs, 0.0f );
+	instance.Axes[2] = Vector3f( 0.0f, 0.0f, hs );
+	instance.Color = PackColor( color );
+	AddShape( DEBUG_SHAPE_STAR, instance, endFrame, depthTest );
 }
 
 //==============================
@@ -227,29 +884,29 @@ void OvrDebugLinesLocal::AddPoint(	const Vector3f & pos, const float size,
 		const long long endFrame, const bool depthTest )
 {
 	float const hs = size * 0.5f;
-	Vector3f const fwd( 0.0f, 0.0f, hs );
-	Vector3f const right( hs, 0.0f, 0.0f );
-	Vector3f const up( 0.0f, hs, 0.0f );
-
-	AddLine( pos - fwd, pos + fwd, Vector4f( 0.0f, 0.0f, 1.0f, 1.0f ), Vector4f( 0.0f, 0.0f, 1.0f, 1.0f ), endFrame, depthTest );
-	AddLine( pos - right, pos + right, Vector4f( 1.0f, 0.0f, 0.0f, 1.0f ), Vector4f( 1.0f, 0.0f, 0.0f, 1.0f ), endFrame, depthTest );
-	AddLine( pos - up, pos + up, Vector4f( 0.0f, 1.0f, 0.0f, 1.0f ), Vector4f( 0.0f, 1.0f, 0.0f, 1.0f ), endFrame, depthTest );
+	ovrDebugShapeInstance instance;
+	instance.Origin = pos;
+	instance.Axes[0] = Vector3f( hs, 0.0f, 0.0f );
+	instance.Axes[1] = Vector3f( 0.0f, hs, 0.0f );
+	instance.Axes[2] = Vector3f( 0.0f, 0.0f, hs );
+	instance.Color = COLOR_WHITE;
+	AddShape( DEBUG_SHAPE_AXES, instance, endFrame, depthTest );
 }
 
 //==============================
 // OvrDebugLinesLocal::AddAxes
-void OvrDebugLinesLocal::AddAxes( const Vector3f & origin, const Matrix4f & axes, const float size, 
-						    		const Vector4f & color, const long long endFrame, 
+void OvrDebugLinesLocal::AddAxes( const Vector3f & origin, const Matrix4f & axes, const float size,
+						    		const Vector4f & color, const long long endFrame,
 						    		const bool depthTest )
 {
 	const float half_size = size * 0.5f;
-	Vector3f const fwd		= Vector3f( axes.M[2][0], axes.M[2][1], axes.M[2][2] ) * half_size;
-	Vector3f const right	= Vector3f( axes.M[0][0], axes.M[0][1], axes.M[0][2] ) * half_size;
-	Vector3f const up		= Vector3f( axes.M[1][0], axes.M[1][1], axes.M[1][2] ) * half_size;
-
-	AddLine( origin - fwd,	 origin + fwd,   Vector4f( 0.0f, 0.0f, 1.0f, 1.0f ), Vector4f( 0.0f, 0.0f, 1.0f, 1.0f ), endFrame, depthTest );
-	AddLine( origin - right, origin + right, Vector4f( 1.0f, 0.0f, 0.0f, 1.0f ), Vector4f( 1.0f, 0.0f, 0.0f, 1.0f ), endFrame, depthTest );
-	AddLine( origin - up,    origin + up,    Vector4f( 0.0f, 1.0f, 0.0f, 1.0f ), Vector4f( 0.0f, 1.0f, 0.0f, 1.0f ), endFrame, depthTest );
+	ovrDebugShapeInstance instance;
+	instance.Origin = origin;
+	instance.Axes[0] = Vector3f( axes.M[0][0], axes.M[0][1], axes.M[0][2] ) * half_size;
+	instance.Axes[1] = Vector3f( axes.M[1][0], axes.M[1][1], axes.M[1][2] ) * half_size;
+	instance.Axes[2] = Vector3f( axes.M[2][0], axes.M[2][1], axes.M[2][2] ) * half_size;
+	instance.Color = COLOR_WHITE;
+	AddShape( DEBUG_SHAPE_AXES, instance, endFrame, depthTest );
 }
 
 //==============================
@@ -257,61 +914,46 @@ void OvrDebugLinesLocal::AddAxes( const Vector3f & origin, const Matrix4f & axes
 void OvrDebugLinesLocal::AddBounds( Posef const & pose, Bounds3f const & bounds, Vector4f const & color )
 {
 	Vector3f const & mins = bounds.GetMins();
-	Vector3f const & maxs = bounds.GetMaxs();
-	Vector3f corners[8];
-	corners[0] = mins;
-	corners[7] = maxs;
-	corners[1] = Vector3f( mins.x, maxs.y, mins.z );
-	corners[2] = Vector3f( mins.x, maxs.y, maxs.z );
-	corners[3] = Vector3f( mins.x, mins.y, maxs.z );
-	corners[4] = Vector3f( maxs.x, mins.y, mins.z );
-	corners[5] = Vector3f( maxs.x, maxs.y, mins.z );
-	corners[6] = Vector3f( maxs.x, mins.y, maxs.z );
-
-	// transform points
-	for ( int i = 0; i < 8; ++i )
-	{
-		corners[i] = pose.Rotation.Rotate( corners[i] );
-		corners[i] += pose.Translation;
-	}
-
-	AddLine( corners[0], corners[1], color, color, 1, true );
-	AddLine( corners[1], corners[2], color, color, 1, true );
-	AddLine( corners[2], corners[3], color, color, 1, true );
-	AddLine( corners[3], corners[0], color, color, 1, true );
-	AddLine( corners[7], corners[6], color, color, 1, true );
-	AddLine( corners[6], corners[4], color, color, 1, true );
-	AddLine( corners[4], corners[5], color, color, 1, true );
-	AddLine( corners[5], corners[7], color, color, 1, true );
-	AddLine( corners[0], corners[4], color, color, 1, true );
-	AddLine( corners[1], corners[5], color, color, 1, true );
-	AddLine( corners[2], corners[7], color, color, 1, true );
-	AddLine( corners[3], corners[6], color, color, 1, true );
+	Vector3f const size = bounds.GetSize();
+	ovrDebugShapeInstance instance;
+	instance.Origin = pose.Rotation.Rotate( mins ) + pose.Translation;
+	instance.Axes[0] = pose.Rotation.Rotate( Vector3f( size.x, 0.0f, 0.0f ) );
+	instance.Axes[1] = pose.Rotation.Rotate( Vector3f( 0.0f, size.y, 0.0f ) );
+	instance.Axes[2] = pose.Rotation.Rotate( Vector3f( 0.0f, 0.0f, size.z ) );
+	instance.Color = PackColor( color );
+	AddShape( DEBUG_SHAPE_BOX, instance, 1, true );
 }
 
 //==============================
 // OvrDebugLinesLocal::BeginFrame
 void OvrDebugLinesLocal::BeginFrame( const long long frameNum )
 {
-	// LOG( "OvrDebugLinesLocal::RemoveExpired: frame %lli, removing %i lines", frameNum, DepthTestedLines.GetSizeI() + NonDepthTestedLines.GetSizeI() );
-	DepthTested.Surf.geo.indexCount = 0;
-	NonDepthTested.Surf.geo.indexCount = 0;
-	RemoveExpired( frameNum, DepthTested );
-	RemoveExpired( frameNum, NonDepthTested );
-}
+	CurrentFrame = frameNum;
 
-//==============================
-// OvrDebugLinesLocal::RemoveExpired
-void OvrDebugLinesLocal::RemoveExpired( const long long frameNum, DebugLines_t & lines )
-{
-	for ( int i = lines.EndFrame.GetSizeI() - 1; i >= 0; --i )
+	// the buckets are sorted, so the expired ones are at the front
+	int numExpired = 0;
+	while ( numExpired < Buckets.GetSizeI() && Buckets[numExpired]->EndFrame <= frameNum )
 	{
-		if ( frameNum >= lines.EndFrame[i] )
+		ovrDebugDrawBucket * bucket = Buckets[numExpired];
+		for ( int depthTest = 0; depthTest < 2; depthTest++ )
 		{
-			lines.Attr.position.RemoveMultipleAt( i * 2, 2 );
-			lines.Attr.color.RemoveMultipleAt( i * 2, 2 );
-			lines.EndFrame.RemoveAt( i );
+			for ( int shape = 0; shape < DEBUG_SHAPE_MAX; shape++ )
+			{
+				Array< ovrDebugDrawChunk * > & chunks = bucket->Chunks[depthTest][shape];
+				for ( int i = 0; i < chunks.GetSizeI(); i++ )
+				{
+					Pools[shape].Release( chunks[i] );
+				}
+				chunks.Clear();
+			}
 		}
+		FreeBuckets.PushBack( bucket );
+		numExpired++;
+	}
+	if ( numExpired > 0 )
+	{
+		Buckets.RemoveMultipleAt( 0, numExpired );
+		LastBucket = NULL;
 	}
 }
 
@@ -16,6 +16,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include <stdlib.h>
 
 #include "OVR_GlUtils.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Hash.h"
 #include "Kernel/OVR_LogUtils.h"
 #include "Kernel/OVR_String.h"
 #include "Kernel/OVR_String_Utils.h"
@@ -192,7 +194,7 @@ static const char * FindShaderDirectivesEnd( const char * src )
 }
 #endif
 
-static GLuint CompileShader( GLenum shaderType, const char * directives, const char * src, GLint programVersion )
+static OVR::String ShaderSource( GLenum shaderType, const char * directives, const char * src, GLint programVersion )
 {
 	const char * postVersion = FindShaderVersionEnd( src );
 	if ( postVersion != src )
@@ -231,34 +233,51 @@ static GLuint CompileShader( GLenum shaderType, const char * directives, const c
 
 	srcString.AppendString( postVersion );
 
-	src = srcString.ToCStr();
+	return srcString;
+}
+
+// Does not wait for the compile, see CheckShader().
+static GLuint StartShader( GLenum shaderType, const char * directives, const char * src, GLint programVersion )
+{
+	const OVR::String srcString = ShaderSource( shaderType, directives, src, programVersion );
 
 	GLuint shader = glCreateShader( shaderType );
 
 	const int numSources = 1;
 	const char * srcs[1];
-	srcs[0] = src;
+	srcs[0] = srcString.ToCStr();
 
 	glShaderSource( shader, numSources, srcs, 0 );
 	glCompileShader( shader );
 
+	return shader;
+}
+
+static bool CheckShader( GLuint shader, GLenum shaderType )
+{
 	GLint r;
 	glGetShaderiv( shader, GL_COMPILE_STATUS, &r );
 	if ( r == GL_FALSE )
 	{
 		OVR_WARN( "Compiling %s shader: ****** failed ******\n", shaderType == GL_VERTEX_SHADER ? "vertex" : "fragment" );
+		GLint srcLength = 0;
+		glGetShaderiv( shader, GL_SHADER_SOURCE_LENGTH, &srcLength );
+		Array< char > srcBuffer;
+		srcBuffer.Resize( srcLength + 1 );
+		srcBuffer[0] = 0;
+		glGetShaderSource( shader, srcLength + 1, 0, srcBuffer.GetDataPtr() );
 		GLchar msg[1024];
-		const char * sp = src;
+		const char * sp = srcBuffer.GetDataPtr();
 		int charCount = 0;
 		int line = 0;
-		do
+		while ( *sp != 0 )
 		{
 			if ( *sp != '\n' )
 			{
 				msg[charCount++] = *sp;
 				msg[charCount] = 0;
 			}
-			if ( *sp == 0 || *sp == '\n' || charCount == 1023 )
+			if ( *sp == '\n' || charCount == 1023 )
 			{
 				charCount = 0;
 				line++;
@@ -270,7 +289,7 @@ static GLuint CompileShader( GLenum shaderType, const char * directives, const c
 				}
 			}
 			sp++;
-		} while( *sp != 0 );
+		}
 		if ( charCount != 0 )
 		{
 			line++;
@@ -278,41 +297,19 @@ static GLuint CompileShader( GLenum shaderType, const char * directives, const c
 		}
 		glGetShaderInfoLog( shader, sizeof( msg ), 0, msg );
 		OVR_WARN( "%s\n", msg );
-		glDeleteShader( shader );
-		return 0;
+		return false;
 	}
-	return shader;
+	return true;
 }
 
-GlProgram GlProgram::Build( const char * vertexSrc,
-							const char * fragmentSrc,
-							const ovrProgramParm * parms, const int numParms,
-							const int requestedProgramVersion,
-							bool abortOnError, bool useDeprecatedInterface )
+static int ProgramVersion( const int requestedProgramVersion, const char * fragmentDirectives, const char * fragmentSrc )
 {
-	return Build( NULL, vertexSrc, NULL, fragmentSrc, parms, numParms,
-					requestedProgramVersion, abortOnError, useDeprecatedInterface );
-}
-
-GlProgram GlProgram::Build( const char * vertexDirectives, const char * vertexSrc,
-							const char * fragmentDirectives, const char * fragmentSrc,
-							const ovrProgramParm * parms, const int numParms,
-							const int requestedProgramVersion,
-							bool abortOnError, bool useDeprecatedInterface )
-{
-	GlProgram p;
-	p.UseDeprecatedInterface = useDeprecatedInterface;
-
-	//--------------------------
-	// Compile and Create the Program
-	//--------------------------
-
 	int programVersion = requestedProgramVersion;
-	if ( programVersion < GLSL_PROGRAM_VERSION )
+	if ( programVersion < GlProgram::GLSL_PROGRAM_VERSION )
 	{
 		OVR_WARN( "GlProgram: Program GLSL version requested %d, but does not meet required minimum %d",
-			requestedProgramVersion, GLSL_PROGRAM_VERSION );
-		programVersion = GLSL_PROGRAM_VERSION;
+			requestedProgramVersion, GlProgram::GLSL_PROGRAM_VERSION );
+		programVersion = GlProgram::GLSL_PROGRAM_VERSION;
 	}
 #if defined( OVR_OS_ANDROID )
 	// ----IMAGE_EXTERNAL_WORKAROUND
@@ -324,8 +321,8 @@ GlProgram GlProgram::Build( const char * vertexDirectives, const char * vertexSr
 	// P0003: Warning: Extension 'GL_OES_EGL_image_external' not supported
 	// P0003: Warning: Extension 'GL_OES_EGL_image_external_essl3' not supported
 	// L0001: Expected token '{', found 'identifier' (samplerExternalOES)
-	// 
-	// Currently, it appears that drivers which fully support multiview also support 
+	//
+	// Currently, it appears that drivers which fully support multiview also support
 	// GL_OES_EGL_image_external_essl3 with v300. In the case where multiview is not
 	// fully supported, we force the shader version to v100 in order to maintain support
 	// for image_external with the Mali T760+Android-L drivers.
@@ -338,72 +335,171 @@ GlProgram GlProgram::Build( const char * vertexDirectives, const char * vertexSr
 	}
 	// ----IMAGE_EXTERNAL_WORKAROUND
 #endif
-	p.VertexShader = CompileShader( GL_VERTEX_SHADER, vertexDirectives, vertexSrc, programVersion );
-	if ( p.VertexShader == 0 )
+	return programVersion;
+}
+
+//==============================================================
+// Program cache
+//==============================================================
+
+struct ovrProgramCacheEntry
+{
+	ovrProgramCacheEntry()
+		: RefCount( 0 )
+		, Linked( false )
 	{
-		Free( p );
-		if ( abortOnError )
+		for ( int i = 0; i < ovrUniform::MAX_UNIFORMS; i++ )
 		{
-			OVR_FAIL( "Failed to compile vertex shader" );
+			TextureLocations[i] = -1;
 		}
-		return GlProgram();
 	}
 
-	p.FragmentShader = CompileShader( GL_FRAGMENT_SHADER, fragmentDirectives, fragmentSrc, programVersion );
-	if ( p.FragmentShader == 0 )
+	GlProgram	Program;								// with its uniforms once linked
+	int			TextureLocations[ovrUniform::MAX_UNIFORMS];	// of the implicit Texture0 - Texture7
+	int			RefCount;								// Build() calls not yet freed
+	bool		Linked;									// false while a Prefetch() compiles
+};
+
+static Hash< uint64_t, ovrProgramCacheEntry >	ProgramCache;
+static Hash< unsigned int, uint64_t >			ProgramCacheKeys;		// GL program to cache key
+static ovrProgramCacheStats						ProgramCacheStats;
+static char										BinaryCachePath[1024];
+static int										NumBinaryFormats = -1;	// not queried yet
+static uint64_t									DriverHash = 0;
+
+// Saved binaries start with this, followed by the GlProgram with its uniforms, the
+// TextureLocations and Length bytes of the binary.
+struct ovrProgramBinaryHeader
+{
+	uint32_t	Magic;
+	uint32_t	Version;
+	uint64_t	Key;
+	uint64_t	DriverHash;		// of GL_VENDOR, GL_RENDERER and GL_VERSION
+	uint32_t	ProgramSize;	// sizeof( GlProgram )
+	uint32_t	Format;
+	uint32_t	Length;
+	uint32_t	Pad;
+};
+
+static const uint32_t PROGRAM_BINARY_MAGIC = 0x4e494250;	// "PBIN"
+static const uint32_t PROGRAM_BINARY_VERSION = 1;
+
+// FNV-1a
+static uint64_t HashBytes( uint64_t hash, const void * data, const size_t size )
+{
+	const uint8_t * bytes = static_cast< const uint8_t * >( data );
+	for ( size_t i = 0; i < size; i++ )
 	{
-		Free( p );
-		if ( abortOnError )
-		{
-			OVR_FAIL( "Failed to compile fragment shader" );
-		}
-		return GlProgram();
+		hash = ( hash ^ bytes[i] ) * 1099511628211ULL;
 	}
+	return hash;
+}
 
-	p.Program = glCreateProgram();
-	glAttachShader( p.Program, p.VertexShader );
-	glAttachShader( p.Program, p.FragmentShader );
+static uint64_t HashString( uint64_t hash, const char * s )
+{
+	if ( s == NULL )
+	{
+		const uint8_t none = 0xFF;	// not the same as ""
+		return HashBytes( hash, &none, 1 );
+	}
+	return HashBytes( hash, s, strlen( s ) + 1 );
+}
 
-	//--------------------------
-	// Set attributes before linking
-	//--------------------------
+// Everything that goes into the shader sources and the uniform layout.
+static uint64_t ProgramKey( const char * vertexDirectives, const char * vertexSrc,
+							const char * fragmentDirectives, const char * fragmentSrc,
+							const ovrProgramParm * parms, const int numParms, const int programVersion )
+{
+	uint64_t key = 14695981039346656037ULL;
+	const int32_t values[2] = { programVersion, UseMultiview ? 1 : 0 };
+	key = HashBytes( key, values, sizeof( values ) );
+	key = HashString( key, VertexHeader );
+	key = HashString( key, FragmentHeader );
+	key = HashString( key, vertexDirectives );
+	key = HashString( key, vertexSrc );
+	key = HashString( key, fragmentDirectives );
+	key = HashString( key, fragmentSrc );
+	for ( int i = 0; i < numParms; i++ )
+	{
+		key = HashString( key, parms[i].Name );
+		key = HashBytes( key, &parms[i].Type, sizeof( parms[i].Type ) );
+	}
+	return key;
+}
 
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_POSITION,		"Position" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_NORMAL,			"Normal" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_TANGENT,			"Tangent" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_BINORMAL,		"Binormal" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_COLOR,			"VertexColor" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_UV0,				"TexCoord" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_UV1,				"TexCoord1" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_JOINT_INDICES,	"JointIndices" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_JOINT_WEIGHTS,	"JointWeights" );
-	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_FONT_PARMS,		"FontParms" );
+static bool CanSaveBinaries()
+{
+	if ( BinaryCachePath[0] == '\0' )
+	{
+		return false;
+	}
+	if ( NumBinaryFormats < 0 )
+	{
+		GLint numFormats = 0;
+		glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats );
+		NumBinaryFormats = numFormats;
 
-	//--------------------------
-	// Link Program
-	//--------------------------
+		const GLenum names[3] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+		DriverHash = 14695981039346656037ULL;
+		for ( int i = 0; i < 3; i++ )
+		{
+			DriverHash = HashString( DriverHash, (const char *)glGetString( names[i] ) );
+		}
+	}
+	return NumBinaryFormats > 0;
+}
 
-	glLinkProgram( p.Program );
+static void BinaryFileName( const uint64_t key, char * fileName, const size_t size )
+{
+	OVR_sprintf( fileName, size, "%sprogram_%016llx.bin", BinaryCachePath, (unsigned long long)key );
+}
 
-	GLint linkStatus;
-	glGetProgramiv( p.Program, GL_LINK_STATUS, &linkStatus );
-	if ( linkStatus == GL_FALSE )
+static void FreeProgramObjects( GlProgram & prog )
+{
+	if ( prog.Program != 0 )
 	{
-		GLchar msg[1024];
-		glGetProgramInfoLog( p.Program, sizeof( msg ), 0, msg );
-		Free( p );
-		OVR_LOG( "Linking program failed: %s\n", msg );
-		if ( abortOnError )
-		{
-			OVR_FAIL( "Failed to link program" );
-		}
-		return GlProgram();
+		glDeleteProgram( prog.Program );
 	}
+	if ( prog.VertexShader != 0 )
+	{
+		glDeleteShader( prog.VertexShader );
+	}
+	if ( prog.FragmentShader != 0 )
+	{
+		glDeleteShader( prog.FragmentShader );
+	}
+	prog.Program = 0;
+	prog.VertexShader = 0;
+	prog.FragmentShader = 0;
+}
 
-	//--------------------------
-	// Determine Uniform Parm Location and Binding.
-	//--------------------------
+static void AddToCache( const uint64_t key, const ovrProgramCacheEntry & entry )
+{
+	ProgramCache.Set( key, entry );
+	ProgramCacheKeys.Set( entry.Program.Program, key );
+}
+
+static void RemoveFromCache( const uint64_t key )
+{
+	const ovrProgramCacheEntry * entry = ProgramCache.Get( key );
+	if ( entry == NULL )
+	{
+		return;
+	}
+	ProgramCacheKeys.Remove( entry->Program.Program );
+	ProgramCache.Remove( key );
+	if ( ProgramCache.GetSize() == 0 )
+	{
+		// release the tables
+		ProgramCache.Clear();
+		ProgramCacheKeys.Clear();
+	}
+}
 
+// Looks up the uniform locations and assigns the bindings.
+static void ReflectProgram( GlProgram & p, int textureLocations[ovrUniform::MAX_UNIFORMS],
+							const ovrProgramParm * parms, const int numParms )
+{
 	p.numTextureBindings = 0;
 	p.numUniformBufferBindings = 0;
 
@@ -418,7 +514,6 @@ GlProgram GlProgram::Build( const char * vertexDirectives, const char * vertexSr
 		if ( p.SceneMatrices.Location >= 0 )	// this won't be present for v100 shaders.
 		{
 			p.SceneMatrices.Binding = p.numUniformBufferBindings++;
-			glUniformBlockBinding( p.Program, p.SceneMatrices.Location, p.SceneMatrices.Binding );
 		}
 
 		p.ModelMatrix.Type	 = ovrProgramParmType::FLOAT_MATRIX4;
@@ -450,13 +545,10 @@ GlProgram GlProgram::Build( const char * vertexDirectives, const char * vertexSr
 	if ( p.uJoints != -1 )
 	{
 		p.uJointsBinding = p.numUniformBufferBindings++;
-		glUniformBlockBinding( p.Program, p.uJoints, p.uJointsBinding );
 	}
 	// ^^ old materialDef members - these should go away eventually - ideally soon
 	// ----DEPRECATED_GLPROGRAM
 
-	glUseProgram( p.Program );
-
 	for ( int i = 0; i < numParms; ++i )
 	{
 		OVR_ASSERT( parms[i].Type != ovrProgramParmType::MAX );
@@ -465,13 +557,11 @@ GlProgram GlProgram::Build( const char * vertexDirectives, const char * vertexSr
 		{
 			p.Uniforms[i].Location = static_cast<int16_t>( glGetUniformLocation( p.Program, parms[i].Name ) );
 			p.Uniforms[i].Binding = p.numTextureBindings++;
-			glUniform1i( p.Uniforms[i].Location, p.Uniforms[i].Binding );
 		}
 		else if ( parms[i].Type == ovrProgramParmType::BUFFER_UNIFORM )
 		{
 			p.Uniforms[i].Location = glGetUniformBlockIndex( p.Program, parms[i].Name );
 			p.Uniforms[i].Binding = p.numUniformBufferBindings++;
-			glUniformBlockBinding( p.Program, p.Uniforms[i].Location, p.Uniforms[i].Binding );
 		}
 		else
 		{
@@ -494,38 +584,388 @@ GlProgram GlProgram::Build( const char * vertexDirectives, const char * vertexSr
 	{
 		char name[32];
 		sprintf( name, "Texture%i", i );
-		const GLint uTex = glGetUniformLocation( p.Program, name );
-		if ( uTex != -1 )
+		textureLocations[i] = glGetUniformLocation( p.Program, name );
+	}
+}
+
+// Sets the bindings found by ReflectProgram(), which a program loaded from a binary
+// does not keep.
+static void ApplyBindings( const GlProgram & p, const int textureLocations[ovrUniform::MAX_UNIFORMS] )
+{
+	if ( p.SceneMatrices.Location >= 0 )
+	{
+		glUniformBlockBinding( p.Program, p.SceneMatrices.Location, p.SceneMatrices.Binding );
+	}
+	if ( p.uJoints != -1 )
+	{
+		glUniformBlockBinding( p.Program, p.uJoints, p.uJointsBinding );
+	}
+
+	glUseProgram( p.Program );
+
+	for ( int i = 0; i < ovrUniform::MAX_UNIFORMS; i++ )
+	{
+		if ( p.Uniforms[i].Type == ovrProgramParmType::TEXTURE_SAMPLED )
+		{
+			glUniform1i( p.Uniforms[i].Location, p.Uniforms[i].Binding );
+		}
+		else if ( p.Uniforms[i].Type == ovrProgramParmType::BUFFER_UNIFORM && p.Uniforms[i].Location >= 0 )
+		{
+			glUniformBlockBinding( p.Program, p.Uniforms[i].Location, p.Uniforms[i].Binding );
+		}
+	}
+
+	for ( int i = 0; i < ovrUniform::MAX_UNIFORMS; i++ )
+	{
+		if ( textureLocations[i] != -1 )
 		{
-			glUniform1i( uTex, i );
+			glUniform1i( textureLocations[i], i );
 		}
 	}
 
 	glUseProgram( 0 );
+}
 
+static bool LoadProgramBinary( const uint64_t key, ovrProgramCacheEntry & entry )
+{
+	if ( !CanSaveBinaries() )
+	{
+		return false;
+	}
+
+	char fileName[1024 + 64];
+	BinaryFileName( key, fileName, sizeof( fileName ) );
+	FILE * f = fopen( fileName, "rb" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+
+	ovrProgramBinaryHeader header;
+	GlProgram layout;
+	int textureLocations[ovrUniform::MAX_UNIFORMS];
+	void * binary = NULL;
+	bool valid = fread( &header, sizeof( header ), 1, f ) == 1 &&
+				header.Magic == PROGRAM_BINARY_MAGIC && header.Version == PROGRAM_BINARY_VERSION &&
+				header.Key == key && header.DriverHash == DriverHash && header.ProgramSize == sizeof( GlProgram ) &&
+				header.Length > 0 &&
+				fread( &layout, sizeof( layout ), 1, f ) == 1 &&
+				fread( textureLocations, sizeof( textureLocations ), 1, f ) == 1;
+	if ( valid )
+	{
+		binary = malloc( header.Length );
+		valid = fread( binary, header.Length, 1, f ) == 1;
+	}
+	fclose( f );
+
+	if ( valid )
+	{
+		layout.Program = glCreateProgram();
+		glProgramBinary( layout.Program, header.Format, binary, header.Length );
+		GLint linkStatus;
+		glGetProgramiv( layout.Program, GL_LINK_STATUS, &linkStatus );
+		if ( linkStatus == GL_FALSE )
+		{
+			FreeProgramObjects( layout );
+			valid = false;
+		}
+	}
+	free( binary );
+
+	if ( !valid )
+	{
+		// compiling the program will replace the file
+		OVR_LOG( "GlProgram: rejected the cached binary %s", fileName );
+		ProgramCacheStats.RejectedBinaries++;
+		return false;
+	}
+
+	entry.Program = layout;
+	memcpy( entry.TextureLocations, textureLocations, sizeof( textureLocations ) );
+	entry.Linked = true;
+	ApplyBindings( entry.Program, entry.TextureLocations );
+	ProgramCacheStats.LoadedBinaries++;
+	return true;
+}
+
+static void SaveProgramBinary( const uint64_t key, const ovrProgramCacheEntry & entry )
+{
+	if ( !CanSaveBinaries() )
+	{
+		return;
+	}
+
+	GLint length = 0;
+	glGetProgramiv( entry.Program.Program, GL_PROGRAM_BINARY_LENGTH, &length );
+	if ( length <= 0 )
+	{
+		return;
+	}
+	void * binary = malloc( length );
+	GLsizei written = 0;
+	GLenum format = 0;
+	glGetProgramBinary( entry.Program.Program, length, &written, &format, binary );
+
+	ovrProgramBinaryHeader header;
+	header.Magic = PROGRAM_BINARY_MAGIC;
+	header.Version = PROGRAM_BINARY_VERSION;
+	header.Key = key;
+	header.DriverHash = DriverHash;
+	header.ProgramSize = sizeof( GlProgram );
+	header.Format = format;
+	header.Length = written;
+	header.Pad = 0;
+
+	// GL names are not saved
+	GlProgram layout = entry.Program;
+	layout.Program = 0;
+	layout.VertexShader = 0;
+	layout.FragmentShader = 0;
+
+	// write a temporary file and rename it, so that a crash never leaves a partial binary
+	char fileName[1024 + 64];
+	char tempName[1024 + 64];
+	BinaryFileName( key, fileName, sizeof( fileName ) );
+	OVR_sprintf( tempName, sizeof( tempName ), "%s.tmp", fileName );
+	FILE * f = fopen( tempName, "wb" );
+	if ( f != NULL )
+	{
+		const bool ok = written > 0 &&
+						fwrite( &header, sizeof( header ), 1, f ) == 1 &&
+						fwrite( &layout, sizeof( layout ), 1, f ) == 1 &&
+						fwrite( entry.TextureLocations, sizeof( entry.TextureLocations ), 1, f ) == 1 &&
+						fwrite( binary, written, 1, f ) == 1;
+		if ( fclose( f ) != 0 || !ok || rename( tempName, fileName ) != 0 )
+		{
+			OVR_WARN( "GlProgram: failed to write %s", fileName );
+			remove( tempName );
+		}
+	}
+	free( binary );
+}
+
+// Compiles and links without waiting for the driver, see FinishProgram().
+static void StartProgram( const char * vertexDirectives, const char * vertexSrc,
+						  const char * fragmentDirectives, const char * fragmentSrc,
+						  const int programVersion, GlProgram & p )
+{
+	p.VertexShader = StartShader( GL_VERTEX_SHADER, vertexDirectives, vertexSrc, programVersion );
+	p.FragmentShader = StartShader( GL_FRAGMENT_SHADER, fragmentDirectives, fragmentSrc, programVersion );
+
+	p.Program = glCreateProgram();
+	glAttachShader( p.Program, p.VertexShader );
+	glAttachShader( p.Program, p.FragmentShader );
+
+	//--------------------------
+	// Set attributes before linking
+	//--------------------------
+
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_POSITION,		"Position" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_NORMAL,			"Normal" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_TANGENT,			"Tangent" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_BINORMAL,		"Binormal" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_COLOR,			"VertexColor" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_UV0,				"TexCoord" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_UV1,				"TexCoord1" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_JOINT_INDICES,	"JointIndices" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_JOINT_WEIGHTS,	"JointWeights" );
+	glBindAttribLocation( p.Program, VERTEX_ATTRIBUTE_LOCATION_FONT_PARMS,		"FontParms" );
+
+	if ( CanSaveBinaries() )
+	{
+		glProgramParameteri( p.Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+	}
+
+	//--------------------------
+	// Link Program
+	//--------------------------
+
+	glLinkProgram( p.Program );
+}
+
+// Waits for the program started by StartProgram() and finds its uniforms. Returns an
+// error message if it failed to compile or link.
+static const char * FinishProgram( const uint64_t key, ovrProgramCacheEntry & entry,
+								   const ovrProgramParm * parms, const int numParms )
+{
+	GlProgram & p = entry.Program;
+	if ( !CheckShader( p.VertexShader, GL_VERTEX_SHADER ) )
+	{
+		return "Failed to compile vertex shader";
+	}
+	if ( !CheckShader( p.FragmentShader, GL_FRAGMENT_SHADER ) )
+	{
+		return "Failed to compile fragment shader";
+	}
+
+	GLint linkStatus;
+	glGetProgramiv( p.Program, GL_LINK_STATUS, &linkStatus );
+	if ( linkStatus == GL_FALSE )
+	{
+		GLchar msg[1024];
+		glGetProgramInfoLog( p.Program, sizeof( msg ), 0, msg );
+		OVR_LOG( "Linking program failed: %s\n", msg );
+		return "Failed to link program";
+	}
+
+	ReflectProgram( p, entry.TextureLocations, parms, numParms );
+	ApplyBindings( p, entry.TextureLocations );
+	entry.Linked = true;
+	ProgramCacheStats.Compiled++;
+
+	SaveProgramBinary( key, entry );
+	return NULL;
+}
+
+GlProgram GlProgram::Build( const char * vertexSrc,
+							const char * fragmentSrc,
+							const ovrProgramParm * parms, const int numParms,
+							const int requestedProgramVersion,
+							bool abortOnError, bool useDeprecatedInterface )
+{
+	return Build( NULL, vertexSrc, NULL, fragmentSrc, parms, numParms,
+					requestedProgramVersion, abortOnError, useDeprecatedInterface );
+}
+
+GlProgram GlProgram::Build( const char * vertexDirectives, const char * vertexSrc,
+							const char * fragmentDirectives, const char * fragmentSrc,
+							const ovrProgramParm * parms, const int numParms,
+							const int requestedProgramVersion,
+							bool abortOnError, bool useDeprecatedInterface )
+{
+	const int programVersion = ProgramVersion( requestedProgramVersion, fragmentDirectives, fragmentSrc );
+	const uint64_t key = ProgramKey( vertexDirectives, vertexSrc, fragmentDirectives, fragmentSrc, parms, numParms, programVersion );
+
+	ovrProgramCacheEntry * entry = ProgramCache.Get( key );
+	if ( entry != NULL && entry->Linked )
+	{
+		ProgramCacheStats.Shared++;
+	}
+	else
+	{
+		if ( entry == NULL )
+		{
+			ovrProgramCacheEntry newEntry;
+			if ( !LoadProgramBinary( key, newEntry ) )
+			{
+				StartProgram( vertexDirectives, vertexSrc, fragmentDirectives, fragmentSrc, programVersion, newEntry.Program );
+			}
+			AddToCache( key, newEntry );
+			entry = ProgramCache.Get( key );
+		}
+		if ( !entry->Linked )
+		{
+			const char * error = FinishProgram( key, *entry, parms, numParms );
+			if ( error != NULL )
+			{
+				GlProgram failed = entry->Program;
+				RemoveFromCache( key );
+				FreeProgramObjects( failed );
+				if ( abortOnError )
+				{
+					OVR_FAIL( "%s", error );
+				}
+				return GlProgram();
+			}
+		}
+	}
+
+	entry->RefCount++;
+	GlProgram p = entry->Program;
+	p.UseDeprecatedInterface = useDeprecatedInterface;
 	return p;
 }
 
 void GlProgram::Free( GlProgram & prog )
 {
 	glUseProgram( 0 );
-	if ( prog.Program != 0 )
+	const uint64_t * key = ( prog.Program != 0 ) ? ProgramCacheKeys.Get( prog.Program ) : NULL;
+	if ( key != NULL )
 	{
-		glDeleteProgram( prog.Program );
-	}
-	if ( prog.VertexShader != 0 )
-	{
-		glDeleteShader( prog.VertexShader );
+		ovrProgramCacheEntry * entry = ProgramCache.Get( *key );
+		if ( --entry->RefCount <= 0 )
+		{
+			GlProgram last = entry->Program;
+			RemoveFromCache( *key );
+			FreeProgramObjects( last );
+		}
 	}
-	if ( prog.FragmentShader != 0 )
+	else
 	{
-		glDeleteShader( prog.FragmentShader );
+		// not built by Build(), or forgotten by ShutdownCache()
+		FreeProgramObjects( prog );
 	}
 	prog.Program = 0;
 	prog.VertexShader = 0;
 	prog.FragmentShader = 0;
 }
 
+void GlProgram::Prefetch( const char * vertexDirectives, const char * vertexSrc,
+						  const char * fragmentDirectives, const char * fragmentSrc,
+						  const ovrProgramParm * parms, const int numParms,
+						  const int requestedProgramVersion )
+{
+	const int programVersion = ProgramVersion( requestedProgramVersion, fragmentDirectives, fragmentSrc );
+	const uint64_t key = ProgramKey( vertexDirectives, vertexSrc, fragmentDirectives, fragmentSrc, parms, numParms, programVersion );
+	if ( ProgramCache.Get( key ) != NULL )
+	{
+		return;
+	}
+	ovrProgramCacheEntry entry;
+	if ( !LoadProgramBinary( key, entry ) )
+	{
+		StartProgram( vertexDirectives, vertexSrc, fragmentDirectives, fragmentSrc, programVersion, entry.Program );
+	}
+	AddToCache( key, entry );
+}
+
+void GlProgram::ShutdownCache()
+{
+	Array< uint64_t > keys;
+	int numLive = 0;
+	for ( Hash< uint64_t, ovrProgramCacheEntry >::Iterator it = ProgramCache.Begin(); it != ProgramCache.End(); ++it )
+	{
+		keys.PushBack( it->First );
+		if ( it->Second.RefCount > 0 )
+		{
+			numLive++;
+		}
+	}
+	if ( numLive > 0 )
+	{
+		OVR_WARN( "GlProgram::ShutdownCache: %d programs were not freed", numLive );
+	}
+	for ( int i = 0; i < keys.GetSizeI(); i++ )
+	{
+		ovrProgramCacheEntry * entry = ProgramCache.Get( keys[i] );
+		GlProgram prog = entry->Program;
+		const bool unbuilt = ( entry->RefCount == 0 );
+		RemoveFromCache( keys[i] );
+		if ( unbuilt )
+		{
+			FreeProgramObjects( prog );
+		}
+	}
+	ProgramCache.Clear();
+	ProgramCacheKeys.Clear();
+	NumBinaryFormats = -1;
+}
+
+void GlProgram::SetBinaryCachePath( const char * path )
+{
+	BinaryCachePath[0] = '\0';
+	if ( path != NULL && path[0] != '\0' )
+	{
+		const size_t length = strlen( path );
+		OVR_sprintf( BinaryCachePath, sizeof( BinaryCachePath ), "%s%s", path, ( path[length - 1] != '/' ) ? "/" : "" );
+	}
+}
+
+ovrProgramCacheStats GlProgram::GetCacheStats()
+{
+	return ProgramCacheStats;
+}
+
 void GlProgram::SetUseMultiview( const bool useMultiview_ )
 {
 	UseMultiview = useMultiview_;
@@ -20,6 +20,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_LogUtils.h"
 #include "OVR_Input.h"
 #include "AppLocal.h"
+#include "VrApi.h"
 
 namespace OVR {
 
@@ -82,7 +83,6 @@ typedef struct
 
 GlWindow_t glWindow;
 
-static const int	MIN_SLOTS_AVAILABLE_FOR_INPUT = 12;
 AppLocal * app;
 
 LRESULT APIENTRY WndProc( HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam )
@@ -128,7 +128,7 @@ LRESULT APIENTRY WndProc( HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam
 				const ovrKeyCode key = OSKeyToKeyCode( (int)wParam );
 				if ( app && !window->keyInput[key] )
 				{
-					app->GetMessageQueue().PostPrintfIfSpaceAvailable( MIN_SLOTS_AVAILABLE_FOR_INPUT, "key %i %i %i", key, 1, 0 );
+					app->GetInputEvents().PostKey( vrapi_GetTimeInSeconds(), key, true, 0 );
 				}
 				window->keyInput[key] = true;
 				OVR_LOG( "%s down\n", GetNameForKeyCode( key ) );
@@ -144,7 +144,7 @@ LRESULT APIENTRY WndProc( HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam
 				OVR_LOG( "%s up\n", GetNameForKeyCode( key ) );
 				if ( app )
 				{
-					app->GetMessageQueue().PostPrintfIfSpaceAvailable( MIN_SLOTS_AVAILABLE_FOR_INPUT, "key %i %i %i", key, 0, 0 );
+					app->GetInputEvents().PostKey( vrapi_GetTimeInSeconds(), key, false, 0 );
 				}
 			}
 			break;
@@ -985,16 +985,14 @@ struct OVR_KTX_HEADER
 };
 #pragma pack()
 
-GlTexture LoadTextureKTX( const char * fileName, const unsigned char * buffer, const int bufferLength,
-						bool useSrgbFormat, bool noMipMaps, int & width, int & height )
+// Checks the header of a KTX file and returns where the image data starts.
+static bool ParseKTXHeader( const char * fileName, const unsigned char * buffer, const size_t bufferLength,
+						eTextureFormat & format, int & width, int & height, int & numFaces, int & numLevels, size_t & startTex )
 {
-	width = 0;
-	height = 0;
-
-	if ( bufferLength < (int)( sizeof( OVR_KTX_HEADER ) ) )
+	if ( bufferLength < sizeof( OVR_KTX_HEADER ) )
 	{
 		OVR_LOG( "%s: Invalid KTX file", fileName );
-		return GlTexture( 0, 0, 0 );
+		return false;
 	}
 
 	const char fileIdentifier[12] =
@@ -1006,59 +1004,80 @@ GlTexture LoadTextureKTX( const char * fileName, const unsigned char * buffer, c
 	if ( memcmp( header.identifier, fileIdentifier, sizeof( fileIdentifier ) ) != 0 )
 	{
 		OVR_LOG( "%s: Invalid KTX file", fileName );
-		return GlTexture( 0, 0, 0 );
+		return false;
 	}
 	// only support little endian
 	if ( header.endianness != 0x04030201 )
 	{
 		OVR_LOG( "%s: KTX file has wrong endianess", fileName );
-		return GlTexture( 0, 0, 0 );
+		return false;
 	}
 	// only support compressed or unsigned byte
 	if ( header.glType != 0 && header.glType != GL_UNSIGNED_BYTE )
 	{
 		OVR_LOG( "%s: KTX file has unsupported glType %d", fileName, header.glType );
-		return GlTexture( 0, 0, 0 );
+		return false;
 	}
 	// no support for texture arrays
 	if ( header.numberOfArrayElements != 0 )
 	{
 		OVR_LOG( "%s: KTX file has unsupported number of array elements %d", fileName, header.numberOfArrayElements );
-		return GlTexture( 0, 0, 0 );
+		return false;
 	}
 
 	// derive the texture format from the GL format
-	eTextureFormat format = Texture_None;
+	format = Texture_None;
 	if ( !GlFormatToTextureFormat( format, header.glFormat, header.glInternalFormat ) )
 	{
 		OVR_LOG( "%s: KTX file has unsupported glFormat %d, glInternalFormat %d", fileName, header.glFormat, header.glInternalFormat );
-		return GlTexture( 0, 0, 0 );
+		return false;
 	}
 
 	// skip the key value data
-	const uintptr_t startTex = sizeof( OVR_KTX_HEADER ) + header.bytesOfKeyValueData;
-	if ( ( startTex < sizeof( OVR_KTX_HEADER ) ) || ( startTex >= static_cast< size_t >( bufferLength ) ) )
+	startTex = sizeof( OVR_KTX_HEADER ) + header.bytesOfKeyValueData;
+	if ( ( startTex < sizeof( OVR_KTX_HEADER ) ) || ( startTex >= bufferLength ) )
 	{
 		OVR_LOG( "%s: Invalid KTX header sizes", fileName );
-		return GlTexture( 0, 0, 0 );
+		return false;
 	}
 
 	width = header.pixelWidth;
 	height = header.pixelHeight;
+	numFaces = header.numberOfFaces;
+	numLevels = OVR::Alg::Max( static_cast<UInt32>( 1u ), header.numberOfMipmapLevels );
+	return true;
+}
+
+GlTexture LoadTextureKTX( const char * fileName, const unsigned char * buffer, const int bufferLength,
+						bool useSrgbFormat, bool noMipMaps, int & width, int & height )
+{
+	width = 0;
+	height = 0;
+
+	eTextureFormat format = Texture_None;
+	int numFaces = 0;
+	int numLevels = 0;
+	size_t startTex = 0;
+	if ( bufferLength < 0 || !ParseKTXHeader( fileName, buffer, bufferLength, format, width, height, numFaces, numLevels, startTex ) )
+	{
+		width = 0;
+		height = 0;
+		return GlTexture( 0, 0, 0 );
+	}
 
-	const UInt32 mipCount = ( noMipMaps ) ? 1 : OVR::Alg::Max( static_cast<UInt32>( 1u ), header.numberOfMipmapLevels );
+	const int mipCount = ( noMipMaps ) ? 1 : numLevels;
 
-	if ( header.numberOfFaces == 1 )
+	if ( numFaces == 1 )
 	{
 		return CreateGlTexture( fileName, format, width, height, buffer + startTex, bufferLength - startTex, mipCount, useSrgbFormat, true );
 	}
-	else if ( header.numberOfFaces == 6 )
+	else if ( numFaces == 6 )
 	{
 		return CreateGlCubeTexture( fileName, format, width, height, buffer + startTex, bufferLength - startTex, mipCount, useSrgbFormat, true );
 	}
 	else
 	{
-		OVR_LOG( "%s: KTX file has unsupported number of faces %d", fileName, header.numberOfFaces );
+		OVR_LOG( "%s: KTX file has unsupported number of faces %d", fileName, numFaces );
 	}
 
 	width = 0;
@@ -1105,6 +1124,263 @@ static int MipLevelsForSize( int width, int height )
 	return levels;
 }
 
+static bool IsStbImageExtension( const String & ext )
+{
+	return	ext == ".jpg" || ext == ".tga" ||
+			ext == ".png" || ext == ".bmp" ||
+			ext == ".psd" || ext == ".gif" ||
+			ext == ".hdr" || ext == ".pic";
+}
+
+static void OutlineAlphaBorder( unsigned char * image, const int width, const int height )
+{
+	for ( int i = 0 ; i < width ; i++ )
+	{
+		image[i*4+3] = 0;
+		image[((height-1)*width+i)*4+3] = 0;
+	}
+	for ( int i = 0 ; i < height ; i++ )
+	{
+		image[i*width*4+3] = 0;
+		image[(i*width+width-1)*4+3] = 0;
+	}
+}
+
+struct ovrSrgbTables
+{
+	float	ToLinear[256];
+	uint8_t	FromLinear[4096];
+
+	ovrSrgbTables()
+	{
+		for ( int i = 0; i < 256; i++ )
+		{
+			const float c = i / 255.0f;
+			ToLinear[i] = ( c <= 0.04045f ) ? c / 12.92f : powf( ( c + 0.055f ) / 1.055f, 2.4f );
+		}
+		for ( int i = 0; i < 4096; i++ )
+		{
+			const float l = i / 4095.0f;
+			const float c = ( l <= 0.0031308f ) ? l * 12.92f : 1.055f * powf( l, 1.0f / 2.4f ) - 0.055f;
+			FromLinear[i] = static_cast< uint8_t >( c * 255.0f + 0.5f );
+		}
+	}
+};
+
+// Box filters an RGBA level down to the next one. Odd rows and columns are folded into the
+// last texel. sRGB colors are averaged in linear space, the same as glGenerateMipmap.
+static void DownsampleRGBA( const uint8_t * src, const int srcWidth, const int srcHeight,
+						uint8_t * dst, const int dstWidth, const int dstHeight, const bool useSrgbFormat )
+{
+	static const ovrSrgbTables srgb;
+
+	for ( int y = 0; y < dstHeight; y++ )
+	{
+		const int y0 = Alg::Min( y * 2, srcHeight - 1 );
+		const int y1 = Alg::Min( y * 2 + 1, srcHeight - 1 );
+		for ( int x = 0; x < dstWidth; x++ )
+		{
+			const int x0 = Alg::Min( x * 2, srcWidth - 1 );
+			const int x1 = Alg::Min( x * 2 + 1, srcWidth - 1 );
+			const uint8_t * s00 = &src[( y0 * srcWidth + x0 ) * 4];
+			const uint8_t * s01 = &src[( y0 * srcWidth + x1 ) * 4];
+			const uint8_t * s10 = &src[( y1 * srcWidth + x0 ) * 4];
+			const uint8_t * s11 = &src[( y1 * srcWidth + x1 ) * 4];
+			uint8_t * d = &dst[( y * dstWidth + x ) * 4];
+			for ( int c = 0; c < 3; c++ )
+			{
+				if ( useSrgbFormat )
+				{
+					const float l = ( srgb.ToLinear[s00[c]] + srgb.ToLinear[s01[c]] + srgb.ToLinear[s10[c]] + srgb.ToLinear[s11[c]] ) * 0.25f;
+					d[c] = srgb.FromLinear[static_cast< int >( l * 4095.0f + 0.5f )];
+				}
+				else
+				{
+					d[c] = static_cast< uint8_t >( ( s00[c] + s01[c] + s10[c] + s11[c] + 2 ) >> 2 );
+				}
+			}
+			d[3] = static_cast< uint8_t >( ( s00[3] + s01[3] + s10[3] + s11[3] + 2 ) >> 2 );
+		}
+	}
+}
+
+bool GetTextureSizeFromBuffer( const char * fileName, const uint8_t * buffer, const size_t bufferLength,
+		int & width, int & height, bool & isStreamable )
+{
+	const String ext = String( fileName ).GetExtension().ToLower();
+
+	width = 0;
+	height = 0;
+	isStreamable = false;
+
+	if ( buffer == NULL || bufferLength < 1 )
+	{
+		return false;
+	}
+
+	if ( IsStbImageExtension( ext ) )
+	{
+		int comp;
+		if ( stbi_info_from_memory( buffer, (int)bufferLength, &width, &height, &comp ) == 0 )
+		{
+			return false;
+		}
+		isStreamable = true;
+		return true;
+	}
+
+	if ( ext == ".ktx" )
+	{
+		eTextureFormat format = Texture_None;
+		int numFaces = 0;
+		int numLevels = 0;
+		size_t startTex = 0;
+		if ( !ParseKTXHeader( fileName, buffer, bufferLength, format, width, height, numFaces, numLevels, startTex ) )
+		{
+			width = 0;
+			height = 0;
+			return false;
+		}
+		isStreamable = ( numFaces == 1 );
+		return true;
+	}
+
+	return false;
+}
+
+bool DecodeTextureFromRGBA( const uint8_t * image, const int width, const int height,
+		const TextureFlags_t & flags, ovrDecodedTexture & decoded )
+{
+	decoded.UseSrgb = ( flags & TEXTUREFLAG_USE_SRGB ) != 0;
+	decoded.NumLevels = 0;
+
+	if ( image == NULL || width < 1 || height < 1 )
+	{
+		return false;
+	}
+
+	decoded.Format = Texture_RGBA;
+	decoded.Width = width;
+	decoded.Height = height;
+	decoded.NumLevels = Alg::Min( ( flags & TEXTUREFLAG_NO_MIPMAPS ) ? 1 : MipLevelsForSize( width, height ),
+			static_cast< int >( ovrDecodedTexture::MAX_LEVELS ) );
+
+	size_t dataSize = 0;
+	for ( int i = 0; i < decoded.NumLevels; i++ )
+	{
+		decoded.LevelOffset[i] = dataSize;
+		decoded.LevelSize[i] = GetOvrTextureSize( Texture_RGBA, decoded.GetLevelWidth( i ), decoded.GetLevelHeight( i ) );
+		dataSize += decoded.LevelSize[i];
+	}
+	decoded.Data.Realloc( dataSize );
+
+	uint8_t * data = decoded.Data;
+	memcpy( data, image, decoded.LevelSize[0] );
+
+	if ( flags & TEXTUREFLAG_ALPHA_BORDER )
+	{
+		OutlineAlphaBorder( data, width, height );
+	}
+
+	for ( int i = 1; i < decoded.NumLevels; i++ )
+	{
+		DownsampleRGBA( data + decoded.LevelOffset[i - 1], decoded.GetLevelWidth( i - 1 ), decoded.GetLevelHeight( i - 1 ),
+				data + decoded.LevelOffset[i], decoded.GetLevelWidth( i ), decoded.GetLevelHeight( i ), decoded.UseSrgb );
+	}
+	return true;
+}
+
+bool DecodeTextureFromBuffer( const char * fileName, const uint8_t * buffer, const size_t bufferLength,
+		const TextureFlags_t & flags, ovrDecodedTexture & decoded )
+{
+	const String ext = String( fileName ).GetExtension().ToLower();
+
+	decoded.UseSrgb = ( flags & TEXTUREFLAG_USE_SRGB ) != 0;
+	decoded.NumLevels = 0;
+
+	if ( buffer == NULL || bufferLength < 1 )
+	{
+		return false;
+	}
+
+	if ( IsStbImageExtension( ext ) )
+	{
+		int width = 0;
+		int height = 0;
+		int comp;
+		stbi_uc * image = stbi_load_from_memory( buffer, (int)bufferLength, &width, &height, &comp, 4 );
+		if ( image == NULL )
+		{
+			OVR_LOG( "%s: stbi_load_from_memory() failed!", fileName );
+			return false;
+		}
+
+		const bool result = DecodeTextureFromRGBA( image, width, height, flags, decoded );
+		free( image );
+		return result;
+	}
+
+	if ( ext == ".ktx" )
+	{
+		int numFaces = 0;
+		int numLevels = 0;
+		size_t startTex = 0;
+		if ( !ParseKTXHeader( fileName, buffer, bufferLength, decoded.Format, decoded.Width, decoded.Height, numFaces, numLevels, startTex ) )
+		{
+			return false;
+		}
+		if ( numFaces != 1 )
+		{
+			OVR_LOG( "%s: KTX file has unsupported number of faces %d", fileName, numFaces );
+			return false;
+		}
+		if ( decoded.Width <= 0 || decoded.Width > 32768 || decoded.Height <= 0 || decoded.Height > 32768 )
+		{
+			OVR_LOG( "%s: Invalid texture size (%dx%d)", fileName, decoded.Width, decoded.Height );
+			return false;
+		}
+
+		numLevels = Alg::Min( ( flags & TEXTUREFLAG_NO_MIPMAPS ) ? 1 : numLevels, static_cast< int >( ovrDecodedTexture::MAX_LEVELS ) );
+
+		// Every level is preceded by its size and padded to 4 bytes.
+		const uint8_t * level = buffer + startTex;
+		const uint8_t * endOfBuffer = buffer + bufferLength;
+		size_t dataSize = 0;
+		for ( int i = 0; i < numLevels; i++ )
+		{
+			if ( endOfBuffer - level < 4 )
+			{
+				OVR_LOG( "%s: Image data exceeds buffer size", fileName );
+				return false;
+			}
+			const uint32_t mipSize = *(const uint32_t *)level;
+			level += 4;
+			if ( mipSize == 0 || mipSize > static_cast< size_t >( endOfBuffer - level ) )
+			{
+				OVR_LOG( "%s: Mip level %d exceeds buffer size (%u > %td)", fileName, i, mipSize, ptrdiff_t( endOfBuffer - level ) );
+				return false;
+			}
+			decoded.LevelOffset[i] = level - ( buffer + startTex );
+			decoded.LevelSize[i] = mipSize;
+			dataSize = decoded.LevelOffset[i] + mipSize;
+			level += mipSize + 3 - ( ( mipSize + 3 ) % 4 );
+		}
+
+		decoded.NumLevels = numLevels;
+		decoded.Data.Realloc( dataSize );
+		memcpy( decoded.Data, buffer + startTex, dataSize );
+		return true;
+	}
+
+	OVR_LOG( "%s: can't decode '%s' files", fileName, ext.ToCStr() );
+	return false;
+}
+
+bool IsCompressedTextureFormat( const eTextureFormat format )
+{
+	return IsCompressedFormat( format );
+}
+
 GlTexture LoadTextureFromBuffer( const char * fileName, const MemBuffer & buffer,
 		const TextureFlags_t & flags, int & width, int & height )
 {
@@ -1120,10 +1396,7 @@ GlTexture LoadTextureFromBuffer( const char * fileName, const MemBuffer & buffer
 	{
 		// can't load anything from an empty buffer
 	}
-	else if (	ext == ".jpg" || ext == ".tga" ||
-				ext == ".png" || ext == ".bmp" ||
-				ext == ".psd" || ext == ".gif" ||
-				ext == ".hdr" || ext == ".pic" )
+	else if ( IsStbImageExtension( ext ) )
 	{
 		// Uncompressed files loaded by stb_image
 		int comp;
@@ -1133,16 +1406,7 @@ GlTexture LoadTextureFromBuffer( const char * fileName, const MemBuffer & buffer
 			// Optionally outline the border alpha.
 			if ( flags & TEXTUREFLAG_ALPHA_BORDER )
 			{
-				for ( int i = 0 ; i < width ; i++ )
-				{
-					image[i*4+3] = 0;
-					image[((height-1)*width+i)*4+3] = 0;
-				}
-				for ( int i = 0 ; i < height ; i++ )
-				{
-					image[i*width*4+3] = 0;
-					image[(i*width+width-1)*4+3] = 0;
-				}
+				OutlineAlphaBorder( image, width, height );
 			}
 
 			const size_t dataSize = GetOvrTextureSize( Texture_RGBA, width, height );
@@ -0,0 +1,107 @@
+/************************************************************************************
+
+Filename    :   InputEventRing.cpp
+Content     :   Fixed-capacity ring of timestamped joystick and key events.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "InputEventRing.h"
+
+namespace OVR {
+
+static_assert( ( ovrInputEventRing::CAPACITY & ( ovrInputEventRing::CAPACITY - 1 ) ) == 0, "CAPACITY must be a power of 2" );
+
+ovrInputEventRing::ovrInputEventRing() :
+	Head( 0 ),
+	Tail( 0 ),
+	NumDropped( 0 )
+{
+	for ( int i = 0; i < CAPACITY; i++ )
+	{
+		Slots[i].Sequence.store( i, std::memory_order_relaxed );
+	}
+}
+
+bool ovrInputEventRing::Post( const ovrInputEvent & event, const int minFree )
+{
+	uint32_t position = Head.load( std::memory_order_relaxed );
+	for ( ; ; )
+	{
+		if ( minFree > 1 && (int)( position - Tail.load( std::memory_order_relaxed ) ) > CAPACITY - minFree )
+		{
+			NumDropped.fetch_add( 1, std::memory_order_relaxed );
+			return false;
+		}
+		ovrSlot & slot = Slots[position & ( CAPACITY - 1 )];
+		const int32_t difference = (int32_t)( slot.Sequence.load( std::memory_order_acquire ) - position );
+		if ( difference == 0 )
+		{
+			// the slot is free, claim it unless another thread did first
+			if ( Head.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+			{
+				slot.Event = event;
+				slot.Sequence.store( position + 1, std::memory_order_release );
+				return true;
+			}
+		}
+		else if ( difference < 0 )
+		{
+			// the slot has not been read since the ring last wrapped
+			NumDropped.fetch_add( 1, std::memory_order_relaxed );
+			return false;
+		}
+		else
+		{
+			position = Head.load( std::memory_order_relaxed );
+		}
+	}
+}
+
+bool ovrInputEventRing::PostJoySticks( const double timeInSeconds, const float lx, const float ly, const float rx, const float ry )
+{
+	ovrInputEvent event;
+	event.TimeInSeconds = timeInSeconds;
+	event.Type = INPUT_EVENT_JOYSTICKS;
+	event.JoySticks[0][0] = lx;
+	event.JoySticks[0][1] = ly;
+	event.JoySticks[1][0] = rx;
+	event.JoySticks[1][1] = ry;
+	return Post( event, RESERVED_FOR_KEYS + 1 );
+}
+
+bool ovrInputEventRing::PostKey( const double timeInSeconds, const int keyCode, const bool down, const int repeatCount )
+{
+	ovrInputEvent event;
+	event.TimeInSeconds = timeInSeconds;
+	event.Type = INPUT_EVENT_KEY;
+	event.Key.KeyCode = keyCode;
+	event.Key.RepeatCount = repeatCount;
+	event.Key.Down = down;
+	return Post( event, 1 );
+}
+
+const ovrInputEvent * ovrInputEventRing::Peek() const
+{
+	const uint32_t position = Tail.load( std::memory_order_relaxed );
+	const ovrSlot & slot = Slots[position & ( CAPACITY - 1 )];
+	if ( slot.Sequence.load( std::memory_order_acquire ) != position + 1 )
+	{
+		return NULL;
+	}
+	return &slot.Event;
+}
+
+void ovrInputEventRing::Pop()
+{
+	const uint32_t position = Tail.load( std::memory_order_relaxed );
+	ovrSlot & slot = Slots[position & ( CAPACITY - 1 )];
+	OVR_ASSERT( slot.Sequence.load( std::memory_order_relaxed ) == position + 1 );
+	slot.Sequence.store( position + CAPACITY, std::memory_order_release );
+	Tail.store( position + 1, std::memory_order_relaxed );
+}
+
+} // namespace OVR
@@ -43,6 +43,7 @@ public:
 	virtual bool			ReadFile( char const * uri, MemBufferT< uint8_t > & outBuffer );
 	virtual bool			FileExists( char const * uri );
 	virtual bool			GetLocalPathForURI( char const * uri, String &outputPath );
+	virtual bool			GetLocalRangeForURI( char const * uri, String & outPath, size_t & outOffset, size_t & outLength, bool & outMap );
 
 	virtual void			Shutdown();
 
@@ -415,6 +416,20 @@ bool ovrFileSysLocal::GetLocalPathForURI( char const * uri, String &outputPath )
 	return result;	
 }
 
+//==============================
+// ovrFileSysLocal::GetLocalRangeForURI
+bool ovrFileSysLocal::GetLocalRangeForURI( char const * uri, String & outPath, size_t & outOffset, size_t & outLength, bool & outMap )
+{
+	ovrStream * stream = OpenStream( uri, OVR_STREAM_MODE_READ );
+	if ( stream == NULL )
+	{
+		return false;
+	}
+	const bool result = stream->GetLocalRange( outPath, outOffset, outLength, outMap );
+	CloseStream( stream );
+	return result;
+}
+
 //==============================
 // ovrFileSysLocal::FindSchemeIndexForName
 int ovrFileSysLocal::FindSchemeIndexForName( char const * schemeName ) const
@@ -332,6 +332,11 @@ void GL_InitExtensions()
 		extensionsOpenGL.EXT_texture_border_clamp = true;
 	}
 
+	if ( GL_ExtensionStringPresent( "GL_KHR_texture_compression_astc_ldr", extensions ) )
+	{
+		extensionsOpenGL.KHR_texture_compression_astc_ldr = true;
+	}
+
 	if ( GL_ExtensionStringPresent( "GL_EXT_texture_filter_anisotropic", extensions ) )
 	{
 		extensionsOpenGL.EXT_texture_filter_anisotropic = true;
@@ -0,0 +1,671 @@
+/************************************************************************************
+
+Filename    :   OVR_PackWriter.cpp
+Content     :   Writes generated assets into zip packs, compressing them on worker threads.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "OVR_PackWriter.h"
+
+#include "Kernel/OVR_LogUtils.h"
+#include "Kernel/OVR_Std.h"
+
+#include "unzip.h"
+#include "zip.h"
+
+#include <string.h>
+#include <time.h>
+#if defined( OVR_OS_WIN32 )
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace OVR {
+
+static const size_t		LOCAL_HEADER_SIZE = 30;
+static const size_t		END_OF_CENTRAL_DIR_SIZE = 22;
+static const uint32_t	CENTRAL_DIR_SIGNATURE = 0x02014b50;
+static const uint32_t	END_OF_CENTRAL_DIR_SIGNATURE = 0x06054b50;
+static const uint16_t	ALIGNMENT_EXTRA_ID = 0xd935;		// the extra field zipalign pads with
+static const size_t		ALIGNMENT_EXTRA_SIZE = 6;			// id, size and alignment
+static const int		MAX_FILES = 0xffff;					// more need zip64 end records
+static const size_t		MAX_PACK_LENGTH = 0xffffffff;		// larger packs need zip64 offsets
+
+//==============================================================
+// File helpers
+
+#if defined( OVR_OS_WIN32 )
+
+static int64_t TellFile( FILE * file ) { return _ftelli64( file ); }
+static bool SeekFile( FILE * file, const int64_t offset ) { return _fseeki64( file, offset, SEEK_SET ) == 0; }
+static bool SyncFile( FILE * file ) { return fflush( file ) == 0 && _commit( _fileno( file ) ) == 0; }
+
+static bool TruncateFile( char const * path, const size_t length )
+{
+	int fd = -1;
+	if ( _sopen_s( &fd, path, _O_RDWR | _O_BINARY, _SH_DENYNO, 0 ) != 0 )
+	{
+		return false;
+	}
+	const bool truncated = _chsize_s( fd, length ) == 0;
+	_close( fd );
+	return truncated;
+}
+
+static bool ReplaceFile( char const * from, char const * to )
+{
+	return MoveFileExA( from, to, MOVEFILE_REPLACE_EXISTING ) != 0;
+}
+
+#else
+
+static int64_t TellFile( FILE * file ) { return ftello( file ); }
+static bool SeekFile( FILE * file, const int64_t offset ) { return fseeko( file, offset, SEEK_SET ) == 0; }
+static bool SyncFile( FILE * file ) { return fflush( file ) == 0 && fsync( fileno( file ) ) == 0; }
+static bool TruncateFile( char const * path, const size_t length ) { return truncate( path, length ) == 0; }
+static bool ReplaceFile( char const * from, char const * to ) { return rename( from, to ) == 0; }
+
+#endif
+
+static uint32_t ReadLE16( uint8_t const * p ) { return p[0] | ( p[1] << 8 ); }
+static uint32_t ReadLE32( uint8_t const * p ) { return p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( (uint32_t)p[3] << 24 ); }
+static void WriteLE16( uint8_t * p, const uint32_t x ) { p[0] = (uint8_t)x; p[1] = (uint8_t)( x >> 8 ); }
+
+// A complete end of central directory record at offset, for a pack without zip64 records.
+static bool IsPackEnd( FILE * file, uint8_t const * record, const int64_t offset, const int64_t fileLength )
+{
+	const int64_t indexOffset = ReadLE32( record + 16 );
+	const int64_t indexLength = ReadLE32( record + 12 );
+	if ( ReadLE32( record ) != END_OF_CENTRAL_DIR_SIGNATURE ||
+			ReadLE32( record + 4 ) != 0 ||							// single disk
+			ReadLE16( record + 8 ) != ReadLE16( record + 10 ) ||
+			indexOffset + indexLength != offset ||
+			offset + (int64_t)END_OF_CENTRAL_DIR_SIZE + ReadLE16( record + 20 ) > fileLength )
+	{
+		return false;
+	}
+	if ( indexLength == 0 )
+	{
+		return true;
+	}
+	uint8_t signature[4];
+	const int64_t restore = TellFile( file );
+	const bool found = SeekFile( file, indexOffset ) && fread( signature, 1, 4, file ) == 4 &&
+						ReadLE32( signature ) == CENTRAL_DIR_SIGNATURE;
+	SeekFile( file, restore );
+	return found;
+}
+
+// Finds the end of the last complete pack in the file at path and cuts off anything after
+// it, which is what is left of an append that did not finish.
+static bool FindPackEnd( char const * path, size_t & outLength, size_t & outIndexLength )
+{
+	static const int64_t BLOCK_SIZE = 64 * 1024;
+
+	FILE * file = fopen( path, "rb" );
+	if ( file == NULL )
+	{
+		return false;
+	}
+	fseek( file, 0, SEEK_END );
+	const int64_t fileLength = TellFile( file );
+
+	Array< uint8_t > block;
+	block.Resize( BLOCK_SIZE );
+	int64_t end = -1;
+	int64_t indexLength = 0;
+	for ( int64_t blockEnd = fileLength; blockEnd >= (int64_t)END_OF_CENTRAL_DIR_SIZE && end < 0; )
+	{
+		const int64_t blockStart = ( blockEnd > BLOCK_SIZE ) ? blockEnd - BLOCK_SIZE : 0;
+		if ( !SeekFile( file, blockStart ) || fread( block.GetDataPtr(), 1, (size_t)( blockEnd - blockStart ), file ) != (size_t)( blockEnd - blockStart ) )
+		{
+			break;
+		}
+		for ( int64_t offset = blockEnd - END_OF_CENTRAL_DIR_SIZE; offset >= blockStart; offset-- )
+		{
+			uint8_t const * record = &block[offset - blockStart];
+			if ( record[0] == 0x50 && IsPackEnd( file, record, offset, fileLength ) )
+			{
+				end = offset + END_OF_CENTRAL_DIR_SIZE + ReadLE16( record + 20 );
+				indexLength = end - ReadLE32( record + 16 );
+				break;
+			}
+		}
+		if ( blockStart == 0 )
+		{
+			break;
+		}
+		// overlap the blocks so a record across the boundary is found
+		blockEnd = blockStart + END_OF_CENTRAL_DIR_SIZE - 1;
+	}
+	fclose( file );
+
+	if ( end < 0 )
+	{
+		return false;
+	}
+	if ( end < fileLength )
+	{
+		OVR_LOG( "ovrPackWriter: dropping %lld bytes from the end of %s", (long long)( fileLength - end ), path );
+		if ( !TruncateFile( path, (size_t)end ) )
+		{
+			return false;
+		}
+	}
+	outLength = (size_t)end;
+	outIndexLength = (size_t)indexLength;
+	return true;
+}
+
+// Files that are compressed already are stored.
+static bool IsCompressedFormat( char const * name )
+{
+	static char const * extensions[] = { ".jpg", ".jpeg", ".png", ".ktx", ".astc", ".pkm",
+										".webp", ".ogg", ".mp3", ".mp4", ".zip", ".gz" };
+	const size_t nameLength = strlen( name );
+	for ( size_t i = 0; i < sizeof( extensions ) / sizeof( extensions[0] ); i++ )
+	{
+		const size_t length = strlen( extensions[i] );
+		if ( nameLength >= length && OVR_stricmp( name + nameLength - length, extensions[i] ) == 0 )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// unzGoToFirstFile() fails on a pack without files.
+static int GoToFirstFile( unzFile pack )
+{
+	unz_global_info info;
+	if ( unzGetGlobalInfo( pack, &info ) != UNZ_OK )
+	{
+		return UNZ_ERRNO;
+	}
+	return ( info.number_entry > 0 ) ? unzGoToFirstFile( pack ) : UNZ_END_OF_LIST_OF_FILE;
+}
+
+//==============================================================
+// ovrPackEntry
+
+struct ovrPackWriter::ovrPackEntry
+{
+	ovrPackEntry( char const * name, MemBufferT< uint8_t > & data, const int method )
+		: Name( name )
+		, CompressedLength( 0 )
+		, Crc( 0 )
+		, Method( method )
+		, Done( false )
+	{
+		Data = data;
+	}
+
+	String					Name;
+	MemBufferT< uint8_t >	Data;
+	MemBufferT< uint8_t >	Compressed;
+	size_t					CompressedLength;
+	uint32_t				Crc;
+	int						Method;		// 0 when stored
+	bool					Done;		// compressed, under QueueMutex
+};
+
+//==============================================================
+// ovrPackWriter
+
+ovrPackWriter::ovrPackWriter()
+	: OriginalLength( 0 )
+	, Zip( NULL )
+	, File( NULL )
+	, SyncOnClose( true )
+	, Failed( false )
+	, CompressionLevel( DEFAULT_COMPRESSION_LEVEL )
+	, DosDate( 0 )
+	, NextWrite( 0 )
+	, NextCompress( 0 )
+	, PendingBytes( 0 )
+	, Exiting( false )
+{
+}
+
+ovrPackWriter::~ovrPackWriter()
+{
+	Abort();
+}
+
+bool ovrPackWriter::Open( char const * path, const bool append, const int numThreads, const int compressionLevel )
+{
+	OVR_ASSERT( !IsOpen() );
+
+	Path = path;
+	WritePath = Path + ".tmp";
+	OriginalLength = 0;
+	Failed = false;
+	SyncOnClose = true;
+	CompressionLevel = compressionLevel;
+	Names.Clear();
+
+	const time_t now = time( NULL );
+	const struct tm * local = localtime( &now );
+	DosDate = ( local == NULL || local->tm_year < 80 ) ? 0 :
+				( ( local->tm_year - 80 ) << 25 ) | ( ( local->tm_mon + 1 ) << 21 ) | ( local->tm_mday << 16 ) |
+				( local->tm_hour << 11 ) | ( local->tm_min << 5 ) | ( local->tm_sec >> 1 );
+
+	// Find out what is in the pack and how much of it is left over from earlier appends.
+	unzFile pack = NULL;
+	bool inPlace = false;
+	size_t packLength = 0;
+	size_t indexLength = 0;
+	if ( append && FindPackEnd( path, packLength, indexLength ) && ( pack = unzOpen( path ) ) != NULL )
+	{
+		size_t filesLength = 0;
+		int ret = GoToFirstFile( pack );
+		for ( ; ret == UNZ_OK; ret = unzGoToNextFile( pack ) )
+		{
+			char name[1024];
+			unz_file_info info;
+			if ( unzGetCurrentFileInfo( pack, &info, name, sizeof( name ), NULL, 0, NULL, 0 ) != UNZ_OK )
+			{
+				break;
+			}
+			Names.SetCaseInsensitive( name, true );
+			filesLength += LOCAL_HEADER_SIZE + info.size_filename + info.size_file_extra + info.compressed_size;
+		}
+		if ( ret != UNZ_END_OF_LIST_OF_FILE )
+		{
+			OVR_WARN( "ovrPackWriter: could not read %s, starting it over", path );
+			Names.Clear();
+			unzClose( pack );
+			pack = NULL;
+		}
+		else
+		{
+			// anything that is not a file or the index was left by earlier appends
+			inPlace = packLength <= indexLength + 2 * filesLength;
+		}
+	}
+
+	zlib_filefunc64_def fileFuncs;
+	fill_fopen64_filefunc( &fileFuncs );
+	fileFuncs.zopen64_file = OpenCallback;
+	fileFuncs.zclose_file = CloseCallback;
+	fileFuncs.opaque = this;
+	if ( inPlace )
+	{
+		unzClose( pack );
+		pack = NULL;
+		WritePath = Path;
+		OriginalLength = packLength;
+		Zip = zipOpen2_64( path, APPEND_STATUS_ADDAFTERZIP, NULL, &fileFuncs );
+	}
+	else
+	{
+		Zip = zipOpen2_64( WritePath.ToCStr(), APPEND_STATUS_CREATE, NULL, &fileFuncs );
+	}
+	if ( Zip == NULL )
+	{
+		OVR_WARN( "ovrPackWriter: could not open %s", WritePath.ToCStr() );
+		if ( pack != NULL )
+		{
+			unzClose( pack );
+		}
+		Names.Clear();
+		return false;
+	}
+	if ( pack != NULL )
+	{
+		const bool copied = CopyFiles( pack );
+		unzClose( pack );
+		if ( !copied )
+		{
+			OVR_WARN( "ovrPackWriter: could not copy the files of %s", path );
+			Abort();
+			return false;
+		}
+	}
+
+	Exiting = false;
+	NextWrite = 0;
+	NextCompress = 0;
+	PendingBytes = 0;
+	for ( int i = 0; i < numThreads; i++ )
+	{
+		Thread::CreateParams createParams( ovrPackWriter::ThreadFn, this, 128 * 1024, -1,
+				Thread::Running, Thread::NormalPriority );
+		Threads.PushBack( new Thread( createParams ) );
+	}
+	return true;
+}
+
+bool ovrPackWriter::AddFile( char const * name, void const * data, const size_t length, const bool store )
+{
+	MemBufferT< uint8_t > buffer( length );
+	memcpy( (uint8_t *)buffer, data, length );
+	return AddFile( name, buffer, store );
+}
+
+bool ovrPackWriter::AddFile( char const * name, MemBufferT< uint8_t > & buffer, const bool store )
+{
+	if ( !IsOpen() || Failed )
+	{
+		return false;
+	}
+	if ( HasFile( name ) )
+	{
+		OVR_WARN( "ovrPackWriter: %s is already in %s", name, Path.ToCStr() );
+		return false;
+	}
+	if ( GetNumFiles() >= MAX_FILES || buffer.GetSize() >= MAX_PACK_LENGTH )
+	{
+		OVR_WARN( "ovrPackWriter: %s does not fit in %s", name, Path.ToCStr() );
+		return false;
+	}
+	Names.SetCaseInsensitive( name, true );
+
+	ovrPackEntry * entry = new ovrPackEntry( name, buffer, ( store || IsCompressedFormat( name ) ) ? 0 : Z_DEFLATED );
+	{
+		Mutex::Locker locker( &QueueMutex );
+		PendingBytes += entry->Data.GetSize();
+		Queue.PushBack( entry );
+		QueueWake.Notify();
+	}
+	return WriteFinished( false );
+}
+
+bool ovrPackWriter::Close()
+{
+	if ( !IsOpen() )
+	{
+		return false;
+	}
+	const bool written = WriteFinished( true );
+	StopThreads();
+	// The files are on storage before the central directory that points at them.
+	if ( !written || !SyncFile( File ) )
+	{
+		OVR_WARN( "ovrPackWriter: could not write %s", WritePath.ToCStr() );
+		Abort();
+		return false;
+	}
+	SyncOnClose = true;
+	const int closeRet = zipClose( Zip, NULL );
+	Zip = NULL;
+	if ( closeRet != ZIP_OK || ( WritePath != Path && !ReplaceFile( WritePath.ToCStr(), Path.ToCStr() ) ) )
+	{
+		OVR_WARN( "ovrPackWriter: could not finish %s", Path.ToCStr() );
+		Restore();
+		return false;
+	}
+	return true;
+}
+
+void ovrPackWriter::Abort()
+{
+	if ( !IsOpen() )
+	{
+		return;
+	}
+	StopThreads();
+	// There is no way to close the zip without writing a central directory, but it is
+	// cut off or deleted along with the files.
+	SyncOnClose = false;
+	zipClose( Zip, NULL );
+	Zip = NULL;
+	Restore();
+}
+
+void ovrPackWriter::Restore()
+{
+	if ( WritePath == Path )
+	{
+		TruncateFile( Path.ToCStr(), OriginalLength );
+	}
+	else
+	{
+		remove( WritePath.ToCStr() );
+	}
+	Names.Clear();
+}
+
+void ovrPackWriter::StopThreads()
+{
+	{
+		Mutex::Locker locker( &QueueMutex );
+		Exiting = true;
+		QueueWake.NotifyAll();
+	}
+	for ( int i = 0; i < Threads.GetSizeI(); i++ )
+	{
+		Threads[i]->Join();
+		delete Threads[i];
+	}
+	Threads.Clear();
+
+	for ( int i = NextWrite; i < Queue.GetSizeI(); i++ )
+	{
+		delete Queue[i];
+	}
+	Queue.Clear();
+	NextWrite = 0;
+	NextCompress = 0;
+	PendingBytes = 0;
+}
+
+// Copies the files of the pack that is being replaced without decompressing them.
+bool ovrPackWriter::CopyFiles( void * pack )
+{
+	Array< uint8_t > data;
+	int ret = GoToFirstFile( pack );
+	for ( ; ret == UNZ_OK; ret = unzGoToNextFile( pack ) )
+	{
+		char name[1024];
+		unz_file_info info;
+		int method = 0;
+		int level = 0;
+		if ( unzGetCurrentFileInfo( pack, &info, name, sizeof( name ), NULL, 0, NULL, 0 ) != UNZ_OK ||
+				unzOpenCurrentFile2( pack, &method, &level, 1 /* raw */ ) != UNZ_OK )
+		{
+			return false;
+		}
+		data.Resize( info.compressed_size );
+		const int readRet = ( info.compressed_size > 0 ) ? unzReadCurrentFile( pack, data.GetDataPtr(), info.compressed_size ) : 0;
+		unzCloseCurrentFile( pack );
+		if ( readRet != (int)info.compressed_size ||
+				!WriteFile( name, data.GetDataPtr(), info.compressed_size, method, info.crc, info.uncompressed_size ) )
+		{
+			return false;
+		}
+	}
+	return ret == UNZ_END_OF_LIST_OF_FILE;
+}
+
+void ovrPackWriter::Compress( ovrPackEntry & entry ) const
+{
+	const size_t length = entry.Data.GetSize();
+	entry.Crc = (uint32_t)unzCrc32( 0, (uint8_t const *)entry.Data, length );
+	if ( entry.Method != Z_DEFLATED || length == 0 )
+	{
+		entry.Method = 0;
+		return;
+	}
+
+	z_stream stream;
+	memset( &stream, 0, sizeof( stream ) );
+	if ( deflateInit2( &stream, CompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+	{
+		entry.Method = 0;
+		return;
+	}
+	entry.Compressed.Realloc( deflateBound( &stream, (uLong)length ) );
+	stream.next_in = (Bytef *)(uint8_t *)entry.Data;
+	stream.avail_in = (uInt)length;
+	stream.next_out = (Bytef *)(uint8_t *)entry.Compressed;
+	stream.avail_out = (uInt)entry.Compressed.GetSize();
+	const int ret = deflate( &stream, Z_FINISH );
+	entry.CompressedLength = stream.total_out;
+	deflateEnd( &stream );
+
+	// Data that does not get smaller is stored.
+	if ( ret != Z_STREAM_END || entry.CompressedLength >= length )
+	{
+		entry.Method = 0;
+	}
+}
+
+// Writes the files that are compressed, in the order they were added. If waitForAll is set,
+// or too much is pending, this waits for the oldest file and helps compress the others.
+bool ovrPackWriter::WriteFinished( const bool waitForAll )
+{
+	for ( ; ; )
+	{
+		ovrPackEntry * write = NULL;
+		ovrPackEntry * compress = NULL;
+		{
+			Mutex::Locker locker( &QueueMutex );
+			if ( NextWrite >= Queue.GetSizeI() )
+			{
+				return !Failed;
+			}
+			if ( Queue[NextWrite]->Done )
+			{
+				write = Queue[NextWrite++];
+				PendingBytes -= write->Data.GetSize();
+				if ( NextWrite == Queue.GetSizeI() || NextWrite >= 1024 )
+				{
+					Queue.RemoveMultipleAt( 0, NextWrite );
+					NextCompress -= NextWrite;
+					NextWrite = 0;
+				}
+			}
+			else if ( !waitForAll && PendingBytes <= MAX_PENDING_BYTES )
+			{
+				return !Failed;
+			}
+			else if ( NextCompress < Queue.GetSizeI() )
+			{
+				compress = Queue[NextCompress++];
+			}
+			else
+			{
+				DoneWake.Wait( &QueueMutex );
+			}
+		}
+
+		if ( compress != NULL )
+		{
+			Compress( *compress );
+			Mutex::Locker locker( &QueueMutex );
+			compress->Done = true;
+			DoneWake.NotifyAll();
+		}
+		if ( write != NULL )
+		{
+			if ( !Failed )
+			{
+				const bool stored = write->Method == 0;
+				Failed = !WriteFile( write->Name.ToCStr(),
+									stored ? (uint8_t const *)write->Data : (uint8_t const *)write->Compressed,
+									stored ? write->Data.GetSize() : write->CompressedLength,
+									write->Method, write->Crc, write->Data.GetSize() );
+			}
+			delete write;
+		}
+	}
+}
+
+bool ovrPackWriter::WriteFile( char const * name, uint8_t const * data, const size_t length,
+		const int method, const uint32_t crc, const size_t uncompressedLength )
+{
+	const size_t nameLength = strlen( name );
+	const int64_t headerOffset = TellFile( File );
+	if ( headerOffset < 0 ||
+			(uint64_t)headerOffset + LOCAL_HEADER_SIZE + nameLength + ALIGNMENT_EXTRA_SIZE + PAGE_ALIGNMENT + length >= MAX_PACK_LENGTH )
+	{
+		OVR_WARN( "ovrPackWriter: %s does not fit in %s", name, Path.ToCStr() );
+		return false;
+	}
+
+	// Stored data is aligned by padding the local header with an extra field, like zipalign.
+	uint8_t extra[ALIGNMENT_EXTRA_SIZE + PAGE_ALIGNMENT];
+	size_t extraLength = 0;
+	if ( method == 0 )
+	{
+		const size_t alignment = ( length >= PAGE_ALIGNED_LENGTH ) ? PAGE_ALIGNMENT : STORED_ALIGNMENT;
+		const size_t dataOffset = (size_t)headerOffset + LOCAL_HEADER_SIZE + nameLength;
+		if ( dataOffset % alignment != 0 )
+		{
+			const size_t padding = ( alignment - ( dataOffset + ALIGNMENT_EXTRA_SIZE ) % alignment ) % alignment;
+			extraLength = ALIGNMENT_EXTRA_SIZE + padding;
+			memset( extra, 0, extraLength );
+			WriteLE16( extra + 0, ALIGNMENT_EXTRA_ID );
+			WriteLE16( extra + 2, (uint32_t)( extraLength - 4 ) );
+			WriteLE16( extra + 4, (uint32_t)alignment );
+		}
+	}
+
+	zip_fileinfo info;
+	memset( &info, 0, sizeof( info ) );
+	info.dosDate = DosDate;
+	if ( zipOpenNewFileInZip2( Zip, name, &info, extraLength > 0 ? extra : NULL, (uInt)extraLength, NULL, 0, NULL,
+			method, method == 0 ? 0 : CompressionLevel, 1 /* raw */ ) != ZIP_OK )
+	{
+		return false;
+	}
+	const bool written = length == 0 || zipWriteInFileInZip( Zip, data, (unsigned)length ) == ZIP_OK;
+	return zipCloseFileInZipRaw( Zip, (uLong)uncompressedLength, crc ) == ZIP_OK && written;
+}
+
+threadReturn_t ovrPackWriter::ThreadFn( Thread * thread, void * data )
+{
+	ovrPackWriter * writer = static_cast< ovrPackWriter * >( data );
+
+	thread->SetThreadName( "PackWriter" );
+
+	for ( ; ; )
+	{
+		ovrPackEntry * entry = NULL;
+		{
+			Mutex::Locker locker( &writer->QueueMutex );
+			while ( !writer->Exiting && writer->NextCompress >= writer->Queue.GetSizeI() )
+			{
+				writer->QueueWake.Wait( &writer->QueueMutex );
+			}
+			if ( writer->Exiting )
+			{
+				return (threadReturn_t)0;
+			}
+			entry = writer->Queue[writer->NextCompress++];
+		}
+		writer->Compress( *entry );
+		{
+			Mutex::Locker locker( &writer->QueueMutex );
+			entry->Done = true;
+			writer->DoneWake.NotifyAll();
+		}
+	}
+}
+
+void * ovrPackWriter::OpenCallback( void * opaque, const void * fileName, int mode )
+{
+	ovrPackWriter * writer = static_cast< ovrPackWriter * >( opaque );
+	zlib_filefunc64_def fileFuncs;
+	fill_fopen64_filefunc( &fileFuncs );
+	writer->File = (FILE *)fileFuncs.zopen64_file( NULL, fileName, mode );
+	return writer->File;
+}
+
+int ovrPackWriter::CloseCallback( void * opaque, void * stream )
+{
+	ovrPackWriter * writer = static_cast< ovrPackWriter * >( opaque );
+	FILE * file = (FILE *)stream;
+	const bool synced = !writer->SyncOnClose || SyncFile( file );
+	writer->File = NULL;
+	return ( fclose( file ) == 0 && synced ) ? 0 : EOF;
+}
+
+} // namespace OVR
@@ -0,0 +1,637 @@
+/************************************************************************************
+
+Filename    :   OVR_Profiler.cpp
+Content     :   Records nested timing zones, counters and frame markers per thread.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "OVR_Profiler.h"
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Hash.h"
+#include "Kernel/OVR_LogUtils.h"
+#include "Kernel/OVR_Threads.h"
+#include "Console.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( OVR_OS_ANDROID ) || defined( OVR_OS_LINUX )
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace OVR {
+
+static const char		CAPTURE_MAGIC[8] = { 'O', 'V', 'R', 'P', 'R', 'O', 'F', 0 };
+static const uint32_t	CAPTURE_VERSION = 1;
+static const char *		DEFAULT_CAPTURE_PATH = "/sdcard/oculus_profile.json";
+
+std::atomic< bool >				ovrProfiler::Recording( false );
+thread_local ovrProfileRing *	ovrProfiler::ThreadRing = nullptr;
+
+// Never destroyed so threads can still record during process exit.
+static Mutex & RingsMutex()
+{
+	static Mutex * mutex = new Mutex();
+	return *mutex;
+}
+
+// Rings are never freed, so the events of threads that have exited can still be captured.
+static ovrProfileRing *		Rings[ovrProfiler::MAX_THREADS];
+static int					NumRings = 0;
+static int					EventsPerThread = ovrProfiler::DEFAULT_EVENTS_PER_THREAD;
+static std::atomic< uint64_t >	StartTicks( 0 );
+// set by SetThreadName(), which may be called before the thread has a ring
+static thread_local char		ThreadName[32];
+
+static int GetSystemThreadId()
+{
+#if defined( OVR_OS_ANDROID )
+	return gettid();
+#elif defined( OVR_OS_LINUX )
+	return (int)syscall( SYS_gettid );
+#else
+	static std::atomic< int > nextId( 1 );
+	static thread_local int id = nextId.fetch_add( 1 );
+	return id;
+#endif
+}
+
+uint64_t ovrProfiler::GetTicksPerSecond()
+{
+#if defined( __aarch64__ )
+	uint64_t frequency;
+	__asm__ volatile( "mrs %0, cntfrq_el0" : "=r"( frequency ) );
+	return frequency;
+#else
+	return 1000000000ull;
+#endif
+}
+
+void ovrProfiler::Start( const int eventsPerThread )
+{
+	{
+		Mutex::Locker locker( &RingsMutex() );
+		int size = 1;
+		while ( size < eventsPerThread )
+		{
+			size <<= 1;
+		}
+		EventsPerThread = size;
+	}
+	StartTicks.store( GetTicks(), std::memory_order_relaxed );
+	Recording.store( true, std::memory_order_release );
+	OVR_LOG( "ovrProfiler: recording" );
+}
+
+void ovrProfiler::Stop()
+{
+	Recording.store( false, std::memory_order_release );
+	OVR_LOG( "ovrProfiler: stopped" );
+}
+
+ovrProfileRing * ovrProfiler::CreateThreadRing()
+{
+	Mutex::Locker locker( &RingsMutex() );
+	if ( NumRings >= MAX_THREADS )
+	{
+		return nullptr;
+	}
+	ovrProfileRing * ring = new ovrProfileRing();
+	ring->Begun.store( 0, std::memory_order_relaxed );
+	ring->Head.store( 0, std::memory_order_relaxed );
+	ring->Mask = EventsPerThread - 1;
+	ring->Events = new ovrProfileEvent[EventsPerThread];
+	ring->ThreadId = GetSystemThreadId();
+	OVR_strcpy( ring->ThreadName, sizeof( ring->ThreadName ), ThreadName );
+#if defined( OVR_OS_ANDROID ) || defined( OVR_OS_LINUX )
+	char name[17] = {};	// prctl names are at most 16 characters
+	if ( ring->ThreadName[0] == '\0' && prctl( PR_GET_NAME, name, 0, 0, 0 ) == 0 )
+	{
+		OVR_strcpy( ring->ThreadName, sizeof( ring->ThreadName ), name );
+	}
+#endif
+	Rings[NumRings++] = ring;
+	ThreadRing = ring;
+	return ring;
+}
+
+void ovrProfiler::SetThreadName( const char * name )
+{
+	OVR_strcpy( ThreadName, sizeof( ThreadName ), name );
+	if ( ThreadRing != nullptr )
+	{
+		OVR_strcpy( ThreadRing->ThreadName, sizeof( ThreadRing->ThreadName ), name );
+	}
+}
+
+//==============================================================
+// ovrProfileCapture
+struct ovrProfileThreadCapture
+{
+	int							ThreadId;
+	char						ThreadName[32];
+	Array< ovrProfileEvent >	Events;
+};
+
+struct ovrProfileCapture
+{
+	uint64_t						TicksPerSecond;
+	Array< ovrProfileThreadCapture >	Threads;
+	Array< char >					Names;	// the text of the names of a capture read from a file
+};
+
+static void CaptureRings( const int maxFrames, ovrProfileCapture & capture )
+{
+	capture.TicksPerSecond = ovrProfiler::GetTicksPerSecond();
+
+	ovrProfileRing * rings[ovrProfiler::MAX_THREADS];
+	int numRings = 0;
+	{
+		Mutex::Locker locker( &RingsMutex() );
+		numRings = NumRings;
+		memcpy( rings, Rings, numRings * sizeof( rings[0] ) );
+	}
+
+	const uint64_t startTicks = StartTicks.load( std::memory_order_relaxed );
+	Array< ovrProfileEvent > copied;
+	for ( int i = 0; i < numRings; i++ )
+	{
+		ovrProfileRing * ring = rings[i];
+		const uint64_t size = ring->Mask + 1;
+		const uint64_t head = ring->Head.load( std::memory_order_acquire );
+		const uint64_t first = ( head > size ) ? head - size : 0;
+		copied.Resize( (int)( head - first ) );
+		for ( uint64_t e = first; e < head; e++ )
+		{
+			copied[(int)( e - first )] = ring->Events[e & ring->Mask];
+		}
+		// Events that the thread started to write after the copy began overwrote the oldest ones.
+		std::atomic_thread_fence( std::memory_order_acquire );
+		const uint64_t begun = ring->Begun.load( std::memory_order_relaxed );
+		const uint64_t firstValid = Alg::Max( first, ( begun > size ) ? begun - size : 0 );
+
+		ovrProfileThreadCapture & thread = capture.Threads.PushDefault();
+		thread.ThreadId = ring->ThreadId;
+		OVR_strcpy( thread.ThreadName, sizeof( thread.ThreadName ), ring->ThreadName );
+		thread.Events.Reserve( (int)( head - firstValid ) );
+		for ( uint64_t e = firstValid; e < head; e++ )
+		{
+			const ovrProfileEvent & event = copied[(int)( e - first )];
+			if ( event.Ticks >= startTicks )
+			{
+				thread.Events.PushBack( event );
+			}
+		}
+	}
+
+	if ( maxFrames <= 0 )
+	{
+		return;
+	}
+
+	// drop the events before the oldest of the last maxFrames frames
+	Array< uint64_t > frameTicks;
+	for ( int i = 0; i < capture.Threads.GetSizeI(); i++ )
+	{
+		const Array< ovrProfileEvent > & events = capture.Threads[i].Events;
+		for ( int e = 0; e < events.GetSizeI(); e++ )
+		{
+			if ( events[e].Type == PROFILE_EVENT_FRAME )
+			{
+				frameTicks.PushBack( events[e].Ticks );
+			}
+		}
+	}
+	if ( frameTicks.GetSizeI() <= maxFrames )
+	{
+		return;
+	}
+	Alg::QuickSort( frameTicks );
+	const uint64_t firstTicks = frameTicks[frameTicks.GetSizeI() - maxFrames];
+	for ( int i = 0; i < capture.Threads.GetSizeI(); i++ )
+	{
+		Array< ovrProfileEvent > & events = capture.Threads[i].Events;
+		int first = 0;
+		while ( first < events.GetSizeI() && events[first].Ticks < firstTicks )
+		{
+			first++;
+		}
+		events.RemoveMultipleAt( 0, first );
+	}
+}
+
+static void WriteJsonString( FILE * f, const char * s )
+{
+	fputc( '"', f );
+	for ( ; *s != '\0'; s++ )
+	{
+		if ( *s == '"' || *s == '\\' )
+		{
+			fputc( '\\', f );
+			fputc( *s, f );
+		}
+		else if ( (unsigned char)*s >= 0x20 )
+		{
+			fputc( *s, f );
+		}
+	}
+	fputc( '"', f );
+}
+
+static bool WriteChromeTraceFile( const ovrProfileCapture & capture, const char * path )
+{
+	FILE * f = fopen( path, "wb" );
+	if ( f == NULL )
+	{
+		OVR_WARN( "ovrProfiler: failed to open %s", path );
+		return false;
+	}
+
+	uint64_t firstTicks = UINT64_MAX;
+	for ( int i = 0; i < capture.Threads.GetSizeI(); i++ )
+	{
+		if ( capture.Threads[i].Events.GetSizeI() > 0 )
+		{
+			firstTicks = Alg::Min( firstTicks, capture.Threads[i].Events[0].Ticks );
+		}
+	}
+	const double microsecondsPerTick = 1e6 / (double)capture.TicksPerSecond;
+
+	fprintf( f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+	bool firstEvent = true;
+	auto beginEvent = [&]( const char * name, const char * phase, const int tid, const uint64_t ticks )
+	{
+		fprintf( f, firstEvent ? "{\"name\":" : ",\n{\"name\":" );
+		firstEvent = false;
+		WriteJsonString( f, name );
+		fprintf( f, ",\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", phase, tid, ( ticks - firstTicks ) * microsecondsPerTick );
+	};
+
+	for ( int i = 0; i < capture.Threads.GetSizeI(); i++ )
+	{
+		const ovrProfileThreadCapture & thread = capture.Threads[i];
+		if ( thread.Events.GetSizeI() == 0 )
+		{
+			continue;
+		}
+		const int tid = thread.ThreadId;
+
+		fprintf( f, firstEvent ? "{" : ",\n{" );
+		firstEvent = false;
+		fprintf( f, "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", tid );
+		WriteJsonString( f, thread.ThreadName[0] != '\0' ? thread.ThreadName : "thread" );
+		fprintf( f, "}}" );
+
+		// The oldest events of a full ring may end zones that began before it, and the
+		// newest may begin zones that have not ended yet, so only matched pairs are written.
+		Array< const char * > open;
+		for ( int e = 0; e < thread.Events.GetSizeI(); e++ )
+		{
+			const ovrProfileEvent & event = thread.Events[e];
+			switch ( event.Type )
+			{
+				case PROFILE_EVENT_ZONE_BEGIN:
+					beginEvent( event.Name, "B", tid, event.Ticks );
+					fprintf( f, "}" );
+					open.PushBack( event.Name );
+					break;
+				case PROFILE_EVENT_ZONE_END:
+					if ( open.GetSizeI() == 0 )
+					{
+						break;
+					}
+					beginEvent( open.Back(), "E", tid, event.Ticks );
+					fprintf( f, "}" );
+					open.PopBack();
+					break;
+				case PROFILE_EVENT_COUNTER:
+					beginEvent( event.Name, "C", tid, event.Ticks );
+					fprintf( f, ",\"args\":{\"value\":%.17g}}", event.Value );
+					break;
+				case PROFILE_EVENT_FRAME:
+				{
+					char name[64];
+					OVR_sprintf( name, sizeof( name ), "%s %lld", event.Name, (long long)event.Value );
+					beginEvent( name, "i", tid, event.Ticks );
+					fprintf( f, ",\"s\":\"g\"}" );
+					break;
+				}
+				default:
+					break;
+			}
+		}
+		const uint64_t lastTicks = thread.Events.Back().Ticks;
+		while ( open.GetSizeI() > 0 )
+		{
+			beginEvent( open.Back(), "E", tid, lastTicks );
+			fprintf( f, "}" );
+			open.PopBack();
+		}
+	}
+	fprintf( f, "\n]}\n" );
+
+	const bool ok = ( ferror( f ) == 0 );
+	fclose( f );
+	return ok;
+}
+
+//==============================================================
+// Binary capture
+// The header is followed by the names and then each thread's events. Every event is a
+// type byte, the index of its name and the ticks since the thread's previous event as
+// variable length integers, and the value for counters and frame markers.
+struct ovrCaptureHeader
+{
+	char		Magic[8];
+	uint32_t	Version;
+	uint32_t	NumNames;
+	uint32_t	NumThreads;
+	uint32_t	Pad;
+	uint64_t	TicksPerSecond;
+};
+
+static void PutVarInt( Array< uint8_t > & out, uint64_t v )
+{
+	while ( v >= 0x80 )
+	{
+		out.PushBack( (uint8_t)( v | 0x80 ) );
+		v >>= 7;
+	}
+	out.PushBack( (uint8_t)v );
+}
+
+static void PutBytes( Array< uint8_t > & out, const void * data, const size_t size )
+{
+	const int offset = out.GetSizeI();
+	out.Resize( offset + (int)size );
+	memcpy( &out[offset], data, size );
+}
+
+static bool GetVarInt( const uint8_t *& p, const uint8_t * end, uint64_t & v )
+{
+	v = 0;
+	for ( int shift = 0; p < end && shift < 64; shift += 7 )
+	{
+		const uint8_t b = *p++;
+		v |= (uint64_t)( b & 0x7F ) << shift;
+		if ( ( b & 0x80 ) == 0 )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool GetBytes( const uint8_t *& p, const uint8_t * end, void * data, const size_t size )
+{
+	if ( (size_t)( end - p ) < size )
+	{
+		return false;
+	}
+	memcpy( data, p, size );
+	p += size;
+	return true;
+}
+
+static bool WriteCaptureFile( const ovrProfileCapture & capture, const char * path )
+{
+	Hash< const char *, int > nameIndices;
+	Array< const char * > names;
+	Array< uint8_t > events;
+	for ( int i = 0; i < capture.Threads.GetSizeI(); i++ )
+	{
+		const ovrProfileThreadCapture & thread = capture.Threads[i];
+		const int32_t threadId = thread.ThreadId;
+		const uint32_t numEvents = thread.Events.GetSizeI();
+		PutBytes( events, &threadId, sizeof( threadId ) );
+		PutBytes( events, thread.ThreadName, sizeof( thread.ThreadName ) );
+		PutBytes( events, &numEvents, sizeof( numEvents ) );
+
+		uint64_t lastTicks = 0;
+		for ( int e = 0; e < thread.Events.GetSizeI(); e++ )
+		{
+			const ovrProfileEvent & event = thread.Events[e];
+			int nameIndex;
+			if ( !nameIndices.Get( event.Name, &nameIndex ) )
+			{
+				nameIndex = names.GetSizeI();
+				nameIndices.Add( event.Name, nameIndex );
+				names.PushBack( event.Name );
+			}
+			events.PushBack( (uint8_t)event.Type );
+			PutVarInt( events, nameIndex );
+			PutVarInt( events, event.Ticks - lastTicks );
+			lastTicks = event.Ticks;
+			if ( event.Type == PROFILE_EVENT_COUNTER || event.Type == PROFILE_EVENT_FRAME )
+			{
+				PutBytes( events, &event.Value, sizeof( event.Value ) );
+			}
+		}
+	}
+
+	ovrCaptureHeader header;
+	memcpy( header.Magic, CAPTURE_MAGIC, sizeof( header.Magic ) );
+	header.Version = CAPTURE_VERSION;
+	header.NumNames = names.GetSizeI();
+	header.NumThreads = capture.Threads.GetSizeI();
+	header.Pad = 0;
+	header.TicksPerSecond = capture.TicksPerSecond;
+
+	Array< uint8_t > out;
+	PutBytes( out, &header, sizeof( header ) );
+	for ( int i = 0; i < names.GetSizeI(); i++ )
+	{
+		const size_t length = strlen( names[i] );
+		PutVarInt( out, length );
+		PutBytes( out, names[i], length );
+	}
+
+	FILE * f = fopen( path, "wb" );
+	if ( f == NULL )
+	{
+		OVR_WARN( "ovrProfiler: failed to open %s", path );
+		return false;
+	}
+	bool ok = fwrite( out.GetDataPtr(), 1, out.GetSize(), f ) == out.GetSize();
+	ok = ok && ( events.GetSize() == 0 || fwrite( events.GetDataPtr(), 1, events.GetSize(), f ) == events.GetSize() );
+	fclose( f );
+	return ok;
+}
+
+static bool ReadCaptureFile( const char * path, ovrProfileCapture & capture )
+{
+	FILE * f = fopen( path, "rb" );
+	if ( f == NULL )
+	{
+		OVR_WARN( "ovrProfiler: failed to open %s", path );
+		return false;
+	}
+	fseek( f, 0, SEEK_END );
+	const long fileSize = ftell( f );
+	fseek( f, 0, SEEK_SET );
+	Array< uint8_t > data;
+	data.Resize( fileSize > 0 ? fileSize : 0 );
+	const bool readOk = fileSize > 0 && fread( data.GetDataPtr(), 1, fileSize, f ) == (size_t)fileSize;
+	fclose( f );
+	if ( !readOk )
+	{
+		return false;
+	}
+
+	const uint8_t * p = data.GetDataPtr();
+	const uint8_t * end = p + data.GetSize();
+	ovrCaptureHeader header;
+	if ( !GetBytes( p, end, &header, sizeof( header ) ) ||
+			memcmp( header.Magic, CAPTURE_MAGIC, sizeof( header.Magic ) ) != 0 || header.Version != CAPTURE_VERSION )
+	{
+		OVR_WARN( "ovrProfiler: %s is not a capture", path );
+		return false;
+	}
+	capture.TicksPerSecond = header.TicksPerSecond;
+
+	// the name pointers are set once all the text is in place
+	Array< int > nameOffsets;
+	for ( uint32_t i = 0; i < header.NumNames; i++ )
+	{
+		uint64_t length;
+		if ( !GetVarInt( p, end, length ) || (uint64_t)( end - p ) < length )
+		{
+			return false;
+		}
+		nameOffsets.PushBack( capture.Names.GetSizeI() );
+		for ( uint64_t c = 0; c < length; c++ )
+		{
+			capture.Names.PushBack( (char)*p++ );
+		}
+		capture.Names.PushBack( '\0' );
+	}
+
+	for ( uint32_t i = 0; i < header.NumThreads; i++ )
+	{
+		ovrProfileThreadCapture & thread = capture.Threads.PushDefault();
+		int32_t threadId;
+		uint32_t numEvents;
+		if ( !GetBytes( p, end, &threadId, sizeof( threadId ) ) ||
+				!GetBytes( p, end, thread.ThreadName, sizeof( thread.ThreadName ) ) ||
+				!GetBytes( p, end, &numEvents, sizeof( numEvents ) ) )
+		{
+			return false;
+		}
+		thread.ThreadId = threadId;
+		thread.ThreadName[sizeof( thread.ThreadName ) - 1] = '\0';
+		thread.Events.Resize( numEvents );
+
+		uint64_t ticks = 0;
+		for ( uint32_t e = 0; e < numEvents; e++ )
+		{
+			ovrProfileEvent & event = thread.Events[e];
+			uint64_t nameIndex;
+			uint64_t deltaTicks;
+			if ( p >= end )
+			{
+				return false;
+			}
+			event.Type = *p++;
+			if ( !GetVarInt( p, end, nameIndex ) || nameIndex >= header.NumNames || !GetVarInt( p, end, deltaTicks ) )
+			{
+				return false;
+			}
+			ticks += deltaTicks;
+			event.Ticks = ticks;
+			event.Name = (const char *)(uintptr_t)nameIndex;
+			event.Value = 0.0;
+			if ( event.Type == PROFILE_EVENT_COUNTER || event.Type == PROFILE_EVENT_FRAME )
+			{
+				if ( !GetBytes( p, end, &event.Value, sizeof( event.Value ) ) )
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	for ( int i = 0; i < capture.Threads.GetSizeI(); i++ )
+	{
+		Array< ovrProfileEvent > & events = capture.Threads[i].Events;
+		for ( int e = 0; e < events.GetSizeI(); e++ )
+		{
+			events[e].Name = &capture.Names[nameOffsets[(int)(uintptr_t)events[e].Name]];
+		}
+	}
+	return true;
+}
+
+bool ovrProfiler::WriteChromeTrace( const char * path, const int maxFrames )
+{
+	ovrProfileCapture capture;
+	CaptureRings( maxFrames, capture );
+	return WriteChromeTraceFile( capture, path );
+}
+
+bool ovrProfiler::WriteCapture( const char * path, const int maxFrames )
+{
+	ovrProfileCapture capture;
+	CaptureRings( maxFrames, capture );
+	return WriteCaptureFile( capture, path );
+}
+
+bool ovrProfiler::ConvertCaptureToChromeTrace( const char * capturePath, const char * tracePath )
+{
+	ovrProfileCapture capture;
+	if ( !ReadCaptureFile( capturePath, capture ) )
+	{
+		OVR_WARN( "ovrProfiler: failed to read %s", capturePath );
+		return false;
+	}
+	return WriteChromeTraceFile( capture, tracePath );
+}
+
+//==============================================================
+// console functions
+
+static void ProfileStart( void * appPtr, const char * cmd )
+{
+	OVR_UNUSED( appPtr );
+	const int eventsPerThread = atoi( cmd );
+	ovrProfiler::Start( eventsPerThread > 0 ? eventsPerThread : ovrProfiler::DEFAULT_EVENTS_PER_THREAD );
+}
+
+static void ProfileStop( void * appPtr, const char * cmd )
+{
+	OVR_UNUSED( appPtr );
+	OVR_UNUSED( cmd );
+	ovrProfiler::Stop();
+}
+
+static void ProfileWrite( void * appPtr, const char * cmd )
+{
+	OVR_UNUSED( appPtr );
+	char path[512];
+	int maxFrames = 0;
+	if ( sscanf( cmd, "%511s %d", path, &maxFrames ) < 1 )
+	{
+		OVR_strcpy( path, sizeof( path ), DEFAULT_CAPTURE_PATH );
+	}
+	const size_t length = strlen( path );
+	const bool json = length >= 5 && OVR_stricmp( path + length - 5, ".json" ) == 0;
+	const bool ok = json ? ovrProfiler::WriteChromeTrace( path, maxFrames ) : ovrProfiler::WriteCapture( path, maxFrames );
+	OVR_LOG( "ovrProfiler: %s %s", ok ? "wrote" : "failed to write", path );
+}
+
+void ovrProfiler::RegisterConsoleFunctions()
+{
+	RegisterConsoleFunction( "profileStart", ProfileStart );
+	RegisterConsoleFunction( "profileStop", ProfileStop );
+	RegisterConsoleFunction( "profileWrite", ProfileWrite );
+}
+
+} // namespace OVR
@@ -0,0 +1,671 @@
+/************************************************************************************
+
+Filename    :   OVR_ReadService.cpp
+Content     :   Reads files on worker threads, in priority order.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "OVR_ReadService.h"
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_LogUtils.h"
+#include "Kernel/OVR_MappedFile.h"
+#include "OVR_FileSys.h"
+
+#if !defined( OVR_OS_WIN32 )
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace OVR {
+
+//==============================================================
+// Reads at an offset without a shared file position, so that several threads can read the
+// same file at once.
+
+#if defined( OVR_OS_WIN32 )
+
+static intptr_t OpenForReading( char const * path )
+{
+	HANDLE handle = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	return ( handle == INVALID_HANDLE_VALUE ) ? -1 : (intptr_t)handle;
+}
+
+static void CloseForReading( intptr_t handle )
+{
+	CloseHandle( (HANDLE)handle );
+}
+
+static bool ReadAt( intptr_t handle, const size_t offset, void * buffer, const size_t length )
+{
+	OVERLAPPED overlapped = {};
+	overlapped.Offset = (DWORD)offset;
+	overlapped.OffsetHigh = (DWORD)( (uint64_t)offset >> 32 );
+	DWORD numRead = 0;
+	return ReadFile( (HANDLE)handle, buffer, (DWORD)length, &numRead, &overlapped ) && numRead == length;
+}
+
+#else
+
+static intptr_t OpenForReading( char const * path )
+{
+	return open( path, O_RDONLY );
+}
+
+static void CloseForReading( intptr_t handle )
+{
+	close( (int)handle );
+}
+
+static bool ReadAt( intptr_t handle, const size_t offset, void * buffer, const size_t length )
+{
+	for ( size_t done = 0; done < length; )
+	{
+		const ssize_t numRead = pread( (int)handle, (uint8_t *)buffer + done, length - done, (off_t)( offset + done ) );
+		if ( numRead < 0 && errno == EINTR )
+		{
+			continue;
+		}
+		if ( numRead <= 0 )
+		{
+			return false;	// past the end of the file, or an error
+		}
+		done += numRead;
+	}
+	return true;
+}
+
+#endif
+
+//==============================================================
+// ovrReadRequest::ovrReadFile
+struct ovrReadRequest::ovrReadFile
+{
+	String			Path;
+	intptr_t		Handle;			// -1 until the first read
+	MappedFile *	Mapping;		// NULL until the first map
+	int				NumRequests;	// queued for or being read from the file
+};
+
+//==============================================================================================
+// ovrReadRequest
+//==============================================================================================
+
+ovrReadRequest::ovrReadRequest()
+	: Service( NULL )
+	, RefCount( 2 )		// one for the caller and one for the service
+	, Status( OVR_READ_PENDING )
+	, File( NULL )
+	, Offset( 0 )
+	, Length( 0 )
+	, Map( false )
+	, Priority( OVR_READ_PRIORITY_NORMAL )
+	, Queued( false )
+	, Canceled( false )
+	, Finished( false )
+	, Callback( NULL )
+	, UserData( NULL )
+	, Block( NULL )
+	, Data( NULL )
+{
+}
+
+ovrReadRequest::~ovrReadRequest()
+{
+	ReleaseBlock( Block );
+}
+
+void ovrReadRequest::ReleaseBlock( ovrReadBlock * block )
+{
+	if ( block != NULL && block->RefCount.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+	{
+		delete block->View;
+		delete block;
+	}
+}
+
+void ovrReadRequest::Release()
+{
+	if ( RefCount.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+	{
+		delete this;
+	}
+}
+
+bool ovrReadRequest::IsMapped() const
+{
+	return Block != NULL && Block->View != NULL;
+}
+
+ovrReadStatus ovrReadRequest::Wait()
+{
+	Mutex::Locker locker( &Service->QueueMutex );
+	if ( Queued && Priority != OVR_READ_PRIORITY_URGENT )
+	{
+		Service->Unqueue( this );
+		Priority = OVR_READ_PRIORITY_URGENT;
+		Service->Queue[Priority].PushBack( this );
+		Queued = true;
+	}
+	while ( !Finished )
+	{
+		Service->FinishedWake.Wait( &Service->QueueMutex );
+	}
+	return GetStatus();
+}
+
+//==============================================================================================
+// ovrReadService
+//==============================================================================================
+
+ovrReadService::ovrReadService()
+	: FileSys( NULL )
+	, Exiting( false )
+	, NumFileReads( 0 )
+{
+}
+
+ovrReadService::~ovrReadService()
+{
+	OVR_ASSERT( Threads.GetSizeI() == 0 );	// Shutdown() must be called
+}
+
+void ovrReadService::Init( ovrFileSys * fileSys, const int numThreads )
+{
+	OVR_ASSERT( Threads.GetSizeI() == 0 );
+
+	FileSys = fileSys;
+	Exiting = false;
+
+	for ( int i = 0; i < numThreads; i++ )
+	{
+		Thread::CreateParams createParams( ovrReadService::ThreadFn, this, 128 * 1024, -1,
+				Thread::Running, Thread::NormalPriority );
+		Threads.PushBack( new Thread( createParams ) );
+	}
+}
+
+void ovrReadService::Shutdown()
+{
+	{
+		Mutex::Locker locker( &QueueMutex );
+		Exiting = true;
+		QueueWake.NotifyAll();
+	}
+
+	for ( int i = 0; i < Threads.GetSizeI(); i++ )
+	{
+		Threads[i]->Join();
+		delete Threads[i];
+	}
+	Threads.Clear();
+
+	Mutex::Locker locker( &QueueMutex );
+	for ( int priority = 0; priority < OVR_READ_PRIORITY_MAX; priority++ )
+	{
+		while ( Queue[priority].GetSizeI() > 0 )
+		{
+			ovrReadRequest * request = Queue[priority].Back();
+			Unqueue( request );
+			if ( request->File != NULL )
+			{
+				request->File->NumRequests--;
+			}
+			request->Status.store( OVR_READ_CANCELED, std::memory_order_release );
+			request->Finished = true;
+			request->Release();
+		}
+	}
+	FinishedWake.NotifyAll();
+
+	for ( StringHash< ovrReadFile * >::Iterator it = Files.Begin(); it != Files.End(); ++it )
+	{
+		ovrReadFile * file = it->Second;
+		OVR_ASSERT( file->NumRequests == 0 );
+		if ( file->Handle != -1 )
+		{
+			CloseForReading( file->Handle );
+		}
+		delete file->Mapping;
+		delete file;
+	}
+	Files.Clear();
+}
+
+ovrReadRequest * ovrReadService::Read( char const * path, const size_t offset, const size_t length,
+		const ovrReadPriority priority, ovrReadCallback callback, void * userData )
+{
+	ovrReadRequest * request = new ovrReadRequest();
+	request->Offset = offset;
+	request->Length = length;
+	request->Callback = callback;
+	request->UserData = userData;
+
+	Mutex::Locker locker( &QueueMutex );
+	request->File = FindOrAddFile( path );
+	return Submit( request, priority );
+}
+
+ovrReadRequest * ovrReadService::Map( char const * path, const size_t offset, const size_t length,
+		const ovrReadPriority priority, ovrReadCallback callback, void * userData )
+{
+	ovrReadRequest * request = new ovrReadRequest();
+	request->Offset = offset;
+	request->Length = length;
+	request->Map = true;
+	request->Callback = callback;
+	request->UserData = userData;
+
+	Mutex::Locker locker( &QueueMutex );
+	request->File = FindOrAddFile( path );
+	return Submit( request, priority );
+}
+
+ovrReadRequest * ovrReadService::ReadUri( char const * uri, const ovrReadPriority priority,
+		ovrReadCallback callback, void * userData )
+{
+	OVR_ASSERT( FileSys != NULL );
+
+	ovrReadRequest * request = new ovrReadRequest();
+	request->Uri = uri;
+	request->Callback = callback;
+	request->UserData = userData;
+
+	Mutex::Locker locker( &QueueMutex );
+	return Submit( request, priority );
+}
+
+// QueueMutex must be held.
+ovrReadRequest * ovrReadService::Submit( ovrReadRequest * request, const ovrReadPriority priority )
+{
+	request->Service = this;
+	request->Priority = priority;
+	if ( Exiting )
+	{
+		request->Status.store( OVR_READ_CANCELED, std::memory_order_release );
+		request->Finished = true;
+		if ( request->File != NULL )
+		{
+			request->File->NumRequests--;
+		}
+		request->Release();
+		return request;
+	}
+	request->Queued = true;
+	Queue[priority].PushBack( request );
+	QueueWake.Notify();
+	return request;
+}
+
+bool ovrReadService::Cancel( ovrReadRequest * request )
+{
+	Mutex::Locker locker( &QueueMutex );
+	if ( request->Finished || request->GetStatus() != OVR_READ_PENDING )
+	{
+		return request->GetStatus() == OVR_READ_CANCELED;
+	}
+	if ( !request->Queued )
+	{
+		request->Canceled = true;	// ReadBatch() finishes it
+		return true;
+	}
+	Unqueue( request );
+	if ( request->File != NULL )
+	{
+		request->File->NumRequests--;
+	}
+	request->Status.store( OVR_READ_CANCELED, std::memory_order_release );
+	request->Finished = true;
+	FinishedWake.NotifyAll();
+	request->Release();
+	return true;
+}
+
+// QueueMutex must be held.
+ovrReadService::ovrReadFile * ovrReadService::FindOrAddFile( char const * path )
+{
+	ovrReadFile ** found = Files.Get( path );
+	ovrReadFile * file = NULL;
+	if ( found != NULL )
+	{
+		file = *found;
+	}
+	else
+	{
+		file = new ovrReadFile();
+		file->Path = path;
+		file->Handle = -1;
+		file->Mapping = NULL;
+		file->NumRequests = 0;
+		Files.Add( file->Path, file );
+	}
+	file->NumRequests++;
+	return file;
+}
+
+// Closes files that nothing is queued for, once there are more than MAX_IDLE_FILES of them.
+// QueueMutex must be held.
+void ovrReadService::CloseIdleFiles()
+{
+	int numIdle = 0;
+	for ( StringHash< ovrReadFile * >::Iterator it = Files.Begin(); it != Files.End(); ++it )
+	{
+		numIdle += ( it->Second->NumRequests == 0 );
+	}
+	if ( numIdle <= MAX_IDLE_FILES )
+	{
+		return;
+	}
+	for ( StringHash< ovrReadFile * >::Iterator it = Files.Begin(); it != Files.End(); ++it )
+	{
+		ovrReadFile * file = it->Second;
+		if ( file->NumRequests == 0 )
+		{
+			if ( file->Handle != -1 )
+			{
+				CloseForReading( file->Handle );
+			}
+			delete file->Mapping;
+			delete file;
+			it.Remove();
+		}
+	}
+}
+
+// QueueMutex must be held.
+void ovrReadService::Unqueue( ovrReadRequest * request )
+{
+	Array< ovrReadRequest * > & queue = Queue[request->Priority];
+	for ( int i = 0; i < queue.GetSizeI(); i++ )
+	{
+		if ( queue[i] == request )
+		{
+			queue.RemoveAt( i );
+			break;
+		}
+	}
+	request->Queued = false;
+}
+
+// QueueMutex must be held.
+ovrReadRequest * ovrReadService::PopNext()
+{
+	for ( int priority = 0; priority < OVR_READ_PRIORITY_MAX; priority++ )
+	{
+		if ( Queue[priority].GetSizeI() > 0 )
+		{
+			ovrReadRequest * request = Queue[priority][0];
+			Queue[priority].RemoveAt( 0 );
+			request->Queued = false;
+			return request;
+		}
+	}
+	return NULL;
+}
+
+// Takes the queued requests that can be read with the seed in one read, whatever their
+// priority. QueueMutex must be held.
+void ovrReadService::Gather( ovrReadRequest * seed, Array< ovrReadRequest * > & batch )
+{
+	batch.Clear();
+	batch.PushBack( seed );
+	if ( seed->Map || seed->Length >= MAX_COALESCED_LENGTH )
+	{
+		return;
+	}
+
+	size_t start = seed->Offset;
+	size_t end = seed->Offset + seed->Length;
+	for ( bool grew = true; grew; )
+	{
+		grew = false;
+		for ( int priority = 0; priority < OVR_READ_PRIORITY_MAX; priority++ )
+		{
+			Array< ovrReadRequest * > & queue = Queue[priority];
+			for ( int i = 0; i < queue.GetSizeI(); i++ )
+			{
+				ovrReadRequest * request = queue[i];
+				if ( request->File != seed->File || request->Map )
+				{
+					continue;
+				}
+				const size_t requestEnd = request->Offset + request->Length;
+				if ( request->Offset > end + MAX_COALESCE_GAP || requestEnd + MAX_COALESCE_GAP < start )
+				{
+					continue;
+				}
+				const size_t newStart = Alg::Min( start, request->Offset );
+				const size_t newEnd = Alg::Max( end, requestEnd );
+				if ( newEnd - newStart > MAX_COALESCED_LENGTH )
+				{
+					continue;
+				}
+				start = newStart;
+				end = newEnd;
+				queue.RemoveAt( i-- );
+				request->Queued = false;
+				batch.PushBack( request );
+				grew = true;
+			}
+		}
+	}
+}
+
+// Reads or maps the requests of a batch, which are all from the same file, and finishes them.
+void ovrReadService::ReadBatch( Array< ovrReadRequest * > & batch )
+{
+	ovrReadFile * file = batch[0]->File;
+	const bool map = batch[0]->Map;
+
+	size_t start = batch[0]->Offset;
+	size_t end = batch[0]->Offset + batch[0]->Length;
+	for ( int i = 1; i < batch.GetSizeI(); i++ )
+	{
+		start = Alg::Min( start, batch[i]->Offset );
+		end = Alg::Max( end, batch[i]->Offset + batch[i]->Length );
+	}
+
+	// Files are opened here, rather than when the first request is queued, so the caller
+	// doesn't wait on it. A file that is in use is not closed, so the handle stays valid
+	// once the mutex is released.
+	bool opened = false;
+	{
+		Mutex::Locker locker( &QueueMutex );
+		if ( map )
+		{
+			if ( file->Mapping == NULL )
+			{
+				file->Mapping = new MappedFile();
+				if ( !file->Mapping->OpenRead( file->Path.ToCStr(), false, false ) )
+				{
+					delete file->Mapping;
+					file->Mapping = NULL;
+				}
+			}
+			opened = ( file->Mapping != NULL );
+		}
+		else
+		{
+			if ( file->Handle == -1 )
+			{
+				file->Handle = OpenForReading( file->Path.ToCStr() );
+			}
+			opened = ( file->Handle != -1 );
+		}
+	}
+
+	ovrReadRequest::ovrReadBlock * block = NULL;
+	if ( opened )
+	{
+		block = new ovrReadRequest::ovrReadBlock();
+		block->RefCount.store( 1, std::memory_order_relaxed );	// released at the end of the batch
+		block->View = NULL;
+		if ( map )
+		{
+			block->View = new MappedView();
+			if ( end > file->Mapping->GetLength() || !block->View->Open( file->Mapping ) ||
+					block->View->MapView( start, (uint32_t)( end - start ) ) == NULL )
+			{
+				ovrReadRequest::ReleaseBlock( block );
+				block = NULL;
+			}
+		}
+		else
+		{
+			MemBufferT< uint8_t > memory( end - start );
+			block->Memory = memory;
+			if ( !ReadAt( file->Handle, start, block->Memory, end - start ) )
+			{
+				ovrReadRequest::ReleaseBlock( block );
+				block = NULL;
+			}
+		}
+		NumFileReads.fetch_add( 1, std::memory_order_relaxed );
+	}
+	if ( block == NULL )
+	{
+		OVR_WARN( "ovrReadService: failed to read %zu bytes at %zu from '%s'", end - start, start, file->Path.ToCStr() );
+	}
+
+	uint8_t const * data = NULL;
+	if ( block != NULL )
+	{
+		// MapView() maps from the allocation granularity before the offset.
+		data = map ? block->View->GetFront() + ( start - block->View->GetOffset() ) : (uint8_t const *)block->Memory;
+	}
+	for ( int i = 0; i < batch.GetSizeI(); i++ )
+	{
+		ovrReadRequest * request = batch[i];
+		Finish( request, block, ( data != NULL ) ? data + ( request->Offset - start ) : NULL, request->Length );
+	}
+	ovrReadRequest::ReleaseBlock( block );
+
+	Mutex::Locker locker( &QueueMutex );
+	file->NumRequests -= batch.GetSizeI();
+	CloseIdleFiles();
+}
+
+// Turns a ReadUri() request into a read of a range of a file, or reads it through the file
+// system if its data is not stored as is in a local file.
+void ovrReadService::ResolveUri( ovrReadRequest * request )
+{
+	String path;
+	size_t offset = 0;
+	size_t length = 0;
+	bool map = false;
+	if ( FileSys->GetLocalRangeForURI( request->Uri.ToCStr(), path, offset, length, map ) && length > 0 )
+	{
+		Mutex::Locker locker( &QueueMutex );
+		request->File = FindOrAddFile( path.ToCStr() );
+		request->Offset = offset;
+		request->Length = length;
+		request->Map = map;
+		request->Uri.Clear();
+		if ( request->Canceled )
+		{
+			request->File->NumRequests--;
+			request->Status.store( OVR_READ_CANCELED, std::memory_order_release );
+			request->Finished = true;
+			FinishedWake.NotifyAll();
+			request->Release();
+			return;
+		}
+		// It was next in line, so it stays at the front.
+		request->Queued = true;
+		Queue[request->Priority].InsertAt( 0, request );
+		QueueWake.Notify();
+		return;
+	}
+
+	ovrReadRequest::ovrReadBlock * block = new ovrReadRequest::ovrReadBlock();
+	block->RefCount.store( 1, std::memory_order_relaxed );
+	block->View = NULL;
+	if ( !FileSys->ReadFile( request->Uri.ToCStr(), block->Memory ) )
+	{
+		OVR_WARN( "ovrReadService: failed to read '%s'", request->Uri.ToCStr() );
+		ovrReadRequest::ReleaseBlock( block );
+		block = NULL;
+	}
+	Finish( request, block, ( block != NULL ) ? (uint8_t const *)block->Memory : NULL, ( block != NULL ) ? block->Memory.GetSize() : 0 );
+	ovrReadRequest::ReleaseBlock( block );
+}
+
+// Completes a request with data from block, or fails it if block is NULL, unless it was
+// canceled while it was being read.
+void ovrReadService::Finish( ovrReadRequest * request, ovrReadRequest::ovrReadBlock * block, uint8_t const * data, const size_t length )
+{
+	bool canceled = false;
+	{
+		Mutex::Locker locker( &QueueMutex );
+		canceled = request->Canceled;
+		if ( !canceled && block != NULL )
+		{
+			block->RefCount.fetch_add( 1, std::memory_order_relaxed );
+			request->Block = block;
+			request->Data = data;
+			request->Length = length;
+		}
+		request->Status.store( canceled ? OVR_READ_CANCELED : ( block != NULL ? OVR_READ_COMPLETE : OVR_READ_FAILED ), std::memory_order_release );
+	}
+
+	if ( !canceled && request->Callback != NULL )
+	{
+		request->Callback( *request, request->UserData );
+	}
+
+	{
+		Mutex::Locker locker( &QueueMutex );
+		request->Finished = true;
+		FinishedWake.NotifyAll();
+	}
+	request->Release();
+}
+
+threadReturn_t ovrReadService::ThreadFn( Thread * thread, void * data )
+{
+	ovrReadService * service = static_cast< ovrReadService * >( data );
+
+	thread->SetThreadName( "ReadService" );
+
+	Array< ovrReadRequest * > batch;
+	for ( ; ; )
+	{
+		ovrReadRequest * request = NULL;
+		{
+			Mutex::Locker locker( &service->QueueMutex );
+			for ( ; ; )
+			{
+				if ( service->Exiting )
+				{
+					return (threadReturn_t)0;
+				}
+				request = service->PopNext();
+				if ( request != NULL )
+				{
+					break;
+				}
+				service->QueueWake.Wait( &service->QueueMutex );
+			}
+			if ( request->File != NULL )
+			{
+				service->Gather( request, batch );
+			}
+		}
+
+		if ( request->File == NULL )
+		{
+			service->ResolveUri( request );
+		}
+		else
+		{
+			service->ReadBatch( batch );
+		}
+	}
+}
+
+} // namespace OVR
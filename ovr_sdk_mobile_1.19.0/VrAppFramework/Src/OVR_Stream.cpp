@@ -164,6 +164,17 @@ bool ovrStream::GetLocalPathFromUri( const char *uri, String &outputPath )
 	return GetLocalPathFromUri_Internal( uri, outputPath );
 }
 
+//==============================
+// ovrStream::GetLocalRange
+bool ovrStream::GetLocalRange( String & outPath, size_t & outOffset, size_t & outLength, bool & outMap )
+{
+	if ( !IsOpen() || Mode != OVR_STREAM_MODE_READ )
+	{
+		return false;
+	}
+	return GetLocalRange_Internal( outPath, outOffset, outLength, outMap );
+}
+
 //==============================
 // ovrStream::Read
 bool ovrStream::Read( MemBufferT< uint8_t > & outBuffer, size_t const bytesToRead, size_t & outBytesRead ) 
@@ -461,6 +472,20 @@ bool ovrStream_File::GetLocalPathFromUri_Internal( const char *uri, String &outp
 	return false;
 }
 
+//==============================
+// ovrStream_File::GetLocalRange_Internal
+bool ovrStream_File::GetLocalRange_Internal( String & outPath, size_t & outOffset, size_t & outLength, bool & outMap )
+{
+	if ( F == NULL || !GetLocalPathFromUri_Internal( GetUri(), outPath ) )
+	{
+		return false;
+	}
+	outOffset = 0;
+	outLength = Length_Internal();
+	outMap = false;
+	return true;
+}
+
 //==============================
 // ovrStream_File::Open_Internal
 bool ovrStream_File::Open_Internal( char const * uri, ovrStreamMode const mode ) 
@@ -759,6 +784,26 @@ void * ovrUriScheme_Apk::GetZipFileForHostName( char const * hostName ) const
 	return host->GetZipFile();
 }
 
+//==============================
+// ovrUriScheme_Apk::GetPackagePathForHostName
+bool ovrUriScheme_Apk::GetPackagePathForHostName( char const * hostName, String & outPath ) const
+{
+	ovrApkHost * host = FindHostByHostName( hostName );
+	if ( host == NULL )
+	{
+		return false;
+	}
+	int port;
+	char path[ovrFileSys::OVR_MAX_PATH_LEN];
+	if ( !ovrUri::ParseUri( host->GetSourceUri(), NULL, 0, NULL, 0, NULL, 0, NULL, 0,
+			port, path, sizeof( path ), NULL, 0, NULL, 0 ) )
+	{
+		return false;
+	}
+	outPath = path;
+	return true;
+}
+
 //==============================
 // ovrUriScheme_Apk::ovrApkHost::Open
 bool ovrUriScheme_Apk::ovrApkHost::Open()
@@ -845,6 +890,35 @@ bool ovrStream_Apk::GetLocalPathFromUri_Internal( const char *uri, String &outpu
 	return false;
 }
 
+//==============================
+// ovrStream_Apk::GetLocalRange_Internal
+bool ovrStream_Apk::GetLocalRange_Internal( String & outPath, size_t & outOffset, size_t & outLength, bool & outMap )
+{
+	char hostName[ovrFileSys::OVR_MAX_HOST_NAME_LEN];
+	int port;
+	char path[ovrFileSys::OVR_MAX_PATH_LEN];
+	if ( !ovrUri::ParseUri( GetUri(), NULL, 0, NULL, 0, NULL, 0, hostName, sizeof( hostName ),
+			port, path, sizeof( path ), NULL, 0, NULL, 0 ) )
+	{
+		return false;
+	}
+
+	void * zipFile = GetApkScheme().GetZipFileForHostName( hostName );
+	if ( zipFile == NULL || !GetApkScheme().GetPackagePathForHostName( hostName, outPath ) )
+	{
+		return false;
+	}
+
+	// only files stored without compression can be read directly
+	char const * pathStart = ( path[0] == '/' ) ? path + 1 : path;
+	if ( !ovr_GetStoredFileRangeInPackage( zipFile, pathStart, outOffset, outLength ) )
+	{
+		return false;
+	}
+	outMap = true;
+	return true;
+}
+
 //==============================
 // ovrStream_Apk::Open_Internal
 bool ovrStream_Apk::Open_Internal( char const * uri, ovrStreamMode const mode )
@@ -141,6 +141,7 @@ public:
 	virtual			~ovrUriScheme_Apk();
 
 	void *			GetZipFileForHostName( char const * hostName ) const;
+	bool			GetPackagePathForHostName( char const * hostName, String & outPath ) const;
 
 private:
 	class ovrApkHost 
@@ -230,6 +231,7 @@ private:
 
 private:
 	virtual bool		GetLocalPathFromUri_Internal( const char *uri, String &outputPath ) OVR_OVERRIDE;
+	virtual bool		GetLocalRange_Internal( String & outPath, size_t & outOffset, size_t & outLength, bool & outMap ) OVR_OVERRIDE;
 	virtual bool		Open_Internal( char const * uri, ovrStreamMode const mode ) OVR_OVERRIDE;
 	virtual void		Close_Internal() OVR_OVERRIDE;
 	virtual bool		Read_Internal( MemBufferT< uint8_t > & outBuffer, size_t const bytesToRead, size_t & outBytesRead ) OVR_OVERRIDE;
@@ -257,6 +259,7 @@ private:
 
 private:
 	virtual bool		GetLocalPathFromUri_Internal( const char *uri, String &outputPath ) OVR_OVERRIDE;
+	virtual bool		GetLocalRange_Internal( String & outPath, size_t & outOffset, size_t & outLength, bool & outMap ) OVR_OVERRIDE;
 	virtual bool		Open_Internal( char const * uri, ovrStreamMode const mode ) OVR_OVERRIDE;
 	virtual void		Close_Internal() OVR_OVERRIDE;
 	virtual bool		Read_Internal( MemBufferT< uint8_t > & outBuffer, size_t const bytesToRead, size_t & outBytesRead ) OVR_OVERRIDE;
@@ -0,0 +1,1537 @@
+/************************************************************************************
+
+Filename    :   OVR_TextureEncoder.cpp
+Content     :   Compresses RGBA images to ETC2 and ASTC on the CPU.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "OVR_TextureEncoder.h"
+
+#include "Kernel/OVR_LogUtils.h"
+#include "ImageData.h"
+
+#include <math.h>
+#include <float.h>
+
+#if defined( __SSE2__ ) || defined( OVR_CPU_X86_64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define OVR_TEXTURE_ENCODER_SSE2
+#elif defined( __ARM_NEON ) || defined( OVR_CPU_ARM_NEON )
+#include <arm_neon.h>
+#define OVR_TEXTURE_ENCODER_NEON
+#endif
+
+namespace OVR {
+
+//==============================================================================================
+// ovrFloat4
+// Four floats, for the loops over the texels of a block. Every block has a multiple of 4 texels.
+//==============================================================================================
+
+#if defined( OVR_TEXTURE_ENCODER_SSE2 )
+
+typedef __m128 ovrFloat4;
+
+static inline ovrFloat4 Float4Load( const float * p ) { return _mm_loadu_ps( p ); }
+static inline ovrFloat4 Float4Set( const float f ) { return _mm_set1_ps( f ); }
+static inline ovrFloat4 Float4Add( const ovrFloat4 a, const ovrFloat4 b ) { return _mm_add_ps( a, b ); }
+static inline ovrFloat4 Float4Sub( const ovrFloat4 a, const ovrFloat4 b ) { return _mm_sub_ps( a, b ); }
+static inline ovrFloat4 Float4Mul( const ovrFloat4 a, const ovrFloat4 b ) { return _mm_mul_ps( a, b ); }
+static inline ovrFloat4 Float4Min( const ovrFloat4 a, const ovrFloat4 b ) { return _mm_min_ps( a, b ); }
+// Rounds towards zero.
+static inline ovrFloat4 Float4Truncate( const ovrFloat4 a ) { return _mm_cvtepi32_ps( _mm_cvttps_epi32( a ) ); }
+static inline float Float4Sum( const ovrFloat4 a )
+{
+	const ovrFloat4 b = _mm_add_ps( a, _mm_movehl_ps( a, a ) );
+	return _mm_cvtss_f32( _mm_add_ss( b, _mm_shuffle_ps( b, b, 1 ) ) );
+}
+
+#elif defined( OVR_TEXTURE_ENCODER_NEON )
+
+typedef float32x4_t ovrFloat4;
+
+static inline ovrFloat4 Float4Load( const float * p ) { return vld1q_f32( p ); }
+static inline ovrFloat4 Float4Set( const float f ) { return vdupq_n_f32( f ); }
+static inline ovrFloat4 Float4Add( const ovrFloat4 a, const ovrFloat4 b ) { return vaddq_f32( a, b ); }
+static inline ovrFloat4 Float4Sub( const ovrFloat4 a, const ovrFloat4 b ) { return vsubq_f32( a, b ); }
+static inline ovrFloat4 Float4Mul( const ovrFloat4 a, const ovrFloat4 b ) { return vmulq_f32( a, b ); }
+static inline ovrFloat4 Float4Min( const ovrFloat4 a, const ovrFloat4 b ) { return vminq_f32( a, b ); }
+static inline ovrFloat4 Float4Truncate( const ovrFloat4 a ) { return vcvtq_f32_s32( vcvtq_s32_f32( a ) ); }
+static inline float Float4Sum( const ovrFloat4 a )
+{
+	const float32x2_t b = vadd_f32( vget_low_f32( a ), vget_high_f32( a ) );
+	return vget_lane_f32( vpadd_f32( b, b ), 0 );
+}
+
+#else
+
+struct ovrFloat4
+{
+	float	v[4];
+};
+
+static inline ovrFloat4 Float4Load( const float * p ) { ovrFloat4 r = { { p[0], p[1], p[2], p[3] } }; return r; }
+static inline ovrFloat4 Float4Set( const float f ) { ovrFloat4 r = { { f, f, f, f } }; return r; }
+static inline ovrFloat4 Float4Add( const ovrFloat4 a, const ovrFloat4 b ) { ovrFloat4 r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] + b.v[i]; } return r; }
+static inline ovrFloat4 Float4Sub( const ovrFloat4 a, const ovrFloat4 b ) { ovrFloat4 r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] - b.v[i]; } return r; }
+static inline ovrFloat4 Float4Mul( const ovrFloat4 a, const ovrFloat4 b ) { ovrFloat4 r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] * b.v[i]; } return r; }
+static inline ovrFloat4 Float4Min( const ovrFloat4 a, const ovrFloat4 b ) { ovrFloat4 r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; } return r; }
+static inline ovrFloat4 Float4Truncate( const ovrFloat4 a ) { ovrFloat4 r; for ( int i = 0; i < 4; i++ ) { r.v[i] = (float)(int)a.v[i]; } return r; }
+static inline float Float4Sum( const ovrFloat4 a ) { return ( a.v[0] + a.v[1] ) + ( a.v[2] + a.v[3] ); }
+
+#endif
+
+//==============================================================================================
+// Block texels
+//==============================================================================================
+
+static const int MAX_BLOCK_TEXELS = 36;
+
+struct ovrBlockTexels
+{
+	int		Width;
+	int		Height;
+	float	R[MAX_BLOCK_TEXELS];	// row major
+	float	G[MAX_BLOCK_TEXELS];
+	float	B[MAX_BLOCK_TEXELS];
+};
+
+// Blocks that go past the edge of the image repeat the last row and column.
+static void GetBlockTexels( const uint8_t * rgba, const int width, const int height,
+		const int blockX, const int blockY, const int blockWidth, const int blockHeight, ovrBlockTexels & texels )
+{
+	texels.Width = blockWidth;
+	texels.Height = blockHeight;
+	for ( int y = 0; y < blockHeight; y++ )
+	{
+		const int sy = Alg::Min( blockY * blockHeight + y, height - 1 );
+		for ( int x = 0; x < blockWidth; x++ )
+		{
+			const int sx = Alg::Min( blockX * blockWidth + x, width - 1 );
+			const uint8_t * p = rgba + ( sy * width + sx ) * 4;
+			texels.R[y * blockWidth + x] = p[0];
+			texels.G[y * blockWidth + x] = p[1];
+			texels.B[y * blockWidth + x] = p[2];
+		}
+	}
+}
+
+static void StoreBlockTexels( const uint8_t ( *colors )[3], const int blockX, const int blockY,
+		const int blockWidth, const int blockHeight, const int width, const int height, uint8_t * rgba )
+{
+	for ( int y = 0; y < blockHeight && blockY * blockHeight + y < height; y++ )
+	{
+		for ( int x = 0; x < blockWidth && blockX * blockWidth + x < width; x++ )
+		{
+			uint8_t * p = rgba + ( ( blockY * blockHeight + y ) * width + blockX * blockWidth + x ) * 4;
+			p[0] = colors[y * blockWidth + x][0];
+			p[1] = colors[y * blockWidth + x][1];
+			p[2] = colors[y * blockWidth + x][2];
+			p[3] = 255;
+		}
+	}
+}
+
+static inline int ClampByte( const int v )
+{
+	return v < 0 ? 0 : ( v > 255 ? 255 : v );
+}
+
+// Sets numBits bits starting at bit, counting from the least significant bit of block[0].
+static void SetBits( uint8_t * block, const int bit, const int numBits, const uint32_t value )
+{
+	for ( int i = 0; i < numBits; i++ )
+	{
+		if ( value & ( 1u << i ) )
+		{
+			block[( bit + i ) >> 3] |= (uint8_t)( 1 << ( ( bit + i ) & 7 ) );
+		}
+	}
+}
+
+static uint32_t GetBits( const uint8_t * block, const int bit, const int numBits )
+{
+	uint32_t value = 0;
+	for ( int i = 0; i < numBits; i++ )
+	{
+		value |= (uint32_t)( ( block[( bit + i ) >> 3] >> ( ( bit + i ) & 7 ) ) & 1 ) << i;
+	}
+	return value;
+}
+
+//==============================================================================================
+// ETC2 RGB
+//==============================================================================================
+
+static const int EtcModifiers[8][4] =
+{
+	{ 2, 8, -2, -8 },
+	{ 5, 17, -5, -17 },
+	{ 9, 29, -9, -29 },
+	{ 13, 42, -13, -42 },
+	{ 18, 60, -18, -60 },
+	{ 24, 80, -24, -80 },
+	{ 33, 106, -33, -106 },
+	{ 47, 183, -47, -183 }
+};
+
+static inline int EtcExpand( const int q, const int bits )
+{
+	// 4, 5, 6 and 7 bit values are widened by repeating their high bits
+	return ( q << ( 8 - bits ) ) | ( q >> ( 2 * bits - 8 ) );
+}
+
+// The sub-blocks of both flip modes as runs of 8 texels, so they can be read 4 at a time.
+struct ovrEtcTexels
+{
+	float	R[2][16];	// [flip][( flip ? y * 4 + x : x * 4 + y )]
+	float	G[2][16];
+	float	B[2][16];
+};
+
+// The sum over the 8 texels of the squared error to the nearest of the 4 colors of the table.
+static float EtcSubblockError( const float * r, const float * g, const float * b, const int base[3], const int table )
+{
+	ovrFloat4 error0 = Float4Set( FLT_MAX );
+	ovrFloat4 error1 = Float4Set( FLT_MAX );
+	const ovrFloat4 r0 = Float4Load( r );
+	const ovrFloat4 r1 = Float4Load( r + 4 );
+	const ovrFloat4 g0 = Float4Load( g );
+	const ovrFloat4 g1 = Float4Load( g + 4 );
+	const ovrFloat4 b0 = Float4Load( b );
+	const ovrFloat4 b1 = Float4Load( b + 4 );
+	for ( int k = 0; k < 4; k++ )
+	{
+		const int m = EtcModifiers[table][k];
+		const ovrFloat4 cr = Float4Set( (float)ClampByte( base[0] + m ) );
+		const ovrFloat4 cg = Float4Set( (float)ClampByte( base[1] + m ) );
+		const ovrFloat4 cb = Float4Set( (float)ClampByte( base[2] + m ) );
+
+		ovrFloat4 dr = Float4Sub( r0, cr );
+		ovrFloat4 dg = Float4Sub( g0, cg );
+		ovrFloat4 db = Float4Sub( b0, cb );
+		error0 = Float4Min( error0, Float4Add( Float4Add( Float4Mul( dr, dr ), Float4Mul( dg, dg ) ), Float4Mul( db, db ) ) );
+
+		dr = Float4Sub( r1, cr );
+		dg = Float4Sub( g1, cg );
+		db = Float4Sub( b1, cb );
+		error1 = Float4Min( error1, Float4Add( Float4Add( Float4Mul( dr, dr ), Float4Mul( dg, dg ) ), Float4Mul( db, db ) ) );
+	}
+	return Float4Sum( Float4Add( error0, error1 ) );
+}
+
+struct ovrEtcBase
+{
+	int		Q[3];		// 4 or 5 bit base color
+	int		Table;
+	float	Error;
+};
+
+// Quantized values on either side of v, or only the nearest one.
+static int EtcQuantizeCandidates( const float v, const int bits, const bool both, int candidates[2] )
+{
+	const int maxQ = ( 1 << bits ) - 1;
+	int lo = Alg::Clamp( (int)( v * maxQ / 255.0f ), 0, maxQ );
+	while ( lo < maxQ && EtcExpand( lo + 1, bits ) <= v )
+	{
+		lo++;
+	}
+	while ( lo > 0 && EtcExpand( lo, bits ) > v )
+	{
+		lo--;
+	}
+	const int hi = Alg::Min( lo + 1, maxQ );
+	if ( both && hi != lo )
+	{
+		candidates[0] = lo;
+		candidates[1] = hi;
+		return 2;
+	}
+	candidates[0] = ( v - EtcExpand( lo, bits ) <= EtcExpand( hi, bits ) - v ) ? lo : hi;
+	return 1;
+}
+
+// Fills bases with the best table for each candidate base color of a sub-block.
+static int EtcSearchSubblock( const float * r, const float * g, const float * b, const int bits,
+		const bool both, ovrEtcBase bases[8] )
+{
+	float avg[3] = { 0.0f, 0.0f, 0.0f };
+	for ( int i = 0; i < 8; i++ )
+	{
+		avg[0] += r[i];
+		avg[1] += g[i];
+		avg[2] += b[i];
+	}
+
+	int candidates[3][2];
+	int numCandidates[3];
+	for ( int c = 0; c < 3; c++ )
+	{
+		numCandidates[c] = EtcQuantizeCandidates( avg[c] * ( 1.0f / 8.0f ), bits, both, candidates[c] );
+	}
+
+	int numBases = 0;
+	for ( int i0 = 0; i0 < numCandidates[0]; i0++ )
+	{
+		for ( int i1 = 0; i1 < numCandidates[1]; i1++ )
+		{
+			for ( int i2 = 0; i2 < numCandidates[2]; i2++ )
+			{
+				ovrEtcBase & base = bases[numBases++];
+				base.Q[0] = candidates[0][i0];
+				base.Q[1] = candidates[1][i1];
+				base.Q[2] = candidates[2][i2];
+				const int expanded[3] = { EtcExpand( base.Q[0], bits ), EtcExpand( base.Q[1], bits ), EtcExpand( base.Q[2], bits ) };
+				base.Error = FLT_MAX;
+				for ( int t = 0; t < 8; t++ )
+				{
+					const float error = EtcSubblockError( r, g, b, expanded, t );
+					if ( error < base.Error )
+					{
+						base.Error = error;
+						base.Table = t;
+					}
+				}
+			}
+		}
+	}
+	return numBases;
+}
+
+static void EtcWriteBlock( const uint32_t hi, const uint32_t lo, uint8_t * out )
+{
+	for ( int i = 0; i < 4; i++ )
+	{
+		out[i] = (uint8_t)( hi >> ( 24 - i * 8 ) );
+		out[4 + i] = (uint8_t)( lo >> ( 24 - i * 8 ) );
+	}
+}
+
+// Picks the nearest of the 4 colors for each texel.
+static uint32_t EtcSelectors( const ovrBlockTexels & texels, const bool flip, const int base[2][3], const int table[2] )
+{
+	uint32_t bits = 0;
+	for ( int y = 0; y < 4; y++ )
+	{
+		for ( int x = 0; x < 4; x++ )
+		{
+			const int sub = flip ? ( y >> 1 ) : ( x >> 1 );
+			const int t = y * 4 + x;
+			int best = 0;
+			int bestError = INT_MAX;
+			for ( int k = 0; k < 4; k++ )
+			{
+				const int m = EtcModifiers[table[sub]][k];
+				const int dr = ClampByte( base[sub][0] + m ) - (int)texels.R[t];
+				const int dg = ClampByte( base[sub][1] + m ) - (int)texels.G[t];
+				const int db = ClampByte( base[sub][2] + m ) - (int)texels.B[t];
+				const int error = dr * dr + dg * dg + db * db;
+				if ( error < bestError )
+				{
+					bestError = error;
+					best = k;
+				}
+			}
+			const int i = x * 4 + y;
+			bits |= (uint32_t)( best >> 1 ) << ( 16 + i );
+			bits |= (uint32_t)( best & 1 ) << i;
+		}
+	}
+	return bits;
+}
+
+static void EtcPlanarColor( const int o[3], const int h[3], const int v[3], const int x, const int y, int color[3] )
+{
+	for ( int c = 0; c < 3; c++ )
+	{
+		color[c] = ClampByte( ( x * ( h[c] - o[c] ) + y * ( v[c] - o[c] ) + 4 * o[c] + 2 ) >> 2 );
+	}
+}
+
+static const int EtcPlanarBits[3] = { 6, 7, 6 };
+
+static float EtcPlanarError( const ovrBlockTexels & texels, const int qo[3], const int qh[3], const int qv[3] )
+{
+	int o[3];
+	int h[3];
+	int v[3];
+	for ( int c = 0; c < 3; c++ )
+	{
+		o[c] = EtcExpand( qo[c], EtcPlanarBits[c] );
+		h[c] = EtcExpand( qh[c], EtcPlanarBits[c] );
+		v[c] = EtcExpand( qv[c], EtcPlanarBits[c] );
+	}
+	float error = 0.0f;
+	for ( int y = 0; y < 4; y++ )
+	{
+		for ( int x = 0; x < 4; x++ )
+		{
+			int color[3];
+			EtcPlanarColor( o, h, v, x, y, color );
+			const float dr = color[0] - texels.R[y * 4 + x];
+			const float dg = color[1] - texels.G[y * 4 + x];
+			const float db = color[2] - texels.B[y * 4 + x];
+			error += dr * dr + dg * dg + db * db;
+		}
+	}
+	return error;
+}
+
+// Fits a plane to the block and returns its error once quantized.
+static float EtcFitPlanar( const ovrBlockTexels & texels, const bool search, int qo[3], int qh[3], int qv[3] )
+{
+	const float * channels[3] = { texels.R, texels.G, texels.B };
+	for ( int c = 0; c < 3; c++ )
+	{
+		float mean = 0.0f;
+		float dx = 0.0f;
+		float dy = 0.0f;
+		for ( int y = 0; y < 4; y++ )
+		{
+			for ( int x = 0; x < 4; x++ )
+			{
+				const float value = channels[c][y * 4 + x];
+				mean += value;
+				dx += ( x - 1.5f ) * value;
+				dy += ( y - 1.5f ) * value;
+			}
+		}
+		mean *= 1.0f / 16.0f;
+		dx *= 1.0f / 20.0f;	// sum of ( x - 1.5 )^2
+		dy *= 1.0f / 20.0f;
+		const float o = mean - 1.5f * dx - 1.5f * dy;
+		const float values[3] = { o, o + 4.0f * dx, o + 4.0f * dy };
+		int * q[3] = { &qo[c], &qh[c], &qv[c] };
+		for ( int i = 0; i < 3; i++ )
+		{
+			int candidates[2];
+			EtcQuantizeCandidates( Alg::Clamp( values[i], 0.0f, 255.0f ), EtcPlanarBits[c], false, candidates );
+			*q[i] = candidates[0];
+		}
+	}
+
+	float error = EtcPlanarError( texels, qo, qh, qv );
+	if ( search )
+	{
+		// one pass of moving each value by one step
+		int * q[9] = { &qo[0], &qo[1], &qo[2], &qh[0], &qh[1], &qh[2], &qv[0], &qv[1], &qv[2] };
+		for ( int i = 0; i < 9; i++ )
+		{
+			const int maxQ = ( 1 << EtcPlanarBits[i % 3] ) - 1;
+			const int original = *q[i];
+			int best = original;
+			for ( int d = -1; d <= 1; d += 2 )
+			{
+				if ( original + d < 0 || original + d > maxQ )
+				{
+					continue;
+				}
+				*q[i] = original + d;
+				const float e = EtcPlanarError( texels, qo, qh, qv );
+				if ( e < error )
+				{
+					error = e;
+					best = original + d;
+				}
+			}
+			*q[i] = best;
+		}
+	}
+	return error;
+}
+
+static void EtcWritePlanar( const int qo[3], const int qh[3], const int qv[3], uint8_t * out )
+{
+	uint8_t b[8];
+	b[0] = (uint8_t)( ( qo[0] << 1 ) | ( qo[1] >> 6 ) );
+	b[1] = (uint8_t)( ( ( qo[1] & 0x3F ) << 1 ) | ( qo[2] >> 5 ) );
+	b[2] = (uint8_t)( ( qo[2] & 0x18 ) | ( ( qo[2] >> 1 ) & 3 ) );
+	b[3] = (uint8_t)( ( ( qo[2] & 1 ) << 7 ) | ( ( qh[0] >> 1 ) << 2 ) | 2 | ( qh[0] & 1 ) );
+	b[4] = (uint8_t)( ( qh[1] << 1 ) | ( qh[2] >> 5 ) );
+	b[5] = (uint8_t)( ( ( qh[2] & 0x1F ) << 3 ) | ( qv[0] >> 3 ) );
+	b[6] = (uint8_t)( ( ( qv[0] & 7 ) << 5 ) | ( qv[1] >> 2 ) );
+	b[7] = (uint8_t)( ( ( qv[1] & 3 ) << 6 ) | qv[2] );
+
+	// The planar mode is signalled by red and green not overflowing in the differential
+	// layout while blue does. The bits that are not part of the colors are free to set that up.
+	for ( int i = 0; i < 2; i++ )
+	{
+		const int base = b[i] >> 3;
+		const int delta = ( (int)( b[i] & 7 ) ^ 4 ) - 4;
+		if ( base + delta < 0 || base + delta > 31 )
+		{
+			b[i] ^= 0x80;
+		}
+	}
+	for ( int free = 0; free < 16; free++ )
+	{
+		const uint8_t b2 = (uint8_t)( b[2] | ( ( free & 1 ) << 7 ) | ( ( ( free >> 1 ) & 1 ) << 6 ) |
+				( ( ( free >> 2 ) & 1 ) << 5 ) | ( ( ( free >> 3 ) & 1 ) << 2 ) );
+		const int base = b2 >> 3;
+		const int delta = ( (int)( b2 & 7 ) ^ 4 ) - 4;
+		if ( base + delta < 0 || base + delta > 31 )
+		{
+			b[2] = b2;
+			break;
+		}
+	}
+	memcpy( out, b, 8 );
+}
+
+static void EncodeEtc2Block( const ovrBlockTexels & texels, const ovrTextureEncodeQuality quality, uint8_t * out )
+{
+	ovrEtcTexels etc;
+	for ( int y = 0; y < 4; y++ )
+	{
+		for ( int x = 0; x < 4; x++ )
+		{
+			etc.R[0][x * 4 + y] = etc.R[1][y * 4 + x] = texels.R[y * 4 + x];
+			etc.G[0][x * 4 + y] = etc.G[1][y * 4 + x] = texels.G[y * 4 + x];
+			etc.B[0][x * 4 + y] = etc.B[1][y * 4 + x] = texels.B[y * 4 + x];
+		}
+	}
+
+	const bool both = ( quality == TEXTURE_ENCODE_HIGH );
+	float bestError = FLT_MAX;
+	uint32_t bestHi = 0;
+	int bestBase[2][3] = {};
+	int bestTable[2] = {};
+	bool bestFlip = false;
+
+	for ( int flip = 0; flip < 2; flip++ )
+	{
+		ovrEtcBase diff[2][8];
+		int numDiff[2];
+		ovrEtcBase individual[2][8];
+		int numIndividual[2] = { 0, 0 };
+		for ( int sub = 0; sub < 2; sub++ )
+		{
+			const float * r = &etc.R[flip][sub * 8];
+			const float * g = &etc.G[flip][sub * 8];
+			const float * b = &etc.B[flip][sub * 8];
+			numDiff[sub] = EtcSearchSubblock( r, g, b, 5, both, diff[sub] );
+			if ( quality != TEXTURE_ENCODE_FAST )
+			{
+				numIndividual[sub] = EtcSearchSubblock( r, g, b, 4, both, individual[sub] );
+			}
+		}
+
+		// differential: the second base color is stored as a 3 bit delta from the first
+		bool hasDiff = false;
+		for ( int i = 0; i < numDiff[0]; i++ )
+		{
+			for ( int j = 0; j < numDiff[1]; j++ )
+			{
+				const ovrEtcBase & b0 = diff[0][i];
+				const ovrEtcBase & b1 = diff[1][j];
+				const int dr = b1.Q[0] - b0.Q[0];
+				const int dg = b1.Q[1] - b0.Q[1];
+				const int db = b1.Q[2] - b0.Q[2];
+				if ( dr < -4 || dr > 3 || dg < -4 || dg > 3 || db < -4 || db > 3 )
+				{
+					continue;
+				}
+				hasDiff = true;
+				const float error = b0.Error + b1.Error;
+				if ( error < bestError )
+				{
+					bestError = error;
+					bestHi = ( (uint32_t)b0.Q[0] << 27 ) | ( (uint32_t)( dr & 7 ) << 24 ) |
+							( (uint32_t)b0.Q[1] << 19 ) | ( (uint32_t)( dg & 7 ) << 16 ) |
+							( (uint32_t)b0.Q[2] << 11 ) | ( (uint32_t)( db & 7 ) << 8 ) |
+							( (uint32_t)b0.Table << 5 ) | ( (uint32_t)b1.Table << 2 ) | 2 | (uint32_t)flip;
+					for ( int c = 0; c < 3; c++ )
+					{
+						bestBase[0][c] = EtcExpand( b0.Q[c], 5 );
+						bestBase[1][c] = EtcExpand( b1.Q[c], 5 );
+					}
+					bestTable[0] = b0.Table;
+					bestTable[1] = b1.Table;
+					bestFlip = ( flip != 0 );
+				}
+			}
+		}
+
+		// individual: two 4 bit base colors
+		if ( quality == TEXTURE_ENCODE_FAST && !hasDiff )
+		{
+			for ( int sub = 0; sub < 2; sub++ )
+			{
+				numIndividual[sub] = EtcSearchSubblock( &etc.R[flip][sub * 8], &etc.G[flip][sub * 8], &etc.B[flip][sub * 8],
+						4, false, individual[sub] );
+			}
+		}
+		if ( numIndividual[0] > 0 )
+		{
+			const ovrEtcBase * best[2];
+			for ( int sub = 0; sub < 2; sub++ )
+			{
+				best[sub] = &individual[sub][0];
+				for ( int i = 1; i < numIndividual[sub]; i++ )
+				{
+					if ( individual[sub][i].Error < best[sub]->Error )
+					{
+						best[sub] = &individual[sub][i];
+					}
+				}
+			}
+			const float error = best[0]->Error + best[1]->Error;
+			if ( error < bestError )
+			{
+				bestError = error;
+				bestHi = ( (uint32_t)best[0]->Q[0] << 28 ) | ( (uint32_t)best[1]->Q[0] << 24 ) |
+						( (uint32_t)best[0]->Q[1] << 20 ) | ( (uint32_t)best[1]->Q[1] << 16 ) |
+						( (uint32_t)best[0]->Q[2] << 12 ) | ( (uint32_t)best[1]->Q[2] << 8 ) |
+						( (uint32_t)best[0]->Table << 5 ) | ( (uint32_t)best[1]->Table << 2 ) | (uint32_t)flip;
+				for ( int c = 0; c < 3; c++ )
+				{
+					bestBase[0][c] = EtcExpand( best[0]->Q[c], 4 );
+					bestBase[1][c] = EtcExpand( best[1]->Q[c], 4 );
+				}
+				bestTable[0] = best[0]->Table;
+				bestTable[1] = best[1]->Table;
+				bestFlip = ( flip != 0 );
+			}
+		}
+	}
+
+	if ( quality != TEXTURE_ENCODE_FAST )
+	{
+		int qo[3];
+		int qh[3];
+		int qv[3];
+		const float error = EtcFitPlanar( texels, quality == TEXTURE_ENCODE_HIGH, qo, qh, qv );
+		if ( error < bestError )
+		{
+			EtcWritePlanar( qo, qh, qv, out );
+			return;
+		}
+	}
+
+	EtcWriteBlock( bestHi, EtcSelectors( texels, bestFlip, bestBase, bestTable ), out );
+}
+
+static void DecodeEtc2Block( const uint8_t * in, uint8_t colors[16][3] )
+{
+	const uint32_t hi = ( (uint32_t)in[0] << 24 ) | ( (uint32_t)in[1] << 16 ) | ( (uint32_t)in[2] << 8 ) | in[3];
+	const uint32_t lo = ( (uint32_t)in[4] << 24 ) | ( (uint32_t)in[5] << 16 ) | ( (uint32_t)in[6] << 8 ) | in[7];
+	const bool flip = ( hi & 1 ) != 0;
+	int base[2][3];
+
+	if ( ( hi & 2 ) == 0 )
+	{
+		for ( int c = 0; c < 3; c++ )
+		{
+			base[0][c] = EtcExpand( ( hi >> ( 28 - c * 8 ) ) & 15, 4 );
+			base[1][c] = EtcExpand( ( hi >> ( 24 - c * 8 ) ) & 15, 4 );
+		}
+	}
+	else
+	{
+		int overflow = -1;
+		for ( int c = 0; c < 3; c++ )
+		{
+			const int q = ( hi >> ( 27 - c * 8 ) ) & 31;
+			const int delta = ( (int)( ( hi >> ( 24 - c * 8 ) ) & 7 ) ^ 4 ) - 4;
+			if ( overflow < 0 && ( q + delta < 0 || q + delta > 31 ) )
+			{
+				overflow = c;
+			}
+			base[0][c] = EtcExpand( q, 5 );
+			base[1][c] = EtcExpand( Alg::Clamp( q + delta, 0, 31 ), 5 );
+		}
+		if ( overflow == 2 )
+		{
+			const int qo[3] = { ( in[0] >> 1 ) & 0x3F,
+								( ( in[0] & 1 ) << 6 ) | ( ( in[1] >> 1 ) & 0x3F ),
+								( ( in[1] & 1 ) << 5 ) | ( in[2] & 0x18 ) | ( ( in[2] & 3 ) << 1 ) | ( in[3] >> 7 ) };
+			const int qh[3] = { ( ( in[3] >> 1 ) & 0x3E ) | ( in[3] & 1 ),
+								( in[4] >> 1 ) & 0x7F,
+								( ( in[4] & 1 ) << 5 ) | ( in[5] >> 3 ) };
+			const int qv[3] = { ( ( in[5] & 7 ) << 3 ) | ( in[6] >> 5 ),
+								( ( in[6] & 0x1F ) << 2 ) | ( in[7] >> 6 ),
+								in[7] & 0x3F };
+			int o[3];
+			int h[3];
+			int v[3];
+			for ( int c = 0; c < 3; c++ )
+			{
+				o[c] = EtcExpand( qo[c], EtcPlanarBits[c] );
+				h[c] = EtcExpand( qh[c], EtcPlanarBits[c] );
+				v[c] = EtcExpand( qv[c], EtcPlanarBits[c] );
+			}
+			for ( int y = 0; y < 4; y++ )
+			{
+				for ( int x = 0; x < 4; x++ )
+				{
+					int color[3];
+					EtcPlanarColor( o, h, v, x, y, color );
+					for ( int c = 0; c < 3; c++ )
+					{
+						colors[y * 4 + x][c] = (uint8_t)color[c];
+					}
+				}
+			}
+			return;
+		}
+		if ( overflow >= 0 )
+		{
+			// T and H modes are not produced by the encoder
+			for ( int i = 0; i < 16; i++ )
+			{
+				colors[i][0] = 255;
+				colors[i][1] = 0;
+				colors[i][2] = 255;
+			}
+			return;
+		}
+	}
+
+	const int table[2] = { (int)( ( hi >> 5 ) & 7 ), (int)( ( hi >> 2 ) & 7 ) };
+	for ( int y = 0; y < 4; y++ )
+	{
+		for ( int x = 0; x < 4; x++ )
+		{
+			const int sub = flip ? ( y >> 1 ) : ( x >> 1 );
+			const int i = x * 4 + y;
+			const int k = ( ( ( lo >> ( 16 + i ) ) & 1 ) << 1 ) | ( ( lo >> i ) & 1 );
+			for ( int c = 0; c < 3; c++ )
+			{
+				colors[y * 4 + x][c] = (uint8_t)ClampByte( base[sub][c] + EtcModifiers[table[sub]][k] );
+			}
+		}
+	}
+}
+
+//==============================================================================================
+// ASTC
+//==============================================================================================
+
+static const int ASTC_WEIGHT_BITS = 3;
+static const int ASTC_NUM_WEIGHT_LEVELS = 8;
+// 3 bit weights widened to 0..64
+static const int AstcWeightLevels[ASTC_NUM_WEIGHT_LEVELS] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const int ASTC_CEM_LDR_RGB_DIRECT = 8;
+
+struct ovrAstcMode
+{
+	int		BlockMode;		// 11 bit block mode: grid size and 3 bit weights
+	int		GridWidth;
+	int		GridHeight;
+	int		EndpointBits;	// the color bits left over, which fix the endpoint precision
+};
+
+// A 4x4 grid of 3 bit weights leaves 63 bits for the 6 endpoint values, enough for 8 bits
+// each. A 5x5 grid leaves 36 bits, 6 bits each.
+static const ovrAstcMode AstcMode4x4 = { 0x053, 4, 4, 8 };
+static const ovrAstcMode AstcMode5x5 = { 0x0F3, 5, 5, 6 };
+
+// How the weights of each texel are interpolated from the weight grid.
+struct ovrAstcInfill
+{
+	int		NumTexels;
+	int		Index[MAX_BLOCK_TEXELS][4];
+	int		Factor[MAX_BLOCK_TEXELS][4];	// in 16ths
+};
+
+static void BuildAstcInfill( const int blockWidth, const int blockHeight, const int gridWidth, const int gridHeight, ovrAstcInfill & infill )
+{
+	infill.NumTexels = blockWidth * blockHeight;
+	const int ds = ( 1024 + blockWidth / 2 ) / ( blockWidth - 1 );
+	const int dt = ( 1024 + blockHeight / 2 ) / ( blockHeight - 1 );
+	for ( int t = 0; t < blockHeight; t++ )
+	{
+		for ( int s = 0; s < blockWidth; s++ )
+		{
+			const int gs = ( ds * s * ( gridWidth - 1 ) + 32 ) >> 6;
+			const int gt = ( dt * t * ( gridHeight - 1 ) + 32 ) >> 6;
+			const int js = gs >> 4;
+			const int fs = gs & 15;
+			const int jt = gt >> 4;
+			const int ft = gt & 15;
+			const int w11 = ( fs * ft + 8 ) >> 4;
+			const int i = t * blockWidth + s;
+			const int v0 = jt * gridWidth + js;
+			infill.Index[i][0] = v0;
+			infill.Index[i][1] = ( js + 1 < gridWidth ) ? v0 + 1 : v0;
+			infill.Index[i][2] = ( jt + 1 < gridHeight ) ? v0 + gridWidth : v0;
+			infill.Index[i][3] = ( js + 1 < gridWidth && jt + 1 < gridHeight ) ? v0 + gridWidth + 1 : v0;
+			infill.Factor[i][0] = 16 - fs - ft + w11;
+			infill.Factor[i][1] = fs - w11;
+			infill.Factor[i][2] = ft - w11;
+			infill.Factor[i][3] = w11;
+		}
+	}
+}
+
+static const ovrAstcInfill & GetAstcInfill( const int blockSize, const ovrAstcMode & mode )
+{
+	struct ovrAstcInfills
+	{
+		ovrAstcInfills()
+		{
+			BuildAstcInfill( 4, 4, 4, 4, Block4Grid4 );
+			BuildAstcInfill( 6, 6, 4, 4, Block6Grid4 );
+			BuildAstcInfill( 6, 6, 5, 5, Block6Grid5 );
+		}
+		ovrAstcInfill	Block4Grid4;
+		ovrAstcInfill	Block6Grid4;
+		ovrAstcInfill	Block6Grid5;
+	};
+	static const ovrAstcInfills infills;
+	if ( blockSize == 4 )
+	{
+		return infills.Block4Grid4;
+	}
+	return ( mode.GridWidth == 4 ) ? infills.Block6Grid4 : infills.Block6Grid5;
+}
+
+static int AstcQuantizeEndpoint( const float v, const int bits )
+{
+	if ( bits == 8 )
+	{
+		return Alg::Clamp( (int)( v + 0.5f ), 0, 255 );
+	}
+	int candidates[2];
+	EtcQuantizeCandidates( Alg::Clamp( v, 0.0f, 255.0f ), bits, false, candidates );
+	return candidates[0];
+}
+
+static inline int AstcUnquantizeEndpoint( const int q, const int bits )
+{
+	return ( bits == 8 ) ? q : EtcExpand( q, bits );
+}
+
+static int AstcNearestWeightLevel( const float w )
+{
+	int best = 0;
+	for ( int i = 1; i < ASTC_NUM_WEIGHT_LEVELS; i++ )
+	{
+		if ( fabsf( w - AstcWeightLevels[i] ) < fabsf( w - AstcWeightLevels[best] ) )
+		{
+			best = i;
+		}
+	}
+	return best;
+}
+
+// Widens the quantized grid weights and interpolates them for each texel.
+static void AstcTexelWeights( const ovrAstcInfill & infill, const int * levels, float * weights )
+{
+	for ( int i = 0; i < infill.NumTexels; i++ )
+	{
+		int sum = 8;
+		for ( int k = 0; k < 4; k++ )
+		{
+			sum += AstcWeightLevels[levels[infill.Index[i][k]]] * infill.Factor[i][k];
+		}
+		weights[i] = (float)( sum >> 4 );
+	}
+}
+
+// The squared error of the block as it decodes, interpolating the endpoints widened to
+// 16 bits and keeping the top 8 bits of the result.
+static float AstcBlockError( const ovrBlockTexels & texels, const int e0[3], const int e1[3], const float * weights )
+{
+	const int numTexels = texels.Width * texels.Height;
+	const float * channels[3] = { texels.R, texels.G, texels.B };
+	ovrFloat4 error = Float4Set( 0.0f );
+	for ( int c = 0; c < 3; c++ )
+	{
+		const ovrFloat4 c0 = Float4Set( (float)( e0[c] * 257 ) );
+		const ovrFloat4 delta = Float4Set( (float)( ( e1[c] - e0[c] ) * 257 ) );
+		const ovrFloat4 scale64 = Float4Set( 64.0f );
+		const ovrFloat4 round = Float4Set( 32.0f );
+		const ovrFloat4 inv64 = Float4Set( 1.0f / 64.0f );
+		const ovrFloat4 inv256 = Float4Set( 1.0f / 256.0f );
+		for ( int i = 0; i < numTexels; i += 4 )
+		{
+			// ( c0 * ( 64 - w ) + c1 * w + 32 ) >> 6 >> 8, all values positive
+			const ovrFloat4 w = Float4Load( weights + i );
+			const ovrFloat4 c16 = Float4Truncate( Float4Mul( Float4Add( Float4Add( Float4Mul( c0, scale64 ), Float4Mul( delta, w ) ), round ), inv64 ) );
+			const ovrFloat4 c8 = Float4Truncate( Float4Mul( c16, inv256 ) );
+			const ovrFloat4 d = Float4Sub( c8, Float4Load( channels[c] + i ) );
+			error = Float4Add( error, Float4Mul( d, d ) );
+		}
+	}
+	return Float4Sum( error );
+}
+
+// Least squares endpoints for the given texel weights.
+static bool AstcFitEndpoints( const ovrBlockTexels & texels, const float * weights, float e0[3], float e1[3] )
+{
+	const int numTexels = texels.Width * texels.Height;
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float ap[3] = { 0.0f, 0.0f, 0.0f };
+	float bp[3] = { 0.0f, 0.0f, 0.0f };
+	const float * channels[3] = { texels.R, texels.G, texels.B };
+	for ( int i = 0; i < numTexels; i++ )
+	{
+		const float b = weights[i] * ( 1.0f / 64.0f );
+		const float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for ( int c = 0; c < 3; c++ )
+		{
+			ap[c] += a * channels[c][i];
+			bp[c] += b * channels[c][i];
+		}
+	}
+	const float det = aa * bb - ab * ab;
+	if ( fabsf( det ) < 1e-4f )
+	{
+		return false;
+	}
+	const float invDet = 1.0f / det;
+	for ( int c = 0; c < 3; c++ )
+	{
+		e0[c] = Alg::Clamp( ( bb * ap[c] - ab * bp[c] ) * invDet, 0.0f, 255.0f );
+		e1[c] = Alg::Clamp( ( aa * bp[c] - ab * ap[c] ) * invDet, 0.0f, 255.0f );
+	}
+	return true;
+}
+
+struct ovrAstcBlock
+{
+	int		Q0[3];		// quantized endpoints
+	int		Q1[3];
+	int		Levels[MAX_BLOCK_TEXELS];	// quantized grid weights
+	float	Error;
+};
+
+// Quantizes the endpoints and picks the grid weights for them.
+static void AstcChooseWeights( const ovrBlockTexels & texels, const ovrAstcMode & mode, const ovrAstcInfill & infill,
+		const float e0[3], const float e1[3], ovrAstcBlock & block )
+{
+	int u0[3];
+	int u1[3];
+	for ( int c = 0; c < 3; c++ )
+	{
+		block.Q0[c] = AstcQuantizeEndpoint( e0[c], mode.EndpointBits );
+		block.Q1[c] = AstcQuantizeEndpoint( e1[c], mode.EndpointBits );
+		u0[c] = AstcUnquantizeEndpoint( block.Q0[c], mode.EndpointBits );
+		u1[c] = AstcUnquantizeEndpoint( block.Q1[c], mode.EndpointBits );
+	}
+
+	// project each texel on the line between the endpoints
+	const float d[3] = { (float)( u1[0] - u0[0] ), (float)( u1[1] - u0[1] ), (float)( u1[2] - u0[2] ) };
+	const float lengthSq = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+	const float scale = ( lengthSq > 0.0f ) ? 64.0f / lengthSq : 0.0f;
+	float ideal[MAX_BLOCK_TEXELS];
+	for ( int i = 0; i < infill.NumTexels; i++ )
+	{
+		const float t = ( ( texels.R[i] - u0[0] ) * d[0] + ( texels.G[i] - u0[1] ) * d[1] + ( texels.B[i] - u0[2] ) * d[2] ) * scale;
+		ideal[i] = Alg::Clamp( t, 0.0f, 64.0f );
+	}
+
+	const int numWeights = mode.GridWidth * mode.GridHeight;
+	if ( numWeights == infill.NumTexels )
+	{
+		for ( int i = 0; i < numWeights; i++ )
+		{
+			block.Levels[i] = AstcNearestWeightLevel( ideal[i] );
+		}
+		return;
+	}
+
+	// Weighted average of the texels each grid weight reaches, then a few steps that move
+	// each grid weight against the error of the texels it reaches.
+	float grid[MAX_BLOCK_TEXELS];
+	float sum[MAX_BLOCK_TEXELS];
+	float sumSq[MAX_BLOCK_TEXELS];
+	memset( grid, 0, sizeof( grid ) );
+	memset( sum, 0, sizeof( sum ) );
+	memset( sumSq, 0, sizeof( sumSq ) );
+	for ( int i = 0; i < infill.NumTexels; i++ )
+	{
+		for ( int k = 0; k < 4; k++ )
+		{
+			const float f = infill.Factor[i][k] * ( 1.0f / 16.0f );
+			grid[infill.Index[i][k]] += f * ideal[i];
+			sum[infill.Index[i][k]] += f;
+			sumSq[infill.Index[i][k]] += f * f;
+		}
+	}
+	for ( int j = 0; j < numWeights; j++ )
+	{
+		grid[j] = ( sum[j] > 0.0f ) ? grid[j] / sum[j] : 0.0f;
+	}
+	for ( int iteration = 0; iteration < 2; iteration++ )
+	{
+		float step[MAX_BLOCK_TEXELS];
+		memset( step, 0, sizeof( step ) );
+		for ( int i = 0; i < infill.NumTexels; i++ )
+		{
+			float w = 0.0f;
+			for ( int k = 0; k < 4; k++ )
+			{
+				w += infill.Factor[i][k] * ( 1.0f / 16.0f ) * grid[infill.Index[i][k]];
+			}
+			const float residual = ideal[i] - w;
+			for ( int k = 0; k < 4; k++ )
+			{
+				step[infill.Index[i][k]] += infill.Factor[i][k] * ( 1.0f / 16.0f ) * residual;
+			}
+		}
+		for ( int j = 0; j < numWeights; j++ )
+		{
+			if ( sumSq[j] > 0.0f )
+			{
+				grid[j] = Alg::Clamp( grid[j] + step[j] / sumSq[j], 0.0f, 64.0f );
+			}
+		}
+	}
+	for ( int j = 0; j < numWeights; j++ )
+	{
+		block.Levels[j] = AstcNearestWeightLevel( grid[j] );
+	}
+}
+
+static float AstcEvaluate( const ovrBlockTexels & texels, const ovrAstcMode & mode, const ovrAstcInfill & infill,
+		const ovrAstcBlock & block, float * weights )
+{
+	int u0[3];
+	int u1[3];
+	for ( int c = 0; c < 3; c++ )
+	{
+		u0[c] = AstcUnquantizeEndpoint( block.Q0[c], mode.EndpointBits );
+		u1[c] = AstcUnquantizeEndpoint( block.Q1[c], mode.EndpointBits );
+	}
+	AstcTexelWeights( infill, block.Levels, weights );
+	return AstcBlockError( texels, u0, u1, weights );
+}
+
+static void AstcSearchMode( const ovrBlockTexels & texels, const ovrAstcMode & mode, const ovrTextureEncodeQuality quality,
+		ovrAstcBlock & best )
+{
+	const int blockSize = texels.Width;
+	const ovrAstcInfill & infill = GetAstcInfill( blockSize, mode );
+	const int numTexels = infill.NumTexels;
+	const float * channels[3] = { texels.R, texels.G, texels.B };
+
+	// endpoints at the extents of the texels along their principal axis
+	float mean[3] = { 0.0f, 0.0f, 0.0f };
+	for ( int c = 0; c < 3; c++ )
+	{
+		for ( int i = 0; i < numTexels; i++ )
+		{
+			mean[c] += channels[c][i];
+		}
+		mean[c] /= numTexels;
+	}
+	float cov[3][3] = {};
+	for ( int i = 0; i < numTexels; i++ )
+	{
+		const float d[3] = { texels.R[i] - mean[0], texels.G[i] - mean[1], texels.B[i] - mean[2] };
+		for ( int a = 0; a < 3; a++ )
+		{
+			for ( int b = 0; b < 3; b++ )
+			{
+				cov[a][b] += d[a] * d[b];
+			}
+		}
+	}
+	float axis[3] = { 1.0f, 1.0f, 1.0f };
+	for ( int iteration = 0; iteration < 6; iteration++ )
+	{
+		float next[3];
+		for ( int a = 0; a < 3; a++ )
+		{
+			next[a] = cov[a][0] * axis[0] + cov[a][1] * axis[1] + cov[a][2] * axis[2];
+		}
+		const float length = sqrtf( next[0] * next[0] + next[1] * next[1] + next[2] * next[2] );
+		if ( length < 1e-6f )
+		{
+			break;
+		}
+		for ( int a = 0; a < 3; a++ )
+		{
+			axis[a] = next[a] / length;
+		}
+	}
+	float minT = FLT_MAX;
+	float maxT = -FLT_MAX;
+	for ( int i = 0; i < numTexels; i++ )
+	{
+		const float t = ( texels.R[i] - mean[0] ) * axis[0] + ( texels.G[i] - mean[1] ) * axis[1] + ( texels.B[i] - mean[2] ) * axis[2];
+		minT = Alg::Min( minT, t );
+		maxT = Alg::Max( maxT, t );
+	}
+	float e0[3];
+	float e1[3];
+	for ( int c = 0; c < 3; c++ )
+	{
+		e0[c] = Alg::Clamp( mean[c] + minT * axis[c], 0.0f, 255.0f );
+		e1[c] = Alg::Clamp( mean[c] + maxT * axis[c], 0.0f, 255.0f );
+	}
+
+	const int numIterations = ( quality == TEXTURE_ENCODE_FAST ) ? 1 : ( ( quality == TEXTURE_ENCODE_NORMAL ) ? 2 : 4 );
+	best.Error = FLT_MAX;
+	for ( int iteration = 0; iteration < numIterations; iteration++ )
+	{
+		ovrAstcBlock block;
+		AstcChooseWeights( texels, mode, infill, e0, e1, block );
+		float weights[MAX_BLOCK_TEXELS];
+		block.Error = AstcEvaluate( texels, mode, infill, block, weights );
+		if ( block.Error < best.Error )
+		{
+			best = block;
+		}
+		if ( block.Error == 0.0f || !AstcFitEndpoints( texels, weights, e0, e1 ) )
+		{
+			break;
+		}
+	}
+
+	if ( quality == TEXTURE_ENCODE_HIGH && best.Error > 0.0f )
+	{
+		// one pass of moving each grid weight by one level
+		const int numWeights = mode.GridWidth * mode.GridHeight;
+		float weights[MAX_BLOCK_TEXELS];
+		for ( int j = 0; j < numWeights; j++ )
+		{
+			const int original = best.Levels[j];
+			int bestLevel = original;
+			for ( int d = -1; d <= 1; d += 2 )
+			{
+				if ( original + d < 0 || original + d >= ASTC_NUM_WEIGHT_LEVELS )
+				{
+					continue;
+				}
+				best.Levels[j] = original + d;
+				const float error = AstcEvaluate( texels, mode, infill, best, weights );
+				if ( error < best.Error )
+				{
+					best.Error = error;
+					bestLevel = original + d;
+				}
+			}
+			best.Levels[j] = bestLevel;
+		}
+	}
+}
+
+static void AstcWriteBlock( const ovrAstcMode & mode, const ovrAstcBlock & block, uint8_t * out )
+{
+	int q0[3];
+	int q1[3];
+	int levels[MAX_BLOCK_TEXELS];
+	const int numWeights = mode.GridWidth * mode.GridHeight;
+	memcpy( q0, block.Q0, sizeof( q0 ) );
+	memcpy( q1, block.Q1, sizeof( q1 ) );
+	memcpy( levels, block.Levels, numWeights * sizeof( int ) );
+
+	// If the second endpoint sums lower than the first the decoder applies blue contraction,
+	// so swap the endpoints and mirror the weights, which decodes to the same colors.
+	const int sum0 = AstcUnquantizeEndpoint( q0[0], mode.EndpointBits ) + AstcUnquantizeEndpoint( q0[1], mode.EndpointBits ) + AstcUnquantizeEndpoint( q0[2], mode.EndpointBits );
+	const int sum1 = AstcUnquantizeEndpoint( q1[0], mode.EndpointBits ) + AstcUnquantizeEndpoint( q1[1], mode.EndpointBits ) + AstcUnquantizeEndpoint( q1[2], mode.EndpointBits );
+	if ( sum1 < sum0 )
+	{
+		for ( int c = 0; c < 3; c++ )
+		{
+			Alg::Swap( q0[c], q1[c] );
+		}
+		for ( int j = 0; j < numWeights; j++ )
+		{
+			levels[j] = ASTC_NUM_WEIGHT_LEVELS - 1 - levels[j];
+		}
+	}
+
+	memset( out, 0, 16 );
+	SetBits( out, 0, 11, mode.BlockMode );
+	SetBits( out, 11, 2, 0 );	// one partition
+	SetBits( out, 13, 4, ASTC_CEM_LDR_RGB_DIRECT );
+	int bit = 17;
+	for ( int c = 0; c < 3; c++ )
+	{
+		SetBits( out, bit, mode.EndpointBits, q0[c] );
+		bit += mode.EndpointBits;
+		SetBits( out, bit, mode.EndpointBits, q1[c] );
+		bit += mode.EndpointBits;
+	}
+
+	// the weights are stored bit reversed from the top of the block
+	uint8_t weightBits[16] = {};
+	for ( int j = 0; j < numWeights; j++ )
+	{
+		SetBits( weightBits, j * ASTC_WEIGHT_BITS, ASTC_WEIGHT_BITS, levels[j] );
+	}
+	for ( int i = 0; i < 16; i++ )
+	{
+		uint8_t b = weightBits[i];
+		b = (uint8_t)( ( ( b & 0xF0 ) >> 4 ) | ( ( b & 0x0F ) << 4 ) );
+		b = (uint8_t)( ( ( b & 0xCC ) >> 2 ) | ( ( b & 0x33 ) << 2 ) );
+		b = (uint8_t)( ( ( b & 0xAA ) >> 1 ) | ( ( b & 0x55 ) << 1 ) );
+		out[15 - i] |= b;
+	}
+}
+
+static void EncodeAstcBlock( const ovrBlockTexels & texels, const ovrTextureEncodeQuality quality, uint8_t * out )
+{
+	ovrAstcBlock best;
+	AstcSearchMode( texels, AstcMode4x4, quality, best );
+	const ovrAstcMode * bestMode = &AstcMode4x4;
+
+	// 6x6 blocks can trade endpoint precision for a finer weight grid
+	if ( texels.Width == 6 && quality != TEXTURE_ENCODE_FAST && best.Error > 0.0f )
+	{
+		ovrAstcBlock block;
+		AstcSearchMode( texels, AstcMode5x5, quality, block );
+		if ( block.Error < best.Error )
+		{
+			best = block;
+			bestMode = &AstcMode5x5;
+		}
+	}
+	AstcWriteBlock( *bestMode, best, out );
+}
+
+static void DecodeAstcBlock( const uint8_t * in, const int blockSize, uint8_t ( *colors )[3] )
+{
+	const int numTexels = blockSize * blockSize;
+	const int blockMode = GetBits( in, 0, 11 );
+	const ovrAstcMode * mode = ( blockMode == AstcMode4x4.BlockMode ) ? &AstcMode4x4 :
+			( ( blockMode == AstcMode5x5.BlockMode && blockSize == 6 ) ? &AstcMode5x5 : NULL );
+	if ( mode == NULL || GetBits( in, 11, 2 ) != 0 || GetBits( in, 13, 4 ) != (uint32_t)ASTC_CEM_LDR_RGB_DIRECT )
+	{
+		for ( int i = 0; i < numTexels; i++ )
+		{
+			colors[i][0] = 255;
+			colors[i][1] = 0;
+			colors[i][2] = 255;
+		}
+		return;
+	}
+
+	int v[6];
+	for ( int i = 0; i < 6; i++ )
+	{
+		v[i] = AstcUnquantizeEndpoint( GetBits( in, 17 + i * mode->EndpointBits, mode->EndpointBits ), mode->EndpointBits );
+	}
+	int e0[3];
+	int e1[3];
+	if ( v[1] + v[3] + v[5] >= v[0] + v[2] + v[4] )
+	{
+		for ( int c = 0; c < 3; c++ )
+		{
+			e0[c] = v[c * 2];
+			e1[c] = v[c * 2 + 1];
+		}
+	}
+	else
+	{
+		// blue contraction
+		e0[0] = ( v[1] + v[5] ) >> 1;
+		e0[1] = ( v[3] + v[5] ) >> 1;
+		e0[2] = v[5];
+		e1[0] = ( v[0] + v[4] ) >> 1;
+		e1[1] = ( v[2] + v[4] ) >> 1;
+		e1[2] = v[4];
+	}
+
+	uint8_t weightBits[16];
+	for ( int i = 0; i < 16; i++ )
+	{
+		uint8_t b = in[15 - i];
+		b = (uint8_t)( ( ( b & 0xF0 ) >> 4 ) | ( ( b & 0x0F ) << 4 ) );
+		b = (uint8_t)( ( ( b & 0xCC ) >> 2 ) | ( ( b & 0x33 ) << 2 ) );
+		b = (uint8_t)( ( ( b & 0xAA ) >> 1 ) | ( ( b & 0x55 ) << 1 ) );
+		weightBits[i] = b;
+	}
+	int levels[MAX_BLOCK_TEXELS];
+	for ( int j = 0; j < mode->GridWidth * mode->GridHeight; j++ )
+	{
+		levels[j] = GetBits( weightBits, j * ASTC_WEIGHT_BITS, ASTC_WEIGHT_BITS );
+	}
+	float weights[MAX_BLOCK_TEXELS];
+	AstcTexelWeights( GetAstcInfill( blockSize, *mode ), levels, weights );
+
+	for ( int i = 0; i < numTexels; i++ )
+	{
+		const int w = (int)weights[i];
+		for ( int c = 0; c < 3; c++ )
+		{
+			colors[i][c] = (uint8_t)( ( ( e0[c] * 257 * ( 64 - w ) + e1[c] * 257 * w + 32 ) >> 6 ) >> 8 );
+		}
+	}
+}
+
+static int GetEncoderBlockSize( const eTextureFormat format )
+{
+	switch ( format )
+	{
+		case Texture_ETC2_RGB:		return 4;
+		case Texture_ASTC_4x4:		return 4;
+		case Texture_ASTC_SRGB_4x4:	return 4;
+		case Texture_ASTC_6x6:		return 6;
+		case Texture_ASTC_SRGB_6x6:	return 6;
+		default:					return 0;
+	}
+}
+
+static int GetEncoderBlockBytes( const eTextureFormat format )
+{
+	return ( format == Texture_ETC2_RGB ) ? 8 : 16;
+}
+
+//==============================================================================================
+// ovrTextureEncoder
+//==============================================================================================
+
+ovrTextureEncoder::ovrTextureEncoder()
+	: Job( NULL )
+	, JobSequence( 0 )
+	, NumActiveWorkers( 0 )
+	, Exiting( false )
+{
+}
+
+ovrTextureEncoder::~ovrTextureEncoder()
+{
+	OVR_ASSERT( Threads.GetSizeI() == 0 );	// Shutdown() must be called
+}
+
+void ovrTextureEncoder::Init( const int numThreads )
+{
+	OVR_ASSERT( Threads.GetSizeI() == 0 );
+	Exiting = false;
+	for ( int i = 0; i < numThreads; i++ )
+	{
+		Thread::CreateParams createParams( ovrTextureEncoder::ThreadFn, this, 128 * 1024, -1,
+				Thread::Running, Thread::BelowNormalPriority );
+		Threads.PushBack( new Thread( createParams ) );
+	}
+}
+
+void ovrTextureEncoder::Shutdown()
+{
+	{
+		Mutex::Locker locker( &JobMutex );
+		Exiting = true;
+		JobWake.NotifyAll();
+	}
+	for ( int i = 0; i < Threads.GetSizeI(); i++ )
+	{
+		Threads[i]->Join();
+		delete Threads[i];
+	}
+	Threads.Clear();
+}
+
+bool ovrTextureEncoder::CanEncode( const eTextureFormat format )
+{
+	return GetEncoderBlockSize( format ) != 0;
+}
+
+size_t ovrTextureEncoder::GetEncodedSize( const eTextureFormat format, const int width, const int height )
+{
+	const int blockSize = GetEncoderBlockSize( format );
+	if ( blockSize == 0 )
+	{
+		return 0;
+	}
+	const size_t blocksX = ( width + blockSize - 1 ) / blockSize;
+	const size_t blocksY = ( height + blockSize - 1 ) / blockSize;
+	return blocksX * blocksY * GetEncoderBlockBytes( format );
+}
+
+threadReturn_t ovrTextureEncoder::ThreadFn( Thread * thread, void * data )
+{
+	ovrTextureEncoder * encoder = static_cast< ovrTextureEncoder * >( data );
+
+	thread->SetThreadName( "TextureEncoder" );
+
+	int lastSequence = 0;
+	for ( ; ; )
+	{
+		ovrEncodeJob * job = NULL;
+		{
+			Mutex::Locker locker( &encoder->JobMutex );
+			while ( !encoder->Exiting && ( encoder->Job == NULL || encoder->JobSequence == lastSequence ) )
+			{
+				encoder->JobWake.Wait( &encoder->JobMutex );
+			}
+			if ( encoder->Exiting )
+			{
+				break;
+			}
+			job = encoder->Job;
+			lastSequence = encoder->JobSequence;
+			encoder->NumActiveWorkers++;
+		}
+
+		encoder->EncodeRows( *job );
+
+		{
+			Mutex::Locker locker( &encoder->JobMutex );
+			if ( --encoder->NumActiveWorkers == 0 )
+			{
+				encoder->JobDone.NotifyAll();
+			}
+		}
+	}
+
+	return (threadReturn_t)0;
+}
+
+void ovrTextureEncoder::EncodeRows( ovrEncodeJob & job )
+{
+	const int blockSize = GetEncoderBlockSize( job.Format );
+	const int blockBytes = GetEncoderBlockBytes( job.Format );
+	const int blocksX = ( job.Width + blockSize - 1 ) / blockSize;
+	for ( ; ; )
+	{
+		const int row = job.NextRow.ExchangeAdd_Sync( 1 );
+		if ( row >= job.NumRows )
+		{
+			break;
+		}
+		uint8_t * out = job.Blocks + (size_t)row * blocksX * blockBytes;
+		for ( int bx = 0; bx < blocksX; bx++ )
+		{
+			ovrBlockTexels texels;
+			GetBlockTexels( job.Rgba, job.Width, job.Height, bx, row, blockSize, blockSize, texels );
+			if ( job.Format == Texture_ETC2_RGB )
+			{
+				EncodeEtc2Block( texels, job.Quality, out );
+			}
+			else
+			{
+				EncodeAstcBlock( texels, job.Quality, out );
+			}
+			out += blockBytes;
+		}
+	}
+}
+
+bool ovrTextureEncoder::Encode( const uint8_t * rgba, const int width, const int height,
+		const eTextureFormat format, const ovrTextureEncodeQuality quality, uint8_t * blocks )
+{
+	const int blockSize = GetEncoderBlockSize( format );
+	if ( blockSize == 0 || width <= 0 || height <= 0 )
+	{
+		OVR_WARN( "ovrTextureEncoder::Encode: can't encode format 0x%x", (int)format );
+		return false;
+	}
+
+	Mutex::Locker encodeLocker( &EncodeMutex );
+
+	ovrEncodeJob job;
+	job.Rgba = rgba;
+	job.Width = width;
+	job.Height = height;
+	job.Format = format;
+	job.Quality = quality;
+	job.Blocks = blocks;
+	job.NumRows = ( height + blockSize - 1 ) / blockSize;
+	job.NextRow = 0;
+
+	{
+		Mutex::Locker locker( &JobMutex );
+		Job = &job;
+		JobSequence++;
+		JobWake.NotifyAll();
+	}
+
+	EncodeRows( job );
+
+	// every row has been taken, wait for the workers that are still encoding one
+	{
+		Mutex::Locker locker( &JobMutex );
+		while ( NumActiveWorkers > 0 )
+		{
+			JobDone.Wait( &JobMutex );
+		}
+		Job = NULL;
+	}
+	return true;
+}
+
+bool ovrTextureEncoder::EncodeMipChain( const uint8_t * rgba, const int width, const int height, const int numLevels,
+		const eTextureFormat format, const bool useSrgb, const ovrTextureEncodeQuality quality,
+		ovrDecodedTexture & encoded )
+{
+	if ( !CanEncode( format ) )
+	{
+		return false;
+	}
+
+	// QuarterImageSize() needs at least 2x2 texels
+	int levels = 1;
+	while ( levels < numLevels && levels < ovrDecodedTexture::MAX_LEVELS &&
+			Alg::Min( width >> ( levels - 1 ), height >> ( levels - 1 ) ) >= 2 )
+	{
+		levels++;
+	}
+
+	encoded.Format = format;
+	encoded.UseSrgb = useSrgb;
+	encoded.Width = width;
+	encoded.Height = height;
+	encoded.NumLevels = levels;
+	size_t totalSize = 0;
+	for ( int level = 0; level < levels; level++ )
+	{
+		encoded.LevelOffset[level] = totalSize;
+		encoded.LevelSize[level] = GetEncodedSize( format, encoded.GetLevelWidth( level ), encoded.GetLevelHeight( level ) );
+		totalSize += encoded.LevelSize[level];
+	}
+	encoded.Data.Realloc( totalSize );
+
+	const uint8_t * src = rgba;
+	unsigned char * quartered = NULL;
+	for ( int level = 0; level < levels; level++ )
+	{
+		const int w = encoded.GetLevelWidth( level );
+		const int h = encoded.GetLevelHeight( level );
+		if ( level > 0 )
+		{
+			unsigned char * next = QuarterImageSize( src, encoded.GetLevelWidth( level - 1 ), encoded.GetLevelHeight( level - 1 ), useSrgb );
+			free( quartered );
+			quartered = next;
+			src = quartered;
+		}
+		Encode( src, w, h, format, quality, static_cast< uint8_t * >( encoded.Data ) + encoded.LevelOffset[level] );
+	}
+	free( quartered );
+	return true;
+}
+
+void DecodeTextureBlocks( const uint8_t * blocks, const int width, const int height,
+		const eTextureFormat format, uint8_t * rgba )
+{
+	const int blockSize = GetEncoderBlockSize( format );
+	if ( blockSize == 0 )
+	{
+		return;
+	}
+	const int blockBytes = GetEncoderBlockBytes( format );
+	const int blocksX = ( width + blockSize - 1 ) / blockSize;
+	const int blocksY = ( height + blockSize - 1 ) / blockSize;
+	for ( int by = 0; by < blocksY; by++ )
+	{
+		for ( int bx = 0; bx < blocksX; bx++ )
+		{
+			const uint8_t * in = blocks + ( (size_t)by * blocksX + bx ) * blockBytes;
+			uint8_t colors[MAX_BLOCK_TEXELS][3];
+			if ( format == Texture_ETC2_RGB )
+			{
+				DecodeEtc2Block( in, colors );
+			}
+			else
+			{
+				DecodeAstcBlock( in, blockSize, colors );
+			}
+			StoreBlockTexels( colors, bx, by, blockSize, blockSize, width, height, rgba );
+		}
+	}
+}
+
+} // namespace OVR
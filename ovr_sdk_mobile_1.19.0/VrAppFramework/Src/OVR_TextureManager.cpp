@@ -18,7 +18,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_String.h"
 #include "Kernel/OVR_Array.h"
 #include "Kernel/OVR_LogUtils.h"
-#include "Kernel/OVR_Hash.h"
+#include "Kernel/OVR_StringHash.h"
 
 #include "OVR_FileSys.h"
 #include "PackageFiles.h"
@@ -49,33 +49,6 @@ void ovrManagedTexture::Free()
 // ovrTextureManagerImpl
 //==============================================================================================
 
-// DJB2 string hash function
-static unsigned long DJB2Hash( char const * str )
-{
-    unsigned long hash = 5381;
-    int c;
-
-	for ( c = *str; c != 0; str++, c = *str )
-    //while ( c = *str++ )
-	{
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
-	}
-    return hash;
-}
-
-//==============================================================
-// Hash functor for OVR::String
-
-template< class C >
-class ovrUriHash
-{
-public:
-	UPInt operator()( const C & data ) const 
-	{
-		return DJB2Hash( data.ToCStr() );
-	}
-};
-
 //==============================================================
 // ovrTextureManagerImpl
 class ovrTextureManagerImpl : public ovrTextureManager
@@ -117,7 +90,7 @@ private:
 	bool						Initialized;
 
 #if defined( USE_HASH )
-	OVR::Hash< String, int, ovrUriHash< String > >	UriHash;
+	StringHash< int >			UriHash;
 #endif
 
 	mutable int					NumUriLoads;
@@ -475,7 +448,7 @@ void ovrTextureManagerImpl::FreeTexture( textureHandle_t const handle )
 	if ( idx >= 0 )
 	{
 #if defined( USE_HASH )
-		if ( Textures[idx].GetUri().IsEmpty() )
+		if ( !Textures[idx].GetUri().IsEmpty() )
 		{
 			UriHash.Remove( Textures[idx].GetUri() );
 		}
@@ -505,7 +478,7 @@ int ovrTextureManagerImpl::FindTextureIndex( char const * uri ) const
 
 #if defined( USE_HASH )
 	int index = -1;
-	if ( UriHash.Get( String( uri ), &index ) )
+	if ( UriHash.Get( uri, &index ) )
 	{
 		return index;
 	}
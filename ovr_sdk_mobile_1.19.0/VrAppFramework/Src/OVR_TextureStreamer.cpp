@@ -0,0 +1,493 @@
+/************************************************************************************
+
+Filename    :   OVR_TextureStreamer.cpp
+Content     :   Decodes textures on worker threads and uploads them under a per-frame budget.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "OVR_TextureStreamer.h"
+
+#include "Kernel/OVR_LogUtils.h"
+#include "OVR_GlUtils.h"
+#include "SystemClock.h"
+
+namespace OVR {
+
+//==============================================================================================
+// ovrTextureUploaderGl
+//==============================================================================================
+
+GLuint ovrTextureUploaderGl::CreateTexture( const bool mipmapped )
+{
+	GLuint texId;
+	glGenTextures( 1, &texId );
+	glBindTexture( GL_TEXTURE_2D, texId );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+	return texId;
+}
+
+void ovrTextureUploaderGl::DeleteTexture( const GLuint texture )
+{
+	glDeleteTextures( 1, &texture );
+}
+
+void ovrTextureUploaderGl::DefineLevel( const GLuint texture, const int level, const eTextureFormat format, const bool useSrgb,
+		const int width, const int height, const void * data, const size_t dataSize )
+{
+	GLenum glFormat;
+	GLenum glInternalFormat;
+	if ( !TextureFormatToGlFormat( format, useSrgb, glFormat, glInternalFormat ) )
+	{
+		return;
+	}
+
+	glBindTexture( GL_TEXTURE_2D, texture );
+	if ( IsCompressedTextureFormat( format ) )
+	{
+		glCompressedTexImage2D( GL_TEXTURE_2D, level, glInternalFormat, width, height, 0, static_cast< GLsizei >( dataSize ), data );
+	}
+	else
+	{
+		glTexImage2D( GL_TEXTURE_2D, level, glInternalFormat, width, height, 0, glFormat, GL_UNSIGNED_BYTE, data );
+	}
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+void ovrTextureUploaderGl::UploadRows( const GLuint texture, const int level, const eTextureFormat format, const bool useSrgb,
+		const int y, const int width, const int height, const void * data )
+{
+	GLenum glFormat;
+	GLenum glInternalFormat;
+	if ( !TextureFormatToGlFormat( format, useSrgb, glFormat, glInternalFormat ) )
+	{
+		return;
+	}
+
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glTexSubImage2D( GL_TEXTURE_2D, level, 0, y, width, height, glFormat, GL_UNSIGNED_BYTE, data );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+void ovrTextureUploaderGl::SetLevelRange( const GLuint texture, const int baseLevel, const int maxLevel )
+{
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+double ovrTextureUploaderGl::GetTimeInSeconds() const
+{
+	return SystemClock::GetTimeInSeconds();
+}
+
+//==============================================================================================
+// ovrTextureStreamer
+//==============================================================================================
+
+ovrTextureStreamer::ovrTextureStreamer()
+	: Uploader( NULL )
+	, BytesPerFrame( 2 * 1024 * 1024 )
+	, SecondsPerFrame( 0.002 )
+	, LastUpdateBytes( 0 )
+	, LastUpdateSeconds( 0.0 )
+	, NextSequence( 0 )
+	, Exiting( false )
+{
+}
+
+ovrTextureStreamer::~ovrTextureStreamer()
+{
+	OVR_ASSERT( Threads.GetSizeI() == 0 );	// Shutdown() must be called
+}
+
+void ovrTextureStreamer::Init( ovrTextureUploader * uploader, const int numThreads )
+{
+	OVR_ASSERT( Threads.GetSizeI() == 0 );
+
+	Uploader = ( uploader != NULL ) ? uploader : &GlUploader;
+	Exiting = false;
+
+	for ( int i = 0; i < numThreads; i++ )
+	{
+		Thread::CreateParams createParams( ovrTextureStreamer::ThreadFn, this, 128 * 1024, -1,
+				Thread::Running, Thread::BelowNormalPriority );
+		Threads.PushBack( new Thread( createParams ) );
+	}
+}
+
+void ovrTextureStreamer::Shutdown()
+{
+	{
+		Mutex::Locker locker( &QueueMutex );
+		Exiting = true;
+		QueueWake.NotifyAll();
+	}
+
+	for ( int i = 0; i < Threads.GetSizeI(); i++ )
+	{
+		Threads[i]->Join();
+		delete Threads[i];
+	}
+	Threads.Clear();
+
+	// Textures that were freed while they were being decoded are only in Decoded,
+	// every other one is in Loading.
+	for ( int i = 0; i < Decoded.GetSizeI(); i++ )
+	{
+		if ( Decoded[i]->Cancelled )
+		{
+			delete Decoded[i]->Decoded;
+			delete Decoded[i];
+		}
+	}
+	for ( int i = 0; i < Loading.GetSizeI(); i++ )
+	{
+		delete Loading[i]->Decoded;
+		delete Loading[i];
+	}
+	Loading.Clear();
+	Ready.Clear();
+	DecodeQueue.Clear();
+	Decoded.Clear();
+}
+
+void ovrTextureStreamer::SetBudget( const size_t bytesPerFrame, const double secondsPerFrame )
+{
+	BytesPerFrame = bytesPerFrame;
+	SecondsPerFrame = secondsPerFrame;
+}
+
+GlTexture ovrTextureStreamer::LoadTexture( const char * fileName, MemBufferT< uint8_t > & buffer, const TextureFlags_t & flags )
+{
+	int width = 0;
+	int height = 0;
+	bool isStreamable = false;
+	if ( !GetTextureSizeFromBuffer( fileName, buffer, buffer.GetSize(), width, height, isStreamable ) || !isStreamable )
+	{
+		return LoadTextureFromBuffer( fileName, MemBuffer( buffer, static_cast< int >( buffer.GetSize() ) ), flags, width, height );
+	}
+	return Queue( fileName, buffer, width, height, false, flags );
+}
+
+GlTexture ovrTextureStreamer::LoadRGBATexture( MemBufferT< uint8_t > & pixels, const int width, const int height,
+		const TextureFlags_t & flags )
+{
+	OVR_ASSERT( pixels.GetSize() >= static_cast< size_t >( width * height * 4 ) );
+	return Queue( "RGBA", pixels, width, height, true, flags );
+}
+
+GlTexture ovrTextureStreamer::Queue( const char * fileName, MemBufferT< uint8_t > & buffer, const int width, const int height,
+		const bool isRGBA, const TextureFlags_t & flags )
+{
+	ovrStreamingTexture * st = new ovrStreamingTexture();
+	st->Texture = Uploader->CreateTexture( ( flags & TEXTUREFLAG_NO_MIPMAPS ) == 0 );
+	st->Sequence = NextSequence++;
+	st->FileName = fileName;
+	st->Buffer = buffer;
+	st->Width = isRGBA ? width : 0;
+	st->Height = isRGBA ? height : 0;
+	st->Flags = flags;
+	st->Decoded = NULL;
+	st->NextLevel = 0;
+	st->NextRow = 0;
+	st->Cancelled = false;
+	Loading.PushBack( st );
+
+	{
+		Mutex::Locker locker( &QueueMutex );
+		DecodeQueue.PushBack( st );
+		QueueWake.Notify();
+	}
+
+	return GlTexture( st->Texture, GL_TEXTURE_2D, width, height );
+}
+
+void ovrTextureStreamer::FreeTexture( GlTexture & texture )
+{
+	if ( !texture.IsValid() )
+	{
+		return;
+	}
+
+	for ( int i = 0; i < Loading.GetSizeI(); i++ )
+	{
+		ovrStreamingTexture * st = Loading[i];
+		if ( st->Texture != texture.texture )
+		{
+			continue;
+		}
+		Loading.RemoveAt( i );
+
+		bool isReady = false;
+		for ( int j = 0; j < Ready.GetSizeI(); j++ )
+		{
+			if ( Ready[j] == st )
+			{
+				Ready.RemoveAt( j );
+				isReady = true;
+				break;
+			}
+		}
+
+		bool canDelete = isReady;
+		if ( !isReady )
+		{
+			Mutex::Locker locker( &QueueMutex );
+			for ( int j = 0; j < DecodeQueue.GetSizeI(); j++ )
+			{
+				if ( DecodeQueue[j] == st )
+				{
+					DecodeQueue.RemoveAt( j );
+					canDelete = true;
+					break;
+				}
+			}
+			// a worker has it, or it is waiting in Decoded, so it is deleted in CollectDecoded()
+			st->Cancelled = !canDelete;
+		}
+		if ( canDelete )
+		{
+			delete st->Decoded;
+			delete st;
+		}
+		break;
+	}
+
+	Uploader->DeleteTexture( texture.texture );
+	texture = GlTexture();
+}
+
+bool ovrTextureStreamer::IsLoading( const GlTexture & texture ) const
+{
+	for ( int i = 0; i < Loading.GetSizeI(); i++ )
+	{
+		if ( Loading[i]->Texture == texture.texture )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+threadReturn_t ovrTextureStreamer::ThreadFn( Thread * thread, void * data )
+{
+	ovrTextureStreamer * streamer = static_cast< ovrTextureStreamer * >( data );
+
+	thread->SetThreadName( "TextureStreamer" );
+
+	for ( ; ; )
+	{
+		ovrStreamingTexture * st = NULL;
+		{
+			Mutex::Locker locker( &streamer->QueueMutex );
+			while ( streamer->DecodeQueue.GetSizeI() == 0 && !streamer->Exiting )
+			{
+				streamer->QueueWake.Wait( &streamer->QueueMutex );
+			}
+			if ( streamer->Exiting )
+			{
+				break;
+			}
+			st = streamer->DecodeQueue[0];
+			streamer->DecodeQueue.RemoveAt( 0 );
+		}
+
+		ovrDecodedTexture * decoded = new ovrDecodedTexture();
+		const bool isDecoded = ( st->Width > 0 ) ?
+				DecodeTextureFromRGBA( st->Buffer, st->Width, st->Height, st->Flags, *decoded ) :
+				DecodeTextureFromBuffer( st->FileName.ToCStr(), st->Buffer, st->Buffer.GetSize(), st->Flags, *decoded );
+		if ( !isDecoded )
+		{
+			delete decoded;
+			decoded = NULL;
+		}
+
+		{
+			Mutex::Locker locker( &streamer->QueueMutex );
+			MemBufferT< uint8_t > empty;
+			st->Buffer = empty;
+			st->Decoded = decoded;
+			streamer->Decoded.PushBack( st );
+		}
+	}
+
+	return (threadReturn_t)0;
+}
+
+void ovrTextureStreamer::CollectDecoded()
+{
+	Array< ovrStreamingTexture * > decoded;
+	{
+		Mutex::Locker locker( &QueueMutex );
+		if ( Decoded.GetSizeI() == 0 )
+		{
+			return;
+		}
+		decoded.Append( Decoded.GetDataPtr(), Decoded.GetSize() );
+		Decoded.Clear();
+	}
+
+	for ( int i = 0; i < decoded.GetSizeI(); i++ )
+	{
+		ovrStreamingTexture * st = decoded[i];
+		if ( st->Cancelled )
+		{
+			delete st->Decoded;
+			delete st;
+		}
+		else if ( st->Decoded == NULL )
+		{
+			// the texture stays incomplete
+			OVR_WARN( "Failed to load %s", st->FileName.ToCStr() );
+			Finish( st );
+		}
+		else
+		{
+			st->NextLevel = st->Decoded->NumLevels - 1;
+			st->NextRow = 0;
+			Ready.PushBack( st );
+		}
+	}
+}
+
+ovrTextureStreamer::ovrStreamingTexture * ovrTextureStreamer::NextToUpload() const
+{
+	// Finish a level that was split over frames before starting another. Otherwise the
+	// smallest level of all goes first, so every texture gets its mip tail before any
+	// texture gets its full resolution levels.
+	ovrStreamingTexture * best = NULL;
+	for ( int i = 0; i < Ready.GetSizeI(); i++ )
+	{
+		ovrStreamingTexture * st = Ready[i];
+		if ( st->NextRow > 0 )
+		{
+			return st;
+		}
+		if ( best == NULL )
+		{
+			best = st;
+			continue;
+		}
+		const size_t size = st->Decoded->LevelSize[st->NextLevel];
+		const size_t bestSize = best->Decoded->LevelSize[best->NextLevel];
+		if ( size < bestSize || ( size == bestSize && st->Sequence < best->Sequence ) )
+		{
+			best = st;
+		}
+	}
+	return best;
+}
+
+size_t ovrTextureStreamer::UploadNext( ovrStreamingTexture * st, const size_t remainingBytes, const bool mustUpload )
+{
+	const ovrDecodedTexture & decoded = *st->Decoded;
+	const int level = st->NextLevel;
+	const int width = decoded.GetLevelWidth( level );
+	const int height = decoded.GetLevelHeight( level );
+	const size_t levelSize = decoded.LevelSize[level];
+	const uint8_t * levelData = decoded.GetLevelData( level );
+	const bool isCompressed = IsCompressedTextureFormat( decoded.Format );
+
+	size_t uploaded = 0;
+	if ( st->NextRow == 0 && ( levelSize <= remainingBytes || ( mustUpload && isCompressed ) ) )
+	{
+		Uploader->DefineLevel( st->Texture, level, decoded.Format, decoded.UseSrgb, width, height, levelData, levelSize );
+		uploaded = levelSize;
+		st->NextRow = height;
+	}
+	else if ( !isCompressed )
+	{
+		const size_t rowSize = levelSize / height;
+		int numRows = Alg::Min( static_cast< int >( remainingBytes / rowSize ), height - st->NextRow );
+		if ( numRows == 0 )
+		{
+			if ( !mustUpload )
+			{
+				return 0;
+			}
+			numRows = 1;
+		}
+		if ( st->NextRow == 0 )
+		{
+			Uploader->DefineLevel( st->Texture, level, decoded.Format, decoded.UseSrgb, width, height, NULL, 0 );
+		}
+		Uploader->UploadRows( st->Texture, level, decoded.Format, decoded.UseSrgb, st->NextRow, width, numRows,
+				levelData + st->NextRow * rowSize );
+		uploaded = numRows * rowSize;
+		st->NextRow += numRows;
+	}
+	else
+	{
+		return 0;
+	}
+
+	if ( st->NextRow == height )
+	{
+		// start sampling the new level
+		Uploader->SetLevelRange( st->Texture, level, decoded.NumLevels - 1 );
+		st->NextRow = 0;
+		st->NextLevel--;
+		if ( st->NextLevel < 0 )
+		{
+			Finish( st );
+		}
+	}
+	return uploaded;
+}
+
+void ovrTextureStreamer::Finish( ovrStreamingTexture * st )
+{
+	for ( int i = 0; i < Ready.GetSizeI(); i++ )
+	{
+		if ( Ready[i] == st )
+		{
+			Ready.RemoveAt( i );
+			break;
+		}
+	}
+	for ( int i = 0; i < Loading.GetSizeI(); i++ )
+	{
+		if ( Loading[i] == st )
+		{
+			Loading.RemoveAt( i );
+			break;
+		}
+	}
+	delete st->Decoded;
+	delete st;
+}
+
+void ovrTextureStreamer::Update()
+{
+	CollectDecoded();
+
+	const double start = Uploader->GetTimeInSeconds();
+	size_t bytes = 0;
+	while ( Ready.GetSizeI() > 0 && bytes < BytesPerFrame )
+	{
+		const size_t uploaded = UploadNext( NextToUpload(), BytesPerFrame - bytes, bytes == 0 );
+		if ( uploaded == 0 )
+		{
+			break;
+		}
+		bytes += uploaded;
+		if ( Uploader->GetTimeInSeconds() - start >= SecondsPerFrame )
+		{
+			break;
+		}
+	}
+
+	LastUpdateBytes = bytes;
+	LastUpdateSeconds = Uploader->GetTimeInSeconds() - start;
+}
+
+} // namespace OVR
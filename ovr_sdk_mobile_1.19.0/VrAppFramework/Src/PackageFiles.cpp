@@ -12,6 +12,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "PackageFiles.h"
 
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Array.h"
 #include "Kernel/OVR_LogUtils.h"
 #include "Kernel/OVR_String.h"
 #include "Kernel/OVR_Threads.h"
@@ -26,6 +28,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #endif
 #include "ScopedMutex.h"
 
+#include <atomic>
+
 namespace OVR
 {
 
@@ -112,6 +116,42 @@ bool ovr_OtherPackageFileExists( void* zipFile, const char * nameInZip )
 	return true;
 }
 
+bool ovr_GetStoredFileRangeInPackage( void * zipFile, const char * nameInZip, size_t & offset, size_t & length )
+{
+	if ( zipFile == 0 )
+	{
+		return false;
+	}
+
+	ovrScopedMutex mutex( PackageFileMutex );
+
+	if ( unzLocateFile( zipFile, nameInZip, 2 /* case insensitive */ ) != UNZ_OK )
+	{
+		return false;
+	}
+
+	unz_file_info info;
+	if ( unzGetCurrentFileInfo( zipFile, &info, NULL, 0, NULL, 0, NULL, 0 ) != UNZ_OK )
+	{
+		return false;
+	}
+	// encrypted files are also not stored as is
+	if ( info.compression_method != 0 || ( info.flag & 1 ) != 0 )
+	{
+		return false;
+	}
+
+	// the data starts after the local header, which is only read when the file is opened
+	if ( unzOpenCurrentFile( zipFile ) != UNZ_OK )
+	{
+		return false;
+	}
+	offset = (size_t)unzGetCurrentFileZStreamPos64( zipFile );
+	length = info.uncompressed_size;
+	unzCloseCurrentFile( zipFile );
+	return true;
+}
+
 static bool ovr_ReadFileFromOtherApplicationPackageInternal( void * zipFile, const char * nameInZip, int & length, void * & buffer, const bool useMalloc )
 {
 	auto allocBuffer = [] ( const size_t size, const bool useMalloc )
@@ -220,7 +260,13 @@ static bool ovr_ReadFileFromOtherApplicationPackageInternal( void * zipFile, con
 	length = info.uncompressed_size;
 	buffer = allocBuffer( length, useMalloc );
 
-	const int readRet = unzReadCurrentFile( zipFile, buffer, length );
+	// The bulk read inflates straight into the buffer and checks the CRC once; it does not
+	// take every compression method, so fall back to the chunked read for the rest.
+	int readRet = unzReadCurrentFileBulk( zipFile, buffer, length );
+	if ( readRet == UNZ_PARAMERROR )
+	{
+		readRet = unzReadCurrentFile( zipFile, buffer, length );
+	}
 	if ( readRet != length )
 	{
 		OVR_WARN( "Error reading file '%s' from apk!", nameInZip );
@@ -289,6 +335,153 @@ bool ovr_ReadFileFromOtherApplicationPackage( void * zipFile, const char * nameI
 	return ovr_ReadFileFromOtherApplicationPackageInternal( zipFile, nameInZip, length, buffer, true );
 }
 
+//==============================================================
+// ovrPackageDecodeJobs
+// The files of ovr_ReadFilesFromOtherApplicationPackage() that are read but not yet
+// decompressed. Workers take the next job with an atomic add.
+//==============================================================
+struct ovrPackageDecodeJob
+{
+	ovrPackageFileRead *	File;
+	uint8_t *				Compressed;		// File->Buffer for stored files
+	uLong					CompressedSize;
+	int						Method;
+	uLong					Crc;
+};
+
+struct ovrPackageDecodeJobs
+{
+	ovrPackageDecodeJobs() : NextJob( 0 ), Failed( false ) {}
+
+	Array< ovrPackageDecodeJob >	Jobs;
+	std::atomic< int >				NextJob;
+	std::atomic< bool >				Failed;
+
+	void	Decode()
+	{
+		for ( ; ; )
+		{
+			const int index = NextJob.fetch_add( 1, std::memory_order_relaxed );
+			if ( index >= Jobs.GetSizeI() )
+			{
+				return;
+			}
+			ovrPackageDecodeJob & job = Jobs[index];
+			const int ret = unzDecompressBuffer( job.Compressed, job.CompressedSize,
+											(uint8_t *)job.File->Buffer, job.File->Buffer.GetSize(), job.Method, job.Crc );
+			if ( job.Compressed != (uint8_t *)job.File->Buffer )
+			{
+				delete [] job.Compressed;
+			}
+			job.Compressed = NULL;
+			if ( ret != UNZ_OK )
+			{
+				OVR_WARN( "Error %i decompressing file '%s' from apk!", ret, job.File->NameInZip );
+				job.File->Buffer.Realloc( 0 );
+				Failed.store( true, std::memory_order_relaxed );
+			}
+		}
+	}
+
+	static threadReturn_t ThreadFn( Thread * thread, void * data )
+	{
+		thread->SetThreadName( "PackageDecode" );
+		static_cast< ovrPackageDecodeJobs * >( data )->Decode();
+		return (threadReturn_t)0;
+	}
+};
+
+bool ovr_ReadFilesFromOtherApplicationPackage( void * zipFile, ovrPackageFileRead * files, const int numFiles, const int numThreads )
+{
+	for ( int i = 0; i < numFiles; i++ )
+	{
+		files[i].Buffer.Realloc( 0 );
+	}
+	if ( zipFile == 0 )
+	{
+		return false;
+	}
+
+	ovrPackageDecodeJobs decode;
+	decode.Jobs.Reserve( numFiles );
+	bool readAll = true;
+
+	// Only the reads of the compressed data go through the zip file.
+	{
+		ovrScopedMutex mutex( PackageFileMutex );
+
+		for ( int i = 0; i < numFiles; i++ )
+		{
+			ovrPackageFileRead & file = files[i];
+			if ( unzLocateFile( zipFile, file.NameInZip, 2 /* case insensitive */ ) != UNZ_OK )
+			{
+				OVR_LOG( "File '%s' not found in apk!", file.NameInZip );
+				readAll = false;
+				continue;
+			}
+
+			unz_file_info info;
+			if ( unzGetCurrentFileInfo( zipFile, &info, NULL, 0, NULL, 0, NULL, 0 ) != UNZ_OK ||
+					( info.flag & 1 ) != 0 )
+			{
+				OVR_WARN( "File info error reading '%s' from apk!", file.NameInZip );
+				readAll = false;
+				continue;
+			}
+
+			int method = 0;
+			int level = 0;
+			if ( unzOpenCurrentFile2( zipFile, &method, &level, 1 /* raw */ ) != UNZ_OK )
+			{
+				OVR_WARN( "Error opening file '%s' from apk!", file.NameInZip );
+				readAll = false;
+				continue;
+			}
+
+			file.Buffer.Realloc( info.uncompressed_size );
+			ovrPackageDecodeJob job;
+			job.File = &file;
+			job.Compressed = ( method == 0 ) ? (uint8_t *)file.Buffer : new uint8_t[info.compressed_size];
+			job.CompressedSize = info.compressed_size;
+			job.Method = method;
+			job.Crc = info.crc;
+
+			const int readRet = ( info.compressed_size > 0 ) ? unzReadCurrentFile( zipFile, job.Compressed, info.compressed_size ) : 0;
+			unzCloseCurrentFile( zipFile );
+			if ( readRet != (int)info.compressed_size )
+			{
+				OVR_WARN( "Error reading file '%s' from apk!", file.NameInZip );
+				if ( job.Compressed != (uint8_t *)file.Buffer )
+				{
+					delete [] job.Compressed;
+				}
+				file.Buffer.Realloc( 0 );
+				readAll = false;
+				continue;
+			}
+			decode.Jobs.PushBack( job );
+		}
+	}
+
+	// Stored files are only checked against their CRC, the rest are inflated.
+	const int numWorkers = Alg::Min( numThreads, decode.Jobs.GetSizeI() - 1 );
+	Array< Thread * > threads;
+	for ( int i = 0; i < numWorkers; i++ )
+	{
+		Thread::CreateParams createParams( ovrPackageDecodeJobs::ThreadFn, &decode, 128 * 1024, -1,
+				Thread::Running, Thread::NormalPriority );
+		threads.PushBack( new Thread( createParams ) );
+	}
+	decode.Decode();
+	for ( int i = 0; i < threads.GetSizeI(); i++ )
+	{
+		threads[i]->Join();
+		delete threads[i];
+	}
+
+	return readAll && !decode.Failed.load( std::memory_order_relaxed );
+}
+
 //--------------------------------------------------------------
 // Functions for reading assets from this process's application package
 //--------------------------------------------------------------
@@ -323,6 +516,11 @@ bool ovr_ReadFileFromApplicationPackage( const char * nameInZip, int & length, v
 	return ovr_ReadFileFromOtherApplicationPackage( packageZipFile, nameInZip, length, buffer );
 }
 
+bool ovr_ReadFilesFromApplicationPackage( ovrPackageFileRead * files, const int numFiles, const int numThreads )
+{
+	return ovr_ReadFilesFromOtherApplicationPackage( packageZipFile, files, numFiles, numThreads );
+}
+
 bool ovr_ReadFileFromApplicationPackage( const char * nameInZip, MemBufferFile & memBufferFile )
 {
 	memBufferFile.FreeData();
@@ -580,7 +580,8 @@ ovrDrawCounters ovrSurfaceRender::RenderSurfaceList( const Array<ovrDrawSurface>
 				if ( cmd.Program.uJoints != -1 )
 				{
 					OVR_ASSERT( cmd.Program.uJointsBinding != -1 );
-					const GLuint bufferObj = cmd.uniformJoints.GetBuffer();
+					const GlBuffer & joints = ( drawSurface.joints != NULL ) ? *drawSurface.joints : cmd.uniformJoints;
+					const GLuint bufferObj = joints.GetBuffer();
 					if ( currentBuffers[cmd.Program.uJointsBinding] != bufferObj )
 					{
 						counters.numBufferBinds++;
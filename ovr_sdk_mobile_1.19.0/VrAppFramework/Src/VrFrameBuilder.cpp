@@ -11,7 +11,6 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "VrFrameBuilder.h"
 #include "Kernel/OVR_LogUtils.h"
-#include "Android/JniUtils.h"
 #include "Kernel/OVR_Alg.h"
 #include "VrApi.h"
 #include "VrApi_Input.h"
@@ -19,10 +18,6 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_String.h"
 #include "OVR_Input.h"
 
-#if defined ( OVR_OS_ANDROID )
-#include <android/input.h>
-#endif
-
 namespace OVR
 {
 
@@ -70,6 +65,7 @@ static struct
 static ovrHeadSetPluggedState HeadPhonesPluggedState = OVR_HEADSET_PLUGGED_UNKNOWN;
 
 VrFrameBuilder::VrFrameBuilder() :
+	JoySticks(),
 	lastTouchpadTime( 0.0 ),
 	touchpadTimer( 0.0 ),
 	lastTouchDown( false ),
@@ -97,7 +93,8 @@ void VrFrameBuilder::InterpretTouchpad( VrInput & input, const double currentTim
 	static const double timer_finger_down = 0.3;
 	static const double timer_finger_up = 0.3;
 
-	const double deltaTime = currentTime - lastTouchpadTime;
+	// The time comes from the input devices, which may lag the previous frame's time.
+	const double deltaTime = Alg::Max( currentTime - lastTouchpadTime, 0.0 );
 	lastTouchpadTime = currentTime;
 	touchpadTimer = touchpadTimer + deltaTime;
 
@@ -227,7 +224,8 @@ void VrFrameBuilder::InterpretTouchpad( VrInput & input, const double currentTim
 	}
 }
 
-void VrFrameBuilder::AddKeyEventToFrame( ovrKeyCode const keyCode, KeyEventType const eventType, int const repeatCount )
+void VrFrameBuilder::AddKeyEventToFrame( ovrKeyCode const keyCode, KeyEventType const eventType, int const repeatCount,
+		double const timeInSeconds )
 {
 	if ( eventType == KEY_EVENT_NONE )
 	{
@@ -239,15 +237,17 @@ void VrFrameBuilder::AddKeyEventToFrame( ovrKeyCode const keyCode, KeyEventType
 	vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].KeyCode = keyCode;
 	vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].RepeatCount = repeatCount;
 	vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].EventType = eventType;
+	vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].TimeInSeconds = timeInSeconds;
 	vrFrame.Input.NumKeyEvents++;
 }
 
-void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobile * ovr,
+void VrFrameBuilder::AdvanceVrFrame( ovrInputEventRing & inputEvents, ovrMobile * ovr,
 									const ovrJava & java,
 									const ovrTrackingTransform trackingTransform,
 									const long long enteredVrModeFrameNumber )
 {
 	const VrInput lastVrInput = vrFrame.Input;
+	const double currentTime = vrapi_GetTimeInSeconds();
 
 	// check before incrementing FrameNumber because it will be the previous frame's number
 	vrFrame.EnteredVrMode = vrFrame.FrameNumber == enteredVrModeFrameNumber;
@@ -260,15 +260,48 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 
 	float touchpadMinSwipe = 100.0f;
 
+	// Drain the input events. Only the latest joystick event matters, and key events that
+	// do not fit in this frame stay queued, in order, for the next one.
+	vrFrame.Input.NumKeyEvents = 0;
+	for ( const ovrInputEvent * event = inputEvents.Peek(); event != NULL; event = inputEvents.Peek() )
+	{
+		if ( event->Type == INPUT_EVENT_JOYSTICKS )
+		{
+			memcpy( JoySticks, event->JoySticks, sizeof( JoySticks ) );
+		}
+		else if ( event->Type == INPUT_EVENT_KEY )
+		{
+			const ovrKeyCode keyCode = static_cast< ovrKeyCode >( event->Key.KeyCode & ~BUTTON_JOYPAD_FLAG );
+			// The back key is handled with the vrapi input state.
+			if ( keyCode != OVR_KEY_ESCAPE )
+			{
+				if ( vrFrame.Input.NumKeyEvents >= MAX_KEY_EVENTS_PER_FRAME )
+				{
+					break;
+				}
+				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].KeyCode = keyCode;
+				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].RepeatCount = event->Key.RepeatCount;
+				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].EventType = event->Key.Down ? KEY_EVENT_DOWN : KEY_EVENT_UP;
+				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].TimeInSeconds = event->TimeInSeconds;
+				vrFrame.Input.NumKeyEvents++;
+			}
+		}
+		inputEvents.Pop();
+	}
+
 	// Copy JoySticks
 	for ( int i = 0; i < 2; i++ )
 	{
 		for ( int j = 0; j < 2; j++ )
 		{
-			vrFrame.Input.sticks[i][j] = inputEvents.JoySticks[i][j];
+			vrFrame.Input.sticks[i][j] = JoySticks[i][j];
 		}
 	}
 
+	// Touchpad gestures are timed with the time the touchpads were last sampled, rather than
+	// the time of this frame, so that a late frame does not stretch a tap.
+	double touchpadTime = 0.0;
+
 #if defined( OVR_OS_ANDROID )
 	int trackedRemoteIndex = 0;
 
@@ -289,6 +322,7 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 			if ( result == ovrSuccess )
 			{
 				backButtonDownThisFrame |= headsetInputState.Buttons & ovrButton_Back;
+				touchpadTime = Alg::Max( touchpadTime, headsetInputState.Header.TimeInSeconds );
 
 				if ( headsetInputState.TrackpadStatus )
 				{
@@ -316,6 +350,7 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 			if ( result == ovrSuccess )
 			{
 				backButtonDownThisFrame |= trackedRemoteState.Buttons & ovrButton_Back;
+				touchpadTime = Alg::Max( touchpadTime, trackedRemoteState.Header.TimeInSeconds );
 
 				bool setTouched = trackedRemoteState.Buttons & ovrButton_A || trackedRemoteState.Buttons & ovrButton_Enter || ( trackedRemoteState.TrackpadStatus && TreatRemoteTouchpadTouchedAsButtonDown[trackedRemoteIndex] );
 
@@ -418,23 +453,6 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 	}
 #endif
 
-	// Clear the key events.
-	vrFrame.Input.NumKeyEvents = 0;
-
-	// Copy the key events.
-	for ( int i = 0; i < inputEvents.NumKeyEvents && vrFrame.Input.NumKeyEvents < MAX_KEY_EVENTS_PER_FRAME; i++ )
-	{
-		// The back key is already handled.
-		if ( inputEvents.KeyEvents[i].KeyCode == OVR_KEY_ESCAPE )
-		{
-			continue;
-		}
-		vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].KeyCode = inputEvents.KeyEvents[i].KeyCode;
-		vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].RepeatCount = inputEvents.KeyEvents[i].RepeatCount;
-		vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].EventType = inputEvents.KeyEvents[i].Down ? KEY_EVENT_DOWN : KEY_EVENT_UP;
-		vrFrame.Input.NumKeyEvents++;
-	}
-
 	if ( injectLeftStick )
 	{
 		vrFrame.Input.buttonState &= ~BUTTON_LSTICK_UP;
@@ -532,6 +550,7 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].KeyCode = LStick.CurrStickCode;
 				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].RepeatCount = 0;
 				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].EventType = KEY_EVENT_DOWN;
+				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].TimeInSeconds = currentTime;
 				vrFrame.Input.NumKeyEvents++;
 			}
 			else if ( ( !LStick.CurrStickState && LStick.LastStickState ) ) // if the LeftJoystick is released
@@ -539,6 +558,7 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].KeyCode = LStick.LastStickCode;
 				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].RepeatCount = 0;
 				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].EventType = KEY_EVENT_UP;
+				vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].TimeInSeconds = currentTime;
 				vrFrame.Input.NumKeyEvents++;
 			}
 		}
@@ -549,6 +569,7 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 			vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].KeyCode = RStick.CurrStickCode;
 			vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].RepeatCount = 0;
 			vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].EventType = KEY_EVENT_DOWN;
+			vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].TimeInSeconds = currentTime;
 			vrFrame.Input.NumKeyEvents++;
 		}
 		else if ( ( !RStick.CurrStickState && RStick.LastStickState ) ) // if the RightJoystick is released
@@ -556,6 +577,7 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 			vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].KeyCode = RStick.LastStickCode;
 			vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].RepeatCount = 0;
 			vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].EventType = KEY_EVENT_UP;
+			vrFrame.Input.KeyEvents[vrFrame.Input.NumKeyEvents].TimeInSeconds = currentTime;
 			vrFrame.Input.NumKeyEvents++;
 		}
 	}
@@ -574,7 +596,7 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 	for ( int i = 0; i < vrFrame.Input.NumKeyEvents; i++ )
 	{
 		const ovrKeyCode keyCode = vrFrame.Input.KeyEvents[i].KeyCode;
-		bool down = inputEvents.KeyEvents[i].Down;
+		bool down = vrFrame.Input.KeyEvents[i].EventType == KEY_EVENT_DOWN;
 
 		if ( RStick.CurrStickState ) // if RStick is used
 		{
@@ -649,13 +671,12 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 	}
 
 	// Synthesize swipe gestures as buttons.
-	const double currentTime = vrapi_GetTimeInSeconds();
-	InterpretTouchpad( vrFrame.Input, currentTime, touchpadMinSwipe );
+	InterpretTouchpad( vrFrame.Input, ( touchpadTime > 0.0 ) ? touchpadTime : currentTime, touchpadMinSwipe );
 
 	// Add the short back press to the event list
 	if ( BackKeyDownLastFrame && !backButtonDownThisFrame )
 	{
-		AddKeyEventToFrame( OVR_KEY_BACK, KEY_EVENT_SHORT_PRESS, 0 );
+		AddKeyEventToFrame( OVR_KEY_BACK, KEY_EVENT_SHORT_PRESS, 0, currentTime );
 	}
 
 	BackKeyDownLastFrame = backButtonDownThisFrame;
@@ -694,6 +715,8 @@ void VrFrameBuilder::AdvanceVrFrame( const ovrInputEvents & inputEvents, ovrMobi
 }	// namespace OVR
 
 #if defined( OVR_OS_ANDROID )
+#include <jni.h>
+
 extern "C"
 {
 JNIEXPORT void Java_com_oculus_vrappframework_HeadsetReceiver_headsetStateChanged( JNIEnv * jni, jclass clazz, jint state )
@@ -30,6 +30,7 @@ import android.net.Uri;
 import android.os.Bundle;
 import android.os.Environment;
 import android.os.StatFs;
+import android.os.SystemClock;
 import android.provider.Settings;
 import android.util.Log;
 import android.view.InputDevice;
@@ -42,8 +43,8 @@ public class VrActivity extends Activity {
 	public static final String TAG = "VrActivity";
 
 	private static native void nativeNewIntent(long appPtr, String fromPackageName, String command, String uriString);
-	private static native void nativeKeyEvent(long appPtr, int keyNum, boolean down, int repeatCount );
-	private static native void nativeJoypadAxis(long appPtr, float lx, float ly, float rx, float ry);
+	private static native void nativeKeyEvent(long appPtr, int keyNum, boolean down, int repeatCount, long eventTime );
+	private static native void nativeJoypadAxis(long appPtr, float lx, float ly, float rx, float ry, long eventTime);
 	private static native void nativeTouch(long appPtr, int action, float x, float y );
 
 	// Pass down to native code so we talk to the right App object.
@@ -246,7 +247,7 @@ public class VrActivity extends Activity {
 	}
 
 	private int axisButtons(int deviceId, float axisValue, int negativeButton, int positiveButton,
-			int previousState) {
+			int previousState, long eventTime) {
 		int currentState;
 		if (axisValue < -0.5f) {
 			currentState = -1;
@@ -258,18 +259,18 @@ public class VrActivity extends Activity {
 		if (currentState != previousState) {
 			if (previousState == -1) {
 				// negativeButton up
-				buttonEvent(deviceId, negativeButton, false, 0);
+				buttonEvent(deviceId, negativeButton, false, 0, eventTime);
 			} else if (previousState == 1) {
 				// positiveButton up
-				buttonEvent(deviceId, positiveButton, false, 0);
+				buttonEvent(deviceId, positiveButton, false, 0, eventTime);
 			}
 
 			if (currentState == -1) {
 				// negativeButton down
-				buttonEvent(deviceId, negativeButton, true, 0);
+				buttonEvent(deviceId, negativeButton, true, 0, eventTime);
 			} else if (currentState == 1) {
 				// positiveButton down
-				buttonEvent(deviceId, positiveButton, true, 0);
+				buttonEvent(deviceId, positiveButton, true, 0, eventTime);
 			}
 		}
 		return currentState;
@@ -300,14 +301,15 @@ public class VrActivity extends Activity {
 					deadBand(event.getAxisValue(MotionEvent.AXIS_RX))
 						+ deadBand(event.getAxisValue(MotionEvent.AXIS_Z)),		// Moga uses  Z for R-stick X
 					deadBand(event.getAxisValue(MotionEvent.AXIS_RY))
-						+ deadBand(event.getAxisValue(MotionEvent.AXIS_RZ)));	// Moga uses RZ for R-stick Y
+						+ deadBand(event.getAxisValue(MotionEvent.AXIS_RZ)),	// Moga uses RZ for R-stick Y
+					event.getEventTime());
 
 			// Turn the hat and thumbstick axis into buttons
 			for ( int i = 0 ; i < 6 ; i++ ) {
 				axisState[i] = axisButtons( event.getDeviceId(),
 						event.getAxisValue(axisAxis[i]),
 						axisNegativeButton[i], axisPositiveButton[i],
-						axisState[i]);
+						axisState[i], event.getEventTime());
 			}
 					
 			return true;
@@ -358,7 +360,23 @@ public class VrActivity extends Activity {
 		if (event.getSource() == 1281) {
 			keyCode |= JoyEvent.BUTTON_JOYPAD_FLAG;			
 		}
-		return buttonEvent(deviceId, keyCode, down, event.getRepeatCount() );
+		return buttonEvent(deviceId, keyCode, down, event.getRepeatCount(), event.getEventTime() );
+	}
+
+	// The time of the event that is being passed to buttonEvent().
+	private long buttonEventTime = -1;
+
+	/*
+	 * Called with the time of the event, in the SystemClock.uptimeMillis()
+	 * time base like KeyEvent.getEventTime(). Calls the four argument
+	 * buttonEvent(), so that apps that override it still see every button.
+	 */
+	protected boolean buttonEvent(int deviceId, int keyCode, boolean down, int repeatCount, long eventTime ) {
+		final long previousEventTime = buttonEventTime;
+		buttonEventTime = eventTime;
+		final boolean consumed = buttonEvent( deviceId, keyCode, down, repeatCount );
+		buttonEventTime = previousEventTime;
+		return consumed;
 	}
 
 	/*
@@ -376,10 +394,15 @@ public class VrActivity extends Activity {
 	 * The BUTTON_* values are what you get in joyCode from our reference
 	 * joypad.
 	 * 
+	 * Override this to intercept buttons. The event time is passed on to the
+	 * native code, or SystemClock.uptimeMillis() if this is called from
+	 * outside of an event.
+	 * 
 	 * @return Return true if this event was consumed.
 	 */
 	protected boolean buttonEvent(int deviceId, int keyCode, boolean down, int repeatCount ) {
 		//Log.d(TAG, "buttonEvent " + deviceId + " " + keyCode + " " + down);
+		final long eventTime = ( buttonEventTime >= 0 ) ? buttonEventTime : SystemClock.uptimeMillis();
 		
 		// DispatchKeyEvent will cause the K joypads to spawn other
 		// apps on select and "game", which we don't want, so manually call
@@ -394,11 +417,11 @@ public class VrActivity extends Activity {
 		// VrActivity versions were effectively the consumers by calling nativeKeyEvent.  Instead, call nativeKeyEvent
 		// here directly.
 		if ( down ) {
-			nativeKeyEvent( getAppPtr(), keyCode, true, ev.getRepeatCount() );
+			nativeKeyEvent( getAppPtr(), keyCode, true, ev.getRepeatCount(), eventTime );
 		}
 		else
 		{
-			nativeKeyEvent( getAppPtr(), keyCode, false, 0 );
+			nativeKeyEvent( getAppPtr(), keyCode, false, 0, eventTime );
 		}
 		return true;
 	}
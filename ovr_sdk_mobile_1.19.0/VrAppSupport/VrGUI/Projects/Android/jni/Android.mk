@@ -34,12 +34,15 @@ LOCAL_SRC_FILES := 	../../../Src/ActionComponents.cpp \
 					../../../Src/ScrollManager.cpp \
 					../../../Src/SoundLimiter.cpp \
 					../../../Src/SwipeHintComponent.cpp \
+					../../../Src/ThumbnailCache.cpp \
 					../../../Src/TextFade_Component.cpp \
 					../../../Src/VRMenu.cpp \
 					../../../Src/VRMenuComponent.cpp \
 					../../../Src/VRMenuEvent.cpp \
 					../../../Src/VRMenuEventHandler.cpp \
 					../../../Src/VRMenuMgr.cpp \
+					../../../Src/VRMenuBvh.cpp \
+					../../../Src/VRMenuPool.cpp \
 					../../../Src/VRMenuObject.cpp \
 					../../../Src/SliderComponent.cpp \
 					../../../Src/UI/UITexture.cpp \
@@ -56,6 +59,7 @@ LOCAL_SRC_FILES := 	../../../Src/ActionComponents.cpp \
 					../../../Src/UI/UIKeyboard.cpp \
 					../../../Src/UI/UITextBox.cpp \
 					../../../Src/Reflection.cpp \
+					../../../Src/ReflectionCache.cpp \
 					../../../Src/ReflectionData.cpp
 
 
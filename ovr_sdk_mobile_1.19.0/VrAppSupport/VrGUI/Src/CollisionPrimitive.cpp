@@ -12,12 +12,86 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "CollisionPrimitive.h"
 
+#if defined( __SSE2__ ) || defined( OVR_CPU_X86_64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define OVR_COLLISION_PRIMITIVE_SSE2
+#elif defined( __ARM_NEON ) || defined( OVR_CPU_ARM_NEON )
+#include <arm_neon.h>
+#define OVR_COLLISION_PRIMITIVE_NEON
+#endif
+
 #include "OVR_Geometry.h"
 #include "DebugLines.h"
+#include "Kernel/OVR_Alg.h"
 #include "Kernel/OVR_LogUtils.h"
 
 namespace OVR {
 
+//==============================================================================================
+// ovrSimd4f
+
+#if defined( OVR_COLLISION_PRIMITIVE_SSE2 )
+
+typedef __m128 ovrSimd4f;
+
+static inline ovrSimd4f Simd4fLoad( const float * p ) { return _mm_loadu_ps( p ); }
+static inline ovrSimd4f Simd4fSet( const float f ) { return _mm_set1_ps( f ); }
+static inline ovrSimd4f Simd4fAdd( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_add_ps( a, b ); }
+static inline ovrSimd4f Simd4fSub( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_sub_ps( a, b ); }
+static inline ovrSimd4f Simd4fMul( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_mul_ps( a, b ); }
+static inline ovrSimd4f Simd4fAbs( const ovrSimd4f a ) { return _mm_andnot_ps( _mm_set1_ps( -0.0f ), a ); }
+static inline ovrSimd4f Simd4fLess( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_cmplt_ps( a, b ); }
+static inline ovrSimd4f Simd4fOr( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_or_ps( a, b ); }
+static inline int Simd4fMaskBits( const ovrSimd4f m ) { return _mm_movemask_ps( m ); }
+
+#elif defined( OVR_COLLISION_PRIMITIVE_NEON )
+
+typedef float32x4_t ovrSimd4f;
+
+static inline ovrSimd4f Simd4fLoad( const float * p ) { return vld1q_f32( p ); }
+static inline ovrSimd4f Simd4fSet( const float f ) { return vdupq_n_f32( f ); }
+static inline ovrSimd4f Simd4fAdd( const ovrSimd4f a, const ovrSimd4f b ) { return vaddq_f32( a, b ); }
+static inline ovrSimd4f Simd4fSub( const ovrSimd4f a, const ovrSimd4f b ) { return vsubq_f32( a, b ); }
+static inline ovrSimd4f Simd4fMul( const ovrSimd4f a, const ovrSimd4f b ) { return vmulq_f32( a, b ); }
+static inline ovrSimd4f Simd4fAbs( const ovrSimd4f a ) { return vabsq_f32( a ); }
+static inline ovrSimd4f Simd4fLess( const ovrSimd4f a, const ovrSimd4f b ) { return vreinterpretq_f32_u32( vcltq_f32( a, b ) ); }
+static inline ovrSimd4f Simd4fOr( const ovrSimd4f a, const ovrSimd4f b ) { return vreinterpretq_f32_u32( vorrq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) ); }
+static inline int Simd4fMaskBits( const ovrSimd4f m )
+{
+	const uint32x4_t u = vreinterpretq_u32_f32( m );
+	return (int)( ( vgetq_lane_u32( u, 0 ) & 1 ) | ( vgetq_lane_u32( u, 1 ) & 2 ) |
+				( vgetq_lane_u32( u, 2 ) & 4 ) | ( vgetq_lane_u32( u, 3 ) & 8 ) );
+}
+
+#else
+
+struct ovrSimd4f
+{
+	float	v[4];
+};
+
+static inline ovrSimd4f Simd4fLoad( const float * p ) { ovrSimd4f r = { { p[0], p[1], p[2], p[3] } }; return r; }
+static inline ovrSimd4f Simd4fSet( const float f ) { ovrSimd4f r = { { f, f, f, f } }; return r; }
+static inline ovrSimd4f Simd4fAdd( const ovrSimd4f a, const ovrSimd4f b ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] + b.v[i]; } return r; }
+static inline ovrSimd4f Simd4fSub( const ovrSimd4f a, const ovrSimd4f b ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] - b.v[i]; } return r; }
+static inline ovrSimd4f Simd4fMul( const ovrSimd4f a, const ovrSimd4f b ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] * b.v[i]; } return r; }
+static inline ovrSimd4f Simd4fAbs( const ovrSimd4f a ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = fabsf( a.v[i] ); } return r; }
+static inline ovrSimd4f Simd4fLess( const ovrSimd4f a, const ovrSimd4f b ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = ( a.v[i] < b.v[i] ) ? 1.0f : 0.0f; } return r; }
+static inline ovrSimd4f Simd4fOr( const ovrSimd4f a, const ovrSimd4f b ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = ( a.v[i] != 0.0f || b.v[i] != 0.0f ) ? 1.0f : 0.0f; } return r; }
+static inline int Simd4fMaskBits( const ovrSimd4f m ) { return ( m.v[0] != 0.0f ) | ( ( m.v[1] != 0.0f ) << 1 ) | ( ( m.v[2] != 0.0f ) << 2 ) | ( ( m.v[3] != 0.0f ) << 3 ); }
+
+#endif
+
+// The SIMD triangle tests only reject a lane when the barycentric terms are outside by more
+// than this, relative to the magnitude of their products, and leave the rest to Intersect_RayTriangle.
+static const float TRIANGLE_REJECT_TOLERANCE = 4e-6f;
+
+// Nodes are padded by this fraction of their size so that rounding in the scaled vertices
+// and in the line / bounds test never culls a triangle that Intersect_RayTriangle would hit.
+static const float NODE_BOUNDS_PADDING = 1e-4f;
+
+static const int MAX_TREE_DEPTH = 64;
+
 //==============================
 // OvrCollisionPrimitive::IntersectRayBounds
 bool OvrCollisionPrimitive::IntersectRayBounds( Vector3f const & start, Vector3f const & dir, 
@@ -112,6 +186,162 @@ void OvrTriCollisionPrimitive::Init( Array< Vector3f > const & vertices, Array<
 	}
 
 	SetBounds( b );
+
+	BuildTree();
+}
+
+//==============================
+// ovrTriangleCenterLess
+// Orders triangle indices by their center along one axis.
+class ovrTriangleCenterLess
+{
+public:
+	ovrTriangleCenterLess( const Array< Vector3f > & centers, const int axis ) :
+		Centers( centers ),
+		Axis( axis )
+	{
+	}
+
+	bool operator()( const int a, const int b ) const
+	{
+		return Centers[a][Axis] < Centers[b][Axis];
+	}
+
+private:
+	const Array< Vector3f > &	Centers;
+	int							Axis;
+};
+
+//==============================
+// OvrTriCollisionPrimitive::BuildTree
+void OvrTriCollisionPrimitive::BuildTree()
+{
+	Nodes.Clear();
+	Blocks.Clear();
+
+	const int numTriangles = Indices.GetSizeI() / 3;
+	if ( numTriangles == 0 )
+	{
+		return;
+	}
+
+	Array< Vector3f > centers;
+	Array< int > triangles;
+	centers.Resize( numTriangles );
+	triangles.Resize( numTriangles );
+	for ( int i = 0; i < numTriangles; i++ )
+	{
+		centers[i] = ( Vertices[Indices[i * 3 + 0]] + Vertices[Indices[i * 3 + 1]] + Vertices[Indices[i * 3 + 2]] ) * ( 1.0f / 3.0f );
+		triangles[i] = i;
+	}
+
+	BuildNode_r( centers, triangles, 0, numTriangles );
+}
+
+//==============================
+// OvrTriCollisionPrimitive::BuildNode_r
+int OvrTriCollisionPrimitive::BuildNode_r( const Array< Vector3f > & centers, Array< int > & triangles,
+		const int first, const int count )
+{
+	const int nodeIndex = Nodes.GetSizeI();
+	Nodes.PushBack( ovrTriNode() );
+
+	Bounds3f bounds( Bounds3f::Init );
+	Bounds3f centerBounds( Bounds3f::Init );
+	for ( int i = first; i < first + count; i++ )
+	{
+		const int tri = triangles[i];
+		for ( int j = 0; j < 3; j++ )
+		{
+			bounds.AddPoint( Vertices[Indices[tri * 3 + j]] );
+		}
+		centerBounds.AddPoint( centers[tri] );
+	}
+
+	// pad by the node size and the magnitude of the coordinates
+	const Vector3f size = bounds.GetSize();
+	float maxCoord = 1.0f;
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		maxCoord = Alg::Max( maxCoord, Alg::Max( fabsf( bounds.b[0][axis] ), fabsf( bounds.b[1][axis] ) ) );
+	}
+	const float padding = NODE_BOUNDS_PADDING * ( Alg::Max( Alg::Max( size.x, size.y ), size.z ) + maxCoord );
+	bounds = Bounds3f( bounds.GetMins() - Vector3f( padding ), bounds.GetMaxs() + Vector3f( padding ) );
+
+	{
+		ovrTriNode & node = Nodes[nodeIndex];
+		node.Bounds = bounds;
+		node.Left = -1;
+		node.Right = -1;
+		node.FirstBlock = 0;
+		node.NumBlocks = 0;
+	}
+
+	if ( count <= MAX_LEAF_TRIANGLES )
+	{
+		const int firstBlock = Blocks.GetSizeI();
+		const int numBlocks = ( count + 3 ) / 4;
+		for ( int b = 0; b < numBlocks; b++ )
+		{
+			ovrTriangles4 & block = Blocks.PushDefault();
+			for ( int lane = 0; lane < 4; lane++ )
+			{
+				const int index = b * 4 + lane;
+				const int tri = ( index < count ) ? triangles[first + index] : -1;
+				block.Triangle[lane] = tri;
+				for ( int j = 0; j < 3; j++ )
+				{
+					const Vector3f v = ( tri >= 0 ) ? Vertices[Indices[tri * 3 + j]] : Vector3f( 0.0f );
+					block.X[j][lane] = v.x;
+					block.Y[j][lane] = v.y;
+					block.Z[j][lane] = v.z;
+				}
+			}
+		}
+		Nodes[nodeIndex].FirstBlock = firstBlock;
+		Nodes[nodeIndex].NumBlocks = numBlocks;
+		return nodeIndex;
+	}
+
+	// split at the median along the longest axis of the triangle centers
+	const Vector3f centerSize = centerBounds.GetSize();
+	const int axis = ( centerSize.x >= centerSize.y && centerSize.x >= centerSize.z ) ? 0 : ( ( centerSize.y >= centerSize.z ) ? 1 : 2 );
+	Alg::QuickSortSliced( triangles, first, first + count, ovrTriangleCenterLess( centers, axis ) );
+
+	const int half = count / 2;
+	const int left = BuildNode_r( centers, triangles, first, half );
+	const int right = BuildNode_r( centers, triangles, first + half, count - half );
+	Nodes[nodeIndex].Left = left;
+	Nodes[nodeIndex].Right = right;
+	return nodeIndex;
+}
+
+//==============================
+// IntersectLineBounds
+// Intersects the infinite line start + t * dir with the bounds, where invDir is 1 / dir, or 0
+// for axes the line is parallel to. Returns the t where the line enters the bounds.
+static bool IntersectLineBounds( Vector3f const & start, Vector3f const & dir, Vector3f const & invDir,
+		Bounds3f const & bounds, float & tEnter )
+{
+	float t0 = -FLT_MAX;
+	float t1 = FLT_MAX;
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		if ( invDir[axis] == 0.0f )
+		{
+			if ( start[axis] < bounds.b[0][axis] || start[axis] > bounds.b[1][axis] )
+			{
+				return false;
+			}
+			continue;
+		}
+		const float a = ( bounds.b[0][axis] - start[axis] ) * invDir[axis];
+		const float b = ( bounds.b[1][axis] - start[axis] ) * invDir[axis];
+		t0 = Alg::Max( t0, Alg::Min( a, b ) );
+		t1 = Alg::Min( t1, Alg::Max( a, b ) );
+	}
+	tEnter = t0;
+	return t0 <= t1 + 1e-5f * Alg::Max( fabsf( t0 ), fabsf( t1 ) );
 }
 
 //==============================
@@ -135,6 +365,10 @@ bool OvrTriCollisionPrimitive::IntersectRay( Vector3f const & start, Vector3f co
 //==============================
 // OvrTriCollisionPrimitive::IntersectRay
 // the ray should already be in local space
+// Walks the tree front to back along the line of the ray and tests four triangles at a time
+// with SIMD, only running Intersect_RayTriangle on the triangles the SIMD test cannot reject.
+// Like testing every triangle in order, the nearest hit wins, and the lowest triangle index on
+// equal distances, where hits behind the start of the ray count as nearer.
 bool OvrTriCollisionPrimitive::IntersectRay( Vector3f const & localStart, Vector3f const & localDir,
 		Vector3f const & scale, ContentFlags_t const testContents, OvrCollisionResult & result ) const
 {
@@ -153,35 +387,173 @@ bool OvrTriCollisionPrimitive::IntersectRay( Vector3f const & localStart, Vector
 	}
 
 	result.TriIndex = -1;
-	for ( int i = 0; i < Indices.GetSizeI(); i += 3 )
+	if ( Nodes.GetSizeI() == 0 )
 	{
-		float t_;
-		float u_;
-		float v_;
-		Vector3f verts[3];
-		verts[0] = Vertices[Indices[i]] * scale;
-		verts[1] = Vertices[Indices[i + 1]] * scale;
-		verts[2] = Vertices[Indices[i + 2]] * scale;
+		return false;
+	}
+
+	float diff = fabsf( localDir.LengthSq() - 1.0f );
+	if ( diff > Mathf::Tolerance() )
+	{
+		OVR_LOG( "!rayDir.IsNormalized() - ( %.4f, %.4f, %.4f ), len = %.8f, diff = %.8f", localDir.x, localDir.y, localDir.z , localDir.Length(), diff );
+		OVR_ASSERT( !"IsNormalized()" );
+	}
+
+	// The tree is in unscaled space, so the line is tested against the nodes with the scale
+	// divided out, which leaves the line parameter unchanged. With a zero scale every node is visited.
+	const bool cullNodes = scale.x != 0.0f && scale.y != 0.0f && scale.z != 0.0f;
+	const Vector3f nodeStart = cullNodes ? localStart / scale : localStart;
+	const Vector3f nodeDir = cullNodes ? localDir / scale : localDir;
+	Vector3f nodeInvDir;
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		nodeInvDir[axis] = ( fabsf( nodeDir[axis] ) > MATH_FLOAT_SMALLEST_NON_DENORMAL ) ? 1.0f / nodeDir[axis] : 0.0f;
+	}
+
+	const ovrSimd4f scaleX = Simd4fSet( scale.x );
+	const ovrSimd4f scaleY = Simd4fSet( scale.y );
+	const ovrSimd4f scaleZ = Simd4fSet( scale.z );
+	const ovrSimd4f startX = Simd4fSet( localStart.x );
+	const ovrSimd4f startY = Simd4fSet( localStart.y );
+	const ovrSimd4f startZ = Simd4fSet( localStart.z );
+	const ovrSimd4f dirX = Simd4fSet( localDir.x );
+	const ovrSimd4f dirY = Simd4fSet( localDir.y );
+	const ovrSimd4f dirZ = Simd4fSet( localDir.z );
+	const ovrSimd4f tolerance = Simd4fSet( TRIANGLE_REJECT_TOLERANCE * ( fabsf( localDir.x ) + fabsf( localDir.y ) + fabsf( localDir.z ) ) );
+	const ovrSimd4f zero = Simd4fSet( 0.0f );
+
+	int stackNodes[MAX_TREE_DEPTH];
+	float stackEnter[MAX_TREE_DEPTH];
+	int stackDepth = 0;
+	float rootEnter = -FLT_MAX;
+	if ( !cullNodes || IntersectLineBounds( nodeStart, nodeDir, nodeInvDir, Nodes[0].Bounds, rootEnter ) )
+	{
+		stackNodes[stackDepth] = 0;
+		stackEnter[stackDepth] = rootEnter;
+		stackDepth++;
+	}
 
-		float diff = fabsf( localDir.LengthSq() - 1.0f );
-		if ( diff > Mathf::Tolerance() )
+	while ( stackDepth > 0 )
+	{
+		stackDepth--;
+		if ( stackEnter[stackDepth] - 1e-5f * fabsf( stackEnter[stackDepth] ) > result.t )
 		{
-			OVR_LOG( "!rayDir.IsNormalized() - ( %.4f, %.4f, %.4f ), len = %.8f, diff = %.8f", localDir.x, localDir.y, localDir.z , localDir.Length(), diff );
-			OVR_ASSERT( !"IsNormalized()" );
+			continue;
 		}
+		const ovrTriNode & node = Nodes[stackNodes[stackDepth]];
 
-		if ( Intersect_RayTriangle( localStart, localDir, verts[0], verts[1], verts[2], t_, u_, v_ ) )
+		if ( node.Left >= 0 )
 		{
-			if ( t_ < result.t )
+			float leftEnter = -FLT_MAX;
+			float rightEnter = -FLT_MAX;
+			const bool hitLeft = !cullNodes || IntersectLineBounds( nodeStart, nodeDir, nodeInvDir, Nodes[node.Left].Bounds, leftEnter );
+			const bool hitRight = !cullNodes || IntersectLineBounds( nodeStart, nodeDir, nodeInvDir, Nodes[node.Right].Bounds, rightEnter );
+			OVR_ASSERT( stackDepth + 2 <= MAX_TREE_DEPTH );
+			// push the far child first so the near child is tested first
+			const bool leftFirst = leftEnter <= rightEnter;
+			if ( hitRight && leftFirst )
+			{
+				stackNodes[stackDepth] = node.Right;
+				stackEnter[stackDepth] = rightEnter;
+				stackDepth++;
+			}
+			if ( hitLeft )
 			{
-				result.t = t_;
+				stackNodes[stackDepth] = node.Left;
+				stackEnter[stackDepth] = leftEnter;
+				stackDepth++;
+			}
+			if ( hitRight && !leftFirst )
+			{
+				stackNodes[stackDepth] = node.Right;
+				stackEnter[stackDepth] = rightEnter;
+				stackDepth++;
+			}
+			continue;
+		}
 
-				result.TriIndex = i / 3;
-				result.uv = UVs[Indices[i + 0]] * ( 1.0f - u_ - v_ ) +
-							UVs[Indices[i + 1]] * u_ +
-							UVs[Indices[i + 2]] * v_;				
+		for ( int b = node.FirstBlock; b < node.FirstBlock + node.NumBlocks; b++ )
+		{
+			const ovrTriangles4 & block = Blocks[b];
+
+			// the scaled vertices and edges are the same as those Intersect_RayTriangle is called with
+			const ovrSimd4f v0x = Simd4fMul( Simd4fLoad( block.X[0] ), scaleX );
+			const ovrSimd4f v0y = Simd4fMul( Simd4fLoad( block.Y[0] ), scaleY );
+			const ovrSimd4f v0z = Simd4fMul( Simd4fLoad( block.Z[0] ), scaleZ );
+			const ovrSimd4f e1x = Simd4fSub( Simd4fMul( Simd4fLoad( block.X[1] ), scaleX ), v0x );
+			const ovrSimd4f e1y = Simd4fSub( Simd4fMul( Simd4fLoad( block.Y[1] ), scaleY ), v0y );
+			const ovrSimd4f e1z = Simd4fSub( Simd4fMul( Simd4fLoad( block.Z[1] ), scaleZ ), v0z );
+			const ovrSimd4f e2x = Simd4fSub( Simd4fMul( Simd4fLoad( block.X[2] ), scaleX ), v0x );
+			const ovrSimd4f e2y = Simd4fSub( Simd4fMul( Simd4fLoad( block.Y[2] ), scaleY ), v0y );
+			const ovrSimd4f e2z = Simd4fSub( Simd4fMul( Simd4fLoad( block.Z[2] ), scaleZ ), v0z );
+			const ovrSimd4f tvx = Simd4fSub( startX, v0x );
+			const ovrSimd4f tvy = Simd4fSub( startY, v0y );
+			const ovrSimd4f tvz = Simd4fSub( startZ, v0z );
+
+			// pv = dir x edge2, qv = tv x edge1
+			const ovrSimd4f pvx = Simd4fSub( Simd4fMul( dirY, e2z ), Simd4fMul( dirZ, e2y ) );
+			const ovrSimd4f pvy = Simd4fSub( Simd4fMul( dirZ, e2x ), Simd4fMul( dirX, e2z ) );
+			const ovrSimd4f pvz = Simd4fSub( Simd4fMul( dirX, e2y ), Simd4fMul( dirY, e2x ) );
+			const ovrSimd4f qvx = Simd4fSub( Simd4fMul( tvy, e1z ), Simd4fMul( tvz, e1y ) );
+			const ovrSimd4f qvy = Simd4fSub( Simd4fMul( tvz, e1x ), Simd4fMul( tvx, e1z ) );
+			const ovrSimd4f qvz = Simd4fSub( Simd4fMul( tvx, e1y ), Simd4fMul( tvy, e1x ) );
+
+			const ovrSimd4f det = Simd4fAdd( Simd4fAdd( Simd4fMul( e1x, pvx ), Simd4fMul( e1y, pvy ) ), Simd4fMul( e1z, pvz ) );
+			const ovrSimd4f s = Simd4fAdd( Simd4fAdd( Simd4fMul( tvx, pvx ), Simd4fMul( tvy, pvy ) ), Simd4fMul( tvz, pvz ) );
+			const ovrSimd4f t = Simd4fAdd( Simd4fAdd( Simd4fMul( dirX, qvx ), Simd4fMul( dirY, qvy ) ), Simd4fMul( dirZ, qvz ) );
+
+			// bounds on the rounding error of det, s and t
+			const ovrSimd4f len1 = Simd4fAdd( Simd4fAdd( Simd4fAbs( e1x ), Simd4fAbs( e1y ) ), Simd4fAbs( e1z ) );
+			const ovrSimd4f len2 = Simd4fAdd( Simd4fAdd( Simd4fAbs( e2x ), Simd4fAbs( e2y ) ), Simd4fAbs( e2z ) );
+			const ovrSimd4f lenT = Simd4fAdd( Simd4fAdd( Simd4fAbs( tvx ), Simd4fAbs( tvy ) ), Simd4fAbs( tvz ) );
+			const ovrSimd4f errDet = Simd4fMul( Simd4fMul( len1, len2 ), tolerance );
+			const ovrSimd4f errS = Simd4fMul( Simd4fMul( lenT, len2 ), tolerance );
+			const ovrSimd4f errT = Simd4fMul( Simd4fMul( lenT, len1 ), tolerance );
+
+			// det <= 0, s < 0, s > det, t < 0, s + t > det
+			ovrSimd4f reject = Simd4fLess( det, Simd4fSub( zero, errDet ) );
+			reject = Simd4fOr( reject, Simd4fLess( s, Simd4fSub( zero, errS ) ) );
+			reject = Simd4fOr( reject, Simd4fLess( Simd4fAdd( det, Simd4fAdd( errDet, errS ) ), s ) );
+			reject = Simd4fOr( reject, Simd4fLess( t, Simd4fSub( zero, errT ) ) );
+			reject = Simd4fOr( reject, Simd4fLess( Simd4fAdd( det, Simd4fAdd( errDet, Simd4fAdd( errS, errT ) ) ), Simd4fAdd( s, t ) ) );
+
+			const int accept = ~Simd4fMaskBits( reject ) & 15;
+			if ( accept == 0 )
+			{
+				continue;
+			}
 
-				result.Barycentric = Vector2f( u_, v_ );
+			for ( int lane = 0; lane < 4; lane++ )
+			{
+				const int tri = block.Triangle[lane];
+				if ( ( accept & ( 1 << lane ) ) == 0 || tri < 0 )
+				{
+					continue;
+				}
+
+				const int i = tri * 3;
+				float t_;
+				float u_;
+				float v_;
+				Vector3f verts[3];
+				verts[0] = Vertices[Indices[i]] * scale;
+				verts[1] = Vertices[Indices[i + 1]] * scale;
+				verts[2] = Vertices[Indices[i + 2]] * scale;
+
+				if ( Intersect_RayTriangle( localStart, localDir, verts[0], verts[1], verts[2], t_, u_, v_ ) )
+				{
+					if ( t_ < result.t || ( t_ == result.t && tri < result.TriIndex ) )
+					{
+						result.t = t_;
+
+						result.TriIndex = tri;
+						result.uv = UVs[Indices[i + 0]] * ( 1.0f - u_ - v_ ) +
+									UVs[Indices[i + 1]] * u_ +
+									UVs[Indices[i + 2]] * v_;
+
+						result.Barycentric = Vector2f( u_, v_ );
+					}
+				}
 			}
 		}
 	}
@@ -119,9 +119,35 @@ public:
 								bool const showNormals ) const OVR_OVERRIDE;
 
 private:
+	static const int MAX_LEAF_TRIANGLES = 8;
+
+	// Four triangles in local space, SoA by corner and axis. Unused lanes have Triangle -1.
+	struct ovrTriangles4
+	{
+		float	X[3][4];
+		float	Y[3][4];
+		float	Z[3][4];
+		int		Triangle[4];
+	};
+
+	struct ovrTriNode
+	{
+		Bounds3f	Bounds;		// local space, padded for rounding
+		int			Left;		// child nodes, -1 for leaves
+		int			Right;
+		int			FirstBlock;	// first block in Blocks for leaves
+		int			NumBlocks;	// number of blocks for leaves, 0 for interior nodes
+	};
+
 	Array< Vector3f >		Vertices;	// vertices for all triangles
 	Array< TriangleIndex >	Indices;	// indices indicating which vertices make up each triangle
 	Array< Vector2f >		UVs;		// uvs for each vertex
+	Array< ovrTriNode >		Nodes;		// bounding volume hierarchy of the triangles, built by Init
+	Array< ovrTriangles4 >	Blocks;		// triangles in leaf order
+
+	void				BuildTree();
+	int					BuildNode_r( const Array< Vector3f > & centers, Array< int > & triangles,
+								const int first, const int count );
 };
 
 } // namespace OVR
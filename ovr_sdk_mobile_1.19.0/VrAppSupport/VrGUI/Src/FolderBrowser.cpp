@@ -28,6 +28,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "VRMenuObject.h"
 #include "ScrollBarComponent.h"
 #include "SwipeHintComponent.h"
+#include "OVR_TextureStreamer.h"
 
 namespace OVR {
 
@@ -791,6 +792,7 @@ OvrFolderBrowser::OvrFolderBrowser(
 	, LastControllerInputTimeStamp( 0.0f )
 	, IsTouchDownPosistionTracked( false )
 	, TouchDirectionLocked( NO_LOCK )
+	, TextureStreamer( guiSys.GetApp()->GetTextureStreamer() )
 	, ThumbnailLoadingThread( Thread::CreateParams( & ThumbnailThread, this, 128 * 1024, -1, Thread::NotRunning, Thread::BelowNormalPriority) )
 {
 	//  Load up thumbnail alpha from panel.tga
@@ -880,6 +882,8 @@ OvrFolderBrowser::~OvrFolderBrowser()
 	ThumbnailThreadCondition.NotifyAll();
 	ThumbnailThreadMutex.Unlock();
 	BackgroundCommands.ClearMessages();
+
+	ThumbnailCache.Close();
 	
 	int numFolders = Folders.GetSizeI();
 	for ( int i = 0; i < numFolders; ++i )
@@ -887,7 +891,7 @@ OvrFolderBrowser::~OvrFolderBrowser()
 		FolderView * folder = Folders.At( i );
 		if ( folder )
 		{
-			folder->FreeThumbnailTextures( DefaultPanelTextureIds[ 0 ] );
+			folder->FreeThumbnailTextures( TextureStreamer, DefaultPanelTextureIds[ 0 ] );
 			delete folder;
 		}
 	}
@@ -1013,6 +1017,11 @@ void OvrFolderBrowser::OneTimeInit( OvrGuiSys & guiSys )
 	storagePaths.GetPathIfValidPermission( EST_PRIMARY_EXTERNAL_STORAGE, EFT_CACHE, "", permissionFlags_t( PERMISSION_WRITE ), AppCachePath );
 	OVR_ASSERT( !AppCachePath.IsEmpty() );
 
+	if ( !AppCachePath.IsEmpty() )
+	{
+		ThumbnailCache.Open( ( AppCachePath + "thumbnails.pack" ).ToCStr() );
+	}
+
 	storagePaths.PushBackSearchPathIfValid( EST_SECONDARY_EXTERNAL_STORAGE, EFT_ROOT, "RetailMedia/", ThumbSearchPaths );
 	storagePaths.PushBackSearchPathIfValid( EST_SECONDARY_EXTERNAL_STORAGE, EFT_ROOT, "", ThumbSearchPaths );
 	storagePaths.PushBackSearchPathIfValid( EST_PRIMARY_EXTERNAL_STORAGE, EFT_ROOT, "RetailMedia/", ThumbSearchPaths );
@@ -1724,8 +1733,24 @@ void OvrFolderBrowser::LoadThumbnailToTexture( OvrGuiSys & guiSys, const char *
 	VRMenuObject * panelObject = guiSys.GetVRMenuMgr().ToObject( thumbHandle );
 	OVR_ASSERT( panelObject );
 
-	GlTexture texId = LoadRGBATextureFromMemory( data, width, height, true /* srgb */ );
-	free( data );
+	GlTexture texId;
+	if ( TextureStreamer != NULL )
+	{
+		// the panel shows the thumbnail once its smallest mip level is uploaded
+		MemBufferT< uint8_t > pixels( width * height * 4 );
+		memcpy( pixels, data, width * height * 4 );
+		free( data );
+		texId = TextureStreamer->LoadRGBATexture( pixels, width, height, TextureFlags_t( TEXTUREFLAG_USE_SRGB ) );
+	}
+	else
+	{
+		texId = LoadRGBATextureFromMemory( data, width, height, true /* srgb */ );
+		free( data );
+		if ( texId )
+		{
+			BuildTextureMipmaps( texId );
+		}
+	}
 
 	if ( texId )
 	{
@@ -1734,7 +1759,6 @@ void OvrFolderBrowser::LoadThumbnailToTexture( OvrGuiSys & guiSys, const char *
 
 		panel->TextureId = texId;
 
-		BuildTextureMipmaps( texId );
 		MakeTextureTrilinear( texId );
 		MakeTextureClamped( texId );
 	}
@@ -2230,7 +2254,7 @@ OvrFolderBrowser::FolderView::~FolderView()
 
 void OvrFolderBrowser::FolderView::UnloadThumbnails( OvrGuiSys & guiSys, const GLuint defaultTextureId, const int thumbWidth, const int thumbHeight )
 {
-	FreeThumbnailTextures( defaultTextureId );
+	FreeThumbnailTextures( guiSys.GetApp()->GetTextureStreamer(), defaultTextureId );
 
 	for ( int i = 0; i < Panels.GetSizeI(); ++i )
 	{
@@ -2242,14 +2266,23 @@ void OvrFolderBrowser::FolderView::UnloadThumbnails( OvrGuiSys & guiSys, const G
 	}
 }
 
-void OvrFolderBrowser::FolderView::FreeThumbnailTextures( const GLuint defaultTextureId )
+void OvrFolderBrowser::FolderView::FreeThumbnailTextures( ovrTextureStreamer * streamer, const GLuint defaultTextureId )
 {
 	for ( int i = 0; i < Panels.GetSizeI(); ++i )
 	{
 		PanelView * panel = Panels.At( i );
 		if ( panel && ( panel->TextureId != defaultTextureId ) )
 		{
-			glDeleteTextures( 1, &panel->TextureId  );
+			if ( streamer != NULL )
+			{
+				// also stops the upload of a thumbnail that is still loading
+				GlTexture texture( panel->TextureId, 0, 0 );
+				streamer->FreeTexture( texture );
+			}
+			else
+			{
+				glDeleteTextures( 1, &panel->TextureId  );
+			}
 			panel->TextureId = 0;
 		}
 	}
@@ -19,6 +19,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "ScrollManager.h"
 #include "Kernel/OVR_Lockless.h"
 #include "VRMenuComponent.h"
+#include "ThumbnailCache.h"
 
 namespace OVR {
 
@@ -27,6 +28,7 @@ class OvrFolderSwipeComponent;
 class OvrFolderBrowserSwipeComponent;
 class OvrDefaultComponent;
 class OvrPanel_OnUp;
+class ovrTextureStreamer;
 
 //==============================================================
 // OvrFolderBrowser
@@ -84,7 +86,7 @@ public:
 		virtual ~FolderView();
 
 		void UnloadThumbnails( OvrGuiSys & guiSys, const GLuint defaultTextureId, const int thumbWidth, const int thumbHeight );
-		void FreeThumbnailTextures( const GLuint defaultTextureId );
+		void FreeThumbnailTextures( ovrTextureStreamer * streamer, const GLuint defaultTextureId );
 
 		const String			CategoryTag;
 		const String			LocalizedName;		// Store for rebuild of title
@@ -270,6 +272,9 @@ protected:
 protected:
 	int							MediaCount; // Used to determine if no media was loaded
 
+	// Decoded thumbnails of the media, kept in the app cache across launches
+	OvrThumbnailCache			ThumbnailCache;
+
 private:
 	static threadReturn_t		ThumbnailThread( Thread * thread, void * v );
 	void				LoadThumbnailToTexture( OvrGuiSys & guiSys, const char * thumbnailCommand );
@@ -363,6 +368,9 @@ private:
 	Vector3f 						TouchDownPosistion; // First event in touch relative is considered as touch down position
 	eScrollDirectionLockType		TouchDirectionLocked;
 
+	// Uploads the thumbnails and generates their mip levels off the frame, if the app has one
+	ovrTextureStreamer *			TextureStreamer;
+
 	Thread									ThumbnailLoadingThread;
 };
 
@@ -30,6 +30,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_JSON.h"
 #include "Kernel/OVR_Lexer.h"
 #include "Reflection.h"
+#include "ReflectionCache.h"
 #include "ReflectionData.h"
 #include "PointTracker.h"
 
@@ -230,6 +231,16 @@ void OvrGuiSysLocal::Init( App * app_, OvrGuiSys::SoundEffectPlayer & soundEffec
 	SoundEffectPlayer = &soundEffectPlayer;
 	DebugLines = debugLines;
 
+	// Keep parsed menu files so that later runs replay them instead of parsing them again.
+	{
+		String cachePath;
+		if ( app->GetStoragePaths().GetPathIfValidPermission( EST_INTERNAL_STORAGE, EFT_CACHE, "",
+				permissionFlags_t( PERMISSION_WRITE ) | PERMISSION_READ, cachePath ) )
+		{
+			Reflection->GetCache().SetFileName( ( cachePath + "reflection.cache" ).ToCStr() );
+		}
+	}
+
 	MenuMgr = OvrVRMenuMgr::Create( *this );
 	MenuMgr->Init( *this );
 
@@ -853,14 +864,9 @@ HitTestResult OvrGuiSysLocal::TestRayIntersection( const Vector3f & start, const
 		{
 			continue;
 		}
-		VRMenuObject * root = GetVRMenuMgr().ToObject( curMenu->GetRootHandle() );
-		if ( root == nullptr )
-		{
-			continue;
-		}
-
 		HitTestResult r;
-		menuHandle_t hitHandle = root->HitTest( *this, curMenu->GetMenuPose(), start, dir, ContentFlags_t( CONTENT_SOLID ), r );
+		menuHandle_t hitHandle = GetVRMenuMgr().HitTest( *this, curMenu->GetRootHandle(), curMenu->GetMenuPose(),
+				start, dir, ContentFlags_t( CONTENT_SOLID ), r );
 		if ( hitHandle.IsValid() && r.t < result.t )
 		{
 			result = r;
@@ -11,6 +11,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "Reflection.h"
 #include "ReflectionData.h"
+#include "ReflectionCache.h"
 #include "Kernel/OVR_Lexer.h"
 #include "Kernel/OVR_LogUtils.h"
 #include "Kernel/OVR_TypesafeNumber.h"
@@ -230,18 +231,8 @@ ovrParseResult ParseBitFlags( ovrReflection & /*refl*/, ovrLocale const & /*loca
 	}
 }
 
-ovrParseResult ParseString( ovrReflection & /*refl*/, ovrLocale const & locale, const char * name, ovrLexer & lex, ovrTypeInfo const * /*atomicInfo*/, void * outPtr, size_t const /*arraySize*/ )
+void AssignStringToken( ovrLocale const & locale, char const * token, String & out )
 {
-	String & out = *static_cast< String* >( outPtr );
-	size_t const MAX_TOKEN = 1024;
-	char token[MAX_TOKEN];
-
-	ovrLexer::ovrResult res = lex.NextToken( token, MAX_TOKEN );
-	if ( res != ovrLexer::LEX_RESULT_OK )
-	{
-		return ovrParseResult( res, "Error parsing '%s': expected string, got '%s'", name, token );
-	}
-	
 	// we find the start of the string because it may be preceeded by a format specifier (~~w0, ~~RRGGBBAA, etc.)
 	char const * keyPtr = strstr( token, "@string/" );
 	if ( keyPtr != nullptr )
@@ -249,14 +240,33 @@ ovrParseResult ParseString( ovrReflection & /*refl*/, ovrLocale const & locale,
 		intptr_t const keyIndex = keyPtr - token;
 		String temp;
 		locale.GetString( keyPtr, keyPtr, temp );
-		token[keyIndex] = '\0';
-		out += token;
+		out.AppendString( token, keyIndex );
 		out += temp;
 	}
 	else
 	{
 		out = token;
 	}
+}
+
+ovrParseResult ParseString( ovrReflection & refl, ovrLocale const & locale, const char * name, ovrLexer & lex, ovrTypeInfo const * /*atomicInfo*/, void * outPtr, size_t const /*arraySize*/ )
+{
+	String & out = *static_cast< String* >( outPtr );
+	size_t const MAX_TOKEN = 1024;
+	char token[MAX_TOKEN];
+
+	ovrLexer::ovrResult res = lex.NextToken( token, MAX_TOKEN );
+	if ( res != ovrLexer::LEX_RESULT_OK )
+	{
+		return ovrParseResult( res, "Error parsing '%s': expected string, got '%s'", name, token );
+	}
+
+	if ( refl.GetRecorder() != nullptr )
+	{
+		// the token is recorded before the locale lookup, so the recording works for any locale
+		refl.GetRecorder()->StringValue( outPtr, token );
+	}
+	AssignStringToken( locale, token, out );
 	return ovrParseResult();
 }
 
@@ -354,6 +364,12 @@ ovrParseResult ParseArray( ovrReflection & refl, ovrLocale const & locale, const
 	const int MAX_TOKEN = 1024;
 	char token[MAX_TOKEN];
 
+	ovrReflectionRecorder * const recorder = refl.GetRecorder();
+	if ( recorder != nullptr )
+	{
+		recorder->BeginArray( arrayPtr, arrayTypeInfo, arraySize );
+	}
+
 	// next token must be either the size of the array or an opening brace
 	ovrLexer::ovrResult result = lex.NextToken( token, MAX_TOKEN );
 	if ( result != ovrLexer::LEX_RESULT_OK ) { return ovrParseResult( result, "Error parsing '%s'", name ); }
@@ -382,6 +398,10 @@ ovrParseResult ParseArray( ovrReflection & refl, ovrLocale const & locale, const
 			return ovrParseResult( ovrLexer::LEX_RESULT_ERROR, "Error parsing '%s': invalid array size %i", name, count ); 
 		}
 		arrayTypeInfo->ResizeArrayFn( arrayPtr, count );
+		if ( recorder != nullptr )
+		{
+			recorder->ResizeArray( count );
+		}
 
 		ovrParseResult parseRes = ExpectPunctuation( name, lex, "{" );
 		if ( !parseRes ) { return parseRes; }
@@ -391,13 +411,15 @@ ovrParseResult ParseArray( ovrReflection & refl, ovrLocale const & locale, const
 	for ( int index = 0; ; ++index )
 	{
 		ovrLexer::ovrResult res = lex.NextToken( token, MAX_TOKEN );
-		if ( res == ovrLexer::LEX_RESULT_EOF ) { return ovrParseResult(); }
-		if ( res ) { return ovrParseResult( res, "Error %d parsing '%s'", name ); }
-
-		if ( !OVR_strcmp( token, "}" ) )
+		if ( res == ovrLexer::LEX_RESULT_EOF || ( res == ovrLexer::LEX_RESULT_OK && !OVR_strcmp( token, "}" ) ) )
 		{
+			if ( recorder != nullptr )
+			{
+				recorder->EndArray();
+			}
 			return ovrParseResult();
 		}
+		if ( res ) { return ovrParseResult( res, "Error %d parsing '%s'", name ); }
 
 		if ( index >= count )
 		{
@@ -405,6 +427,10 @@ ovrParseResult ParseArray( ovrReflection & refl, ovrLocale const & locale, const
 			{
 				// resize the dynamic array
 				arrayTypeInfo->ResizeArrayFn( arrayPtr, index + 1 );
+				if ( recorder != nullptr )
+				{
+					recorder->ResizeArray( index + 1 );
+				}
 			}
 			else
 			{
@@ -445,6 +471,10 @@ ovrParseResult ParseArray( ovrReflection & refl, ovrLocale const & locale, const
 #endif
 		}
 		void * elementPtr = elementTypeInfo->CreateFn( placementBuffer );
+		if ( recorder != nullptr )
+		{
+			recorder->BeginElement( elementPtr, elementTypeInfo, index );
+		}
 
 		if ( elementTypeInfo->MemberInfo != nullptr )
 		{
@@ -460,6 +490,10 @@ ovrParseResult ParseArray( ovrReflection & refl, ovrLocale const & locale, const
 
 			parseRes = elementTypeInfo->ParseFn( refl, locale, name, lex, elementTypeInfo, elementPtr, 0 );
 			if ( !parseRes ) { return parseRes; }
+			if ( recorder != nullptr )
+			{
+				recorder->ParsedValue( elementPtr, elementTypeInfo );
+			}
 
 			parseRes = ExpectPunctuation( name, lex, ";" );
 			if ( !parseRes ) { return parseRes; }
@@ -467,6 +501,10 @@ ovrParseResult ParseArray( ovrReflection & refl, ovrLocale const & locale, const
 
 		// copy to the array
 		arrayTypeInfo->SetArrayElementFn( arrayPtr, index, elementPtr );
+		if ( recorder != nullptr )
+		{
+			recorder->EndElement();
+		}
 	}
 }
 
@@ -500,9 +538,16 @@ ovrReflectionOverload const * ovrReflection::FindOverload( char const * scope )
 ovrParseResult ParseObject( ovrReflection & refl, ovrLocale const & locale, const char * name, ovrLexer & lex, 
 		ovrTypeInfo const * objectTypeInfo, void * objPtr, const size_t /*arraySize*/ )
 {
-	String scope;
-	BuildScope( refl, objectTypeInfo, scope );
-	ovrReflectionOverload const * o = refl.FindOverload( scope.ToCStr() );
+	ovrReflectionRecorder * const recorder = refl.GetRecorder();
+
+	// most files have no overloads, so don't build the scope name unless there are some
+	ovrReflectionOverload const * o = nullptr;
+	if ( refl.HasOverloads() )
+	{
+		String scope;
+		BuildScope( refl, objectTypeInfo, scope );
+		o = refl.FindOverload( scope.ToCStr() );
+	}
 	if ( o != nullptr && o->OverloadsMemberVar() )
 	{
 		ovrMemberInfo const * overloadedMemberVar = refl.FindMemberReflectionInfo( objectTypeInfo->MemberInfo, o->GetName() );
@@ -513,9 +558,17 @@ ovrParseResult ParseObject( ovrReflection & refl, ovrLocale const & locale, cons
 			{
 				case ovrReflectionOverload::OVERLOAD_FLOAT_DEFAULT_VALUE:
 					*reinterpret_cast< float* >( memberPtr ) = static_cast< ovrReflectionOverload_FloatDefaultValue const * >( o )->GetValue();
+					if ( recorder != nullptr )
+					{
+						recorder->Value( memberPtr, sizeof( float ) );
+					}
 					break;
 				default:
 					OVR_ASSERT( false );	// unhandled overload type
+					if ( recorder != nullptr )
+					{
+						recorder->Invalidate();
+					}
 					break;
 			}
 		}
@@ -567,6 +620,10 @@ ovrParseResult ParseObject( ovrReflection & refl, ovrLocale const & locale, cons
 
 			ovrParseResult parseRes = memberTypeInfo->ParseFn( refl, locale, name, lex, memberTypeInfo, memberPtr, memberInfo->ArraySize );
 			if ( !parseRes ) { return parseRes; }
+			if ( recorder != nullptr )
+			{
+				recorder->ParsedValue( memberPtr, memberTypeInfo );
+			}
 
 			if ( memberInfo->Operator != ovrTypeOperator::ARRAY )
 			{
@@ -612,6 +669,7 @@ void ovrReflection::Destroy( ovrReflection * & r )
 
 void ovrReflection::Init()
 {
+	Cache = new ovrReflectionCache();
 	AddTypeInfoList( TypeInfoList );
 }
 
@@ -623,11 +681,79 @@ void ovrReflection::Shutdown()
 		Overloads[i] = nullptr;
 	}
 	Overloads.Clear();
+
+	delete Cache;
+	Cache = nullptr;
 }
 
 void ovrReflection::AddTypeInfoList( ovrTypeInfo const * list )
 {
 	TypeInfoLists.PushBack( list );
+
+	ovrHash64 h;
+	h.AddValue( LayoutHash );
+	for ( int i = 0; list[i].TypeName != nullptr; ++i )
+	{
+		ovrTypeInfo const & ti = list[i];
+		// earlier lists take precedence, the same as the search order of FindTypeInfo
+		if ( TypeIndices.Get( ti.TypeName ) == nullptr )
+		{
+			TypeIndices.Add( ti.TypeName, Types.GetSizeI() );
+			Types.PushBack( &ti );
+		}
+
+		h.AddString( ti.TypeName );
+		h.AddString( ti.ParentTypeName != nullptr ? ti.ParentTypeName : "" );
+		h.AddValue( ti.Size );
+		h.AddValue( ti.ArrayType );
+		for ( int j = 0; ti.MemberInfo != nullptr && ti.MemberInfo[j].MemberName != nullptr; ++j )
+		{
+			ovrMemberInfo const & mi = ti.MemberInfo[j];
+			h.AddString( mi.MemberName );
+			h.AddString( mi.TypeName );
+			h.AddValue( mi.Operator );
+			h.AddValue( mi.Offset );
+			h.AddValue( mi.ArraySize );
+		}
+	}
+	LayoutHash = h.Get();
+}
+
+int ovrReflection::GetTypeIndex( ovrTypeInfo const * typeInfo ) const
+{
+	if ( typeInfo == nullptr )
+	{
+		return -1;
+	}
+	int const * index = TypeIndices.Get( typeInfo->TypeName );
+	return ( index != nullptr && Types[*index] == typeInfo ) ? *index : -1;
+}
+
+ovrTypeInfo const * ovrReflection::GetTypeForIndex( int const index ) const
+{
+	return ( index >= 0 && index < Types.GetSizeI() ) ? Types[index] : nullptr;
+}
+
+void ovrReflection::AddOverload( ovrReflectionOverload * o )
+{
+	for ( int i = 0; i < Overloads.GetSizeI(); ++i )
+	{
+		ovrReflectionOverload const * other = Overloads[i];
+		if ( other->GetType() != o->GetType() || OVR_strcmp( other->GetScope(), o->GetScope() ) != 0 
+				|| OVR_strcmp( other->GetName(), o->GetName() ) != 0 )
+		{
+			continue;
+		}
+		if ( o->GetType() == ovrReflectionOverload::OVERLOAD_FLOAT_DEFAULT_VALUE 
+				&& static_cast< ovrReflectionOverload_FloatDefaultValue const * >( o )->GetValue() 
+						!= static_cast< ovrReflectionOverload_FloatDefaultValue const * >( other )->GetValue() )
+		{
+			continue;
+		}
+		delete o;
+		return;
+	}
+	Overloads.PushBack( o );
 }
 
 ovrMemberInfo const * ovrReflection::FindMemberReflectionInfoRecursive( ovrTypeInfo const * objectTypeInfo, const char * memberName )
@@ -674,13 +800,10 @@ ovrTypeInfo const * ovrReflection::FindTypeInfo( char const * typeName )
 		return nullptr;
 	}
 
-	for ( int i = 0; i < TypeInfoLists.GetSizeI(); ++i )
+	int const * index = TypeIndices.Get( typeName );
+	if ( index != nullptr )
 	{
-		ovrTypeInfo const * ti = StaticFindTypeInfo( TypeInfoLists[i], typeName );
-		if ( ti != nullptr )
-		{
-			return ti;
-		}
+		return Types[*index];
 	}
 	OVR_ASSERT( false );
 	return nullptr;
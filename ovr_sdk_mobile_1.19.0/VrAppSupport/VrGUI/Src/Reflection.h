@@ -15,6 +15,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_String.h"
 #include "Kernel/OVR_Lexer.h"
 #include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_StringHash.h"
 
 namespace OVR {
 
@@ -22,6 +23,8 @@ struct ovrTypeInfo;
 struct ovrMemberInfo;
 class ovrLocale;
 class ovrReflection;
+class ovrReflectionRecorder;
+class ovrReflectionCache;
 
 //==============================================================================================
 // Parsing
@@ -63,6 +66,9 @@ ovrParseResult ParseFloatVector( ovrReflection & refl, ovrLocale const & locale,
 ovrParseResult ParseArray( ovrReflection & refl, ovrLocale const & locale, const char * name, ovrLexer & lex, ovrTypeInfo const * arrayTypeInfo, void * objPtr, size_t const arraySize );
 ovrParseResult ParseObject( ovrReflection & refl, ovrLocale const & locale, const char * name, ovrLexer & lex, ovrTypeInfo const * objectTypeInfo, void * objPtr, size_t const arraySize );
 
+// Assigns a string token the way ParseString does, looking up any @string/ key in the locale.
+void AssignStringToken( ovrLocale const & locale, char const * token, String & out );
+
 //==============================================================================================
 // Reflection data types
 //==============================================================================================
@@ -184,8 +190,27 @@ public:
 	ovrMemberInfo const *			FindMemberReflectionInfo( ovrMemberInfo const * arrayOfMemberType, const char * memberName );
 	ovrTypeInfo const *				FindTypeInfo( char const * typeName );
 
-	void							AddOverload( ovrReflectionOverload * o ) { Overloads.PushBack( o ); }
+	// Every type has an index that is stable for as long as the same type lists are added in
+	// the same order. Returns -1 / nullptr for types that were not added.
+	int								GetTypeIndex( ovrTypeInfo const * typeInfo ) const;
+	ovrTypeInfo const *				GetTypeForIndex( int const index ) const;
+	// Hash of the names, sizes and member offsets of every type. This changes whenever a
+	// change to the reflected types would change how data is parsed into them.
+	uint64_t						GetLayoutHash() const { return LayoutHash; }
+
+	// Takes ownership of o. An overload that is identical to an existing one is deleted,
+	// so that loading the same file twice does not add the same overloads twice.
+	void							AddOverload( ovrReflectionOverload * o );
 	ovrReflectionOverload const *	FindOverload( char const * scope ) const;
+	bool							HasOverloads() const { return Overloads.GetSizeI() > 0; }
+	int								GetNumOverloads() const { return Overloads.GetSizeI(); }
+	ovrReflectionOverload const *	GetOverload( int const index ) const { return Overloads[index]; }
+
+	// While a recorder is set, the parse functions record everything they write so that
+	// the result can be replayed from the cache without lexing the source again.
+	void							SetRecorder( ovrReflectionRecorder * recorder ) { Recorder = recorder; }
+	ovrReflectionRecorder *			GetRecorder() const { return Recorder; }
+	ovrReflectionCache &			GetCache() { return *Cache; }
 
 protected:
 	static ovrTypeInfo const *		StaticFindTypeInfo( ovrTypeInfo const * list, char const * typeName );
@@ -194,9 +219,19 @@ protected:
 private:
 	Array< ovrTypeInfo const * >	TypeInfoLists;
 	Array< ovrReflectionOverload* >	Overloads;
+	Array< ovrTypeInfo const * >	Types;			// every type in every list, in the order added
+	StringHash< int >				TypeIndices;	// type name -> index in Types
+	uint64_t						LayoutHash;
+	ovrReflectionRecorder *			Recorder;
+	ovrReflectionCache *			Cache;
 
 	// can only be allocated and deleted by ovrReflection::Create and ovrReflection::Destroy
-	ovrReflection() { };	
+	ovrReflection()
+		: LayoutHash( 0 )
+		, Recorder( nullptr )
+		, Cache( nullptr )
+	{
+	}
 	virtual	~ovrReflection() { }
 };
 	
@@ -0,0 +1,796 @@
+/************************************************************************************
+
+Filename    :   ReflectionCache.cpp
+Content     :   Binary cache of data parsed through reflection.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "ReflectionCache.h"
+#include "Kernel/OVR_LogUtils.h"
+#if defined( OVR_OS_WIN32 )
+#include <malloc.h>
+#else
+#include <alloca.h>
+#endif
+#include <limits.h>
+#include <stdio.h>
+
+namespace OVR {
+
+// Must be incremented whenever the format of a recording or of the cache changes.
+static uint32_t const REFLECTION_CACHE_VERSION = 1;
+static uint32_t const REFLECTION_CACHE_MAGIC = 0x43464552;	// "REFC"
+
+//==============================
+// ovrHash64::Add
+void ovrHash64::Add( void const * data, size_t const size )
+{
+	uint8_t const * bytes = static_cast< uint8_t const * >( data );
+	uint64_t h = Value;
+	for ( size_t i = 0; i < size; ++i )
+	{
+		h ^= bytes[i];
+		h *= 1099511628211ULL;
+	}
+	Value = h;
+}
+
+//==============================
+// ovrHash64::AddString
+void ovrHash64::AddString( char const * s )
+{
+	Add( s, OVR_strlen( s ) + 1 );
+}
+
+//==============================
+// IsPlainParseFn
+// True for the parse functions that only write typeInfo->Size bytes at the output pointer.
+static bool IsPlainParseFn( ParseFn_t const fn )
+{
+	return fn == ParseBool || fn == ParseInt || fn == ParseFloat || fn == ParseDouble
+			|| fn == ParseEnum || fn == ParseBitFlags || fn == ParseTypesafeNumber_int
+			|| fn == ParseTypesafeNumber_long_long || fn == ParseIntVector || fn == ParseFloatVector;
+}
+
+//==============================================================================================
+// ovrReflectionRecorder
+//==============================================================================================
+
+//==============================
+// ovrReflectionRecorder::ovrReflectionRecorder
+ovrReflectionRecorder::ovrReflectionRecorder( ovrReflection const & refl )
+	: Refl( refl )
+	, Valid( true )
+{
+}
+
+//==============================
+// ovrReflectionRecorder::PutUInt32
+void ovrReflectionRecorder::PutUInt32( uint32_t const value )
+{
+	PutBytes( &value, sizeof( value ) );
+}
+
+//==============================
+// ovrReflectionRecorder::PutBytes
+void ovrReflectionRecorder::PutBytes( void const * data, size_t const size )
+{
+	size_t const oldSize = Data.GetSize();
+	Data.Resize( oldSize + size );
+	memcpy( &Data[oldSize], data, size );
+}
+
+//==============================
+// ovrReflectionRecorder::PutString
+void ovrReflectionRecorder::PutString( char const * s )
+{
+	size_t const length = OVR_strlen( s );
+	PutUInt32( static_cast< uint32_t >( length ) );
+	PutBytes( s, length + 1 );
+}
+
+//==============================
+// ovrReflectionRecorder::GetOffset
+// Values can only be written inside the element that is being parsed.
+bool ovrReflectionRecorder::GetOffset( void const * ptr, size_t const size, uint32_t & offset )
+{
+	if ( Scopes.GetSizeI() == 0 )
+	{
+		Invalidate();
+		return false;
+	}
+	ovrScope const & scope = Scopes.Back();
+	uint8_t const * p = static_cast< uint8_t const * >( ptr );
+	if ( p < scope.Base || p + size > scope.Base + scope.Size )
+	{
+		Invalidate();
+		return false;
+	}
+	offset = static_cast< uint32_t >( p - scope.Base );
+	return true;
+}
+
+//==============================
+// ovrReflectionRecorder::BeginArray
+void ovrReflectionRecorder::BeginArray( void const * arrayPtr, ovrTypeInfo const * arrayTypeInfo, size_t const arraySize )
+{
+	if ( !Valid )
+	{
+		return;
+	}
+	uint32_t offset = 0;
+	if ( Scopes.GetSizeI() > 0 && !GetOffset( arrayPtr, 1, offset ) )
+	{
+		return;
+	}
+	int const typeIndex = Refl.GetTypeIndex( arrayTypeInfo );
+	if ( typeIndex < 0 )
+	{
+		Invalidate();
+		return;
+	}
+	PutOp( REFLECTION_OP_ARRAY );
+	PutUInt32( offset );
+	PutUInt32( static_cast< uint32_t >( typeIndex ) );
+	PutUInt32( static_cast< uint32_t >( arraySize ) );
+
+	ovrScope scope = { static_cast< uint8_t const * >( arrayPtr ), 0 };
+	Scopes.PushBack( scope );
+}
+
+//==============================
+// ovrReflectionRecorder::ResizeArray
+void ovrReflectionRecorder::ResizeArray( int const count )
+{
+	if ( !Valid )
+	{
+		return;
+	}
+	PutOp( REFLECTION_OP_RESIZE );
+	PutUInt32( static_cast< uint32_t >( count ) );
+}
+
+//==============================
+// ovrReflectionRecorder::BeginElement
+void ovrReflectionRecorder::BeginElement( void const * elementPtr, ovrTypeInfo const * elementTypeInfo, int const index )
+{
+	if ( !Valid )
+	{
+		return;
+	}
+	int const typeIndex = Refl.GetTypeIndex( elementTypeInfo );
+	if ( typeIndex < 0 || Scopes.GetSizeI() == 0 || Scopes.Back().Size != 0 )
+	{
+		Invalidate();
+		return;
+	}
+	PutOp( REFLECTION_OP_ELEMENT );
+	PutUInt32( static_cast< uint32_t >( typeIndex ) );
+	PutUInt32( static_cast< uint32_t >( index ) );
+
+	ovrScope scope = { static_cast< uint8_t const * >( elementPtr ), elementTypeInfo->Size };
+	Scopes.PushBack( scope );
+}
+
+//==============================
+// ovrReflectionRecorder::EndElement
+void ovrReflectionRecorder::EndElement()
+{
+	if ( !Valid )
+	{
+		return;
+	}
+	if ( Scopes.GetSizeI() == 0 || Scopes.Back().Size == 0 )
+	{
+		Invalidate();
+		return;
+	}
+	PutOp( REFLECTION_OP_END );
+	Scopes.PopBack();
+}
+
+//==============================
+// ovrReflectionRecorder::EndArray
+void ovrReflectionRecorder::EndArray()
+{
+	if ( !Valid )
+	{
+		return;
+	}
+	if ( Scopes.GetSizeI() == 0 || Scopes.Back().Size != 0 )
+	{
+		Invalidate();
+		return;
+	}
+	PutOp( REFLECTION_OP_END );
+	Scopes.PopBack();
+}
+
+//==============================
+// ovrReflectionRecorder::ParsedValue
+void ovrReflectionRecorder::ParsedValue( void const * ptr, ovrTypeInfo const * typeInfo )
+{
+	if ( typeInfo->ParseFn == ParseString || typeInfo->ParseFn == ParseArray )
+	{
+		return;	// already recorded
+	}
+	if ( !IsPlainParseFn( typeInfo->ParseFn ) )
+	{
+		// we can't know what an unknown parse function did
+		Invalidate();
+		return;
+	}
+	Value( ptr, typeInfo->Size );
+}
+
+//==============================
+// ovrReflectionRecorder::Value
+void ovrReflectionRecorder::Value( void const * ptr, size_t const size )
+{
+	uint32_t offset;
+	if ( !Valid || !GetOffset( ptr, size, offset ) )
+	{
+		return;
+	}
+	PutOp( REFLECTION_OP_VALUE );
+	PutUInt32( offset );
+	PutUInt32( static_cast< uint32_t >( size ) );
+	PutBytes( ptr, size );
+}
+
+//==============================
+// ovrReflectionRecorder::StringValue
+void ovrReflectionRecorder::StringValue( void const * ptr, char const * token )
+{
+	uint32_t offset;
+	if ( !Valid || !GetOffset( ptr, sizeof( String ), offset ) )
+	{
+		return;
+	}
+	PutOp( REFLECTION_OP_STRING );
+	PutUInt32( offset );
+	PutString( token );
+}
+
+//==============================
+// ovrReflectionRecorder::OverloadFloat
+void ovrReflectionRecorder::OverloadFloat( char const * scope, char const * name, float const value )
+{
+	if ( !Valid )
+	{
+		return;
+	}
+	if ( Scopes.GetSizeI() != 0 )
+	{
+		Invalidate();
+		return;
+	}
+	PutOp( REFLECTION_OP_OVERLOAD_FLOAT );
+	PutString( scope );
+	PutString( name );
+	PutBytes( &value, sizeof( value ) );
+}
+
+//==============================
+// ovrReflectionRecorder::EndRecording
+void ovrReflectionRecorder::EndRecording()
+{
+	if ( !Valid )
+	{
+		return;
+	}
+	if ( Scopes.GetSizeI() != 0 )
+	{
+		Invalidate();
+		return;
+	}
+	PutOp( REFLECTION_OP_END );
+}
+
+//==============================================================================================
+// ovrReflectionReplay
+//==============================================================================================
+
+//==============================
+// ovrReflectionReplay::ovrReflectionReplay
+ovrReflectionReplay::ovrReflectionReplay( ovrReflection & refl, ovrLocale const & locale, uint8_t const * data, size_t const size )
+	: Refl( refl )
+	, Locale( locale )
+	, Cur( data )
+	, End( data + size )
+{
+}
+
+//==============================
+// ovrReflectionReplay::GetUInt32
+bool ovrReflectionReplay::GetUInt32( uint32_t & value )
+{
+	if ( static_cast< size_t >( End - Cur ) < sizeof( value ) )
+	{
+		return false;
+	}
+	memcpy( &value, Cur, sizeof( value ) );
+	Cur += sizeof( value );
+	return true;
+}
+
+//==============================
+// ovrReflectionReplay::GetString
+bool ovrReflectionReplay::GetString( char const * & s, uint32_t & length )
+{
+	if ( !GetUInt32( length ) || static_cast< size_t >( End - Cur ) <= length || Cur[length] != 0 )
+	{
+		return false;
+	}
+	s = reinterpret_cast< char const * >( Cur );
+	Cur += length + 1;
+	return true;
+}
+
+//==============================
+// ovrReflectionReplay::GetType
+bool ovrReflectionReplay::GetType( ovrTypeInfo const * & typeInfo )
+{
+	uint32_t index;
+	if ( !GetUInt32( index ) || index > INT_MAX )
+	{
+		return false;
+	}
+	typeInfo = Refl.GetTypeForIndex( static_cast< int >( index ) );
+	return typeInfo != nullptr;
+}
+
+//==============================
+// ovrReflectionReplay::NextOp
+ovrReflectionOp ovrReflectionReplay::NextOp()
+{
+	if ( Cur >= End )
+	{
+		return REFLECTION_OP_INVALID;
+	}
+	uint8_t const op = *Cur++;
+	switch ( op )
+	{
+		case REFLECTION_OP_END:
+		case REFLECTION_OP_ARRAY:
+		case REFLECTION_OP_OVERLOAD_FLOAT:
+			return static_cast< ovrReflectionOp >( op );
+		default:
+			return REFLECTION_OP_INVALID;
+	}
+}
+
+//==============================
+// ovrReflectionReplay::ReadOverloadFloat
+bool ovrReflectionReplay::ReadOverloadFloat( String & scope, String & name, float & value )
+{
+	char const * s;
+	char const * n;
+	uint32_t length;
+	if ( !GetString( s, length ) || !GetString( n, length ) || static_cast< size_t >( End - Cur ) < sizeof( value ) )
+	{
+		return false;
+	}
+	memcpy( &value, Cur, sizeof( value ) );
+	Cur += sizeof( value );
+	scope = s;
+	name = n;
+	return true;
+}
+
+//==============================
+// ovrReflectionReplay::ReadArray
+bool ovrReflectionReplay::ReadArray( ovrTypeInfo const * arrayTypeInfo, void * arrayPtr )
+{
+	uint32_t offset;
+	ovrTypeInfo const * typeInfo;
+	uint32_t arraySize;
+	if ( !GetUInt32( offset ) || !GetType( typeInfo ) || !GetUInt32( arraySize ) )
+	{
+		return false;
+	}
+	if ( offset != 0 || typeInfo != arrayTypeInfo )
+	{
+		return false;
+	}
+	return ReadArrayOps( arrayTypeInfo, arrayPtr, arraySize );
+}
+
+//==============================
+// ovrReflectionReplay::ReadArrayOps
+bool ovrReflectionReplay::ReadArrayOps( ovrTypeInfo const * arrayTypeInfo, void * arrayPtr, uint32_t const arraySize )
+{
+	bool const dynamic = arrayTypeInfo->ArrayType == ovrArrayType::OVR_POINTER || arrayTypeInfo->ArrayType == ovrArrayType::OVR_OBJECT;
+	uint32_t count = 0;
+	for ( ; ; )
+	{
+		if ( Cur >= End )
+		{
+			return false;
+		}
+		uint8_t const op = *Cur++;
+		switch ( op )
+		{
+			case REFLECTION_OP_END:
+				return true;
+			case REFLECTION_OP_RESIZE:
+			{
+				if ( !GetUInt32( count ) || !dynamic || count > INT_MAX || arrayTypeInfo->ResizeArrayFn == nullptr )
+				{
+					return false;
+				}
+				arrayTypeInfo->ResizeArrayFn( arrayPtr, static_cast< int >( count ) );
+				break;
+			}
+			case REFLECTION_OP_ELEMENT:
+			{
+				ovrTypeInfo const * elementTypeInfo;
+				uint32_t index;
+				if ( !GetType( elementTypeInfo ) || !GetUInt32( index ) )
+				{
+					return false;
+				}
+				if ( index >= ( dynamic ? count : arraySize ) || elementTypeInfo->CreateFn == nullptr || arrayTypeInfo->SetArrayElementFn == nullptr )
+				{
+					return false;
+				}
+
+				// same as ParseArray, non-pointer elements are created on the stack and copied to the array
+				void * placementBuffer = nullptr;
+				if ( arrayTypeInfo->ArrayType != ovrArrayType::OVR_POINTER && arrayTypeInfo->ArrayType != ovrArrayType::C_POINTER )
+				{
+#if defined( OVR_OS_WIN32 )
+					placementBuffer = _alloca( elementTypeInfo->Size ) ;
+#else
+					placementBuffer = alloca( elementTypeInfo->Size ) ;
+#endif
+				}
+				void * elementPtr = elementTypeInfo->CreateFn( placementBuffer );
+				if ( !ReadElementOps( elementTypeInfo, static_cast< uint8_t * >( elementPtr ) ) )
+				{
+					return false;
+				}
+				arrayTypeInfo->SetArrayElementFn( arrayPtr, static_cast< int >( index ), elementPtr );
+				break;
+			}
+			default:
+				return false;
+		}
+	}
+}
+
+//==============================
+// ovrReflectionReplay::ReadElementOps
+bool ovrReflectionReplay::ReadElementOps( ovrTypeInfo const * elementTypeInfo, uint8_t * elementPtr )
+{
+	size_t const elementSize = elementTypeInfo->Size;
+	for ( ; ; )
+	{
+		if ( Cur >= End )
+		{
+			return false;
+		}
+		uint8_t const op = *Cur++;
+		uint32_t offset;
+		switch ( op )
+		{
+			case REFLECTION_OP_END:
+				return true;
+			case REFLECTION_OP_VALUE:
+			{
+				uint32_t size;
+				if ( !GetUInt32( offset ) || !GetUInt32( size ) )
+				{
+					return false;
+				}
+				if ( offset > elementSize || size > elementSize - offset || static_cast< size_t >( End - Cur ) < size )
+				{
+					return false;
+				}
+				memcpy( elementPtr + offset, Cur, size );
+				Cur += size;
+				break;
+			}
+			case REFLECTION_OP_STRING:
+			{
+				char const * token;
+				uint32_t length;
+				if ( !GetUInt32( offset ) || !GetString( token, length ) )
+				{
+					return false;
+				}
+				if ( offset > elementSize || sizeof( String ) > elementSize - offset )
+				{
+					return false;
+				}
+				AssignStringToken( Locale, token, *reinterpret_cast< String* >( elementPtr + offset ) );
+				break;
+			}
+			case REFLECTION_OP_ARRAY:
+			{
+				ovrTypeInfo const * arrayTypeInfo;
+				uint32_t arraySize;
+				if ( !GetUInt32( offset ) || !GetType( arrayTypeInfo ) || !GetUInt32( arraySize ) )
+				{
+					return false;
+				}
+				if ( offset >= elementSize || arrayTypeInfo->ParseFn != ParseArray )
+				{
+					return false;
+				}
+				if ( !ReadArrayOps( arrayTypeInfo, elementPtr + offset, arraySize ) )
+				{
+					return false;
+				}
+				break;
+			}
+			default:
+				return false;
+		}
+	}
+}
+
+//==============================================================================================
+// ovrReflectionCache
+//==============================================================================================
+
+//==============================
+// ovrReflectionCache::MakeKey
+uint64_t ovrReflectionCache::MakeKey( ovrReflection const & refl, void const * source, size_t const sourceSize )
+{
+	ovrHash64 h;
+	h.AddValue( REFLECTION_CACHE_VERSION );
+	h.AddValue( refl.GetLayoutHash() );
+	// overloads change the values objects start with
+	for ( int i = 0; i < refl.GetNumOverloads(); ++i )
+	{
+		ovrReflectionOverload const * o = refl.GetOverload( i );
+		h.AddValue( static_cast< int >( o->GetType() ) );
+		h.AddString( o->GetScope() );
+		h.AddString( o->GetName() );
+		if ( o->GetType() == ovrReflectionOverload::OVERLOAD_FLOAT_DEFAULT_VALUE )
+		{
+			h.AddValue( static_cast< ovrReflectionOverload_FloatDefaultValue const * >( o )->GetValue() );
+		}
+	}
+	h.Add( source, sourceSize );
+	return h.Get();
+}
+
+//==============================
+// ovrReflectionCache::Store
+void ovrReflectionCache::Store( uint64_t const key, ovrReflectionRecorder const & recorder )
+{
+	if ( !recorder.IsValid() )
+	{
+		return;
+	}
+	ovrEntry * entry = nullptr;
+	for ( int i = 0; i < Entries.GetSizeI(); ++i )
+	{
+		if ( Entries[i].Key == key )
+		{
+			entry = &Entries[i];
+			break;
+		}
+	}
+	if ( entry == nullptr )
+	{
+		Entries.PushBack( ovrEntry() );
+		entry = &Entries.Back();
+	}
+	entry->Key = key;
+	entry->Data = recorder.GetData();
+	Dirty = true;
+}
+
+//==============================
+// ovrReflectionCache::Find
+bool ovrReflectionCache::Find( uint64_t const key, uint8_t const * & data, size_t & size ) const
+{
+	for ( int i = 0; i < Entries.GetSizeI(); ++i )
+	{
+		if ( Entries[i].Key == key )
+		{
+			data = Entries[i].Data.GetDataPtr();
+			size = Entries[i].Data.GetSize();
+			return true;
+		}
+	}
+	return false;
+}
+
+//==============================
+// ovrReflectionCache::GetNumBytes
+size_t ovrReflectionCache::GetNumBytes() const
+{
+	size_t numBytes = 0;
+	for ( int i = 0; i < Entries.GetSizeI(); ++i )
+	{
+		numBytes += Entries[i].Data.GetSize();
+	}
+	return numBytes;
+}
+
+//==============================
+// ovrReflectionCache::Write
+void ovrReflectionCache::Write( ovrReflection const & refl, MemBufferT< uint8_t > & out ) const
+{
+	uint32_t const numEntries = static_cast< uint32_t >( Entries.GetSize() );
+	uint64_t const layoutHash = refl.GetLayoutHash();
+	size_t size = sizeof( REFLECTION_CACHE_MAGIC ) + sizeof( REFLECTION_CACHE_VERSION ) + sizeof( layoutHash ) + sizeof( numEntries );
+	for ( int i = 0; i < Entries.GetSizeI(); ++i )
+	{
+		size += sizeof( uint64_t ) + sizeof( uint32_t ) + Entries[i].Data.GetSize();
+	}
+	size += sizeof( uint64_t );	// checksum
+
+	out.Realloc( size );
+	uint8_t * p = out;
+	memcpy( p, &REFLECTION_CACHE_MAGIC, sizeof( REFLECTION_CACHE_MAGIC ) );		p += sizeof( REFLECTION_CACHE_MAGIC );
+	memcpy( p, &REFLECTION_CACHE_VERSION, sizeof( REFLECTION_CACHE_VERSION ) );	p += sizeof( REFLECTION_CACHE_VERSION );
+	memcpy( p, &layoutHash, sizeof( layoutHash ) );								p += sizeof( layoutHash );
+	memcpy( p, &numEntries, sizeof( numEntries ) );								p += sizeof( numEntries );
+	for ( int i = 0; i < Entries.GetSizeI(); ++i )
+	{
+		uint32_t const entrySize = static_cast< uint32_t >( Entries[i].Data.GetSize() );
+		memcpy( p, &Entries[i].Key, sizeof( uint64_t ) );	p += sizeof( uint64_t );
+		memcpy( p, &entrySize, sizeof( entrySize ) );		p += sizeof( entrySize );
+		if ( entrySize > 0 )
+		{
+			memcpy( p, Entries[i].Data.GetDataPtr(), entrySize );
+			p += entrySize;
+		}
+	}
+	ovrHash64 checksum;
+	checksum.Add( static_cast< uint8_t * >( out ), p - static_cast< uint8_t * >( out ) );
+	uint64_t const checksumValue = checksum.Get();
+	memcpy( p, &checksumValue, sizeof( checksumValue ) );
+}
+
+//==============================
+// ovrReflectionCache::Read
+bool ovrReflectionCache::Read( ovrReflection const & refl, uint8_t const * data, size_t const size )
+{
+	Entries.Clear();
+
+	size_t const headerSize = sizeof( uint32_t ) * 2 + sizeof( uint64_t ) + sizeof( uint32_t );
+	if ( data == nullptr || size < headerSize + sizeof( uint64_t ) )
+	{
+		return false;
+	}
+
+	uint64_t checksumValue;
+	memcpy( &checksumValue, data + size - sizeof( checksumValue ), sizeof( checksumValue ) );
+	ovrHash64 checksum;
+	checksum.Add( data, size - sizeof( checksumValue ) );
+	if ( checksum.Get() != checksumValue )
+	{
+		OVR_WARN( "Reflection cache: bad checksum" );
+		return false;
+	}
+
+	uint32_t magic;
+	uint32_t version;
+	uint64_t layoutHash;
+	uint32_t numEntries;
+	uint8_t const * p = data;
+	memcpy( &magic, p, sizeof( magic ) );			p += sizeof( magic );
+	memcpy( &version, p, sizeof( version ) );		p += sizeof( version );
+	memcpy( &layoutHash, p, sizeof( layoutHash ) );	p += sizeof( layoutHash );
+	memcpy( &numEntries, p, sizeof( numEntries ) );	p += sizeof( numEntries );
+	if ( magic != REFLECTION_CACHE_MAGIC || version != REFLECTION_CACHE_VERSION || layoutHash != refl.GetLayoutHash() )
+	{
+		// written by another version or for other types, so it has to be rebuilt
+		return false;
+	}
+
+	uint8_t const * const end = data + size - sizeof( checksumValue );
+	for ( uint32_t i = 0; i < numEntries; ++i )
+	{
+		uint64_t key;
+		uint32_t entrySize;
+		if ( static_cast< size_t >( end - p ) < sizeof( key ) + sizeof( entrySize ) )
+		{
+			Entries.Clear();
+			return false;
+		}
+		memcpy( &key, p, sizeof( key ) );				p += sizeof( key );
+		memcpy( &entrySize, p, sizeof( entrySize ) );	p += sizeof( entrySize );
+		if ( static_cast< size_t >( end - p ) < entrySize )
+		{
+			Entries.Clear();
+			return false;
+		}
+		Entries.PushBack( ovrEntry() );
+		ovrEntry & entry = Entries.Back();
+		entry.Key = key;
+		entry.Data.Resize( entrySize );
+		if ( entrySize > 0 )
+		{
+			memcpy( entry.Data.GetDataPtr(), p, entrySize );
+		}
+		p += entrySize;
+	}
+	return true;
+}
+
+//==============================
+// ovrReflectionCache::SetFileName
+void ovrReflectionCache::SetFileName( char const * fileName )
+{
+	FileName = fileName;
+	Loaded = false;
+}
+
+//==============================
+// ovrReflectionCache::Load
+void ovrReflectionCache::Load( ovrReflection const & refl )
+{
+	if ( Loaded || FileName.IsEmpty() )
+	{
+		return;
+	}
+	Loaded = true;
+
+	FILE * f = fopen( FileName.ToCStr(), "rb" );
+	if ( f == nullptr )
+	{
+		// not written yet
+		return;
+	}
+	MemBufferT< uint8_t > data;
+	bool ok = fseek( f, 0, SEEK_END ) == 0;
+	long const size = ok ? ftell( f ) : -1;
+	ok = size > 0 && fseek( f, 0, SEEK_SET ) == 0;
+	if ( ok )
+	{
+		data.Realloc( static_cast< size_t >( size ) );
+		ok = fread( static_cast< uint8_t * >( data ), static_cast< size_t >( size ), 1, f ) == 1;
+	}
+	fclose( f );
+
+	if ( !ok || !Read( refl, data, data.GetSize() ) )
+	{
+		// rewritten by the next Save()
+		OVR_LOG( "Reflection cache: ignoring '%s'", FileName.ToCStr() );
+		return;
+	}
+	Dirty = false;
+	OVR_LOG( "Reflection cache: read %i entries from '%s'", Entries.GetSizeI(), FileName.ToCStr() );
+}
+
+//==============================
+// ovrReflectionCache::Save
+void ovrReflectionCache::Save( ovrReflection const & refl )
+{
+	if ( !Dirty || FileName.IsEmpty() )
+	{
+		return;
+	}
+	Dirty = false;
+
+	MemBufferT< uint8_t > data;
+	Write( refl, data );
+
+	// write a temporary file and rename it, so that a crash never leaves a partial cache
+	String const tempName = FileName + ".tmp";
+	FILE * f = fopen( tempName.ToCStr(), "wb" );
+	if ( f == nullptr )
+	{
+		OVR_WARN( "Reflection cache: failed to write '%s'", tempName.ToCStr() );
+		return;
+	}
+	bool const ok = fwrite( static_cast< uint8_t * >( data ), data.GetSize(), 1, f ) == 1;
+	if ( fclose( f ) != 0 || !ok || rename( tempName.ToCStr(), FileName.ToCStr() ) != 0 )
+	{
+		OVR_WARN( "Reflection cache: failed to write '%s'", FileName.ToCStr() );
+		remove( tempName.ToCStr() );
+	}
+}
+
+} // namespace OVR
@@ -0,0 +1,185 @@
+/************************************************************************************
+
+Filename    :   ReflectionCache.h
+Content     :   Binary cache of data parsed through reflection.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( OVR_ReflectionCache_h )
+#define OVR_ReflectionCache_h
+
+#include "Reflection.h"
+#include "Kernel/OVR_MemBuffer.h"
+
+namespace OVR {
+
+//==============================================================
+// ovrHash64
+// 64-bit FNV-1a hash.
+class ovrHash64
+{
+public:
+	ovrHash64() : Value( 14695981039346656037ULL ) { }
+
+	void		Add( void const * data, size_t const size );
+	// Adds the string including its terminator, so that "ab","c" and "a","bc" differ.
+	void		AddString( char const * s );
+	template< typename T >
+	void		AddValue( T const & value ) { Add( &value, sizeof( value ) ); }
+
+	uint64_t	Get() const { return Value; }
+
+private:
+	uint64_t	Value;
+};
+
+// Ops in a recorded parse. Every op is a byte followed by its operands.
+enum ovrReflectionOp
+{
+	REFLECTION_OP_END,				// ends an array, an element or the recording
+	REFLECTION_OP_ARRAY,			// uint32 offset, uint32 type index, uint32 array size, then ops until OP_END
+	REFLECTION_OP_RESIZE,			// uint32 count
+	REFLECTION_OP_ELEMENT,			// uint32 type index, uint32 index, then ops until OP_END
+	REFLECTION_OP_VALUE,			// uint32 offset, uint32 size, bytes
+	REFLECTION_OP_STRING,			// uint32 offset, uint32 length, bytes, 0
+	REFLECTION_OP_OVERLOAD_FLOAT,	// scope, name (as OP_STRING without the offset), float value
+	REFLECTION_OP_INVALID
+};
+
+//==============================================================
+// ovrReflectionRecorder
+// Records what the parse functions write while it is set on an ovrReflection. Offsets are
+// relative to the array element being parsed, so a recording only holds the values and
+// strings that were parsed and the type indices of the elements that were created.
+// Parse functions that are not known to write plain data invalidate the recording.
+class ovrReflectionRecorder
+{
+public:
+	ovrReflectionRecorder( ovrReflection const & refl );
+
+	void	BeginArray( void const * arrayPtr, ovrTypeInfo const * arrayTypeInfo, size_t const arraySize );
+	void	ResizeArray( int const count );
+	void	BeginElement( void const * elementPtr, ovrTypeInfo const * elementTypeInfo, int const index );
+	void	EndElement();
+	void	EndArray();
+
+	// Records the result of typeInfo->ParseFn. Strings and arrays record themselves.
+	void	ParsedValue( void const * ptr, ovrTypeInfo const * typeInfo );
+	void	Value( void const * ptr, size_t const size );
+	void	StringValue( void const * ptr, char const * token );
+	void	OverloadFloat( char const * scope, char const * name, float const value );
+	// Ends a recording after the last top-level op.
+	void	EndRecording();
+
+	void	Invalidate() { Valid = false; }
+	// True if the recording is complete and can be replayed.
+	bool	IsValid() const { return Valid && Scopes.GetSizeI() == 0; }
+
+	Array< uint8_t > const &	GetData() const { return Data; }
+
+private:
+	struct ovrScope
+	{
+		uint8_t const *	Base;
+		size_t			Size;		// 0 for arrays, since only elements hold values
+	};
+
+	ovrReflection const &	Refl;
+	Array< uint8_t >		Data;
+	Array< ovrScope >		Scopes;
+	bool					Valid;
+
+	void	PutOp( ovrReflectionOp const op ) { Data.PushBack( static_cast< uint8_t >( op ) ); }
+	void	PutUInt32( uint32_t const value );
+	void	PutBytes( void const * data, size_t const size );
+	void	PutString( char const * s );
+	bool	GetOffset( void const * ptr, size_t const size, uint32_t & offset );
+};
+
+//==============================================================
+// ovrReflectionReplay
+// Replays a recording. Top-level ops are read by the caller, which knows what the root
+// arrays are, and ReadArray() does the rest without lexing or looking up any names.
+// Offsets, sizes and indices are checked against the objects being created, so a truncated
+// recording fails cleanly. The contents of a recording are otherwise trusted, which is why
+// ovrReflectionCache::Read() checks the layout hash and a checksum first.
+class ovrReflectionReplay
+{
+public:
+	ovrReflectionReplay( ovrReflection & refl, ovrLocale const & locale, uint8_t const * data, size_t const size );
+
+	// Returns the next top-level op, REFLECTION_OP_INVALID if the recording is corrupt.
+	ovrReflectionOp	NextOp();
+
+	bool			ReadOverloadFloat( String & scope, String & name, float & value );
+	// Reads an OP_ARRAY, which must be of type arrayTypeInfo, into arrayPtr.
+	bool			ReadArray( ovrTypeInfo const * arrayTypeInfo, void * arrayPtr );
+
+private:
+	ovrReflection &		Refl;
+	ovrLocale const &	Locale;
+	uint8_t const *		Cur;
+	uint8_t const *		End;
+
+	bool				GetUInt32( uint32_t & value );
+	bool				GetString( char const * & s, uint32_t & length );
+	bool				GetType( ovrTypeInfo const * & typeInfo );
+	bool				ReadArrayOps( ovrTypeInfo const * arrayTypeInfo, void * arrayPtr, uint32_t const arraySize );
+	bool				ReadElementOps( ovrTypeInfo const * elementTypeInfo, uint8_t * elementPtr );
+};
+
+//==============================================================
+// ovrReflectionCache
+// Recordings of parsed files keyed by a hash of the source and of everything else that
+// affects the parse, so a file that was already parsed can be replayed instead. Strings
+// are recorded before @string/ keys are looked up, so recordings do not depend on the locale.
+class ovrReflectionCache
+{
+public:
+	ovrReflectionCache() : Loaded( false ), Dirty( false ) { }
+
+	// Key for parsing source with the current types and overloads of refl.
+	static uint64_t	MakeKey( ovrReflection const & refl, void const * source, size_t const sourceSize );
+
+	// Stores the recording for key if it is valid.
+	void			Store( uint64_t const key, ovrReflectionRecorder const & recorder );
+	bool			Find( uint64_t const key, uint8_t const * & data, size_t & size ) const;
+	void			Clear() { Entries.Clear(); }
+
+	int				GetNumEntries() const { return Entries.GetSizeI(); }
+	size_t			GetNumBytes() const;
+
+	// Writes every entry so the cache can outlive the process. Read() replaces the current
+	// entries and fails, leaving the cache empty, if the data was written for other types.
+	void			Write( ovrReflection const & refl, MemBufferT< uint8_t > & out ) const;
+	bool			Read( ovrReflection const & refl, uint8_t const * data, size_t const size );
+
+	// Sets the file that Load() reads and Save() writes. Without one, the cache only lives
+	// as long as the process.
+	void			SetFileName( char const * fileName );
+	// Reads the file the first time it is called. Must be called after every type list was
+	// added, since a file written for other types is ignored.
+	void			Load( ovrReflection const & refl );
+	// Writes the file if entries were stored since it was read or last written.
+	void			Save( ovrReflection const & refl );
+
+private:
+	struct ovrEntry
+	{
+		uint64_t			Key;
+		Array< uint8_t >	Data;
+	};
+
+	Array< ovrEntry >	Entries;
+	String				FileName;
+	bool				Loaded;
+	bool				Dirty;
+};
+
+} // namespace OVR
+
+#endif // OVR_ReflectionCache_h
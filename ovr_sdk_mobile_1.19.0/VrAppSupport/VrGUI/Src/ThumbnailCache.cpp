@@ -0,0 +1,393 @@
+/************************************************************************************
+
+Filename    :   ThumbnailCache.cpp
+Content     :   Pack file of decoded thumbnails keyed by the content of their source images.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#include "ThumbnailCache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_LogUtils.h"
+#include "Kernel/OVR_Std.h"
+#include "OVR_PackWriter.h"
+#include "unzip.h"
+
+namespace OVR {
+
+static const int KEY_SAMPLE_SIZE = 64 * 1024;
+
+// A pack that grows past this is started over when it is next opened.
+static const uint64_t MAX_PACK_SIZE = 256 * 1024 * 1024;
+
+// Thumbnails that are added within this long of each other are appended to the pack
+// together, so that a folder scan does not write a central directory per thumbnail.
+static const unsigned WRITE_DELAY_MS = 1000;
+
+static void MakeThumbnailName( char * name, const size_t size, const uint64_t key, const int width, const int height )
+{
+	OVR_sprintf( name, size, "%016llx-%dx%d.rgba", (unsigned long long)key, width, height );
+}
+
+static bool ReadAt( const int fd, void * data, const size_t size, const uint64_t offset )
+{
+	uint8_t * bytes = static_cast< uint8_t * >( data );
+	size_t read = 0;
+	while ( read < size )
+	{
+		const ssize_t r = pread( fd, bytes + read, size - read, (off_t)( offset + read ) );
+		if ( r <= 0 )
+		{
+			return false;
+		}
+		read += (size_t)r;
+	}
+	return true;
+}
+
+//==============================
+// OvrThumbnailCache::OvrThumbnailCache
+OvrThumbnailCache::OvrThumbnailCache() :
+	FlushWaiters( 0 ),
+	ShuttingDown( false ),
+	WriterThread( NULL )
+{
+}
+
+//==============================
+// OvrThumbnailCache::~OvrThumbnailCache
+OvrThumbnailCache::~OvrThumbnailCache()
+{
+	Close();
+}
+
+//==============================
+// OvrThumbnailCache::Open
+bool OvrThumbnailCache::Open( const char * packPath )
+{
+	Close();
+
+	PackPath = packPath;
+	struct stat st;
+	if ( stat( packPath, &st ) == 0 && (uint64_t)st.st_size > MAX_PACK_SIZE )
+	{
+		OVR_LOG( "OvrThumbnailCache::Open: starting %s over", packPath );
+		remove( packPath );
+	}
+	if ( !ReadPack() )
+	{
+		// Appending nothing cuts off an append that did not finish, and starts over a pack
+		// that cannot be read at all.
+		ovrPackWriter writer;
+		if ( !writer.Open( packPath, true, 0 ) || !writer.Close() )
+		{
+			OVR_WARN( "OvrThumbnailCache::Open: failed to write %s", packPath );
+			Close();
+			return false;
+		}
+		// unzip does not open a pack without files, which has no thumbnails to find anyway
+		ReadPack();
+	}
+
+	OVR_LOG( "OvrThumbnailCache::Open: %d thumbnails in %s", Entries.GetSizeI(), packPath );
+
+	ShuttingDown = false;
+	WriterThread = new Thread( Thread::CreateParams( WriterThreadFunction, this, 128 * 1024, -1, Thread::NotRunning, Thread::BelowNormalPriority ) );
+	WriterThread->Start();
+	return true;
+}
+
+//==============================
+// OvrThumbnailCache::Close
+void OvrThumbnailCache::Close()
+{
+	if ( WriterThread != NULL )
+	{
+		Flush();
+		CacheMutex.DoLock();
+		ShuttingDown = true;
+		PendingCondition.NotifyAll();
+		CacheMutex.Unlock();
+		WriterThread->Join();
+		delete WriterThread;
+		WriterThread = NULL;
+	}
+	PackView.Close();
+	PackFile.Close();
+	Entries.Clear();
+}
+
+//==============================
+// OvrThumbnailCache::CalculateKey
+uint64_t OvrThumbnailCache::CalculateKey( const char * fileName )
+{
+	const int fd = open( fileName, O_RDONLY );
+	if ( fd < 0 )
+	{
+		return 0;
+	}
+	struct stat st;
+	if ( fstat( fd, &st ) != 0 )
+	{
+		close( fd );
+		return 0;
+	}
+	const uint64_t size = (uint64_t)st.st_size;
+
+	// FNV-1a over the size and the sampled contents
+	uint64_t key = 14695981039346656037ULL;
+	for ( int i = 0; i < 8; i++ )
+	{
+		key = ( key ^ ( ( size >> ( i * 8 ) ) & 0xFF ) ) * 1099511628211ULL;
+	}
+
+	uint8_t * buffer = static_cast< uint8_t * >( malloc( KEY_SAMPLE_SIZE ) );
+	const uint64_t headSize = Alg::Min( size, (uint64_t)KEY_SAMPLE_SIZE );
+	const uint64_t tailOffset = Alg::Max( size - Alg::Min( size, (uint64_t)KEY_SAMPLE_SIZE ), headSize );
+	const uint64_t samples[2][2] = { { 0, headSize }, { tailOffset, size - tailOffset } };
+	bool ok = true;
+	for ( int s = 0; s < 2 && ok; s++ )
+	{
+		ok = ReadAt( fd, buffer, (size_t)samples[s][1], samples[s][0] );
+		for ( uint64_t i = 0; i < samples[s][1] && ok; i++ )
+		{
+			key = ( key ^ buffer[i] ) * 1099511628211ULL;
+		}
+	}
+	free( buffer );
+	close( fd );
+
+	if ( !ok )
+	{
+		return 0;
+	}
+	return ( key != 0 ) ? key : 1;
+}
+
+//==============================
+// OvrThumbnailCache::Find
+unsigned char * OvrThumbnailCache::Find( const uint64_t key, int & width, int & height )
+{
+	Mutex::Locker locker( &CacheMutex );
+
+	for ( int i = Pending.GetSizeI() - 1; i >= 0; i-- )
+	{
+		const ovrPendingThumbnail & pending = Pending[i];
+		if ( pending.Key == key )
+		{
+			const size_t size = (size_t)pending.Width * pending.Height * 4;
+			unsigned char * data = static_cast< unsigned char * >( malloc( size ) );
+			memcpy( data, pending.Data, size );
+			width = pending.Width;
+			height = pending.Height;
+			return data;
+		}
+	}
+
+	const ovrEntry * entry = Entries.Get( key );
+	if ( entry == NULL )
+	{
+		return NULL;
+	}
+
+	const size_t size = (size_t)entry->Width * entry->Height * 4;
+	unsigned char * data = static_cast< unsigned char * >( malloc( size ) );
+	memcpy( data, PackView.GetFront() + entry->Offset, size );
+	width = entry->Width;
+	height = entry->Height;
+	return data;
+}
+
+//==============================
+// OvrThumbnailCache::Add
+void OvrThumbnailCache::Add( const uint64_t key, const unsigned char * rgba, const int width, const int height )
+{
+	if ( key == 0 || rgba == NULL || width <= 0 || height <= 0 )
+	{
+		return;
+	}
+
+	Mutex::Locker locker( &CacheMutex );
+
+	if ( WriterThread == NULL || PackFile.GetLength() >= MAX_PACK_SIZE || Entries.Get( key ) != NULL )
+	{
+		return;
+	}
+	for ( int i = 0; i < Pending.GetSizeI(); i++ )
+	{
+		if ( Pending[i].Key == key )
+		{
+			return;
+		}
+	}
+
+	const size_t size = (size_t)width * height * 4;
+	ovrPendingThumbnail pending;
+	pending.Key = key;
+	pending.Width = width;
+	pending.Height = height;
+	pending.Data = static_cast< unsigned char * >( malloc( size ) );
+	memcpy( pending.Data, rgba, size );
+	Pending.PushBack( pending );
+	// the writer thread only waits for the first of a batch
+	if ( Pending.GetSizeI() == 1 )
+	{
+		PendingCondition.NotifyAll();
+	}
+}
+
+//==============================
+// OvrThumbnailCache::Flush
+void OvrThumbnailCache::Flush()
+{
+	Mutex::Locker locker( &CacheMutex );
+	FlushWaiters++;
+	PendingCondition.NotifyAll();
+	while ( Pending.GetSizeI() > 0 && WriterThread != NULL )
+	{
+		WrittenCondition.Wait( &CacheMutex );
+	}
+	FlushWaiters--;
+}
+
+//==============================
+// OvrThumbnailCache::WriterThreadFunction
+threadReturn_t OvrThumbnailCache::WriterThreadFunction( Thread * thread, void * v )
+{
+	thread->SetThreadName( "ThumbnailCache" );
+	static_cast< OvrThumbnailCache * >( v )->WritePending();
+	return NULL;
+}
+
+//==============================
+// OvrThumbnailCache::WritePending
+void OvrThumbnailCache::WritePending()
+{
+	CacheMutex.DoLock();
+	for ( ;; )
+	{
+		while ( Pending.GetSizeI() == 0 && !ShuttingDown )
+		{
+			PendingCondition.Wait( &CacheMutex );
+		}
+		if ( Pending.GetSizeI() == 0 )
+		{
+			break;
+		}
+		if ( FlushWaiters == 0 && !ShuttingDown )
+		{
+			PendingCondition.Wait( &CacheMutex, WRITE_DELAY_MS );
+		}
+
+		// the thumbnails stay in Pending, where Find() can get them, until they are in the pack
+		Array< ovrPendingThumbnail > batch;
+		batch.Append( Pending.GetDataPtr(), Pending.GetSize() );
+		CacheMutex.Unlock();
+
+		ovrPackWriter writer;
+		bool written = writer.Open( PackPath.ToCStr(), true, 0 );
+		for ( int i = 0; i < batch.GetSizeI() && written; i++ )
+		{
+			char name[64];
+			MakeThumbnailName( name, sizeof( name ), batch[i].Key, batch[i].Width, batch[i].Height );
+			written = writer.AddFile( name, batch[i].Data, (size_t)batch[i].Width * batch[i].Height * 4, true );
+		}
+		// the pack is left as it was if anything could not be written
+		written = written && writer.Close();
+		if ( !written )
+		{
+			OVR_WARN( "OvrThumbnailCache: failed to write %d thumbnails", batch.GetSizeI() );
+		}
+
+		CacheMutex.DoLock();
+		if ( written && !ReadPack() )
+		{
+			OVR_WARN( "OvrThumbnailCache: failed to read %s", PackPath.ToCStr() );
+		}
+		for ( int i = 0; i < batch.GetSizeI(); i++ )
+		{
+			free( batch[i].Data );
+		}
+		Pending.RemoveMultipleAt( 0, batch.GetSize() );
+		WrittenCondition.NotifyAll();
+	}
+	CacheMutex.Unlock();
+}
+
+//==============================
+// OvrThumbnailCache::ReadPack
+// Maps the pack and finds the thumbnails in it. Called before the writer thread is started,
+// or with CacheMutex locked.
+bool OvrThumbnailCache::ReadPack()
+{
+	PackView.Close();
+	PackFile.Close();
+	Entries.Clear();
+
+	unzFile pack = unzOpen( PackPath.ToCStr() );
+	if ( pack == NULL )
+	{
+		return false;
+	}
+	unz_global_info info;
+	if ( unzGetGlobalInfo( pack, &info ) != UNZ_OK ||
+			!PackFile.OpenRead( PackPath.ToCStr() ) || !PackView.Open( &PackFile ) || PackView.MapView() == NULL )
+	{
+		unzClose( pack );
+		PackView.Close();
+		PackFile.Close();
+		return false;
+	}
+
+	int ret = ( info.number_entry > 0 ) ? unzGoToFirstFile( pack ) : UNZ_END_OF_LIST_OF_FILE;
+	for ( ; ret == UNZ_OK; ret = unzGoToNextFile( pack ) )
+	{
+		char name[64];
+		unz_file_info fileInfo;
+		unsigned long long key = 0;
+		ovrEntry entry;
+		if ( unzGetCurrentFileInfo( pack, &fileInfo, name, sizeof( name ), NULL, 0, NULL, 0 ) != UNZ_OK )
+		{
+			break;
+		}
+		// only stored thumbnails can be copied out of the mapping
+		if ( sscanf( name, "%16llx-%dx%d.rgba", &key, &entry.Width, &entry.Height ) != 3 ||
+				entry.Width <= 0 || entry.Height <= 0 || fileInfo.compression_method != 0 ||
+				(uint64_t)fileInfo.uncompressed_size != (uint64_t)entry.Width * entry.Height * 4 ||
+				unzOpenCurrentFile( pack ) != UNZ_OK )
+		{
+			continue;
+		}
+		// the data starts after the local header, which is only read when the file is opened
+		entry.Offset = (size_t)unzGetCurrentFileZStreamPos64( pack );
+		unzCloseCurrentFile( pack );
+		if ( entry.Offset + fileInfo.uncompressed_size <= PackView.GetLength() )
+		{
+			Entries.Set( key, entry );
+		}
+	}
+	unzClose( pack );
+
+	if ( ret != UNZ_END_OF_LIST_OF_FILE )
+	{
+		PackView.Close();
+		PackFile.Close();
+		Entries.Clear();
+		return false;
+	}
+	return true;
+}
+
+} // namespace OVR
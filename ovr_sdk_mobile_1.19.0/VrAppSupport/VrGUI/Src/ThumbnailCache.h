@@ -0,0 +1,100 @@
+/************************************************************************************
+
+Filename    :   ThumbnailCache.h
+Content     :   Pack file of decoded thumbnails keyed by the content of their source images.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#if !defined( OVR_ThumbnailCache_h )
+#define OVR_ThumbnailCache_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Hash.h"
+#include "Kernel/OVR_MappedFile.h"
+#include "Kernel/OVR_String.h"
+#include "Kernel/OVR_Threads.h"
+
+namespace OVR {
+
+//==============================================================
+// OvrThumbnailCache
+//
+// Keeps decoded RGBA thumbnails in a single pack file so that browsing a folder of large
+// images only decodes each image once. The pack is a zip written by ovrPackWriter, with
+// each thumbnail stored as "<key>-<width>x<height>.rgba", and it is memory-mapped so that
+// thumbnails are copied out of it in place. Thumbnails that are added are appended to it in
+// batches on a writer thread, so that Add() never waits for the disk. A pack that was cut
+// short by a crash loses only the unfinished append, and a pack that has grown past 256 MB
+// is started over.
+//
+// All functions can be called from any thread.
+class OvrThumbnailCache
+{
+public:
+						OvrThumbnailCache();
+						~OvrThumbnailCache();
+
+	// Maps the pack at packPath, creating it if it does not exist or is not a pack.
+	bool				Open( const char * packPath );
+	// Waits for queued thumbnails to be written and closes the pack.
+	void				Close();
+
+	bool				IsOpen() const { return WriterThread != NULL; }
+
+	// Returns a key for the contents of a file, or 0 if the file cannot be read. To avoid
+	// reading all of a large image, only its size and its first and last 64 kB are hashed,
+	// which covers the JPEG headers, the EXIF data and the end of the compressed data.
+	static uint64_t		CalculateKey( const char * fileName );
+
+	// Returns a copy of the thumbnail to be released with free(), or NULL if it is not cached.
+	unsigned char *		Find( const uint64_t key, int & width, int & height );
+
+	// Copies the thumbnail and queues it to be appended to the pack.
+	void				Add( const uint64_t key, const unsigned char * rgba, const int width, const int height );
+
+	// Waits until all queued thumbnails have been written.
+	void				Flush();
+
+private:
+	struct ovrEntry
+	{
+		size_t			Offset;		// of the pixels in PackView
+		int				Width;
+		int				Height;
+	};
+
+	struct ovrPendingThumbnail
+	{
+		uint64_t		Key;
+		int				Width;
+		int				Height;
+		unsigned char *	Data;
+	};
+
+	Hash< uint64_t, ovrEntry >		Entries;
+	Array< ovrPendingThumbnail >	Pending;		// oldest first, written by WriterThread
+	Mutex							CacheMutex;
+	WaitCondition					PendingCondition;
+	WaitCondition					WrittenCondition;
+	int								FlushWaiters;	// write the pending thumbnails now
+	bool							ShuttingDown;
+
+	String							PackPath;
+	MappedFile						PackFile;
+	MappedView						PackView;
+	Thread *						WriterThread;
+
+	static threadReturn_t			WriterThreadFunction( Thread * thread, void * v );
+	void							WritePending();
+	bool							ReadPack();
+};
+
+} // namespace OVR
+
+#endif // OVR_ThumbnailCache_h
@@ -25,6 +25,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "App.h"
 #include "GuiSys.h"
 #include "Reflection.h"
+#include "ReflectionCache.h"
 #include "OVR_FileSys.h"
 
 //#define OVR_USE_PERF_TIMER
@@ -162,6 +163,18 @@ void VRMenu::AddItems( OvrGuiSys & guiSys,
 
 	Array< ChildParmsPair > pairs;
 
+	// create the objects in one batch so storage for all of them is reserved up front
+	Array< menuHandle_t > handles;
+	{
+#if defined( OVR_USE_PERF_TIMER )
+		double const createObjectStartTime = vrapi_GetTimeInSeconds();
+#endif
+		guiSys.GetVRMenuMgr().CreateObjects( itemParms, handles );
+#if defined( OVR_USE_PERF_TIMER )
+		createObjectTotal += vrapi_GetTimeInSeconds() - createObjectStartTime;
+#endif
+	}
+
 	Vector3f nextItemPos( 0.0f );
 	int childIndex = 0;
 	for ( int i = 0; i < itemParms.GetSizeI(); ++i )
@@ -179,13 +192,7 @@ void VRMenu::AddItems( OvrGuiSys & guiSys,
 		}
 #endif
 
-#if defined( OVR_USE_PERF_TIMER )
-		double const createObjectStartTime = vrapi_GetTimeInSeconds();
-#endif
-		menuHandle_t handle = guiSys.GetVRMenuMgr().CreateObject( *parms );
-#if defined( OVR_USE_PERF_TIMER )
-		createObjectTotal += vrapi_GetTimeInSeconds() - createObjectStartTime;
-#endif
+		menuHandle_t handle = handles[i];
 
 		if ( handle.IsValid() && root != NULL )
 		{
@@ -728,28 +735,43 @@ void VRMenu::SetSelected( OvrGuiSys & guiSys, VRMenuId_t const itemId, bool cons
 	return SetSelected( obj, selected );
 }
 
+//==============================
+// ReadReflectionFile
+// Reads a reflection file and 0-terminates it.
+static bool ReadReflectionFile( ovrFileSys & fileSys, char const * fileName, MemBufferT< uint8_t > & parmBuffer )
+{
+	if ( !fileSys.ReadFile( fileName, parmBuffer ) )
+	{
+		return false;
+	}
+
+	size_t newSize = parmBuffer.GetSize() + 1;
+	uint8_t * temp = new uint8_t[newSize];
+	memcpy( temp, static_cast< uint8_t* >( parmBuffer ), parmBuffer.GetSize() );
+	temp[parmBuffer.GetSize()] = 0;
+	parmBuffer.TakeOwnershipOfBuffer( *(void**)&temp, newSize );
+	return true;
+}
+
 //==============================
 // VRMenu::InitFromReflectionData
 bool VRMenu::InitFromReflectionData( OvrGuiSys & guiSys, ovrFileSys & fileSys, ovrReflection & refl, 
 	ovrLocale const & locale, char const * fileNames[], float const menuDistance, VRMenuFlags_t const & flags )
 {
+	// reads the cache written by an earlier run, now that the app added its types
+	refl.GetCache().Load( refl );
+
 	Array< VRMenuObjectParms const * > itemParms;
 	for ( int i = 0; fileNames[i] != nullptr; ++i )
 	{
 		MemBufferT< uint8_t > parmBuffer;
-		if ( !fileSys.ReadFile( fileNames[i], parmBuffer ) )
+		if ( !ReadReflectionFile( fileSys, fileNames[i], parmBuffer ) )
 		{
 			DeletePointerArray( itemParms );
 			OVR_LOG( "Failed to load reflection file '%s'.", fileNames[i] );
 			return false;
 		}
 
-		size_t newSize = parmBuffer.GetSize() + 1;
-		uint8_t * temp = new uint8_t[newSize];
-		memcpy( temp, static_cast< uint8_t* >( parmBuffer ), parmBuffer.GetSize() );
-		temp[parmBuffer.GetSize()] = 0;
-		parmBuffer.TakeOwnershipOfBuffer( *(void**)&temp, newSize );
-
 		ovrParseResult parseResult = VRMenuObject::ParseItemParms( refl, locale, fileNames[i], parmBuffer, itemParms );
 		if ( !parseResult )
 		{
@@ -759,9 +781,13 @@ bool VRMenu::InitFromReflectionData( OvrGuiSys & guiSys, ovrFileSys & fileSys, o
 		}
 	} 
 
+	// keeps any file that was parsed from text for the next run
+	refl.GetCache().Save( refl );
+
 	InitWithItems( guiSys, menuDistance, flags, itemParms );
 	return true;
 }
 
+
 } // namespace OVR
 
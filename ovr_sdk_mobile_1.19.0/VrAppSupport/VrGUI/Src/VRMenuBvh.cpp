@@ -0,0 +1,566 @@
+/************************************************************************************
+
+Filename    :   VRMenuBvh.cpp
+Content     :   Bounding volume hierarchy for hit testing menu objects.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#include "VRMenuBvh.h"
+
+#include "Kernel/OVR_Alg.h"
+#include "VRMenuMgr.h"
+#include "GuiSys.h"
+
+namespace OVR {
+
+//==============================
+// PosesEqual
+static inline bool PosesEqual( Posef const & a, Posef const & b )
+{
+	return a.Rotation == b.Rotation && a.Translation == b.Translation;
+}
+
+//==============================
+// IntersectRayBounds
+// Slab test that returns the unclamped distance at which the ray line enters the bounds.
+static bool IntersectRayBounds( Vector3f const & start, Vector3f const & dir, Vector3f const & invDir,
+		Bounds3f const & bounds, float & tEntry )
+{
+	float t0 = -FLT_MAX;
+	float t1 = FLT_MAX;
+	for ( int axis = 0; axis < 3; ++axis )
+	{
+		if ( fabsf( dir[axis] ) < MATH_FLOAT_SMALLEST_NON_DENORMAL )
+		{
+			// parallel to this slab
+			if ( start[axis] < bounds.b[0][axis] || start[axis] > bounds.b[1][axis] )
+			{
+				return false;
+			}
+			continue;
+		}
+		float ta = ( bounds.b[0][axis] - start[axis] ) * invDir[axis];
+		float tb = ( bounds.b[1][axis] - start[axis] ) * invDir[axis];
+		if ( ta > tb )
+		{
+			Alg::Swap( ta, tb );
+		}
+		t0 = Alg::Max( t0, ta );
+		t1 = Alg::Min( t1, tb );
+	}
+	if ( t1 < t0 || t1 < 0.0f )
+	{
+		return false;
+	}
+	tEntry = t0;
+	return true;
+}
+
+//==============================================================
+// ovrCenterLess
+// Orders entry indices by the center of their bounds along one axis.
+class ovrCenterLess
+{
+public:
+	ovrCenterLess( Array< Vector3f > const & centers, int const axis ) :
+		Centers( centers ),
+		Axis( axis )
+	{
+	}
+
+	bool operator()( int const a, int const b ) const
+	{
+		return Centers[a][Axis] < Centers[b][Axis];
+	}
+
+private:
+	Array< Vector3f > const &	Centers;
+	int							Axis;
+};
+
+//==============================
+// ovrVRMenuBvh::ovrVRMenuBvh
+ovrVRMenuBvh::ovrVRMenuBvh( menuHandle_t const rootHandle )
+	: RootHandle( rootHandle )
+	, WorldPoseStamp( 0 )
+	, NeedsRebuild( true )
+{
+}
+
+//==============================
+// ovrVRMenuBvh::IsExcluded
+// True if HitTest_r never tests the object or any of its children.
+bool ovrVRMenuBvh::IsExcluded( VRMenuObject const & obj )
+{
+	return ( obj.GetFlags() & ( VRMenuObjectFlags_t( VRMENUOBJECT_DONT_RENDER ) | VRMENUOBJECT_DONT_HIT_ALL ) ) != 0;
+}
+
+//==============================
+// ovrVRMenuBvh::ObjectChanged
+void ovrVRMenuBvh::ObjectChanged( VRMenuObject const & obj )
+{
+	if ( NeedsRebuild )
+	{
+		return;
+	}
+
+	menuHandle_t const handle = obj.GetHandle();
+	if ( handle == RootHandle )
+	{
+		// the root may have been shown or hidden
+		if ( Entries.GetSizeI() == 0 || IsExcluded( obj ) || obj.NumChildren() != Entries[0].NumChildren )
+		{
+			NeedsRebuild = true;
+			return;
+		}
+	}
+
+	int const * entryIndex = EntryForHandle.Get( handle.Get() );
+	if ( entryIndex != NULL )
+	{
+		// an object in the hierarchy that was hidden or had children added or removed
+		ovrEntry const & entry = Entries[*entryIndex];
+		if ( IsExcluded( obj ) || obj.NumChildren() != entry.NumChildren )
+		{
+			NeedsRebuild = true;
+			return;
+		}
+		if ( !EntryStale[*entryIndex] )
+		{
+			EntryStale[*entryIndex] = true;
+			StaleEntries.PushBack( *entryIndex );
+		}
+		return;
+	}
+
+	// Objects outside of the hierarchy only matter if they just became hittable below an
+	// object that is in it. Objects that are added to the hierarchy change the child count
+	// of their new parent.
+	if ( !IsExcluded( obj ) && EntryForHandle.Get( obj.GetParentHandle().Get() ) != NULL )
+	{
+		NeedsRebuild = true;
+	}
+}
+
+//==============================
+// ovrVRMenuBvh::AddEntries_r
+void ovrVRMenuBvh::AddEntries_r( OvrVRMenuMgr const & menuMgr, VRMenuObject const & obj, int const parent )
+{
+	int const index = Entries.GetSizeI();
+	Entries.PushBack( ovrEntry() );
+	Entries[index].Handle = obj.GetHandle();
+	Entries[index].Parent = parent;
+	Entries[index].NumChildren = obj.NumChildren();
+	EntryForHandle.Set( obj.GetHandle().Get(), index );
+
+	for ( int i = 0; i < obj.NumChildren(); ++i )
+	{
+		VRMenuObject const * child = menuMgr.ToObject( obj.GetChildHandleForIndex( i ) );
+		if ( child != NULL && !IsExcluded( *child ) )
+		{
+			AddEntries_r( menuMgr, *child, index );
+		}
+	}
+
+	Entries[index].SubtreeEnd = Entries.GetSizeI();
+}
+
+//==============================
+// ovrVRMenuBvh::UpdateEntry
+// Entries must be updated after their parent.
+void ovrVRMenuBvh::UpdateEntry( OvrGuiSys const & guiSys, int const index )
+{
+	ovrEntry & entry = Entries[index];
+	VRMenuObject const * obj = guiSys.GetVRMenuMgr().ToObject( entry.Handle );
+	if ( obj == NULL )
+	{
+		NeedsRebuild = true;
+		return;
+	}
+
+	Posef parentPose;
+	Vector3f parentScale( 1.0f );
+	if ( entry.Parent >= 0 )
+	{
+		parentPose = Entries[entry.Parent].MenuPose;
+		parentScale = Entries[entry.Parent].Scale;
+	}
+
+	Vector4f color;
+	entry.LocalPose = obj->GetLocalPose();
+	entry.LocalScale = obj->GetLocalScale();
+	VRMenuObject::TransformByParent( parentPose, parentScale, Vector4f( 1.0f ), entry.LocalPose,
+			entry.LocalScale, Vector4f( 1.0f ), obj->GetFlags(), entry.MenuPose, entry.Scale, color );
+	entry.ParentScale = parentScale;
+	entry.MenuBounds = Bounds3f::Transform( entry.MenuPose,
+			obj->GetHitTestBounds( guiSys.GetDefaultFont(), parentScale ) );
+	entry.Contents = obj->GetContents();
+	entry.ModelPoseStamp = WorldPoseStamp - 1;
+}
+
+//==============================
+// ovrVRMenuBvh::GetModelPose
+// Composes the world pose from the world pose of the menu down, in the same order as
+// HitTest_r, so the ray is transformed into exactly the same local space. Only the
+// entries that are actually tested, and their parents, are updated after the menu moves.
+Posef const & ovrVRMenuBvh::GetModelPose( int const index )
+{
+	ovrEntry & entry = Entries[index];
+	if ( entry.ModelPoseStamp != WorldPoseStamp )
+	{
+		Posef const & parentPose = entry.Parent >= 0 ? GetModelPose( entry.Parent ) : WorldPose;
+		Vector3f scale;
+		Vector4f color;
+		VRMenuObject::TransformByParent( parentPose, entry.ParentScale, Vector4f( 1.0f ), entry.LocalPose,
+				entry.LocalScale, Vector4f( 1.0f ), VRMenuObjectFlags_t(), entry.ModelPose, scale, color );
+		entry.ModelPoseStamp = WorldPoseStamp;
+	}
+	return entry.ModelPose;
+}
+
+//==============================
+// ovrVRMenuBvh::BuildNode_r
+int ovrVRMenuBvh::BuildNode_r( Array< Vector3f > const & centers, int const parent, int const first, int const count )
+{
+	int const nodeIndex = Nodes.GetSizeI();
+	Nodes.PushBack( ovrNode() );
+
+	Bounds3f bounds( Bounds3f::Init );
+	Bounds3f centerBounds( Bounds3f::Init );
+	ContentFlags_t contents;
+	for ( int i = first; i < first + count; ++i )
+	{
+		ovrEntry const & entry = Entries[LeafEntries[i]];
+		bounds = Bounds3f::Union( bounds, entry.MenuBounds );
+		centerBounds.AddPoint( centers[LeafEntries[i]] );
+		contents |= entry.Contents;
+	}
+
+	{
+		ovrNode & node = Nodes[nodeIndex];
+		node.Bounds = bounds;
+		node.Contents = contents;
+		node.Parent = parent;
+		node.Left = -1;
+		node.Right = -1;
+		node.First = first;
+		node.Count = count;
+	}
+
+	if ( count <= MAX_LEAF_ENTRIES )
+	{
+		for ( int i = first; i < first + count; ++i )
+		{
+			EntryLeaf[LeafEntries[i]] = nodeIndex;
+		}
+		return nodeIndex;
+	}
+
+	// split at the median along the longest axis of the entry centers
+	Vector3f const size = centerBounds.GetSize();
+	int const axis = ( size.x >= size.y && size.x >= size.z ) ? 0 : ( ( size.y >= size.z ) ? 1 : 2 );
+	Alg::QuickSortSliced( LeafEntries, first, first + count, ovrCenterLess( centers, axis ) );
+
+	int const half = count / 2;
+	int const left = BuildNode_r( centers, nodeIndex, first, half );
+	int const right = BuildNode_r( centers, nodeIndex, first + half, count - half );
+	Nodes[nodeIndex].Left = left;
+	Nodes[nodeIndex].Right = right;
+	return nodeIndex;
+}
+
+//==============================
+// ovrVRMenuBvh::Rebuild
+void ovrVRMenuBvh::Rebuild( OvrGuiSys const & guiSys )
+{
+	NeedsRebuild = false;
+	Entries.Resize( 0 );
+	EntryForHandle.Clear();
+	StaleEntries.Resize( 0 );
+	Nodes.Resize( 0 );
+
+	OvrVRMenuMgr const & menuMgr = guiSys.GetVRMenuMgr();
+	VRMenuObject const * root = menuMgr.ToObject( RootHandle );
+	if ( root != NULL && !IsExcluded( *root ) )
+	{
+		AddEntries_r( menuMgr, *root, -1 );
+	}
+
+	int const numEntries = Entries.GetSizeI();
+	EntryStale.Resize( numEntries );
+	EntryLeaf.Resize( numEntries );
+	LeafEntries.Resize( numEntries );
+	Array< Vector3f > centers;
+	centers.Resize( numEntries );
+	for ( int i = 0; i < numEntries; ++i )
+	{
+		UpdateEntry( guiSys, i );
+		EntryStale[i] = false;
+		LeafEntries[i] = i;
+		centers[i] = Entries[i].MenuBounds.GetCenter();
+	}
+
+	if ( numEntries > 0 )
+	{
+		BuildNode_r( centers, -1, 0, numEntries );
+	}
+}
+
+//==============================
+// ovrVRMenuBvh::RefitNode
+// Refits a node from its entries or from its child nodes.
+void ovrVRMenuBvh::RefitNode( int const nodeIndex )
+{
+	ovrNode & node = Nodes[nodeIndex];
+	if ( node.Left < 0 )
+	{
+		node.Bounds = Bounds3f( Bounds3f::Init );
+		node.Contents = ContentFlags_t();
+		for ( int i = node.First; i < node.First + node.Count; ++i )
+		{
+			ovrEntry const & entry = Entries[LeafEntries[i]];
+			node.Bounds = Bounds3f::Union( node.Bounds, entry.MenuBounds );
+			node.Contents |= entry.Contents;
+		}
+	}
+	else
+	{
+		node.Bounds = Bounds3f::Union( Nodes[node.Left].Bounds, Nodes[node.Right].Bounds );
+		node.Contents = Nodes[node.Left].Contents | Nodes[node.Right].Contents;
+	}
+}
+
+//==============================
+// ovrVRMenuBvh::Refit
+// Refits a leaf and every node above it.
+void ovrVRMenuBvh::Refit( int const nodeIndex )
+{
+	for ( int n = nodeIndex; n >= 0; n = Nodes[n].Parent )
+	{
+		RefitNode( n );
+	}
+}
+
+//==============================
+// ovrVRMenuBvh::UpdateStaleEntries
+void ovrVRMenuBvh::UpdateStaleEntries( OvrGuiSys const & guiSys )
+{
+	if ( StaleEntries.GetSizeI() == 0 )
+	{
+		return;
+	}
+
+	// A changed object moves all of its descendants too. Entries are in pre-order, so
+	// sorting them lets us skip entries inside a sub-tree that was already updated.
+	Alg::QuickSort( StaleEntries );
+
+	int numUpdated = 0;
+	int updatedEnd = 0;
+	for ( int i = 0; i < StaleEntries.GetSizeI(); ++i )
+	{
+		int const index = StaleEntries[i];
+		EntryStale[index] = false;
+		if ( index < updatedEnd )
+		{
+			continue;
+		}
+		updatedEnd = Entries[index].SubtreeEnd;
+		for ( int j = index; j < updatedEnd; ++j )
+		{
+			UpdateEntry( guiSys, j );
+		}
+		numUpdated += updatedEnd - index;
+	}
+
+	if ( !NeedsRebuild )
+	{
+		if ( numUpdated * 4 > Entries.GetSizeI() )
+		{
+			// children are always allocated after their parent, so this refits bottom-up
+			for ( int n = Nodes.GetSizeI() - 1; n >= 0; --n )
+			{
+				RefitNode( n );
+			}
+		}
+		else
+		{
+			updatedEnd = 0;
+			for ( int i = 0; i < StaleEntries.GetSizeI(); ++i )
+			{
+				int const index = StaleEntries[i];
+				if ( index < updatedEnd )
+				{
+					continue;
+				}
+				updatedEnd = Entries[index].SubtreeEnd;
+				for ( int j = index; j < updatedEnd; ++j )
+				{
+					Refit( EntryLeaf[j] );
+				}
+			}
+		}
+	}
+
+	StaleEntries.Resize( 0 );
+}
+
+//==============================
+// ovrVRMenuBvh::TestEntries
+// Tests the entries in LeafEntries[first, first + count) whose bounds the ray crosses.
+void ovrVRMenuBvh::TestEntries( OvrGuiSys const & guiSys, ovrRay const & ray, int const first, int const count,
+		HitTestResult & best, int & bestEntry )
+{
+	for ( int i = first; i < first + count; ++i )
+	{
+		int const entryIndex = LeafEntries[i];
+		ovrEntry const & entry = Entries[entryIndex];
+		float t;
+		if ( !( entry.Contents & ray.Contents ) ||
+				!IntersectRayBounds( ray.MenuStart, ray.MenuDir, ray.InvMenuDir, entry.MenuBounds, t ) || t > best.t )
+		{
+			continue;
+		}
+		VRMenuObject const * obj = guiSys.GetVRMenuMgr().ToObject( entry.Handle );
+		if ( obj == NULL )
+		{
+			continue;
+		}
+
+		// transform the ray into local space exactly like HitTest_r
+		Posef const & modelPose = GetModelPose( entryIndex );
+		Vector3f const localStart = modelPose.Rotation.Inverted().Rotate( ray.Start - modelPose.Translation );
+		Vector3f const localDir = modelPose.Rotation.Inverted().Rotate( ray.Dir ).Normalized();
+
+		HitTestResult r;
+		if ( obj->HitTestSelf( guiSys, localStart, localDir, entry.ParentScale, ray.Contents, r ) )
+		{
+			// HitTest_r keeps the first of equally distant hits in pre-order
+			if ( r.t < best.t || ( r.t == best.t && entryIndex < bestEntry ) )
+			{
+				best = r;
+				bestEntry = entryIndex;
+			}
+		}
+	}
+}
+
+//==============================
+// ovrVRMenuBvh::HitTest
+menuHandle_t ovrVRMenuBvh::HitTest( OvrGuiSys const & guiSys, Posef const & worldPose,
+		Vector3f const & rayStart, Vector3f const & rayDir,
+		ContentFlags_t const testContents, HitTestResult & result )
+{
+	if ( !PosesEqual( worldPose, WorldPose ) )
+	{
+		// the bounds are relative to the menu, so only the world poses of the tested objects change
+		WorldPose = worldPose;
+		WorldPoseStamp++;
+	}
+
+	if ( !NeedsRebuild )
+	{
+		UpdateStaleEntries( guiSys );
+	}
+	if ( NeedsRebuild )
+	{
+		Rebuild( guiSys );
+	}
+
+	if ( Nodes.GetSizeI() == 0 )
+	{
+		return menuHandle_t();
+	}
+
+	// HitTest_r works with a normalized direction, so distances are comparable across objects
+	Quatf const toMenu = WorldPose.Rotation.Inverted();
+	ovrRay ray;
+	ray.Start = rayStart;
+	ray.Dir = rayDir;
+	ray.MenuStart = toMenu.Rotate( rayStart - WorldPose.Translation );
+	ray.MenuDir = toMenu.Rotate( rayDir.Normalized() );
+	ray.InvMenuDir = Vector3f( 1.0f / ray.MenuDir.x, 1.0f / ray.MenuDir.y, 1.0f / ray.MenuDir.z );
+	ray.Contents = testContents;
+
+	// Each node pushes at most two children, so a tree of depth d needs d + 1 slots. The
+	// median split keeps d at log2 of the number of entries.
+	int const MAX_STACK = 64;
+	int nodeStack[MAX_STACK];
+	float entryStack[MAX_STACK];
+	int stackSize = 0;
+
+	float rootEntry;
+	if ( !( Nodes[0].Contents & testContents ) ||
+			!IntersectRayBounds( ray.MenuStart, ray.MenuDir, ray.InvMenuDir, Nodes[0].Bounds, rootEntry ) )
+	{
+		return menuHandle_t();
+	}
+	nodeStack[stackSize] = 0;
+	entryStack[stackSize] = rootEntry;
+	stackSize++;
+
+	HitTestResult best;
+	int bestEntry = -1;
+	while ( stackSize > 0 )
+	{
+		stackSize--;
+		// every hit inside a node is at or beyond where the ray enters its bounds
+		if ( entryStack[stackSize] > best.t )
+		{
+			continue;
+		}
+		ovrNode const & node = Nodes[nodeStack[stackSize]];
+
+		if ( node.Left < 0 )
+		{
+			TestEntries( guiSys, ray, node.First, node.Count, best, bestEntry );
+			continue;
+		}
+
+		if ( stackSize + 2 > MAX_STACK )
+		{
+			// should never happen, but test the entries one by one rather than skip any
+			OVR_ASSERT( false );
+			TestEntries( guiSys, ray, node.First, node.Count, best, bestEntry );
+			continue;
+		}
+
+		float tLeft = 0.0f;
+		float tRight = 0.0f;
+		bool const hitLeft = ( Nodes[node.Left].Contents & testContents ) &&
+				IntersectRayBounds( ray.MenuStart, ray.MenuDir, ray.InvMenuDir, Nodes[node.Left].Bounds, tLeft );
+		bool const hitRight = ( Nodes[node.Right].Contents & testContents ) &&
+				IntersectRayBounds( ray.MenuStart, ray.MenuDir, ray.InvMenuDir, Nodes[node.Right].Bounds, tRight );
+
+		// push the farther child first so the nearer one is visited first
+		if ( hitLeft && hitRight )
+		{
+			bool const leftFirst = tLeft <= tRight;
+			nodeStack[stackSize] = leftFirst ? node.Right : node.Left;
+			entryStack[stackSize] = leftFirst ? tRight : tLeft;
+			stackSize++;
+			nodeStack[stackSize] = leftFirst ? node.Left : node.Right;
+			entryStack[stackSize] = leftFirst ? tLeft : tRight;
+			stackSize++;
+		}
+		else if ( hitLeft || hitRight )
+		{
+			nodeStack[stackSize] = hitLeft ? node.Left : node.Right;
+			entryStack[stackSize] = hitLeft ? tLeft : tRight;
+			stackSize++;
+		}
+	}
+
+	if ( bestEntry < 0 )
+	{
+		return menuHandle_t();
+	}
+	result = best;
+	return result.HitHandle;
+}
+
+} // namespace OVR
@@ -0,0 +1,117 @@
+/************************************************************************************
+
+Filename    :   VRMenuBvh.h
+Content     :   Bounding volume hierarchy for hit testing menu objects.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#if !defined( OVR_VRMenuBvh_h )
+#define OVR_VRMenuBvh_h
+
+#include "Kernel/OVR_Hash.h"
+#include "VRMenuObject.h"
+
+namespace OVR {
+
+//==============================================================
+// ovrVRMenuBvh
+//
+// Holds the bounds of every object that VRMenuObject::HitTest() would test in the tree
+// below a root object, so that a ray only has to be tested against the objects whose bounds
+// it actually crosses. Bounds are kept relative to the world pose of the menu, so moving the
+// whole menu only transforms the ray. The hierarchy is refit when objects move and rebuilt
+// when objects are added, removed, hidden or shown. Results are the same as the recursive
+// test, except that children are never rejected by the cull bounds of their parent, which
+// are only updated when the menu is rendered.
+class ovrVRMenuBvh
+{
+public:
+	explicit ovrVRMenuBvh( menuHandle_t const rootHandle );
+
+	menuHandle_t	GetRootHandle() const { return RootHandle; }
+	int				GetNumObjects() const { return Entries.GetSizeI(); }
+
+	// Called by the menu manager whenever an object is marked dirty.
+	void			ObjectChanged( VRMenuObject const & obj );
+
+	// Returns the closest object hit by the ray, or an invalid handle if nothing was hit.
+	menuHandle_t	HitTest( OvrGuiSys const & guiSys, Posef const & worldPose,
+							Vector3f const & rayStart, Vector3f const & rayDir,
+							ContentFlags_t const testContents, HitTestResult & result );
+
+private:
+	static int const	MAX_LEAF_ENTRIES = 4;
+
+	struct ovrEntry
+	{
+		menuHandle_t	Handle;
+		int				Parent;			// index of the parent entry, or -1 for the root
+		int				SubtreeEnd;		// one past the index of the last descendant entry
+		int				NumChildren;	// child count when the hierarchy was built
+		Posef			LocalPose;
+		Vector3f		LocalScale;
+		Posef			MenuPose;		// pose relative to the world pose of the menu
+		Vector3f		Scale;			// accumulated scale, including this object
+		Vector3f		ParentScale;	// accumulated scale of the parent
+		Bounds3f		MenuBounds;		// hit test bounds relative to the world pose of the menu
+		ContentFlags_t	Contents;
+		Posef			ModelPose;		// same world pose HitTest_r computes, if ModelPoseStamp is current
+		int				ModelPoseStamp;
+	};
+
+	struct ovrNode
+	{
+		Bounds3f		Bounds;
+		ContentFlags_t	Contents;		// union of the contents of every entry below this node
+		int				Parent;
+		int				Left;			// child nodes, -1 for leaves
+		int				Right;
+		int				First;			// first index into LeafEntries of the entries below this node
+		int				Count;			// number of entries below this node
+	};
+
+	struct ovrRay
+	{
+		Vector3f		Start;
+		Vector3f		Dir;
+		Vector3f		MenuStart;		// relative to the world pose of the menu and normalized
+		Vector3f		MenuDir;
+		Vector3f		InvMenuDir;
+		ContentFlags_t	Contents;
+	};
+
+	menuHandle_t			RootHandle;
+	Posef					WorldPose;
+	int						WorldPoseStamp;	// changes with WorldPose, invalidating every ModelPose
+	bool					NeedsRebuild;
+
+	Array< ovrEntry >		Entries;		// every hittable object in pre-order
+	Hash< UInt64, int >		EntryForHandle;
+	Array< bool >			EntryStale;
+	Array< int >			StaleEntries;	// entries whose transform or bounds changed
+	Array< int >			EntryLeaf;		// node holding each entry
+	Array< int >			LeafEntries;	// entry indices, grouped by leaf
+	Array< ovrNode >		Nodes;
+
+	static bool		IsExcluded( VRMenuObject const & obj );
+
+	void			Rebuild( OvrGuiSys const & guiSys );
+	void			AddEntries_r( OvrVRMenuMgr const & menuMgr, VRMenuObject const & obj, int const parent );
+	int				BuildNode_r( Array< Vector3f > const & centers, int const parent, int const first, int const count );
+	void			UpdateEntry( OvrGuiSys const & guiSys, int const index );
+	Posef const &	GetModelPose( int const index );
+	void			RefitNode( int const nodeIndex );
+	void			Refit( int const nodeIndex );
+	void			UpdateStaleEntries( OvrGuiSys const & guiSys );
+	void			TestEntries( OvrGuiSys const & guiSys, ovrRay const & ray, int const first, int const count,
+							HitTestResult & best, int & bestEntry );
+};
+
+} // namespace OVR
+
+#endif // OVR_VRMenuBvh_h
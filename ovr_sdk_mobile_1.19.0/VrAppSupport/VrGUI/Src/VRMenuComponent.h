@@ -16,6 +16,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "VRMenuObject.h"
 #include "VRMenuEvent.h"
 #include "SoundLimiter.h"
+#include "VRMenuPool.h"
 
 namespace OVR {
 
@@ -55,6 +56,13 @@ public:
 							}
 	virtual					~VRMenuComponent() { }
 
+	// Components are allocated from size-segregated slab pools. The sized delete gets the
+	// size of the most derived type because the destructor is virtual.
+	void *					operator new( size_t size ) { return ovrComponentAllocator::Alloc( size ); }
+	void					operator delete( void * p, size_t size ) { ovrComponentAllocator::Free( p, size ); }
+	// components can still be constructed in place, like the reflection system does
+	OVR_MEMORY_DEFINE_PLACEMENT_NEW
+
     bool                    HandlesEvent( VRMenuEventFlags_t const eventFlags ) const { return ( EventFlags & eventFlags ) != 0; }
 
     // only called if the event's type flag is set in the component's EventFlags.
@@ -62,7 +62,8 @@ void VRMenuEventHandler::Frame( OvrGuiSys & guiSys, ovrFrameInput const & vrFram
 #endif
 
 	HitTestResult result;
-	menuHandle_t hitHandle = root->HitTest( guiSys, menuPose, viewPos, viewFwd, ContentFlags_t( CONTENT_SOLID ), result );
+	menuHandle_t hitHandle = guiSys.GetVRMenuMgr().HitTest( guiSys, rootHandle, menuPose, viewPos, viewFwd,
+			ContentFlags_t( CONTENT_SOLID ), result );
 	result.RayStart = viewPos;
 	result.RayDir = viewFwd;
 
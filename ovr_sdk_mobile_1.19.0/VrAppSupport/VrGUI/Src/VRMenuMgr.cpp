@@ -17,6 +17,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "DebugLines.h"
 #include "BitmapFont.h"
 #include "VRMenuObject.h"
+#include "VRMenuBvh.h"
 #include "GuiSys.h"
 #include "Kernel/OVR_Lexer.h"
 
@@ -247,6 +248,13 @@ static bool HandleComponentsAreValid( int const index, UInt32 const id )
 	return true;
 }
 
+//==================================
+// PosesEqual
+static inline bool PosesEqual( Posef const & a, Posef const & b )
+{
+	return a.Rotation == b.Rotation && a.Translation == b.Translation;
+}
+
 //==============================================================
 // SurfSort
 class SurfSort
@@ -266,6 +274,7 @@ class VRMenuMgrLocal : public OvrVRMenuMgr
 {
 public:
 	static int const	MAX_SUBMITTED	= 256;
+	static int const	OBJECTS_PER_SLAB = 64;
 
 								VRMenuMgrLocal( OvrGuiSys & guiSys );
 	virtual						~VRMenuMgrLocal();
@@ -277,8 +286,11 @@ public:
 
 	// creates a new menu object
 	virtual menuHandle_t		CreateObject( VRMenuObjectParms const & parms );
-	// Frees a menu object.  If the object is a child of a parent object, this will
-	// also remove the child from the parent.
+	// Creates a menu object for each of the parms, reserving storage for all of them up front.
+	virtual void				CreateObjects( Array< VRMenuObjectParms const * > const & parms,
+										Array< menuHandle_t > & outHandles );
+	// Frees a menu object and all of its descendants.  If the object is a child of a parent
+	// object, this will also remove the child from the parent.
 	virtual void				FreeObject( menuHandle_t const handle );
 	// Returns true if the handle is valid.
 	virtual bool				IsValid( menuHandle_t const handle ) const;
@@ -299,6 +311,12 @@ public:
 
     virtual GlProgram const *   GetGUIGlProgram( eGUIProgramType const programType ) const;
 
+	virtual menuHandle_t		HitTest( OvrGuiSys const & guiSys, menuHandle_t const rootHandle,
+										Posef const & worldPose, Vector3f const & rayStart, Vector3f const & rayDir,
+										ContentFlags_t const testContents, HitTestResult & result ) const;
+
+	virtual void				GetPoolStats( Array< ovrPoolStats > & stats ) const;
+
 	static VRMenuMgrLocal &		ToLocal( OvrVRMenuMgr & menuMgr ) { return *(VRMenuMgrLocal*)&menuMgr; }
 
 private:
@@ -311,14 +329,19 @@ private:
 	
 	void						AddComponentToDeletionList( menuHandle_t const ownerHandle, VRMenuComponent * component );
 	void						ExecutePendingComponentDeletions();
-
-	void						CondenseList();
-	void						SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f const & centerViewMatrix,
+	void						MarkObjectDirty( VRMenuObject const & obj );
+	void						FreeHitTestBvh( menuHandle_t const rootHandle );
+
+	void						ReserveObjects( int const count );
+	// Frees an object and its descendants without updating the child lists of the objects being freed.
+	void						FreeObject_r( VRMenuObject * obj );
+	// Returns true if the cull bounds of the object or any of its children changed.
+	bool						SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f const & centerViewMatrix,
 										VRMenuRenderFlags_t const & flags, VRMenuObject const * obj,
 										Posef const & parentModelPose, Vector4f const & parentColor,
 										Vector3f const & parentScale, Bounds3f & cullBounds,
                                         SubmittedMenuObject * submitted, int const maxIndices, int & curIndex,
-										int const distanceIndex ) const;
+										int const distanceIndex );
 
 	//--------------------------------------------------------------
 	// private members
@@ -327,9 +350,31 @@ private:
 	UInt32					CurrentId;		// ever-incrementing object ID (well... up to 4 billion or so :)
 	Array< VRMenuObject* >	ObjectList;		// list of all menu objects
 	Array< int >			FreeList;		// list of free slots in the array
+	ovrSlotPool				ObjectPool;		// storage for the objects, indexed by the same slot as ObjectList
 	
 	Array< ovrComponentList >	PendingDeletions;	// list of components (and owning objects) that are pending deletion
 
+	// Cached world state, indexed by the slot index of each object's handle. An object's entries
+	// are only rebuilt when the object was marked dirty or when the state it inherits from its
+	// parent differs from what the cached state was built from, so unchanged objects skip the
+	// transform, bounds and text metric work entirely.
+	Array< bool >			CacheDirty;			// true if the object changed since its state was cached
+	Array< Posef >			CacheParentPose;	// parent world pose the cached state was built from
+	Array< Vector3f >		CacheParentScale;	// parent world scale the cached state was built from
+	Array< Vector4f >		CacheParentColor;	// parent color the cached state was built from
+	Array< Posef >			CacheModelPose;		// world pose passed to children (includes the hilight pose)
+	Array< Vector3f >		CacheScale;			// world scale
+	Array< Vector4f >		CacheColor;			// world color
+	Array< Bounds3f >		CacheLocalBounds;	// local bounds scaled by the parent scale
+	Array< Bounds3f >		CacheCullBounds;	// local bounds of the object and all its children
+	Array< Vector3f >		CacheTextPosition;	// world-space text position (not used for billboards)
+	Array< Vector3f >		CacheTextNormal;	// world-space text normal (not used for billboards)
+	Array< Vector3f >		CacheTextUp;		// world-space text up vector (not used for billboards)
+
+	// One hit test hierarchy for each root that HitTest() has been called for. These are
+	// built on demand, so they are mutable.
+	mutable Array< ovrVRMenuBvh* >	HitTestBvhs;
+
 	bool					Initialized;	// true if Init has been called
 
 	SubmittedMenuObject		Submitted[MAX_SUBMITTED];	// all objects that have been submitted for rendering on the current frame
@@ -352,6 +397,9 @@ private:
 	static bool				ShowPoses;
 	static bool				ShowStats;			// show stats like number of draw calls
 	static bool				ShowWrapWidths;
+	static bool				DisableTransformCache;	// true to rebuild the world state of every object on every submit
+	static bool				DisableHitTestBvh;		// true to hit test by walking the hierarchy
+	static bool				LogPoolStats;			// true to log the pool statistics on the next Finish()
 
 	static void				DebugCollision( void * appPtr, const char * cmdLine );
 	static void				DebugMenuBounds( void * appPtr, const char * cmdLine );
@@ -359,6 +407,9 @@ private:
 	static void				DebugMenuPoses( void * appPtr, const char * cmdLine );
 	static void				DebugShowStats( void * appPtr, const char * cmdLine );
 	static void				DebugWordWrap( void * appPtr, const char * cmdLine );
+	static void				DebugTransformCache( void * appPtr, const char * cmdLine );
+	static void				DebugHitTestBvh( void * appPtr, const char * cmdLine );
+	static void				DebugPoolStats( void * appPtr, const char * cmdLine );
 };
 
 bool VRMenuMgrLocal::ShowCollision = false;
@@ -368,6 +419,9 @@ bool VRMenuMgrLocal::ShowDebugNormals = false;
 bool VRMenuMgrLocal::ShowPoses = false;
 bool VRMenuMgrLocal::ShowStats = false;
 bool VRMenuMgrLocal::ShowWrapWidths = false;
+bool VRMenuMgrLocal::DisableTransformCache = false;
+bool VRMenuMgrLocal::DisableHitTestBvh = false;
+bool VRMenuMgrLocal::LogPoolStats = false;
 
 void VRMenuMgrLocal::DebugCollision( void * appPtr, const char * parms )
 {
@@ -423,11 +477,37 @@ void VRMenuMgrLocal::DebugWordWrap( void * appPtr, const char * parms )
 	OVR_LOG( "ShowWrapWidths( '%s' ): show = %i", parms, show );
 }
 
+void VRMenuMgrLocal::DebugTransformCache( void * appPtr, const char * parms )
+{
+	ovrLexer lex( parms );
+	int enable;
+	lex.ParseInt( enable, 1 );
+	DisableTransformCache = enable == 0;
+	OVR_LOG( "DebugTransformCache( '%s' ): enable = %i", parms, enable );
+}
+
+void VRMenuMgrLocal::DebugPoolStats( void * appPtr, const char * parms )
+{
+	// logged by the next Finish()
+	LogPoolStats = true;
+	OVR_LOG( "DebugPoolStats( '%s' )", parms );
+}
+
+void VRMenuMgrLocal::DebugHitTestBvh( void * appPtr, const char * parms )
+{
+	ovrLexer lex( parms );
+	int enable;
+	lex.ParseInt( enable, 1 );
+	DisableHitTestBvh = enable == 0;
+	OVR_LOG( "DebugHitTestBvh( '%s' ): enable = %i", parms, enable );
+}
+
 //==================================
 // VRMenuMgrLocal::VRMenuMgrLocal
 VRMenuMgrLocal::VRMenuMgrLocal( OvrGuiSys & guiSys )
 	: GuiSys( guiSys )
 	, CurrentId( 0 )
+	, ObjectPool( "VRMenuObject", sizeof( VRMenuObject ), OBJECTS_PER_SLAB )
 	, Initialized( false )
 	, NumSubmitted( 0 )
 	, NumToRender( 0 )
@@ -438,6 +518,11 @@ VRMenuMgrLocal::VRMenuMgrLocal( OvrGuiSys & guiSys )
 // VRMenuMgrLocal::~VRMenuMgrLocal
 VRMenuMgrLocal::~VRMenuMgrLocal()
 {
+	for ( int i = 0; i < HitTestBvhs.GetSizeI(); ++i )
+	{
+		delete HitTestBvhs[i];
+	}
+	HitTestBvhs.Clear();
 }
 
 //==================================
@@ -453,36 +538,36 @@ void VRMenuMgrLocal::Init( OvrGuiSys & guiSys )
 	}
 
 	// diffuse only
-	if ( GUIProgramDiffuseOnly.VertexShader == 0 || GUIProgramDiffuseOnly.FragmentShader == 0 )
+	if ( !GUIProgramDiffuseOnly.IsValid() )
 	{
 		GUIProgramDiffuseOnly = BuildProgram( GUIDiffuseOnlyVertexShaderSrc, GUIDiffuseOnlyFragmentShaderSrc );
 	}
 	// diffuse alpha discard only
-	if ( GUIProgramDiffuseAlphaDiscard.VertexShader == 0 || GUIProgramDiffuseAlphaDiscard.FragmentShader == 0 )
+	if ( !GUIProgramDiffuseAlphaDiscard.IsValid() )
 	{
 		GUIProgramDiffuseAlphaDiscard = BuildProgram( GUIDiffuseOnlyVertexShaderSrc, GUIDiffuseAlphaDiscardFragmentShaderSrc );
 	}	
 	// diffuse + additive
-	if ( GUIProgramDiffusePlusAdditive.VertexShader == 0 || GUIProgramDiffusePlusAdditive.FragmentShader == 0 )
+	if ( !GUIProgramDiffusePlusAdditive.IsValid() )
 	{
 		GUIProgramDiffusePlusAdditive = BuildProgram( GUITwoTextureColorModulatedShaderSrc, GUIDiffusePlusAdditiveFragmentShaderSrc );
 	}
 	// diffuse + diffuse
-	if ( GUIProgramDiffuseComposite.VertexShader == 0 || GUIProgramDiffuseComposite.FragmentShader == 0 )
+	if ( !GUIProgramDiffuseComposite.IsValid() )
 	{
 		GUIProgramDiffuseComposite = BuildProgram( GUITwoTextureColorModulatedShaderSrc, GUIDiffuseCompositeFragmentShaderSrc );
 	}
 	// diffuse color ramped
-	if ( GUIProgramDiffuseColorRamp.VertexShader == 0 || GUIProgramDiffuseColorRamp.FragmentShader == 0 )
+	if ( !GUIProgramDiffuseColorRamp.IsValid() )
 	{
 		GUIProgramDiffuseColorRamp = BuildProgram( GUIDiffuseOnlyVertexShaderSrc, GUIColorRampFragmentSrc );
 	}
 	// diffuse, color ramp, and a specific target for the color ramp
-	if ( GUIProgramDiffuseColorRampTarget.VertexShader == 0 || GUIProgramDiffuseColorRampTarget.FragmentShader == 0 )
+	if ( !GUIProgramDiffuseColorRampTarget.IsValid() )
 	{
 		GUIProgramDiffuseColorRampTarget = BuildProgram( GUIDiffuseColorRampTargetVertexShaderSrc, GUIColorRampTargetFragmentSrc );
 	}
-	if ( GUIProgramAlphaDiffuse.VertexShader == 0 || GUIProgramAlphaDiffuse.FragmentShader == 0 )
+	if ( !GUIProgramAlphaDiffuse.IsValid() )
 	{
 		GUIProgramAlphaDiffuse = BuildProgram( GUITwoTextureColorModulatedShaderSrc, GUIAlphaDiffuseFragmentShaderSrc );
 	}
@@ -492,6 +577,9 @@ void VRMenuMgrLocal::Init( OvrGuiSys & guiSys )
 	guiSys.GetApp()->RegisterConsoleFunction( "debugMenuPoses", DebugMenuPoses );
 	guiSys.GetApp()->RegisterConsoleFunction( "debugShowStats", DebugShowStats );
 	guiSys.GetApp()->RegisterConsoleFunction( "debugWordWrap", DebugWordWrap );
+	guiSys.GetApp()->RegisterConsoleFunction( "debugMenuTransformCache", DebugTransformCache );
+	guiSys.GetApp()->RegisterConsoleFunction( "debugMenuHitTestBvh", DebugHitTestBvh );
+	guiSys.GetApp()->RegisterConsoleFunction( "debugMenuPoolStats", DebugPoolStats );
 
 	Initialized = true;
 }
@@ -554,13 +642,8 @@ menuHandle_t VRMenuMgrLocal::CreateObject( VRMenuObjectParms const & parms )
 	menuHandle_t handle = ComposeHandle( index, id );
 	//OVR_LOG( "VRMenuMgrLocal::CreateObject - handle is %llu", handle.Get() );
 
-	VRMenuObject * obj = new VRMenuObject( parms, handle );
-	if ( obj == NULL )
-	{
-		OVR_WARN( "VRMenuMgrLocal::CreateObject - failed to allocate menu object!" );
-		OVR_ASSERT( obj != NULL );	// this would be bad -- but we're likely just going to explode elsewhere
-		return menuHandle_t();
-	}
+	// the object lives in the pool slot with the same index as the handle
+	VRMenuObject * obj = new ( ObjectPool.Acquire( index ) ) VRMenuObject( *this, parms, handle );
 
 	obj->Init( GuiSys, parms );
 
@@ -576,9 +659,75 @@ menuHandle_t VRMenuMgrLocal::CreateObject( VRMenuObjectParms const & parms )
 		ObjectList[index ] = obj;
 	}
 
+	// the cache arrays never shrink, so they may already cover this slot
+	if ( index >= CacheDirty.GetSizeI() )
+	{
+		int const newSize = index + 1;
+		CacheDirty.Resize( newSize );
+		CacheParentPose.Resize( newSize );
+		CacheParentScale.Resize( newSize );
+		CacheParentColor.Resize( newSize );
+		CacheModelPose.Resize( newSize );
+		CacheScale.Resize( newSize );
+		CacheColor.Resize( newSize );
+		CacheLocalBounds.Resize( newSize );
+		CacheCullBounds.Resize( newSize );
+		CacheTextPosition.Resize( newSize );
+		CacheTextNormal.Resize( newSize );
+		CacheTextUp.Resize( newSize );
+	}
+	CacheDirty[index] = true;
+
 	return handle;
 }
 
+//==================================
+// VRMenuMgrLocal::ReserveObjects
+// Makes sure count more objects can be created without growing any of the per-slot arrays.
+void VRMenuMgrLocal::ReserveObjects( int const count )
+{
+	int const numNewSlots = Alg::Max( 0, count - FreeList.GetSizeI() );
+	int const numSlots = ObjectList.GetSizeI() + numNewSlots;
+	if ( numSlots > ObjectList.GetCapacityI() )
+	{
+		ObjectList.Reserve( numSlots );
+	}
+	if ( numSlots > CacheDirty.GetCapacityI() )
+	{
+		CacheDirty.Reserve( numSlots );
+		CacheParentPose.Reserve( numSlots );
+		CacheParentScale.Reserve( numSlots );
+		CacheParentColor.Reserve( numSlots );
+		CacheModelPose.Reserve( numSlots );
+		CacheScale.Reserve( numSlots );
+		CacheColor.Reserve( numSlots );
+		CacheLocalBounds.Reserve( numSlots );
+		CacheCullBounds.Reserve( numSlots );
+		CacheTextPosition.Reserve( numSlots );
+		CacheTextNormal.Reserve( numSlots );
+		CacheTextUp.Reserve( numSlots );
+	}
+	ObjectPool.Reserve( numSlots );
+}
+
+//==================================
+// VRMenuMgrLocal::CreateObjects
+void VRMenuMgrLocal::CreateObjects( Array< VRMenuObjectParms const * > const & parms,
+		Array< menuHandle_t > & outHandles )
+{
+	OVR_PERF_TIMER( CreateObjects );
+
+	if ( Initialized )
+	{
+		ReserveObjects( parms.GetSizeI() );
+	}
+	outHandles.Reserve( outHandles.GetSizeI() + parms.GetSizeI() );
+	for ( int i = 0; i < parms.GetSizeI(); ++i )
+	{
+		outHandles.PushBack( parms[i] != NULL ? CreateObject( *parms[i] ) : menuHandle_t() );
+	}
+}
+
 //==================================
 // VRMenuMgrLocal::FreeObject
 // Frees a menu object.  If the object is a child of a parent object, this will
@@ -609,47 +758,37 @@ void VRMenuMgrLocal::FreeObject( menuHandle_t const handle )
 		}
 	}
 
-    // free all of this object's children
-    obj->FreeChildren( *this );
-
-	delete obj;
-
-	// empty the slot
-	ObjectList[index] = NULL;
-	// add the index to the free list
-	FreeList.PushBack( index );
-
-	CondenseList();
+	FreeObject_r( obj );
 }
 
 //==================================
-// VRMenuMgrLocal::CondenseList
-// keeps the free list from growing too large when items are removed
-void VRMenuMgrLocal::CondenseList()
+// VRMenuMgrLocal::FreeObject_r
+void VRMenuMgrLocal::FreeObject_r( VRMenuObject * obj )
 {
-	// we can only condense the array if we have a significant number of items at the end of the array buffer
-	// that are empty (because we cannot move an existing object around without changing its handle, too, which
-	// would invalidate any existing references to it).
-	// This is the difference between the current size and the array capacity.
-	int const MIN_FREE = 64;	// very arbitray number
-	if ( ObjectList.GetCapacityI() - ObjectList.GetSizeI() < MIN_FREE )
-	{
-		return;
-	}
-
-	// shrink to current size
-	ObjectList.Resize( ObjectList.GetSizeI() );
-
-	// create a new free list of just indices < the new size
-	Array< int > newFreeList;
-	for ( int i = 0; i < FreeList.GetSizeI(); ++i )
+	// the whole sub-tree is going away, so children are not removed from their parents one at a time
+	for ( int i = 0; i < obj->NumChildren(); ++i )
 	{
-		if ( FreeList[i] <= ObjectList.GetSizeI() )
+		VRMenuObject * child = ToObject( obj->GetChildHandleForIndex( i ) );
+		if ( child != NULL )
 		{
-			newFreeList.PushBack( FreeList[i] );
+			FreeObject_r( child );
 		}
 	}
-	FreeList = newFreeList;
+
+	menuHandle_t const handle = obj->GetHandle();
+	int index;
+	UInt32 id;
+	DecomposeHandle( handle, index, id );
+
+	FreeHitTestBvh( handle );
+
+	obj->~VRMenuObject();
+	ObjectPool.Release( index );
+
+	// empty the slot
+	ObjectList[index] = NULL;
+	// add the index to the free list
+	FreeList.PushBack( index );
 }
 
 //==================================
@@ -715,10 +854,10 @@ OVR_PERF_ACCUMULATOR( SubmitForRenderingRecursive_submit );
 
 //==============================
 // VRMenuMgrLocal::SubmitForRenderingRecursive
-void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f const & centerViewMatrix,
+bool VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f const & centerViewMatrix,
 		VRMenuRenderFlags_t const & flags, VRMenuObject const * obj, Posef const & parentModelPose,
 		Vector4f const & parentColor, Vector3f const & parentScale, Bounds3f & cullBounds,
-		SubmittedMenuObject * submitted, int const maxIndices, int & curIndex, int const distanceIndex ) const
+		SubmittedMenuObject * submitted, int const maxIndices, int & curIndex, int const distanceIndex )
 {
 	if ( curIndex >= maxIndices )
 	{
@@ -726,37 +865,67 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 		// OR we've got a LOT of surfaces.
 		OVR_LOG( "maxIndices = %i, curIndex = %i", maxIndices, curIndex );
 		OVR_ASSERT_WITH_TAG( curIndex < maxIndices, "VrMenu" );
-		return;
+		return false;
 	}
 
+	OVR_ASSERT( obj != NULL );
+
+	int slot;
+	UInt32 id;
+	DecomposeHandle( obj->GetHandle(), slot, id );
+
 	// check if this object is hidden
 	VRMenuObjectFlags_t const oFlags = obj->GetFlags();
 	if ( oFlags & VRMENUOBJECT_DONT_RENDER )
 	{
-		return;
+		// Hidden objects contribute empty bounds to their parent, so they only report a change
+		// once. Showing the object again marks it dirty, which rebuilds its cached state.
+		bool const changed = CacheDirty[slot];
+		CacheDirty[slot] = false;
+		return changed;
 	}
 
-	Posef const & localPose = obj->GetLocalPose();
-	Vector3f const & localScale = obj->GetLocalScale();
-	Vector4f const & localColor = obj->GetColor();
-	Posef curModelPose;
-	Vector4f curColor;
-	Vector3f scale;
+	// only rebuild the cached world state if this object changed or it is being placed differently
+	bool const rebuild = DisableTransformCache || CacheDirty[slot] ||
+			!PosesEqual( CacheParentPose[slot], parentModelPose ) ||
+			!( CacheParentScale[slot] == parentScale ) ||
+			!( CacheParentColor[slot] == parentColor );
+	if ( rebuild )
+	{
+		Posef curModelPose;
+		Vector4f curColor;
+		Vector3f scale;
 
-	VRMenuObject::TransformByParent( parentModelPose, parentScale, parentColor, localPose, localScale, localColor, oFlags, curModelPose, scale, curColor );
+		VRMenuObject::TransformByParent( parentModelPose, parentScale, parentColor, obj->GetLocalPose(),
+				obj->GetLocalScale(), obj->GetColor(), oFlags, curModelPose, scale, curColor );
 
-	OVR_ASSERT( obj != NULL );
+		if ( obj->GetType() != VRMENU_CONTAINER )
+		{
+			// so children like the slider bar caret use our hilight offset and don't end up clipping behind us!
+			Posef const & hilightPose = obj->GetHilightPose();
+			curModelPose = Posef( curModelPose.Rotation * hilightPose.Rotation,
+					curModelPose.Translation + ( curModelPose.Rotation * parentScale.EntrywiseMultiply( hilightPose.Translation ) ) );
+		}
+
+		CacheDirty[slot] = false;
+		CacheParentPose[slot] = parentModelPose;
+		CacheParentScale[slot] = parentScale;
+		CacheParentColor[slot] = parentColor;
+		CacheModelPose[slot] = curModelPose;
+		CacheScale[slot] = scale;
+		CacheColor[slot] = curColor;
+		CacheLocalBounds[slot] = obj->GetLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
+	}
 
-	cullBounds = obj->GetLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
+	Posef curModelPose = CacheModelPose[slot];
+	Vector3f const scale = CacheScale[slot];
+	Vector4f const curColor = CacheColor[slot];
+	Bounds3f const localBounds = CacheLocalBounds[slot];
 
 	int submissionIndex = -1;
 	if ( obj->GetType() != VRMENU_CONTAINER )	// containers never render, but their children may
 	{
-        Posef const & hilightPose = obj->GetHilightPose();
-        Posef itemPose( curModelPose.Rotation * hilightPose.Rotation,
-                        curModelPose.Translation + ( curModelPose.Rotation * parentScale.EntrywiseMultiply( hilightPose.Translation ) ) );
-		Matrix4f poseMat( itemPose.Rotation );
-		curModelPose = itemPose;	// so children like the slider bar caret use our hilight offset and don't end up clipping behind us!
+		Posef itemPose = curModelPose;
 		VRMenuRenderFlags_t rFlags = flags;
 		if ( oFlags & VRMENUOBJECT_FLAG_POLYGON_OFFSET )
 		{
@@ -775,7 +944,9 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 			rFlags |= VRMENU_RENDER_SUBMIT_TEXT_SURFACE;
 		}
 
-		if ( oFlags & VRMENUOBJECT_FLAG_BILLBOARD )
+		// billboards depend on the view, so they can never use the cached text placement
+		bool const billboard = ( oFlags & VRMENUOBJECT_FLAG_BILLBOARD ) != 0;
+		if ( billboard )
 		{
 			Matrix4f invViewMatrix = centerViewMatrix.Transposed();
 			itemPose.Rotation = Quatf( invViewMatrix );
@@ -821,7 +992,7 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 #if defined( OVR_BUILD_DEBUG )
 					sub.SurfaceName = surf.GetName();
 #endif
-					sub.LocalBounds = cullBounds;
+					sub.LocalBounds = localBounds;
 					curIndex++;
 				}
 			}
@@ -831,15 +1002,33 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 		OVR::String const & text = obj->GetText();
 		if ( ( oFlags & VRMENUOBJECT_DONT_RENDER_TEXT ) == 0 && text.GetLengthI() > 0 )
 		{
-            Posef const & textLocalPose = obj->GetTextLocalPose();
-            Posef curTextPose;
-            curTextPose.Translation = itemPose.Translation + ( itemPose.Rotation * textLocalPose.Translation * scale );
-            curTextPose.Rotation = itemPose.Rotation * textLocalPose.Rotation;
-
-			Matrix4f textMat( curTextPose );
-			Vector3f textUp = textMat.GetYBasis();
-            Vector3f textNormal = textMat.GetZBasis();
-			Vector3f position = curTextPose.Translation + textNormal * 0.001f; // this is simply to prevent z-fighting right now
+			bool const placeText = rebuild || billboard;
+			if ( placeText )
+			{
+				Posef const & textLocalPose = obj->GetTextLocalPose();
+				Posef curTextPose;
+				curTextPose.Translation = itemPose.Translation + ( itemPose.Rotation * textLocalPose.Translation * scale );
+				curTextPose.Rotation = itemPose.Rotation * textLocalPose.Rotation;
+
+				Matrix4f textMat( curTextPose );
+				CacheTextUp[slot] = textMat.GetYBasis();
+				CacheTextNormal[slot] = textMat.GetZBasis();
+				CacheTextPosition[slot] = curTextPose.Translation + CacheTextNormal[slot] * 0.001f; // this is simply to prevent z-fighting right now
+
+				if ( rFlags & VRMENU_RENDER_SUBMIT_TEXT_SURFACE )
+				{
+					OVR_ASSERT( obj->TextSurface != nullptr );
+					Matrix4f scaleMatrix;
+					scaleMatrix.M[0][0] = parentScale.x;
+					scaleMatrix.M[1][1] = parentScale.y;
+					scaleMatrix.M[2][2] = parentScale.z;
+					obj->TextSurface->ModelMatrix = scaleMatrix * Matrix4f( curTextPose.Rotation );
+					obj->TextSurface->ModelMatrix.SetTranslation( curTextPose.Translation );
+				}
+			}
+			Vector3f const & position = CacheTextPosition[slot];
+			Vector3f const & textNormal = CacheTextNormal[slot];
+			Vector3f const & textUp = CacheTextUp[slot];
             Vector3f textScale = scale * obj->GetTextLocalScale() * obj->GetWrapScale();
 
             Vector4f textColor = obj->GetTextColor();
@@ -858,14 +1047,6 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 			// change, but that would be needlessly expensive.
 			if ( rFlags & VRMENU_RENDER_SUBMIT_TEXT_SURFACE )
 			{
-				OVR_ASSERT( obj->TextSurface != nullptr );
-				Matrix4f scaleMatrix;
-				scaleMatrix.M[0][0] = parentScale.x;
-				scaleMatrix.M[1][1] = parentScale.y;
-				scaleMatrix.M[2][2] = parentScale.z;
-				obj->TextSurface->ModelMatrix = scaleMatrix * Matrix4f( curTextPose.Rotation );
-				obj->TextSurface->ModelMatrix.SetTranslation( curTextPose.Translation );
-
 				// if we didn't submit anything but we have an instanced text surface, submit an invalid surface so that
 				// the text surface will be added to the surface list in BuildDrawSurface
 				if ( curIndex - submissionIndex == 0 )
@@ -877,7 +1058,7 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 					sub.Flags = rFlags;
 					sub.Handle = obj->GetHandle();
 					sub.Color = parentColor;
-					sub.LocalBounds = cullBounds;
+					sub.LocalBounds = localBounds;
 					curIndex++;
 				}
 			}
@@ -909,6 +1090,7 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 	}
 
 	// submit all children
+	bool childrenChanged = false;
     if ( obj->Children.GetSizeI() > 0 )
     {
 		// If this object has the render hierarchy order flag, then it and all its children should
@@ -929,17 +1111,46 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 		    }
 
             Bounds3f childCullBounds;
-		    SubmitForRenderingRecursive( guiSys, centerViewMatrix, flags, child, curModelPose,
-                    curColor, scale, childCullBounds, submitted, maxIndices, curIndex, di );
+		    if ( SubmitForRenderingRecursive( guiSys, centerViewMatrix, flags, child, curModelPose,
+                    curColor, scale, childCullBounds, submitted, maxIndices, curIndex, di ) )
+			{
+				childrenChanged = true;
+			}
+	    }
+    }
+
+	// the cull bounds only need to be re-accumulated if something in this sub-tree changed
+	bool const changed = rebuild || childrenChanged;
+	if ( changed )
+	{
+		Bounds3f bounds = localBounds;
+		for ( int i = 0; i < obj->Children.GetSizeI(); ++i )
+		{
+			VRMenuObject const * child = static_cast< VRMenuObject const * >( ToObject( obj->Children[i] ) );
+			if ( child == NULL )
+			{
+				continue;
+			}
+
+			// hidden children contribute empty bounds at their local position
+			Bounds3f childCullBounds;
+			if ( ( child->GetFlags() & VRMENUOBJECT_DONT_RENDER ) == 0 )
+			{
+				int childSlot;
+				UInt32 childId;
+				DecomposeHandle( child->GetHandle(), childSlot, childId );
+				childCullBounds = CacheCullBounds[childSlot];
+			}
 
 		    Posef pose = child->GetLocalPose();
 		    pose.Translation = pose.Translation * scale;
             childCullBounds = Bounds3f::Transform( pose, childCullBounds );
-            cullBounds = Bounds3f::Union( cullBounds, childCullBounds );
-	    }
-    }
-
-    obj->SetCullBounds( cullBounds );
+            bounds = Bounds3f::Union( bounds, childCullBounds );
+		}
+		CacheCullBounds[slot] = bounds;
+	    obj->SetCullBounds( bounds );
+	}
+	cullBounds = CacheCullBounds[slot];
 
 	//VRMenuId_t debugId( 297 );
 	if ( ShowCollision )
@@ -969,7 +1180,6 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 			guiSys.GetDebugLines().AddBounds( curModelPose, cullBounds, Vector4f( 0.0f, 1.0f, 1.0f, 1.0f ) );
 		}
 		{
-			Bounds3f localBounds = obj->GetLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
 			//LogBounds( obj->GetText().ToCStr(), "localBounds", localBounds );
     		guiSys.GetDebugLines().AddBounds( curModelPose, localBounds, Vector4f( 1.0f, 0.0f, 0.0f, 1.0f ) );
 			Bounds3f textLocalBounds = obj->GetTextLocalBounds( guiSys.GetDefaultFont() );
@@ -1004,6 +1214,8 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive( OvrGuiSys & guiSys, Matrix4f c
 					obj->GetSurfaces()[0].GetName().ToCStr() );
 		}
 	}
+
+	return changed;
 }
 
 //==============================
@@ -1039,6 +1251,20 @@ void VRMenuMgrLocal::Finish( Matrix4f const & viewMatrix )
 	// free any deleted component objects
 	ExecutePendingComponentDeletions();
 
+	if ( LogPoolStats )
+	{
+		LogPoolStats = false;
+		Array< ovrPoolStats > stats;
+		GetPoolStats( stats );
+		for ( int i = 0; i < stats.GetSizeI(); ++i )
+		{
+			ovrPoolStats const & ps = stats[i];
+			OVR_LOG( "Pool '%s': %i bytes, %i per slab, %i slabs, %i live, %i peak, %llu allocs, %llu frees",
+					ps.Name, ps.ElementSize, ps.ElementsPerSlab, ps.NumSlabs, ps.NumLive, ps.PeakLive,
+					(unsigned long long)ps.NumAllocs, (unsigned long long)ps.NumFrees );
+		}
+	}
+
 	if ( NumSubmitted == 0 )
 	{
 		NumToRender = 0;
@@ -1194,6 +1420,87 @@ void VRMenuMgrLocal::AddComponentToDeletionList( menuHandle_t const ownerHandle,
 	PendingDeletions[index].AddComponent( component );
 }
 
+//==============================
+// VRMenuMgrLocal::MarkObjectDirty
+void VRMenuMgrLocal::MarkObjectDirty( VRMenuObject const & obj )
+{
+	int index;
+	UInt32 id;
+	DecomposeHandle( obj.GetHandle(), index, id );
+	// objects can be modified during Init(), before their cache entries exist
+	if ( HandleComponentsAreValid( index, id ) && index < CacheDirty.GetSizeI() )
+	{
+		CacheDirty[index] = true;
+	}
+
+	for ( int i = 0; i < HitTestBvhs.GetSizeI(); ++i )
+	{
+		HitTestBvhs[i]->ObjectChanged( obj );
+	}
+}
+
+//==============================
+// VRMenuMgrLocal::FreeHitTestBvh
+void VRMenuMgrLocal::FreeHitTestBvh( menuHandle_t const rootHandle )
+{
+	for ( int i = 0; i < HitTestBvhs.GetSizeI(); ++i )
+	{
+		if ( HitTestBvhs[i]->GetRootHandle() == rootHandle )
+		{
+			delete HitTestBvhs[i];
+			HitTestBvhs.RemoveAtUnordered( i );
+			return;
+		}
+	}
+}
+
+//==============================
+// VRMenuMgrLocal::GetPoolStats
+void VRMenuMgrLocal::GetPoolStats( Array< ovrPoolStats > & stats ) const
+{
+	ovrPoolStats objectStats;
+	ObjectPool.GetStats( objectStats );
+	stats.PushBack( objectStats );
+	ovrComponentAllocator::GetStats( stats );
+}
+
+//==============================
+// VRMenuMgrLocal::HitTest
+menuHandle_t VRMenuMgrLocal::HitTest( OvrGuiSys const & guiSys, menuHandle_t const rootHandle,
+		Posef const & worldPose, Vector3f const & rayStart, Vector3f const & rayDir,
+		ContentFlags_t const testContents, HitTestResult & result ) const
+{
+	if ( DisableHitTestBvh )
+	{
+		VRMenuObject const * root = ToObject( rootHandle );
+		if ( root == NULL )
+		{
+			return menuHandle_t();
+		}
+		return root->HitTest( guiSys, worldPose, rayStart, rayDir, testContents, result );
+	}
+
+	ovrVRMenuBvh * bvh = NULL;
+	for ( int i = 0; i < HitTestBvhs.GetSizeI(); ++i )
+	{
+		if ( HitTestBvhs[i]->GetRootHandle() == rootHandle )
+		{
+			bvh = HitTestBvhs[i];
+			break;
+		}
+	}
+	if ( bvh == NULL )
+	{
+		if ( !IsValid( rootHandle ) )
+		{
+			return menuHandle_t();
+		}
+		bvh = new ovrVRMenuBvh( rootHandle );
+		HitTestBvhs.PushBack( bvh );
+	}
+	return bvh->HitTest( guiSys, worldPose, rayStart, rayDir, testContents, result );
+}
+
 //==============================
 // VRMenuMgrLocal::ExecutePendingComponentDeletions
 void VRMenuMgrLocal::ExecutePendingComponentDeletions()
@@ -14,6 +14,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #define OVR_VRMenuMgr_h
 
 #include "VRMenuObject.h"
+#include "VRMenuPool.h"
 
 namespace OVR {
 
@@ -41,8 +42,12 @@ public:
 
 	// creates a new menu object
 	virtual menuHandle_t		CreateObject( VRMenuObjectParms const & parms ) = 0;
-	// Frees a menu object.  If the object is a child of a parent object, this will
-	// also remove the child from the parent.
+	// Creates a menu object for each of the parms, reserving storage for all of them up front.
+	// Handles are appended to outHandles in the same order, invalid for objects that failed.
+	virtual void				CreateObjects( Array< VRMenuObjectParms const * > const & parms,
+										Array< menuHandle_t > & outHandles ) = 0;
+	// Frees a menu object and all of its descendants.  If the object is a child of a parent
+	// object, this will also remove the child from the parent.
 	virtual void				FreeObject( menuHandle_t const handle ) = 0;
 	// Returns true if the handle is valid.
 	virtual bool				IsValid( menuHandle_t const handle ) const = 0;
@@ -63,9 +68,21 @@ public:
 
     virtual GlProgram const *   GetGUIGlProgram( eGUIProgramType const programType ) const = 0;
 
+	// Appends the statistics of the menu object pool and the component pools.
+	virtual void				GetPoolStats( Array< ovrPoolStats > & stats ) const = 0;
+
+	// Returns the closest object hit by the ray in the tree below rootHandle, or an invalid
+	// handle if nothing was hit. Same as VRMenuObject::HitTest(), but uses a bounding volume
+	// hierarchy that is kept up to date as objects change.
+	virtual menuHandle_t		HitTest( OvrGuiSys const & guiSys, menuHandle_t const rootHandle,
+										Posef const & worldPose, Vector3f const & rayStart, Vector3f const & rayDir,
+										ContentFlags_t const testContents, HitTestResult & result ) const = 0;
+
 private:
 	// Called only from VRMenuObject.
 	virtual void				AddComponentToDeletionList( menuHandle_t const ownerHandle, VRMenuComponent * component ) = 0;
+	// Called only from VRMenuObject when its pose, scale, color, flags, text or surfaces change.
+	virtual void				MarkObjectDirty( VRMenuObject const & obj ) = 0;
 };
 
 } // namespace OVR
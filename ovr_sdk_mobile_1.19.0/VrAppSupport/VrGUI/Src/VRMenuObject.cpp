@@ -24,6 +24,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "OVR_TextureManager.h"
 #include "OVR_Locale.h"
 #include "Reflection.h"
+#include "ReflectionCache.h"
 
 //#define OVR_USE_PERF_TIMER
 #include "OVR_PerfTimer.h"
@@ -895,7 +896,7 @@ void VRMenuSurface::SetOwnership( int const index, bool const isOwner )
 
 //==================================
 // VRMenuObject::VRMenuObject
-VRMenuObject::VRMenuObject( VRMenuObjectParms const & parms,
+VRMenuObject::VRMenuObject( OvrVRMenuMgr & menuMgr, VRMenuObjectParms const & parms,
 		menuHandle_t const handle ) :
 	Type( parms.Type ),
 	Handle( handle ),
@@ -923,7 +924,8 @@ VRMenuObject::VRMenuObject( VRMenuObjectParms const & parms,
 	MinsBoundsExpand( 0.0f ),
 	MaxsBoundsExpand( 0.0f ),
 	TextMetrics(),
-	TextSurface( nullptr )
+	TextSurface( nullptr ),
+	MenuMgr( &menuMgr )
 {
 	CullBounds.Clear();
 }
@@ -958,6 +960,11 @@ OVR_PERF_ACCUMULATOR( VRMenuObjectInit );
 void VRMenuObject::Init( OvrGuiSys & guiSys, VRMenuObjectParms const & parms )
 {
 	OVR_PERF_TIMER( VRMenuObjectInit );
+	// one allocation for all surfaces instead of growing the array
+	if ( parms.SurfaceParms.GetSizeI() > 0 )
+	{
+		Surfaces.Reserve( parms.SurfaceParms.GetSizeI() );
+	}
 	for ( int i = 0; i < parms.SurfaceParms.GetSizeI(); ++i )
 	{
 		int idx = static_cast< int >( Surfaces.AllocBack() );
@@ -998,11 +1005,14 @@ void VRMenuObject::Init( OvrGuiSys & guiSys, VRMenuObjectParms const & parms )
 // VRMenuObject::FreeChildren
 void VRMenuObject::FreeChildren( OvrVRMenuMgr & menuMgr )
 {
-	for ( int i = 0; i < Children.GetSizeI(); ++i )
+	// Freeing a child removes it from this list by swapping the last child into its place,
+	// so walk the list backwards to visit every child.
+	for ( int i = Children.GetSizeI() - 1; i >= 0; --i )
 	{
 		menuMgr.FreeObject( Children[i] );
 	}
 	Children.Resize( 0 );
+	MarkDirty();
 	// NOTE! bounds will be incorrect now until submitted for rendering
 }
 
@@ -1045,6 +1055,7 @@ void VRMenuObject::AddChild( OvrVRMenuMgr & menuMgr, menuHandle_t const handle )
 	{
 		child->SetParentHandle( this->Handle );
 	}
+	MarkDirty();
     // NOTE: bounds will be incorrect until submitted for rendering
 }
 
@@ -1057,6 +1068,7 @@ void VRMenuObject::RemoveChild( OvrVRMenuMgr & menuMgr, menuHandle_t const handl
 		if ( Children[i] == handle )
 		{
 			Children.RemoveAtUnordered( i );
+			MarkDirty();
 			return;
 		}
 	}
@@ -1072,6 +1084,7 @@ void VRMenuObject::FreeChild( OvrVRMenuMgr & menuMgr, menuHandle_t const handle
 		if ( childHandle == handle )
 		{
 			Children.RemoveAtUnordered( i );
+			MarkDirty();
 			menuMgr.FreeObject( childHandle );
 			return;
 		}
@@ -1106,6 +1119,9 @@ bool VRMenuObject::IntersectRayBounds( Vector3f const & start, Vector3f const &
 
 	if ( Bounds3f( mins, maxs ).Contains( start, 0.1f ) )
 	{
+		// the start is inside, so report the hit at the start of the ray
+		t0 = 0.0f;
+		t1 = 0.0f;
 		return true;
 	}
 	Intersect_RayBounds( start, dir, mins, maxs, t0, t1 );
@@ -1177,6 +1193,93 @@ static void TransformByParentPose( Posef const & parentPose, Vector3f const & pa
 	outScale = parentScale.EntrywiseMultiply( localScale );
 }
 
+//==============================
+// VRMenuObject::HitTestSelf
+// Tests the ray (in this object's local space) against this object only, ignoring children.
+bool VRMenuObject::HitTestSelf( OvrGuiSys const & guiSys, Vector3f const & localStart, Vector3f const & localDir,
+		Vector3f const & parentScale, ContentFlags_t const testContents, HitTestResult & result ) const
+{
+	if ( GetContents() & testContents )
+	{
+		if ( Flags & VRMENUOBJECT_BOUND_ALL )
+		{
+			// local bounds are the union of surface bounds and text bounds
+			Bounds3f localBounds = GetLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
+			float t0;
+		        float t1;
+		        bool hit = IntersectRayBounds( localStart, localDir, localBounds.GetMins(), localBounds.GetMaxs(), testContents, t0, t1 );
+			if ( hit )
+			{
+				result.HitHandle = Handle;
+				result.t = t1;
+				result.uv = Vector2f( 0.0f );	// unknown
+			}
+		}
+		else
+		{
+			float selfT0;
+			float selfT1;
+			OvrCollisionResult cresult;
+			Bounds3f const & localBounds = GetLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
+			OVR_ASSERT( !localBounds.IsInverted() );
+
+			bool hit = IntersectRay( localStart, localDir, parentScale, localBounds, selfT0, selfT1, testContents, cresult );
+			if ( hit )
+			{
+				//app->ShowInfoText( 0.0f, "tri: %i", (int)cresult.TriIndex );
+				result = cresult;
+				result.HitHandle = Handle;
+			}
+
+			// also check vs. the text bounds if there is any text
+			if ( !Text.IsEmpty() && GetType() != VRMENU_CONTAINER && ( Flags & VRMENUOBJECT_DONT_HIT_TEXT ) == 0 )
+			{
+				float textT0;
+				float textT1;
+				Bounds3f bounds = GetTextLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
+				bool textHit = IntersectRayBounds( localStart, localDir, bounds.GetMins(), bounds.GetMaxs(), testContents, textT0, textT1 );
+				if ( textHit && textT1 < result.t )
+				{
+					result.HitHandle = Handle;
+					result.t = textT1;
+					result.uv = Vector2f( 0.0f );	// unknown
+				}
+			}
+		}
+	}
+	return result.HitHandle.IsValid();
+}
+
+//==============================
+// VRMenuObject::GetHitTestBounds
+// Returns local bounds, scaled by the parent scale, that contain every hit HitTestSelf can report.
+Bounds3f VRMenuObject::GetHitTestBounds( BitmapFont const & font, Vector3f const & parentScale ) const
+{
+	Bounds3f bounds = GetLocalBounds( font ) * parentScale;
+
+	// text and geometry are tested with the full scale and without the hilight pose, so they
+	// are not necessarily inside the local bounds
+	if ( !Text.IsEmpty() && GetType() != VRMENU_CONTAINER )
+	{
+		bounds = Bounds3f::Union( bounds, GetTextLocalBounds( font ) * parentScale );
+	}
+	Vector3f const scale = GetLocalScale() * parentScale;
+	if ( CollisionPrimitive != NULL )
+	{
+		bounds = Bounds3f::Union( bounds, CollisionPrimitive->GetBounds() * scale );
+	}
+	for ( int i = 0; i < Surfaces.GetSizeI(); ++i )
+	{
+		if ( Surfaces[i].IsRenderable() )
+		{
+			bounds = Bounds3f::Union( bounds, Surfaces[i].GetLocalBounds() * scale );
+		}
+	}
+
+	// IntersectRayBounds reports a hit when the ray starts within 0.1 of the bounds
+	return Bounds3f::Expand( bounds, Vector3f( -0.1f ), Vector3f( 0.1f ) );
+}
+
 //==============================
 // VRMenuObject::HitTest_r
 bool VRMenuObject::HitTest_r( OvrGuiSys const & guiSys, Posef const & parentPose,
@@ -1230,54 +1333,7 @@ bool VRMenuObject::HitTest_r( OvrGuiSys const & guiSys, Posef const & parentPose
 	}
 
 	// test against self first, if not a container
-	if ( GetContents() & testContents )
-	{
-		if ( Flags & VRMENUOBJECT_BOUND_ALL )
-		{
-			// local bounds are the union of surface bounds and text bounds
-			Bounds3f localBounds = GetLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
-			float t0;
-		        float t1;
-		        bool hit = IntersectRayBounds( localStart, localDir, localBounds.GetMins(), localBounds.GetMaxs(), testContents, t0, t1 );
-			if ( hit )
-			{
-				result.HitHandle = Handle;
-				result.t = t1;
-				result.uv = Vector2f( 0.0f );	// unknown
-			}
-		}
-		else
-		{
-			float selfT0;
-			float selfT1;
-			OvrCollisionResult cresult;
-			Bounds3f const & localBounds = GetLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
-			OVR_ASSERT( !localBounds.IsInverted() );
-
-			bool hit = IntersectRay( localStart, localDir, parentScale, localBounds, selfT0, selfT1, testContents, cresult );
-			if ( hit )
-			{
-				//app->ShowInfoText( 0.0f, "tri: %i", (int)cresult.TriIndex );
-				result = cresult;
-				result.HitHandle = Handle;
-			}
-
-			// also check vs. the text bounds if there is any text
-			if ( !Text.IsEmpty() && GetType() != VRMENU_CONTAINER && ( Flags & VRMENUOBJECT_DONT_HIT_TEXT ) == 0 )
-			{
-				float textT0;
-				float textT1;
-				Bounds3f bounds = GetTextLocalBounds( guiSys.GetDefaultFont() ) * parentScale;
-				bool textHit = IntersectRayBounds( localStart, localDir, bounds.GetMins(), bounds.GetMaxs(), testContents, textT0, textT1 );
-				if ( textHit && textT1 < result.t )
-				{
-					result.HitHandle = Handle;
-					result.t = textT1;
-					result.uv = Vector2f( 0.0f );	// unknown
-				}
-			}
-		}
-	}
+	HitTestSelf( guiSys, localStart, localDir, parentScale, testContents, result );
 
 	// test against children
 	for ( int i = 0; i < Children.GetSizeI(); ++i )
@@ -1735,6 +1791,7 @@ Vector4f const & VRMenuObject::GetColor() const
 void VRMenuObject::SetColor( Vector4f const & c )
 {
 	Color = c;
+	MarkDirty();
 }
 
 void VRMenuObject::SetVisible( bool visible )
@@ -1747,6 +1804,7 @@ void VRMenuObject::SetVisible( bool visible )
 	{
 		Flags |= VRMenuObjectFlags_t( VRMENUOBJECT_DONT_RENDER );
 	}
+	MarkDirty();
 }
 
 //==============================
@@ -1813,19 +1871,32 @@ menuHandle_t VRMenuObject::ChildHandleForName( OvrVRMenuMgr const & menuMgr, cha
 		return menuHandle_t();
 	}
 
+	// names are interned, so if the name was never interned no object can have it
+	ovrAtom noCaseName;
+	if ( !ovrAtom::FindNoCase( name, noCaseName ) )
+	{
+		return menuHandle_t();
+	}
+	return ChildHandleForNoCaseName( menuMgr, noCaseName );
+}
+
+//==============================
+// VRMenuObject::ChildHandleForNoCaseName
+menuHandle_t VRMenuObject::ChildHandleForNoCaseName( OvrVRMenuMgr const & menuMgr, ovrAtom const & noCaseName ) const
+{
 	int n = NumChildren();
 	for ( int i = 0; i < n; ++i )
 	{
 		VRMenuObject const * child = static_cast< VRMenuObject* >( menuMgr.ToObject( GetChildHandleForIndex( i ) ) );
 		if ( child != NULL )
 		{
-			if ( OVR_stricmp( child->GetName().ToCStr(), name ) == 0 )
+			if ( child->GetName().GetNoCase() == noCaseName )
 			{
 				return child->GetHandle();
 			}
 			else
 			{
-				menuHandle_t handle = child->ChildHandleForName( menuMgr, name );
+				menuHandle_t handle = child->ChildHandleForNoCaseName( menuMgr, noCaseName );
 				if ( handle.IsValid() )
 				{
 					return handle;
@@ -1845,19 +1916,31 @@ menuHandle_t VRMenuObject::ChildHandleForTag( OvrVRMenuMgr const & menuMgr, char
 		return menuHandle_t();
 	}
 
+	ovrAtom noCaseTag;
+	if ( !ovrAtom::FindNoCase( tag, noCaseTag ) )
+	{
+		return menuHandle_t();
+	}
+	return ChildHandleForNoCaseTag( menuMgr, noCaseTag );
+}
+
+//==============================
+// VRMenuObject::ChildHandleForNoCaseTag
+menuHandle_t VRMenuObject::ChildHandleForNoCaseTag( OvrVRMenuMgr const & menuMgr, ovrAtom const & noCaseTag ) const
+{
 	int n = NumChildren();
 	for ( int i = 0; i < n; ++i )
 	{
 		VRMenuObject const * child = static_cast< VRMenuObject* >( menuMgr.ToObject( GetChildHandleForIndex( i ) ) );
 		if ( child != NULL )
 		{
-			if ( OVR_stricmp( child->GetTag().ToCStr(), tag ) == 0 )
+			if ( child->GetTag().GetNoCase() == noCaseTag )
 			{
 				return child->GetHandle();
 			}
 			else
 			{
-				menuHandle_t handle = child->ChildHandleForTag( menuMgr, tag );
+				menuHandle_t handle = child->ChildHandleForNoCaseTag( menuMgr, noCaseTag );
 				if ( handle.IsValid() )
 				{
 					return handle;
@@ -1966,6 +2049,7 @@ void VRMenuObject::RegenerateSurfaceGeometry( int const surfaceIndex, const bool
 	}
 
 	Surfaces[ surfaceIndex ].RegenerateSurfaceGeometry();
+	MarkDirty();
 }
 
 //==============================
@@ -1992,6 +2076,7 @@ void VRMenuObject::SetSurfaceDims( int const surfaceIndex, Vector2f const &dims
 	}
 
 	Surfaces[ surfaceIndex ].SetDims( dims );
+	MarkDirty();
 }
 
 //==============================
@@ -2018,6 +2103,7 @@ void VRMenuObject::SetSurfaceBorder( int const surfaceIndex, Vector4f const & bo
 	}
 
 	Surfaces[ surfaceIndex ].SetBorder( border );
+	MarkDirty();
 }
 
 
@@ -2027,6 +2113,7 @@ void VRMenuObject::SetLocalBoundsExpand( Vector3f const mins, Vector3f const & m
 {
 	MinsBoundsExpand = mins;
 	MaxsBoundsExpand = maxs;
+	MarkDirty();
 }
 
 //==============================
@@ -2038,6 +2125,7 @@ void VRMenuObject::SetCollisionPrimitive( OvrCollisionPrimitive * c )
 		delete CollisionPrimitive;
 	}
 	CollisionPrimitive = c;
+	MarkDirty();
 }
 
 //==============================
@@ -2128,6 +2216,7 @@ int VRMenuObject::NumSurfaces() const
 // VRMenuObject::AllocSurface
 int VRMenuObject::AllocSurface()
 {
+	MarkDirty();
 	return static_cast<int>( Surfaces.AllocBack() );
 }
 
@@ -2138,6 +2227,7 @@ void VRMenuObject::CreateFromSurfaceParms( OvrGuiSys & guiSys, int const surface
 {
 	VRMenuSurface & surf = Surfaces[surfaceIndex];
 	surf.CreateFromSurfaceParms( guiSys, parms );
+	MarkDirty();
 }
 
 //==============================
@@ -2146,6 +2236,7 @@ void VRMenuObject::SetText( char const * text )
 {
 	Text = text;
 	TextDirty = true;
+	MarkDirty();
 }
 
 //==============================
@@ -2157,6 +2248,13 @@ void VRMenuObject::SetTextWordWrapped( char const * text, BitmapFont const & fon
 	font.WordWrapText( Text, widthInMeters, FontParms.Scale );
 }
 
+//==============================
+// VRMenuObject::MarkDirty
+void VRMenuObject::MarkDirty()
+{
+	MenuMgr->MarkObjectDirty( *this );
+}
+
 //==============================
 // VRMenuObject::TransformByParent
 void VRMenuObject::TransformByParent( Posef const & parentPose,
@@ -2247,9 +2345,10 @@ static void DumpText( char const * token, char const * text, int const size )
 }
 
 //==============================
-// VRMenuObject::ParseItemParms
-ovrParseResult VRMenuObject::ParseItemParms( ovrReflection & refl, ovrLocale const & locale, char const * fileName, 
-		MemBufferT< uint8_t > const & buffer, OVR::Array<VRMenuObjectParms const *> & itemParms )
+// ParseItemParmsText
+static ovrParseResult ParseItemParmsText( ovrReflection & refl, ovrLocale const & locale, char const * fileName, 
+		MemBufferT< uint8_t > const & buffer, OVR::Array<VRMenuObjectParms const *> & itemParms,
+		ovrReflectionRecorder & recorder )
 {
 	ovrLexer lex( buffer, ":;|[],()/*\\#" );
 	
@@ -2338,6 +2437,7 @@ ovrParseResult VRMenuObject::ParseItemParms( ovrReflection & refl, ovrLocale con
 					}
 
 					refl.AddOverload( new ovrReflectionOverload_FloatDefaultValue( scope.ToCStr(), name.ToCStr(), value ) );
+					recorder.OverloadFloat( scope.ToCStr(), name.ToCStr(), value );
 				}
 			}
 			else
@@ -2383,5 +2483,93 @@ ovrParseResult VRMenuObject::ParseItemParms( ovrReflection & refl, ovrLocale con
 	return ovrParseResult();
 }
 
+//==============================
+// ReplayItemParms
+// Nothing is added to itemParms or refl unless the whole recording replays.
+static bool ReplayItemParms( ovrReflection & refl, ovrLocale const & locale, uint8_t const * data, size_t const size,
+		OVR::Array<VRMenuObjectParms const *> & itemParms )
+{
+	ovrTypeInfo const * typeInfo = refl.FindTypeInfo( "OVR::Array< VRMenuObjectParms* >" );
+	Array< VRMenuObjectParms const * > fileParms;
+	Array< ovrReflectionOverload * > overloads;
+
+	ovrReflectionReplay replay( refl, locale, data, size );
+	for ( ; ; )
+	{
+		ovrReflectionOp const op = replay.NextOp();
+		if ( op == REFLECTION_OP_END )
+		{
+			break;
+		}
+
+		bool ok = false;
+		if ( op == REFLECTION_OP_OVERLOAD_FLOAT )
+		{
+			String scope;
+			String name;
+			float value;
+			ok = replay.ReadOverloadFloat( scope, name, value );
+			if ( ok )
+			{
+				overloads.PushBack( new ovrReflectionOverload_FloatDefaultValue( scope.ToCStr(), name.ToCStr(), value ) );
+			}
+		}
+		else if ( op == REFLECTION_OP_ARRAY && typeInfo != nullptr )
+		{
+			Array< VRMenuObjectParms const * > parms;
+			ok = replay.ReadArray( typeInfo, &parms );
+			// append even on failure so that anything that was created is deleted below
+			fileParms.Append( parms );
+		}
+
+		if ( !ok )
+		{
+			DeletePointerArray( fileParms );
+			DeletePointerArray( overloads );
+			return false;
+		}
+	}
+
+	for ( int i = 0; i < overloads.GetSizeI(); ++i )
+	{
+		refl.AddOverload( overloads[i] );
+	}
+	itemParms.Append( fileParms );
+	return true;
+}
+
+//==============================
+// VRMenuObject::ParseItemParms
+ovrParseResult VRMenuObject::ParseItemParms( ovrReflection & refl, ovrLocale const & locale, char const * fileName, 
+		MemBufferT< uint8_t > const & buffer, OVR::Array<VRMenuObjectParms const *> & itemParms )
+{
+	// if this file was parsed before with the same types and overloads, replay the result
+	ovrReflectionCache & cache = refl.GetCache();
+	uint64_t const key = ovrReflectionCache::MakeKey( refl, static_cast< uint8_t const * >( buffer ), buffer.GetSize() );
+	uint8_t const * data;
+	size_t size;
+	if ( cache.Find( key, data, size ) )
+	{
+		if ( ReplayItemParms( refl, locale, data, size, itemParms ) )
+		{
+			return ovrParseResult();
+		}
+		OVR_WARN( "Failed to replay cached reflection data for '%s'.", fileName );
+	}
+
+	ovrReflectionRecorder recorder( refl );
+	ovrReflectionRecorder * const prevRecorder = refl.GetRecorder();
+	refl.SetRecorder( &recorder );
+	ovrParseResult const parseRes = ParseItemParmsText( refl, locale, fileName, buffer, itemParms, recorder );
+	refl.SetRecorder( prevRecorder );
+
+	if ( parseRes )
+	{
+		recorder.EndRecording();
+		cache.Store( key, recorder );
+	}
+	return parseRes;
+}
+
 
 } // namespace OVR
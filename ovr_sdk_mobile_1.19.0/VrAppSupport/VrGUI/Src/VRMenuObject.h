@@ -17,6 +17,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_Math.h"
 #include "Kernel/OVR_Array.h"
 #include "Kernel/OVR_String.h"
+#include "Kernel/OVR_Atom.h"
 #include "Kernel/OVR_TypesafeNumber.h"
 #include "Kernel/OVR_BitFlags.h"
 #include "OVR_GlUtils.h"	// GLuint
@@ -891,6 +892,7 @@ class VRMenuObject
 public:
 	friend class VRMenuMgr;
 	friend class VRMenuMgrLocal;
+	friend class ovrVRMenuBvh;
 
 	class ovrRecursionFunctor
 	{
@@ -976,9 +978,9 @@ public:
 	void				SetParentHandle( menuHandle_t const h ) { ParentHandle = h; }
 
 	VRMenuObjectFlags_t const &	GetFlags() const { return Flags; }
-	void				SetFlags( VRMenuObjectFlags_t const & flags ) { Flags = flags; }
-	void				AddFlags( VRMenuObjectFlags_t const & flags ) { Flags |= flags; }
-	void				RemoveFlags( VRMenuObjectFlags_t const & flags ) { Flags &= ~flags; }
+	void				SetFlags( VRMenuObjectFlags_t const & flags ) { Flags = flags; MarkDirty(); }
+	void				AddFlags( VRMenuObjectFlags_t const & flags ) { Flags |= flags; MarkDirty(); }
+	void				RemoveFlags( VRMenuObjectFlags_t const & flags ) { Flags &= ~flags; MarkDirty(); }
 
 	void				ModifyFlags( bool const add, VRMenuObjectFlags_t const & flags )
 	{
@@ -1004,28 +1006,28 @@ public:
 	menuHandle_t		GetChildHandleForIndex( int const index ) const { return Children[index]; }
 
 	Posef const &		GetLocalPose() const { return LocalPose; }
-	void				SetLocalPose( Posef const & pose ) { LocalPose = pose; }
+	void				SetLocalPose( Posef const & pose ) { LocalPose = pose; MarkDirty(); }
 	Vector3f const &	GetLocalPosition() const { return LocalPose.Translation; }
-	void				SetLocalPosition( Vector3f const & pos ) { LocalPose.Translation = pos; }
+	void				SetLocalPosition( Vector3f const & pos ) { LocalPose.Translation = pos; MarkDirty(); }
 	Quatf const &		GetLocalRotation() const { return LocalPose.Rotation; }
-	void				SetLocalRotation( Quatf const & rot ) { LocalPose.Rotation = rot; }
+	void				SetLocalRotation( Quatf const & rot ) { LocalPose.Rotation = rot; MarkDirty(); }
 	Vector3f            GetLocalScale() const;
-	void				SetLocalScale( Vector3f const & scale ) { LocalScale = scale; }
+	void				SetLocalScale( Vector3f const & scale ) { LocalScale = scale; MarkDirty(); }
 
     Posef const &       GetHilightPose() const { return HilightPose; }
-    void                SetHilightPose( Posef const & pose ) { HilightPose = pose; }
+    void                SetHilightPose( Posef const & pose ) { HilightPose = pose; MarkDirty(); }
     float               GetHilightScale() const { return HilightScale; }
-    void                SetHilightScale( float const s ) { HilightScale = s; }
+    void                SetHilightScale( float const s ) { HilightScale = s; MarkDirty(); }
 
-    void                SetTextLocalPose( Posef const & pose ) { TextLocalPose = pose; }
+    void                SetTextLocalPose( Posef const & pose ) { TextLocalPose = pose; MarkDirty(); }
     Posef const &       GetTextLocalPose() const { return TextLocalPose; }
-    void                SetTextLocalPosition( Vector3f const & pos ) { TextLocalPose.Translation = pos; }
+    void                SetTextLocalPosition( Vector3f const & pos ) { TextLocalPose.Translation = pos; MarkDirty(); }
     Vector3f const &    GetTextLocalPosition() const { return TextLocalPose.Translation; }
-    void                SetTextLocalRotation( Quatf const & rot ) { TextLocalPose.Rotation = rot; }
+    void                SetTextLocalRotation( Quatf const & rot ) { TextLocalPose.Rotation = rot; MarkDirty(); }
     Quatf const &       GetTextLocalRotation() const { return TextLocalPose.Rotation; }
     Vector3f            GetTextLocalScale() const;
 	float				GetWrapScale() const { return WrapScale; }
-    void                SetTextLocalScale( Vector3f const & scale ) { TextLocalScale = scale; }
+    void                SetTextLocalScale( Vector3f const & scale ) { TextLocalScale = scale; MarkDirty(); }
 
 	void				SetLocalBoundsExpand( Vector3f const mins, Vector3f const & maxs );
 
@@ -1045,15 +1047,15 @@ public:
     Vector4f const &	GetTextColor() const { return TextColor; }
     void				SetTextColor( Vector4f const & c ) { TextColor = c; }
 
-	String const &		GetName() const { return Name; }
-	String const &		GetTag() const { return Tag; }
+	ovrAtom const &		GetName() const { return Name; }
+	ovrAtom const &		GetTag() const { return Tag; }
 	VRMenuId_t			GetId() const { return Id; }
 	VRMenuObject *		ChildForId( OvrVRMenuMgr const & menuMgr, VRMenuId_t const id ) const;
 	menuHandle_t		ChildHandleForId( OvrVRMenuMgr const & menuMgr, VRMenuId_t const id ) const;
 	menuHandle_t		ChildHandleForName( OvrVRMenuMgr const & menuMgr, char const * name ) const;
 	menuHandle_t		ChildHandleForTag( OvrVRMenuMgr const & menuMgr, char const * tag ) const;
 
-	void				SetFontParms( VRMenuFontParms const & fontParms ) { FontParms = fontParms; }
+	void				SetFontParms( VRMenuFontParms const & fontParms ) { FontParms = fontParms; MarkDirty(); }
 	VRMenuFontParms const & GetFontParms() const { return FontParms; }
 
 	Vector3f const &	GetFadeDirection() const { return FadeDirection;  }
@@ -1099,16 +1101,20 @@ public:
 	//--------------------------------------------------------------
 	// collision
 	//--------------------------------------------------------------
+	// The bounds the menu manager caches are only updated by SetCollisionPrimitive(), not by
+	// changes made through GetCollisionPrimitive().
 	void							SetCollisionPrimitive( OvrCollisionPrimitive * c );
 	OvrCollisionPrimitive *			GetCollisionPrimitive() { return CollisionPrimitive; }
 	OvrCollisionPrimitive const *	GetCollisionPrimitive() const { return CollisionPrimitive; }
 
 	ContentFlags_t		GetContents() const { return Contents; }
-	void				SetContents( ContentFlags_t const c ) { Contents = c; }
+	void				SetContents( ContentFlags_t const c ) { Contents = c; MarkDirty(); }
 
 	//--------------------------------------------------------------
 	// surfaces (non-virtual)
 	//--------------------------------------------------------------
+	// Changes to the size of a surface go through SetSurfaceDims(), SetSurfaceBorder() or
+	// RegenerateSurfaceGeometry() so that the cached bounds are updated.
 	VRMenuSurface const &			GetSurface( int const s ) const { return Surfaces[s]; }
 	VRMenuSurface &					GetSurface( int const s ) { return Surfaces[s]; }
 	Array< VRMenuSurface > const &	GetSurfaces() const { return Surfaces; }
@@ -1153,8 +1159,8 @@ private:
 	menuHandle_t				ParentHandle;	// handle of this object's parent
 	VRMenuId_t					Id;				// opaque id that the creator of the menu can use to identify a menu object
 	VRMenuObjectFlags_t			Flags;			// various bit flags
-	OVR::String					Name;			// name of this object (can be empty)
-	OVR::String					Tag;			// tags are like names but are always child-relative.
+	ovrAtom						Name;			// name of this object (can be empty)
+	ovrAtom						Tag;			// tags are like names but are always child-relative.
 	Posef						LocalPose;		// local-space position and orientation
 	Vector3f					LocalScale;		// local-space scale of this item
     Posef                       HilightPose;    // additional pose applied when hilighted
@@ -1194,11 +1200,17 @@ private:
 
 	mutable ovrTextSurface	*	TextSurface;
 
+	OvrVRMenuMgr *				MenuMgr;			// manager that owns this object and caches its world transform
+
 private:
 	// only VRMenuMgrLocal static methods can construct and destruct a menu object.
-	VRMenuObject( VRMenuObjectParms const & parms, menuHandle_t const handle );
+	VRMenuObject( OvrVRMenuMgr & menuMgr, VRMenuObjectParms const & parms, menuHandle_t const handle );
 	~VRMenuObject();
 
+	// Tells the menu manager that something affecting this object's world transform, color
+	// or bounds changed, so its cached world state has to be rebuilt on the next submit.
+	void						MarkDirty();
+
 	bool						IntersectRayBounds( Vector3f const & start, Vector3f const & dir,
 										Vector3f const & mins, Vector3f const & maxs,
 										ContentFlags_t const testContents, float & t0, float & t1 ) const;
@@ -1209,9 +1221,19 @@ private:
 	bool						HitTest_r( OvrGuiSys const & guiSys, Posef const & parentPose, Vector3f const & parentScale,
                                         Vector3f const & rayStart, Vector3f const & rayDir,  ContentFlags_t const testContents,
                                         HitTestResult & result ) const;
+	// Tests the ray (in this object's local space) against this object only.
+	bool						HitTestSelf( OvrGuiSys const & guiSys, Vector3f const & localStart, Vector3f const & localDir,
+										Vector3f const & parentScale, ContentFlags_t const testContents,
+										HitTestResult & result ) const;
+	// Local bounds, scaled by the parent scale, that contain any hit reported by HitTestSelf.
+	Bounds3f					GetHitTestBounds( BitmapFont const & font, Vector3f const & parentScale ) const;
 
 	int							GetComponentIndex( VRMenuComponent * component ) const;
 
+	// Depth-first searches for a child by the lower-case atom of its name or tag.
+	menuHandle_t				ChildHandleForNoCaseName( OvrVRMenuMgr const & menuMgr, ovrAtom const & noCaseName ) const;
+	menuHandle_t				ChildHandleForNoCaseTag( OvrVRMenuMgr const & menuMgr, ovrAtom const & noCaseTag ) const;
+
 	void						FreeTextSurface() const;
 
 	// Called by VRMenuMgr to free deleted components.
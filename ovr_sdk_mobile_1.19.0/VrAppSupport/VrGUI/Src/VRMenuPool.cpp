@@ -0,0 +1,286 @@
+/************************************************************************************
+
+Filename    :   VRMenuPool.cpp
+Content     :   Slab pools for menu objects and components.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#include "VRMenuPool.h"
+
+#include "Kernel/OVR_Allocator.h"
+#include "Kernel/OVR_Atomic.h"
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_LogUtils.h"
+#include <new>
+
+namespace OVR {
+
+static size_t const POOL_ALIGNMENT = 16;
+
+static size_t AlignElementSize( size_t const size )
+{
+	// blocks on the free list hold a pointer
+	size_t const minSize = Alg::Max( size, sizeof( void* ) );
+	return ( minSize + POOL_ALIGNMENT - 1 ) & ~( POOL_ALIGNMENT - 1 );
+}
+
+//==============================
+// ovrSlabPool::ovrSlabPool
+ovrSlabPool::ovrSlabPool( char const * name, size_t const elementSize, int const elementsPerSlab )
+	: FreeBlocks( NULL )
+	, NumFree( 0 )
+{
+	OVR_ASSERT( elementsPerSlab > 0 );
+	Stats.Name = name;
+	Stats.ElementSize = static_cast< int >( AlignElementSize( elementSize ) );
+	Stats.ElementsPerSlab = elementsPerSlab;
+}
+
+//==============================
+// ovrSlabPool::~ovrSlabPool
+ovrSlabPool::~ovrSlabPool()
+{
+	if ( Stats.NumLive != 0 )
+	{
+		OVR_WARN( "ovrSlabPool '%s' destroyed with %i live elements", Stats.Name, Stats.NumLive );
+	}
+	for ( int i = 0; i < Slabs.GetSizeI(); ++i )
+	{
+		OVR_FREE_ALIGNED( Slabs[i] );
+	}
+	Slabs.Clear();
+}
+
+//==============================
+// ovrSlabPool::AllocSlab
+void ovrSlabPool::AllocSlab()
+{
+	UByte * slab = static_cast< UByte* >( OVR_ALLOC_ALIGNED( Stats.ElementSize * Stats.ElementsPerSlab, POOL_ALIGNMENT ) );
+	Slabs.PushBack( slab );
+	Stats.NumSlabs = Slabs.GetSizeI();
+
+	// push in reverse so blocks are handed out in address order
+	for ( int i = Stats.ElementsPerSlab - 1; i >= 0; --i )
+	{
+		ovrFreeBlock * block = reinterpret_cast< ovrFreeBlock* >( slab + i * Stats.ElementSize );
+		block->Next = FreeBlocks;
+		FreeBlocks = block;
+	}
+	NumFree += Stats.ElementsPerSlab;
+}
+
+//==============================
+// ovrSlabPool::Alloc
+void * ovrSlabPool::Alloc()
+{
+	if ( FreeBlocks == NULL )
+	{
+		AllocSlab();
+	}
+	ovrFreeBlock * block = FreeBlocks;
+	FreeBlocks = block->Next;
+	NumFree--;
+
+	Stats.NumAllocs++;
+	Stats.NumLive++;
+	Stats.PeakLive = Alg::Max( Stats.PeakLive, Stats.NumLive );
+	return block;
+}
+
+//==============================
+// ovrSlabPool::Free
+void ovrSlabPool::Free( void * p )
+{
+	if ( p == NULL )
+	{
+		return;
+	}
+	ovrFreeBlock * block = static_cast< ovrFreeBlock* >( p );
+	block->Next = FreeBlocks;
+	FreeBlocks = block;
+	NumFree++;
+
+	Stats.NumFrees++;
+	Stats.NumLive--;
+}
+
+//==============================
+// ovrSlabPool::Reserve
+void ovrSlabPool::Reserve( int const count )
+{
+	while ( NumFree < count )
+	{
+		AllocSlab();
+	}
+}
+
+//==============================
+// ovrSlabPool::GetStats
+void ovrSlabPool::GetStats( ovrPoolStats & stats ) const
+{
+	stats = Stats;
+}
+
+//==============================
+// ovrSlotPool::ovrSlotPool
+ovrSlotPool::ovrSlotPool( char const * name, size_t const elementSize, int const elementsPerSlab )
+{
+	OVR_ASSERT( elementsPerSlab > 0 );
+	Stats.Name = name;
+	Stats.ElementSize = static_cast< int >( AlignElementSize( elementSize ) );
+	Stats.ElementsPerSlab = elementsPerSlab;
+}
+
+//==============================
+// ovrSlotPool::~ovrSlotPool
+ovrSlotPool::~ovrSlotPool()
+{
+	// elements still in use are the owner's responsibility
+	for ( int i = 0; i < Slabs.GetSizeI(); ++i )
+	{
+		OVR_FREE_ALIGNED( Slabs[i] );
+	}
+	Slabs.Clear();
+}
+
+//==============================
+// ovrSlotPool::Reserve
+void ovrSlotPool::Reserve( int const numSlots )
+{
+	int const numSlabs = ( numSlots + Stats.ElementsPerSlab - 1 ) / Stats.ElementsPerSlab;
+	while ( Slabs.GetSizeI() < numSlabs )
+	{
+		Slabs.PushBack( static_cast< UByte* >( OVR_ALLOC_ALIGNED( Stats.ElementSize * Stats.ElementsPerSlab, POOL_ALIGNMENT ) ) );
+	}
+	Stats.NumSlabs = Slabs.GetSizeI();
+}
+
+//==============================
+// ovrSlotPool::Acquire
+void * ovrSlotPool::Acquire( int const slot )
+{
+	OVR_ASSERT( slot >= 0 );
+	Reserve( slot + 1 );
+
+	Stats.NumAllocs++;
+	Stats.NumLive++;
+	Stats.PeakLive = Alg::Max( Stats.PeakLive, Stats.NumLive );
+
+	int const slab = slot / Stats.ElementsPerSlab;
+	int const offset = slot - slab * Stats.ElementsPerSlab;
+	return Slabs[slab] + offset * Stats.ElementSize;
+}
+
+//==============================
+// ovrSlotPool::Release
+void ovrSlotPool::Release( int const slot )
+{
+	OVR_UNUSED( slot );
+	OVR_ASSERT( slot >= 0 && slot < Slabs.GetSizeI() * Stats.ElementsPerSlab );
+	Stats.NumFrees++;
+	Stats.NumLive--;
+}
+
+//==============================
+// ovrSlotPool::GetStats
+void ovrSlotPool::GetStats( ovrPoolStats & stats ) const
+{
+	stats = Stats;
+}
+
+//==============================================================
+// ovrComponentPools
+// Never destroyed, because components can still be freed during static destruction.
+static int const NUM_COMPONENT_SIZE_CLASSES = 4;
+static size_t const ComponentSizeClasses[NUM_COMPONENT_SIZE_CLASSES] = { 64, 128, 256, 512 };
+static int const COMPONENTS_PER_SLAB = 64;
+
+struct ovrComponentPools
+{
+	ovrComponentPools()
+	{
+		static char const * names[NUM_COMPONENT_SIZE_CLASSES] =
+		{
+			"VRMenuComponent 64", "VRMenuComponent 128", "VRMenuComponent 256", "VRMenuComponent 512"
+		};
+		for ( int i = 0; i < NUM_COMPONENT_SIZE_CLASSES; ++i )
+		{
+			Pools[i] = new ovrSlabPool( names[i], ComponentSizeClasses[i], COMPONENTS_PER_SLAB );
+		}
+	}
+
+	Lock			PoolLock;
+	ovrSlabPool *	Pools[NUM_COMPONENT_SIZE_CLASSES];
+};
+
+static ovrComponentPools & GetComponentPools()
+{
+	static ovrComponentPools * pools = new ovrComponentPools();
+	return *pools;
+}
+
+static int GetComponentSizeClass( size_t const size )
+{
+	for ( int i = 0; i < NUM_COMPONENT_SIZE_CLASSES; ++i )
+	{
+		if ( size <= ComponentSizeClasses[i] )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+//==============================
+// ovrComponentAllocator::Alloc
+void * ovrComponentAllocator::Alloc( size_t const size )
+{
+	int const sizeClass = GetComponentSizeClass( size );
+	if ( sizeClass < 0 )
+	{
+		return ::operator new( size );
+	}
+	ovrComponentPools & pools = GetComponentPools();
+	Lock::Locker locker( &pools.PoolLock );
+	return pools.Pools[sizeClass]->Alloc();
+}
+
+//==============================
+// ovrComponentAllocator::Free
+void ovrComponentAllocator::Free( void * p, size_t const size )
+{
+	if ( p == NULL )
+	{
+		return;
+	}
+	int const sizeClass = GetComponentSizeClass( size );
+	if ( sizeClass < 0 )
+	{
+		::operator delete( p );
+		return;
+	}
+	ovrComponentPools & pools = GetComponentPools();
+	Lock::Locker locker( &pools.PoolLock );
+	pools.Pools[sizeClass]->Free( p );
+}
+
+//==============================
+// ovrComponentAllocator::GetStats
+void ovrComponentAllocator::GetStats( Array< ovrPoolStats > & stats )
+{
+	ovrComponentPools & pools = GetComponentPools();
+	Lock::Locker locker( &pools.PoolLock );
+	for ( int i = 0; i < NUM_COMPONENT_SIZE_CLASSES; ++i )
+	{
+		ovrPoolStats s;
+		pools.Pools[i]->GetStats( s );
+		stats.PushBack( s );
+	}
+}
+
+} // namespace OVR
@@ -0,0 +1,133 @@
+/************************************************************************************
+
+Filename    :   VRMenuPool.h
+Content     :   Slab pools for menu objects and components.
+Created     :   10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#if !defined( OVR_VRMenuPool_h )
+#define OVR_VRMenuPool_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+
+namespace OVR {
+
+//==============================================================
+// ovrPoolStats
+struct ovrPoolStats
+{
+	ovrPoolStats() :
+		Name( "" ),
+		ElementSize( 0 ),
+		ElementsPerSlab( 0 ),
+		NumSlabs( 0 ),
+		NumLive( 0 ),
+		PeakLive( 0 ),
+		NumAllocs( 0 ),
+		NumFrees( 0 )
+	{
+	}
+
+	char const *	Name;
+	int				ElementSize;		// size of each element, including padding
+	int				ElementsPerSlab;
+	int				NumSlabs;			// slabs currently allocated
+	int				NumLive;			// elements currently in use
+	int				PeakLive;			// most elements in use at any one time
+	UInt64			NumAllocs;			// elements handed out since the pool was created
+	UInt64			NumFrees;			// elements returned since the pool was created
+};
+
+//==============================================================
+// ovrSlabPool
+//
+// Hands out fixed-size blocks carved from large slabs. Freed blocks are kept on an
+// intrusive free list and reused before another slab is allocated. Slabs are only
+// released when the pool is destroyed.
+class ovrSlabPool
+{
+public:
+					ovrSlabPool( char const * name, size_t const elementSize, int const elementsPerSlab );
+					~ovrSlabPool();
+
+	void *			Alloc();
+	void			Free( void * p );
+
+	// Allocates enough slabs that count more blocks can be handed out without allocating.
+	void			Reserve( int const count );
+
+	void			GetStats( ovrPoolStats & stats ) const;
+
+private:
+	struct ovrFreeBlock
+	{
+		ovrFreeBlock *	Next;
+	};
+
+	Array< UByte* >	Slabs;
+	ovrFreeBlock *	FreeBlocks;
+	int				NumFree;
+	ovrPoolStats	Stats;
+
+	void			AllocSlab();
+
+	// copying would free the slabs twice
+					ovrSlabPool( ovrSlabPool const & );
+	ovrSlabPool &	operator=( ovrSlabPool const & );
+};
+
+//==============================================================
+// ovrSlotPool
+//
+// Storage for elements that are addressed by a slot index, like the index part of a
+// menu handle. Each slot always lives at the same address, so growing the pool never
+// moves live elements. The caller constructs and destructs elements in place.
+class ovrSlotPool
+{
+public:
+					ovrSlotPool( char const * name, size_t const elementSize, int const elementsPerSlab );
+					~ovrSlotPool();
+
+	// Returns the storage for a slot, allocating its slab if needed.
+	void *			Acquire( int const slot );
+	// Marks the slot as unused. The storage is kept for the next Acquire().
+	void			Release( int const slot );
+
+	// Allocates the slabs for slots [0, numSlots).
+	void			Reserve( int const numSlots );
+
+	void			GetStats( ovrPoolStats & stats ) const;
+
+private:
+	Array< UByte* >	Slabs;
+	ovrPoolStats	Stats;
+
+					ovrSlotPool( ovrSlotPool const & );
+	ovrSlotPool &	operator=( ovrSlotPool const & );
+};
+
+//==============================================================
+// ovrComponentAllocator
+//
+// Size-segregated slab pools backing VRMenuComponent::operator new. Component types of
+// similar size share a pool, larger components use the global heap. This is used from
+// any thread that creates components, so the pools are locked.
+class ovrComponentAllocator
+{
+public:
+	static void *	Alloc( size_t const size );
+	static void		Free( void * p, size_t const size );
+
+	// Appends the statistics for each size class.
+	static void		GetStats( Array< ovrPoolStats > & stats );
+};
+
+} // namespace OVR
+
+#endif // OVR_VRMenuPool_h
@@ -20,7 +20,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "tinyxml2.h"
 #include "Kernel/OVR_Types.h"
 #include "Kernel/OVR_Array.h"
-#include "Kernel/OVR_Hash.h"
+#include "Kernel/OVR_StringHash.h"
 #include "Kernel/OVR_MemBuffer.h"
 #include "Kernel/OVR_JSON.h"
 #include "Kernel/OVR_LogUtils.h"
@@ -32,33 +32,6 @@ namespace OVR {
 char const *	ovrLocale::LOCALIZED_KEY_PREFIX = "@string/";
 size_t const	ovrLocale::LOCALIZED_KEY_PREFIX_LEN = OVR_strlen( LOCALIZED_KEY_PREFIX );
 
-// DJB2 string hash function
-static unsigned long DJB2Hash( char const * str )
-{
-    unsigned long hash = 5381;
-    int c;
-
-	for ( c = *str; c != 0; str++, c = *str )
-    //while ( c = *str++ )
-	{
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
-	}
-    return hash;
-}
-
-//==============================================================
-// Hash functor for OVR::String
-
-template< class C >
-class OvrStringHash
-{
-public:
-	UPInt operator()( const C & data ) const
-	{
-		return DJB2Hash( data.ToCStr() );
-	}
-};
-
 //==============================================================
 // ovrLocaleInternal
 class ovrLocaleInternal : public ovrLocale
@@ -95,11 +68,9 @@ private:
 	jobject									activityObject;
 #endif
 
-	typedef OvrStringHash< String >			HashFunctor;
-
 	String									Name;			// user-specified locale name
 	String									LanguageCode;	// system-specific locale name
-	OVR::Hash< String, int, HashFunctor >	StringHash;
+	StringHash< int >						StringIndices;	// index into Strings for each key
 	Array< String	>						Strings;
 
 private:
@@ -263,10 +234,11 @@ bool ovrLocaleInternal::AddStringsFromAndroidFormatXMLBuffer( char const * name,
 		}
 		//OVR_LOG( "Name: '%s' = '%s'\n", key.ToCStr(), value.ToCStr() );
 
-		int index = -1;
-		if ( !StringHash.Get( key, &index ) )
+		// hash once for both the duplicate check and the insert
+		size_t const keyHash = StringIndices.CalcHash( key );
+		if ( StringIndices.GetWithHash( key, keyHash ) == NULL )
 		{
-			StringHash.Add( key, Strings.GetSizeI() );
+			StringIndices.AddWithHash( key, Strings.GetSizeI(), keyHash );
 			Strings.PushBack( decodedValue );
 		}
 	}
@@ -356,9 +328,9 @@ bool ovrLocaleInternal::GetString( char const * key, char const * defaultStr, St
 	{
 		if ( Strings.GetSizeI() > 0 )
 		{
-			String realKey( key + LOCALIZED_KEY_PREFIX_LEN );
+			char const * realKey = key + LOCALIZED_KEY_PREFIX_LEN;
 			int index = -1;
-			if ( StringHash.Get( realKey, &index ) )
+			if ( StringIndices.Get( realKey, &index ) )
 			{
 				out = Strings[index];
 				return true;
@@ -12,6 +12,15 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "ModelCollision.h"
 
 #include <math.h>
+#include <float.h>
+
+#if defined( __SSE2__ ) || defined( OVR_CPU_X86_64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define OVR_MODEL_COLLISION_SSE2
+#elif defined( __ARM_NEON ) || defined( OVR_CPU_ARM_NEON )
+#include <arm_neon.h>
+#define OVR_MODEL_COLLISION_NEON
+#endif
 
 #include "Kernel/OVR_Alg.h"
 #include "Kernel/OVR_Array.h"
@@ -116,15 +125,476 @@ bool CollisionPolytope::PopOut( Vector3f & p ) const
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//	ovrSimd4f
+//-----------------------------------------------------------------------------
+
+#if defined( OVR_MODEL_COLLISION_SSE2 )
+
+typedef __m128 ovrSimd4f;
+
+static inline ovrSimd4f Simd4fLoad( const float * p ) { return _mm_loadu_ps( p ); }
+static inline ovrSimd4f Simd4fSet( const float f ) { return _mm_set1_ps( f ); }
+static inline ovrSimd4f Simd4fAdd( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_add_ps( a, b ); }
+static inline ovrSimd4f Simd4fMul( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_mul_ps( a, b ); }
+static inline ovrSimd4f Simd4fMin( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_min_ps( a, b ); }
+static inline bool Simd4fAnyGreater( const ovrSimd4f a, const ovrSimd4f b ) { return _mm_movemask_ps( _mm_cmpgt_ps( a, b ) ) != 0; }
+
+#elif defined( OVR_MODEL_COLLISION_NEON )
+
+typedef float32x4_t ovrSimd4f;
+
+static inline ovrSimd4f Simd4fLoad( const float * p ) { return vld1q_f32( p ); }
+static inline ovrSimd4f Simd4fSet( const float f ) { return vdupq_n_f32( f ); }
+static inline ovrSimd4f Simd4fAdd( const ovrSimd4f a, const ovrSimd4f b ) { return vaddq_f32( a, b ); }
+static inline ovrSimd4f Simd4fMul( const ovrSimd4f a, const ovrSimd4f b ) { return vmulq_f32( a, b ); }
+static inline ovrSimd4f Simd4fMin( const ovrSimd4f a, const ovrSimd4f b ) { return vminq_f32( a, b ); }
+static inline bool Simd4fAnyGreater( const ovrSimd4f a, const ovrSimd4f b )
+{
+	const uint32x4_t m = vcgtq_f32( a, b );
+	const uint32x2_t n = vorr_u32( vget_low_u32( m ), vget_high_u32( m ) );
+	return ( vget_lane_u32( n, 0 ) | vget_lane_u32( n, 1 ) ) != 0;
+}
+
+#else
+
+struct ovrSimd4f
+{
+	float	v[4];
+};
+
+static inline ovrSimd4f Simd4fLoad( const float * p ) { ovrSimd4f r = { { p[0], p[1], p[2], p[3] } }; return r; }
+static inline ovrSimd4f Simd4fSet( const float f ) { ovrSimd4f r = { { f, f, f, f } }; return r; }
+static inline ovrSimd4f Simd4fAdd( const ovrSimd4f a, const ovrSimd4f b ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] + b.v[i]; } return r; }
+static inline ovrSimd4f Simd4fMul( const ovrSimd4f a, const ovrSimd4f b ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] * b.v[i]; } return r; }
+static inline ovrSimd4f Simd4fMin( const ovrSimd4f a, const ovrSimd4f b ) { ovrSimd4f r; for ( int i = 0; i < 4; i++ ) { r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; } return r; }
+static inline bool Simd4fAnyGreater( const ovrSimd4f a, const ovrSimd4f b ) { return a.v[0] > b.v[0] || a.v[1] > b.v[1] || a.v[2] > b.v[2] || a.v[3] > b.v[3]; }
+
+#endif
+
+//-----------------------------------------------------------------------------
+//	Cull bounds
+//-----------------------------------------------------------------------------
+
+// The SIMD plane tests only decide when the plane distances are further than this from
+// zero, relative to the magnitude of the terms, and leave the rest to the scalar tests.
+// This keeps the results the same as the scalar tests, with or without fused multiply-adds.
+const float SIMD_PLANE_TOLERANCE = 1e-5f;
+
+// Polytopes with more planes are tested by every query.
+const int MAX_CULL_PLANES = 64;
+
+// TestRay can only return true if every plane has an end of the ray on its inside, which
+// means that the start of the ray is inside the polytope with every plane moved out by the
+// part of the ray along its normal. Any three planes whose normals add up to an axis with
+// non-negative weights y bound that polytope along the axis, because along the axis
+// x = sum( y * N.x ) <= sum( y * ( -D + max( 0, -N.ray ) ) ). The best bound over all
+// triples is the support of the polytope along the axis. Returns false if the polytope is
+// not bounded along all six axes, or has too many planes.
+bool ModelCollision::CalculateCullBounds( const Array< Planef > & planes, ovrCullBounds & bounds )
+{
+	const int numPlanes = planes.GetSizeI();
+	if ( numPlanes < 4 || numPlanes > MAX_CULL_PLANES )
+	{
+		return false;
+	}
+
+	double best[6];
+	double bestGrow[6];
+	for ( int i = 0; i < 6; i++ )
+	{
+		best[i] = DBL_MAX;
+		bestGrow[i] = DBL_MAX;
+	}
+
+	for ( int a = 0; a < numPlanes; a++ )
+	{
+		for ( int b = a + 1; b < numPlanes; b++ )
+		{
+			for ( int c = b + 1; c < numPlanes; c++ )
+			{
+				const Planef * p[3] = { &planes[a], &planes[b], &planes[c] };
+				double m[3][3];
+				for ( int i = 0; i < 3; i++ )
+				{
+					m[i][0] = p[i]->N.x;
+					m[i][1] = p[i]->N.y;
+					m[i][2] = p[i]->N.z;
+				}
+				// inverse from the cofactors
+				double inv[3][3];
+				inv[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+				inv[0][1] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+				inv[0][2] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+				inv[1][0] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+				inv[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+				inv[1][2] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+				inv[2][0] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+				inv[2][1] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+				inv[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+				const double det = m[0][0] * inv[0][0] + m[0][1] * inv[1][0] + m[0][2] * inv[2][0];
+				const double scale = p[0]->N.Length() * p[1]->N.Length() * p[2]->N.Length();
+				if ( fabs( det ) <= 1e-6 * scale )
+				{
+					continue;
+				}
+
+				for ( int axis = 0; axis < 3; axis++ )
+				{
+					for ( int sign = 0; sign < 2; sign++ )
+					{
+						// the weights for +axis are row 'axis' of the inverse
+						double y[3];
+						bool valid = true;
+						for ( int i = 0; i < 3 && valid; i++ )
+						{
+							y[i] = ( sign == 0 ? inv[axis][i] : -inv[axis][i] ) / det;
+							if ( y[i] < -1e-9 )
+							{
+								valid = false;
+							}
+							y[i] = Alg::Max( y[i], 0.0 );
+						}
+						if ( !valid )
+						{
+							continue;
+						}
+						double bound = 0.0;
+						double pos[3] = { 0.0, 0.0, 0.0 };
+						double neg[3] = { 0.0, 0.0, 0.0 };
+						for ( int i = 0; i < 3; i++ )
+						{
+							bound -= y[i] * p[i]->D;
+							for ( int k = 0; k < 3; k++ )
+							{
+								const double n = p[i]->N[k];
+								neg[k] += y[i] * Alg::Max( n, 0.0 );
+								pos[k] += y[i] * Alg::Max( -n, 0.0 );
+							}
+						}
+						const double grow = pos[0] + pos[1] + pos[2] + neg[0] + neg[1] + neg[2];
+						const int slab = axis * 2 + sign;
+						if ( bound < best[slab] || ( bound == best[slab] && grow < bestGrow[slab] ) )
+						{
+							best[slab] = bound;
+							bestGrow[slab] = grow;
+							bounds.Slabs[slab].GrowPos = Vector3f( (float)pos[0], (float)pos[1], (float)pos[2] );
+							bounds.Slabs[slab].GrowNeg = Vector3f( (float)neg[0], (float)neg[1], (float)neg[2] );
+						}
+					}
+				}
+			}
+		}
+	}
+
+	for ( int i = 0; i < 6; i++ )
+	{
+		if ( best[i] == DBL_MAX )
+		{
+			return false;
+		}
+		// cover the rounding of the float plane tests
+		ovrCullSlab & slab = bounds.Slabs[i];
+		slab.Bound = (float)( best[i] + 1e-3 + 1e-5 * fabs( best[i] ) );
+		slab.GrowPos = slab.GrowPos * 1.0001f + Vector3f( 1e-5f );
+		slab.GrowNeg = slab.GrowNeg * 1.0001f + Vector3f( 1e-5f );
+	}
+	return true;
+}
+
+// Returns false if a ray that starts at p and moves by deltaPos - deltaNeg cannot hit
+// anything inside the bounds.
+bool ModelCollision::TestCullBounds( const ovrCullBounds & bounds, const Vector3f & p,
+		const Vector3f & deltaPos, const Vector3f & deltaNeg )
+{
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		const ovrCullSlab & plus = bounds.Slabs[axis * 2 + 0];
+		if ( p[axis] > plus.Bound + plus.GrowPos.Dot( deltaPos ) + plus.GrowNeg.Dot( deltaNeg ) )
+		{
+			return false;
+		}
+		const ovrCullSlab & minus = bounds.Slabs[axis * 2 + 1];
+		if ( -p[axis] > minus.Bound + minus.GrowPos.Dot( deltaPos ) + minus.GrowNeg.Dot( deltaNeg ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //	ModelCollision
 //-----------------------------------------------------------------------------
 
-bool ModelCollision::TestPoint( const Vector3f & p ) const
+// Orders polytope indices by the center of their cull bounds along one axis.
+class ovrPolytopeCenterLess
+{
+public:
+	ovrPolytopeCenterLess( const Array< Vector3f > & centers, const int axis ) :
+		Centers( centers ),
+		Axis( axis )
+	{
+	}
+
+	bool operator()( const int a, const int b ) const
+	{
+		return Centers[a][Axis] < Centers[b][Axis];
+	}
+
+private:
+	const Array< Vector3f > &	Centers;
+	int							Axis;
+};
+
+ModelCollision::ModelCollision() :
+	TreePolytopes( -1 )
 {
+}
+
+void ModelCollision::BuildTree()
+{
+	Nodes.Clear();
+	LeafPolytopes.Clear();
+	UnboundedPolytopes.Clear();
+	PlaneBlocks.Clear();
+	PolytopeInfo.Resize( Polytopes.GetSizeI() );
+
+	Array< Vector3f > centers;
+	centers.Resize( Polytopes.GetSizeI() );
 	for ( int i = 0; i < Polytopes.GetSizeI(); i++ )
 	{
-		if ( Polytopes[i].TestPoint( p ) )
+		const Array< Planef > & planes = Polytopes[i].Planes;
+		ovrPolytopeInfo & info = PolytopeInfo[i];
+		info.FirstBlock = PlaneBlocks.GetSizeI();
+		info.NumBlocks = ( planes.GetSizeI() + 3 ) / 4;
+		info.MaxNormal = 0.0f;
+		info.MaxDist = 0.0f;
+		for ( int b = 0; b < info.NumBlocks; b++ )
+		{
+			ovrPlanes4 & block = PlaneBlocks.PushDefault();
+			for ( int j = 0; j < 4; j++ )
+			{
+				const int index = b * 4 + j;
+				const Planef plane = ( index < planes.GetSizeI() ) ? planes[index] : Planef( Vector3f( 0.0f ), -1.0f );
+				block.Nx[j] = plane.N.x;
+				block.Ny[j] = plane.N.y;
+				block.Nz[j] = plane.N.z;
+				block.D[j] = plane.D;
+				info.MaxNormal = Alg::Max( info.MaxNormal, fabsf( plane.N.x ) + fabsf( plane.N.y ) + fabsf( plane.N.z ) );
+				info.MaxDist = Alg::Max( info.MaxDist, fabsf( plane.D ) );
+			}
+		}
+
+		info.Bounded = CalculateCullBounds( planes, info.Bounds );
+		if ( !info.Bounded )
+		{
+			UnboundedPolytopes.PushBack( i );
+			continue;
+		}
+		LeafPolytopes.PushBack( i );
+		for ( int axis = 0; axis < 3; axis++ )
+		{
+			centers[i][axis] = 0.5f * ( info.Bounds.Slabs[axis * 2 + 0].Bound - info.Bounds.Slabs[axis * 2 + 1].Bound );
+		}
+	}
+
+	if ( LeafPolytopes.GetSizeI() > 0 )
+	{
+		BuildNode_r( centers, 0, LeafPolytopes.GetSizeI() );
+	}
+	TreePolytopes = Polytopes.GetSizeI();
+}
+
+int ModelCollision::BuildNode_r( const Array< Vector3f > & centers, const int first, const int count )
+{
+	const int nodeIndex = Nodes.GetSizeI();
+	Nodes.PushBack( ovrTreeNode() );
+
+	ovrCullBounds bounds = PolytopeInfo[LeafPolytopes[first]].Bounds;
+	Bounds3f centerBounds( Bounds3f::Init );
+	for ( int i = first; i < first + count; i++ )
+	{
+		const ovrCullBounds & polytopeBounds = PolytopeInfo[LeafPolytopes[i]].Bounds;
+		for ( int j = 0; j < 6; j++ )
+		{
+			ovrCullSlab & slab = bounds.Slabs[j];
+			const ovrCullSlab & polytopeSlab = polytopeBounds.Slabs[j];
+			slab.Bound = Alg::Max( slab.Bound, polytopeSlab.Bound );
+			for ( int k = 0; k < 3; k++ )
+			{
+				slab.GrowPos[k] = Alg::Max( slab.GrowPos[k], polytopeSlab.GrowPos[k] );
+				slab.GrowNeg[k] = Alg::Max( slab.GrowNeg[k], polytopeSlab.GrowNeg[k] );
+			}
+		}
+		centerBounds.AddPoint( centers[LeafPolytopes[i]] );
+	}
+
+	{
+		ovrTreeNode & node = Nodes[nodeIndex];
+		node.Bounds = bounds;
+		node.Left = -1;
+		node.Right = -1;
+		node.First = first;
+		node.Count = count;
+	}
+
+	if ( count <= MAX_LEAF_POLYTOPES )
+	{
+		return nodeIndex;
+	}
+
+	// split at the median along the longest axis of the polytope centers
+	const Vector3f size = centerBounds.GetSize();
+	const int axis = ( size.x >= size.y && size.x >= size.z ) ? 0 : ( ( size.y >= size.z ) ? 1 : 2 );
+	Alg::QuickSortSliced( LeafPolytopes, first, first + count, ovrPolytopeCenterLess( centers, axis ) );
+
+	const int half = count / 2;
+	const int left = BuildNode_r( centers, first, half );
+	const int right = BuildNode_r( centers, first + half, count - half );
+	Nodes[nodeIndex].Left = left;
+	Nodes[nodeIndex].Right = right;
+	Nodes[nodeIndex].Count = 0;
+	return nodeIndex;
+}
+
+int ModelCollision::FindCandidates( const Vector3f & start, const Vector3f & delta, int * candidates ) const
+{
+	int numCandidates = 0;
+	for ( int i = 0; i < UnboundedPolytopes.GetSizeI(); i++ )
+	{
+		if ( numCandidates >= MAX_CANDIDATES )
+		{
+			return -1;
+		}
+		candidates[numCandidates++] = UnboundedPolytopes[i];
+	}
+
+	if ( Nodes.GetSizeI() > 0 )
+	{
+		const Vector3f deltaPos( Alg::Max( delta.x, 0.0f ), Alg::Max( delta.y, 0.0f ), Alg::Max( delta.z, 0.0f ) );
+		const Vector3f deltaNeg( Alg::Max( -delta.x, 0.0f ), Alg::Max( -delta.y, 0.0f ), Alg::Max( -delta.z, 0.0f ) );
+
+		int stack[64];
+		int stackDepth = 0;
+		stack[stackDepth++] = 0;
+		while ( stackDepth > 0 )
+		{
+			const ovrTreeNode & node = Nodes[stack[--stackDepth]];
+			if ( !TestCullBounds( node.Bounds, start, deltaPos, deltaNeg ) )
+			{
+				continue;
+			}
+			if ( node.Count == 0 )
+			{
+				stack[stackDepth++] = node.Right;
+				stack[stackDepth++] = node.Left;
+				continue;
+			}
+			for ( int i = node.First; i < node.First + node.Count; i++ )
+			{
+				const int polytope = LeafPolytopes[i];
+				if ( !TestCullBounds( PolytopeInfo[polytope].Bounds, start, deltaPos, deltaNeg ) )
+				{
+					continue;
+				}
+				if ( numCandidates >= MAX_CANDIDATES )
+				{
+					return -1;
+				}
+				candidates[numCandidates++] = polytope;
+			}
+		}
+	}
+
+	// the polytopes are tested in the same order as without the tree
+	Alg::QuickSortSliced( candidates, 0, numCandidates, Alg::OperatorLess< int >::Compare );
+	return numCandidates;
+}
+
+int ModelCollision::ClassifyPoint( const int polytope, const Vector3f & p ) const
+{
+	const ovrPolytopeInfo & info = PolytopeInfo[polytope];
+	const float magnitude = Alg::Max( fabsf( p.x ), Alg::Max( fabsf( p.y ), fabsf( p.z ) ) );
+	const float tolerance = SIMD_PLANE_TOLERANCE * ( info.MaxNormal * magnitude + info.MaxDist ) + FLT_MIN;
+	const ovrSimd4f px = Simd4fSet( p.x );
+	const ovrSimd4f py = Simd4fSet( p.y );
+	const ovrSimd4f pz = Simd4fSet( p.z );
+	const ovrSimd4f outside = Simd4fSet( tolerance );
+	const ovrSimd4f inside = Simd4fSet( -tolerance );
+	bool certainlyInside = true;
+	for ( int b = info.FirstBlock; b < info.FirstBlock + info.NumBlocks; b++ )
+	{
+		const ovrPlanes4 & block = PlaneBlocks[b];
+		const ovrSimd4f dist = Simd4fAdd( Simd4fAdd( Simd4fAdd(
+				Simd4fMul( Simd4fLoad( block.Nx ), px ),
+				Simd4fMul( Simd4fLoad( block.Ny ), py ) ),
+				Simd4fMul( Simd4fLoad( block.Nz ), pz ) ),
+				Simd4fLoad( block.D ) );
+		if ( Simd4fAnyGreater( dist, outside ) )
+		{
+			return 0;
+		}
+		if ( Simd4fAnyGreater( dist, inside ) )
+		{
+			certainlyInside = false;
+		}
+	}
+	return certainlyInside ? 1 : -1;
+}
+
+bool ModelCollision::MayHitRay( const int polytope, const Vector3f & start, const Vector3f & end ) const
+{
+	const ovrPolytopeInfo & info = PolytopeInfo[polytope];
+	const float magnitude = Alg::Max( Alg::Max( fabsf( start.x ), Alg::Max( fabsf( start.y ), fabsf( start.z ) ) ),
+										Alg::Max( fabsf( end.x ), Alg::Max( fabsf( end.y ), fabsf( end.z ) ) ) );
+	const ovrSimd4f outside = Simd4fSet( SIMD_PLANE_TOLERANCE * ( info.MaxNormal * magnitude + info.MaxDist ) + FLT_MIN );
+	const ovrSimd4f sx = Simd4fSet( start.x );
+	const ovrSimd4f sy = Simd4fSet( start.y );
+	const ovrSimd4f sz = Simd4fSet( start.z );
+	const ovrSimd4f ex = Simd4fSet( end.x );
+	const ovrSimd4f ey = Simd4fSet( end.y );
+	const ovrSimd4f ez = Simd4fSet( end.z );
+	for ( int b = info.FirstBlock; b < info.FirstBlock + info.NumBlocks; b++ )
+	{
+		const ovrPlanes4 & block = PlaneBlocks[b];
+		const ovrSimd4f nx = Simd4fLoad( block.Nx );
+		const ovrSimd4f ny = Simd4fLoad( block.Ny );
+		const ovrSimd4f nz = Simd4fLoad( block.Nz );
+		const ovrSimd4f d = Simd4fLoad( block.D );
+		const ovrSimd4f dist1 = Simd4fAdd( Simd4fAdd( Simd4fAdd( Simd4fMul( nx, sx ), Simd4fMul( ny, sy ) ), Simd4fMul( nz, sz ) ), d );
+		const ovrSimd4f dist2 = Simd4fAdd( Simd4fAdd( Simd4fAdd( Simd4fMul( nx, ex ), Simd4fMul( ny, ey ) ), Simd4fMul( nz, ez ) ), d );
+		// both ends outside the same plane
+		if ( Simd4fAnyGreater( Simd4fMin( dist1, dist2 ), outside ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ModelCollision::TestPoint( const Vector3f & p ) const
+{
+	if ( !HasTree() )
+	{
+		for ( int i = 0; i < Polytopes.GetSizeI(); i++ )
+		{
+			if ( Polytopes[i].TestPoint( p ) )
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	int candidates[MAX_CANDIDATES];
+	const int numCandidates = FindCandidates( p, Vector3f( 0.0f ), candidates );
+	const int count = ( numCandidates >= 0 ) ? numCandidates : Polytopes.GetSizeI();
+	for ( int c = 0; c < count; c++ )
+	{
+		const int i = ( numCandidates >= 0 ) ? candidates[c] : c;
+		const int side = ClassifyPoint( i, p );
+		if ( side > 0 || ( side < 0 && Polytopes[i].TestPoint( p ) ) )
 		{
 			return true;
 		}
@@ -134,9 +604,27 @@ bool ModelCollision::TestPoint( const Vector3f & p ) const
 
 bool ModelCollision::TestRay( const Vector3f & start, const Vector3f & dir, float & length, Planef * plane ) const
 {
+	const bool hasTree = HasTree();
+	int candidates[MAX_CANDIDATES];
+	const int numCandidates = hasTree ? FindCandidates( start, dir * length, candidates ) : -1;
+	const int count = ( numCandidates >= 0 ) ? numCandidates : Polytopes.GetSizeI();
+
 	bool clipped = false;
-	for ( int i = 0; i < Polytopes.GetSizeI(); i++ )
+	for ( int c = 0; c < count; c++ )
 	{
+		const int i = ( numCandidates >= 0 ) ? candidates[c] : c;
+		if ( hasTree )
+		{
+			// the length may have been clipped since the candidates were found
+			const Vector3f delta = dir * length;
+			const Vector3f deltaPos( Alg::Max( delta.x, 0.0f ), Alg::Max( delta.y, 0.0f ), Alg::Max( delta.z, 0.0f ) );
+			const Vector3f deltaNeg( Alg::Max( -delta.x, 0.0f ), Alg::Max( -delta.y, 0.0f ), Alg::Max( -delta.z, 0.0f ) );
+			if ( ( PolytopeInfo[i].Bounded && !TestCullBounds( PolytopeInfo[i].Bounds, start, deltaPos, deltaNeg ) ) ||
+					!MayHitRay( i, start, start + delta ) )
+			{
+				continue;
+			}
+		}
 		Planef clipPlane;
 		float clipLength = length;
 		if ( Polytopes[i].TestRay( start, dir, clipLength, &clipPlane ) )
@@ -157,8 +645,17 @@ bool ModelCollision::TestRay( const Vector3f & start, const Vector3f & dir, floa
 
 bool ModelCollision::PopOut( Vector3f & p ) const
 {
-	for ( int i = 0; i < Polytopes.GetSizeI(); i++ )
+	const bool hasTree = HasTree();
+	int candidates[MAX_CANDIDATES];
+	const int numCandidates = hasTree ? FindCandidates( p, Vector3f( 0.0f ), candidates ) : -1;
+	const int count = ( numCandidates >= 0 ) ? numCandidates : Polytopes.GetSizeI();
+	for ( int c = 0; c < count; c++ )
 	{
+		const int i = ( numCandidates >= 0 ) ? candidates[c] : c;
+		if ( hasTree && ClassifyPoint( i, p ) == 0 )
+		{
+			continue;
+		}
 		if ( Polytopes[i].PopOut( p ) )
 		{
 			return true;
@@ -231,4 +728,19 @@ Vector3f SlideMove(
 	return eyePos - UpVector * eyeHeight;
 }
 
+void SlideMoves(
+		SlideMover * movers,
+		const int numMovers,
+		const ModelCollision & collisionModel,
+		const ModelCollision & groundCollisionModel
+		)
+{
+	for ( int i = 0; i < numMovers; i++ )
+	{
+		SlideMover & mover = movers[i];
+		mover.FootPos = SlideMove( mover.FootPos, mover.EyeHeight, mover.MoveDirection, mover.MoveDistance,
+								collisionModel, groundCollisionModel );
+	}
+}
+
 }	// namespace OVR
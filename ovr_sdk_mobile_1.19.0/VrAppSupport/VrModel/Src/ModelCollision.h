@@ -43,6 +43,14 @@ public:
 class ModelCollision
 {
 public:
+			ModelCollision();
+
+	// Builds a bounding volume hierarchy over the polytopes and stores their planes four
+	// at a time for SIMD plane tests. Queries test every polytope until this is called,
+	// and again when the number of polytopes changes. Call it again after changing planes.
+	// The results are the same with and without the hierarchy.
+	void	BuildTree();
+
 	// Returns true if the given point is inside solid.
 	bool	TestPoint( const Vector3f & p ) const;
 
@@ -56,6 +64,83 @@ public:
 
 public:
 	Array< CollisionPolytope > Polytopes;
+
+private:
+	static const int MAX_LEAF_POLYTOPES = 4;
+	static const int MAX_CANDIDATES = 1024;
+
+	// Upper bound on the coordinate of the start of a ray that can hit a polytope along one
+	// of +X, -X, +Y, -Y, +Z, -Z. The bound grows with the positive and negative parts of the
+	// ray, so a point is the case of a ray with zero length.
+	struct ovrCullSlab
+	{
+		float		Bound;
+		Vector3f	GrowPos;
+		Vector3f	GrowNeg;
+	};
+
+	struct ovrCullBounds
+	{
+		ovrCullSlab	Slabs[6];
+	};
+
+	struct ovrTreeNode
+	{
+		ovrCullBounds	Bounds;
+		int				Left;	// child nodes, -1 for leaves
+		int				Right;
+		int				First;	// first index into LeafPolytopes for leaves
+		int				Count;	// number of polytopes for leaves, 0 for interior nodes
+	};
+
+	// Four planes, unused planes are 0x + 0y + 0z - 1 <= 0.
+	struct ovrPlanes4
+	{
+		float	Nx[4];
+		float	Ny[4];
+		float	Nz[4];
+		float	D[4];
+	};
+
+	struct ovrPolytopeInfo
+	{
+		int				FirstBlock;	// into PlaneBlocks
+		int				NumBlocks;
+		float			MaxNormal;	// largest sum of the absolute normal components
+		float			MaxDist;	// largest absolute plane distance
+		bool			Bounded;	// false for polytopes in UnboundedPolytopes
+		ovrCullBounds	Bounds;
+	};
+
+	int							TreePolytopes;		// number of polytopes when the tree was built, -1 for none
+	Array< ovrTreeNode >		Nodes;
+	Array< int >				LeafPolytopes;
+	Array< int >				UnboundedPolytopes;	// tested by every query
+	Array< ovrPolytopeInfo >	PolytopeInfo;
+	Array< ovrPlanes4 >			PlaneBlocks;
+
+	static bool	CalculateCullBounds( const Array< Planef > & planes, ovrCullBounds & bounds );
+	static bool	TestCullBounds( const ovrCullBounds & bounds, const Vector3f & p,
+						const Vector3f & deltaPos, const Vector3f & deltaNeg );
+
+	bool	HasTree() const { return TreePolytopes >= 0 && TreePolytopes == Polytopes.GetSizeI(); }
+	int		BuildNode_r( const Array< Vector3f > & centers, const int first, const int count );
+	// Returns the polytopes a ray from start along delta may hit, in ascending order, or -1
+	// if there are too many.
+	int		FindCandidates( const Vector3f & start, const Vector3f & delta, int * candidates ) const;
+	// Returns 1 if the point is inside, 0 if it is outside and -1 if the planes have to be tested.
+	int		ClassifyPoint( const int polytope, const Vector3f & p ) const;
+	// Returns false if the ray from start to end certainly misses the polytope.
+	bool	MayHitRay( const int polytope, const Vector3f & start, const Vector3f & end ) const;
+};
+
+// A mover for SlideMoves. FootPos is updated by the move.
+struct SlideMover
+{
+	Vector3f	FootPos;
+	float		EyeHeight;
+	Vector3f	MoveDirection;
+	float		MoveDistance;
 };
 
 Vector3f SlideMove(
@@ -67,6 +152,14 @@ Vector3f SlideMove(
 		const ModelCollision & groundCollisionModel
 	    );
 
+// Same as calling SlideMove for each of the movers.
+void SlideMoves(
+		SlideMover * movers,
+		const int numMovers,
+		const ModelCollision & collisionModel,
+		const ModelCollision & groundCollisionModel
+		);
+
 }	// namespace OVR
 
 #endif	// MODELCOLLISION_H
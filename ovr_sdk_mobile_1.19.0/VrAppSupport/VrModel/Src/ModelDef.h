@@ -14,6 +14,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "Kernel/OVR_System.h"	// Array
 #include "Kernel/OVR_String.h"	// String
+#include "Kernel/OVR_Atom.h"	// ovrAtom
 #include "GlProgram.h"			// GlProgram
 #include "GlTexture.h"
 #include "ModelCollision.h"
@@ -329,7 +330,7 @@ public:
 	void							SetLocalTransform( const Matrix4f matrix );
 	void							RecalculateGlobalTransform( ModelFile & modelFile );
 
-	String							name;
+	ovrAtom							name;
 	String							jointName;
 	Quatf							rotation;
 	Vector3f						translation;
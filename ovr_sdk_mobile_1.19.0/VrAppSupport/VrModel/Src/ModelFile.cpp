@@ -55,12 +55,18 @@ ModelFile::~ModelFile()
 
 ovrSurfaceDef * ModelFile::FindNamedSurface( const char * name ) const
 {
+	// surface names are interned, so if the name was never interned no surface can have it
+	ovrAtom noCaseName;
+	if ( !ovrAtom::FindNoCase( name, noCaseName ) )
+	{
+		return nullptr;
+	}
 	for ( int i = 0; i < Models.GetSizeI(); i++ )
 	{
 		for ( int j = 0; j < Models[i].surfaces.GetSizeI(); j++ )
 		{
 			const ovrSurfaceDef & sd = Models[i].surfaces[j].surfaceDef;
-			if ( sd.surfaceName.CompareNoCase( name ) == 0 )
+			if ( sd.surfaceName.GetNoCase() == noCaseName )
 			{
 				return const_cast< ovrSurfaceDef* >( &sd );
 			}
@@ -228,14 +228,16 @@ bool LoadModelFile_OvrScene_Json( ModelFile & modelFile,
 						const JsonReader source( surface.GetChildByName( "source" ) );
 						if ( source.IsArray() )
 						{
+							String surfaceName;
 							while ( !source.IsEndOfArray() )
 							{
-								if ( modelSurface.surfaceDef.surfaceName.GetLength() )
+								if ( surfaceName.GetLength() )
 								{
-									modelSurface.surfaceDef.surfaceName += ";";
+									surfaceName += ";";
 								}
-								modelSurface.surfaceDef.surfaceName += source.GetNextArrayString();
+								surfaceName += source.GetNextArrayString();
 							}
+							modelSurface.surfaceDef.surfaceName = surfaceName;
 						}
 
 						LOGV( "surface %s", modelSurface.surfaceDef.surfaceName.ToCStr() );
@@ -574,6 +576,9 @@ bool LoadModelFile_OvrScene_Json( ModelFile & modelFile,
 			}
 		}
 
+		modelFile.Collisions.BuildTree();
+		modelFile.GroundCollisions.BuildTree();
+
 		//
 		// Ray-Trace Model
 		//
@@ -549,10 +549,10 @@ bool LoadModelFile_glTF_Json( ModelFile & modelFile, const char * modelsJson,
 							modelFile.Materials.PushBack( newGltfMaterial );
 						}
 					}
-					// Add a default material at the end of the list for primitives with an unspecified material.
-					ModelMaterial defaultmaterial;
-					modelFile.Materials.PushBack( defaultmaterial );
 				}
+				// Add a default material at the end of the list for primitives with an unspecified material.
+				ModelMaterial defaultmaterial;
+				modelFile.Materials.PushBack( defaultmaterial );
 			} // END MATERIALS
 
 			if ( loaded )
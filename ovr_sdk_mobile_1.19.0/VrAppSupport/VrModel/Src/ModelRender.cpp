@@ -134,7 +134,7 @@ struct bsort_t
 {
 	float						key;
 	Matrix4f					modelMatrix;
-	const Array< Matrix4f > *	joints;
+	const GlBuffer *			joints;
 	const ovrSurfaceDef *		surface;
 	bool						transparent;
 
@@ -163,11 +163,361 @@ struct bsort_t
 	};
 };
 
+//==============================================================
+// ovrSkinPaletteCache
+
+// Palettes that are not drawn for this many frames are returned to the free list.
+static const int MAX_UNUSED_PALETTE_FRAMES = 90;
+
+class ovrSkinPaletteCache::ovrWorker
+{
+public:
+	ovrWorker( ovrSkinPaletteCache * cache, const int generation )
+		: Cache( cache )
+		, Generation( generation )
+		, MyThread( NULL )
+	{
+	}
+
+	ovrSkinPaletteCache *	Cache;
+	int						Generation;		// last generation of work this worker took part in
+	Thread *				MyThread;
+};
+
+ovrSkinPaletteCache::ovrSkinPaletteCache( const int maxWorkers, const int minPalettesPerWorker )
+	: FrameNum( 0 )
+	, MaxWorkers( maxWorkers )
+	, MinPalettesPerWorker( Alg::Max( minPalettesPerWorker, 1 ) )
+	, WorkGeneration( 0 )
+	, NumBusyWorkers( 0 )
+	, ExitWorkers( false )
+	, NextPending( 0 )
+	, NumCalculated( 0 )
+	, NumUploaded( 0 )
+{
+}
+
+ovrSkinPaletteCache::~ovrSkinPaletteCache()
+{
+	Clear();
+}
+
+void ovrSkinPaletteCache::Clear()
+{
+	StopWorkers();
+
+	for ( Hash< ovrPaletteKey, ovrPalette * >::Iterator it = Palettes.Begin(); it != Palettes.End(); ++it )
+	{
+		FreePalettes.PushBack( it->Second );
+	}
+	Palettes.Clear();
+	Pending.Clear();
+
+	for ( int i = 0; i < FreePalettes.GetSizeI(); i++ )
+	{
+		FreePalettes[i]->Buffer.Destroy();
+		delete FreePalettes[i];
+	}
+	FreePalettes.Clear();
+}
+
+void ovrSkinPaletteCache::BeginFrame()
+{
+	FrameNum++;
+	Pending.Clear();
+
+	const int firstFree = FreePalettes.GetSizeI();
+	for ( Hash< ovrPaletteKey, ovrPalette * >::Iterator it = Palettes.Begin(); it != Palettes.End(); ++it )
+	{
+		if ( FrameNum - it->Second->LastFrame > MAX_UNUSED_PALETTE_FRAMES )
+		{
+			FreePalettes.PushBack( it->Second );
+		}
+	}
+	for ( int i = firstFree; i < FreePalettes.GetSizeI(); i++ )
+	{
+		Palettes.Remove( FreePalettes[i]->Key );
+		FreePalettes[i]->NodeState = NULL;
+	}
+}
+
+const GlBuffer * ovrSkinPaletteCache::Request( const ModelNodeState & nodeState )
+{
+	const ModelNode * node = nodeState.GetNode();
+
+	ovrPaletteKey key;
+	if ( nodeState.JointMatricesOvrScene.GetSize() > 0 )
+	{
+		key.Owner = &nodeState;
+		key.SkinIndex = -1;
+		key.RootIndex = -1;
+	}
+	else if ( node->skinIndex >= 0 )
+	{
+		const ModelSkin & skin = nodeState.state->mf->Skins[node->skinIndex];
+		key.Owner = nodeState.state;
+		key.SkinIndex = node->skinIndex;
+		key.RootIndex = ( skin.skeletonRootIndex >= 0 ) ? skin.skeletonRootIndex : node->parentIndex;
+	}
+	else
+	{
+		return NULL;
+	}
+
+	ovrPalette * palette = NULL;
+	if ( !Palettes.Get( key, &palette ) )
+	{
+		if ( FreePalettes.GetSizeI() > 0 )
+		{
+			palette = FreePalettes.Pop();
+		}
+		else
+		{
+			palette = new ovrPalette();
+			palette->Buffer.Create( GLBUFFER_TYPE_UNIFORM, sizeof( palette->Joints ), NULL );
+		}
+		// The buffer holds NumJoints matrices, so this makes sure the new palette is uploaded.
+		palette->NumJoints = 0;
+		palette->LastFrame = 0;
+		palette->Key = key;
+		Palettes.Set( key, palette );
+	}
+
+	if ( palette->LastFrame != FrameNum )
+	{
+		palette->LastFrame = FrameNum;
+		palette->NodeState = &nodeState;
+		Pending.PushBack( palette );
+	}
+	return &palette->Buffer;
+}
+
+void ovrSkinPaletteCache::Update()
+{
+	NumCalculated = Pending.GetSizeI();
+	NumUploaded = 0;
+	if ( Pending.GetSizeI() == 0 )
+	{
+		return;
+	}
+
+	CalculatePending();
+
+	for ( int i = 0; i < Pending.GetSizeI(); i++ )
+	{
+		const ovrPalette & palette = *Pending[i];
+		if ( palette.Changed )
+		{
+			palette.Buffer.Update( palette.NumJoints * sizeof( Matrix4f ), &palette.Joints[0] );
+			NumUploaded++;
+		}
+	}
+}
+
+int ovrSkinPaletteCache::CalculatePalette( const ModelNodeState & nodeState, Matrix4f * joints )
+{
+	if ( nodeState.JointMatricesOvrScene.GetSize() > 0 )
+	{
+		const int numJoints = Alg::Min( nodeState.JointMatricesOvrScene.GetSizeI(), MAX_JOINTS );
+		for ( int j = 0; j < numJoints; j++ )
+		{
+			joints[j] = nodeState.JointMatricesOvrScene[j].Transposed();
+		}
+		return numJoints;
+	}
+
+	const ModelNode * node = nodeState.GetNode();
+	if ( node->skinIndex < 0 )
+	{
+		return 0;
+	}
+
+	const ModelState & state = *nodeState.state;
+	const ModelSkin & skin = state.mf->Skins[node->skinIndex];
+	const int numJoints = Alg::Min( skin.jointIndexes.GetSizeI(), MAX_JOINTS );
+
+	Matrix4f inverseGlobalSkeletonTransform;
+	if ( skin.skeletonRootIndex >= 0 )
+	{
+		inverseGlobalSkeletonTransform = state.nodeStates[skin.skeletonRootIndex].GetGlobalTransform().Inverted();
+	}
+	else if ( node->parentIndex >= 0 )
+	{
+		inverseGlobalSkeletonTransform = state.nodeStates[node->parentIndex].GetGlobalTransform().Inverted();
+	}
+
+	const bool hasInverseBind = skin.inverseBindMatrices.GetSizeI() > 0;
+	if ( !hasInverseBind )
+	{
+		OVR_WARN( "No inverse bind on modle" );
+	}
+
+	for ( int j = 0; j < numJoints; j++ )
+	{
+		const Matrix4f & globalTransform = state.nodeStates[skin.jointIndexes[j]].GetGlobalTransform();
+		Matrix4f tempTransform;
+		Matrix4f::Multiply( &tempTransform, inverseGlobalSkeletonTransform, globalTransform );
+		if ( hasInverseBind )
+		{
+			Matrix4f localJointTransform;
+			Matrix4f::Multiply( &localJointTransform, tempTransform, skin.inverseBindMatrices[j] );
+			joints[j] = localJointTransform.Transposed();
+		}
+		else
+		{
+			joints[j] = tempTransform.Transposed();
+		}
+	}
+	return numJoints;
+}
+
+// Takes palettes from the pending list until there are none left. Called by the workers
+// and by the thread that calls Update().
+void ovrSkinPaletteCache::CalculatePendingPalettes()
+{
+	const int numPending = Pending.GetSizeI();
+	for ( ; ; )
+	{
+		const int index = NextPending.ExchangeAdd_NoSync( 1 );
+		if ( index >= numPending )
+		{
+			break;
+		}
+
+		ovrPalette & palette = *Pending[index];
+		Matrix4f joints[MAX_JOINTS];
+		const int numJoints = CalculatePalette( *palette.NodeState, joints );
+		palette.Changed = ( numJoints != palette.NumJoints ) || memcmp( joints, palette.Joints, numJoints * sizeof( Matrix4f ) ) != 0;
+		if ( palette.Changed )
+		{
+			memcpy( palette.Joints, joints, numJoints * sizeof( Matrix4f ) );
+			palette.NumJoints = numJoints;
+		}
+	}
+}
+
+void ovrSkinPaletteCache::CalculatePending()
+{
+	const int numWorkers = Alg::Min( MaxWorkers, Pending.GetSizeI() / MinPalettesPerWorker - 1 );
+
+	NextPending.Store_Release( 0 );
+
+	if ( numWorkers <= 0 )
+	{
+		CalculatePendingPalettes();
+		return;
+	}
+
+	if ( Workers.GetSizeI() < numWorkers )
+	{
+		StartWorkers( numWorkers );
+	}
+
+	{
+		Mutex::Locker locker( &WorkMutex );
+		WorkGeneration++;
+		NumBusyWorkers = Workers.GetSizeI();
+		WorkCondition.NotifyAll();
+	}
+
+	CalculatePendingPalettes();
+
+	{
+		Mutex::Locker locker( &WorkMutex );
+		while ( NumBusyWorkers > 0 )
+		{
+			DoneCondition.Wait( &WorkMutex );
+		}
+	}
+}
+
+threadReturn_t ovrSkinPaletteCache::WorkerThreadFn( Thread * thread, void * data )
+{
+	ovrWorker * worker = static_cast< ovrWorker * >( data );
+	ovrSkinPaletteCache * cache = worker->Cache;
+
+	thread->SetThreadName( "SkinPalette" );
+
+	for ( ; ; )
+	{
+		{
+			Mutex::Locker locker( &cache->WorkMutex );
+			while ( cache->WorkGeneration == worker->Generation && !cache->ExitWorkers )
+			{
+				cache->WorkCondition.Wait( &cache->WorkMutex );
+			}
+			if ( cache->ExitWorkers )
+			{
+				break;
+			}
+			worker->Generation = cache->WorkGeneration;
+		}
+
+		cache->CalculatePendingPalettes();
+
+		{
+			Mutex::Locker locker( &cache->WorkMutex );
+			if ( --cache->NumBusyWorkers == 0 )
+			{
+				cache->DoneCondition.Notify();
+			}
+		}
+	}
+
+	return (threadReturn_t)0;
+}
+
+void ovrSkinPaletteCache::StartWorkers( const int numWorkers )
+{
+	size_t const stackSize = 128 * 1024;
+	int const processorAffinity = -1;
+
+	while ( Workers.GetSizeI() < numWorkers )
+	{
+		// Workers are only started between generations, so the new worker waits for the next one.
+		ovrWorker * worker = new ovrWorker( this, WorkGeneration );
+		Thread::CreateParams createParams(
+				ovrSkinPaletteCache::WorkerThreadFn,
+				worker,
+				stackSize,
+				processorAffinity,
+				Thread::Running,
+				Thread::NormalPriority );
+		worker->MyThread = new Thread( createParams );
+		Workers.PushBack( worker );
+	}
+}
+
+void ovrSkinPaletteCache::StopWorkers()
+{
+	if ( Workers.GetSizeI() == 0 )
+	{
+		return;
+	}
+
+	{
+		Mutex::Locker locker( &WorkMutex );
+		ExitWorkers = true;
+		WorkCondition.NotifyAll();
+	}
+
+	for ( int i = 0; i < Workers.GetSizeI(); i++ )
+	{
+		Workers[i]->MyThread->Join();
+		delete Workers[i]->MyThread;
+		delete Workers[i];
+	}
+	Workers.Clear();
+
+	ExitWorkers = false;
+}
+
 void BuildModelSurfaceList(	Array<ovrDrawSurface> & surfaceList,
 							const Array<ModelNodeState *> & emitNodes,
 							const Array<ovrDrawSurface> & emitSurfaces,
 							const Matrix4f & viewMatrix,
-							const Matrix4f & projectionMatrix )
+							const Matrix4f & projectionMatrix,
+							ovrSkinPaletteCache * skinPalettes )
 {
 	// A mobile GPU will be in trouble if it draws more than this.
 	static const int MAX_DRAW_SURFACES = 1024;
@@ -178,6 +528,13 @@ void BuildModelSurfaceList(	Array<ovrDrawSurface> & surfaceList,
 	int	numSurfaces = 0;
 	int	cullCount = 0;
 
+	if ( skinPalettes != NULL )
+	{
+		skinPalettes->BeginFrame();
+	}
+	const ModelNodeState * paletteNodeState = NULL;
+	int paletteNumJoints = 0;
+
 	for ( int nodeNum = 0; nodeNum < emitNodes.GetSizeI(); nodeNum++ )
 	{
 		const ModelNodeState & nodeState = *emitNodes[nodeNum];
@@ -222,62 +579,27 @@ void BuildModelSurfaceList(	Array<ovrDrawSurface> & surfaceList,
 						break;
 					}
 
-					// Update the Joint Uniform Buffer
-					if ( nodeState.JointMatricesOvrScene.GetSize() > 0 )
+					const GlBuffer * joints = NULL;
+					if ( skinPalettes != NULL )
 					{
-						static Matrix4f transposedJoints[MAX_JOINTS];
-						const int numJoints = Alg::Min( nodeState.JointMatricesOvrScene.GetSizeI(), MAX_JOINTS );
-
-						for ( int j = 0; j < numJoints; j++ )
-						{
-							transposedJoints[j] = nodeState.JointMatricesOvrScene[j].Transposed();
-						}
-
-						const size_t updateSize = numJoints * sizeof( Matrix4f );
-						surfaceDef.graphicsCommand.uniformJoints.Update( updateSize, &transposedJoints[0] );
+						joints = skinPalettes->Request( nodeState );
 					}
-					else if ( nodeState.node->skinIndex >= 0 )
+					else if ( nodeState.JointMatricesOvrScene.GetSize() > 0 || nodeState.node->skinIndex >= 0 )
 					{
-						const ModelSkin & skin = nodeState.state->mf->Skins[nodeState.node->skinIndex];
-						
+						// Update the Joint Uniform Buffer of the surface, calculating the palette once per node.
 						static Matrix4f transposedJoints[MAX_JOINTS];
-						const int numJoints = Alg::Min( skin.jointIndexes.GetSizeI(), MAX_JOINTS );
-
-						Matrix4f inverseGlobalSkeletonTransform;
-						if ( skin.skeletonRootIndex >= 0 )
-						{
-							inverseGlobalSkeletonTransform = nodeState.state->nodeStates[skin.skeletonRootIndex].GetGlobalTransform().Inverted();
-						}
-						else
+						if ( paletteNodeState != &nodeState )
 						{
-							inverseGlobalSkeletonTransform = nodeState.state->nodeStates[nodeState.node->parentIndex].GetGlobalTransform().Inverted();
+							paletteNumJoints = ovrSkinPaletteCache::CalculatePalette( nodeState, transposedJoints );
+							paletteNodeState = &nodeState;
 						}
-
-						for ( int j = 0; j < numJoints; j++ )
-						{
-							Matrix4f globalTransform  = nodeState.state->nodeStates[skin.jointIndexes[j]].GetGlobalTransform();
-							Matrix4f tempTransform;
-							Matrix4f::Multiply( &tempTransform, inverseGlobalSkeletonTransform, globalTransform );
-							Matrix4f localJointTransform;
-
-							if ( skin.inverseBindMatrices.GetSizeI() > 0 )
-							{
-								Matrix4f::Multiply( &localJointTransform, tempTransform, skin.inverseBindMatrices[j] );
-							}
-							else
-							{
-								OVR_WARN( "No inverse bind on modle" );
-								localJointTransform = tempTransform;
-							}
-
-							transposedJoints[j] = localJointTransform.Transposed();
-						}
-						const size_t updateSize = numJoints * sizeof( Matrix4f );
+						const size_t updateSize = paletteNumJoints * sizeof( Matrix4f );
 						surfaceDef.graphicsCommand.uniformJoints.Update( updateSize, &transposedJoints[0] );
 					}
 
 					bsort[numSurfaces].key = sort;
 					bsort[numSurfaces].modelMatrix = nodeState.GetGlobalTransform();
+					bsort[numSurfaces].joints = joints;
 					bsort[numSurfaces].surface = &surfaceDef;
 					bsort[numSurfaces].transparent = ( surfaceDef.graphicsCommand.GpuState.blendEnable != ovrGpuState::BLEND_DISABLE );
 					numSurfaces++;
@@ -308,6 +630,7 @@ void BuildModelSurfaceList(	Array<ovrDrawSurface> & surfaceList,
 
 		bsort[ numSurfaces ].key = sort;
 		bsort[ numSurfaces ].modelMatrix = drawSurf.modelMatrix;
+		bsort[ numSurfaces ].joints = drawSurf.joints;
 		bsort[ numSurfaces ].surface = &surfaceDef;
 		bsort[ numSurfaces ].transparent = ( surfaceDef.graphicsCommand.GpuState.blendEnable != ovrGpuState::BLEND_DISABLE );
 		numSurfaces++;
@@ -315,6 +638,12 @@ void BuildModelSurfaceList(	Array<ovrDrawSurface> & surfaceList,
 
 	//OVR_LOG( "Culled %i, draw %i", cullCount, numSurfaces );
 
+	// Calculate and upload the palettes of the skins that will be drawn.
+	if ( skinPalettes != NULL )
+	{
+		skinPalettes->Update();
+	}
+
 	// sort by the far W and transparency
 	// IMPORTANT: use a stable sort so surfaces with identical bounds
 	// will sort consistently from frame to frame, rather than randomly
@@ -327,6 +656,7 @@ void BuildModelSurfaceList(	Array<ovrDrawSurface> & surfaceList,
 	{
 		surfaceList[i].modelMatrix = bsort[i].modelMatrix;
 		surfaceList[i].surface = bsort[i].surface;
+		surfaceList[i].joints = bsort[i].joints;
 	}
 }
 
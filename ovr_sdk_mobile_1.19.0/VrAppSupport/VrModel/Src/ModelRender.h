@@ -14,6 +14,9 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Kernel/OVR_Math.h"
 #include "Kernel/OVR_Array.h"
 #include "Kernel/OVR_String.h"
+#include "Kernel/OVR_Hash.h"
+#include "Kernel/OVR_Threads.h"
+#include "Kernel/OVR_Atomic.h"
 
 #include "OVR_GlUtils.h"
 #include "SurfaceRender.h"
@@ -21,15 +24,121 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 namespace OVR
 {
+
+//==============================================================
+// ovrSkinPaletteCache
+// Joint matrices for the skinned nodes that are drawn in a frame. A palette is calculated
+// once per frame for each skin of each model state, no matter how many surfaces use it, and
+// it is kept transposed in the layout of the joint uniform buffer, which is uploaded only if
+// the palette changed since the last frame it was drawn.
+// Palettes that were not drawn for a while are freed. Requires an active GL context.
+class ovrSkinPaletteCache
+{
+public:
+	// Palettes are calculated on up to maxWorkers threads in addition to the calling thread
+	// once more than minPalettesPerWorker palettes per thread are requested in a frame.
+	static const int	DEFAULT_MAX_WORKERS = 2;
+	static const int	DEFAULT_MIN_PALETTES_PER_WORKER = 8;
+
+							ovrSkinPaletteCache( const int maxWorkers = DEFAULT_MAX_WORKERS,
+												 const int minPalettesPerWorker = DEFAULT_MIN_PALETTES_PER_WORKER );
+							~ovrSkinPaletteCache();
+
+	// Frees all palettes and stops the worker threads.
+	void					Clear();
+
+	// Starts a new frame. Returns palettes from the last frame to the free list if they were
+	// not requested for a while.
+	void					BeginFrame();
+	// Returns the joint buffer for a skinned node, or NULL if the node is not skinned.
+	// The buffer holds the node's palette after the next call to Update().
+	const GlBuffer *		Request( const ModelNodeState & nodeState );
+	// Calculates and uploads every palette that was requested since BeginFrame().
+	void					Update();
+
+	int						GetNumPalettes() const { return Palettes.GetSizeI(); }
+	// Number of palettes that were calculated and uploaded by the last Update().
+	int						GetNumCalculated() const { return NumCalculated; }
+	int						GetNumUploaded() const { return NumUploaded; }
+
+	// Calculates the transposed joint matrices of a skinned node into joints, which must hold
+	// MAX_JOINTS matrices, and returns the number of joints.
+	static int				CalculatePalette( const ModelNodeState & nodeState, Matrix4f * joints );
+
+private:
+	// A palette only depends on the joints of the skin and on the skeleton root. For skins
+	// without a root, that is the parent of the skinned node. ovrscene nodes own their joints.
+	struct ovrPaletteKey
+	{
+		const void *	Owner;
+		int				SkinIndex;
+		int				RootIndex;
+
+		bool operator == ( const ovrPaletteKey & other ) const
+		{
+			return Owner == other.Owner && SkinIndex == other.SkinIndex && RootIndex == other.RootIndex;
+		}
+	};
+
+	struct ovrPalette
+	{
+		ovrPalette() : NodeState( NULL ), LastFrame( 0 ), NumJoints( 0 ), Changed( false ) {}
+
+		Matrix4f				Joints[MAX_JOINTS];	// transposed, as uploaded
+		GlBuffer				Buffer;
+		ovrPaletteKey			Key;
+		const ModelNodeState *	NodeState;			// any node that uses the palette this frame
+		long long				LastFrame;
+		int						NumJoints;
+		bool					Changed;
+	};
+
+	class ovrWorker;
+
+	Hash< ovrPaletteKey, ovrPalette * >	Palettes;
+	Array< ovrPalette * >	FreePalettes;
+	Array< ovrPalette * >	Pending;		// requested since BeginFrame()
+	long long				FrameNum;
+
+	// Fork / join state for the workers.
+	Array< ovrWorker * >	Workers;
+	int						MaxWorkers;
+	int						MinPalettesPerWorker;
+	Mutex					WorkMutex;
+	WaitCondition			WorkCondition;
+	WaitCondition			DoneCondition;
+	int						WorkGeneration;
+	int						NumBusyWorkers;
+	bool					ExitWorkers;
+	AtomicInt< int >		NextPending;
+
+	int						NumCalculated;
+	int						NumUploaded;
+
+	void					CalculatePending();
+	void					CalculatePendingPalettes();
+	void					StartWorkers( const int numWorkers );
+	void					StopWorkers();
+	static threadReturn_t	WorkerThreadFn( Thread * thread, void * data );
+
+	// not copyable
+							ovrSkinPaletteCache( const ovrSkinPaletteCache & );
+	ovrSkinPaletteCache &	operator = ( const ovrSkinPaletteCache & );
+};
+
 // The model surfaces are culled and added to the sorted surface list.
 // Application specific surfaces from the emit list are also added to the sorted surface list.
 // The surface list is sorted such that opaque surfaces come first, sorted front-to-back,
 // and transparent surfaces come last, sorted back-to-front.
+// If skinPalettes is not NULL, the joints of the draw surfaces refer to palettes in it, which
+// are updated once per skin. Otherwise the joint buffer of each skinned surface is updated,
+// which only works if no other model state draws the same surfaces.
 void BuildModelSurfaceList(	Array<ovrDrawSurface> & surfaceList,
 							const Array<ModelNodeState *> & emitNodes,
 							const Array<ovrDrawSurface> & emitSurfaces,
 							const Matrix4f & viewMatrix,
-							const Matrix4f & projectionMatrix );
+							const Matrix4f & projectionMatrix,
+							ovrSkinPaletteCache * skinPalettes = NULL );
 
 } // namespace OVR
 
@@ -42,7 +42,7 @@ bool ModelTrace::Validate( const bool fullVerify ) const
 	invalid |= header.numNodes != nodes.GetSizeI();
 	invalid |= header.numLeafs != leafs.GetSizeI();
 	invalid |= header.numOverflow != overflow.GetSizeI();
-	if ( !invalid )
+	if ( invalid )
 	{
 		OVR_LOG( "ModelTrace::Verify - invalid header" );
 		return false;
@@ -780,7 +780,7 @@ void OvrSceneView::GenerateFrameSurfaceList( const ovrFrameMatrices & frameMatri
 		}
 	}
 
-	BuildModelSurfaceList( surfaceList, emitNodes, EmitSurfaces, centerEyeCullViewMatrix, symmetricEyeProjectionMatrix );
+	BuildModelSurfaceList( surfaceList, emitNodes, EmitSurfaces, centerEyeCullViewMatrix, symmetricEyeProjectionMatrix, &SkinPalettes );
 }
 
 void OvrSceneView::SetFootPos( const Vector3f & pos, bool updateCenterEye /*= true*/ )
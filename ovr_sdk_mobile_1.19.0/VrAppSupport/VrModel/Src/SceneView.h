@@ -13,6 +13,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #define SCENEVIEW_H
 
 #include "ModelFile.h"
+#include "ModelRender.h"
 #include "App.h"		// ovrFrameResult
 #include "OVR_Input.h"	// ovrFrameInput, etc
 
@@ -149,6 +150,9 @@ private:
 	// Externally generated surfaces
 	Array<ovrDrawSurface>	EmitSurfaces;
 
+	// Joint matrices of the skinned models, updated by GenerateFrameSurfaceList().
+	mutable ovrSkinPaletteCache	SkinPalettes;
+
 	GlProgram				ProgVertexColor;
 	GlProgram				ProgSingleTexture;
 	GlProgram				ProgLightMapped;
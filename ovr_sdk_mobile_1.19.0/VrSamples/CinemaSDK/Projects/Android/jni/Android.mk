@@ -13,6 +13,7 @@ LOCAL_SRC_FILES	:= 	../../../Src/CinemaApp.cpp \
 					../../../Src/ShaderManager.cpp \
 					../../../Src/ModelManager.cpp \
 					../../../Src/MovieManager.cpp \
+					../../../Src/PosterLoader.cpp \
 					../../../Src/MoviePlayerView.cpp \
 					../../../Src/MovieSelectionView.cpp \
 					../../../Src/TheaterSelectionView.cpp \
@@ -28,11 +28,12 @@ class CarouselItem
 public:
 	String		Name;
 	GLuint		Texture;
+	Vector4f	TextureUVs;		// part of Texture to show, in UV space
 	int			TextureWidth;
 	int			TextureHeight;
 	void *		UserData;
 
-				CarouselItem() : Texture( 0 ), TextureWidth( 0 ), TextureHeight( 0 ), UserData( NULL ) {}
+				CarouselItem() : Texture( 0 ), TextureUVs( 0.0f, 0.0f, 1.0f, 1.0f ), TextureWidth( 0 ), TextureHeight( 0 ), UserData( NULL ) {}
 };
 
 class PanelPose
@@ -68,6 +69,8 @@ public:
 	void							SetPanelPoses( OvrVRMenuMgr & menuMgr, VRMenuObject * self, const Array<PanelPose> &panelPoses );
 	void 							SetMenuObjects( const Array<VRMenuObject *> &menuObjs, const Array<CarouselItemComponent *> &menuComps );
 	void							SetItems( const Array<CarouselItem *> &items );
+	// Call after changing the contents of items so the panels show them.
+	void							RefreshPanels() { PanelsNeedUpdate = true; }
 	void							SetSelectionIndex( const int selectedIndex );
     int 							GetSelection() const;
 	bool							HasSelection() const;
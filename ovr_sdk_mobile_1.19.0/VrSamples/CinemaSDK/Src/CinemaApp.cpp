@@ -462,6 +462,9 @@ ovrFrameResult CinemaApp::Frame( const ovrFrameInput & vrFrame )
 		OVR_LOG( "Headset unmounted" );
 	}
 
+	// Hand the posters that finished loading to the views before they update.
+	MovieMgr.Frame();
+
 	// The View handles setting the FrameResult and Parms.
 	ViewMgr.Frame( vrFrame );
 
@@ -33,6 +33,16 @@ namespace OculusCinema {
 const int MovieManager::PosterWidth = 228;
 const int MovieManager::PosterHeight = 344;
 
+// Uploading a poster and rebuilding the mips of its atlas page is cheap, but a whole
+// library at once is not, so uploads are spread over a few frames.
+static const int MAX_POSTER_UPLOADS_PER_FRAME = 8;
+
+enum PosterSource
+{
+	POSTER_SOURCE_FILE,			// <movie>.png, or the cached copy for external sdcards
+	POSTER_SOURCE_THUMBNAIL		// created from the video
+};
+
 static const char * searchDirs[] =
 {
 	"DCIM",
@@ -61,7 +71,12 @@ const char *MovieManager::SupportedFormats[] =
 
 MovieManager::MovieManager( CinemaApp &cinema ) :
     Movies(),
-	Cinema( cinema )
+	Cinema( cinema ),
+	Loader(),
+	DefaultPoster( 0 ),
+	DefaultPosterUVs( 0.0f, 0.0f, 1.0f, 1.0f ),
+	PosterVersion( 0 ),
+	ThumbnailQueue()
 {
 }
 
@@ -77,6 +92,16 @@ void MovieManager::OneTimeInit( const char * launchIntent )
 
 	const double start =  SystemClock::GetTimeInSeconds();
 
+	Loader.Init( PosterWidth, PosterHeight );
+
+	// every movie shows the default poster until its own has been loaded
+	MemBufferFile defaultPosterFile( MemBufferFile::NoInit );
+	if ( !ovr_ReadFileFromApplicationPackage( "assets/default_poster.png", defaultPosterFile ) ||
+		!Loader.LoadPosterNow( static_cast< const uint8_t * >( defaultPosterFile.Buffer ), defaultPosterFile.Length, DefaultPoster, DefaultPosterUVs ) )
+	{
+		OVR_LOG( "MovieManager::OneTimeInit: failed to load default poster" );
+	}
+
 	LoadMovies();
 
 	OVR_LOG( "MovieManager::OneTimeInit: %i movies loaded, %3.1f seconds", Movies.GetSizeI(), SystemClock::GetTimeInSeconds() - start );
@@ -85,6 +110,40 @@ void MovieManager::OneTimeInit( const char * launchIntent )
 void MovieManager::OneTimeShutdown()
 {
 	OVR_LOG( "MovieManager::OneTimeShutdown" );
+
+	Loader.Shutdown();
+	ThumbnailQueue.Clear();
+}
+
+void MovieManager::Frame()
+{
+	Array<PosterLoader::Result> results;
+	Loader.Update( results, MAX_POSTER_UPLOADS_PER_FRAME );
+
+	for ( int i = 0; i < results.GetSizeI(); i++ )
+	{
+		MovieDef * movie = static_cast<MovieDef *>( results[ i ].UserData );
+		if ( results[ i ].Loaded )
+		{
+			movie->Poster = results[ i ].Texture;
+			movie->PosterUVs = results[ i ].UVs;
+			PosterVersion++;
+		}
+		else if ( results[ i ].Tag == POSTER_SOURCE_FILE )
+		{
+			ThumbnailQueue.PushBack( movie );
+		}
+		// if a created thumbnail can't be loaded either, the movie keeps the default poster
+	}
+
+	// Thumbnails are created through JNI, which has to happen on this thread. Create one per
+	// frame, and only once the posters that already exist are done, so they show up first.
+	if ( ThumbnailQueue.GetSizeI() > 0 && Loader.GetNumPending() == 0 )
+	{
+		MovieDef * movie = ThumbnailQueue[ 0 ];
+		ThumbnailQueue.RemoveAt( 0 );
+		CreateThumbnail( movie );
+	}
 }
 
 void MovieManager::LoadMovies()
@@ -130,7 +189,7 @@ void MovieManager::LoadMovies()
 		LoadPoster( movie );
 	}
 
-	OVR_LOG( "%i movies panels loaded, %3.1f seconds", Movies.GetSizeI(),  SystemClock::GetTimeInSeconds() - start );
+	OVR_LOG( "%i movies panels loaded, %i posters queued, %3.1f seconds", Movies.GetSizeI(), Loader.GetNumPending(), SystemClock::GetTimeInSeconds() - start );
 }
 
 MovieFormat MovieManager::FormatFromString( const String & formatString ) const
@@ -227,40 +286,41 @@ void MovieManager::ReadMetaData( MovieDef *movie )
 
 void MovieManager::LoadPoster( MovieDef *movie )
 {
+	movie->Poster = DefaultPoster;
+	movie->PosterUVs = DefaultPosterUVs;
+	movie->PosterWidth = PosterWidth;
+	movie->PosterHeight = PosterHeight;
+
 	String posterFilename = movie->Filename;
 	posterFilename.StripExtension();
 	posterFilename.AppendString( ".png" );
 
-	movie->Poster = LoadTextureFromBuffer( posterFilename.ToCStr(), MemBufferFile( posterFilename.ToCStr() ),
-			TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), movie->PosterWidth, movie->PosterHeight );
-
-	if ( movie->Poster == 0 && Cinema.IsExternalSDCardDir( posterFilename.ToCStr() ) )
+	// posters for movies on an external sdcard may have been created in the cache
+	String cachedFilename;
+	if ( Cinema.IsExternalSDCardDir( posterFilename.ToCStr() ) )
 	{
-		posterFilename = Native::GetExternalCacheDirectory( Cinema.app ) + ExtractFile( posterFilename );
+		cachedFilename = Native::GetExternalCacheDirectory( Cinema.app ) + ExtractFile( posterFilename );
+	}
 
-		// check if we have the thumbnail in the cache
-		movie->Poster = LoadTextureFromBuffer( posterFilename.ToCStr(), MemBufferFile( posterFilename.ToCStr() ),
-				TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), movie->PosterWidth, movie->PosterHeight );
+	Loader.LoadPoster( movie, POSTER_SOURCE_FILE, posterFilename.ToCStr(), cachedFilename.ToCStr() );
+}
 
+void MovieManager::CreateThumbnail( MovieDef *movie )
+{
+	String posterFilename = movie->Filename;
+	posterFilename.StripExtension();
+	posterFilename.AppendString( ".png" );
 
-	}
-	// no thumbnail found, so create it.  if it's on an external sdcard, posterFilename will contain the new filename at this point and will load it from the cache
-	if ( ( movie->Poster == 0 ) && Native::CreateVideoThumbnail( Cinema.app, movie->Filename.ToCStr(), posterFilename.ToCStr(), PosterWidth, PosterHeight ) )
+	// can't write to an external sdcard, so the thumbnail goes to the cache
+	if ( Cinema.IsExternalSDCardDir( posterFilename.ToCStr() ) )
 	{
-		movie->Poster = LoadTextureFromBuffer( posterFilename.ToCStr(), MemBufferFile( posterFilename.ToCStr() ),
-				TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), movie->PosterWidth, movie->PosterHeight );
+		posterFilename = Native::GetExternalCacheDirectory( Cinema.app ) + ExtractFile( posterFilename );
 	}
 
-	// if all else failed, then just use the default poster
-	if ( movie->Poster == 0 )
+	if ( Native::CreateVideoThumbnail( Cinema.app, movie->Filename.ToCStr(), posterFilename.ToCStr(), PosterWidth, PosterHeight ) )
 	{
-		movie->Poster = LoadTextureFromApplicationPackage( "assets/default_poster.png",
-				TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), movie->PosterWidth, movie->PosterHeight );
+		Loader.LoadPoster( movie, POSTER_SOURCE_THUMBNAIL, posterFilename.ToCStr(), NULL );
 	}
-
-	BuildTextureMipmaps( GlTexture( movie->Poster, movie->PosterWidth, movie->PosterHeight ) );
-	MakeTextureTrilinear( GlTexture( movie->Poster, movie->PosterWidth, movie->PosterHeight ) );
-	MakeTextureClamped( GlTexture( movie->Poster, movie->PosterWidth, movie->PosterHeight ) );
 }
 
 bool MovieManager::IsSupportedMovieFormat( const String &extension ) const
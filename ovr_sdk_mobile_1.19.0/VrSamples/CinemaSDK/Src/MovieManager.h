@@ -19,6 +19,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "Kernel/OVR_String.h"
 #include "Kernel/OVR_Array.h"
 #include "GlTexture.h"
+#include "PosterLoader.h"
 
 namespace OculusCinema {
 
@@ -52,6 +53,7 @@ public:
 	MovieFormat 	Format;
 
 	GLuint			Poster;
+	Vector4f		PosterUVs;		// posters share atlas textures, so this is the part of Poster to show
 	int				PosterWidth;
 	int				PosterHeight;
 
@@ -62,7 +64,7 @@ public:
 	bool			AllowTheaterSelection;
 
 
-	MovieDef() : Filename(), Title(), Is3D( false ), Format( VT_2D ), Poster( 0 ), PosterWidth( 0 ), PosterHeight( 0 ),
+	MovieDef() : Filename(), Title(), Is3D( false ), Format( VT_2D ), Poster( 0 ), PosterUVs( 0.0f, 0.0f, 1.0f, 1.0f ), PosterWidth( 0 ), PosterHeight( 0 ),
 			Theater(), Category( CATEGORY_MYVIDEOS ), IsEncrypted( false ), AllowTheaterSelection( false ) {}
 };
 
@@ -75,8 +77,14 @@ public:
 	void					OneTimeInit( const char * launchIntent );
 	void					OneTimeShutdown();
 
+	// Uploads the posters that finished loading. Must be called every frame on the GL thread.
+	void					Frame();
+
 	Array<const MovieDef *>	GetMovieList( MovieCategory category ) const;
 
+	// Changes whenever the poster of any movie changes.
+	int						GetPosterVersion() const { return PosterVersion; }
+
 	static const String 	GetMovieTitleFromFilename( const char *filepath );
 
 public:
@@ -90,6 +98,12 @@ public:
 private:
 	CinemaApp &				Cinema;
 
+	PosterLoader			Loader;
+	GLuint					DefaultPoster;
+	Vector4f				DefaultPosterUVs;
+	int						PosterVersion;
+	Array<MovieDef *>		ThumbnailQueue;		// movies that need a thumbnail created from the video
+
 	MovieManager &			operator=( const MovieManager & );
 
 	void					LoadMovies();
@@ -97,6 +111,7 @@ private:
 	MovieCategory 			CategoryFromString( const String &categoryString ) const;
 	void 					ReadMetaData( MovieDef *movie );
 	void 					LoadPoster( MovieDef *movie );
+	void					CreateThumbnail( MovieDef *movie );
 	void 					MoviesInDirectory( Array<String> &movies, const char * dirName ) const;
 	Array<String> 			ScanMovieDirectories() const;
 	bool					IsSupportedMovieFormat( const String &extension ) const;
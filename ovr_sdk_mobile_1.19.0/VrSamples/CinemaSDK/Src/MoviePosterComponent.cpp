@@ -28,6 +28,8 @@ bool MoviePosterComponent::ShowShadows = true;
 MoviePosterComponent::MoviePosterComponent() :
 	CarouselItemComponent( VRMenuEventFlags_t() ),
 	Movie( NULL ),
+	Texture( 0 ),
+	TextureUVs( 0.0f, 0.0f, 1.0f, 1.0f ),
     Poster( NULL ),
 	PosterImage( NULL ),
     Is3DIcon( NULL ),
@@ -78,12 +80,19 @@ void MoviePosterComponent::SetItem( VRMenuObject * self, const CarouselItem * it
 	Is3DIcon->SetColor( pose.Color );
 	Shadow->SetColor( pose.Color );
 
-	if ( movie != Movie )
+	// the poster changes when the real one replaces the placeholder
+	if ( ( movie != Movie ) || ( ( movie != NULL ) && ( ( item->Texture != Texture ) || ( item->TextureUVs != TextureUVs ) ) ) )
 	{
 		if ( movie != NULL )
 		{
-			PosterImage->SetImage( 0, SURFACE_TEXTURE_DIFFUSE, item->Texture, 
-				static_cast<short>( Width ), static_cast<short>( Height ) );
+			VRMenuSurfaceParms parms( "",
+				item->Texture, Width, Height, SURFACE_TEXTURE_DIFFUSE,
+				0, 0, 0, SURFACE_TEXTURE_MAX,
+				0, 0, 0, SURFACE_TEXTURE_MAX );
+			parms.CropUV = item->TextureUVs;
+			PosterImage->SetImage( 0, parms );
+			Texture = item->Texture;
+			TextureUVs = item->TextureUVs;
 
 			Is3DIcon->SetVisible( movie->Is3D );
 			Shadow->SetVisible( ShowShadows );
@@ -43,6 +43,8 @@ private:
                                     VRMenuObject * self, VRMenuEvent const & event );
 
     const MovieDef *	 	Movie;
+    GLuint					Texture;
+    Vector4f				TextureUVs;
 
     int						Width;
     int						Height;
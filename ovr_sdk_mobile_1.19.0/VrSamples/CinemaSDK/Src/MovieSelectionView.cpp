@@ -88,7 +88,8 @@ MovieSelectionView::MovieSelectionView( CinemaApp &cinema ) :
 	MoviesIndex( 0 ),
 	LastMovieDisplayed( NULL ),
 	RepositionScreen( false ),
-	HadSelection( false )
+	HadSelection( false ),
+	PosterVersion( 0 )
 
 {
 	// This is called at library load time, so the system is not initialized
@@ -612,12 +613,14 @@ void MovieSelectionView::SetMovieList( const Array<const MovieDef *> &movies, co
 
 		CarouselItem *item = new CarouselItem();
 		item->Texture 		= movie->Poster;
+		item->TextureUVs 	= movie->PosterUVs;
 		item->TextureWidth 	= movie->PosterWidth;
 		item->TextureHeight	= movie->PosterHeight;
 		item->UserData 		= ( void * )movie;
 		MovieBrowserItems.PushBack( item );
 	}
 	MovieBrowser->SetItems( MovieBrowserItems );
+	PosterVersion = Cinema.MovieMgr.GetPosterVersion();
 
 	MovieTitle->SetText( "" );
 	LastMovieDisplayed = NULL;
@@ -830,6 +833,19 @@ void MovieSelectionView::Frame( const ovrFrameInput & vrFrame )
 	eyeBufferParms.multisamples = 4;
 	Cinema.app->SetEyeBufferParms( eyeBufferParms );
 
+	// show the posters that finished loading in place of the placeholders
+	if ( PosterVersion != Cinema.MovieMgr.GetPosterVersion() )
+	{
+		PosterVersion = Cinema.MovieMgr.GetPosterVersion();
+		for ( UPInt i = 0; i < MovieBrowserItems.GetSize(); i++ )
+		{
+			const MovieDef * movie = static_cast<const MovieDef *>( MovieBrowserItems[ i ]->UserData );
+			MovieBrowserItems[ i ]->Texture = movie->Poster;
+			MovieBrowserItems[ i ]->TextureUVs = movie->PosterUVs;
+		}
+		MovieBrowser->RefreshPanels();
+	}
+
 #if 0
 	if ( !Cinema.InLobby && Cinema.SceneMgr.ChangeSeats( vrFrame ) )
 	{
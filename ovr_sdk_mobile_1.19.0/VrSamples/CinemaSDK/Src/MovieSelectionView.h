@@ -140,6 +140,8 @@ private:
 	bool								RepositionScreen;
 	bool								HadSelection;
 
+	int									PosterVersion;		// MovieManager poster version that MovieBrowserItems were last updated for
+
 private:
 	MovieSelectionView &				operator=( const MovieSelectionView & );
 
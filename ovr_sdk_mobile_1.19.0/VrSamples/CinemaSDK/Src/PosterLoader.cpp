@@ -0,0 +1,395 @@
+/************************************************************************************
+
+Filename    :   PosterLoader.cpp
+Content     :	Loads movie posters on background threads into a shared texture atlas.
+Created     :	10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+This source code is licensed under the BSD-style license found in the
+LICENSE file in the Cinema/ directory. An additional grant
+of patent rights can be found in the PATENTS file in the same directory.
+
+*************************************************************************************/
+
+#include "PosterLoader.h"
+
+#include "Kernel/OVR_MemBuffer.h"
+#include "Kernel/OVR_LogUtils.h"
+#include "stb_image.h"
+
+namespace OculusCinema {
+
+//=======================================================================================
+// PosterAtlas
+
+PosterAtlas::PosterAtlas() :
+	CellWidth( 0 ),
+	CellHeight( 0 ),
+	PageColumns( 0 ),
+	PageRows( 0 ),
+	Pages()
+{
+}
+
+PosterAtlas::~PosterAtlas()
+{
+	OVR_ASSERT( Pages.GetSizeI() == 0 );	// Shutdown() must be called on the GL thread
+}
+
+void PosterAtlas::Init( const int cellWidth, const int cellHeight )
+{
+	OVR_ASSERT( Pages.GetSizeI() == 0 );
+
+	CellWidth = cellWidth;
+	CellHeight = cellHeight;
+	PageColumns = Alg::Max( MAX_PAGE_SIZE / GetPaddedWidth(), 1 );
+	PageRows = Alg::Max( MAX_PAGE_SIZE / GetPaddedHeight(), 1 );
+}
+
+void PosterAtlas::Shutdown()
+{
+	for ( int i = 0; i < Pages.GetSizeI(); i++ )
+	{
+		glDeleteTextures( 1, &Pages[ i ].Texture );
+	}
+	Pages.Clear();
+}
+
+size_t PosterAtlas::GetCellSizeInBytes() const
+{
+	return GetPaddedWidth() * GetPaddedHeight() * 4;
+}
+
+void PosterAtlas::BuildCell( const uint8_t * rgba, const int width, const int height, Array< uint8_t > & cell ) const
+{
+	const int paddedWidth = GetPaddedWidth();
+	const int paddedHeight = GetPaddedHeight();
+	cell.Resize( GetCellSizeInBytes() );
+
+	// Average the source pixels that fall into each cell pixel. This is a copy for images
+	// that already have the size of a cell, which is the case for generated thumbnails.
+	for ( int y = 0; y < CellHeight; y++ )
+	{
+		const int y0 = y * height / CellHeight;
+		const int y1 = Alg::Max( ( y + 1 ) * height / CellHeight, y0 + 1 );
+		uint8_t * dest = &cell[ ( ( y + CELL_BORDER ) * paddedWidth + CELL_BORDER ) * 4 ];
+		for ( int x = 0; x < CellWidth; x++, dest += 4 )
+		{
+			const int x0 = x * width / CellWidth;
+			const int x1 = Alg::Max( ( x + 1 ) * width / CellWidth, x0 + 1 );
+			if ( x1 - x0 == 1 && y1 - y0 == 1 )
+			{
+				memcpy( dest, &rgba[ ( y0 * width + x0 ) * 4 ], 4 );
+				continue;
+			}
+			int sum[4] = { 0, 0, 0, 0 };
+			for ( int sy = y0; sy < y1; sy++ )
+			{
+				const uint8_t * src = &rgba[ ( sy * width + x0 ) * 4 ];
+				for ( int sx = x0; sx < x1; sx++, src += 4 )
+				{
+					sum[0] += src[0];
+					sum[1] += src[1];
+					sum[2] += src[2];
+					sum[3] += src[3];
+				}
+			}
+			const int count = ( x1 - x0 ) * ( y1 - y0 );
+			for ( int c = 0; c < 4; c++ )
+			{
+				dest[c] = static_cast< uint8_t >( ( sum[c] + count / 2 ) / count );
+			}
+		}
+	}
+
+	// Repeat the edge pixels into the border.
+	for ( int y = CELL_BORDER; y < CELL_BORDER + CellHeight; y++ )
+	{
+		uint8_t * row = &cell[ y * paddedWidth * 4 ];
+		for ( int x = 0; x < CELL_BORDER; x++ )
+		{
+			memcpy( &row[ x * 4 ], &row[ CELL_BORDER * 4 ], 4 );
+			memcpy( &row[ ( paddedWidth - 1 - x ) * 4 ], &row[ ( CELL_BORDER + CellWidth - 1 ) * 4 ], 4 );
+		}
+	}
+	const size_t rowSize = paddedWidth * 4;
+	for ( int y = 0; y < CELL_BORDER; y++ )
+	{
+		memcpy( &cell[ y * rowSize ], &cell[ CELL_BORDER * rowSize ], rowSize );
+		memcpy( &cell[ ( paddedHeight - 1 - y ) * rowSize ], &cell[ ( CELL_BORDER + CellHeight - 1 ) * rowSize ], rowSize );
+	}
+}
+
+void PosterAtlas::AddCell( const uint8_t * cell, GLuint & texture, Vector4f & uvs )
+{
+	if ( Pages.GetSizeI() == 0 || Pages.Back().NumCells == PageColumns * PageRows )
+	{
+		Page page;
+		page.NumCells = 0;
+		page.Dirty = false;
+		glGenTextures( 1, &page.Texture );
+		glBindTexture( GL_TEXTURE_2D, page.Texture );
+		glTexStorage2D( GL_TEXTURE_2D, NUM_MIP_LEVELS, GL_RGBA8, GetPageWidth(), GetPageHeight() );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, NUM_MIP_LEVELS - 1 );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		glBindTexture( GL_TEXTURE_2D, 0 );
+		Pages.PushBack( page );
+	}
+
+	Page & page = Pages.Back();
+	const int x = ( page.NumCells % PageColumns ) * GetPaddedWidth();
+	const int y = ( page.NumCells / PageColumns ) * GetPaddedHeight();
+	page.NumCells++;
+	page.Dirty = true;
+
+	glBindTexture( GL_TEXTURE_2D, page.Texture );
+	glTexSubImage2D( GL_TEXTURE_2D, 0, x, y, GetPaddedWidth(), GetPaddedHeight(), GL_RGBA, GL_UNSIGNED_BYTE, cell );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+
+	const float pageWidth = static_cast< float >( GetPageWidth() );
+	const float pageHeight = static_cast< float >( GetPageHeight() );
+	texture = page.Texture;
+	uvs.x = ( x + CELL_BORDER ) / pageWidth;
+	uvs.y = ( y + CELL_BORDER ) / pageHeight;
+	uvs.z = ( x + CELL_BORDER + CellWidth ) / pageWidth;
+	uvs.w = ( y + CELL_BORDER + CellHeight ) / pageHeight;
+}
+
+void PosterAtlas::Flush()
+{
+	for ( int i = 0; i < Pages.GetSizeI(); i++ )
+	{
+		if ( Pages[ i ].Dirty )
+		{
+			glBindTexture( GL_TEXTURE_2D, Pages[ i ].Texture );
+			glGenerateMipmap( GL_TEXTURE_2D );
+			Pages[ i ].Dirty = false;
+		}
+	}
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+//=======================================================================================
+// PosterLoader
+
+PosterLoader::PosterLoader() :
+	Atlas(),
+	Threads(),
+	NextJob( 0 ),
+	NumPending( 0 ),
+	Exiting( false )
+{
+}
+
+PosterLoader::~PosterLoader()
+{
+	OVR_ASSERT( Threads.GetSizeI() == 0 );
+}
+
+void PosterLoader::Init( const int cellWidth, const int cellHeight )
+{
+	OVR_ASSERT( Threads.GetSizeI() == 0 );
+
+	Atlas.Init( cellWidth, cellHeight );
+	Exiting = false;
+
+	for ( int i = 0; i < NUM_THREADS; i++ )
+	{
+		Thread::CreateParams createParams( PosterLoader::ThreadFn, this, 128 * 1024, -1,
+				Thread::Running, Thread::BelowNormalPriority );
+		Threads.PushBack( new Thread( createParams ) );
+	}
+}
+
+void PosterLoader::Shutdown()
+{
+	{
+		Mutex::Locker locker( &QueueMutex );
+		Exiting = true;
+		QueueWake.NotifyAll();
+	}
+
+	for ( int i = 0; i < Threads.GetSizeI(); i++ )
+	{
+		Threads[ i ]->Join();
+		delete Threads[ i ];
+	}
+	Threads.Clear();
+
+	for ( int i = 0; i < Finished.GetSizeI(); i++ )
+	{
+		delete Finished[ i ];
+	}
+	Finished.Clear();
+	Jobs.Clear();
+	NextJob = 0;
+	NumPending = 0;
+
+	Atlas.Shutdown();
+}
+
+void PosterLoader::LoadPoster( void * userData, const int tag, const char * fileName, const char * altFileName )
+{
+	Job job;
+	job.UserData = userData;
+	job.Tag = tag;
+	job.FileName = fileName;
+	job.AltFileName = ( altFileName != NULL ) ? altFileName : "";
+
+	Mutex::Locker locker( &QueueMutex );
+	Jobs.PushBack( job );
+	NumPending++;
+	QueueWake.Notify();
+}
+
+bool PosterLoader::LoadPosterNow( const uint8_t * buffer, const int bufferLength, GLuint & texture, Vector4f & uvs )
+{
+	Array< uint8_t > cell;
+	if ( !DecodeImage( buffer, bufferLength, cell ) )
+	{
+		return false;
+	}
+	Atlas.AddCell( cell.GetDataPtr(), texture, uvs );
+	Atlas.Flush();
+	return true;
+}
+
+void PosterLoader::Update( Array< Result > & results, const int maxUploads )
+{
+	Array< Decoded * > decoded;
+	{
+		Mutex::Locker locker( &QueueMutex );
+		int count = 0;
+		int uploads = 0;
+		for ( ; count < Finished.GetSizeI(); count++ )
+		{
+			if ( Finished[ count ]->Cell.GetSizeI() > 0 )
+			{
+				if ( uploads == maxUploads )
+				{
+					break;
+				}
+				uploads++;
+			}
+		}
+		if ( count == 0 )
+		{
+			return;
+		}
+		decoded.Append( Finished.GetDataPtr(), count );
+		Finished.RemoveMultipleAt( 0, count );
+		NumPending -= count;
+	}
+
+	for ( int i = 0; i < decoded.GetSizeI(); i++ )
+	{
+		Result result;
+		result.UserData = decoded[ i ]->UserData;
+		result.Tag = decoded[ i ]->Tag;
+		result.Loaded = decoded[ i ]->Cell.GetSizeI() > 0;
+		result.Texture = 0;
+		result.UVs = Vector4f( 0.0f, 0.0f, 1.0f, 1.0f );
+		if ( result.Loaded )
+		{
+			Atlas.AddCell( decoded[ i ]->Cell.GetDataPtr(), result.Texture, result.UVs );
+		}
+		results.PushBack( result );
+		delete decoded[ i ];
+	}
+
+	// one mipmap build per page for the whole batch
+	Atlas.Flush();
+}
+
+int PosterLoader::GetNumPending() const
+{
+	Mutex::Locker locker( &QueueMutex );
+	return NumPending;
+}
+
+threadReturn_t PosterLoader::ThreadFn( Thread * thread, void * data )
+{
+	PosterLoader * loader = static_cast< PosterLoader * >( data );
+
+	thread->SetThreadName( "PosterLoader" );
+
+	for ( ; ; )
+	{
+		Job job;
+		{
+			Mutex::Locker locker( &loader->QueueMutex );
+			while ( loader->NextJob == loader->Jobs.GetSizeI() && !loader->Exiting )
+			{
+				loader->QueueWake.Wait( &loader->QueueMutex );
+			}
+			if ( loader->Exiting )
+			{
+				break;
+			}
+			job = loader->Jobs[ loader->NextJob++ ];
+			if ( loader->NextJob == loader->Jobs.GetSizeI() )
+			{
+				loader->Jobs.Clear();
+				loader->NextJob = 0;
+			}
+		}
+
+		Decoded * decoded = loader->DecodeJob( job );
+
+		{
+			Mutex::Locker locker( &loader->QueueMutex );
+			loader->Finished.PushBack( decoded );
+		}
+	}
+
+	return (threadReturn_t)0;
+}
+
+PosterLoader::Decoded * PosterLoader::DecodeJob( const Job & job ) const
+{
+	Decoded * decoded = new Decoded();
+	decoded->UserData = job.UserData;
+	decoded->Tag = job.Tag;
+
+	const String * fileNames[2] = { &job.FileName, &job.AltFileName };
+	for ( int i = 0; i < 2; i++ )
+	{
+		if ( fileNames[ i ]->IsEmpty() )
+		{
+			continue;
+		}
+		MemBufferFile file( MemBufferFile::NoInit );
+		if ( !file.LoadFile( fileNames[ i ]->ToCStr() ) )
+		{
+			continue;
+		}
+		if ( DecodeImage( static_cast< const uint8_t * >( file.Buffer ), file.Length, decoded->Cell ) )
+		{
+			break;
+		}
+		OVR_LOG( "PosterLoader: failed to decode %s", fileNames[ i ]->ToCStr() );
+	}
+	return decoded;
+}
+
+bool PosterLoader::DecodeImage( const uint8_t * buffer, const int bufferLength, Array< uint8_t > & cell ) const
+{
+	int width = 0;
+	int height = 0;
+	int comp = 0;
+	stbi_uc * image = stbi_load_from_memory( buffer, bufferLength, &width, &height, &comp, 4 );
+	if ( image == NULL )
+	{
+		return false;
+	}
+	Atlas.BuildCell( image, width, height, cell );
+	free( image );
+	return true;
+}
+
+} // namespace OculusCinema
@@ -0,0 +1,155 @@
+/************************************************************************************
+
+Filename    :   PosterLoader.h
+Content     :	Loads movie posters on background threads into a shared texture atlas.
+Created     :	10/18/2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+This source code is licensed under the BSD-style license found in the
+LICENSE file in the Cinema/ directory. An additional grant
+of patent rights can be found in the PATENTS file in the same directory.
+
+*************************************************************************************/
+
+#if !defined( PosterLoader_h )
+#define PosterLoader_h
+
+#include "Kernel/OVR_String.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Math.h"
+#include "Kernel/OVR_Threads.h"
+#include "OVR_GlUtils.h"
+
+namespace OculusCinema {
+
+using namespace OVR;
+
+//==============================================================
+// PosterAtlas
+// Posters are all drawn at the same size, so they are packed into a grid of cells on a few
+// large textures instead of each getting its own texture. Every cell has a border of
+// repeated edge pixels so that filtering and the first mip levels do not bleed between cells.
+class PosterAtlas
+{
+public:
+	static const int		CELL_BORDER = 4;
+	static const int		MAX_PAGE_SIZE = 2048;
+	static const int		NUM_MIP_LEVELS = 3;
+
+							PosterAtlas();
+							~PosterAtlas();
+
+	void					Init( const int cellWidth, const int cellHeight );
+	void					Shutdown();
+
+	int						GetCellWidth() const { return CellWidth; }
+	int						GetCellHeight() const { return CellHeight; }
+	int						GetNumPages() const { return Pages.GetSizeI(); }
+
+	// Scales an RGBA image to the cell size and adds the cell border. Does not touch GL,
+	// so it can be called on any thread. cell is resized to GetCellSizeInBytes().
+	void					BuildCell( const uint8_t * rgba, const int width, const int height, Array< uint8_t > & cell ) const;
+	size_t					GetCellSizeInBytes() const;
+
+	// Uploads a cell built by BuildCell() and returns the texture and the crop range of the
+	// poster in UV space.
+	void					AddCell( const uint8_t * cell, GLuint & texture, Vector4f & uvs );
+	// Generates the mip levels of the pages that cells were added to since the last flush.
+	void					Flush();
+
+private:
+	struct Page
+	{
+		GLuint				Texture;
+		int					NumCells;
+		bool				Dirty;
+	};
+
+	int						CellWidth;
+	int						CellHeight;
+	int						PageColumns;
+	int						PageRows;
+	Array< Page >			Pages;
+
+	int						GetPaddedWidth() const { return CellWidth + 2 * CELL_BORDER; }
+	int						GetPaddedHeight() const { return CellHeight + 2 * CELL_BORDER; }
+	int						GetPageWidth() const { return PageColumns * GetPaddedWidth(); }
+	int						GetPageHeight() const { return PageRows * GetPaddedHeight(); }
+};
+
+//==============================================================
+// PosterLoader
+// Reads and decodes posters on worker threads and uploads the finished ones into a
+// PosterAtlas in batches on the GL thread, so a large library does not hold up startup.
+class PosterLoader
+{
+public:
+	static const int		NUM_THREADS = 2;
+
+	struct Result
+	{
+		void *				UserData;
+		int					Tag;
+		bool				Loaded;		// false if none of the files could be loaded
+		GLuint				Texture;
+		Vector4f			UVs;
+	};
+
+							PosterLoader();
+							~PosterLoader();
+
+	// Must be called on the GL thread.
+	void					Init( const int cellWidth, const int cellHeight );
+	void					Shutdown();
+
+	// Loads the first of fileName and altFileName that can be decoded. altFileName can be NULL.
+	// userData and tag are returned in the result.
+	void					LoadPoster( void * userData, const int tag, const char * fileName, const char * altFileName );
+	// Decodes and uploads an image on the calling thread, which must be the GL thread.
+	bool					LoadPosterNow( const uint8_t * buffer, const int bufferLength, GLuint & texture, Vector4f & uvs );
+
+	// Uploads up to maxUploads posters that finished decoding and appends their results,
+	// and the results of the posters that failed to load.
+	void					Update( Array< Result > & results, const int maxUploads );
+
+	// Posters that were queued but have not been returned by Update() yet.
+	int						GetNumPending() const;
+	int						GetNumTextures() const { return Atlas.GetNumPages(); }
+
+private:
+	struct Job
+	{
+		void *				UserData;
+		int					Tag;
+		String				FileName;
+		String				AltFileName;
+	};
+
+	struct Decoded
+	{
+		void *				UserData;
+		int					Tag;
+		Array< uint8_t >	Cell;		// empty if the poster failed to load
+	};
+
+	PosterAtlas				Atlas;
+	Array< Thread * >		Threads;
+
+	mutable Mutex			QueueMutex;
+	WaitCondition			QueueWake;
+	Array< Job >			Jobs;
+	int						NextJob;
+	Array< Decoded * >		Finished;
+	int						NumPending;
+	bool					Exiting;
+
+	static threadReturn_t	ThreadFn( Thread * thread, void * data );
+	Decoded *				DecodeJob( const Job & job ) const;
+	bool					DecodeImage( const uint8_t * buffer, const int bufferLength, Array< uint8_t > & cell ) const;
+};
+
+} // namespace OculusCinema
+
+#endif // PosterLoader_h
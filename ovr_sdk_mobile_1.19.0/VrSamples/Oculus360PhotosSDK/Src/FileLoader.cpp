@@ -20,6 +20,8 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "Oculus360Photos.h"
 #include "turbojpeg.h"
 #include "OVR_TurboJpeg.h"
+#include "SystemClock.h"
+#include "ImageData.h"
 
 namespace OVR {
 
@@ -156,6 +158,8 @@ void * Queue3Thread( Thread * thread, void * v )
 {
 	thread->SetThreadName( "FileQueue3" );
 
+	Oculus360Photos * photos = ( Oculus360Photos * )v;
+
 	// Process incoming messages until queue is empty
 	for ( ; ; )
 	{
@@ -237,6 +241,56 @@ void * Queue3Thread( Thread * thread, void * v )
 				data[i] = NULL;
 			}
 		}
+		else if ( photos->GetPanoCompression() != Texture_None )
+		{
+			// Compress on this thread so the background GL thread only has to upload the blocks.
+			// Only the levels that are uploaded are encoded, so images too large for gl are
+			// quartered first, and panos stop after the levels they sample.
+			const double start = SystemClock::GetTimeInSeconds();
+			const bool isCube = ( numBuffers == 6 );
+			const int maxSize = photos->GetMaxTextureSize( isCube );
+			while ( resolutionX > maxSize || resolutionY > maxSize )
+			{
+				OVR_LOG( "Queue3: quartering oversize %ix%i image", resolutionX, resolutionY );
+				for ( int i = 0; i < numBuffers; i++ )
+				{
+					unsigned char * quartered = QuarterImageSize( data[i], resolutionX, resolutionY, photos->GetUseSrgb() );
+					free( data[i] );
+					data[i] = quartered;
+				}
+				resolutionX >>= 1;
+				resolutionY >>= 1;
+			}
+			int numLevels = Oculus360Photos::PANO_NUM_LEVELS;
+			if ( isCube )
+			{
+				numLevels = ovrDecodedTexture::MAX_LEVELS;
+			}
+			ovrDecodedTexture * textures[6] = {};
+			for ( int i = 0; i < numBuffers; i++ )
+			{
+				textures[i] = new ovrDecodedTexture;
+				photos->GetTextureEncoder().EncodeMipChain( data[i], resolutionX, resolutionY, numLevels,
+						photos->GetPanoCompression(), photos->GetUseSrgb(), photos->GetPanoCompressionQuality(), *textures[i] );
+				free( data[i] );
+				data[i] = NULL;
+			}
+			OVR_LOG( "Queue3: %4.2fs to compress %i %ix%i images", SystemClock::GetTimeInSeconds() - start, numBuffers, resolutionX, resolutionY );
+
+			if ( numBuffers == 1 )
+			{
+				OVR_LOG( "Queue3.PostPrintf( \"c%s %p\" )", commandName, textures[0] );
+				photos->GetBGMessageQueue().PostPrintf( "c%s %p", commandName, textures[0] );
+			}
+			else
+			{
+				OVR_ASSERT( numBuffers == 6 );
+				OVR_LOG( "Queue3.PostPrintf( \"c%s %p %p %p %p %p %p\" )", commandName,
+						textures[0], textures[1], textures[2], textures[3], textures[4], textures[5] );
+				photos->GetBGMessageQueue().PostPrintf( "c%s %p %p %p %p %p %p", commandName,
+						textures[0], textures[1], textures[2], textures[3], textures[4], textures[5] );
+			}
+		}
 		else
 		{
 			if ( numBuffers == 1 )
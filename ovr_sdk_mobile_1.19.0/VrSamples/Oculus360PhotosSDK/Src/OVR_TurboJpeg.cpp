@@ -83,9 +83,11 @@ bool WriteJpeg( const char * destinationFile, const unsigned char * rgbxBuffer,
 #endif
 }
 
-// Drop-in replacement for stbi_load_from_memory(), but without component specification.
-// Often 2x - 3x faster.
-unsigned char * TurboJpegLoadFromMemory( const unsigned char * jpg, const int length, int * width, int * height )
+// Decodes at the smallest of the 1, 1/2, 1/4 and 1/8 DCT scaling factors that gives at least
+// minWidth x minHeight, or at full size when minWidth or minHeight is 0. These factors only
+// drop DCT coefficients, while the others need a resampling IDCT that is barely cheaper.
+static unsigned char * LoadFromMemory( const unsigned char * jpg, const int length, const int minWidth, const int minHeight,
+		int * width, int * height )
 {
 #if defined( OVR_OS_ANDROID )
 	tjhandle tj = tjInitDecompress();
@@ -102,13 +104,33 @@ unsigned char * TurboJpegLoadFromMemory( const unsigned char * jpg, const int le
 		tjDestroy( tj );
 		return NULL;
 	}
-	const int bufLen = jpegWidth * jpegHeight * 4;
+
+	int scaledWidth = jpegWidth;
+	int scaledHeight = jpegHeight;
+	if ( minWidth > 0 && minHeight > 0 )
+	{
+		int numScalingFactors = 0;
+		const tjscalingfactor * scalingFactors = tjGetScalingFactors( &numScalingFactors );
+		for ( int i = 0; i < numScalingFactors; i++ )
+		{
+			const tjscalingfactor sf = scalingFactors[i];
+			const int w = TJSCALED( jpegWidth, sf );
+			const int h = TJSCALED( jpegHeight, sf );
+			if ( sf.num == 1 && ( sf.denom & ( sf.denom - 1 ) ) == 0 && w >= minWidth && h >= minHeight && w * h < scaledWidth * scaledHeight )
+			{
+				scaledWidth = w;
+				scaledHeight = h;
+			}
+		}
+	}
+
+	const int bufLen = scaledWidth * scaledHeight * 4;
 	unsigned char * buffer = ( unsigned char * )malloc( bufLen );
 	if ( buffer != NULL )
 	{
 		const int decompRet = tjDecompress2( tj,
 			( unsigned char * )jpg, length, buffer,
-			jpegWidth, jpegWidth * 4, jpegHeight, TJPF_RGBX, 0 /* flags */ );
+			scaledWidth, scaledWidth * 4, scaledHeight, TJPF_RGBX, 0 /* flags */ );
 		if ( decompRet )
 		{
 			LOG_TJ( "TurboJpegLoadFromMemory: decompress: %s", tjGetErrorStr() );
@@ -119,8 +141,8 @@ unsigned char * TurboJpegLoadFromMemory( const unsigned char * jpg, const int le
 
 		tjDestroy( tj );
 
-		*width = jpegWidth;
-		*height = jpegHeight;
+		*width = scaledWidth;
+		*height = scaledHeight;
 
 	}
 
@@ -130,12 +152,13 @@ unsigned char * TurboJpegLoadFromMemory( const unsigned char * jpg, const int le
 
 	OVR_UNUSED( jpg );
 	OVR_UNUSED3( length, width, height );
+	OVR_UNUSED2( minWidth, minHeight );
 
 	return NULL;
 #endif
 }
 
-unsigned char * TurboJpegLoadFromFile( const char * filename, int * width, int * height )
+static unsigned char * LoadFromFile( const char * filename, const int minWidth, const int minHeight, int * width, int * height )
 {
 #if defined( OVR_OS_ANDROID )
 	const int fd = open( filename, O_RDONLY );
@@ -162,7 +185,7 @@ unsigned char * TurboJpegLoadFromFile( const char * filename, int * width, int *
 	}
 	LOG_TJ( "mmap %s, %i bytes at %p", filename, ( int )st.st_size, jpg );
 
-	unsigned char * ret = TurboJpegLoadFromMemory( jpg, ( int )st.st_size, width, height );
+	unsigned char * ret = LoadFromMemory( jpg, ( int )st.st_size, minWidth, minHeight, width, height );
 	close( fd );
 	munmap( ( void * )jpg, ( size_t )st.st_size );
 	return ret;
@@ -171,8 +194,33 @@ unsigned char * TurboJpegLoadFromFile( const char * filename, int * width, int *
 
 	OVR_UNUSED( filename );
 	OVR_UNUSED2( width, height );
+	OVR_UNUSED2( minWidth, minHeight );
 
 	return NULL;
 #endif
 }
+
+// Drop-in replacement for stbi_load_from_memory(), but without component specification.
+// Often 2x - 3x faster.
+unsigned char * TurboJpegLoadFromMemory( const unsigned char * jpg, const int length, int * width, int * height )
+{
+	return LoadFromMemory( jpg, length, 0, 0, width, height );
+}
+
+unsigned char * TurboJpegLoadFromFile( const char * filename, int * width, int * height )
+{
+	return LoadFromFile( filename, 0, 0, width, height );
+}
+
+unsigned char * TurboJpegLoadScaledFromMemory( const unsigned char * jpg, const int length, const int minWidth, const int minHeight,
+		int * width, int * height )
+{
+	return LoadFromMemory( jpg, length, minWidth, minHeight, width, height );
+}
+
+unsigned char * TurboJpegLoadScaledFromFile( const char * filename, const int minWidth, const int minHeight, int * width, int * height )
+{
+	return LoadFromFile( filename, minWidth, minHeight, width, height );
+}
+
 }
@@ -121,6 +121,7 @@ Oculus360Photos::DoubleBufferedTextureData::DoubleBufferedTextureData() :
 	TextureSwapChain(),
 	Width(),
 	Height(),
+	Format(),
 	CurrentIndex( 0 )
 {
 }
@@ -151,15 +152,16 @@ void Oculus360Photos::DoubleBufferedTextureData::Swap()
 	CurrentIndex ^= 1;
 }
 
-void Oculus360Photos::DoubleBufferedTextureData::SetSize( const int width, const int height )
+void Oculus360Photos::DoubleBufferedTextureData::SetSize( const int width, const int height, const eTextureFormat format )
 {
 	Width[ CurrentIndex ] = width;
 	Height[ CurrentIndex ] = height;
+	Format[ CurrentIndex ] = format;
 }
 
-bool Oculus360Photos::DoubleBufferedTextureData::SameSize( const int width, const int height ) const
+bool Oculus360Photos::DoubleBufferedTextureData::SameSize( const int width, const int height, const eTextureFormat format ) const
 {
-	return ( Width[ CurrentIndex ] == width && Height[ CurrentIndex ] == height );
+	return ( Width[ CurrentIndex ] == width && Height[ CurrentIndex ] == height && Format[ CurrentIndex ] == format );
 }
 
 Oculus360Photos::Oculus360Photos()
@@ -186,6 +188,10 @@ Oculus360Photos::Oculus360Photos()
 	, PanoMenuTimeLeft( -1.0f )
 	, BrowserOpenTime( 0.0f )
 	, UseSrgb( true )
+	, PanoCompression( Texture_None )
+	, PanoCompressionQuality( TEXTURE_ENCODE_NORMAL )
+	, MaxTextureSize( 0 )
+	, MaxCubeMapTextureSize( 0 )
 	, BackgroundCommands( 100 )
 #if defined( OVR_OS_ANDROID )
 	, EglClientVersion( 0 )
@@ -211,6 +217,8 @@ Oculus360Photos::~Oculus360Photos()
 	// Shut down background loader
 	ShutdownRequest.SetState( true );
 
+	TextureEncoder.Shutdown();
+
 	GlobeSurfaceDef.geo.Free();
 	GlProgram::Free( TexturedMvpProgram );
 	GlProgram::Free( CubeMapPanoProgram );
@@ -306,6 +314,19 @@ void Oculus360Photos::EnteredVrMode( const ovrIntentType intentType, const char
 
 		GlobeProgramColor = Vector4f( 1.0f, 1.0f, 1.0f, 1.0f );
 
+		// Every ES 3.0 GPU can sample ETC2, ASTC 4x4 looks better for the same quarter of the memory.
+		if ( extensionsOpenGL.KHR_texture_compression_astc_ldr )
+		{
+			PanoCompression = UseSrgb ? Texture_ASTC_SRGB_4x4 : Texture_ASTC_4x4;
+		}
+		else
+		{
+			PanoCompression = Texture_ETC2_RGB;
+		}
+		TextureEncoder.Init();
+		glGetIntegerv( GL_MAX_TEXTURE_SIZE, &MaxTextureSize );
+		glGetIntegerv( GL_MAX_CUBE_MAP_TEXTURE_SIZE, &MaxCubeMapTextureSize );
+
 		InitFileQueue( app, this );
 
 		// meta file used by OvrMetaData
@@ -546,6 +567,45 @@ void * Oculus360Photos::BackgroundGLLoadThread( Thread * thread, void * v )
 			const double end = SystemClock::GetTimeInSeconds();
 			OVR_LOG( "%4.2fs to load %ix%i res pano map", end - start, width, height );
 		}
+		else if ( MatchesHead( "cpano ", msg ) )
+		{
+			ovrDecodedTexture * texture;
+			sscanf( msg, "cpano %p", &texture );
+
+			const double start = SystemClock::GetTimeInSeconds();
+
+			photos->LoadCompressedTexture( *texture );
+			delete texture;
+
+			// Wait for the upload to complete.
+			glFinish();
+
+			photos->GetMessageQueue().PostPrintf( "%s", "loaded pano" );
+
+			const double end = SystemClock::GetTimeInSeconds();
+			OVR_LOG( "%4.2fs to load compressed pano map", end - start );
+		}
+		else if ( MatchesHead( "ccube ", msg ) )
+		{
+			ovrDecodedTexture * faces[ 6 ];
+			sscanf( msg, "ccube %p %p %p %p %p %p", &faces[ 0 ], &faces[ 1 ], &faces[ 2 ], &faces[ 3 ], &faces[ 4 ], &faces[ 5 ] );
+
+			const double start = SystemClock::GetTimeInSeconds();
+
+			photos->LoadCompressedCubeMap( faces );
+			for ( int i = 0; i < 6; i++ )
+			{
+				delete faces[ i ];
+			}
+
+			// Wait for the upload to complete.
+			glFinish();
+
+			photos->GetMessageQueue().PostPrintf( "%s", "loaded cube" );
+
+			const double end = SystemClock::GetTimeInSeconds();
+			OVR_LOG( "%4.2fs to load compressed cube map", end - start );
+		}
 		else if ( MatchesHead( "cube ", msg ) )
 		{
 			unsigned char * data[ 6 ];
@@ -634,7 +694,7 @@ void Oculus360Photos::LoadRgbaCubeMap( const int resolution, const unsigned char
 
 	// Create texture storage once
 	ovrTextureSwapChain * chain = BackgroundCubeTexData.GetLoadTextureSwapChain();
-	if ( chain == NULL || !BackgroundCubeTexData.SameSize( resolution, resolution ) )
+	if ( chain == NULL || !BackgroundCubeTexData.SameSize( resolution, resolution, Texture_RGBA ) )
 	{
 		vrapi_DestroyTextureSwapChain( chain );
 		const ovrTextureFormat textureFormat = useSrgbFormat ?
@@ -645,7 +705,7 @@ void Oculus360Photos::LoadRgbaCubeMap( const int resolution, const unsigned char
 
 		BackgroundCubeTexData.SetLoadTextureSwapChain( chain );
 
-		BackgroundCubeTexData.SetSize( resolution, resolution );
+		BackgroundCubeTexData.SetSize( resolution, resolution, Texture_RGBA );
 	}
 	glBindTexture( GL_TEXTURE_CUBE_MAP, vrapi_GetTextureSwapChainHandle( chain, 0 ) );
 	for ( int side = 0; side < 6; side++ )
@@ -664,7 +724,7 @@ void Oculus360Photos::LoadRgbaTexture( const unsigned char * data, int width, in
 
 	// Create texture storage once
 	ovrTextureSwapChain * chain = BackgroundPanoTexData.GetLoadTextureSwapChain();
-	if ( chain == NULL || !BackgroundPanoTexData.SameSize( width, height ) )
+	if ( chain == NULL || !BackgroundPanoTexData.SameSize( width, height, Texture_RGBA ) )
 	{
 		vrapi_DestroyTextureSwapChain( chain );
 		const ovrTextureFormat textureFormat = useSrgbFormat ?
@@ -674,7 +734,7 @@ void Oculus360Photos::LoadRgbaTexture( const unsigned char * data, int width, in
 										ComputeFullMipChainNumLevels( width, height ), false );
 
 		BackgroundPanoTexData.SetLoadTextureSwapChain( chain );
-		BackgroundPanoTexData.SetSize( width, height );
+		BackgroundPanoTexData.SetSize( width, height, Texture_RGBA );
 	}
 
 	glBindTexture( GL_TEXTURE_2D, vrapi_GetTextureSwapChainHandle( chain, 0 ) );
@@ -685,12 +745,87 @@ void Oculus360Photos::LoadRgbaTexture( const unsigned char * data, int width, in
 	// from the opposite half of the pano.  Clamping the level avoids this.
 	// A well filtered pano shouldn't have any high frequency texels
 	// that alias near the poles.
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2 );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, PANO_NUM_LEVELS - 1 );
 	glBindTexture( GL_TEXTURE_2D, 0 );
 
 	GL_CheckErrors( "leave LoadRgbaTexture" );
 }
 
+void Oculus360Photos::LoadCompressedCubeMap( const ovrDecodedTexture * const faces[ 6 ] )
+{
+	GL_CheckErrors( "enter LoadCompressedCubeMap" );
+
+	const ovrDecodedTexture & face = *faces[ 0 ];
+	const int resolution = face.Width;
+	const int numLevels = face.NumLevels;
+
+	GLenum glFormat;
+	GLenum glInternalFormat;
+	TextureFormatToGlFormat( face.Format, face.UseSrgb, glFormat, glInternalFormat );
+
+	// Create texture storage once
+	ovrTextureSwapChain * chain = BackgroundCubeTexData.GetLoadTextureSwapChain();
+	if ( chain == NULL || !BackgroundCubeTexData.SameSize( resolution, resolution, face.Format ) )
+	{
+		vrapi_DestroyTextureSwapChain( chain );
+		chain = vrapi_CreateTextureSwapChain3( VRAPI_TEXTURE_TYPE_CUBE, glInternalFormat, resolution, resolution, numLevels, 1 );
+
+		BackgroundCubeTexData.SetLoadTextureSwapChain( chain );
+		BackgroundCubeTexData.SetSize( resolution, resolution, face.Format );
+	}
+	glBindTexture( GL_TEXTURE_CUBE_MAP, vrapi_GetTextureSwapChainHandle( chain, 0 ) );
+	for ( int side = 0; side < 6; side++ )
+	{
+		for ( int level = 0; level < numLevels; level++ )
+		{
+			glCompressedTexSubImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + side, level, 0, 0,
+					faces[ side ]->GetLevelWidth( level ), faces[ side ]->GetLevelHeight( level ), glInternalFormat,
+					(GLsizei)faces[ side ]->LevelSize[ level ], faces[ side ]->GetLevelData( level ) );
+		}
+	}
+	glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, numLevels - 1 );
+	glBindTexture( GL_TEXTURE_CUBE_MAP, 0 );
+
+	GL_CheckErrors( "leave LoadCompressedCubeMap" );
+}
+
+void Oculus360Photos::LoadCompressedTexture( const ovrDecodedTexture & texture )
+{
+	GL_CheckErrors( "enter LoadCompressedTexture" );
+
+	// FileLoader only encodes the PANO_NUM_LEVELS levels that are sampled.
+	const int width = texture.Width;
+	const int height = texture.Height;
+	const int numLevels = texture.NumLevels;
+
+	GLenum glFormat;
+	GLenum glInternalFormat;
+	TextureFormatToGlFormat( texture.Format, texture.UseSrgb, glFormat, glInternalFormat );
+
+	// Create texture storage once
+	ovrTextureSwapChain * chain = BackgroundPanoTexData.GetLoadTextureSwapChain();
+	if ( chain == NULL || !BackgroundPanoTexData.SameSize( width, height, texture.Format ) )
+	{
+		vrapi_DestroyTextureSwapChain( chain );
+		chain = vrapi_CreateTextureSwapChain3( VRAPI_TEXTURE_TYPE_2D, glInternalFormat, width, height, numLevels, 1 );
+
+		BackgroundPanoTexData.SetLoadTextureSwapChain( chain );
+		BackgroundPanoTexData.SetSize( width, height, texture.Format );
+	}
+
+	glBindTexture( GL_TEXTURE_2D, vrapi_GetTextureSwapChainHandle( chain, 0 ) );
+	for ( int level = 0; level < numLevels; level++ )
+	{
+		glCompressedTexSubImage2D( GL_TEXTURE_2D, level, 0, 0,
+				texture.GetLevelWidth( level ), texture.GetLevelHeight( level ), glInternalFormat,
+				(GLsizei)texture.LevelSize[ level ], texture.GetLevelData( level ) );
+	}
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1 );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+
+	GL_CheckErrors( "leave LoadCompressedTexture" );
+}
+
 Matrix4f CubeMatrixForViewMatrix( const Matrix4f & viewMatrix )
 {
 	Matrix4f m = viewMatrix;
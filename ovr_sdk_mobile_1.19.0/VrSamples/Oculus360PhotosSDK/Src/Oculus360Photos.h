@@ -23,6 +23,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "Kernel/OVR_Threads.h"
 #include "GuiSys.h"
 #include "SoundEffectContext.h"
+#include "OVR_TextureEncoder.h"
 #include <memory>
 
 namespace OVR
@@ -68,16 +69,17 @@ public:
 		// Swaps the buffers
 		void					Swap();
 
-		// Update the last loaded size
-		void					SetSize( const int width, const int height );
+		// Update the last loaded size and format
+		void					SetSize( const int width, const int height, const eTextureFormat format );
 
-		// Return true if passed in size match the load index size
-		bool					SameSize( const int width, const int height ) const;
+		// Return true if passed in size and format match the load index size and format
+		bool					SameSize( const int width, const int height, const eTextureFormat format ) const;
 
 	private:
 		ovrTextureSwapChain *	TextureSwapChain[ 2 ];
 		int						Width[ 2 ];
 		int						Height[ 2 ];
+		eTextureFormat			Format[ 2 ];
 		volatile int			CurrentIndex;
 	};
 
@@ -111,6 +113,16 @@ public:
 	bool				AllowPanoInput() const;
 	ovrMessageQueue &	GetBGMessageQueue() { return BackgroundCommands; }
 
+	// Equirect panos only sample their first mip levels, see LoadRgbaTexture().
+	static const int	PANO_NUM_LEVELS = 3;
+
+	// Texture_None if panos are uploaded uncompressed.
+	eTextureFormat		GetPanoCompression() const							{ return PanoCompression; }
+	// Read on the GL thread at init, so FileLoader can size the images it compresses.
+	int					GetMaxTextureSize( const bool cubeMap ) const		{ return cubeMap ? MaxCubeMapTextureSize : MaxTextureSize; }
+	ovrTextureEncodeQuality	GetPanoCompressionQuality() const				{ return PanoCompressionQuality; }
+	ovrTextureEncoder &	GetTextureEncoder()									{ return TextureEncoder; }
+
 	class ovrLocale &	GetLocale() { return *Locale; }
 	
 private:
@@ -124,6 +136,8 @@ private:
 	bool 				LoadMetaData( const char * metaFile );
 	void				LoadRgbaCubeMap( const int resolution, const unsigned char * const rgba[ 6 ], const bool useSrgbFormat );
 	void				LoadRgbaTexture( const unsigned char * data, int width, int height, const bool useSrgbFormat );
+	void				LoadCompressedCubeMap( const ovrDecodedTexture * const faces[ 6 ] );
+	void				LoadCompressedTexture( const ovrDecodedTexture & texture );
 
 private:
 	ovrSoundEffectContext * SoundEffectContext;
@@ -167,6 +181,13 @@ private:
 	float				BrowserOpenTime;
 
 	bool				UseSrgb;
+
+	// Decoded panos are compressed by FileLoader before they are uploaded.
+	eTextureFormat			PanoCompression;
+	ovrTextureEncodeQuality	PanoCompressionQuality;
+	ovrTextureEncoder		TextureEncoder;
+	int						MaxTextureSize;
+	int						MaxCubeMapTextureSize;
 	
 	// Background texture commands produced by FileLoader consumed by BackgroundGLLoadThread
 	ovrMessageQueue		BackgroundCommands;
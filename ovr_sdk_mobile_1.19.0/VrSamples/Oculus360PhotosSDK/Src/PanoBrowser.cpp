@@ -406,7 +406,8 @@ unsigned char * PanoBrowser::CreateAndCacheThumbnail( const char * soureFile, co
 	}
 	else
 	{
-		data = TurboJpegLoadFromFile( soureFile, &width, &height );
+		// decode with the DCT scaled down as far as possible, the sampling below is the same
+		data = TurboJpegLoadScaledFromFile( soureFile, GetThumbWidth(), GetThumbHeight(), &width, &height );
 	}
 
 	if ( !data )
@@ -457,7 +458,50 @@ unsigned char * PanoBrowser::CreateAndCacheThumbnail( const char * soureFile, co
 
 unsigned char * PanoBrowser::LoadThumbnail( const char * filename, int & width, int & height )
 {
-	return TurboJpegLoadFromFile( filename, &width, &height );
+	return LoadJpegThumbnail( filename, width, height );
+}
+
+unsigned char * PanoBrowser::LoadJpegThumbnail( const char * filename, int & width, int & height )
+{
+	const int thumbWidth = GetThumbWidth();
+	const int thumbHeight = GetThumbHeight();
+
+	const uint64_t key = OvrThumbnailCache::CalculateKey( filename );
+	if ( key != 0 )
+	{
+		unsigned char * cached = ThumbnailCache.Find( key, width, height );
+		if ( cached != NULL )
+		{
+			if ( width == thumbWidth && height == thumbHeight )
+			{
+				return cached;
+			}
+			free( cached );
+		}
+	}
+
+	// decode with the DCT scaled down as far as possible, so the final resize is cheap
+	unsigned char * data = TurboJpegLoadScaledFromFile( filename, thumbWidth, thumbHeight, &width, &height );
+	if ( data == NULL )
+	{
+		return NULL;
+	}
+
+	if ( ( width != thumbWidth || height != thumbHeight ) && width >= thumbWidth && height >= thumbHeight )
+	{
+		unsigned char * outBuffer = ScaleImageRGBA( data, width, height, thumbWidth, thumbHeight, IMAGE_FILTER_CUBIC );
+		free( data );
+		if ( outBuffer == NULL )
+		{
+			return NULL;
+		}
+		data = outBuffer;
+		width = thumbWidth;
+		height = thumbHeight;
+	}
+
+	ThumbnailCache.Add( key, data, width, height );
+	return data;
 }
 
 String PanoBrowser::ThumbName( const String & s )
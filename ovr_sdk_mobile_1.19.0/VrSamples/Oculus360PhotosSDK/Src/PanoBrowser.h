@@ -105,6 +105,10 @@ private:
 		
 	Oculus360Photos &		Photos;
 
+	// Returns the thumbnail of a JPEG from the thumbnail cache, or decodes it close to the
+	// thumbnail size, resizes it and adds it to the cache.
+	unsigned char *			LoadJpegThumbnail( const char * filename, int & width, int & height );
+
 	// Favorites buffer - this is built by PanoMenu and used to rebuild Favorite's menu
 	// if an item in it is null, it's been deleted from favorites
 	struct Favorite
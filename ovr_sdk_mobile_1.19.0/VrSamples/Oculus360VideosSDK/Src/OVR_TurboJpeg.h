@@ -26,5 +26,13 @@ unsigned char * TurboJpegLoadFromMemory( const unsigned char * jpg, const int le
 
 unsigned char * TurboJpegLoadFromFile( const char * filename, int * width, int * height );
 
+// Decodes with the DCT scaled down by 1/2, 1/4 or 1/8, picking the smallest scale that is
+// still at least minWidth x minHeight, which is much faster than decoding at full size and
+// then shrinking the image, for thumbnails.
+unsigned char * TurboJpegLoadScaledFromMemory( const unsigned char * jpg, const int length, const int minWidth, const int minHeight,
+		int * width, int * height );
+
+unsigned char * TurboJpegLoadScaledFromFile( const char * filename, const int minWidth, const int minHeight, int * width, int * height );
+
 }
 #endif // OVR_TJUTIL_H_
@@ -55,12 +55,54 @@ void VideoBrowser::OnPanelActivated( OvrGuiSys & guiSys, const OvrMetaDatum * pa
 
 unsigned char * VideoBrowser::CreateAndCacheThumbnail( const char * soureFile, const char * cacheDestinationFile, int & outW, int & outH )
 {
-	// TODO
-	OVR_UNUSED( soureFile );
+	// the thumbnail cache keeps the thumbnail, so nothing is written next to the app cache path
 	OVR_UNUSED( cacheDestinationFile );
-	OVR_UNUSED( outW );
-	OVR_UNUSED( outH );
-	return NULL;
+	return LoadJpegThumbnail( soureFile, outW, outH );
+}
+
+unsigned char * VideoBrowser::LoadJpegThumbnail( const char * filename, int & width, int & height )
+{
+	const int thumbWidth = GetThumbWidth();
+	const int thumbHeight = GetThumbHeight();
+
+	const uint64_t key = OvrThumbnailCache::CalculateKey( filename );
+	if ( key != 0 )
+	{
+		unsigned char * cached = ThumbnailCache.Find( key, width, height );
+		if ( cached != NULL )
+		{
+			if ( width == thumbWidth && height == thumbHeight )
+			{
+				return cached;
+			}
+			free( cached );
+		}
+	}
+
+	// decode with the DCT scaled down as far as possible, so the final resize is cheap
+	unsigned char * orig = TurboJpegLoadScaledFromFile( filename, thumbWidth, thumbHeight, &width, &height );
+	if ( orig == NULL )
+	{
+		OVR_LOG( "Error: VideoBrowser::LoadJpegThumbnail failed to load %s", filename );
+		return NULL;
+	}
+
+	if ( width != thumbWidth || height != thumbHeight )
+	{
+		OVR_LOG( "VideoBrowser::LoadJpegThumbnail resizing %s from %ix%i to %ix%i", filename, width, height, thumbWidth, thumbHeight );
+		unsigned char * outBuffer = ScaleImageRGBA( ( const unsigned char * )orig, width, height, thumbWidth, thumbHeight, IMAGE_FILTER_CUBIC );
+		free( orig );
+		if ( outBuffer == NULL )
+		{
+			return NULL;
+		}
+		orig = outBuffer;
+		width = thumbWidth;
+		height = thumbHeight;
+	}
+
+	ThumbnailCache.Add( key, orig, width, height );
+	return orig;
 }
 
 unsigned char * VideoBrowser::LoadThumbnail( const char * filename, int & width, int & height )
@@ -76,7 +118,8 @@ unsigned char * VideoBrowser::LoadThumbnail( const char * filename, int & width,
 
 		if ( buffer )
 		{
-			orig = TurboJpegLoadFromMemory( reinterpret_cast< const unsigned char * >( buffer ), length, &width, &height );
+			orig = TurboJpegLoadScaledFromMemory( reinterpret_cast< const unsigned char * >( buffer ), length,
+					GetThumbWidth(), GetThumbHeight(), &width, &height );
 			free( buffer );
 		}
 	}
@@ -86,7 +129,7 @@ unsigned char * VideoBrowser::LoadThumbnail( const char * filename, int & width,
 	}
 	else
 	{
-		orig = TurboJpegLoadFromFile( filename, &width, &height );
+		return LoadJpegThumbnail( filename, width, height );
 	}
 
 	if ( orig )
@@ -44,8 +44,8 @@ public:
 
 	// Called on a background thread
 	//
-	// Create the thumbnail image for the file, which will
-	// be saved out as a _thumb.jpg.
+	// Create the thumbnail image for the file, which is
+	// kept in the thumbnail cache.
 	virtual unsigned char * CreateAndCacheThumbnail( const char * soureFile, const char * cacheDestinationFile, int & width, int & height );
 
 	// Called on a background thread to load thumbnail
@@ -92,6 +92,10 @@ private:
 
 private:
 	Oculus360Videos &	Videos;
+
+	// Returns the thumbnail of a JPEG from the thumbnail cache, or decodes it close to the
+	// thumbnail size, resizes it and adds it to the cache.
+	unsigned char *		LoadJpegThumbnail( const char * filename, int & width, int & height );
 };
 
 }
@@ -68,7 +68,7 @@ void ovrBeamRenderer::Init( const int maxBeams, const bool depthTest )
 
 	MaxBeams = maxBeams;
 
-	if ( LineProgram.VertexShader == 0 || LineProgram.FragmentShader == 0 )
+	if ( !LineProgram.IsValid() )
 	{
 		LineProgram = BuildProgram( DebugLineVertexSrc, DebugLineFragmentSrc );
 	}
@@ -14,6 +14,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "GlTexture.h"
 #include "VrCommon.h"
 
+#include <stddef.h>
+
 namespace OVR {
 
 static const char* ribbonVertexShader = R"=====(
@@ -40,6 +42,36 @@ static const char* ribbonFragmentShader = R"=====(
 		//gl_FragColor = outColor;
 	}
 )=====";
+static const char* trailVertexShader = R"=====(
+	attribute highp vec4 Position;
+	attribute highp vec3 Normal;
+	attribute lowp vec4 VertexColor;
+	attribute highp vec2 TexCoord;
+	uniform highp vec4 TrailParms;
+	varying lowp vec4 outColor;
+	varying highp vec2 oTexCoord;
+	vec3 transposeMultiply( mat4 m, vec3 v )
+	{
+		return vec3(
+			m[0].x * v.x + m[0].y * v.y + m[0].z * v.z,
+			m[1].x * v.x + m[1].y * v.y + m[1].z * v.z,
+			m[2].x * v.x + m[2].y * v.y + m[2].z * v.z );
+	}
+	void main()
+	{
+		// TrailParms.x is the time, y is one over the life time and z is the half width.
+		// TexCoord.x is the time the point was added and TexCoord.y the side of the trail.
+		highp float alpha = 1.0 - clamp( ( TrailParms.x - TexCoord.x ) * TrailParms.y, 0.0, 1.0 );
+		// the edge is perpendicular to the trail and to the direction to the eye, the model matrix is identity
+		highp vec3 eye = transposeMultiply( sm.ViewMatrix[VIEW_ID], -vec3( sm.ViewMatrix[VIEW_ID][3] ) );
+		highp vec3 edge = cross( eye - Position.xyz, Normal );
+		edge *= inversesqrt( max( dot( edge, edge ), 1e-12 ) );
+		gl_Position = TransformVertex( vec4( Position.xyz + edge * ( TexCoord.y * TrailParms.z * alpha ), 1.0 ) );
+		oTexCoord = vec2( 0.0, 0.5 - 0.5 * TexCoord.y );
+		outColor = vec4( VertexColor.rgb, VertexColor.a * alpha );
+	}
+)=====";
+
 //==============================================================================================
 // ovrRibbon
 
@@ -277,4 +309,405 @@ void ovrRibbon::GenerateSurfaceList( Array< ovrDrawSurface > & surfaceList ) con
 	surfaceList.PushBack( drawSurf );
 }
 
+//==============================================================================================
+// ovrTrailBatch
+
+// time of points that are never drawn, so that they fade out at any time
+static const float DEAD_POINT_TIME = -1.0e30f;
+// dirty vertices that are at most this far apart are uploaded with one call
+static const int MAX_UPLOAD_GAP_VERTICES = 64;
+
+static uint32_t PackTrailColor( const Vector4f & color )
+{
+	auto toByte = []( const float f ) { return (uint32_t)( Alg::Clamp( f, 0.0f, 1.0f ) * 255.0f + 0.5f ); };
+	return toByte( color.x ) | ( toByte( color.y ) << 8 ) | ( toByte( color.z ) << 16 ) | ( toByte( color.w ) << 24 );
+}
+
+ovrTrailBatch::ovrTrailBatch( const int maxTrails, const int maxPointsPerTrail, const float width, const float lifeTimeInSeconds )
+	: MaxTrails( maxTrails )
+	, NumSlots( maxPointsPerTrail + 2 )
+	, TrailsPerPage( 0 )
+	, HalfWidth( width )
+	, LifeTime( lifeTimeInSeconds )
+	, BoundsPeriod( lifeTimeInSeconds / ( NUM_BOUNDS_PERIODS - 1 ) )
+	, BaseTime( -1.0 )
+	, TrailParms( 0.0f, 1.0f / lifeTimeInSeconds, width, 0.0f )
+	, LastUpdateVertices( 0 )
+{
+	OVR_ASSERT( NumSlots * 2 <= GlGeometry::MAX_GEOMETRY_VERTICES );
+	TrailsPerPage = Alg::Min( maxTrails, GlGeometry::MAX_GEOMETRY_VERTICES / ( NumSlots * 2 ) );
+
+	Trails.Reserve( maxTrails );
+
+	Texture = CreateRibbonTexture();
+
+	ovrProgramParm parms[] =
+	{
+		{ "Texture0",		ovrProgramParmType::TEXTURE_SAMPLED },
+		{ "TrailParms",		ovrProgramParmType::FLOAT_VECTOR4 },
+	};
+
+	Program = GlProgram::Build( trailVertexShader, ribbonFragmentShader, &parms[0], sizeof( parms ) / sizeof( ovrProgramParm ) );
+	if ( !Program.IsValid() )
+	{
+		OVR_LOG( "Error building trail gpu program" );
+	}
+}
+
+ovrTrailBatch::~ovrTrailBatch()
+{
+	for ( int i = 0; i < Pages.GetSizeI(); i++ )
+	{
+		Pages[i]->Surface.geo.Free();
+		delete Pages[i];
+	}
+	Pages.Clear();
+	DeleteTexture( Texture );
+	GlProgram::Free( Program );
+}
+
+int ovrTrailBatch::AddTrail( const Vector4f & color )
+{
+	if ( Trails.GetSizeI() >= MaxTrails )
+	{
+		return -1;
+	}
+
+	const int trail = Trails.GetSizeI();
+	const int firstTrailInPage = trail % TrailsPerPage;
+	if ( firstTrailInPage == 0 )
+	{
+		// every trail of a page is drawn, so all of them are in the buffers from the start
+		const int numTrails = Alg::Min( TrailsPerPage, MaxTrails - trail );
+		const int numVertices = numTrails * NumSlots * 2;
+		const int numIndices = numTrails * NumSlots * 6;
+
+		ovrTrailVertex deadVertex;
+		deadVertex.Position = Vector3f( 0.0f );
+		deadVertex.Direction = Vector3f( 0.0f );
+		deadVertex.Color = 0;
+		deadVertex.Time = DEAD_POINT_TIME;
+		deadVertex.Side = 1.0f;
+		const int firstVertex = Vertices.GetSizeI();
+		Vertices.Resize( firstVertex + numVertices );
+		for ( int i = 0; i < numVertices; i++ )
+		{
+			Vertices[firstVertex + i] = deadVertex;
+			Vertices[firstVertex + i].Side = ( i & 1 ) ? -1.0f : 1.0f;
+		}
+
+		// a quad from every slot to the next one in the ring, the separators collapse the
+		// quads between the newest and the oldest point
+		Array< TriangleIndex > indices;
+		indices.Resize( numIndices );
+		for ( int t = 0; t < numTrails; t++ )
+		{
+			for ( int slot = 0; slot < NumSlots; slot++ )
+			{
+				const int v0 = ( t * NumSlots + slot ) * 2;
+				const int v2 = ( t * NumSlots + ( slot + 1 ) % NumSlots ) * 2;
+				TriangleIndex * tri = &indices[( t * NumSlots + slot ) * 6];
+				tri[0] = (TriangleIndex)( v0 + 0 );
+				tri[1] = (TriangleIndex)( v0 + 1 );
+				tri[2] = (TriangleIndex)( v2 + 0 );
+				tri[3] = (TriangleIndex)( v2 + 0 );
+				tri[4] = (TriangleIndex)( v0 + 1 );
+				tri[5] = (TriangleIndex)( v2 + 1 );
+			}
+		}
+
+		ovrTrailPage * page = new ovrTrailPage();
+		page->NumTrails = 0;
+		for ( int i = 0; i < NUM_BOUNDS_PERIODS; i++ )
+		{
+			page->PeriodBounds[i].Clear();
+			page->Periods[i] = -1;
+		}
+		GlGeometry & geo = page->Surface.geo;
+		geo.vertexCount = numVertices;
+		geo.indexCount = numIndices;
+		geo.primitiveType = GL_TRIANGLES;
+
+		glGenVertexArrays( 1, &geo.vertexArrayObject );
+		glBindVertexArray( geo.vertexArrayObject );
+
+		glGenBuffers( 1, &geo.vertexBuffer );
+		glBindBuffer( GL_ARRAY_BUFFER, geo.vertexBuffer );
+		glBufferData( GL_ARRAY_BUFFER, numVertices * sizeof( ovrTrailVertex ), &Vertices[firstVertex], GL_DYNAMIC_DRAW );
+
+		glGenBuffers( 1, &geo.indexBuffer );
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, geo.indexBuffer );
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof( TriangleIndex ), indices.GetDataPtr(), GL_STATIC_DRAW );
+
+		glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_POSITION );
+		glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_POSITION, 3, GL_FLOAT, GL_FALSE,
+				sizeof( ovrTrailVertex ), (void *)offsetof( ovrTrailVertex, Position ) );
+
+		glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_NORMAL );
+		glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_NORMAL, 3, GL_FLOAT, GL_FALSE,
+				sizeof( ovrTrailVertex ), (void *)offsetof( ovrTrailVertex, Direction ) );
+
+		glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_COLOR );
+		glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+				sizeof( ovrTrailVertex ), (void *)offsetof( ovrTrailVertex, Color ) );
+
+		glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_UV0 );
+		glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_UV0, 2, GL_FLOAT, GL_FALSE,
+				sizeof( ovrTrailVertex ), (void *)offsetof( ovrTrailVertex, Time ) );
+
+		glBindVertexArray( 0 );
+
+		page->Surface.surfaceName = "trails";
+		page->Surface.numInstances = 1;
+
+		ovrGraphicsCommand & gc = page->Surface.graphicsCommand;
+		gc.Program = Program;
+		gc.UniformData[0].Data = &Texture;
+		gc.UniformData[1].Data = &TrailParms;
+
+		ovrGpuState & gpu = gc.GpuState;
+		gpu.depthEnable = true;
+		gpu.depthMaskEnable = false;
+		gpu.blendEnable = ovrGpuState::BLEND_ENABLE;
+		gpu.blendSrc = GL_SRC_ALPHA;
+		gpu.blendDst = GL_ONE_MINUS_SRC_ALPHA;
+		gpu.blendSrcAlpha = GL_SRC_ALPHA;
+		gpu.blendDstAlpha = GL_ONE_MINUS_SRC_ALPHA;
+		gpu.cullEnable = true;
+
+		Pages.PushBack( page );
+	}
+
+	ovrTrail t;
+	t.Color = PackTrailColor( color );
+	t.Head = NumSlots - 1;
+	t.NumPoints = 0;
+	t.DirtyFirst = 0;
+	t.DirtyCount = 0;
+	Trails.PushBack( t );
+	Pages.Back()->NumTrails++;
+	return trail;
+}
+
+void ovrTrailBatch::ClearTrail( const int trail )
+{
+	ovrTrail & t = Trails[trail];
+	for ( int slot = 0; slot < NumSlots; slot++ )
+	{
+		ovrTrailVertex * v = GetSlot( trail, slot );
+		v[0].Time = DEAD_POINT_TIME;
+		v[1].Time = DEAD_POINT_TIME;
+	}
+	t.Head = NumSlots - 1;
+	t.NumPoints = 0;
+	t.DirtyFirst = 0;
+	t.DirtyCount = NumSlots;
+}
+
+void ovrTrailBatch::WriteSlot( const int trail, const int slot, const Vector3f & position,
+		const Vector3f & direction, const uint32_t color, const float time )
+{
+	ovrTrailVertex * v = GetSlot( trail, slot );
+	for ( int i = 0; i < 2; i++ )
+	{
+		v[i].Position = position;
+		v[i].Direction = direction;
+		v[i].Color = color;
+		v[i].Time = time;
+	}
+}
+
+void ovrTrailBatch::MarkDirty( const int trail, const int first, const int count )
+{
+	ovrTrail & t = Trails[trail];
+	if ( t.DirtyCount == 0 )
+	{
+		t.DirtyFirst = first;
+		t.DirtyCount = count;
+		return;
+	}
+	// slots are written in ring order, so a new range starts in or right after the dirty range
+	const int offset = ( first - t.DirtyFirst + NumSlots ) % NumSlots;
+	if ( offset > t.DirtyCount )
+	{
+		t.DirtyCount = NumSlots;
+		return;
+	}
+	t.DirtyCount = Alg::Min( NumSlots, Alg::Max( t.DirtyCount, offset + count ) );
+}
+
+bool ovrTrailBatch::AddPoint( const int trail, const Vector3f & point, const double timeInSeconds )
+{
+	ovrTrail & t = Trails[trail];
+	const int prev = t.Head;
+	if ( t.NumPoints > 0 && ( point - GetSlot( trail, prev )->Position ).LengthSq() < 0.0001f )
+	{
+		return false;
+	}
+
+	if ( BaseTime < 0.0 )
+	{
+		BaseTime = timeInSeconds;
+	}
+	const float time = (float)( timeInSeconds - BaseTime );
+
+	const int slot = ( prev + 1 ) % NumSlots;
+	const int separator0 = ( slot + 1 ) % NumSlots;
+	const int separator1 = ( slot + 2 ) % NumSlots;
+
+	int firstDirty = slot;
+	Vector3f direction( 0.0f );
+	if ( t.NumPoints == 0 )
+	{
+		// move the unused slots to the first point, so that the quads from them to the live
+		// points have no area until they are written
+		for ( int i = 0; i < NumSlots; i++ )
+		{
+			WriteSlot( trail, i, point, direction, t.Color, DEAD_POINT_TIME );
+		}
+		MarkDirty( trail, 0, NumSlots );
+	}
+	else
+	{
+		// the direction at the previous point is the average of its two segments
+		ovrTrailVertex * p = GetSlot( trail, prev );
+		direction = point - p->Position;
+		const Vector3f prevDirection = ( t.NumPoints > 1 ) ? point - GetSlot( trail, ( prev + NumSlots - 1 ) % NumSlots )->Position : direction;
+		p[0].Direction = prevDirection;
+		p[1].Direction = prevDirection;
+		firstDirty = prev;
+	}
+	WriteSlot( trail, slot, point, direction, t.Color, time );
+
+	// The separators have no width. The first is at the new point and the second is at the
+	// point after it, which is the oldest point once the ring is full, so that the quads between
+	// the newest and the oldest point have no area.
+	WriteSlot( trail, separator0, point, direction, t.Color, DEAD_POINT_TIME );
+	const Vector3f oldest = GetSlot( trail, ( slot + 3 ) % NumSlots )->Position;
+	WriteSlot( trail, separator1, oldest, direction, t.Color, DEAD_POINT_TIME );
+
+	t.Head = slot;
+	t.NumPoints = Alg::Min( t.NumPoints + 1, NumSlots - 2 );
+	MarkDirty( trail, firstDirty, ( separator1 - firstDirty + NumSlots ) % NumSlots + 1 );
+
+	// the point is drawn until Update() drops the bounds of its period
+	ovrTrailPage * page = Pages[trail / TrailsPerPage];
+	const int period = Alg::Max( 0, (int)( time / BoundsPeriod ) );
+	const int periodIndex = period % NUM_BOUNDS_PERIODS;
+	Bounds3f & periodBounds = page->PeriodBounds[periodIndex];
+	if ( page->Periods[periodIndex] != period )
+	{
+		page->Periods[periodIndex] = period;
+		periodBounds.Clear();
+	}
+	const Vector3f pad( HalfWidth );
+	periodBounds.AddPoint( point - pad );
+	periodBounds.AddPoint( point + pad );
+	page->Surface.geo.localBounds = Bounds3f::Union( page->Surface.geo.localBounds, periodBounds );
+	return true;
+}
+
+void ovrTrailBatch::Update( const double timeInSeconds )
+{
+	TrailParms.x = ( BaseTime < 0.0 ) ? 0.0f : (float)( timeInSeconds - BaseTime );
+	LastUpdateVertices = 0;
+
+	// a period is dropped once all of its points are older than the life time
+	const int firstLivePeriod = (int)( TrailParms.x / BoundsPeriod ) - ( NUM_BOUNDS_PERIODS - 1 );
+
+	const int pageVertices = TrailsPerPage * NumSlots * 2;
+	for ( int pageIndex = 0; pageIndex < Pages.GetSizeI(); pageIndex++ )
+	{
+		ovrTrailPage * page = Pages[pageIndex];
+		Bounds3f bounds( Bounds3f::Init );
+		for ( int i = 0; i < NUM_BOUNDS_PERIODS; i++ )
+		{
+			if ( page->Periods[i] >= 0 && page->Periods[i] >= firstLivePeriod )
+			{
+				bounds = Bounds3f::Union( bounds, page->PeriodBounds[i] );
+			}
+		}
+		page->Surface.geo.localBounds = bounds;
+
+		const int firstTrail = pageIndex * TrailsPerPage;
+		const ovrTrailVertex * pageBase = &Vertices[pageIndex * pageVertices];
+
+		// merge the dirty ranges of the page's trails, which are in vertex order
+		int rangeStart = -1;
+		int rangeEnd = -1;
+		bool bound = false;
+		auto flushRange = [&]()
+		{
+			if ( rangeStart < 0 )
+			{
+				return;
+			}
+			if ( !bound )
+			{
+				glBindBuffer( GL_ARRAY_BUFFER, page->Surface.geo.vertexBuffer );
+				bound = true;
+			}
+			glBufferSubData( GL_ARRAY_BUFFER, rangeStart * sizeof( ovrTrailVertex ),
+					( rangeEnd - rangeStart ) * sizeof( ovrTrailVertex ), pageBase + rangeStart );
+			LastUpdateVertices += rangeEnd - rangeStart;
+			rangeStart = -1;
+		};
+		auto addRange = [&]( const int start, const int end )
+		{
+			if ( rangeStart >= 0 && start - rangeEnd <= MAX_UPLOAD_GAP_VERTICES )
+			{
+				rangeEnd = end;
+				return;
+			}
+			flushRange();
+			rangeStart = start;
+			rangeEnd = end;
+		};
+
+		for ( int i = 0; i < page->NumTrails; i++ )
+		{
+			ovrTrail & t = Trails[firstTrail + i];
+			if ( t.DirtyCount == 0 )
+			{
+				continue;
+			}
+			const int trailVertex = i * NumSlots * 2;
+			const int last = t.DirtyFirst + t.DirtyCount;
+			if ( last > NumSlots )
+			{
+				// the range wraps around the end of the ring
+				addRange( trailVertex, trailVertex + ( last - NumSlots ) * 2 );
+				addRange( trailVertex + t.DirtyFirst * 2, trailVertex + NumSlots * 2 );
+			}
+			else
+			{
+				addRange( trailVertex + t.DirtyFirst * 2, trailVertex + last * 2 );
+			}
+			t.DirtyCount = 0;
+		}
+		flushRange();
+		if ( bound )
+		{
+			glBindBuffer( GL_ARRAY_BUFFER, 0 );
+		}
+	}
+}
+
+void ovrTrailBatch::GenerateSurfaceList( Array< ovrDrawSurface > & surfaceList ) const
+{
+	for ( int i = 0; i < Pages.GetSizeI(); i++ )
+	{
+		// pages without points have empty bounds
+		if ( Pages[i]->Surface.geo.localBounds.GetMins().x > Pages[i]->Surface.geo.localBounds.GetMaxs().x )
+		{
+			continue;
+		}
+
+		ovrDrawSurface drawSurf;
+		drawSurf.modelMatrix = Matrix4f::Identity();
+		drawSurf.surface = &Pages[i]->Surface;
+		surfaceList.PushBack( drawSurf );
+	}
+}
+
 } // namespace OVR
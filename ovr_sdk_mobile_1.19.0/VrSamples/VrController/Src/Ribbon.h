@@ -35,4 +35,95 @@ private:
 	GlTexture						Texture;
 };
 
+//==============================================================
+// ovrTrailBatch
+// Draws many trails that only grow at their end, such as the paths left by moving objects.
+// Unlike ovrRibbon, which rebuilds all of its vertices every frame, each trail keeps its
+// points in a ring of vertices that stays in a vertex buffer. Adding a point writes the new
+// point, the direction of the point before it and two separator points that cut the ring
+// between the newest and the oldest point, and the oldest point is overwritten once the
+// ring is full. Only the vertices written since the last Update() are uploaded.
+//
+// Each point is stored twice with the direction of the trail and the time it was added;
+// the vertex shader faces the edges to the eye and fades and narrows points out with age,
+// so nothing needs to be rewritten when the view moves. All trails are drawn with one surface
+// for every page of trails that fits in 16 bit indices.
+//
+// The bounds of a page are the union of the bounds of the points added in each of the last
+// few periods of the life time, so they shrink once the points of a period have faded out.
+class ovrTrailBatch
+{
+public:
+	ovrTrailBatch( const int maxTrails, const int maxPointsPerTrail, const float width, const float lifeTimeInSeconds );
+	~ovrTrailBatch();
+
+	// Returns the trail's index, or -1 if there are already maxTrails trails.
+	int			AddTrail( const Vector4f & color );
+	// Removes all of the trail's points.
+	void		ClearTrail( const int trail );
+	// Points closer than 1 cm to the last point are skipped, as with ovrRibbon::AddPoint().
+	bool		AddPoint( const int trail, const Vector3f & point, const double timeInSeconds );
+	// Uploads the points added since the last update. Call once per frame on the GL thread.
+	void		Update( const double timeInSeconds );
+	void		GenerateSurfaceList( Array< ovrDrawSurface > & surfaceList ) const;
+
+	int			GetNumTrails() const { return Trails.GetSizeI(); }
+	int			GetNumPages() const { return Pages.GetSizeI(); }
+	int			GetTrailPage( const int trail ) const { return trail / TrailsPerPage; }
+	// Vertices uploaded by the last Update().
+	int			GetLastUpdateVertices() const { return LastUpdateVertices; }
+	// Covers the points of the page's trails that have not faded out as of the last Update().
+	const Bounds3f &	GetPageBounds( const int page ) const { return Pages[page]->Surface.geo.localBounds; }
+
+private:
+	struct ovrTrailVertex
+	{
+		Vector3f	Position;
+		Vector3f	Direction;	// of the trail at this point, zero for the first point
+		uint32_t	Color;
+		float		Time;		// time the point was added, relative to BaseTime
+		float		Side;		// 1 or -1
+	};
+
+	struct ovrTrail
+	{
+		uint32_t	Color;
+		int			Head;		// slot of the newest point
+		int			NumPoints;
+		int			DirtyFirst;	// first slot written since the last update
+		int			DirtyCount;
+	};
+
+	static const int NUM_BOUNDS_PERIODS = 8;
+
+	struct ovrTrailPage
+	{
+		ovrSurfaceDef	Surface;
+		int				NumTrails;	// trails added to this page
+		Bounds3f		PeriodBounds[NUM_BOUNDS_PERIODS];	// of the points added in each period
+		int				Periods[NUM_BOUNDS_PERIODS];		// period that PeriodBounds holds, -1 if none
+	};
+
+	int							MaxTrails;
+	int							NumSlots;	// maxPointsPerTrail plus the two separator slots
+	int							TrailsPerPage;
+	float						HalfWidth;
+	float						LifeTime;
+	float						BoundsPeriod;	// NUM_BOUNDS_PERIODS - 1 periods make up the life time
+	double						BaseTime;
+	Vector4f					TrailParms;
+	int							LastUpdateVertices;
+
+	Array< ovrTrailVertex >		Vertices;	// two per slot for every trail
+	Array< ovrTrail >			Trails;
+	Array< ovrTrailPage * >		Pages;
+	GlProgram					Program;
+	GlTexture					Texture;
+
+	ovrTrailVertex *			GetSlot( const int trail, const int slot ) { return &Vertices[( trail * NumSlots + slot ) * 2]; }
+	void						WriteSlot( const int trail, const int slot, const Vector3f & position,
+									const Vector3f & direction, const uint32_t color, const float time );
+	void						MarkDirty( const int trail, const int first, const int count );
+};
+
 } // namespace OVR
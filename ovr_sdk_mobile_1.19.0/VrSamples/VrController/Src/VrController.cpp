@@ -429,11 +429,18 @@ static void UpdateRibbon( ovrPointList & points, ovrPointList & velocities, cons
 
 //==============================
 // ovrControllerRibbon::ovrControllerRibbon
-ovrControllerRibbon::ovrControllerRibbon( const int numPoints, const float width, const float length, const Vector4f & color )
+ovrControllerRibbon::ovrControllerRibbon( const int numPoints, const float width, const float length, const Vector4f & color,
+		ovrTrailBatch * trailBatch )
 	: NumPoints( numPoints )
 	, Length( length )
 {
 #if defined( PERSISTENT_RIBBONS )
+	if ( trailBatch != nullptr )
+	{
+		TrailBatch = trailBatch;
+		Trail = trailBatch->AddTrail( color );
+		return;
+	}
 	Points = new ovrPointList_Circular( numPoints );
 #else
 	Points = new ovrPointList_Vector( numPoints );
@@ -461,8 +468,14 @@ ovrControllerRibbon::~ovrControllerRibbon()
 
 //==============================
 // ovrControllerRibbon::Update
-void ovrControllerRibbon::Update( const Matrix4f & centerViewMatrix, const Vector3f & anchorPos, const float deltaSeconds )
+void ovrControllerRibbon::Update( const Matrix4f & centerViewMatrix, const Vector3f & anchorPos, const float deltaSeconds,
+		const double timeInSeconds )
 {
+	if ( TrailBatch != nullptr )
+	{
+		TrailBatch->AddPoint( Trail, anchorPos, timeInSeconds );
+		return;
+	}
 	OVR_ASSERT( Points != nullptr );
 #if defined( PERSISTENT_RIBBONS )
 	if ( Points->GetCurPoints() == 0 )
@@ -511,6 +524,7 @@ ovrVrController::ovrVrController()
 	, ControllerModelOculusTouchRight( nullptr )
 	, LastGamepadUpdateTimeInSeconds( 0 )
 	, Ribbons{ nullptr, nullptr }
+	, RibbonTrails( nullptr )
 {
 }
 
@@ -523,6 +537,8 @@ ovrVrController::~ovrVrController()
 		delete Ribbons[i];
 		Ribbons[i] = nullptr;
 	}
+	delete RibbonTrails;
+	RibbonTrails = nullptr;
 
 	delete ControllerModelGear;
 	ControllerModelGear = nullptr;
@@ -822,9 +838,13 @@ void ovrVrController::EnteredVrMode( const ovrIntentType intentType, const char
 
 		//------------------------------------------------------------------------------------------
 
+#if defined( PERSISTENT_RIBBONS )
+		// persistent ribbons only grow at their end, so both are trails in one batch
+		RibbonTrails = new ovrTrailBatch( ovrArmModel::HAND_MAX, NUM_RIBBON_POINTS, 0.025f, 60.0f );
+#endif
 		for ( int i = 0; i < ovrArmModel::HAND_MAX; ++i )
 		{
-			Ribbons[i] = new ovrControllerRibbon( NUM_RIBBON_POINTS, 0.025f, 1.0f, Vector4f( 0.0f, 0.5f, 1.0f, 1.0f ) );
+			Ribbons[i] = new ovrControllerRibbon( NUM_RIBBON_POINTS, 0.025f, 1.0f, Vector4f( 0.0f, 0.5f, 1.0f, 1.0f ), RibbonTrails );
 		}
 
 		//------------------------------------------------------------------------------------------
@@ -1421,10 +1441,14 @@ ovrFrameResult ovrVrController::Frame( const ovrFrameInput & vrFrame )
 			{
 				Ribbons[trDevice.GetHand()]->Update( res.FrameMatrices.CenterView,
 					ovrMatrix4f_GetTranslation( mat ),
-					vrFrame.DeltaSeconds );
+					vrFrame.DeltaSeconds, vrFrame.PredictedDisplayTimeInSeconds );
 			}
 		}
 	}
+	if ( RibbonTrails != nullptr )
+	{
+		RibbonTrails->Update( vrFrame.PredictedDisplayTimeInSeconds );
+	}
 	//------------------------------------------------------------------------------------------
 
 #if 0
@@ -1544,11 +1568,15 @@ ovrFrameResult ovrVrController::Frame( const ovrFrameInput & vrFrame )
 			}
 		}
 		
-		if ( Ribbons[trDevice.GetHand()] != nullptr )
+		if ( Ribbons[trDevice.GetHand()] != nullptr && Ribbons[trDevice.GetHand()]->Ribbon != nullptr )
 		{
 			Ribbons[trDevice.GetHand()]->Ribbon->GenerateSurfaceList( res.Surfaces );
 		}		
 	}
+	if ( RibbonTrails != nullptr )
+	{
+		RibbonTrails->GenerateSurfaceList( res.Surfaces );
+	}
 
 	const Matrix4f projectionMatrix;
 	ParticleSystem->RenderEyeView( res.FrameMatrices.CenterView, projectionMatrix, res.Surfaces );
@@ -174,14 +174,19 @@ class ovrControllerRibbon
 {
 public:
 	ovrControllerRibbon() = delete;
-	ovrControllerRibbon( const int numPoints, const float width, const float length, const Vector4f & color );
+	// If trailBatch is not null the ribbon is a trail in the batch, which draws it.
+	ovrControllerRibbon( const int numPoints, const float width, const float length, const Vector4f & color,
+			ovrTrailBatch * trailBatch );
 	~ovrControllerRibbon();
 
-	void Update( const Matrix4f & centerViewMatrix, const Vector3f & anchorPoint, const float deltaSeconds );
+	void Update( const Matrix4f & centerViewMatrix, const Vector3f & anchorPoint, const float deltaSeconds,
+			const double timeInSeconds );
 
 	ovrRibbon *		Ribbon = nullptr;
 	ovrPointList *	Points = nullptr;
 	ovrPointList *	Velocities = nullptr;
+	ovrTrailBatch *	TrailBatch = nullptr;
+	int				Trail = -1;
 	int 			NumPoints = 0;
 	float 			Length = 1.0f;
 };
@@ -256,6 +261,7 @@ private:
 	std::vector< ovrInputDeviceBase* >	InputDevices;
 
 	ovrControllerRibbon *		Ribbons[ovrArmModel::HAND_MAX];
+	ovrTrailBatch *				RibbonTrails;
 
 private:
 	void					ClearAndHideMenuItems();
@@ -7,8 +7,10 @@ LOCAL_PATH:= $(call my-dir)
 include $(CLEAR_VARS)
 
 LOCAL_MODULE			:= vrcubeworld
+LOCAL_ARM_NEON			:= true				# compile with neon support enabled
 LOCAL_CFLAGS			:= -std=c99 -Werror
-LOCAL_SRC_FILES			:= ../../../Src/VrCubeWorld_SurfaceView.c
+LOCAL_SRC_FILES			:= ../../../Src/VrCubeWorld_SurfaceView.c \
+						   ../../../Src/VrCubeWorld_Instances.c
 LOCAL_LDLIBS			:= -llog -landroid -lGLESv3 -lEGL		# include default libraries
 
 LOCAL_SHARED_LIBRARIES	:= vrapi
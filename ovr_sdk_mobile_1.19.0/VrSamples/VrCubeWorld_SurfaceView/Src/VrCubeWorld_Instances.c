@@ -0,0 +1,446 @@
+/************************************************************************************
+
+Filename	:	VrCubeWorld_Instances.c
+Content		:	Computes the instance transforms of the cube world, four instances at a
+				time with SSE2 or NEON, on a pool of worker threads.
+Created		:	10/18/2026
+Authors		:
+
+Copyright	:	Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "VrCubeWorld_Instances.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>					// for prctl( PR_SET_NAME )
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define INSTANCES_SSE2
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#include <arm_neon.h>
+#define INSTANCES_NEON
+#endif
+
+/*
+================================================================================
+
+Sine and Cosine
+
+The range is reduced to [-pi/4, pi/4] with pi/2 split in three parts, and the
+polynomials are the ones of the Cephes sinf() and cosf(). The error is within a
+few ulps for the angles of the sample, and the vector versions do the same
+operations in the same order as the scalar one.
+
+================================================================================
+*/
+
+static const float SINCOS_ROUND		= 12582912.0f;		// 1.5 * 2^23, adding it leaves the rounded integer in the low mantissa bits
+static const float SINCOS_TWO_OVER_PI	= 0.636619772367581343f;
+static const float SINCOS_PIO2_1	= 1.5703125f;
+static const float SINCOS_PIO2_2	= 4.837512969970703125e-4f;
+static const float SINCOS_PIO2_3	= 7.54978995489188216e-8f;
+static const float SINCOS_S1		= -1.6666654611e-1f;
+static const float SINCOS_S2		= 8.3321608736e-3f;
+static const float SINCOS_S3		= -1.9515295891e-4f;
+static const float SINCOS_C1		= 4.166664568298827e-2f;
+static const float SINCOS_C2		= -1.388731625493765e-3f;
+static const float SINCOS_C3		= 2.443315711809948e-5f;
+
+static void SinCos( const float x, float * outSin, float * outCos )
+{
+	union { float f; int32_t i; } t;
+	t.f = x * SINCOS_TWO_OVER_PI + SINCOS_ROUND;
+	const int32_t quadrant = t.i;
+	const float n = t.f - SINCOS_ROUND;
+	const float r = ( ( x - n * SINCOS_PIO2_1 ) - n * SINCOS_PIO2_2 ) - n * SINCOS_PIO2_3;
+	const float r2 = r * r;
+	const float s = r + r * r2 * ( SINCOS_S1 + r2 * ( SINCOS_S2 + r2 * SINCOS_S3 ) );
+	const float c = ( 1.0f - 0.5f * r2 ) + r2 * r2 * ( SINCOS_C1 + r2 * ( SINCOS_C2 + r2 * SINCOS_C3 ) );
+	const float sinValue = ( quadrant & 1 ) ? c : s;
+	const float cosValue = ( quadrant & 1 ) ? s : c;
+	*outSin = ( quadrant & 2 ) ? -sinValue : sinValue;
+	*outCos = ( ( quadrant + 1 ) & 2 ) ? -cosValue : cosValue;
+}
+
+#if defined( INSTANCES_SSE2 )
+
+typedef __m128	ovrFloat4;
+typedef __m128i	ovrInt4;
+
+static inline ovrFloat4 Float4_Load( const float * p ) { return _mm_loadu_ps( p ); }
+static inline ovrFloat4 Float4_Set( const float x ) { return _mm_set1_ps( x ); }
+static inline ovrFloat4 Float4_Add( const ovrFloat4 a, const ovrFloat4 b ) { return _mm_add_ps( a, b ); }
+static inline ovrFloat4 Float4_Sub( const ovrFloat4 a, const ovrFloat4 b ) { return _mm_sub_ps( a, b ); }
+static inline ovrFloat4 Float4_Mul( const ovrFloat4 a, const ovrFloat4 b ) { return _mm_mul_ps( a, b ); }
+static inline ovrInt4 Float4_AsInt( const ovrFloat4 a ) { return _mm_castps_si128( a ); }
+static inline ovrFloat4 Int4_AsFloat( const ovrInt4 a ) { return _mm_castsi128_ps( a ); }
+static inline ovrInt4 Int4_Set( const int32_t x ) { return _mm_set1_epi32( x ); }
+static inline ovrInt4 Int4_And( const ovrInt4 a, const ovrInt4 b ) { return _mm_and_si128( a, b ); }
+static inline ovrInt4 Int4_Xor( const ovrInt4 a, const ovrInt4 b ) { return _mm_xor_si128( a, b ); }
+static inline ovrInt4 Int4_Add( const ovrInt4 a, const ovrInt4 b ) { return _mm_add_epi32( a, b ); }
+static inline ovrInt4 Int4_ShiftLeft30( const ovrInt4 a ) { return _mm_slli_epi32( a, 30 ); }
+static inline ovrInt4 Int4_Equal( const ovrInt4 a, const ovrInt4 b ) { return _mm_cmpeq_epi32( a, b ); }
+// Returns a where the mask is set and b elsewhere.
+static inline ovrFloat4 Float4_Select( const ovrInt4 mask, const ovrFloat4 a, const ovrFloat4 b )
+{
+	return _mm_or_ps( _mm_and_ps( _mm_castsi128_ps( mask ), a ), _mm_andnot_ps( _mm_castsi128_ps( mask ), b ) );
+}
+static inline void Float4_Transpose( ovrFloat4 * r0, ovrFloat4 * r1, ovrFloat4 * r2, ovrFloat4 * r3 )
+{
+	_MM_TRANSPOSE4_PS( *r0, *r1, *r2, *r3 );
+}
+static inline void Float4_Store( float * p, const ovrFloat4 a ) { _mm_storeu_ps( p, a ); }
+
+#elif defined( INSTANCES_NEON )
+
+typedef float32x4_t	ovrFloat4;
+typedef int32x4_t	ovrInt4;
+
+static inline ovrFloat4 Float4_Load( const float * p ) { return vld1q_f32( p ); }
+static inline ovrFloat4 Float4_Set( const float x ) { return vdupq_n_f32( x ); }
+static inline ovrFloat4 Float4_Add( const ovrFloat4 a, const ovrFloat4 b ) { return vaddq_f32( a, b ); }
+static inline ovrFloat4 Float4_Sub( const ovrFloat4 a, const ovrFloat4 b ) { return vsubq_f32( a, b ); }
+static inline ovrFloat4 Float4_Mul( const ovrFloat4 a, const ovrFloat4 b ) { return vmulq_f32( a, b ); }
+static inline ovrInt4 Float4_AsInt( const ovrFloat4 a ) { return vreinterpretq_s32_f32( a ); }
+static inline ovrFloat4 Int4_AsFloat( const ovrInt4 a ) { return vreinterpretq_f32_s32( a ); }
+static inline ovrInt4 Int4_Set( const int32_t x ) { return vdupq_n_s32( x ); }
+static inline ovrInt4 Int4_And( const ovrInt4 a, const ovrInt4 b ) { return vandq_s32( a, b ); }
+static inline ovrInt4 Int4_Xor( const ovrInt4 a, const ovrInt4 b ) { return veorq_s32( a, b ); }
+static inline ovrInt4 Int4_Add( const ovrInt4 a, const ovrInt4 b ) { return vaddq_s32( a, b ); }
+static inline ovrInt4 Int4_ShiftLeft30( const ovrInt4 a ) { return vshlq_n_s32( a, 30 ); }
+static inline ovrInt4 Int4_Equal( const ovrInt4 a, const ovrInt4 b ) { return vreinterpretq_s32_u32( vceqq_s32( a, b ) ); }
+// Returns a where the mask is set and b elsewhere.
+static inline ovrFloat4 Float4_Select( const ovrInt4 mask, const ovrFloat4 a, const ovrFloat4 b )
+{
+	return vbslq_f32( vreinterpretq_u32_s32( mask ), a, b );
+}
+static inline void Float4_Transpose( ovrFloat4 * r0, ovrFloat4 * r1, ovrFloat4 * r2, ovrFloat4 * r3 )
+{
+	const float32x4x2_t t01 = vtrnq_f32( *r0, *r1 );
+	const float32x4x2_t t23 = vtrnq_f32( *r2, *r3 );
+	*r0 = vcombine_f32( vget_low_f32( t01.val[0] ), vget_low_f32( t23.val[0] ) );
+	*r1 = vcombine_f32( vget_low_f32( t01.val[1] ), vget_low_f32( t23.val[1] ) );
+	*r2 = vcombine_f32( vget_high_f32( t01.val[0] ), vget_high_f32( t23.val[0] ) );
+	*r3 = vcombine_f32( vget_high_f32( t01.val[1] ), vget_high_f32( t23.val[1] ) );
+}
+static inline void Float4_Store( float * p, const ovrFloat4 a ) { vst1q_f32( p, a ); }
+
+#endif
+
+#if defined( INSTANCES_SSE2 ) || defined( INSTANCES_NEON )
+
+static void SinCos4( const ovrFloat4 x, ovrFloat4 * outSin, ovrFloat4 * outCos )
+{
+	const ovrFloat4 t = Float4_Add( Float4_Mul( x, Float4_Set( SINCOS_TWO_OVER_PI ) ), Float4_Set( SINCOS_ROUND ) );
+	const ovrInt4 quadrant = Float4_AsInt( t );
+	const ovrFloat4 n = Float4_Sub( t, Float4_Set( SINCOS_ROUND ) );
+	const ovrFloat4 r = Float4_Sub( Float4_Sub( Float4_Sub( x, Float4_Mul( n, Float4_Set( SINCOS_PIO2_1 ) ) ),
+						Float4_Mul( n, Float4_Set( SINCOS_PIO2_2 ) ) ), Float4_Mul( n, Float4_Set( SINCOS_PIO2_3 ) ) );
+	const ovrFloat4 r2 = Float4_Mul( r, r );
+	const ovrFloat4 sp = Float4_Add( Float4_Set( SINCOS_S1 ), Float4_Mul( r2, Float4_Add( Float4_Set( SINCOS_S2 ), Float4_Mul( r2, Float4_Set( SINCOS_S3 ) ) ) ) );
+	const ovrFloat4 s = Float4_Add( r, Float4_Mul( Float4_Mul( r, r2 ), sp ) );
+	const ovrFloat4 cp = Float4_Add( Float4_Set( SINCOS_C1 ), Float4_Mul( r2, Float4_Add( Float4_Set( SINCOS_C2 ), Float4_Mul( r2, Float4_Set( SINCOS_C3 ) ) ) ) );
+	const ovrFloat4 c = Float4_Add( Float4_Sub( Float4_Set( 1.0f ), Float4_Mul( Float4_Set( 0.5f ), r2 ) ), Float4_Mul( Float4_Mul( r2, r2 ), cp ) );
+
+	const ovrInt4 one = Int4_Set( 1 );
+	const ovrInt4 two = Int4_Set( 2 );
+	const ovrInt4 swap = Int4_Equal( Int4_And( quadrant, one ), one );
+	const ovrInt4 sinSign = Int4_ShiftLeft30( Int4_And( quadrant, two ) );
+	const ovrInt4 cosSign = Int4_ShiftLeft30( Int4_And( Int4_Add( quadrant, one ), two ) );
+	*outSin = Int4_AsFloat( Int4_Xor( Float4_AsInt( Float4_Select( swap, c, s ) ), sinSign ) );
+	*outCos = Int4_AsFloat( Int4_Xor( Float4_AsInt( Float4_Select( swap, s, c ) ), cosSign ) );
+}
+
+// Writes the transforms of the INSTANCE_BATCH_SIZE instances starting at index.
+static void WriteTransformBatch( const ovrCubeInstances * instances, const ovrFloat4 * currentRotation,
+									const int index, ovrMatrix4f * transforms )
+{
+	ovrFloat4 sx, cx, sy, cy, sz, cz;
+	SinCos4( Float4_Mul( Float4_Load( instances->RotationX + index ), currentRotation[0] ), &sx, &cx );
+	SinCos4( Float4_Mul( Float4_Load( instances->RotationY + index ), currentRotation[1] ), &sy, &cy );
+	SinCos4( Float4_Mul( Float4_Load( instances->RotationZ + index ), currentRotation[2] ), &sz, &cz );
+
+	// ovrMatrix4f_CreateRotation() is Z * Y * X.
+	const ovrFloat4 sysx = Float4_Mul( sy, sx );
+	const ovrFloat4 sycx = Float4_Mul( sy, cx );
+	const ovrFloat4 zero = Float4_Set( 0.0f );
+
+	ovrFloat4 m00 = Float4_Mul( cz, cy );
+	ovrFloat4 m01 = Float4_Sub( Float4_Mul( cz, sysx ), Float4_Mul( sz, cx ) );
+	ovrFloat4 m02 = Float4_Add( Float4_Mul( cz, sycx ), Float4_Mul( sz, sx ) );
+	ovrFloat4 m03 = zero;
+	ovrFloat4 m10 = Float4_Mul( sz, cy );
+	ovrFloat4 m11 = Float4_Add( Float4_Mul( sz, sysx ), Float4_Mul( cz, cx ) );
+	ovrFloat4 m12 = Float4_Sub( Float4_Mul( sz, sycx ), Float4_Mul( cz, sx ) );
+	ovrFloat4 m13 = zero;
+	ovrFloat4 m20 = Float4_Sub( zero, sy );
+	ovrFloat4 m21 = Float4_Mul( cy, sx );
+	ovrFloat4 m22 = Float4_Mul( cy, cx );
+	ovrFloat4 m23 = zero;
+	ovrFloat4 m30 = Float4_Load( instances->PositionX + index );
+	ovrFloat4 m31 = Float4_Load( instances->PositionY + index );
+	ovrFloat4 m32 = Float4_Load( instances->PositionZ + index );
+	ovrFloat4 m33 = Float4_Set( 1.0f );
+
+	// From one element per instance to one row per instance.
+	Float4_Transpose( &m00, &m01, &m02, &m03 );
+	Float4_Transpose( &m10, &m11, &m12, &m13 );
+	Float4_Transpose( &m20, &m21, &m22, &m23 );
+	Float4_Transpose( &m30, &m31, &m32, &m33 );
+
+	Float4_Store( transforms[0].M[0], m00 );
+	Float4_Store( transforms[0].M[1], m10 );
+	Float4_Store( transforms[0].M[2], m20 );
+	Float4_Store( transforms[0].M[3], m30 );
+	Float4_Store( transforms[1].M[0], m01 );
+	Float4_Store( transforms[1].M[1], m11 );
+	Float4_Store( transforms[1].M[2], m21 );
+	Float4_Store( transforms[1].M[3], m31 );
+	Float4_Store( transforms[2].M[0], m02 );
+	Float4_Store( transforms[2].M[1], m12 );
+	Float4_Store( transforms[2].M[2], m22 );
+	Float4_Store( transforms[2].M[3], m32 );
+	Float4_Store( transforms[3].M[0], m03 );
+	Float4_Store( transforms[3].M[1], m13 );
+	Float4_Store( transforms[3].M[2], m23 );
+	Float4_Store( transforms[3].M[3], m33 );
+}
+
+#endif
+
+/*
+================================================================================
+
+ovrCubeInstances
+
+================================================================================
+*/
+
+void ovrCubeInstances_Create( ovrCubeInstances * instances, const int numInstances )
+{
+	instances->NumInstances = numInstances;
+	instances->NumAllocated = ( numInstances + INSTANCE_BATCH_SIZE - 1 ) & ~( INSTANCE_BATCH_SIZE - 1 );
+
+	// One allocation for all the arrays, zeroed so the padding is harmless.
+	float * memory = (float *) calloc( 6 * instances->NumAllocated, sizeof( float ) );
+	instances->PositionX = memory + 0 * instances->NumAllocated;
+	instances->PositionY = memory + 1 * instances->NumAllocated;
+	instances->PositionZ = memory + 2 * instances->NumAllocated;
+	instances->RotationX = memory + 3 * instances->NumAllocated;
+	instances->RotationY = memory + 4 * instances->NumAllocated;
+	instances->RotationZ = memory + 5 * instances->NumAllocated;
+}
+
+void ovrCubeInstances_Destroy( ovrCubeInstances * instances )
+{
+	free( instances->PositionX );
+	memset( instances, 0, sizeof( ovrCubeInstances ) );
+}
+
+void ovrCubeInstances_Set( ovrCubeInstances * instances, const int index,
+							const ovrVector3f * position, const ovrVector3f * rotation )
+{
+	instances->PositionX[index] = position->x;
+	instances->PositionY[index] = position->y;
+	instances->PositionZ[index] = position->z;
+	instances->RotationX[index] = rotation->x;
+	instances->RotationY[index] = rotation->y;
+	instances->RotationZ[index] = rotation->z;
+}
+
+void ovrCubeInstances_WriteTransforms( const ovrCubeInstances * instances, const ovrVector3f * currentRotation,
+							const int first, const int count, ovrMatrix4f * transforms )
+{
+	int i = first;
+
+#if defined( INSTANCES_SSE2 ) || defined( INSTANCES_NEON )
+	const ovrFloat4 rotation[3] =
+	{
+		Float4_Set( currentRotation->x ),
+		Float4_Set( currentRotation->y ),
+		Float4_Set( currentRotation->z )
+	};
+	for ( ; i + INSTANCE_BATCH_SIZE <= first + count; i += INSTANCE_BATCH_SIZE )
+	{
+		WriteTransformBatch( instances, rotation, i, transforms + i );
+	}
+	if ( i < first + count && i + INSTANCE_BATCH_SIZE <= instances->NumAllocated )
+	{
+		// The last partial batch goes through a copy, so nothing past count is written.
+		ovrMatrix4f batch[INSTANCE_BATCH_SIZE];
+		WriteTransformBatch( instances, rotation, i, batch );
+		memcpy( transforms + i, batch, ( first + count - i ) * sizeof( ovrMatrix4f ) );
+		return;
+	}
+#endif
+
+	for ( ; i < first + count; i++ )
+	{
+		float sx, cx, sy, cy, sz, cz;
+		SinCos( instances->RotationX[i] * currentRotation->x, &sx, &cx );
+		SinCos( instances->RotationY[i] * currentRotation->y, &sy, &cy );
+		SinCos( instances->RotationZ[i] * currentRotation->z, &sz, &cz );
+
+		// Write in order in case the mapped buffer lives on write-combined memory.
+		ovrMatrix4f * transform = &transforms[i];
+		transform->M[0][0] = cz * cy;
+		transform->M[0][1] = cz * ( sy * sx ) - sz * cx;
+		transform->M[0][2] = cz * ( sy * cx ) + sz * sx;
+		transform->M[0][3] = 0.0f;
+
+		transform->M[1][0] = sz * cy;
+		transform->M[1][1] = sz * ( sy * sx ) + cz * cx;
+		transform->M[1][2] = sz * ( sy * cx ) - cz * sx;
+		transform->M[1][3] = 0.0f;
+
+		transform->M[2][0] = -sy;
+		transform->M[2][1] = cy * sx;
+		transform->M[2][2] = cy * cx;
+		transform->M[2][3] = 0.0f;
+
+		transform->M[3][0] = instances->PositionX[i];
+		transform->M[3][1] = instances->PositionY[i];
+		transform->M[3][2] = instances->PositionZ[i];
+		transform->M[3][3] = 1.0f;
+	}
+}
+
+/*
+================================================================================
+
+ovrInstanceJobs
+
+================================================================================
+*/
+
+// Runs jobs until there are none left and returns how many it ran.
+static int ovrInstanceJobs_Work( ovrInstanceJobs * jobs )
+{
+	int numDone = 0;
+	for ( ; ; )
+	{
+		const int job = __atomic_fetch_add( &jobs->NextJob, 1, __ATOMIC_RELAXED );
+		if ( job >= jobs->NumJobs )
+		{
+			break;
+		}
+		const int first = job * INSTANCES_PER_JOB;
+		const int remaining = jobs->Instances->NumInstances - first;
+		const int count = ( remaining < INSTANCES_PER_JOB ) ? remaining : INSTANCES_PER_JOB;
+		ovrCubeInstances_WriteTransforms( jobs->Instances, &jobs->CurrentRotation, first, count, jobs->Transforms );
+		numDone++;
+	}
+	return numDone;
+}
+
+static void * InstanceThreadFunction( void * parm )
+{
+	ovrInstanceJobs * jobs = (ovrInstanceJobs *)parm;
+
+	prctl( PR_SET_NAME, (long)"CubeInstances", 0, 0, 0 );
+
+	pthread_mutex_lock( &jobs->Mutex );
+	int generation = jobs->Generation;
+	for ( ; ; )
+	{
+		while ( jobs->Generation == generation && !jobs->Exit )
+		{
+			pthread_cond_wait( &jobs->WorkCondition, &jobs->Mutex );
+		}
+		if ( jobs->Exit )
+		{
+			break;
+		}
+		generation = jobs->Generation;
+		jobs->NumBusy++;
+		pthread_mutex_unlock( &jobs->Mutex );
+
+		const int numDone = ovrInstanceJobs_Work( jobs );
+
+		pthread_mutex_lock( &jobs->Mutex );
+		jobs->NumBusy--;
+		jobs->NumJobsDone += numDone;
+		if ( jobs->NumBusy == 0 || jobs->NumJobsDone == jobs->NumJobs )
+		{
+			pthread_cond_broadcast( &jobs->DoneCondition );
+		}
+	}
+	pthread_mutex_unlock( &jobs->Mutex );
+
+	return NULL;
+}
+
+void ovrInstanceJobs_Create( ovrInstanceJobs * jobs, const int numThreads )
+{
+	memset( jobs, 0, sizeof( ovrInstanceJobs ) );
+
+	pthread_mutex_init( &jobs->Mutex, NULL );
+	pthread_cond_init( &jobs->WorkCondition, NULL );
+	pthread_cond_init( &jobs->DoneCondition, NULL );
+
+	for ( int i = 0; i < numThreads && i < MAX_INSTANCE_THREADS; i++ )
+	{
+		const int createErr = pthread_create( &jobs->Threads[jobs->NumThreads], NULL, InstanceThreadFunction, jobs );
+		if ( createErr != 0 )
+		{
+			break;
+		}
+		jobs->NumThreads++;
+	}
+}
+
+void ovrInstanceJobs_Destroy( ovrInstanceJobs * jobs )
+{
+	pthread_mutex_lock( &jobs->Mutex );
+	jobs->Exit = true;
+	pthread_cond_broadcast( &jobs->WorkCondition );
+	pthread_mutex_unlock( &jobs->Mutex );
+
+	for ( int i = 0; i < jobs->NumThreads; i++ )
+	{
+		pthread_join( jobs->Threads[i], NULL );
+	}
+	pthread_cond_destroy( &jobs->WorkCondition );
+	pthread_cond_destroy( &jobs->DoneCondition );
+	pthread_mutex_destroy( &jobs->Mutex );
+	jobs->NumThreads = 0;
+}
+
+void ovrInstanceJobs_WriteTransforms( ovrInstanceJobs * jobs, const ovrCubeInstances * instances,
+							const ovrVector3f * currentRotation, ovrMatrix4f * transforms )
+{
+	const int numJobs = ( instances->NumInstances + INSTANCES_PER_JOB - 1 ) / INSTANCES_PER_JOB;
+
+	pthread_mutex_lock( &jobs->Mutex );
+	// A worker that woke up late for the previous set of jobs must not see these half set.
+	while ( jobs->NumBusy > 0 )
+	{
+		pthread_cond_wait( &jobs->DoneCondition, &jobs->Mutex );
+	}
+	jobs->Instances = instances;
+	jobs->CurrentRotation = *currentRotation;
+	jobs->Transforms = transforms;
+	jobs->NumJobs = numJobs;
+	jobs->NextJob = 0;
+	jobs->NumJobsDone = 0;
+	if ( jobs->NumThreads > 0 && numJobs > 1 )
+	{
+		jobs->Generation++;
+		pthread_cond_broadcast( &jobs->WorkCondition );
+	}
+	pthread_mutex_unlock( &jobs->Mutex );
+
+	const int numDone = ovrInstanceJobs_Work( jobs );
+
+	pthread_mutex_lock( &jobs->Mutex );
+	jobs->NumJobsDone += numDone;
+	while ( jobs->NumJobsDone < jobs->NumJobs )
+	{
+		pthread_cond_wait( &jobs->DoneCondition, &jobs->Mutex );
+	}
+	pthread_mutex_unlock( &jobs->Mutex );
+}
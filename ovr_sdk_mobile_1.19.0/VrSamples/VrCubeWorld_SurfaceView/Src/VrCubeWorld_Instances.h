@@ -0,0 +1,105 @@
+/************************************************************************************
+
+Filename	:	VrCubeWorld_Instances.h
+Content		:	Computes the instance transforms of the cube world, four instances at a
+				time with SSE2 or NEON, on a pool of worker threads.
+Created		:	10/18/2026
+Authors		:
+
+Copyright	:	Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#if !defined( VrCubeWorld_Instances_h )
+#define VrCubeWorld_Instances_h
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "VrApi_Types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/*
+================================================================================
+
+ovrCubeInstances
+
+================================================================================
+*/
+
+#define INSTANCE_BATCH_SIZE		4		// instances per SIMD batch
+
+// The positions and rotations of the cubes, stored as separate arrays so four instances
+// load with one instruction. The arrays are padded to a whole number of batches.
+typedef struct
+{
+	int					NumInstances;
+	int					NumAllocated;
+	float *				PositionX;
+	float *				PositionY;
+	float *				PositionZ;
+	float *				RotationX;		// multiplied by the simulation rotation
+	float *				RotationY;
+	float *				RotationZ;
+} ovrCubeInstances;
+
+void	ovrCubeInstances_Create( ovrCubeInstances * instances, const int numInstances );
+void	ovrCubeInstances_Destroy( ovrCubeInstances * instances );
+void	ovrCubeInstances_Set( ovrCubeInstances * instances, const int index,
+							const ovrVector3f * position, const ovrVector3f * rotation );
+
+// Writes transforms[first] through transforms[first + count - 1]. Each one is
+// ovrMatrix4f_CreateRotation() of the instance rotation times currentRotation, with the
+// position in the last row, as the instance transform attributes expect. The matrices are
+// written in order, so transforms can point at write-combined memory.
+void	ovrCubeInstances_WriteTransforms( const ovrCubeInstances * instances, const ovrVector3f * currentRotation,
+							const int first, const int count, ovrMatrix4f * transforms );
+
+/*
+================================================================================
+
+ovrInstanceJobs
+
+================================================================================
+*/
+
+#define MAX_INSTANCE_THREADS	8
+#define INSTANCES_PER_JOB		1024
+
+// Worker threads that split ovrCubeInstances_WriteTransforms() into jobs of
+// INSTANCES_PER_JOB instances. The calling thread works on jobs as well.
+typedef struct
+{
+	pthread_t			Threads[MAX_INSTANCE_THREADS];
+	int					NumThreads;
+
+	pthread_mutex_t		Mutex;
+	pthread_cond_t		WorkCondition;		// a new set of jobs is available or exiting
+	pthread_cond_t		DoneCondition;		// the last job is done or a worker went idle
+	bool				Exit;
+	int					Generation;			// incremented for each set of jobs
+	int					NumBusy;			// workers between taking a generation and going idle
+	int					NumJobsDone;
+
+	// Set under the mutex while no worker is busy.
+	const ovrCubeInstances *	Instances;
+	ovrVector3f			CurrentRotation;
+	ovrMatrix4f *		Transforms;
+	int					NumJobs;
+	int					NextJob;			// taken with an atomic add
+} ovrInstanceJobs;
+
+// Starts numThreads workers; with zero the calling thread does all the work.
+void	ovrInstanceJobs_Create( ovrInstanceJobs * jobs, const int numThreads );
+void	ovrInstanceJobs_Destroy( ovrInstanceJobs * jobs );
+// Writes the transforms of all instances and returns when they are written.
+void	ovrInstanceJobs_WriteTransforms( ovrInstanceJobs * jobs, const ovrCubeInstances * instances,
+							const ovrVector3f * currentRotation, ovrMatrix4f * transforms );
+
+#if defined( __cplusplus )
+}	// extern "C"
+#endif
+
+#endif // VrCubeWorld_Instances_h
@@ -57,6 +57,12 @@ typedef void (GL_APIENTRY* PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC) (GLenum targ
 typedef void (GL_APIENTRY* PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC)(GLenum target, GLenum attachment, GLuint texture, GLint level, GLsizei samples, GLint baseViewIndex, GLsizei numViews);
 #endif
 
+#if !defined( GL_EXT_buffer_storage )
+static const int GL_MAP_PERSISTENT_BIT_EXT		= 0x0040;
+static const int GL_MAP_COHERENT_BIT_EXT		= 0x0080;
+typedef void (GL_APIENTRY* PFNGLBUFFERSTORAGEEXTPROC) (GLenum target, GLsizeiptr size, const void * data, GLbitfield flags);
+#endif
+
 // Must use EGLSyncKHR because the VrApi still supports OpenGL ES 2.0
 // EGL_KHR_reusable_sync
 PFNEGLCREATESYNCKHRPROC			eglCreateSyncKHR;
@@ -70,6 +76,8 @@ PFNEGLGETSYNCATTRIBKHRPROC		eglGetSyncAttribKHR;
 #include "VrApi_SystemUtils.h"
 #include "VrApi_Input.h"
 
+#include "VrCubeWorld_Instances.h"
+
 #define DEBUG 1
 #define LOG_TAG "VrCubeWorld"
 
@@ -83,6 +91,7 @@ PFNEGLGETSYNCATTRIBKHRPROC		eglGetSyncAttribKHR;
 static const int CPU_LEVEL			= 2;
 static const int GPU_LEVEL			= 3;
 static const int NUM_MULTI_SAMPLES	= 4;
+static const int NUM_INSTANCE_THREADS	= 2;	// in addition to the thread that renders
 
 #define MULTI_THREADED			0
 
@@ -113,10 +122,13 @@ typedef struct
 {
 	bool multi_view;						// GL_OVR_multiview, GL_OVR_multiview2
 	bool EXT_texture_border_clamp;			// GL_EXT_texture_border_clamp, GL_OES_texture_border_clamp
+	bool EXT_buffer_storage;				// GL_EXT_buffer_storage
 } OpenGLExtensions_t;
 
 OpenGLExtensions_t glExtensions;
 
+PFNGLBUFFERSTORAGEEXTPROC	glBufferStorageEXT_;
+
 static void EglInitExtensions()
 {
 	eglCreateSyncKHR		= (PFNEGLCREATESYNCKHRPROC)			eglGetProcAddress( "eglCreateSyncKHR" );
@@ -133,6 +145,9 @@ static void EglInitExtensions()
 
 		glExtensions.EXT_texture_border_clamp = strstr( allExtensions, "GL_EXT_texture_border_clamp" ) ||
 												strstr( allExtensions, "GL_OES_texture_border_clamp" );
+
+		glBufferStorageEXT_ = (PFNGLBUFFERSTORAGEEXTPROC) eglGetProcAddress( "glBufferStorageEXT" );
+		glExtensions.EXT_buffer_storage = strstr( allExtensions, "GL_EXT_buffer_storage" ) && glBufferStorageEXT_ != NULL;
 	}
 }
 
@@ -998,6 +1013,17 @@ static void ovrFence_Destroy( ovrFence * fence )
 	}
 }
 
+static void ovrFence_Wait( ovrFence * fence )
+{
+	if ( fence->Sync != EGL_NO_SYNC_KHR )
+	{
+		if ( eglClientWaitSyncKHR( fence->Display, fence->Sync, 0, EGL_FOREVER_KHR ) == EGL_FALSE )
+		{
+			ALOGE( "eglClientWaitSyncKHR() : EGL_FALSE" );
+		}
+	}
+}
+
 static void ovrFence_Insert( ovrFence * fence )
 {
 	ovrFence_Destroy( fence );
@@ -1028,6 +1054,7 @@ ovrScene
 
 #define NUM_INSTANCES		1500
 #define NUM_ROTATIONS		16
+#define NUM_INSTANCE_BUFFERS	3		// the CPU writes one while the GPU may still read the others
 
 typedef struct
 {
@@ -1037,10 +1064,15 @@ typedef struct
 	ovrProgram			Program;
 	ovrGeometry			Cube;
 	GLuint				SceneMatrices;
-	GLuint				InstanceTransformBuffer;
+	GLuint				InstanceTransformBuffer;	// NUM_INSTANCE_BUFFERS sets of NUM_INSTANCES transforms
+	ovrMatrix4f *		InstanceTransforms;			// persistently mapped, or NULL without GL_EXT_buffer_storage
+	ovrFence			InstanceFences[NUM_INSTANCE_BUFFERS];
+	int					InstanceBufferIndex;
 	ovrVector3f			Rotations[NUM_ROTATIONS];
 	ovrVector3f			CubePositions[NUM_INSTANCES];
 	int					CubeRotations[NUM_INSTANCES];
+	ovrCubeInstances	Instances;
+	ovrInstanceJobs		InstanceJobs;
 } ovrScene;
 
 static void ovrScene_Clear( ovrScene * scene )
@@ -1050,6 +1082,8 @@ static void ovrScene_Clear( ovrScene * scene )
 	scene->Random = 2;
 	scene->SceneMatrices = 0;
 	scene->InstanceTransformBuffer = 0;
+	scene->InstanceTransforms = NULL;
+	scene->InstanceBufferIndex = 0;
 
 	ovrProgram_Clear( &scene->Program );
 	ovrGeometry_Clear( &scene->Cube );
@@ -1060,6 +1094,19 @@ static bool ovrScene_IsCreated( ovrScene * scene )
 	return scene->CreatedScene;
 }
 
+// Points the instance transform attributes of the bound VAO at one of the instance buffers.
+static void ovrScene_SetInstanceAttributes( ovrScene * scene, const int bufferIndex )
+{
+	const size_t offset = bufferIndex * NUM_INSTANCES * sizeof( ovrMatrix4f );
+	GL( glBindBuffer( GL_ARRAY_BUFFER, scene->InstanceTransformBuffer ) );
+	for ( int i = 0; i < 4; i++ )
+	{
+		GL( glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_TRANSFORM + i, 4, GL_FLOAT,
+									false, 4 * 4 * sizeof( float ), (void *)( offset + i * 4 * sizeof( float ) ) ) );
+	}
+	GL( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
+}
+
 static void ovrScene_CreateVAOs( ovrScene * scene )
 {
 	if ( !scene->CreatedVAOs )
@@ -1068,14 +1115,12 @@ static void ovrScene_CreateVAOs( ovrScene * scene )
 
 		// Modify the VAO to use the instance transform attributes.
 		GL( glBindVertexArray( scene->Cube.VertexArrayObject ) );
-		GL( glBindBuffer( GL_ARRAY_BUFFER, scene->InstanceTransformBuffer ) );
 		for ( int i = 0; i < 4; i++ )
 		{
 			GL( glEnableVertexAttribArray( VERTEX_ATTRIBUTE_LOCATION_TRANSFORM + i ) );
-			GL( glVertexAttribPointer( VERTEX_ATTRIBUTE_LOCATION_TRANSFORM + i, 4, GL_FLOAT,
-										false, 4 * 4 * sizeof( float ), (void *)( i * 4 * sizeof( float ) ) ) );
 			GL( glVertexAttribDivisor( VERTEX_ATTRIBUTE_LOCATION_TRANSFORM + i, 1 ) );
 		}
+		ovrScene_SetInstanceAttributes( scene, scene->InstanceBufferIndex );
 		GL( glBindVertexArray( 0 ) );
 
 		scene->CreatedVAOs = true;
@@ -1105,11 +1150,27 @@ static void ovrScene_Create( ovrScene * scene, bool useMultiview )
 	ovrProgram_Create( &scene->Program, VERTEX_SHADER, FRAGMENT_SHADER, useMultiview );
 	ovrGeometry_CreateCube( &scene->Cube );
 
-	// Create the instance transform attribute buffer.
+	// Create the instance transform attribute buffers. With GL_EXT_buffer_storage they are
+	// mapped once, so the workers write straight into them without a map per frame.
+	const GLsizeiptr instanceBufferSize = NUM_INSTANCE_BUFFERS * NUM_INSTANCES * sizeof( ovrMatrix4f );
 	GL( glGenBuffers( 1, &scene->InstanceTransformBuffer ) );
 	GL( glBindBuffer( GL_ARRAY_BUFFER, scene->InstanceTransformBuffer ) );
-	GL( glBufferData( GL_ARRAY_BUFFER, NUM_INSTANCES * 4 * 4 * sizeof( float ), NULL, GL_DYNAMIC_DRAW ) );
+	if ( glExtensions.EXT_buffer_storage )
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT_EXT | GL_MAP_COHERENT_BIT_EXT;
+		GL( glBufferStorageEXT_( GL_ARRAY_BUFFER, instanceBufferSize, NULL, flags ) );
+		GL( scene->InstanceTransforms = (ovrMatrix4f *) glMapBufferRange( GL_ARRAY_BUFFER, 0, instanceBufferSize, flags ) );
+	}
+	else
+	{
+		GL( glBufferData( GL_ARRAY_BUFFER, instanceBufferSize, NULL, GL_DYNAMIC_DRAW ) );
+	}
 	GL( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
+	for ( int i = 0; i < NUM_INSTANCE_BUFFERS; i++ )
+	{
+		ovrFence_Create( &scene->InstanceFences[i] );
+	}
+	scene->InstanceBufferIndex = 0;
 
 	// Setup the scene matrices.
 	GL( glGenBuffers( 1, &scene->SceneMatrices ) );
@@ -1182,6 +1243,14 @@ static void ovrScene_Create( ovrScene * scene, bool useMultiview )
 		scene->CubeRotations[insert] = (int)( ovrScene_RandomFloat( scene ) * ( NUM_ROTATIONS - 0.1f ) );
 	}
 
+	// Setup the instances for the workers that compute the transforms.
+	ovrCubeInstances_Create( &scene->Instances, NUM_INSTANCES );
+	for ( int i = 0; i < NUM_INSTANCES; i++ )
+	{
+		ovrCubeInstances_Set( &scene->Instances, i, &scene->CubePositions[i], &scene->Rotations[scene->CubeRotations[i]] );
+	}
+	ovrInstanceJobs_Create( &scene->InstanceJobs, NUM_INSTANCE_THREADS );
+
 	scene->CreatedScene = true;
 
 #if !MULTI_THREADED
@@ -1195,8 +1264,22 @@ static void ovrScene_Destroy( ovrScene * scene )
 	ovrScene_DestroyVAOs( scene );
 #endif
 
+	ovrInstanceJobs_Destroy( &scene->InstanceJobs );
+	ovrCubeInstances_Destroy( &scene->Instances );
+
 	ovrProgram_Destroy( &scene->Program );
 	ovrGeometry_Destroy( &scene->Cube );
+	for ( int i = 0; i < NUM_INSTANCE_BUFFERS; i++ )
+	{
+		ovrFence_Destroy( &scene->InstanceFences[i] );
+	}
+	if ( scene->InstanceTransforms != NULL )
+	{
+		GL( glBindBuffer( GL_ARRAY_BUFFER, scene->InstanceTransformBuffer ) );
+		GL( glUnmapBuffer( GL_ARRAY_BUFFER ) );
+		GL( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
+		scene->InstanceTransforms = NULL;
+	}
 	GL( glDeleteBuffers( 1, &scene->InstanceTransformBuffer ) );
 	GL( glDeleteBuffers( 1, &scene->SceneMatrices ) );
 	scene->CreatedScene = false;
@@ -1296,50 +1379,36 @@ static void ovrRenderer_Destroy( ovrRenderer * renderer )
 }
 
 static ovrLayerProjection2 ovrRenderer_RenderFrame( ovrRenderer * renderer, const ovrJava * java,
-											const ovrScene * scene, const ovrSimulation * simulation,
+											ovrScene * scene, const ovrSimulation * simulation,
 											const ovrTracking2 * tracking, ovrMobile * ovr,
 											unsigned long long * completionFence )
 {
-	ovrMatrix4f rotationMatrices[NUM_ROTATIONS];
-	for ( int i = 0; i < NUM_ROTATIONS; i++ )
+	// Update the instance transform attributes in the next instance buffer, once the GPU
+	// is done with the frame that last used it.
+	const int instanceBufferIndex = scene->InstanceBufferIndex;
+	scene->InstanceBufferIndex = ( scene->InstanceBufferIndex + 1 ) % NUM_INSTANCE_BUFFERS;
+	ovrFence_Wait( &scene->InstanceFences[instanceBufferIndex] );
+	if ( scene->InstanceTransforms != NULL )
 	{
-		rotationMatrices[i] = ovrMatrix4f_CreateRotation(
-								scene->Rotations[i].x * simulation->CurrentRotation.x,
-								scene->Rotations[i].y * simulation->CurrentRotation.y,
-								scene->Rotations[i].z * simulation->CurrentRotation.z );
+		ovrInstanceJobs_WriteTransforms( &scene->InstanceJobs, &scene->Instances, &simulation->CurrentRotation,
+											scene->InstanceTransforms + instanceBufferIndex * NUM_INSTANCES );
 	}
-
-	// Update the instance transform attributes.
-	GL( glBindBuffer( GL_ARRAY_BUFFER, scene->InstanceTransformBuffer ) );
-	GL( ovrMatrix4f * cubeTransforms = (ovrMatrix4f *) glMapBufferRange( GL_ARRAY_BUFFER, 0,
-				NUM_INSTANCES * sizeof( ovrMatrix4f ), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT ) );
-	for ( int i = 0; i < NUM_INSTANCES; i++ )
+	else
 	{
-		const int index = scene->CubeRotations[i];
-
-		// Write in order in case the mapped buffer lives on write-combined memory.
-		cubeTransforms[i].M[0][0] = rotationMatrices[index].M[0][0];
-		cubeTransforms[i].M[0][1] = rotationMatrices[index].M[0][1];
-		cubeTransforms[i].M[0][2] = rotationMatrices[index].M[0][2];
-		cubeTransforms[i].M[0][3] = rotationMatrices[index].M[0][3];
-
-		cubeTransforms[i].M[1][0] = rotationMatrices[index].M[1][0];
-		cubeTransforms[i].M[1][1] = rotationMatrices[index].M[1][1];
-		cubeTransforms[i].M[1][2] = rotationMatrices[index].M[1][2];
-		cubeTransforms[i].M[1][3] = rotationMatrices[index].M[1][3];
-
-		cubeTransforms[i].M[2][0] = rotationMatrices[index].M[2][0];
-		cubeTransforms[i].M[2][1] = rotationMatrices[index].M[2][1];
-		cubeTransforms[i].M[2][2] = rotationMatrices[index].M[2][2];
-		cubeTransforms[i].M[2][3] = rotationMatrices[index].M[2][3];
-
-		cubeTransforms[i].M[3][0] = scene->CubePositions[i].x;
-		cubeTransforms[i].M[3][1] = scene->CubePositions[i].y;
-		cubeTransforms[i].M[3][2] = scene->CubePositions[i].z;
-		cubeTransforms[i].M[3][3] = 1.0f;
+		GL( glBindBuffer( GL_ARRAY_BUFFER, scene->InstanceTransformBuffer ) );
+		GL( ovrMatrix4f * cubeTransforms = (ovrMatrix4f *) glMapBufferRange( GL_ARRAY_BUFFER,
+					instanceBufferIndex * NUM_INSTANCES * sizeof( ovrMatrix4f ), NUM_INSTANCES * sizeof( ovrMatrix4f ),
+					GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT ) );
+		if ( cubeTransforms != NULL )
+		{
+			ovrInstanceJobs_WriteTransforms( &scene->InstanceJobs, &scene->Instances, &simulation->CurrentRotation, cubeTransforms );
+		}
+		GL( glUnmapBuffer( GL_ARRAY_BUFFER ) );
+		GL( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
 	}
-	GL( glUnmapBuffer( GL_ARRAY_BUFFER ) );
-	GL( glBindBuffer( GL_ARRAY_BUFFER, 0 ) );
+	GL( glBindVertexArray( scene->Cube.VertexArrayObject ) );
+	ovrScene_SetInstanceAttributes( scene, instanceBufferIndex );
+	GL( glBindVertexArray( 0 ) );
 
 	ovrTracking2 updatedTracking = *tracking;
 
@@ -1431,6 +1500,8 @@ static ovrLayerProjection2 ovrRenderer_RenderFrame( ovrRenderer * renderer, cons
 
 	ovrFramebuffer_SetNone();
 
+	ovrFence_Insert( &scene->InstanceFences[instanceBufferIndex] );
+
 	// Use a single fence to indicate the frame is ready to be displayed.
 	ovrFence * fence = &renderer->Fence[renderer->FenceIndex];
 	ovrFence_Insert( fence );